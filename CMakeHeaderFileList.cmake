@@ -87,13 +87,17 @@ SET (HEADER_DEVICE_FRAMEGRABBER
 
 SET (HEADER_IMAGE
   image/vpColor.h
+  image/vpImageAllocator.h
   image/vpImageConvert.h
   image/vpImageException.h
   image/vpImageFilter.h
   image/vpImage.h
   image/vpImageIo.h
   image/vpImageMorphology.h
+  image/vpImagePyramid.h
   image/vpImageTools.h
+  image/vpImageUndistortMap.h
+  image/vpPNMReader.h
   image/vpRGBa.h
   image/vpImagePoint.h
   )
@@ -107,6 +111,7 @@ SET (HEADER_KEY_POINT
 
 SET (HEADER_DEVICE_KINECT
   device/kinect/vpKinect.h
+  device/kinect/vpKinectFrameBuffer.h
   )
 
 SET (HEADER_DEVICE_LASERSCANNER
@@ -114,6 +119,7 @@ SET (HEADER_DEVICE_LASERSCANNER
   device/laserscanner/vpLaserScan.h
   device/laserscanner/vpLaserScanner.h
   device/laserscanner/sick/vpSickLDMRS.h
+  device/laserscanner/sick/vpSickLDMRSDecoder.h
   )
 
 SET (HEADER_DEVICE_LIGHT
@@ -123,13 +129,17 @@ SET (HEADER_DEVICE_LIGHT
 SET (HEADER_MATH
   math/kalman/vpKalmanFilter.h
   math/kalman/vpLinearKalmanFilterInstantiation.h
+  math/matrix/vpBatchSolver.h
   math/matrix/vpColVector.h
   math/matrix/vpMatrixException.h
+  math/matrix/vpMatrixFixedStorage.h
   math/matrix/vpMatrix.h
+  math/matrix/vpMatrixExpression.h
   math/matrix/vpRowVector.h
   math/matrix/vpSubMatrix.h
   math/matrix/vpSubColVector.h
   math/matrix/vpSubRowVector.h
+  math/matrix/vpSvdSolver.h
   math/matrix/vpGEMM.h
   math/misc/vpMath.h
   math/misc/vpHinkley.h
@@ -230,6 +240,7 @@ SET (HEADER_TOOLS
   tools/io/vpParallelPortException.h
   tools/io/vpParseArgv.h
   tools/mutex/vpMutex.h
+  tools/mutex/vpTripleBuffer.h
   tools/plot/vpPlot.h
   tools/plot/vpPlotCurve.h
   tools/plot/vpPlotGraph.h
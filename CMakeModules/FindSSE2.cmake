@@ -0,0 +1,58 @@
+#############################################################################
+#
+# $Id$
+#
+# This file is part of the ViSP software.
+# Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+# 
+# This software is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# ("GPL") version 2 as published by the Free Software Foundation.
+# See the file LICENSE.txt at the root directory of this source
+# distribution for additional information about the GNU GPL.
+#
+# For using ViSP with software that can not be combined with the GNU
+# GPL, please contact INRIA about acquiring a ViSP Professional 
+# Edition License.
+#
+# See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+# 
+# This software was developed at:
+# INRIA Rennes - Bretagne Atlantique
+# Campus Universitaire de Beaulieu
+# 35042 Rennes Cedex
+# France
+# http://www.irisa.fr/lagadic
+#
+# If you have questions regarding the use of this file, please contact
+# INRIA at visp@inria.fr
+# 
+# This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+# WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+#
+# Description:
+# Try to detect if the compiler is able to build SSE2 intrinsics
+# (emmintrin.h) with the current compilation flags.
+#
+# SSE2_FOUND - true if SSE2 intrinsics are usable
+
+include(CheckCXXSourceCompiles)
+
+set(SAFE_CMAKE_REQUIRED_FLAGS "${CMAKE_REQUIRED_FLAGS}")
+set(CMAKE_REQUIRED_FLAGS "${CMAKE_CXX_FLAGS}")
+CHECK_CXX_SOURCE_COMPILES("
+  #include <emmintrin.h>
+  int main()
+  {
+    __m128i a = _mm_setzero_si128();
+    __m128i b = _mm_set1_epi16(1);
+    a = _mm_madd_epi16(a, b);
+    return _mm_cvtsi128_si32(a);
+  }" SSE2_INTRINSICS_DETECTED)
+set(CMAKE_REQUIRED_FLAGS "${SAFE_CMAKE_REQUIRED_FLAGS}")
+
+if(SSE2_INTRINSICS_DETECTED)
+  set(SSE2_FOUND TRUE)
+else()
+  set(SSE2_FOUND FALSE)
+endif()
@@ -105,10 +105,14 @@ ENDIF()
 
 SET (SRC_IMAGE
   image/vpColor.cpp
+  image/vpImageAllocator.cpp
   image/vpImageConvert.cpp
   image/vpImageFilter.cpp
   image/vpImageIo.cpp
+  image/vpImagePyramid.cpp
   image/vpImageTools.cpp
+  image/vpImageUndistortMap.cpp
+  image/vpPNMReader.cpp
   image/vpRGBa.cpp
   image/vpImagePoint.cpp
   )
@@ -123,14 +127,16 @@ IF(VISP_HAVE_OPENCV)
   LIST(APPEND SRC_KEY_POINT key-point/vpFernClassifier.cpp)
 ENDIF()
 
-IF(VISP_HAVE_LIBFREENECT_AND_DEPENDENCIES)
-  SET (SRC_DEVICE_KINECT
-    device/kinect/vpKinect.cpp
+SET (SRC_DEVICE_KINECT
+  device/kinect/vpKinectFrameBuffer.cpp
   )
+IF(VISP_HAVE_LIBFREENECT_AND_DEPENDENCIES)
+  LIST(APPEND SRC_DEVICE_KINECT device/kinect/vpKinect.cpp)
 ENDIF()
 
 SET (SRC_DEVICE_LASERSCANNER
   device/laserscanner/sick/vpSickLDMRS.cpp
+  device/laserscanner/sick/vpSickLDMRSDecoder.cpp
   )
 
 IF(VISP_HAVE_PARPORT)
@@ -142,15 +148,19 @@ ENDIF()
 SET (SRC_MATH
   math/kalman/vpKalmanFilter.cpp
   math/kalman/vpLinearKalmanFilterInstantiation.cpp
+  math/matrix/vpBatchSolver.cpp
   math/matrix/vpColVector.cpp
   math/matrix/vpMatrix.cpp
   math/matrix/vpMatrix_lu.cpp
   math/matrix/vpMatrix_svd.cpp
   math/matrix/vpMatrix_covariance.cpp
+  math/matrix/vpMatrix_gemm.cpp
+  math/matrix/vpMatrixExpression.cpp
   math/matrix/vpRowVector.cpp
   math/matrix/vpSubMatrix.cpp
   math/matrix/vpSubColVector.cpp
   math/matrix/vpSubRowVector.cpp
+  math/matrix/vpSvdSolver.cpp
   math/misc/vpMath.cpp 
   math/misc/vpNoise.cpp 
   math/misc/vpHinkley.cpp 
@@ -274,6 +274,9 @@
 //Defined if we want to use openmp
 #cmakedefine VISP_HAVE_OPENMP
 
+//Defined if we want to use SSE2 optimized code
+#cmakedefine VISP_HAVE_SSE2
+
 //Defined if we want to use c++ 11
 #cmakedefine VISP_HAVE_CPP11_COMPATIBILITY
 
@@ -366,6 +366,19 @@ public:
                       double epsilon = 1e-6,
                       double areaThreshold = 0.0);
 
+  static bool ransacBatch(unsigned int n,
+                          double *xb, double *yb,
+                          double *xa, double *ya,
+                          vpHomography &bHa,
+                          vpColVector &inliers,
+                          long seed,
+                          unsigned int nbThreads = 1,
+                          int consensus = 1000,
+                          double threshold = 1e-6,
+                          double areaThreshold = 0.0,
+                          unsigned int maxNbTrials = 10000,
+                          unsigned int blockSize = 64);
+
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
   /*!
     @name Deprecated functions
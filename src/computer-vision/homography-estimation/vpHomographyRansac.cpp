@@ -19,6 +19,14 @@
 #include <visp/vpHomography.h>
 #include <visp/vpColVector.h>
 #include <visp/vpRansac.h>
+#include <visp/vpNoise.h>
+#include <visp/vpMath.h>
+#include <visp/vpException.h>
+#include <visp/vpDebug.h>
+
+#include <vector>
+#include <cmath>
+#include <limits>
 
 #define vpEps 1e-6
 
@@ -349,6 +357,211 @@ bool vpHomography::ransac(unsigned int n,
   return ransacable;
 }
 
+/*!
+
+  Batched and parallel version of ransac(). Instead of fitting and
+  scoring the hypotheses one after the other, a block of \e blockSize
+  minimal samples is drawn, then the homographies are estimated and
+  scored against all the matches in parallel. Each thread keeps its
+  own scratch homography and the residuals are computed directly on the
+  input arrays, so that no temporary vector is allocated per point.
+
+  The samples are drawn sequentially from a random generator
+  initialized with \e seed, and the hypotheses of a block are reduced
+  in their drawing order: the first hypothesis with the largest number
+  of inliers wins, and the adaptive stopping criterion is evaluated
+  after each hypothesis as in the serial algorithm. The result thus only
+  depends on \e seed; it does not depend on \e nbThreads nor on \e
+  blockSize.
+
+  \param n : Number of points.
+  \param xb, yb : Coordinates of the points in \f$ X_b \f$ vector.
+  \param xa, ya : Coordinates of the points in \f$ X_a \f$ vector.
+
+  \param bHa : Homography matrix computed from \f$ X_a \f$ and \f$ X_b \f$
+  vectors.
+
+  \param inliers : n dimension vector indicating if a point is an inlier
+  (value 1.0) or an outlier (value 0).
+
+  \param seed : Seed of the random generator used to draw the samples.
+
+  \param nbThreads : Number of threads used to estimate and score the
+  hypotheses. This setting is only effective when ViSP is built with
+  OpenMP. 0 is considered as 1.
+
+  \param consensus : Minimal number of points (less than n) fitting the
+  model. The search stops as soon as a hypothesis reaches it.
+
+  \param threshold : Threshold for outlier removing.
+
+  \param areaThreshold : When greater than 0, ensure that the area formed by
+  every 3 points within the 4 points used to compute the homography is
+  greater than this threshold.
+
+  \param maxNbTrials : Maximum number of hypotheses that are scored.
+
+  \param blockSize : Number of hypotheses generated and scored together.
+  0 is considered as 1.
+
+  \return true if an homography was found, false otherwise.
+
+  \exception vpException::dimensionError : If less than 4 points are given.
+  \exception vpException::fatalError : If no non degenerate sample could
+  be drawn.
+*/
+bool vpHomography::ransacBatch(unsigned int n,
+                               double *xb, double *yb,
+                               double *xa, double *ya,
+                               vpHomography &bHa,
+                               vpColVector &inliers,
+                               long seed,
+                               unsigned int nbThreads,
+                               int consensus,
+                               double threshold,
+                               double areaThreshold,
+                               unsigned int maxNbTrials,
+                               unsigned int blockSize)
+{
+  if (n < 4) {
+    vpERROR_TRACE("At least 4 points are required, %d given", n);
+    throw(vpException(vpException::dimensionError,
+                      "At least 4 points are required"));
+  }
+  if (nbThreads == 0) nbThreads = 1;
+  if (blockSize == 0) blockSize = 1;
+
+  const double eps = 1e-6;
+  const double p = 0.99;
+  const int maxDataTrials = 1000;
+  const double t2 = threshold * threshold;
+
+  // Only used for the degeneracy test of the samples
+  vpColVector x;
+  vpHomography::initRansac(n, xb, yb, xa, ya, x);
+
+  vpUniRand random(seed);
+  std::vector<unsigned int> sample(4*blockSize);
+  std::vector<double> model(9*blockSize);
+  std::vector<int> score(blockSize);
+
+  double bestM[9];
+  int bestscore = -1;
+  double N = 1;
+  unsigned int trialcount = 0;
+
+  while ((N > trialcount) && (consensus > bestscore)
+         && (trialcount < maxNbTrials)) {
+    unsigned int nb = vpMath::minimum(blockSize, maxNbTrials - trialcount);
+
+    // Draw the samples sequentially to keep the random sequence
+    // independent of the number of threads
+    for (unsigned int b = 0; b < nb; b++) {
+      unsigned int *ind = &sample[4*b];
+      bool degenerate = true;
+      int count = 0;
+      while (degenerate) {
+        for (unsigned int i = 0; i < 4; i++) {
+          ind[i] = (unsigned int)(random() * n);
+          if (ind[i] >= n) ind[i] = n - 1;
+        }
+        if (areaThreshold > 0.)
+          degenerate = degenerateConfiguration(x, ind, areaThreshold);
+        else
+          degenerate = degenerateConfiguration(x, ind);
+
+        if (++count > maxDataTrials) {
+          vpERROR_TRACE("Unable to select a nondegenerate data set");
+          throw(vpException(vpException::fatalError,
+                            "Unable to select a nondegenerate data set"));
+        }
+      }
+    }
+
+    // Estimate and score the hypotheses of the block
+    int nbh = (int)nb;
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel num_threads(nbThreads) if(nbThreads > 1 && nbh > 1)
+#endif
+    {
+      vpHomography aHb;
+      double sxb[4], syb[4], sxa[4], sya[4];
+#ifdef VISP_HAVE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (int b = 0; b < nbh; b++) {
+        const unsigned int *ind = &sample[4*(unsigned int)b];
+        for (unsigned int i = 0; i < 4; i++) {
+          sxb[i] = xb[ind[i]];
+          syb[i] = yb[ind[i]];
+          sxa[i] = xa[ind[i]];
+          sya[i] = ya[ind[i]];
+        }
+
+        double *h = &model[9*(unsigned int)b];
+        score[(unsigned int)b] = -1;
+        try {
+          vpHomography::HLM(4, sxb, syb, sxa, sya, true, aHb);
+        }
+        catch(...) {
+          continue;
+        }
+        if (std::fabs(aHb.data[8]) < std::numeric_limits<double>::epsilon())
+          continue;
+        for (unsigned int i = 0; i < 9; i++)
+          h[i] = aHb.data[i] / aHb.data[8];
+
+        int ninliers = 0;
+        for (unsigned int i = 0; i < n; i++) {
+          double w = h[6]*xb[i] + h[7]*yb[i] + h[8];
+          double u = (h[0]*xb[i] + h[1]*yb[i] + h[2]) / w - xa[i];
+          double v = (h[3]*xb[i] + h[4]*yb[i] + h[5]) / w - ya[i];
+          if (u*u + v*v < t2)
+            ninliers++;
+        }
+        score[(unsigned int)b] = ninliers;
+      }
+    }
+
+    // Reduce in the drawing order, as the serial algorithm would do
+    for (unsigned int b = 0; b < nb; b++) {
+      trialcount++;
+      if (score[b] > bestscore) {
+        bestscore = score[b];
+        for (unsigned int i = 0; i < 9; i++)
+          bestM[i] = model[9*b+i];
+
+        double fracinliers = (double)bestscore / (double)n;
+        double pNoOutliers = 1 - pow(fracinliers, 4);
+        pNoOutliers = vpMath::maximum(eps, pNoOutliers);
+        pNoOutliers = vpMath::minimum(1-eps, pNoOutliers);
+        N = (log(1-p)/log(pNoOutliers));
+      }
+      if ((N <= trialcount) || (consensus <= bestscore))
+        break;
+    }
+  }
+
+  inliers.resize(n);
+  if (bestscore < 0) {
+    vpTRACE("ransac was unable to find a useful solution");
+    inliers = 0;
+    bHa.setIdentity();
+    return false;
+  }
+
+  for (unsigned int i = 0; i < 9; i++)
+    bHa.data[i] = bestM[i];
+
+  for (unsigned int i = 0; i < n; i++) {
+    double w = bestM[6]*xb[i] + bestM[7]*yb[i] + bestM[8];
+    double u = (bestM[0]*xb[i] + bestM[1]*yb[i] + bestM[2]) / w - xa[i];
+    double v = (bestM[3]*xb[i] + bestM[4]*yb[i] + bestM[5]) / w - ya[i];
+    inliers[i] = (u*u + v*v < t2) ? 1 : 0;
+  }
+  return true;
+}
+
 /*
  * Local variables:
  * c-basic-offset: 2
@@ -48,6 +48,7 @@
 #include <visp/vpMatrix.h>
 #include <visp/vpPoint.h>
 #include <visp/vpPlane.h>
+#include <visp/vpSvdSolver.h>
 #include <iostream>
 #include <visp/vpExponentialMap.h>
 
@@ -142,6 +143,8 @@ vpHomography::computeRotation(unsigned int nbpoint,
   robust.setThreshold(0.0000) ;
   vpMatrix W(2*n,2*n)  ;
   W = 0 ;
+  // pseudo inverse of the interaction matrix, reusing its memory
+  vpSvdSolver solver ;
   vpMatrix c2Rc1(3,3) ;
   double r =0 ;
   while (vpMath::equal(r_1,r,threshold_rotation) == false )
@@ -259,7 +262,7 @@ vpHomography::computeRotation(unsigned int nbpoint,
       for (unsigned int k=0 ; k < 2*n ; k++) W[k][k] = 1 ;
     }
     // CreateDiagonalMatrix(w, W) ;
-    (L).pseudoInverse(Lp, 1e-6) ;
+    solver.pseudoInverse(L, Lp, 1e-6) ;
     // Compute the camera velocity
     vpColVector c2Rc1, v(6) ;
 
@@ -339,6 +342,9 @@ vpHomography::computeDisplacement(unsigned int nbpoint,
   robust.setThreshold(0.0000) ;
   vpMatrix W(2*n,2*n)  ;
   W = 0 ;
+  // pseudo inverse of the interaction matrix, reusing its memory
+  vpSvdSolver solver ;
+  vpMatrix WL ;
 
   vpColVector N1(3), N2(3) ;
   double d1, d2 ;
@@ -492,7 +498,8 @@ vpHomography::computeDisplacement(unsigned int nbpoint,
     {
       for (unsigned int k=0 ; k < 2*n ; k++) W[k][k] = 1 ;
     }
-    (W*L).pseudoInverse(Lp, 1e-16) ;
+    WL = W*L ;
+    solver.pseudoInverse(WL, Lp, 1e-16) ;
     // Compute the camera velocity
     vpColVector c2Tcc1 ;
 
@@ -560,6 +567,9 @@ vpHomography::computeDisplacement(unsigned int nbpoint,
   robust.setThreshold(0.0000) ;
   vpMatrix W(2*n,2*n)  ;
   W = 0 ;
+  // pseudo inverse of the interaction matrix, reusing its memory
+  vpSvdSolver solver ;
+  vpMatrix WL ;
 
   vpColVector N1(3), N2(3) ;
   double d1, d2 ;
@@ -713,7 +723,8 @@ vpHomography::computeDisplacement(unsigned int nbpoint,
     {
       for (unsigned int k=0 ; k < 2*n ; k++) W[k][k] = 1 ;
     }
-    (W*L).pseudoInverse(Lp, 1e-16) ;
+    WL = W*L ;
+    solver.pseudoInverse(WL, Lp, 1e-16) ;
     // Compute the camera velocity
     vpColVector c2Tcc1 ;
 
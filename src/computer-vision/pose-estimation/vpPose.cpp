@@ -83,6 +83,9 @@ vpPose::init()
   computeCovariance = false;
   
   ransacMaxTrials = 1000;
+  ransacMethod = RANSAC_STANDARD;
+  ransacSeed = 0;
+  ransacNbTrials = 0;
 
 #if (DEBUG_LEVEL1)
   std::cout << "end vpPose::Init() " << std::endl ;
@@ -413,7 +416,10 @@ vpPose::computePose(vpPoseMethodType methode, vpHomogeneousMatrix& cMo)
         "Not enough points ")) ;
     }
     try {
-      poseRansac(cMo);
+      if (ransacMethod == RANSAC_STANDARD)
+        poseRansac(cMo);
+      else
+        poseRansacAdaptive(cMo);
     }
     catch(...)
     {
@@ -93,6 +93,24 @@ public:
       LAGRANGE_VIRTUAL_VS
     } vpPoseMethodType;
 
+  /*!
+    Algorithm used by computePose() when the RANSAC method is selected.
+    \sa setRansacMethod()
+  */
+  typedef enum
+    {
+      RANSAC_STANDARD, /*!< Draw samples until the consensus is reached
+                         (see poseRansac()). */
+      RANSAC_ADAPTIVE, /*!< Adaptive number of trials, pre-test of each
+                         hypothesis on a random point and early exit of
+                         the consensus evaluation (see
+                         poseRansacAdaptive()). */
+      RANSAC_PROSAC    /*!< Same as RANSAC_ADAPTIVE but the samples are
+                         drawn progressively from the points with the best
+                         quality. The points have to be added by decreasing
+                         quality. */
+    } vpRansacMethodType;
+
   unsigned int npt ;       //!< number of point used in pose computation
   std::list<vpPoint> listP ;     //!< array of point (use here class vpPoint)
 
@@ -114,6 +132,9 @@ private:
   int ransacMaxTrials;
   std::vector<vpPoint> ransacInliers;
   double ransacThreshold;
+  vpRansacMethodType ransacMethod;
+  unsigned int ransacSeed;
+  unsigned int ransacNbTrials;
 
 protected:
   double computeResidualDementhon(vpHomogeneousMatrix &cMo) ;
@@ -161,10 +182,14 @@ public:
   void poseLowe(vpHomogeneousMatrix & cMo) ;
   //! compute the pose using the Ransac approach 
   void poseRansac(vpHomogeneousMatrix & cMo) ;  
+  //! compute the pose using the Ransac approach with an adaptive number of trials
+  void poseRansacAdaptive(vpHomogeneousMatrix & cMo) ;
   //! compute the pose using a robust virtual visual servoing approach
   void poseVirtualVSrobust(vpHomogeneousMatrix & cMo) ;
   //! compute the pose using virtual visual servoing approach
   void poseVirtualVS(vpHomogeneousMatrix & cMo) ;
+  static void poseVirtualVS(const std::vector<vpPose *> &poses,
+                            std::vector<vpHomogeneousMatrix> &cMo) ;
   void printPoint() ; 
   void setDistanceToPlaneForCoplanarityTest(double d) ;
   void setLambda(double a) { lambda = a ; }
@@ -175,6 +200,29 @@ public:
   void setRansacMaxTrials(const int &rM){ ransacMaxTrials = rM; }
   int  getRansacNbInliers(){ return ransacInliers.size(); }
   std::vector<vpPoint> getRansacInliers(){ return ransacInliers; }
+  /*!
+    Set the algorithm used when the pose is computed with the RANSAC method.
+    The default is vpPose::RANSAC_STANDARD.
+
+    \param m : The RANSAC algorithm.
+  */
+  void setRansacMethod(const vpRansacMethodType &m){ ransacMethod = m; }
+  /*!
+    \return The algorithm used when the pose is computed with the RANSAC method.
+  */
+  vpRansacMethodType getRansacMethod() const { return ransacMethod; }
+  /*!
+    Set the seed of the random generator used by poseRansacAdaptive(). With
+    the same seed and the same points, the same pose is computed.
+
+    \param seed : The seed.
+  */
+  void setRansacSeed(const unsigned int &seed){ ransacSeed = seed; }
+  /*!
+    \return The number of samples drawn by the last call to
+    poseRansacAdaptive().
+  */
+  unsigned int getRansacNbTrials() const { return ransacNbTrials; }
   
   /*!
     Set if the covaraince matrix has to be computed in the Virtual Visual Servoing approach.
@@ -39,6 +39,7 @@
  *
  *****************************************************************************/
 #include <visp/vpPoseFeatures.h>
+#include <visp/vpSvdSolver.h>
 
 /*!
   Default constructor.
@@ -453,6 +454,9 @@ void vpPoseFeatures::computePoseVVS(vpHomogeneousMatrix & cMo)
     vpMatrix L;
     vpColVector err;
     vpColVector v ;
+    // pseudo inverse of the interaction matrix, reusing its memory
+    vpSvdSolver solver;
+    vpMatrix Lp ;
     
     unsigned int iter = 0;
     
@@ -467,8 +471,7 @@ void vpPoseFeatures::computePoseVVS(vpHomogeneousMatrix & cMo)
       r = err.sumSquare() ;
 
       // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      int rank = L.pseudoInverse(Lp,1e-16) ;
+      int rank = (int)solver.pseudoInverse(L, Lp, 1e-16) ;
       
       if(rank < 6){
         if(verbose)
@@ -522,6 +525,9 @@ void vpPoseFeatures::computePoseRobustVVS(vpHomogeneousMatrix & cMo)
     vpColVector w, res;
     vpColVector v ;
     vpColVector error ; // error vector
+    // pseudo inverse of the interaction matrix, reusing its memory
+    vpSvdSolver solver;
+    vpMatrix Lp, LRank, WL;
     
     vpRobust robust(2*totalSize) ;
     robust.setThreshold(0.0000) ;
@@ -559,10 +565,9 @@ void vpPoseFeatures::computePoseRobustVVS(vpHomogeneousMatrix & cMo)
         W[2*k+1][2*k+1] = w[k] ;
       }
       // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      vpMatrix LRank;
-      (W*L).pseudoInverse(Lp,1e-6) ;
-      int rank = L.pseudoInverse(LRank,1e-6) ;
+      WL = W*L ;
+      solver.pseudoInverse(WL, Lp, 1e-6) ;
+      int rank = (int)solver.pseudoInverse(L, LRank, 1e-6) ;
       
       if(rank < 6){
         if(verbose)
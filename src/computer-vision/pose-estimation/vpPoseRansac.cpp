@@ -60,6 +60,45 @@
 
 #define eps 1e-6
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Xorshift random generator. Unlike rand(), its state is local so that
+    the result only depends on the seed.
+  */
+  class vpRansacRand
+  {
+  public:
+    vpRansacRand(unsigned int seed) : state(seed * 2654435761u + 0x9e3779b9u)
+    {
+      if (state == 0) state = 0x9e3779b9u;
+    }
+    //! Uniform integer in [0, n)
+    unsigned int operator()(unsigned int n)
+    {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return (unsigned int)(((double)state / 4294967296.0) * n);
+    }
+  private:
+    unsigned int state;
+  };
+
+  /*
+    Squared reprojection error of the point (X, Y, Z) observed at (x, y).
+  */
+  inline double squaredError(const vpHomogeneousMatrix &cMo,
+                             double x, double y, double X, double Y, double Z)
+  {
+    double Xc = cMo[0][0]*X + cMo[0][1]*Y + cMo[0][2]*Z + cMo[0][3];
+    double Yc = cMo[1][0]*X + cMo[1][1]*Y + cMo[1][2]*Z + cMo[1][3];
+    double Zc = cMo[2][0]*X + cMo[2][1]*Y + cMo[2][2]*Z + cMo[2][3];
+    return vpMath::sqr(x - Xc/Zc) + vpMath::sqr(y - Yc/Zc);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*! 
   Compute the pose using the Ransac approach. 
@@ -199,6 +238,205 @@ void vpPose::poseRansac(vpHomogeneousMatrix & cMo)
   }
 }
 
+/*!
+  Compute the pose using an adaptive Ransac approach. This method is
+  called by computePose() with the vpPose::RANSAC method when
+  setRansacMethod() was called with vpPose::RANSAC_ADAPTIVE or
+  vpPose::RANSAC_PROSAC.
+
+  Compared to poseRansac():
+  - the coordinates of the points are copied once in contiguous arrays;
+  - the samples are drawn with a random generator whose seed is set with
+    setRansacSeed();
+  - each hypothesis is first checked on a random point that is not part of
+    the sample (\f$T_{1,1}\f$ pre-test, skipped when there are only four
+    points). The other points are only
+    evaluated if this point is an inlier, and the evaluation stops as soon
+    as the hypothesis can not have more inliers than the best one;
+  - the number of trials is computed from the inlier ratio of the best
+    hypothesis to reach a 99% probability of drawing a sample free of
+    outliers. It is bounded by setRansacMaxTrials();
+  - with vpPose::RANSAC_PROSAC, the samples are first drawn among the
+    first points added with addPoint(), then progressively among all the
+    points. The points have to be added by decreasing quality, for example
+    by increasing matching distance.
+
+  As with poseRansac(), the pose is refined on the inliers with
+  vpPose::LAGRANGE_VIRTUAL_VS if at least the number of inliers set with
+  setRansacNbInliersToReachConsensus() is found, and the inliers given by
+  getRansacInliers() are the points added with addPoint(). The number of
+  samples drawn is given by getRansacNbTrials().
+
+  \param cMo : Computed pose. It is not modified if the consensus is not
+  reached.
+
+  \exception vpPoseException::notEnoughPointError : If less than four
+  points were added.
+
+  \exception vpPoseException::poseError : If no hypothesis reached the
+  number of inliers set with setRansacNbInliersToReachConsensus().
+*/
+void vpPose::poseRansacAdaptive(vpHomogeneousMatrix & cMo)
+{
+  const unsigned int nbMinRandom = 4;
+  const double probability = 0.99;
+  const unsigned int nbMaxDegenerate = 100;
+
+  unsigned int size = (unsigned int)listP.size();
+  ransacInliers.clear();
+  ransacNbTrials = 0;
+  if (size < nbMinRandom) {
+    vpERROR_TRACE("Not enough point (%d) to compute the pose  ", size) ;
+    throw(vpPoseException(vpPoseException::notEnoughPointError,
+                          "Not enough points ")) ;
+  }
+
+  // Structure of arrays of the coordinates, and the points they come from
+  std::vector<double> x(size), y(size), X(size), Y(size), Z(size);
+  std::vector<const vpPoint *> points(size);
+  unsigned int k = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it, k++) {
+    points[k] = &(*it);
+    x[k] = it->get_x();
+    y[k] = it->get_y();
+    X[k] = it->get_oX();
+    Y[k] = it->get_oY();
+    Z[k] = it->get_oZ();
+  }
+
+  vpRansacRand rnd(ransacSeed);
+  double threshold2 = vpMath::sqr(ransacThreshold);
+  std::vector<unsigned int> best_consensus;
+  std::vector<unsigned int> cur_consensus;
+  cur_consensus.reserve(size);
+  vpHomogeneousMatrix cMo_cur, cMo_best;
+  unsigned int nbInliers = 0;
+  unsigned int nbTrialsMax = (ransacMaxTrials > 0) ? (unsigned int)ransacMaxTrials : 0;
+
+  // PROSAC growth function: the samples are drawn among the n first points
+  bool prosac = (ransacMethod == RANSAC_PROSAC);
+  unsigned int n = prosac ? nbMinRandom : size;
+  double Tn = (double)nbTrialsMax;
+  for (unsigned int i = 0; i < nbMinRandom; i++)
+    Tn *= (double)(nbMinRandom - i) / (double)(size - i);
+  unsigned int TnPrime = 1;
+
+  unsigned int sample[4];
+  while (ransacNbTrials < nbTrialsMax)
+  {
+    ransacNbTrials++;
+    bool useLast = false;
+    if (prosac) {
+      while (ransacNbTrials == TnPrime && n < size) {
+        double Tn1 = Tn * (double)(n + 1) / (double)(n + 1 - nbMinRandom);
+        TnPrime += (unsigned int)ceil(Tn1 - Tn);
+        Tn = Tn1;
+        n++;
+      }
+      // Until the end of the stage n, the sample contains the point n-1
+      useLast = (TnPrime >= ransacNbTrials);
+    }
+
+    // Draw a non degenerate sample
+    unsigned int nbPicked = 0;
+    unsigned int nbDegenerate = 0;
+    if (useLast) {
+      sample[nbPicked++] = n - 1;
+    }
+    unsigned int range = useLast ? n - 1 : n;
+    while (nbPicked < nbMinRandom && nbDegenerate < nbMaxDegenerate) {
+      unsigned int r = rnd(range);
+      bool degenerate = false;
+      for (unsigned int i = 0; i < nbPicked; i++) {
+        unsigned int s = sample[i];
+        if( (r == s) ||
+            ((fabs(x[r] - x[s]) < eps) && (fabs(y[r] - y[s]) < eps)) ||
+            ((fabs(X[r] - X[s]) < eps) && (fabs(Y[r] - Y[s]) < eps) && (fabs(Z[r] - Z[s]) < eps))){
+          degenerate = true;
+          break;
+        }
+      }
+      if (degenerate)
+        nbDegenerate++;
+      else
+        sample[nbPicked++] = r;
+    }
+    if (nbPicked < nbMinRandom)
+      continue;
+
+    vpPose poseMin ;
+    for (unsigned int i = 0; i < nbMinRandom; i++)
+      poseMin.addPoint(*points[sample[i]]);
+    try {
+      poseMin.computePose(vpPose::DEMENTHON, cMo_cur) ;
+    }
+    catch(...) {
+      continue;
+    }
+    double r = sqrt(poseMin.computeResidual(cMo_cur))/(double)nbMinRandom;
+    if (! (r < ransacThreshold))
+      continue;
+
+    // T(1,1) pre-test on a random point that is not part of the sample
+    if (size > nbMinRandom) {
+      unsigned int t;
+      bool inSample;
+      do {
+        t = rnd(size);
+        inSample = false;
+        for (unsigned int i = 0; i < nbMinRandom; i++)
+          inSample = inSample || (t == sample[i]);
+      } while (inSample);
+      if (! (squaredError(cMo_cur, x[t], y[t], X[t], Y[t], Z[t]) < threshold2))
+        continue;
+    }
+
+    // Consensus, stopped as soon as the best one can not be improved
+    cur_consensus.clear();
+    for (unsigned int i = 0; i < size; i++) {
+      if (squaredError(cMo_cur, x[i], y[i], X[i], Y[i], Z[i]) < threshold2)
+        cur_consensus.push_back(i);
+      else if (cur_consensus.size() + (size - i - 1) <= nbInliers)
+        break;
+    }
+
+    if (cur_consensus.size() > nbInliers) {
+      best_consensus = cur_consensus;
+      nbInliers = (unsigned int)cur_consensus.size();
+      cMo_best = cMo_cur;
+
+      // Update the number of trials from the inlier ratio
+      double w = (double)nbInliers / (double)size;
+      double pGood = pow(w, (int)nbMinRandom + 1);
+      if (pGood >= 1.) {
+        nbTrialsMax = ransacNbTrials;
+      }
+      else if (pGood > 0.) {
+        double nbTrials = log(1. - probability) / log(1. - pGood);
+        if (nbTrials < (double)nbTrialsMax)
+          nbTrialsMax = (unsigned int)ceil(nbTrials);
+      }
+    }
+  }
+
+  if ((nbInliers == 0) || (nbInliers < (unsigned)ransacNbInlierConsensus)) {
+    vpERROR_TRACE("Ransac found %d inliers, %d are required",
+                  nbInliers, ransacNbInlierConsensus) ;
+    throw(vpPoseException(vpPoseException::poseError,
+                          "Ransac did not reach the consensus")) ;
+  }
+
+  vpPose pose ;
+  for(unsigned i = 0 ; i < best_consensus.size(); i++)
+  {
+    const vpPoint &pt = *points[best_consensus[i]];
+    pose.addPoint(pt) ;
+    ransacInliers.push_back(pt);
+  }
+  cMo = cMo_best;
+  pose.computePose(vpPose::LAGRANGE_VIRTUAL_VS,cMo) ;
+}
+
 /*!
   Match a vector p2D of  2D point (x,y)  and  a vector p3D of 3D points
   (X,Y,Z) using the Ransac algorithm.
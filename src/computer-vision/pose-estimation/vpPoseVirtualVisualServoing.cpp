@@ -50,6 +50,8 @@
 #include <visp/vpFeaturePoint.h>
 #include <visp/vpExponentialMap.h>
 #include <visp/vpRobust.h>
+#include <visp/vpSvdSolver.h>
+#include <visp/vpBatchSolver.h>
 
 /*!
   \brief Compute the pose using virtual visual servoing approach
@@ -81,6 +83,10 @@ vpPose::poseVirtualVS(vpHomogeneousMatrix & cMo)
     vpColVector err(2*nb) ;
     vpColVector sd(2*nb),s(2*nb) ;
     vpColVector v ;
+
+    // pseudo inverse of the interaction matrix, reusing its memory
+    vpSvdSolver solver(2*nb, 6) ;
+    vpMatrix Lp ;
     
     vpPoint P;
     std::list<vpPoint> lP ;
@@ -135,8 +141,7 @@ vpPose::poseVirtualVS(vpHomogeneousMatrix & cMo)
       r = err.sumSquare() ;
 
       // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      L.pseudoInverse(Lp,1e-16) ;
+      solver.pseudoInverse(L, Lp, 1e-16) ;
 
       // compute the VVS control law
       v = -lambda*Lp*err ;
@@ -159,6 +164,161 @@ vpPose::poseVirtualVS(vpHomogeneousMatrix & cMo)
   }
 }
 
+/*!
+  \brief Compute the poses of several independent problems using the
+  virtual visual servoing approach.
+
+  This is equivalent to calling poseVirtualVS(vpHomogeneousMatrix &) on
+  each pose, but the 6x6 normal equations of all the poses are solved
+  together at each iteration by a vpBatchSolver. Each pose keeps its own
+  gain, maximal number of iterations and stopping criterion; it is
+  removed from the batch once it has converged.
+
+  \param poses : The pose problems, whose points must be set.
+  \param cMo : On input the initial poses, on output the estimated
+  poses. Its size must be the number of poses.
+*/
+void
+vpPose::poseVirtualVS(const std::vector<vpPose *> &poses,
+                      std::vector<vpHomogeneousMatrix> &cMo)
+{
+  if (poses.size() != cMo.size())
+  {
+    vpERROR_TRACE("Different number of poses and initial poses") ;
+    throw(vpException(vpException::dimensionError,
+                      "Different number of poses and initial poses")) ;
+  }
+
+  try
+  {
+    unsigned int n = poses.size() ;
+    vpBatchSolver batch(n) ;
+
+    std::vector<vpMatrix> L(n) ;
+    std::vector<vpColVector> err(n), sd(n), v(n) ;
+    std::vector<std::list<vpPoint> > lP(n) ;
+    std::vector<double> residu_1(n, 1e8), r(n, 1e8-1) ;
+    std::vector<int> iter(n, 0) ;
+    std::vector<bool> active(n, true) ;
+    unsigned int nactive = n ;
+
+    // systems of the converged poses
+    vpMatrix I ;
+    I.eye(6) ;
+    vpColVector zero(6) ;
+
+    // create sd
+    for (unsigned int i=0 ; i < n ; i++)
+    {
+      unsigned int nb = poses[i]->listP.size() ;
+      L[i].resize(2*nb, 6) ;
+      err[i].resize(2*nb) ;
+      sd[i].resize(2*nb) ;
+      unsigned int k =0 ;
+      for (std::list<vpPoint>::const_iterator it = poses[i]->listP.begin(); it != poses[i]->listP.end(); ++it)
+      {
+        sd[i][2*k] = it->get_x() ;
+        sd[i][2*k+1] = it->get_y() ;
+        lP[i].push_back(*it) ;
+        k ++;
+      }
+    }
+
+    vpPoint P ;
+    while (nactive != 0)
+    {
+      for (unsigned int i=0 ; i < n ; i++)
+      {
+        if (! active[i])
+          continue ;
+
+        // we stop the minimization when the error is bellow 1e-8
+        if ((int)((residu_1[i] - r[i])*1e12) == 0)
+        {
+          active[i] = false ;
+          nactive-- ;
+          batch.setSystem(i, I, zero) ;
+          continue ;
+        }
+        residu_1[i] = r[i] ;
+
+        // Compute the interaction matrix and the error
+        unsigned int k =0 ;
+        for (std::list<vpPoint>::const_iterator it = lP[i].begin(); it != lP[i].end(); ++it)
+        {
+          P = *it;
+          // forward projection of the 3D model for a given pose
+          P.track(cMo[i]) ;
+
+          double x = P.get_x();  /* point projected from cMo */
+          double y = P.get_y();
+          double Z = P.get_Z() ;
+          err[i][2*k] = x - sd[i][2*k] ;
+          err[i][2*k+1] = y - sd[i][2*k+1] ;
+
+          L[i][2*k][0] = -1/Z  ;
+          L[i][2*k][1] = 0 ;
+          L[i][2*k][2] = x/Z ;
+          L[i][2*k][3] = x*y ;
+          L[i][2*k][4] = -(1+x*x) ;
+          L[i][2*k][5] = y ;
+
+          L[i][2*k+1][0] = 0 ;
+          L[i][2*k+1][1]  = -1/Z ;
+          L[i][2*k+1][2] = y/Z ;
+          L[i][2*k+1][3] = 1+y*y ;
+          L[i][2*k+1][4] = -x*y ;
+          L[i][2*k+1][5] = -x ;
+
+          k+=1 ;
+        }
+
+        // compute the residual
+        r[i] = err[i].sumSquare() ;
+
+        // normal equations L^T L v = L^T err
+        batch.setLeastSquares(i, L[i], err[i]) ;
+      }
+
+      if (nactive == 0)
+        break ;
+
+      batch.solve() ;
+
+      for (unsigned int i=0 ; i < n ; i++)
+      {
+        if (! active[i])
+          continue ;
+
+        // compute the VVS control law
+        batch.getSolution(i, v[i]) ;
+        v[i] *= -poses[i]->lambda ;
+
+        // update the pose
+        cMo[i] = vpExponentialMap::direct(v[i]).inverse()*cMo[i] ;
+        if (iter[i]++ > poses[i]->vvsIterMax)
+        {
+          active[i] = false ;
+          nactive-- ;
+          batch.setSystem(i, I, zero) ;
+        }
+      }
+    }
+
+    for (unsigned int i=0 ; i < n ; i++)
+    {
+      if (poses[i]->computeCovariance)
+        poses[i]->covarianceMatrix =
+          vpMatrix::computeCovarianceMatrix(L[i], v[i], vpColVector(-poses[i]->lambda*err[i])) ;
+    }
+  }
+  catch(...)
+  {
+    vpERROR_TRACE(" ") ;
+    throw ;
+  }
+}
+
 /*!
   \brief Compute the pose using virtual visual servoing approach and
   a robust cotrol law
@@ -190,6 +350,10 @@ vpPose::poseVirtualVSrobust(vpHomogeneousMatrix & cMo)
     vpColVector sd(2*nb),s(2*nb) ;
     vpColVector v ;
 
+    // pseudo inverse of the interaction matrix, reusing its memory
+    vpSvdSolver solver(2*nb, 6) ;
+    vpMatrix Lp, WL ;
+
     listP.front() ;
     vpPoint P;
     std::list<vpPoint> lP ;
@@ -264,8 +428,8 @@ vpPose::poseVirtualVSrobust(vpHomogeneousMatrix & cMo)
         W[2*k+1][2*k+1] = w[k] ;
       }
       // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      (W*L).pseudoInverse(Lp,1e-6) ;
+      WL = W*L ;
+      solver.pseudoInverse(WL, Lp, 1e-6) ;
 
       // compute the VVS control law
       v = -lambda*Lp*W*error ;
@@ -41,6 +41,10 @@
 
 
 #include <visp/vpDiskGrabber.h>
+#include <visp/vpImageException.h>
+
+#include <ctype.h>
+#include <string.h>
 
 
 /*!
@@ -48,6 +52,8 @@
 */
 vpDiskGrabber::vpDiskGrabber()
 {
+  initPrefetch();
+
   setDirectory("/tmp");
   setBaseName("I");
   setImageNumber(0);
@@ -62,6 +68,8 @@ vpDiskGrabber::vpDiskGrabber()
 
 vpDiskGrabber::vpDiskGrabber(const char *genericName)
 {
+  initPrefetch();
+
   strcpy(this->genericName, genericName);
   useGenericName = true;
 }
@@ -83,6 +91,8 @@ vpDiskGrabber::vpDiskGrabber(const char *dir, const char *basename,
                              int step, unsigned int noz,
                              const char *ext)
 {
+  initPrefetch();
+
   setDirectory(dir);
   setBaseName(basename);
   setImageNumber(number);
@@ -144,22 +154,11 @@ vpDiskGrabber::open(vpImage<vpRGBa> &I)
 void
 vpDiskGrabber::acquire(vpImage<unsigned char> &I)
 {
-
-  char name[FILENAME_MAX] ;
-
-  if(useGenericName)
-    sprintf(name,genericName,image_number) ;
-  else
-    sprintf(name,"%s/%s%0*ld.%s",directory,base_name,number_of_zero,image_number,extension) ;
+  long number = image_number ;
 
   image_number += image_step ;
 
-  vpDEBUG_TRACE(2, "load: %s\n", name);
-
-  vpImageIo::read(I, name) ;
-
-  width = I.getWidth();
-  height = I.getHeight();
+  acquire(I, number) ;
 }
 
 /*!
@@ -171,46 +170,43 @@ vpDiskGrabber::acquire(vpImage<unsigned char> &I)
 void
 vpDiskGrabber::acquire(vpImage<vpRGBa> &I)
 {
-
-  char name[FILENAME_MAX] ;
-
-  if(useGenericName)
-    sprintf(name,genericName,image_number) ;
-  else
-    sprintf(name,"%s/%s%0*ld.%s",directory,base_name,number_of_zero,image_number,extension) ;
+  long number = image_number ;
 
   image_number += image_step ;
 
-  vpDEBUG_TRACE(2, "load: %s\n", name);
-
-  vpImageIo::read(I, name) ;
-
-  width = I.getWidth();
-  height = I.getHeight();
-
+  acquire(I, number) ;
 }
 
 /*!
   Acquire an image: read a pgm image from the disk.
   After this call, the image number is incremented considering the step.
 
+  When the prefetch is enabled (see setPrefetch()), the image is taken
+  from the frames already decoded by the prefetch thread.
+
   \param I the read image
   \param image_number The index of the desired image.
  */
 void
 vpDiskGrabber::acquire(vpImage<unsigned char> &I, long image_number)
 {
-
-  char name[FILENAME_MAX] ;
-
-  if(useGenericName)
-    sprintf(name,genericName,image_number) ;
+#ifdef VISP_HAVE_PTHREAD
+  if (prefetchDepth > 0) {
+    vpPrefetchSlot &slot = waitFrame(image_number, false) ;
+    if (! slot.failed)
+      I = slot.I ;
+    releaseFrame(slot) ;
+  }
   else
-    sprintf(name,"%s/%s%0*ld.%s",directory,base_name,number_of_zero,image_number,extension) ;
+#endif
+  {
+    char name[FILENAME_MAX] ;
+    buildName(image_number, name) ;
 
-  vpDEBUG_TRACE(2, "load: %s\n", name);
+    vpDEBUG_TRACE(2, "load: %s\n", name);
 
-  vpImageIo::read(I, name) ;
+    read(pnmReader, I, name) ;
+  }
 
   width = I.getWidth();
   height = I.getHeight();
@@ -220,49 +216,340 @@ vpDiskGrabber::acquire(vpImage<unsigned char> &I, long image_number)
   Acquire an image: read a ppm image from the disk.
   After this call, the image number is incremented considering the step.
 
+  When the prefetch is enabled (see setPrefetch()), the image is taken
+  from the frames already decoded by the prefetch thread.
+
   \param I the read image
   \param image_number The index of the desired image.
  */
 void
 vpDiskGrabber::acquire(vpImage<vpRGBa> &I, long image_number)
 {
-
-  char name[FILENAME_MAX] ;
-
-  if(useGenericName)
-    sprintf(name,genericName,image_number) ;
+#ifdef VISP_HAVE_PTHREAD
+  if (prefetchDepth > 0) {
+    vpPrefetchSlot &slot = waitFrame(image_number, true) ;
+    if (! slot.failed)
+      I = slot.Irgba ;
+    releaseFrame(slot) ;
+  }
   else
-    sprintf(name,"%s/%s%0*ld.%s",directory,base_name,number_of_zero,image_number,extension) ;
+#endif
+  {
+    char name[FILENAME_MAX] ;
+    buildName(image_number, name) ;
 
-  vpDEBUG_TRACE(2, "load: %s\n", name);
+    vpDEBUG_TRACE(2, "load: %s\n", name);
 
-  vpImageIo::read(I, name) ;
+    read(pnmReader, I, name) ;
+  }
 
   width = I.getWidth();
   height = I.getHeight();
+}
+
+/*
+  Build the name of the image file of the given number.
+*/
+void
+vpDiskGrabber::buildName(long number, char *name) const
+{
+  if(useGenericName)
+    sprintf(name,genericName,number) ;
+  else
+    sprintf(name,"%s/%s%0*ld.%s",directory,base_name,number_of_zero,number,extension) ;
+}
+
+/*
+  Return true if the file name has a pgm or ppm extension, whatever the
+  case.
+*/
+bool
+vpDiskGrabber::isPNM(const char *name)
+{
+  const char *dot = strrchr(name, '.');
+  if ((dot == NULL) || (strlen(dot) != 4))
+    return false;
+  char ext[4];
+  for (int i = 0; i < 3; i++)
+    ext[i] = (char)tolower(dot[i+1]);
+  ext[3] = '\0';
+  return (strcmp(ext, "pgm") == 0) || (strcmp(ext, "ppm") == 0);
+}
 
+/*
+  Read an image file. PNM files are read with the given reader, which
+  keeps the header of the sequence, the other formats with vpImageIo.
+*/
+void
+vpDiskGrabber::read(vpPNMReader &reader, vpImage<unsigned char> &I,
+                    const char *name)
+{
+  if (isPNM(name)) {
+    reader.open(name) ;
+    reader.read(I) ;
+    reader.close() ;
+  }
+  else
+    vpImageIo::read(I, name) ;
+}
+
+void
+vpDiskGrabber::read(vpPNMReader &reader, vpImage<vpRGBa> &I,
+                    const char *name)
+{
+  if (isPNM(name)) {
+    reader.open(name) ;
+    reader.read(I) ;
+    reader.close() ;
+  }
+  else
+    vpImageIo::read(I, name) ;
 }
 
 /*!
-  Not useful
+  Set the number of frames decoded in advance by a background thread.
+
+  With a depth of \e n, a thread reads the \e n images that follow the
+  last acquired one while the caller processes it, so that acquire()
+  usually returns without waiting for the disk or the decoder. The
+  prefetched images follow the current image number and step. A call to
+  acquire() with another number, or after setImageNumber(), setStep()
+  or a change of the pixel type, restarts the prefetch from the
+  requested image. When an image cannot be read, for instance at the end
+  of the sequence, acquire() throws the same exception as without
+  prefetch when it reaches this image.
+
+  The prefetch needs ViSP to be built with pthread. Otherwise the images
+  are read by acquire() as when the depth is 0.
+
+  \param depth : Number of prefetched frames. 0, the default, disables
+  the prefetch.
+
+  \sa getPrefetch()
+*/
+void
+vpDiskGrabber::setPrefetch(unsigned int depth)
+{
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
+  prefetchDepth = depth ;
+}
 
-  Here for compatibility issue with the vpFrameGrabber class
+/*!
+  Stop the prefetch thread. The next call to acquire() starts it again
+  if the prefetch is enabled.
  */
 void
 vpDiskGrabber::close()
 {
-  // Nothing do do here...
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
 }
 
 
 /*!
   Destructor
 
-  In fact nothing to destroy...
+  Stop the prefetch thread.
  */
 vpDiskGrabber::~vpDiskGrabber()
 {
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+  pthread_cond_destroy(&prefetchCond) ;
+  pthread_mutex_destroy(&prefetchMutex) ;
+#endif
+}
+
+void
+vpDiskGrabber::initPrefetch()
+{
+  prefetchDepth = 0 ;
+#ifdef VISP_HAVE_PTHREAD
+  pthread_mutex_init(&prefetchMutex, NULL) ;
+  pthread_cond_init(&prefetchCond, NULL) ;
+  prefetchRunning = false ;
+  prefetchStop = false ;
+  prefetchHead = 0 ;
+  prefetchCount = 0 ;
+  prefetchNumber = 0 ;
+  prefetchStep = 1 ;
+  prefetchColor = false ;
+  prefetchEnd = true ;
+  prefetchGeneration = 0 ;
+#endif
+}
+
+#ifdef VISP_HAVE_PTHREAD
+void
+vpDiskGrabber::startPrefetch()
+{
+  prefetchRing.resize(prefetchDepth) ;
+  prefetchStop = false ;
+  prefetchHead = 0 ;
+  prefetchCount = 0 ;
+  // Nothing to read until waitFrame() gives the first image number
+  prefetchEnd = true ;
+  if (pthread_create(&prefetchThread, NULL, prefetchLauncher, (void *)this) != 0) {
+    vpERROR_TRACE("cannot create the prefetch thread") ;
+    throw (vpImageException(vpImageException::ioError,
+                            "cannot create the prefetch thread")) ;
+  }
+  prefetchRunning = true ;
+}
+
+void
+vpDiskGrabber::stopPrefetch()
+{
+  if (! prefetchRunning)
+    return ;
+
+  pthread_mutex_lock(&prefetchMutex) ;
+  prefetchStop = true ;
+  pthread_cond_broadcast(&prefetchCond) ;
+  pthread_mutex_unlock(&prefetchMutex) ;
+  pthread_join(prefetchThread, NULL) ;
+
+  prefetchRunning = false ;
+  prefetchCount = 0 ;
+  prefetchEnd = true ;
+}
+
+void *
+vpDiskGrabber::prefetchLauncher(void *arg)
+{
+  ((vpDiskGrabber *)arg)->prefetchLoop() ;
+  return NULL ;
+}
+
+/*
+  Body of the prefetch thread. The slots are filled in the ring order.
+  A slot reserved by the thread is only accessed by it until it is
+  marked ready, and a ready slot only by the caller of acquire() until
+  it is released, so that the images are read and copied without lock.
+  A frame read for a previous generation of the ring is dropped.
+*/
+void
+vpDiskGrabber::prefetchLoop()
+{
+  // The header cache of this reader follows the prefetched frames
+  vpPNMReader reader ;
+  char name[FILENAME_MAX] ;
+
+  pthread_mutex_lock(&prefetchMutex) ;
+  while (! prefetchStop) {
+    if (prefetchEnd || (prefetchCount == prefetchRing.size())) {
+      pthread_cond_wait(&prefetchCond, &prefetchMutex) ;
+      continue ;
+    }
+
+    vpPrefetchSlot &slot = prefetchRing[(prefetchHead + prefetchCount) % prefetchRing.size()] ;
+    slot.number = prefetchNumber ;
+    slot.ready = false ;
+    bool color = prefetchColor ;
+    unsigned long generation = prefetchGeneration ;
+    buildName(prefetchNumber, name) ;
+    prefetchNumber += prefetchStep ;
+    prefetchCount++ ;
+    pthread_mutex_unlock(&prefetchMutex) ;
+
+    bool failed = false ;
+    std::string message ;
+    try {
+      if (color)
+        read(reader, slot.Irgba, name) ;
+      else
+        read(reader, slot.I, name) ;
+    }
+    catch(vpException &e) {
+      failed = true ;
+      message = e.getStringMessage() ;
+    }
+    catch(...) {
+      failed = true ;
+      message = "cannot read file" ;
+    }
+
+    pthread_mutex_lock(&prefetchMutex) ;
+    if (generation == prefetchGeneration) {
+      slot.failed = failed ;
+      slot.message = message ;
+      slot.ready = true ;
+      // Stop at the first image that cannot be read
+      if (failed)
+        prefetchEnd = true ;
+      pthread_cond_broadcast(&prefetchCond) ;
+    }
+  }
+  pthread_mutex_unlock(&prefetchMutex) ;
+}
+
+/*
+  Wait until the image of the given number is decoded in the given
+  pixel type, and return its slot. The ring is restarted from this
+  image when it does not follow the prefetched ones.
+*/
+vpDiskGrabber::vpPrefetchSlot &
+vpDiskGrabber::waitFrame(long number, bool color)
+{
+  if (! prefetchRunning)
+    startPrefetch() ;
+
+  pthread_mutex_lock(&prefetchMutex) ;
+
+  bool follows ;
+  if (prefetchCount > 0)
+    follows = (prefetchRing[prefetchHead].number == number) ;
+  else
+    follows = (prefetchNumber == number) && ! prefetchEnd ;
+
+  if (! follows || (prefetchColor != color) || (prefetchStep != image_step)) {
+    prefetchGeneration++ ;
+    for (unsigned int i = 0; i < prefetchRing.size(); i++)
+      prefetchRing[i].ready = false ;
+    prefetchHead = 0 ;
+    prefetchCount = 0 ;
+    prefetchNumber = number ;
+    prefetchStep = image_step ;
+    prefetchColor = color ;
+    prefetchEnd = false ;
+    pthread_cond_broadcast(&prefetchCond) ;
+  }
+
+  while (! prefetchRing[prefetchHead].ready || (prefetchCount == 0))
+    pthread_cond_wait(&prefetchCond, &prefetchMutex) ;
+
+  vpPrefetchSlot &slot = prefetchRing[prefetchHead] ;
+  pthread_mutex_unlock(&prefetchMutex) ;
+
+  return slot ;
+}
+
+/*
+  Give the slot returned by waitFrame() back to the prefetch thread.
+  Throw the error met while reading its image, if any.
+*/
+void
+vpDiskGrabber::releaseFrame(vpPrefetchSlot &slot)
+{
+  bool failed = slot.failed ;
+  std::string message = slot.message ;
+
+  pthread_mutex_lock(&prefetchMutex) ;
+  slot.ready = false ;
+  prefetchHead = (prefetchHead + 1) % (unsigned int)prefetchRing.size() ;
+  prefetchCount-- ;
+  pthread_cond_broadcast(&prefetchCond) ;
+  pthread_mutex_unlock(&prefetchMutex) ;
+
+  if (failed) {
+    vpERROR_TRACE("%s", message.c_str()) ;
+    throw (vpImageException(vpImageException::ioError, message)) ;
+  }
 }
+#endif
 
 
 /*!
@@ -271,6 +558,9 @@ vpDiskGrabber::~vpDiskGrabber()
 void
 vpDiskGrabber::setDirectory(const char *dir)
 {
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
   sprintf(directory, "%s", dir) ;
 }
 
@@ -280,6 +570,9 @@ vpDiskGrabber::setDirectory(const char *dir)
 void
 vpDiskGrabber::setBaseName(const char *name)
 {
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
   sprintf(base_name, "%s", name) ;
 }
 
@@ -289,6 +582,9 @@ vpDiskGrabber::setBaseName(const char *name)
 void
 vpDiskGrabber::setExtension(const char *ext)
 {
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
   sprintf(extension, "%s", ext) ;
 }
 
@@ -317,12 +613,18 @@ vpDiskGrabber::setStep(int step)
 void
 vpDiskGrabber::setNumberOfZero(unsigned int noz)
 {
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
   number_of_zero = noz ;
 }
 
 void
 vpDiskGrabber::setGenericName(const char *genericName)
 {
+#ifdef VISP_HAVE_PTHREAD
+  stopPrefetch() ;
+#endif
   strcpy(this->genericName, genericName) ;
   useGenericName = true;
 }
@@ -48,10 +48,18 @@
 #define vpDiskGrabber_hh
 
 #include <visp/vpImageIo.h>
+#include <visp/vpPNMReader.h>
 #include <visp/vpFrameGrabber.h>
 #include <visp/vpRGBa.h>
 #include <visp/vpDebug.h>
 
+#include <string>
+#include <vector>
+
+#ifdef VISP_HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+
 /*!
   \class vpDiskGrabber
 
@@ -62,6 +70,13 @@
   Defined a virtual video device. "Grab" the images from the disk.
   Derived from the vpFrameGrabber class.
 
+  PGM and PPM images are read with a vpPNMReader kept along the
+  sequence: the files are mapped in memory, and their header is parsed
+  only once as long as the size of the images does not change.
+
+  setPrefetch() enables a background thread that reads the next images
+  of the sequence while the current one is processed.
+
   \sa vpFrameGrabber
 
   Here an example of capture from the directory
@@ -121,6 +136,55 @@ private:
   bool useGenericName;
   char genericName[FILENAME_MAX];
 
+  vpPNMReader pnmReader; //!< Keeps the header of the PNM sequence
+
+  unsigned int prefetchDepth; //!< Number of frames read in advance
+
+#ifdef VISP_HAVE_PTHREAD
+  //! Frame of the prefetch ring
+  struct vpPrefetchSlot {
+    long number;          //!< Image number
+    bool ready;           //!< Read by the thread, not yet released
+    bool failed;          //!< The image could not be read
+    std::string message;  //!< Error met when failed is true
+    vpImage<unsigned char> I;
+    vpImage<vpRGBa> Irgba;
+  };
+
+  pthread_t prefetchThread;
+  pthread_mutex_t prefetchMutex;
+  pthread_cond_t prefetchCond;   //!< Signaled on any change of the ring
+  bool prefetchRunning;
+  bool prefetchStop;
+  std::vector<vpPrefetchSlot> prefetchRing;
+  unsigned int prefetchHead;     //!< Next slot to give to acquire()
+  unsigned int prefetchCount;    //!< Slots reserved or ready from the head
+  long prefetchNumber;           //!< Next image number to read
+  int prefetchStep;
+  bool prefetchColor;            //!< Frames read as vpRGBa images
+  bool prefetchEnd;              //!< An image could not be read
+  unsigned long prefetchGeneration; //!< Incremented at each restart
+
+  static void *prefetchLauncher(void *arg);
+  void prefetchLoop();
+  void startPrefetch();
+  void stopPrefetch();
+  vpPrefetchSlot &waitFrame(long number, bool color);
+  void releaseFrame(vpPrefetchSlot &slot);
+#endif
+
+  // The prefetch thread and the mapped file are not shared
+  vpDiskGrabber(const vpDiskGrabber &);
+  vpDiskGrabber &operator=(const vpDiskGrabber &);
+
+  void initPrefetch();
+  void buildName(long number, char *name) const;
+  static bool isPNM(const char *name);
+  static void read(vpPNMReader &reader, vpImage<unsigned char> &I,
+                   const char *name);
+  static void read(vpPNMReader &reader, vpImage<vpRGBa> &I,
+                   const char *name);
+
 public:
   vpDiskGrabber();
   vpDiskGrabber(const char *genericName);
@@ -146,6 +210,14 @@ public:
   void setNumberOfZero(unsigned int noz);
   void setExtension(const char *ext);
   void setGenericName(const char *genericName);
+  void setPrefetch(unsigned int depth);
+
+  /*!
+    Return the number of frames decoded in advance.
+
+    \sa setPrefetch()
+  */
+  unsigned int getPrefetch() const { return prefetchDepth; }
 
   /*!
     Return the current image number.
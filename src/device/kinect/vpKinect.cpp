@@ -57,13 +57,10 @@
 vpKinect::vpKinect(freenect_context *ctx, int index)
   : Freenect::FreenectDevice(ctx, index),
     hd(240), wd(320),
-    m_new_rgb_frame(false),
-    m_new_depth_map(false),
-    m_new_depth_image(false),
+    frames(480, 640),
     height(480), width(640)
 {
   dmap.resize(height, width);
-  IRGB.resize(height, width);
   vpPoseVector r(-0.0266,-0.0047,-0.0055,0.0320578,0.0169041,-0.0076519 );//!Those are the parameters found for our Kinect device. Note that they can differ from one device to another.
   rgbMir.buildFrom(r);
   irMrgb = rgbMir.inverse();
@@ -131,18 +128,7 @@ void vpKinect::stop()
 void vpKinect::VideoCallback(void* rgb, uint32_t /* timestamp */)
 {
 //  	std::cout << "vpKinect Video callback" << std::endl;
-  vpMutex::vpScopedLock lock(m_rgb_mutex);
-  uint8_t* rgb_ = static_cast<uint8_t*>(rgb);
-  for (unsigned i = 0; i< height;i++){
-    for (unsigned j = 0 ; j < width ; j++)
-    {
-      IRGB[i][j].R = rgb_[3*(width*i +j)+0];
-      IRGB[i][j].G = rgb_[3*(width*i +j)+1];
-      IRGB[i][j].B = rgb_[3*(width*i +j)+2];
-    }
-  }
-
-  m_new_rgb_frame = true;
+  frames.pushRGB(static_cast<uint8_t*>(rgb));
 }
 
 /*!
@@ -151,26 +137,14 @@ void vpKinect::VideoCallback(void* rgb, uint32_t /* timestamp */)
   Depth value send by the kinect is coded on 11 bits : 10 for the
   value itself (between 0 and 1023) and one for overflow.
 
-  In this function this value is converted into a metric depth map and
-  stored in dmap.  (range : 0.3 - 5m).
+  In this function this value is converted into a metric depth map
+  (range : 0.3 - 5m). See vpKinectFrameBuffer::rawToMeter().
 
 */
 void vpKinect::DepthCallback(void* depth, uint32_t /* timestamp */)
 {
 //	std::cout << "vpKinect Depth callback" << std::endl;
-  vpMutex::vpScopedLock lock(m_depth_mutex);
-  uint16_t* depth_ = static_cast<uint16_t*>(depth);
-  for (unsigned i = 0; i< height;i++){
-    for (unsigned j = 0 ; j < width ; j++)
-    {
-      dmap[i][j] = 0.1236f * tan(depth_[width*i +j] / 2842.5f + 1.1863f);//formula from http://openkinect.org/wiki/Imaging_Information
-      if(depth_[width*i +j]>1023){//Depth cannot be computed
-        dmap[i][j] = -1;
-      }
-    }
-  }
-  m_new_depth_map = true;
-  m_new_depth_image = true;
+  frames.pushDepth(static_cast<uint16_t*>(depth));
 }
 
 
@@ -179,12 +153,7 @@ void vpKinect::DepthCallback(void* depth, uint32_t /* timestamp */)
 */
 bool vpKinect::getDepthMap(vpImage<float>& map)
 {
-  vpMutex::vpScopedLock lock(m_depth_mutex);
-  if (!m_new_depth_map)
-    return false;
-  map = this->dmap;
-  m_new_depth_map = false;
-  return true;
+  return frames.getDepthMap(map);
 }
 
 
@@ -193,26 +162,15 @@ bool vpKinect::getDepthMap(vpImage<float>& map)
  */
 bool vpKinect::getDepthMap(vpImage<float>& map,vpImage<unsigned char>& Imap)
 {
-	//	vpMutex::vpScopedLock lock(m_depth_mutex);
-	vpImage<float> tempMap;
-	m_depth_mutex.lock();
-	if (!m_new_depth_map && !m_new_depth_image)
-	{
-		m_depth_mutex.unlock();
+	if (!frames.getDepthMap(dmap))
 		return false;
-	}
-	tempMap = dmap;
-
-	m_new_depth_map = false;
-	m_new_depth_image = false;
-	m_depth_mutex.unlock();
 
 	if ((Imap.getHeight()!=hd )||(map.getHeight()!=hd))
 	  vpERROR_TRACE(1, "Image size does not match vpKinect DM resolution");
 	if (DMres == DMAP_LOW_RES){
 		for(unsigned int i = 0; i < hd; i++)
 		  for(unsigned int j = 0; j < wd; j++){
-			map[i][j] = tempMap[i<<1][j<<1];
+			map[i][j] = dmap[i<<1][j<<1];
 			//if (map[i][j] != -1)
 			if (fabs(map[i][j] + 1.f) > std::numeric_limits<float>::epsilon())
 			  Imap[i][j] = (unsigned char)(255*map[i][j]/5);
@@ -224,7 +182,7 @@ bool vpKinect::getDepthMap(vpImage<float>& map,vpImage<unsigned char>& Imap)
 	{
 		for (unsigned i = 0; i< height;i++)
 		  for (unsigned j = 0 ; j < width ; j++){
-			map[i][j] = tempMap[i][j];
+			map[i][j] = dmap[i][j];
 			//if (map[i][j] != -1)
 			if (fabs(map[i][j] + 1.f) > std::numeric_limits<float>::epsilon())
 				Imap[i][j] = (unsigned char)(255*map[i][j]/5);
@@ -242,12 +200,7 @@ bool vpKinect::getDepthMap(vpImage<float>& map,vpImage<unsigned char>& Imap)
 */
 bool vpKinect::getRGB(vpImage<vpRGBa>& IRGB)
 {
-  vpMutex::vpScopedLock lock(m_rgb_mutex);
-  if (!m_new_rgb_frame)
-    return false;
-  IRGB = this->IRGB;
-  m_new_rgb_frame = false;
-  return true;
+  return frames.getRGB(IRGB);
 }
 
 /*!
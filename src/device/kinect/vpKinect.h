@@ -52,8 +52,8 @@
 #include <iostream>
 #include <libfreenect.hpp>
 
-#include <visp/vpMutex.h> // need pthread
 #include <visp/vpImage.h>
+#include <visp/vpKinectFrameBuffer.h>
 #include <visp/vpHomogeneousMatrix.h>
 #include <visp/vpCameraParameters.h>
 #include <visp/vpPixelMeterConversion.h>
@@ -108,6 +108,10 @@ int main() {
   return 0;
 }
   \endcode
+
+  The frames are handed from the libfreenect callbacks to getRGB() and
+  getDepthMap() through a lock-free vpKinectFrameBuffer, so that the
+  acquisition thread never waits for the application.
 */
 class VISP_EXPORT vpKinect : public Freenect::FreenectDevice
 {
@@ -162,9 +166,6 @@ class VISP_EXPORT vpKinect : public Freenect::FreenectDevice
   void DepthCallback(void* depth, uint32_t timestamp);
 
  private:
-  vpMutex m_rgb_mutex;
-  vpMutex m_depth_mutex;
-
   vpCameraParameters RGBcam, IRcam;//intrinsic parameters of the two cameras
   vpHomogeneousMatrix rgbMir;//Transformation from IRcam coordinate frame to RGBcam coordinate frame.
   vpHomogeneousMatrix irMrgb;//Transformation from RGBcam coordinate frame to IRcam coordinate frame .
@@ -172,12 +173,9 @@ class VISP_EXPORT vpKinect : public Freenect::FreenectDevice
   unsigned int hd;//height of the depth map
   unsigned int wd;//width of the depth map
 
-  //Access protected by a mutex:
-  vpImage<float> dmap;
-  vpImage<vpRGBa> IRGB;
-  bool m_new_rgb_frame;
-  bool m_new_depth_map;
-  bool m_new_depth_image;
+  //Written by the callbacks, read without lock:
+  vpKinectFrameBuffer frames;
+  vpImage<float> dmap;//last depth map read
   unsigned int height;//height of the rgb image
   unsigned int width;//width of the rgb image
 
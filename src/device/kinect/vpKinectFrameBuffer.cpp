@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Lock-free handoff of the Kinect frames from the driver callbacks.
+ * Does not require libfreenect.
+ *
+ *****************************************************************************/
+
+
+/*!
+  \file vpKinectFrameBuffer.cpp
+  \brief Lock-free handoff of the Kinect frames from the driver callbacks.
+*/
+
+#include <math.h>
+
+#include <visp/vpImageConvert.h>
+#include <visp/vpKinectFrameBuffer.h>
+
+/*!
+  Allocate the buffers and compute the depth conversion table.
+
+  \param h, w : Size of the color images and of the depth maps.
+*/
+vpKinectFrameBuffer::vpKinectFrameBuffer(unsigned int h, unsigned int w)
+  : height(h), width(w)
+{
+  for (unsigned int i = 0; i < 3; i++) {
+    rgbFrames[i].resize(height, width);
+    depthFrames[i].resize(height, width);
+  }
+  for (unsigned int raw = 0; raw < DEPTH_TABLE_SIZE; raw++)
+    depthTable[raw] = rawToMeter((unsigned short)raw);
+}
+
+/*!
+  Destructor.
+*/
+vpKinectFrameBuffer::~vpKinectFrameBuffer()
+{
+}
+
+/*!
+  Publish a new color image. Called by the producer thread.
+
+  \param rgb : Pixels in RGB 24 bits format, row by row.
+*/
+void vpKinectFrameBuffer::pushRGB(const unsigned char *rgb)
+{
+  vpImage<vpRGBa> &I = rgbFrames.getWriteBuffer();
+  vpImageConvert::RGBToRGBa(const_cast<unsigned char *>(rgb),
+                            (unsigned char *)I.bitmap, height * width);
+  rgbFrames.publish();
+}
+
+/*!
+  Publish a new depth map. Called by the producer thread.
+
+  \param depth : Raw depth values, row by row. See rawToMeter().
+*/
+void vpKinectFrameBuffer::pushDepth(const unsigned short *depth)
+{
+  float *map = depthFrames.getWriteBuffer().bitmap;
+  const unsigned int size = height * width;
+  for (unsigned int i = 0; i < size; i++) {
+    unsigned short raw = depth[i];
+    map[i] = (raw < DEPTH_TABLE_SIZE) ? depthTable[raw] : -1.f;
+  }
+  depthFrames.publish();
+}
+
+/*!
+  Get the last color image.
+
+  \param I : Copy of the image, left unchanged if no new image was
+  published since the previous call.
+
+  \return true if a new image was copied.
+*/
+bool vpKinectFrameBuffer::getRGB(vpImage<vpRGBa> &I)
+{
+  if (! rgbFrames.update())
+    return false;
+  I = rgbFrames.getReadBuffer();
+  return true;
+}
+
+/*!
+  Get the last metric depth map.
+
+  \param map : Copy of the depth map in meters, left unchanged if no new
+  depth map was published since the previous call. The pixels where
+  the depth cannot be computed are set to -1.
+
+  \return true if a new depth map was copied.
+*/
+bool vpKinectFrameBuffer::getDepthMap(vpImage<float> &map)
+{
+  if (! depthFrames.update())
+    return false;
+  map = depthFrames.getReadBuffer();
+  return true;
+}
+
+/*!
+  Convert a raw depth value of the Kinect into meters.
+
+  The value is coded on 11 bits: 10 for the value itself (between 0
+  and 1023) and one for overflow. The conversion formula comes from
+  http://openkinect.org/wiki/Imaging_Information (range: 0.3 - 5m).
+
+  \return The depth in meters, or -1 if it cannot be computed.
+*/
+float vpKinectFrameBuffer::rawToMeter(unsigned short raw)
+{
+  if (raw > 1023)
+    return -1.f;
+  return 0.1236f * (float)tan(raw / 2842.5f + 1.1863f);
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Lock-free handoff of the Kinect frames from the driver callbacks.
+ * Does not require libfreenect.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpKinectFrameBuffer_H
+#define vpKinectFrameBuffer_H
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpRGBa.h>
+#include <visp/vpTripleBuffer.h>
+
+/*!
+  \class vpKinectFrameBuffer
+
+  \ingroup KinectDriver
+
+  \brief Handoff of the color images and depth maps of a Kinect from the
+  driver callbacks to the acquisition loop.
+
+  The libfreenect callbacks give the raw frames to pushRGB() and
+  pushDepth(), which convert them directly into the write buffer of a
+  vpTripleBuffer. getRGB() and getDepthMap() copy the last published
+  frame. The callbacks are therefore never blocked by the acquisition
+  loop, and the loop only waits for the copy of the frame it reads.
+
+  The raw depth values, coded on 11 bits, are converted into meters
+  with a 2048 entry table computed once from rawToMeter(), instead of
+  a tangent per pixel.
+
+  This class does not depend on libfreenect. It is used by vpKinect,
+  and may be fed by any other frame source with the same format.
+*/
+class VISP_EXPORT vpKinectFrameBuffer
+{
+public:
+  //! Number of entries of the raw depth conversion table.
+  static const unsigned int DEPTH_TABLE_SIZE = 2048;
+
+  vpKinectFrameBuffer(unsigned int h = 480, unsigned int w = 640);
+  virtual ~vpKinectFrameBuffer();
+
+  void pushRGB(const unsigned char *rgb);
+  void pushDepth(const unsigned short *depth);
+
+  bool getRGB(vpImage<vpRGBa> &I);
+  bool getDepthMap(vpImage<float> &map);
+
+  //! \return Height of the frames.
+  inline unsigned int getHeight() const { return height; }
+  //! \return Width of the frames.
+  inline unsigned int getWidth() const { return width; }
+
+  //! \return Number of color images given to pushRGB().
+  inline unsigned long getNbRGBFrames() const {
+    return rgbFrames.getNbPublishedFrames();
+  }
+  //! \return Number of color images overwritten before being read.
+  inline unsigned long getNbDroppedRGBFrames() const {
+    return rgbFrames.getNbDroppedFrames();
+  }
+  //! \return Number of depth maps given to pushDepth().
+  inline unsigned long getNbDepthFrames() const {
+    return depthFrames.getNbPublishedFrames();
+  }
+  //! \return Number of depth maps overwritten before being read.
+  inline unsigned long getNbDroppedDepthFrames() const {
+    return depthFrames.getNbDroppedFrames();
+  }
+
+  static float rawToMeter(unsigned short raw);
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  vpKinectFrameBuffer(const vpKinectFrameBuffer &); // Not implemented!
+  vpKinectFrameBuffer &operator=(const vpKinectFrameBuffer &); // Not implemented!
+#endif
+
+  unsigned int height;
+  unsigned int width;
+  vpTripleBuffer<vpImage<vpRGBa> > rgbFrames;
+  vpTripleBuffer<vpImage<float> > depthFrames;
+  float depthTable[DEPTH_TABLE_SIZE];
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
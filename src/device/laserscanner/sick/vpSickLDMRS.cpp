@@ -45,6 +45,8 @@
 #include "visp/vpDebug.h"
 #include "visp/vpTime.h"
 #include <sys/socket.h>
+#include <sys/select.h>
+#include <unistd.h>
 #include <netinet/in.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -64,35 +66,42 @@
   \brief Driver for the Sick LD-MRS laser scanner. 
 */
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Time to wait for the next bytes from the laser, in seconds
+  const long receiveTimeout = 3;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*! 
  
   Default constructor that initialize the Ethernet address to
-  "131.254.12.119", set the port to 12002 and allocates memory for the
-  body messages.
+  "131.254.12.119" and set the port to 12002.
 */
 vpSickLDMRS::vpSickLDMRS()
+  : socket_fd(-1), replay_fd(-1), time_offset(0), isFirstMeasure(true)
 {
   ip = "131.254.12.119";
   port = 12002;
-  body = new unsigned char [104000];
-  isFirstMeasure = true;
-  time_offset = 0;
-
-  vAngle.resize(4); // Vertical angle of the 4 layers
-  vAngle[0] = vpMath::rad(-1.2);
-  vAngle[1] = vpMath::rad(-0.4); 
-  vAngle[2] = vpMath::rad( 0.4); 
-  vAngle[3] = vpMath::rad( 1.2);
+}
 
+/*!
+  Copy constructor. The copy shares the connexion to the laser.
+*/
+vpSickLDMRS::vpSickLDMRS(const vpSickLDMRS &sick)
+  : vpLaserScanner(sick), socket_fd(sick.socket_fd), decoder(sick.decoder),
+    replay_fd(-1), time_offset(sick.time_offset),
+    isFirstMeasure(sick.isFirstMeasure)
+{
 }
 
 /*!
-  Destructor that deallocate the memory for the body messages.
+  Destructor that closes the replay file.
 */
 vpSickLDMRS::~vpSickLDMRS()
 {
-  if (body) 
-    delete [] body;
+  if (replay_fd >= 0)
+    close(replay_fd);
 }
 
 /*! 
@@ -155,130 +164,114 @@ bool vpSickLDMRS::setup()
     }
   }
 
+  // The measures are then received without blocking
+  fcntl(socket_fd, F_SETFL, fcntl(socket_fd, F_GETFL) | O_NONBLOCK);
+  decoder.clear();
+
   return true;
 }
 
 /*!
-  Get the measures of the four scan layers.
+  Read the measures from a raw capture of the TCP stream sent by the
+  laser instead of the laser itself.
 
-  \return true if the measures are retrieven, false otherwise.
+  \param filename : Name of the capture file.
 
+  \return true if the file was opened, false otherwise.
 */
-bool vpSickLDMRS::measure(vpLaserScan laserscan[4])
+bool vpSickLDMRS::setReplayFile(const std::string &filename)
 {
-  unsigned int *uintptr;
-  unsigned short *ushortptr;
-  static unsigned char header[24];
-  ushortptr=(unsigned short *)header;
-  uintptr=(unsigned int *)header;
-
-  assert (sizeof(header) == 24);
-  //std::cout << "size " << sizeof(header) << std::endl;
-
-  double time_second = 0;
-
-  if (isFirstMeasure) {
-    time_second = vpTime::measureTimeSecond();
-  }
-
-  // read the 24 bytes header
-  if (recv(socket_fd, header, sizeof(header), MSG_WAITALL) == -1) {
-    printf("recv\n");
-    perror("recv");
-    return false;
-  }
-
-  if (ntohl(uintptr[0]) != vpSickLDMRS::MagicWordC2) {
-    printf("Error, wrong magic number !!!\n");
+  if (replay_fd >= 0)
+    close(replay_fd);
+  replay_fd = open(filename.c_str(), O_RDONLY);
+  if (replay_fd < 0) {
+    fprintf(stderr, "Cannot open %s - %s\n", filename.c_str(), strerror(errno));
     return false;
   }
+  decoder.clear();
+  isFirstMeasure = true;
+  return true;
+}
 
-  // get the message body
-  uint16_t msgtype = ntohs(ushortptr[7]);
-  uint32_t msgLength = ntohl(uintptr[2]);
+/*!
+  Wait for the next bytes from the laser or from the replay file, and
+  write them in the decoder ring buffer.
 
-  ssize_t len = recv(socket_fd, body, msgLength, MSG_WAITALL);
-  if (len != (ssize_t)msgLength){
-    printf("Error, wrong msg length: %d of %d bytes.\n", (int)len, msgLength);
+  \return false if the connexion or the file is closed, or if no byte
+  arrived before the timeout.
+*/
+bool vpSickLDMRS::receive()
+{
+  unsigned int size;
+  unsigned char *data = decoder.getWritePointer(size);
+  if (data == NULL) {
+    printf("Error, the decoder buffer is full\n");
     return false;
   }
 
-  if (msgtype!=vpSickLDMRS::MeasuredData){
-    //printf("The message in not relative to measured data !!!\n");
-    return true;
+  int fd = (replay_fd >= 0) ? replay_fd : socket_fd;
+  for (;;) {
+    ssize_t len = read(fd, data, size);
+    if (len > 0) {
+      decoder.commit((unsigned int)len);
+      return true;
+    }
+    if (len == 0) // End of the stream
+      return false;
+    if (errno == EINTR)
+      continue;
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      perror("recv");
+      return false;
+    }
+
+    struct timeval tv;
+    fd_set myset;
+    tv.tv_sec = receiveTimeout;
+    tv.tv_usec = 0;
+    FD_ZERO(&myset);
+    FD_SET(static_cast<unsigned int>(fd), &myset);
+    int res = select(fd+1, &myset, NULL, NULL, &tv);
+    if (res == 0) {
+      printf("Error, no data received from the laser\n");
+      return false;
+    }
+    if (res < 0 && errno != EINTR) {
+      perror("select");
+      return false;
+    }
   }
+}
 
-  // decode measured data
+/*!
+  Get the measures of the four scan layers.
 
-  // get the measurement number
-  unsigned short measurementId;
-  ushortptr = (unsigned short *) body;
-  measurementId = ushortptr[0];
+  Waits until a complete measure is received from the laser or read
+  from the replay file.
 
-  // get the start timestamp
-  uintptr=(unsigned int *) (body+6);
-  unsigned int seconds = uintptr[1];
-  unsigned int fractional=uintptr[0];
-  double startTimestamp = seconds + fractional / 4294967296.; // 4294967296. = 2^32
+  \return true if the measures are retrieven, false otherwise, for
+  example at the end of the replay file.
 
-  // get the end timestamp
-  uintptr=(unsigned int *) (body+14);
-  seconds = uintptr[1];
-  fractional=uintptr[0];
-  double endTimestamp = seconds + fractional / 4294967296.; // 4294967296. = 2^32
+*/
+bool vpSickLDMRS::measure(vpLaserScan laserscan[4])
+{
+  // Receive until the next measure is complete, the other messages are
+  // skipped by the decoder
+  while (! decoder.decode()) {
+    if (! receive())
+      return false;
+  }
 
   // compute the time offset to bring the measures in the Unix time reference
   if (isFirstMeasure) {
-    time_offset = time_second - startTimestamp;
+    time_offset = vpTime::measureTimeSecond() - decoder.getStartTimestamp();
     isFirstMeasure = false;
   }
 
-  startTimestamp += time_offset;
-  endTimestamp += time_offset;
-
-  // get the number of steps per scanner rotation
-  unsigned short numSteps = ushortptr[11];
-
-  // get the start/stop angle
-  short startAngle = (short)ushortptr[12];
-  short stopAngle = (short)ushortptr[13];
-//   std::cout << "angle in [" << startAngle << "; " << stopAngle 
-// 	    << "]" << std::endl;
-  
-  // get the number of points of this measurement
-  unsigned short numPoints = ushortptr[14];
-
-  int nlayers = 4;
-  for (int i=0; i < nlayers; i++) {
-    laserscan[i].clear();
-    laserscan[i].setMeasurementId(measurementId); 
-    laserscan[i].setStartTimestamp(startTimestamp); 
-    laserscan[i].setEndTimestamp(endTimestamp); 
-    laserscan[i].setNumSteps(numSteps);
-    laserscan[i].setStartAngle(startAngle);
-    laserscan[i].setStopAngle(stopAngle);
-    laserscan[i].setNumPoints(numPoints);
-  }
-
-  // decode the measured points
-  double hAngle; // horizontal angle in rad
-  double rDist; // radial distance in meters
-  vpScanPoint scanPoint;
-
-  for (int i=0; i < numPoints; i++) {
-    ushortptr = (unsigned short *) (body+44+i*10);
-    unsigned char layer = ((unsigned char)  body[44+i*10])&0x0F;
-    unsigned char echo  = ((unsigned char)  body[44+i*10])>>4;
-    //unsigned char flags = (unsigned char)  body[44+i*10+1];
-    
-    if (echo==0) {
-      hAngle = (2.f * M_PI / numSteps)*(short) ushortptr[1];
-      rDist = 0.01 * ushortptr[2]; // cm to meters conversion
-      
-      //vpTRACE("layer: %d d: %f hangle: %f", layer, rDist, hAngle);
-      scanPoint.setPolar(rDist, hAngle, vAngle[layer]);
-      laserscan[layer].addPoint(scanPoint);
-    }
+  decoder.toLaserScan(laserscan);
+  for (unsigned int i = 0; i < vpSickLDMRSDecoder::NB_LAYERS; i++) {
+    laserscan[i].setStartTimestamp(decoder.getStartTimestamp() + time_offset);
+    laserscan[i].setEndTimestamp(decoder.getEndTimestamp() + time_offset);
   }
   return true;
 }
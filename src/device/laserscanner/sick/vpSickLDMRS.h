@@ -54,6 +54,7 @@
 #include <visp/vpLaserScan.h>
 #include <visp/vpLaserScanner.h>
 #include <visp/vpColVector.h>
+#include <visp/vpSickLDMRSDecoder.h>
 
 /*!
 
@@ -105,6 +106,15 @@ int main()
 #endif
 }
   \endcode
+
+  The socket is non-blocking. The received bytes are decoded in place
+  by a vpSickLDMRSDecoder, that gives access to the points of each
+  layer as contiguous arrays and to the decoding time, see
+  getDecoder().
+
+  Instead of the laser, the measures can be read from a raw capture of
+  its TCP stream, recorded for example with "nc 131.254.12.119 12002 >
+  ldmrs.raw", by calling setReplayFile() instead of setup().
 */
 class VISP_EXPORT vpSickLDMRS : public vpLaserScanner
 {
@@ -116,16 +126,19 @@ class VISP_EXPORT vpSickLDMRS : public vpLaserScanner
     MeasuredData = 0x2202      ///< Flag to indicate that the body of a message contains measured data.
   };
   vpSickLDMRS();
-  /*! Copy constructor. */
-  vpSickLDMRS(const vpSickLDMRS &sick) : vpLaserScanner(sick) {
-    socket_fd = sick.socket_fd;
-    body = new unsigned char [104000];
-  };
+  vpSickLDMRS(const vpSickLDMRS &sick);
   virtual ~vpSickLDMRS();
   bool setup(std::string ip, int port);
   bool setup();
+  bool setReplayFile(const std::string &filename);
   bool measure(vpLaserScan laserscan[4]);
 
+  /*! Decoder of the received messages, that gives access to the
+      points of the last measure and to the decoding statistics. */
+  inline const vpSickLDMRSDecoder &getDecoder() const {
+    return decoder;
+  }
+
  protected:
 #ifdef WIN32
   SOCKET socket_fd;
@@ -133,8 +146,10 @@ class VISP_EXPORT vpSickLDMRS : public vpLaserScanner
   int socket_fd;  
 #endif
  private:
-  unsigned char *body;
-  vpColVector vAngle; // constant vertical angle for each layer
+  bool receive();
+
+  vpSickLDMRSDecoder decoder;
+  int replay_fd; // raw capture file, or -1 to read the socket
   double time_offset;
   bool isFirstMeasure;
  };
@@ -0,0 +1,297 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Streaming decoder of the messages sent by the Sick LD-MRS laser scanner.
+ *
+ *****************************************************************************/
+
+
+/*!
+  \file vpSickLDMRSDecoder.cpp
+
+  \brief Streaming decoder of the messages sent by the Sick LD-MRS
+  laser scanner.
+*/
+
+#include <visp/vpMath.h>
+#include <visp/vpSickLDMRSDecoder.h>
+#include <visp/vpTime.h>
+
+#include <string.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Message types and magic word, see vpSickLDMRS
+  const unsigned int magicWord = 0xAFFEC0C2;
+  const unsigned short measuredData = 0x2202;
+
+  // Size of the measured data before the points, and of a point
+  const unsigned int measureHeaderSize = 44;
+  const unsigned int pointSize = 10;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Allocate the ring buffer.
+
+  \param capacity : Size in bytes of the ring buffer, rounded up to a
+  power of two. It must hold the largest message, header included.
+*/
+vpSickLDMRSDecoder::vpSickLDMRSDecoder(unsigned int capacity)
+  : head(0), tail(0), measurementId(0), startTimestamp(0), endTimestamp(0),
+    numSteps(0), startAngle(0), stopAngle(0), numPoints(0),
+    nbMeasures(0), nbSkipped(0), nbDropped(0),
+    decodeTime(0), totalDecodeTime(0)
+{
+  unsigned int size = 1024;
+  while (size < capacity)
+    size <<= 1;
+  ring.resize(size);
+  mask = size - 1;
+
+  vAngle[0] = vpMath::rad(-1.2);
+  vAngle[1] = vpMath::rad(-0.4);
+  vAngle[2] = vpMath::rad( 0.4);
+  vAngle[3] = vpMath::rad( 1.2);
+}
+
+/*!
+  Destructor.
+*/
+vpSickLDMRSDecoder::~vpSickLDMRSDecoder()
+{
+}
+
+/*!
+  Get the free space of the ring buffer where the next bytes can be
+  received without copy. Once they are written, commit() must be called.
+
+  \param size : Number of contiguous bytes that can be written.
+
+  \return Pointer to the first byte to write, or NULL if the ring
+  buffer is full.
+*/
+unsigned char *vpSickLDMRSDecoder::getWritePointer(unsigned int &size)
+{
+  unsigned int capacity = (unsigned int)ring.size();
+  unsigned int position = tail & mask;
+  size = capacity - (tail - head);
+  if (size > capacity - position)
+    size = capacity - position;
+  return (size == 0) ? NULL : &ring[position];
+}
+
+/*!
+  Add to the received bytes the \e size bytes written at the pointer
+  returned by getWritePointer().
+*/
+void vpSickLDMRSDecoder::commit(unsigned int size)
+{
+  tail += size;
+}
+
+/*!
+  Copy received bytes in the ring buffer.
+
+  \param data : Received bytes.
+  \param size : Number of bytes.
+
+  \return The number of copied bytes, less than \e size if the ring
+  buffer is full.
+*/
+unsigned int vpSickLDMRSDecoder::push(const unsigned char *data, unsigned int size)
+{
+  unsigned int copied = 0;
+  unsigned int n;
+  unsigned char *dest;
+  while ((copied < size) && ((dest = getWritePointer(n)) != NULL)) {
+    if (n > size - copied)
+      n = size - copied;
+    memcpy(dest, data + copied, n);
+    commit(n);
+    copied += n;
+  }
+  return copied;
+}
+
+/*!
+  Drop all the received bytes not yet decoded.
+*/
+void vpSickLDMRSDecoder::clear()
+{
+  head = tail;
+}
+
+unsigned char vpSickLDMRSDecoder::byteAt(unsigned int offset) const
+{
+  return ring[(head + offset) & mask];
+}
+
+// The body of the messages is in little endian
+unsigned short vpSickLDMRSDecoder::uint16At(unsigned int offset) const
+{
+  return (unsigned short)(byteAt(offset) | (byteAt(offset + 1) << 8));
+}
+
+unsigned int vpSickLDMRSDecoder::uint32At(unsigned int offset) const
+{
+  return (unsigned int)uint16At(offset) | ((unsigned int)uint16At(offset + 2) << 16);
+}
+
+// The header of the messages is in big endian
+unsigned short vpSickLDMRSDecoder::bigEndianUint16At(unsigned int offset) const
+{
+  return (unsigned short)((byteAt(offset) << 8) | byteAt(offset + 1));
+}
+
+unsigned int vpSickLDMRSDecoder::bigEndianUint32At(unsigned int offset) const
+{
+  return ((unsigned int)bigEndianUint16At(offset) << 16) | bigEndianUint16At(offset + 2);
+}
+
+/*!
+  Decode the next measurement from the received bytes.
+
+  The messages before it that do not contain measured data are
+  skipped. The bytes that do not start with the magic word of the
+  messages, or that start a message too large for the ring buffer, are
+  dropped.
+
+  \return true if a new measurement was decoded, false if more bytes
+  must be received first.
+*/
+bool vpSickLDMRSDecoder::decode()
+{
+  for (;;) {
+    if (getSize() < HEADER_SIZE)
+      return false;
+
+    unsigned int length = bigEndianUint32At(8);
+    if ((bigEndianUint32At(0) != magicWord)
+        || (length > getCapacity() - HEADER_SIZE)) {
+      head++;
+      nbDropped++;
+      continue;
+    }
+    if (getSize() < HEADER_SIZE + length)
+      return false;
+
+    bool isMeasure = (bigEndianUint16At(14) == measuredData);
+    if (isMeasure) {
+      double t = vpTime::measureTimeMs();
+      head += HEADER_SIZE;
+      bool valid = decodeMeasure(length);
+      head += length;
+      if (valid) {
+        decodeTime = vpTime::measureTimeMs() - t;
+        totalDecodeTime += decodeTime;
+        nbMeasures++;
+        return true;
+      }
+    }
+    else
+      head += HEADER_SIZE + length;
+    nbSkipped++;
+  }
+}
+
+// Decode the measured data of a message body starting at head
+bool vpSickLDMRSDecoder::decodeMeasure(unsigned int length)
+{
+  if (length < measureHeaderSize)
+    return false;
+  unsigned short nbPoints = uint16At(28);
+  if (length < measureHeaderSize + nbPoints * pointSize)
+    return false;
+
+  measurementId = uint16At(0);
+  // The timestamps are NTP 64 bits: fractional part, then seconds
+  startTimestamp = uint32At(10) + uint32At(6) / 4294967296.; // 4294967296. = 2^32
+  endTimestamp = uint32At(18) + uint32At(14) / 4294967296.;
+  numSteps = uint16At(22);
+  startAngle = (short)uint16At(24);
+  stopAngle = (short)uint16At(26);
+  numPoints = nbPoints;
+
+  for (unsigned int layer = 0; layer < NB_LAYERS; layer++) {
+    rDist[layer].clear();
+    hAngle[layer].clear();
+    rDist[layer].reserve(nbPoints);
+    hAngle[layer].reserve(nbPoints);
+  }
+
+  const double angleStep = numSteps ? 2. * M_PI / numSteps : 0.;
+  unsigned int offset = measureHeaderSize;
+  for (unsigned int i = 0; i < nbPoints; i++, offset += pointSize) {
+    unsigned char layerEcho = byteAt(offset);
+    unsigned int layer = layerEcho & 0x0F;
+    unsigned int echo = layerEcho >> 4;
+    if ((echo == 0) && (layer < NB_LAYERS)) {
+      hAngle[layer].push_back(angleStep * (short)uint16At(offset + 2));
+      rDist[layer].push_back(0.01 * uint16At(offset + 4)); // cm to meters conversion
+    }
+  }
+  return true;
+}
+
+/*!
+  Convert the points of the last measurement into laser scans.
+
+  \param laserscan : The four layers. The timestamps are the ones of
+  the scanner, see getStartTimestamp().
+*/
+void vpSickLDMRSDecoder::toLaserScan(vpLaserScan laserscan[4]) const
+{
+  vpScanPoint scanPoint;
+  for (unsigned int layer = 0; layer < NB_LAYERS; layer++) {
+    laserscan[layer].clear();
+    laserscan[layer].setMeasurementId(measurementId);
+    laserscan[layer].setStartTimestamp(startTimestamp);
+    laserscan[layer].setEndTimestamp(endTimestamp);
+    laserscan[layer].setNumSteps(numSteps);
+    laserscan[layer].setStartAngle(startAngle);
+    laserscan[layer].setStopAngle(stopAngle);
+    laserscan[layer].setNumPoints(numPoints);
+    for (unsigned int i = 0; i < rDist[layer].size(); i++) {
+      scanPoint.setPolar(rDist[layer][i], hAngle[layer][i], vAngle[layer]);
+      laserscan[layer].addPoint(scanPoint);
+    }
+  }
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Streaming decoder of the messages sent by the Sick LD-MRS laser scanner.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpSickLDMRSDecoder_h
+#define vpSickLDMRSDecoder_h
+
+#include <visp/vpConfig.h>
+#include <visp/vpLaserScan.h>
+
+#include <vector>
+
+/*!
+
+  \file vpSickLDMRSDecoder.h
+
+  \brief Streaming decoder of the messages sent by the Sick LD-MRS
+  laser scanner.
+*/
+
+/*!
+
+  \class vpSickLDMRSDecoder
+
+  \ingroup LaserDriver
+
+  \brief Streaming decoder of the messages sent by the Sick LD-MRS
+  laser scanner.
+
+  The bytes received from the scanner, or read from a raw capture of
+  its TCP stream, are written in a ring buffer either directly with
+  getWritePointer() and commit(), for example by a non-blocking recv(),
+  or by copy with push(). They may arrive in pieces of any size.
+
+  decode() parses the next complete message in place, without copying
+  it out of the ring buffer. The messages that do not contain measured
+  data are skipped. If the stream is corrupted, the bytes are dropped
+  until the next magic word.
+
+  The points of each of the four layers are stored in contiguous
+  arrays of radial distances and horizontal angles, see
+  getRadialDistances() and getHorizontalAngles(). Only the first echo
+  of each point is kept. toLaserScan() converts them into vpLaserScan.
+
+  The decoding time of each measurement is available with
+  getDecodeTime() and getMeanDecodeTime().
+
+  \code
+#include <visp/vpSickLDMRSDecoder.h>
+#include <stdio.h>
+
+int main()
+{
+  vpSickLDMRSDecoder decoder;
+  FILE *fd = fopen("/tmp/ldmrs.raw", "rb"); // Raw capture of the stream
+  if (fd == NULL)
+    return 0;
+  unsigned int size;
+  unsigned char *data;
+  while ((data = decoder.getWritePointer(size)) != NULL) {
+    size_t n = fread(data, 1, size, fd);
+    if (n == 0)
+      break;
+    decoder.commit((unsigned int)n);
+    while (decoder.decode()) {
+      for (unsigned int layer = 0; layer < 4; layer++)
+        printf("layer %d: %d points\n", layer, decoder.getNbPoints(layer));
+    }
+  }
+  fclose(fd);
+}
+  \endcode
+*/
+class VISP_EXPORT vpSickLDMRSDecoder
+{
+ public:
+  //! Number of scan layers.
+  static const unsigned int NB_LAYERS = 4;
+  //! Size in bytes of the header of the messages.
+  static const unsigned int HEADER_SIZE = 24;
+
+  vpSickLDMRSDecoder(unsigned int capacity = 262144);
+  virtual ~vpSickLDMRSDecoder();
+
+  unsigned char *getWritePointer(unsigned int &size);
+  void commit(unsigned int size);
+  unsigned int push(const unsigned char *data, unsigned int size);
+  void clear();
+
+  bool decode();
+  void toLaserScan(vpLaserScan laserscan[4]) const;
+
+  //! \return The capacity in bytes of the ring buffer.
+  inline unsigned int getCapacity() const { return (unsigned int)ring.size(); }
+  //! \return The number of received bytes not yet decoded.
+  inline unsigned int getSize() const { return tail - head; }
+
+  //! \return The number of the last measurement.
+  inline unsigned short getMeasurementId() const { return measurementId; }
+  //! \return Start time of the last measurement, in the scanner time reference.
+  inline double getStartTimestamp() const { return startTimestamp; }
+  //! \return End time of the last measurement, in the scanner time reference.
+  inline double getEndTimestamp() const { return endTimestamp; }
+  //! \return Angular steps per scanner rotation.
+  inline unsigned short getNumSteps() const { return numSteps; }
+  //! \return Start angle of the last measurement in angular steps.
+  inline short getStartAngle() const { return startAngle; }
+  //! \return Stop angle of the last measurement in angular steps.
+  inline short getStopAngle() const { return stopAngle; }
+  //! \return Number of points of the last measurement, all echoes included.
+  inline unsigned short getNumPoints() const { return numPoints; }
+
+  //! \return Number of points of the first echo in the \e layer.
+  inline unsigned int getNbPoints(unsigned int layer) const {
+    return (unsigned int)rDist[layer].size();
+  }
+  //! \return Radial distances in meters of the points of the \e layer.
+  inline const double *getRadialDistances(unsigned int layer) const {
+    return rDist[layer].empty() ? NULL : &rDist[layer][0];
+  }
+  //! \return Horizontal angles in radians of the points of the \e layer.
+  inline const double *getHorizontalAngles(unsigned int layer) const {
+    return hAngle[layer].empty() ? NULL : &hAngle[layer][0];
+  }
+  //! \return Vertical angle in radians of the \e layer.
+  inline double getVerticalAngle(unsigned int layer) const {
+    return vAngle[layer];
+  }
+
+  //! \return The number of decoded measurements.
+  inline unsigned long getNbMeasures() const { return nbMeasures; }
+  //! \return The number of skipped messages, that are not measured data.
+  inline unsigned long getNbSkippedMessages() const { return nbSkipped; }
+  //! \return The number of bytes dropped to find the next magic word.
+  inline unsigned long getNbDroppedBytes() const { return nbDropped; }
+  //! \return The decoding time of the last measurement in ms.
+  inline double getDecodeTime() const { return decodeTime; }
+  //! \return The mean decoding time of the measurements in ms.
+  inline double getMeanDecodeTime() const {
+    return nbMeasures ? totalDecodeTime / nbMeasures : 0.;
+  }
+
+ private:
+  unsigned char byteAt(unsigned int offset) const;
+  unsigned short uint16At(unsigned int offset) const;
+  unsigned int uint32At(unsigned int offset) const;
+  unsigned short bigEndianUint16At(unsigned int offset) const;
+  unsigned int bigEndianUint32At(unsigned int offset) const;
+  bool decodeMeasure(unsigned int length);
+
+  std::vector<unsigned char> ring;
+  unsigned int mask;
+  unsigned int head; // Position of the first byte not decoded
+  unsigned int tail; // Position after the last received byte
+
+  std::vector<double> rDist[NB_LAYERS];
+  std::vector<double> hAngle[NB_LAYERS];
+  double vAngle[NB_LAYERS];
+  unsigned short measurementId;
+  double startTimestamp;
+  double endTimestamp;
+  unsigned short numSteps;
+  short startAngle;
+  short stopAngle;
+  unsigned short numPoints;
+
+  unsigned long nbMeasures;
+  unsigned long nbSkipped;
+  unsigned long nbDropped;
+  double decodeTime;
+  double totalDecodeTime;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -51,13 +51,16 @@
 #include <visp/vpConfig.h>
 #include <visp/vpDebug.h>
 #include <visp/vpException.h>
+#include <visp/vpImageAllocator.h>
 #include <visp/vpImageException.h>
 #include <visp/vpImagePoint.h>
 #include <visp/vpRGBa.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <math.h>
+#include <new>
 #include <string.h>
 
 class vpDisplay;
@@ -105,6 +108,30 @@ unsigned char value;
 value = I[i][j]; // Here we will get the pixel value at position (101, 80)
 \endcode
 
+  <h3>Views</h3> An image can also be a view on pixels it does not
+  own, either an external buffer (see initView(Type *, unsigned int,
+  unsigned int, unsigned int)) or a sub-rectangle of another image (see
+  initView(vpImage<Type> &, unsigned int, unsigned int, unsigned int,
+  unsigned int)). No pixel is copied and the pixels are not released
+  when the view is destroyed, so the viewed memory has to outlive the
+  view. Consecutive rows of a view are separated by getStride()
+  elements, which may be larger than the width. All the methods of this
+  class, as well as the code that accesses the pixels through I[i][j],
+  work on views. Code that accesses the \e bitmap array linearly
+  requires isContiguous() to be true.
+
+\code
+vpImage<unsigned char> I(480, 640);
+vpImage<unsigned char> roi;
+roi.initView(I, 100, 200, 50, 80); // 50x80 region, top left corner in (100, 200)
+roi[0][0] = 255;                   // Modifies I[100][200]
+\endcode
+
+  Resizing a view, or copying an image into it with operator=(), detaches
+  it: the image then allocates and owns new pixels, and the viewed memory
+  is never written. Only the pixel accesses and operator=(const Type &)
+  write through a view.
+
 */
 template<class Type>
 class vpImage
@@ -134,6 +161,33 @@ public:
   //! destructor
   void destroy() ;
 
+  void initView(Type *array, unsigned int height, unsigned int width,
+                unsigned int stride = 0);
+  void initView(vpImage<Type> &I, unsigned int top, unsigned int left,
+                unsigned int height, unsigned int width);
+  void initPadded(unsigned int height, unsigned int width);
+
+  /*!
+    \return true if the image is a view on pixels it does not own.
+
+    \sa initView()
+  */
+  inline bool isView() const { return ! hasOwnership; }
+  /*!
+    \return true if the rows are stored one after the other in \e
+    bitmap, so that the pixels can be accessed linearly.
+
+    \sa getStride()
+  */
+  inline bool isContiguous() const { return (stride == width) || (height <= 1); }
+  /*!
+    \return The number of elements between the beginning of two
+    consecutive rows. It is equal to the width except for a view.
+
+    \sa isContiguous()
+  */
+  inline unsigned int getStride() const { return stride; }
+
   /*!
     Get the image height.
 
@@ -227,7 +281,7 @@ public:
   */
   inline  Type operator()(const unsigned int i, const  unsigned int j) const
   {
-    return bitmap[i*width+j] ;
+    return row[i][j] ;
   }
   /*!
     Set the value of an image point.
@@ -241,7 +295,7 @@ public:
   inline  void  operator()(const unsigned int i, const  unsigned int j,
 			   const Type &v)
   {
-    bitmap[i*width+j] = v ;
+    row[i][j] = v ;
   }
   /*!
     Get the value of an image point.
@@ -259,7 +313,7 @@ public:
     unsigned int i = (unsigned int) ip.get_i();
     unsigned int j = (unsigned int) ip.get_j();
 
-    return bitmap[i*width+j] ;
+    return row[i][j] ;
   }
   /*!
     Set the value of an image point.
@@ -276,7 +330,7 @@ public:
     unsigned int i = (unsigned int) ip.get_i();
     unsigned int j = (unsigned int) ip.get_j();
 
-    bitmap[i*width+j] = v ;
+    row[i][j] = v ;
   }
 
   vpImage<Type> operator-(const vpImage<Type> &B);
@@ -320,9 +374,42 @@ private:
   unsigned int width ;   //<! number of columns
   unsigned int height ;   //<! number of rows
   Type **row ;    //!< points the row pointer array
+  unsigned int stride ; //<! number of elements between two rows
+  bool hasOwnership ;   //<! false for a view, the bitmap is not released
+
+  static Type *allocateBitmap(unsigned int n) ;
+  static void releaseBitmap(Type *p, unsigned int n) ;
   } ;
 
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Allocate and construct n pixels with vpImageAllocator.
+*/
+template<class Type>
+Type *
+vpImage<Type>::allocateBitmap(unsigned int n)
+{
+  Type *p = (Type *)vpImageAllocator::allocate(n*sizeof(Type)) ;
+  for (unsigned int i = 0 ; i < n ; i++)
+    new (p + i) Type ;
+  return p ;
+}
+
+/*
+  Destroy and release n pixels obtained with allocateBitmap().
+*/
+template<class Type>
+void
+vpImage<Type>::releaseBitmap(Type *p, unsigned int n)
+{
+  for (unsigned int i = 0 ; i < n ; i++)
+    p[i].~Type() ;
+  vpImageAllocator::release(p) ;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+
 /*!
   \brief Image initialisation
 
@@ -348,8 +435,7 @@ vpImage<Type>::init(unsigned int height, unsigned int width, Type value)
     throw ;
   }
 
-  for (unsigned int i=0  ; i < npixels ;  i++)
-    bitmap[i] = value ;
+  *this = value ;
 }
 
 
@@ -362,7 +448,9 @@ vpImage<Type>::init(unsigned int height, unsigned int width, Type value)
 
   If the image has been already initialized, memory allocation is done
   only if the new image size is different, else we re-use the same
-  memory space.
+  memory space. The allocated pixels are contiguous: an image created
+  with initPadded() loses its row padding, and a view is detached (see
+  initView()).
 
   \exception vpException::memoryAllocationError
 
@@ -371,20 +459,31 @@ template<class Type>
 void
 vpImage<Type>::init(unsigned int height, unsigned int width)
 {
+  if (! hasOwnership) {
+    // The viewed memory may not be valid anymore, or may belong to an
+    // object that does not expect to be modified: the view is detached
+    bitmap = NULL;
+    hasOwnership = true;
+  }
+  else if (bitmap != NULL && ! isContiguous()) {
+    // Padded rows; the callers of init() may access bitmap linearly
+    releaseBitmap(bitmap, this->height*stride);
+    bitmap = NULL;
+  }
 
   if (height != this->height) {
     if (row != NULL)  {
       vpDEBUG_TRACE(10,"Destruction row[]");
-      delete [] row;
+      vpImageAllocator::release(row);
       row = NULL;
     }
   }
 
   if ((height != this->height) || (width != this->width))
   {
-    if (bitmap != NULL) {
+    if (bitmap != NULL && hasOwnership) {
       vpDEBUG_TRACE(10,"Destruction bitmap[]") ;
-      delete [] bitmap;
+      releaseBitmap(bitmap, this->height*stride);
       bitmap = NULL;
     }
   }
@@ -397,7 +496,10 @@ vpImage<Type>::init(unsigned int height, unsigned int width)
   npixels=width*height;
 
 
-  if (bitmap == NULL)  bitmap = new  Type[npixels] ;
+  if (bitmap == NULL) {
+    bitmap = allocateBitmap(npixels) ;
+    stride = width ;
+  }
 
   //  vpERROR_TRACE("Allocate bitmap %p",bitmap) ;
   if (bitmap == NULL)
@@ -407,7 +509,8 @@ vpImage<Type>::init(unsigned int height, unsigned int width)
 		      "cannot allocate bitmap ")) ;
   }
 
-  if (row == NULL)  row = new  Type*[height] ;
+  if (row == NULL)
+    row = (Type **)vpImageAllocator::allocate(height*sizeof(Type *)) ;
 //  vpERROR_TRACE("Allocate row %p",row) ;
   if (row == NULL)
   {
@@ -418,7 +521,151 @@ vpImage<Type>::init(unsigned int height, unsigned int width)
 
   unsigned int i ;
   for ( i =0  ; i < height ; i++)
-    row[i] = bitmap + i*width ;
+    row[i] = bitmap + i*stride ;
+}
+
+/*!
+  \brief Make the image a view on an external buffer.
+
+  No memory is allocated for the pixels and no pixel is copied. The
+  buffer is not released when the image is destroyed, so it has to
+  outlive the image. The pixel (i, j) is array[i*stride+j].
+
+  \param array : Pointer to the first pixel of the buffer.
+  \param height, width : Size of the image.
+  \param stride : Number of elements between the beginning of two
+  consecutive rows. 0 means that the rows are contiguous (stride equal
+  to width).
+
+  \exception vpException::badValue : If the stride is smaller than the
+  width.
+
+  The example below shows how to track a dot directly in the buffer of a
+  grabber without copying it:
+  \code
+  unsigned char *buffer = ...; // 640x480 grey level pixels, rows padded to 768 bytes
+  vpImage<unsigned char> I;
+  I.initView(buffer, 480, 640, 768);
+  vpDot2 dot;
+  dot.track(I);
+  \endcode
+
+  \sa initView(vpImage<Type> &, unsigned int, unsigned int, unsigned int, unsigned int)
+*/
+template<class Type>
+void
+vpImage<Type>::initView(Type *array, unsigned int height, unsigned int width,
+                        unsigned int stride)
+{
+  if (stride == 0)
+    stride = width;
+  if (stride < width) {
+    vpERROR_TRACE("Stride %d smaller than the width %d", stride, width) ;
+    throw(vpException(vpException::badValue,
+                      "The stride is smaller than the width")) ;
+  }
+
+  if (height != this->height && row != NULL) {
+    vpImageAllocator::release(row);
+    row = NULL;
+  }
+  if (bitmap != NULL && hasOwnership)
+    releaseBitmap(bitmap, this->height*this->stride);
+
+  bitmap = array;
+  hasOwnership = false;
+  this->width = width;
+  this->height = height;
+  this->stride = stride;
+  npixels = width*height;
+
+  if (row == NULL && height != 0)
+    row = (Type **)vpImageAllocator::allocate(height*sizeof(Type *)) ;
+  for (unsigned int i = 0 ; i < height ; i++)
+    row[i] = bitmap + i*stride ;
+}
+
+/*!
+  \brief Make the image a view on a sub-rectangle of another image.
+
+  No pixel is copied: modifying the view modifies \e I. The view has
+  to be used only while \e I is neither destroyed nor resized.
+
+  \param I : Viewed image. It can itself be a view.
+  \param top, left : Coordinates in \e I of the top left corner of the
+  view.
+  \param height, width : Size of the view.
+
+  \exception vpException::dimensionError : If the rectangle is not
+  inside the image \e I.
+
+  \sa initView(Type *, unsigned int, unsigned int, unsigned int)
+*/
+template<class Type>
+void
+vpImage<Type>::initView(vpImage<Type> &I, unsigned int top, unsigned int left,
+                        unsigned int height, unsigned int width)
+{
+  if ((top + height > I.getHeight()) || (left + width > I.getWidth())) {
+    vpERROR_TRACE("Rectangle %dx%d at (%d, %d) outside of a %dx%d image",
+                  width, height, top, left, I.getWidth(), I.getHeight()) ;
+    throw(vpException(vpException::dimensionError,
+                      "The view is not inside the image")) ;
+  }
+  if (height == 0 || width == 0)
+    initView(I.bitmap, 0, 0, 0);
+  else
+    initView(I[top] + left, height, width, I.getStride());
+}
+
+/*!
+  \brief Image initialization with aligned rows.
+
+  Allocate memory for an [height x width] image whose rows all start
+  on a vpImageAllocator::getAlignment() boundary. Each row is padded
+  up to a multiple of the alignment, so that getStride() may be larger
+  than the width and the pixels have to be accessed by rows (see
+  isContiguous()). If the size of Type does not divide the alignment,
+  the rows are not padded.
+
+  Element of the bitmap are not initialized. A later call to init() or
+  resize() gives back a contiguous image.
+
+  \code
+  vpImage<unsigned char> I;
+  I.initPadded(480, 630); // getStride() is 640 with a 32 bytes alignment
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    unsigned char *r = I[i]; // Aligned on 32 bytes
+    ...
+  }
+  \endcode
+
+  \exception vpException::memoryAllocationError
+*/
+template<class Type>
+void
+vpImage<Type>::initPadded(unsigned int height, unsigned int width)
+{
+  unsigned int alignment = vpImageAllocator::getAlignment() ;
+  unsigned int s = width ;
+  if (alignment % sizeof(Type) == 0) {
+    unsigned int n = alignment / (unsigned int)sizeof(Type) ;
+    s = ((width + n - 1) / n) * n ;
+  }
+
+  if (hasOwnership && bitmap != NULL && height == this->height
+      && width == this->width && s == stride)
+    return ;
+
+  destroy() ;
+  bitmap = allocateBitmap(height*s) ;
+  row = (Type **)vpImageAllocator::allocate(height*sizeof(Type *)) ;
+  this->width = width ;
+  this->height = height ;
+  this->stride = s ;
+  npixels = width*height ;
+  for (unsigned int i = 0 ; i < height ; i++)
+    row[i] = bitmap + i*s ;
 }
 
 /*!
@@ -441,6 +688,8 @@ vpImage<Type>::vpImage(unsigned int height, unsigned int width)
 {
   bitmap = NULL ;
   row = NULL ;
+  stride = 0 ;
+  hasOwnership = true ;
 
   display =  NULL ;
   this->height = this->width = 0 ;
@@ -475,6 +724,8 @@ vpImage<Type>::vpImage (unsigned int height, unsigned int width, Type value)
 {
   bitmap = NULL ;
   row = NULL ;
+  stride = 0 ;
+  hasOwnership = true ;
 
   display =  NULL ;
   this->height = this->width = 0 ;
@@ -503,6 +754,8 @@ vpImage<Type>::vpImage()
 {
   bitmap = NULL ;
   row = NULL ;
+  stride = 0 ;
+  hasOwnership = true ;
 
   display =  NULL ;
 
@@ -557,16 +810,19 @@ vpImage<Type>::destroy()
   {
   //  vpERROR_TRACE("Deallocate bitmap memory %p",bitmap) ;
 //    vpDEBUG_TRACE(20,"Deallocate bitmap memory %p",bitmap) ;
-    delete [] bitmap ;
+    // The pixels of a view are not released
+    if (hasOwnership)
+      releaseBitmap(bitmap, height*stride) ;
     bitmap = NULL;
   }
+  hasOwnership = true;
 
 
   if (row!=NULL)
   {
  //   vpERROR_TRACE("Deallocate row memory %p",row) ;
 //    vpDEBUG_TRACE(20,"Deallocate row memory %p",row) ;
-    delete [] row ;
+    vpImageAllocator::release(row) ;
     row = NULL;
   }
 
@@ -594,6 +850,9 @@ vpImage<Type>::vpImage(const vpImage<Type>& I)
 {
   bitmap = NULL ;
   row = NULL ;  
+  stride = 0 ;
+  hasOwnership = true ;
+  display = NULL ;
     /* we first have to set the initial values of the image because resize function calls init function that test the actual size of the image */
   this->width = 0;
   this->height = 0;
@@ -604,9 +863,11 @@ vpImage<Type>::vpImage(const vpImage<Type>& I)
 //    if(I.getHeight() != 0 || I.getWidth() != 0)
     {
       resize(I.getHeight(),I.getWidth());
-      unsigned int i;
-      memcpy(bitmap, I.bitmap, I.npixels*sizeof(Type)) ;
-      for (i =0  ; i < this->height ; i++) row[i] = bitmap + i*this->width ;
+      if (I.isContiguous())
+        memcpy((unsigned char *)bitmap, (const unsigned char *)I.bitmap, I.npixels*sizeof(Type)) ;
+      else
+        for (unsigned int i = 0 ; i < this->height ; i++)
+          memcpy((unsigned char *)row[i], (const unsigned char *)I.row[i], this->width*sizeof(Type)) ;
     }
   }
   catch(vpException me)
@@ -625,9 +886,11 @@ template<class Type>
 Type vpImage<Type>::getMaxValue() const
 {
   Type m = bitmap[0] ;
-  for (unsigned int i=0 ; i < npixels ; i++)
+  for (unsigned int i=0 ; i < height ; i++)
   {
-    if (bitmap[i]>m) m = bitmap[i] ;
+    const Type *r = row[i] ;
+    for (unsigned int j=0 ; j < width ; j++)
+      if (r[j]>m) m = r[j] ;
   }
   return m ;
 }
@@ -641,8 +904,12 @@ template<class Type>
 Type vpImage<Type>::getMinValue() const
 {
   Type m =  bitmap[0];
-  for (unsigned int i=0 ; i < npixels ; i++)
-    if (bitmap[i]<m) m = bitmap[i] ;
+  for (unsigned int i=0 ; i < height ; i++)
+  {
+    const Type *r = row[i] ;
+    for (unsigned int j=0 ; j < width ; j++)
+      if (r[j]<m) m = r[j] ;
+  }
   return m ;
 }
 
@@ -657,67 +924,75 @@ template<class Type>
 void vpImage<Type>::getMinMaxValue(Type &min, Type &max) const
 {
   min = max =  bitmap[0];
-  for (unsigned int i=0 ; i < npixels ; i++)
+  for (unsigned int i=0 ; i < height ; i++)
   {
-    if (bitmap[i]<min) min = bitmap[i] ;
-    if (bitmap[i]>max) max = bitmap[i] ;
+    const Type *r = row[i] ;
+    for (unsigned int j=0 ; j < width ; j++)
+    {
+      if (r[j]<min) min = r[j] ;
+      if (r[j]>max) max = r[j] ;
+    }
   }
 }
 
 /*!
   \brief Copy operator
+
+  The image owns a copy of the pixels of \e I. When the image is a view,
+  it is detached and the viewed memory is not modified. \e I can be a
+  view on the pixels of the image, for instance to crop it in place:
+  \code
+vpImage<unsigned char> I(480, 640);
+vpImage<unsigned char> roi;
+roi.initView(I, 100, 200, 50, 80);
+I = roi; // I is now the 50x80 region
+  \endcode
 */
 template<class Type>
 void vpImage<Type>::operator=(const vpImage<Type> &I)
 {
-    /* we first have to set the initial values of the image because resize function calls init function that test the actual size of the image */
-  if(bitmap != NULL){
-    delete[] bitmap;
-    bitmap = NULL ;
+  if (this == &I)
+    return;
+
+  if (hasOwnership && (bitmap != NULL) && (I.bitmap >= bitmap)
+      && (I.bitmap < bitmap + height*stride)) {
+    // I views the pixels of this image, that init() may release: the
+    // pixels are copied first, then the old ones are released with the
+    // copy
+    vpImage<Type> copy(I);
+    std::swap(bitmap, copy.bitmap);
+    std::swap(row, copy.row);
+    std::swap(npixels, copy.npixels);
+    std::swap(width, copy.width);
+    std::swap(height, copy.height);
+    std::swap(stride, copy.stride);
+    return;
   }
-  
-  if(row != NULL){
-    delete[] row;
-    row = NULL ;
+
+  if (I.npixels == 0) {
+    destroy();
+    this->width = I.width;
+    this->height = I.height;
+    this->npixels = 0;
+    this->stride = I.width;
+    return;
   }
-  this->width = I.width;
-  this->height = I.height;
-  this->npixels = I.npixels;
+
   try
   {
-    if(I.npixels != 0)
-    {
-      if (bitmap == NULL){  
-        bitmap = new  Type[npixels] ;
-      }
-
-      if (bitmap == NULL){
-            vpERROR_TRACE("cannot allocate bitmap ") ;
-        throw(vpException(vpException::memoryAllocationError,
-		          "cannot allocate bitmap ")) ;
-      }
-
-      if (row == NULL){  
-        row = new  Type*[height] ;
-      }
-      if (row == NULL){
-        vpERROR_TRACE("cannot allocate row ") ;
-        throw(vpException(vpException::memoryAllocationError,
-		          "cannot allocate row ")) ;
-      }      
-
-      memcpy(bitmap, I.bitmap, I.npixels*sizeof(Type)) ;
-
-      for (unsigned int i=0; i<this->height; i++){ 
-        row[i] = bitmap + i*this->width;
-      }
-    }
+    init(I.height, I.width);
   }
   catch(vpException me)
   {
     vpERROR_TRACE(" ") ;
     throw ;
   }
+
+  if (isContiguous() && I.isContiguous())
+    memcpy((unsigned char *)bitmap, (const unsigned char *)I.bitmap, I.npixels*sizeof(Type)) ;
+  else
+    for (unsigned int i=0; i<this->height; i++)
+      memcpy((unsigned char *)row[i], (const unsigned char *)I.row[i], this->width*sizeof(Type)) ;
 }
 
 
@@ -730,8 +1005,15 @@ void vpImage<Type>::operator=(const vpImage<Type> &I)
 template<class Type>
 void vpImage<Type>::operator=(const Type &v)
 {
-  for (unsigned int i=0 ; i < npixels ; i++)
-    bitmap[i] = v ;
+  if (isContiguous()) {
+    for (unsigned int i=0 ; i < npixels ; i++)
+      bitmap[i] = v ;
+  }
+  else {
+    for (unsigned int i=0 ; i < height ; i++)
+      for (unsigned int j=0 ; j < width ; j++)
+        row[i][j] = v ;
+  }
 }
 
 /*!
@@ -747,10 +1029,12 @@ bool vpImage<Type>::operator==(const vpImage<Type> &I)
 	if (this->height != I.getHeight())
 		return false;
 		
-  for (unsigned int i=0 ; i < npixels ; i++) 
+  for (unsigned int i=0 ; i < height ; i++)
   {
-    if (bitmap[i] != I.bitmap[i])
-    	return false;
+    if (memcmp(row[i], I.row[i], width*sizeof(Type)) != 0)
+      for (unsigned int j=0 ; j < width ; j++)
+        if (row[i][j] != I.row[i][j])
+          return false;
   }
   return true ;
 }
@@ -767,10 +1051,11 @@ bool vpImage<Type>::operator!=(const vpImage<Type> &I)
   if (this->height != I.getHeight())
     return true;
 
-  for (unsigned int i=0 ; i < npixels ; i++)
+  for (unsigned int i=0 ; i < height ; i++)
   {
-    if (bitmap[i] == I.bitmap[i])
-      return false;
+    for (unsigned int j=0 ; j < width ; j++)
+      if (row[i][j] == I.row[i][j])
+        return false;
   }
   return true ;
 }
@@ -863,10 +1148,10 @@ void vpImage<Type>::insert(const vpImage<Type> &src,
   
   for (int i = 0; i < hsize; i++)
   {
-    srcBitmap = src.bitmap + ((src_ibegin+i)*src_w+src_jbegin);
-    destBitmap = this->bitmap + ((dest_ibegin+i)*dest_w+dest_jbegin);
+    srcBitmap = src.row[src_ibegin+i] + src_jbegin;
+    destBitmap = this->row[dest_ibegin+i] + dest_jbegin;
   
-    memcpy(destBitmap,srcBitmap,wsize*sizeof(Type));
+    memcpy((unsigned char *)destBitmap, (const unsigned char *)srcBitmap, wsize*sizeof(Type));
   }
 }
 
@@ -1369,9 +1654,10 @@ void vpImage<Type>::sub(const vpImage<Type> &B, vpImage<Type> &C)
           "vpImage mismatch in vpImage/vpImage substraction ")) ;
   }
 
-  for (unsigned int i=0;i<this->getWidth()*this->getHeight();i++)
+  for (unsigned int i=0;i<this->getHeight();i++)
   {
-    *(C.bitmap + i) = *(bitmap + i) - *(B.bitmap + i) ;
+    for (unsigned int j=0;j<this->getWidth();j++)
+      C.row[i][j] = row[i][j] - B.row[i][j] ;
   }
 }
 
@@ -1411,9 +1697,10 @@ void vpImage<Type>::sub(const vpImage<Type> &A, const vpImage<Type> &B,
                       "vpImage mismatch in vpImage/vpImage substraction ")) ;
   }
 
-  for (unsigned int i=0;i<A.getWidth()*A.getHeight();i++)
+  for (unsigned int i=0;i<A.getHeight();i++)
   {
-    *(C.bitmap + i) = *(A.bitmap + i) - *(B.bitmap + i) ;
+    for (unsigned int j=0;j<A.getWidth();j++)
+      C.row[i][j] = A.row[i][j] - B.row[i][j] ;
   }
 }
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
@@ -1446,8 +1733,9 @@ vpImage<Type>::sub(vpImage<Type>* B, vpImage<Type>* C)
           "vpImage mismatch in vpImage/vpImage substraction ")) ;
   }
 
-  for(unsigned int i  = 0; i < height * width; i++)
-    C->bitmap[i] = this->bitmap[i] - B->bitmap[i];
+  for(unsigned int i  = 0; i < height; i++)
+    for(unsigned int j  = 0; j < width; j++)
+      C->row[i][j] = this->row[i][j] - B->row[i][j];
 }
 
 /*!
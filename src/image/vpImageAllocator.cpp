@@ -0,0 +1,391 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Aligned and pooled memory allocation used by vpImage.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImageAllocator.cpp
+  \brief Aligned and pooled memory allocation used by vpImage.
+*/
+
+#include <visp/vpImageAllocator.h>
+#include <visp/vpException.h>
+#include <visp/vpDebug.h>
+
+#include <stdlib.h>
+#include <map>
+#include <vector>
+
+#ifdef VISP_HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Stored just before each aligned block
+  struct vpBlockHeader {
+    void *base;
+    size_t size;
+  };
+
+  typedef std::map<size_t, std::vector<void *> > vpImagePool;
+
+  unsigned int vpAlignment = vpImageAllocator::DEFAULT_ALIGNMENT;
+  bool vpPoolEnabled = false;
+  size_t vpPoolMaxSize = 256 * 1024 * 1024;
+  size_t vpPoolSize = 0;
+  // Allocated on first use and never destroyed, so that images released
+  // by static destructors of other translation units can still use it
+  vpImagePool *vpPool = NULL;
+
+  unsigned long vpNbAllocations = 0;
+  unsigned long vpNbReuses = 0;
+  unsigned long vpNbReleases = 0;
+
+#ifdef VISP_HAVE_PTHREAD
+  pthread_mutex_t vpPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+  class vpPoolLock
+  {
+  public:
+    vpPoolLock() { pthread_mutex_lock(&vpPoolMutex); }
+    ~vpPoolLock() { pthread_mutex_unlock(&vpPoolMutex); }
+  };
+#endif
+
+  inline vpBlockHeader *header(void *ptr)
+  {
+    return (vpBlockHeader *)ptr - 1;
+  }
+
+  inline bool isAligned(const void *ptr, unsigned int alignment)
+  {
+    return ((size_t)ptr & (size_t)(alignment - 1)) == 0;
+  }
+
+  // Must be called with the lock held
+  void freePool()
+  {
+    if (vpPool == NULL)
+      return;
+    for (vpImagePool::iterator it = vpPool->begin(); it != vpPool->end(); ++it) {
+      for (size_t i = 0; i < it->second.size(); i++) {
+        free(header(it->second[i])->base);
+        vpNbReleases++;
+      }
+    }
+    vpPool->clear();
+    vpPoolSize = 0;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+// All the accesses to the shared state are done in the block following
+// VP_POOL_LOCK. With pthread the lock is released at the end of the
+// enclosing scope, with OpenMP at the end of the block.
+#if defined(VISP_HAVE_PTHREAD)
+#  define VP_POOL_LOCK vpPoolLock lock;
+#elif defined(VISP_HAVE_OPENMP)
+#  define VP_POOL_LOCK _Pragma("omp critical (vpImageAllocator)")
+#else
+#  define VP_POOL_LOCK
+#endif
+
+/*!
+  Allocate a memory block aligned on getAlignment() bytes. If the pool
+  is enabled and contains a block of the same size, this block is
+  returned instead of calling the system allocator.
+
+  \param size : Size of the block in bytes.
+  \return A pointer to the block, that has to be given back with
+  release().
+
+  \exception vpException::memoryAllocationError : If the system
+  allocator fails.
+*/
+void *vpImageAllocator::allocate(size_t size)
+{
+  void *ptr = NULL;
+  unsigned int alignment;
+  VP_POOL_LOCK
+  {
+    alignment = vpAlignment;
+    if (vpPool != NULL) {
+      vpImagePool::iterator it = vpPool->find(size);
+      if (it != vpPool->end()) {
+        std::vector<void *> &bucket = it->second;
+        // Blocks allocated before a change of the alignment may not be
+        // aligned enough
+        for (size_t i = bucket.size(); i > 0; i--) {
+          if (isAligned(bucket[i-1], alignment)) {
+            ptr = bucket[i-1];
+            bucket.erase(bucket.begin() + (long)(i-1));
+            vpPoolSize -= size;
+            vpNbReuses++;
+            break;
+          }
+        }
+      }
+    }
+    if (ptr == NULL)
+      vpNbAllocations++;
+  }
+  if (ptr != NULL)
+    return ptr;
+
+  char *base = (char *)malloc(size + alignment + sizeof(vpBlockHeader));
+  if (base == NULL) {
+    vpERROR_TRACE("Cannot allocate %lu bytes", (unsigned long)size) ;
+    throw (vpException(vpException::memoryAllocationError,
+                       "Cannot allocate image memory")) ;
+  }
+  size_t addr = (size_t)(base + sizeof(vpBlockHeader));
+  addr = (addr + alignment - 1) & ~(size_t)(alignment - 1);
+  ptr = (void *)addr;
+  header(ptr)->base = base;
+  header(ptr)->size = size;
+  return ptr;
+}
+
+/*!
+  Give back a block obtained with allocate(). If the pool is enabled
+  and not full, the block is kept for a later allocation of the same
+  size, otherwise it is freed.
+
+  \param ptr : Pointer returned by allocate(). NULL is ignored.
+*/
+void vpImageAllocator::release(void *ptr)
+{
+  if (ptr == NULL)
+    return;
+
+  size_t size = header(ptr)->size;
+  bool kept = false;
+  VP_POOL_LOCK
+  {
+    if (vpPoolEnabled && vpPoolSize + size <= vpPoolMaxSize) {
+      if (vpPool == NULL)
+        vpPool = new vpImagePool;
+      (*vpPool)[size].push_back(ptr);
+      vpPoolSize += size;
+      kept = true;
+    }
+    else
+      vpNbReleases++;
+  }
+  if (! kept)
+    free(header(ptr)->base);
+}
+
+/*!
+  \return The alignment in bytes of the blocks returned by allocate().
+*/
+unsigned int vpImageAllocator::getAlignment()
+{
+  unsigned int alignment;
+  VP_POOL_LOCK
+  {
+    alignment = vpAlignment;
+  }
+  return alignment;
+}
+
+/*!
+  Set the alignment of the next allocated blocks. Typical values are
+  16 for SSE, 32 for AVX and 64 for a cache line or AVX-512. The blocks
+  already allocated keep their alignment.
+
+  \param alignment : Alignment in bytes. It has to be a power of two
+  at least equal to the size of a pointer.
+
+  \exception vpException::badValue : If the alignment is not valid.
+*/
+void vpImageAllocator::setAlignment(unsigned int alignment)
+{
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+    vpERROR_TRACE("Alignment %u is not a power of two", alignment) ;
+    throw (vpException(vpException::badValue,
+                       "Alignment has to be a power of two")) ;
+  }
+  VP_POOL_LOCK
+  {
+    vpAlignment = alignment;
+  }
+}
+
+/*!
+  \return true if released blocks are kept in the pool.
+*/
+bool vpImageAllocator::isPoolEnabled()
+{
+  bool enabled;
+  VP_POOL_LOCK
+  {
+    enabled = vpPoolEnabled;
+  }
+  return enabled;
+}
+
+/*!
+  Enable or disable the pool. The pool is disabled by default.
+  Disabling it frees the blocks it contains.
+
+  \param enable : true to keep the released blocks for later
+  allocations.
+*/
+void vpImageAllocator::setPoolEnabled(bool enable)
+{
+  VP_POOL_LOCK
+  {
+    vpPoolEnabled = enable;
+    if (! enable)
+      freePool();
+  }
+}
+
+/*!
+  \return The maximum number of bytes kept in the pool.
+*/
+size_t vpImageAllocator::getPoolMaxSize()
+{
+  size_t size;
+  VP_POOL_LOCK
+  {
+    size = vpPoolMaxSize;
+  }
+  return size;
+}
+
+/*!
+  Set the maximum number of bytes kept in the pool (256 MB by
+  default). When the pool is full, the released blocks are freed.
+  Reducing the size does not free the blocks already in the pool; use
+  clearPool() for that.
+
+  \param size : Maximum size in bytes.
+*/
+void vpImageAllocator::setPoolMaxSize(size_t size)
+{
+  VP_POOL_LOCK
+  {
+    vpPoolMaxSize = size;
+  }
+}
+
+/*!
+  \return The number of bytes currently kept in the pool.
+*/
+size_t vpImageAllocator::getPoolSize()
+{
+  size_t size;
+  VP_POOL_LOCK
+  {
+    size = vpPoolSize;
+  }
+  return size;
+}
+
+/*!
+  Free all the blocks kept in the pool.
+*/
+void vpImageAllocator::clearPool()
+{
+  VP_POOL_LOCK
+  {
+    freePool();
+  }
+}
+
+/*!
+  \return The number of blocks obtained from the system allocator
+  since the last call to resetCounters().
+*/
+unsigned long vpImageAllocator::getNbAllocations()
+{
+  unsigned long n;
+  VP_POOL_LOCK
+  {
+    n = vpNbAllocations;
+  }
+  return n;
+}
+
+/*!
+  \return The number of allocations served by the pool since the last
+  call to resetCounters().
+*/
+unsigned long vpImageAllocator::getNbReuses()
+{
+  unsigned long n;
+  VP_POOL_LOCK
+  {
+    n = vpNbReuses;
+  }
+  return n;
+}
+
+/*!
+  \return The number of blocks given back to the system allocator
+  since the last call to resetCounters().
+*/
+unsigned long vpImageAllocator::getNbReleases()
+{
+  unsigned long n;
+  VP_POOL_LOCK
+  {
+    n = vpNbReleases;
+  }
+  return n;
+}
+
+/*!
+  Reset the allocation, reuse and release counters to zero.
+*/
+void vpImageAllocator::resetCounters()
+{
+  VP_POOL_LOCK
+  {
+    vpNbAllocations = 0;
+    vpNbReuses = 0;
+    vpNbReleases = 0;
+  }
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Aligned and pooled memory allocation for images.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpImageAllocator_H
+#define vpImageAllocator_H
+
+/*!
+  \file vpImageAllocator.h
+
+  \brief Aligned and pooled memory allocation used by vpImage.
+*/
+
+#include <visp/vpConfig.h>
+
+#include <stddef.h>
+
+/*!
+  \class vpImageAllocator
+
+  \ingroup ImageContainer
+
+  \brief Memory allocation policy of the vpImage pixels and row tables.
+
+  All the memory blocks are aligned on getAlignment() bytes (32 by
+  default), which allows SIMD code to use aligned loads on the first
+  pixel of an image. vpImage::initPadded() also aligns each row.
+
+  When the pool is enabled with setPoolEnabled(), released blocks are
+  not given back to the system but kept in buckets indexed by their
+  size. A later allocation of the same size reuses one of them. The
+  temporary images of filters, pyramids or conversions that are
+  allocated and released at each frame then stop calling the system
+  allocator after the first frame. The pool is thread-safe when ViSP
+  is built with pthread or OpenMP. Its size is bounded by
+  setPoolMaxSize().
+
+  The counters getNbAllocations(), getNbReuses() and getNbReleases()
+  allow the reuse to be measured.
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpImageAllocator.h>
+#include <iostream>
+
+int main()
+{
+  vpImageAllocator::setPoolEnabled(true);
+  for (unsigned int frame = 0; frame < 100; frame++) {
+    vpImage<unsigned char> tmp(480, 640); // Reuses the block of the previous frame
+  }
+  std::cout << vpImageAllocator::getNbAllocations() << " allocations, "
+            << vpImageAllocator::getNbReuses() << " reuses" << std::endl;
+}
+  \endcode
+*/
+class VISP_EXPORT vpImageAllocator
+{
+public:
+  //! Default alignment in bytes of the allocated blocks.
+  static const unsigned int DEFAULT_ALIGNMENT = 32;
+
+  static void *allocate(size_t size);
+  static void release(void *ptr);
+
+  static unsigned int getAlignment();
+  static void setAlignment(unsigned int alignment);
+
+  static bool isPoolEnabled();
+  static void setPoolEnabled(bool enable);
+  static size_t getPoolMaxSize();
+  static void setPoolMaxSize(size_t size);
+  static size_t getPoolSize();
+  static void clearPool();
+
+  static unsigned long getNbAllocations();
+  static unsigned long getNbReuses();
+  static unsigned long getNbReleases();
+  static void resetCounters();
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -48,791 +48,1346 @@
 
 
 #include <sstream>
+#include <string.h>
 
 // image
 #include <visp/vpImageConvert.h>
 
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+// The SSSE3 and AVX2 kernels are compiled for their own instruction set
+// and only called when the processor supports it
+#  if (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || defined(__clang__)
+#    include <immintrin.h>
+#    define VP_CONVERT_DISPATCH
+#    define VP_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    define VP_TARGET_AVX2 __attribute__((target("avx2")))
+#  elif defined(_MSC_VER) && (_MSC_VER >= 1700)
+#    include <immintrin.h>
+#    include <intrin.h>
+#    define VP_CONVERT_DISPATCH
+#    define VP_TARGET_SSSE3
+#    define VP_TARGET_AVX2
+#  endif
+#endif
+
 bool vpImageConvert::YCbCrLUTcomputed = false;
 int vpImageConvert::vpCrr[256];
 int vpImageConvert::vpCgb[256];
 int vpImageConvert::vpCgr[256];
 int vpImageConvert::vpCbb[256];
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Number of threads used by the conversions of large images
+  unsigned int vpConvertThreads = 1;
+  // Images with less pixels are converted by a single thread
+  const unsigned int vpConvertParallelMinPixels = 256*256;
+  // Instruction set in use, -1 until the processor is probed
+  int vpConvertSimd = -1;
+
+  // Tables of the YCbCr conversions, set by computeYCbCrLUT()
+  const int *vpLutCrr = NULL;
+  const int *vpLutCgb = NULL;
+  const int *vpLutCgr = NULL;
+  const int *vpLutCbb = NULL;
+
+  // Conversion of n pixels of a packed format
+  typedef void (*vpPackedKernel)(const unsigned char *src, unsigned char *dst,
+                                 unsigned int n);
+  // Conversion of npairs pairs of rows of a planar 4:2:0 image
+  typedef void (*vpPlanarKernel)(const unsigned char *y, const unsigned char *u,
+                                 const unsigned char *v, unsigned char *dst,
+                                 unsigned int width, unsigned int npairs);
+
+  vpImageConvert::vpSimdType detectSimd()
+  {
+#if defined(VP_CONVERT_DISPATCH) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int nids = info[0];
+    __cpuid(info, 1);
+    bool ssse3 = (info[2] & (1 << 9)) != 0;
+    bool avx = ((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0)
+      && ((_xgetbv(0) & 6) == 6);
+    bool avx2 = false;
+    if (avx && nids >= 7) {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    if (avx2) return vpImageConvert::SIMD_AVX2;
+    if (ssse3) return vpImageConvert::SIMD_SSSE3;
+    return vpImageConvert::SIMD_SSE2;
+#elif defined(VP_CONVERT_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return vpImageConvert::SIMD_AVX2;
+    if (__builtin_cpu_supports("ssse3")) return vpImageConvert::SIMD_SSSE3;
+    return vpImageConvert::SIMD_SSE2;
+#elif defined(VISP_HAVE_SSE2)
+    return vpImageConvert::SIMD_SSE2;
+#else
+    return vpImageConvert::SIMD_NONE;
+#endif
+  }
 
-/*!
-Convert a vpImage\<vpRGBa\> to a vpImage\<unsigned char\>
-\param src : source image
-\param dest : destination image
-*/
-void
-vpImageConvert::convert(const vpImage<unsigned char> &src,
-      vpImage<vpRGBa> & dest)
-{
-  dest.resize(src.getHeight(), src.getWidth()) ;
-
-  GreyToRGBa(src.bitmap, (unsigned char *)dest.bitmap,
-       src.getHeight() * src.getWidth() );
-}
-
-/*!
-Convert a vpImage\<unsigned char\> to a vpImage\<vpRGBa\>
-\param src : source image
-\param dest : destination image
-*/
-void
-vpImageConvert::convert(const vpImage<vpRGBa> &src,
-      vpImage<unsigned char> & dest)
-{
-  dest.resize(src.getHeight(), src.getWidth()) ;
+  // Select the kernel of the best instruction set allowed by
+  // vpImageConvert::getSimdType(). NULL entries are not implemented.
+  template<class Kernel>
+  Kernel pickKernel(Kernel scalar, Kernel sse2, Kernel ssse3, Kernel avx2)
+  {
+    int simd = (int)vpImageConvert::getSimdType();
+    if (simd >= (int)vpImageConvert::SIMD_AVX2 && avx2 != NULL) return avx2;
+    if (simd >= (int)vpImageConvert::SIMD_SSSE3 && ssse3 != NULL) return ssse3;
+    if (simd >= (int)vpImageConvert::SIMD_SSE2 && sse2 != NULL) return sse2;
+    return scalar;
+  }
 
-  RGBaToGrey((unsigned char *)src.bitmap, dest.bitmap,
-       src.getHeight() * src.getWidth() );
-}
+  // Non template overloads, so that NULL can be given for a missing kernel
+  inline vpPackedKernel selectKernel(vpPackedKernel scalar, vpPackedKernel sse2,
+                                     vpPackedKernel ssse3, vpPackedKernel avx2)
+  {
+    return pickKernel(scalar, sse2, ssse3, avx2);
+  }
 
+  inline vpPlanarKernel selectKernel(vpPlanarKernel scalar, vpPlanarKernel sse2,
+                                     vpPlanarKernel ssse3, vpPlanarKernel avx2)
+  {
+    return pickKernel(scalar, sse2, ssse3, avx2);
+  }
 
-/*!
-Convert a vpImage\<float\> to a vpImage\<unsigend char\> by renormalizing between 0 and 255.
-\param src : source image
-\param dest : destination image
-*/
-void
-vpImageConvert::convert(const vpImage<float> &src,
-          vpImage<unsigned char> &dest)
-{
-  dest.resize(src.getHeight(), src.getWidth()) ;
-  unsigned int max_xy = src.getWidth()*src.getHeight();
-  float min, max;
+  unsigned int convertThreads(unsigned int npixels)
+  {
+#ifdef VISP_HAVE_OPENMP
+    if (npixels >= vpConvertParallelMinPixels)
+      return vpConvertThreads;
+#else
+    (void)npixels;
+#endif
+    return 1;
+  }
 
-  src.getMinMaxValue(min,max);
-  
-  for (unsigned int i = 0; i < max_xy; i++) {
-    float val = 255.f * (src.bitmap[i] - min) / (max - min);
-    if(val < 0)
-      dest.bitmap[i] = 0;
-    else if(val > 255)
-      dest.bitmap[i] = 255;
-    else
-      dest.bitmap[i] = (int)val;
+  // Convert n pixels stored by groups of unit pixels, each group using
+  // srcUnit bytes in the source and dstUnit bytes in the destination.
+  // Large images are split in one band per thread.
+  void runPacked(vpPackedKernel kernel, const unsigned char *src,
+                 unsigned char *dst, unsigned int n, unsigned int unit,
+                 unsigned int srcUnit, unsigned int dstUnit)
+  {
+    int nthreads = (int)convertThreads(n);
+    if (nthreads <= 1) {
+      kernel(src, dst, n);
+      return;
+    }
+    unsigned int nunits = n / unit;
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel for num_threads(nthreads)
+#endif
+    for (int t = 0; t < nthreads; t++) {
+      unsigned int base = nunits / (unsigned int)nthreads;
+      unsigned int rem = nunits % (unsigned int)nthreads;
+      unsigned int ut = (unsigned int)t;
+      unsigned int u0 = ut*base + (ut < rem ? ut : rem);
+      unsigned int u1 = u0 + base + (ut < rem ? 1 : 0);
+      // The last band also converts the pixels of an incomplete group
+      unsigned int np = (t == nthreads - 1) ? n - u0*unit : (u1 - u0)*unit;
+      kernel(src + (size_t)u0*srcUnit, dst + (size_t)u0*dstUnit, np);
+    }
   }
-}
 
-/*!
-Convert a vpImage\<unsigned char\> to a vpImage\<float\> by basic casting.
-\param src : source image
-\param dest : destination image
-*/
-void
-vpImageConvert::convert(const vpImage<unsigned char> &src,
-          vpImage<float> &dest)
-{
-  dest.resize(src.getHeight(), src.getWidth()) ;
-  for (unsigned int i = 0; i < src.getHeight()*src.getWidth(); i++)
-    dest.bitmap[i] = (float)src.bitmap[i];
-}
+  // Convert a planar 4:2:0 image; bands of row pairs are given to the threads
+  void runPlanar(vpPlanarKernel kernel, const unsigned char *y,
+                 const unsigned char *u, const unsigned char *v,
+                 unsigned char *dst, unsigned int width, unsigned int height,
+                 unsigned int dstBpp)
+  {
+    unsigned int npairs = height / 2;
+    int nthreads = (int)convertThreads(width*height);
+    if (nthreads <= 1) {
+      kernel(y, u, v, dst, width, npairs);
+      return;
+    }
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel for num_threads(nthreads)
+#endif
+    for (int t = 0; t < nthreads; t++) {
+      unsigned int p0 = (unsigned int)(((double)npairs * t) / nthreads);
+      unsigned int p1 = (unsigned int)(((double)npairs * (t+1)) / nthreads);
+      size_t c = (size_t)p0 * (width/2);
+      kernel(y + (size_t)2*p0*width, u + c, v + c,
+             dst + (size_t)2*p0*width*dstBpp, width, p1 - p0);
+    }
+  }
 
-/*!
-Convert a vpImage\<double\> to a vpImage\<unsigend char\> by renormalizing between 0 and 255.
-\param src : source image
-\param dest : destination image
-*/
-void
-vpImageConvert::convert(const vpImage<double> &src,
-          vpImage<unsigned char> &dest)
-{
-  dest.resize(src.getHeight(), src.getWidth()) ;
-  unsigned int max_xy = src.getWidth()*src.getHeight();
-  double min, max;
+  //
+  // Portable kernels. They are the former implementations of the
+  // conversions and also convert the last pixels left by the SIMD kernels.
+  //
 
-  src.getMinMaxValue(min,max);
-  
-  for (unsigned int i = 0; i < max_xy; i++) {
-    double val = 255. * (src.bitmap[i] - min) / (max - min);
-    if(val < 0)
-      dest.bitmap[i] = 0;
-    else if(val > 255)
-      dest.bitmap[i] = 255;
-    else
-      dest.bitmap[i] = (int)val;
+  inline unsigned char vpSat(int v)
+  {
+    return (unsigned char)((v < 0) ? 0 : ((v > 255) ? 255 : v));
   }
-}
 
-/*!
-Convert a vpImage\<unsigned char\> to a vpImage\<double\> by basic casting.
-\param src : source image
-\param dest : destination image
-*/
-void
-vpImageConvert::convert(const vpImage<unsigned char> &src,
-          vpImage<double> &dest)
-{
-  dest.resize(src.getHeight(), src.getWidth()) ;
-  for (unsigned int i = 0; i < src.getHeight()*src.getWidth(); i++)
-    dest.bitmap[i] = (double)src.bitmap[i];
-}
+  // Model of the YUV422, YUV411, YUV420, YV12 and YUV444 conversions
+  // R = Y + 1.414 V, G = Y - 0.354 U - 0.707 V, B = Y + 1.77 U
+  inline void vispPixel(int Y, int U, int V, unsigned char *d)
+  {
+    d[0] = vpSat(Y + 2*V);
+    d[1] = vpSat(Y - U - V);
+    d[2] = vpSat(Y + 5*U);
+  }
+  inline int vispU(int u) { return (int)((u - 128) * 0.354); }
+  inline int vispV(int v) { return (int)((v - 128) * 0.707); }
 
-#ifdef VISP_HAVE_OPENCV
-/*!
-  Convert a IplImage to a vpImage\<vpRGBa\>
+  // Model of the YUYV conversions
+  inline void yuyvPair(const unsigned char *s, unsigned char *d, unsigned int bpp)
+  {
+    int cb = ((s[1] - 128) * 454) >> 8;
+    int cg = ((s[1] - 128) * 88 + (s[3] - 128) * 183) >> 8;
+    int cr = ((s[3] - 128) * 359) >> 8;
+    d[0] = vpSat(s[0] + cr);
+    d[1] = vpSat(s[0] - cg);
+    d[2] = vpSat(s[0] + cb);
+    d[bpp]   = vpSat(s[2] + cr);
+    d[bpp+1] = vpSat(s[2] - cg);
+    d[bpp+2] = vpSat(s[2] + cb);
+  }
 
-  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
-  image structure. See http://opencvlibrary.sourceforge.net/ for general
-  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
-  for the specific IplImage structure documentation.
+  void yuyvToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n / 2; i; i--, s += 4, d += 8) {
+      yuyvPair(s, d, 4);
+      d[3] = d[7] = 0;
+    }
+  }
 
-  \warning This function is only available if OpenCV was detected during
-  the configuration step.
+  void yuyvToRGB(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n / 2; i; i--, s += 4, d += 6)
+      yuyvPair(s, d, 3);
+  }
 
-  \param src : Source image in OpenCV format.
-  \param dest : Destination image in ViSP format.
-  \param flip : Set to true to vertically flip the converted image.
+  // u01 y0 v01 y1, the alpha byte is not modified
+  void uyvyToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n / 2; i; i--, s += 4, d += 8) {
+      int U = vispU(s[0]), V = vispV(s[2]);
+      vispPixel(s[1], U, V, d);
+      vispPixel(s[3], U, V, d + 4);
+    }
+  }
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
+  void uyvyToRGB(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n / 2; i; i--, s += 4, d += 6) {
+      int U = vispU(s[0]), V = vispV(s[2]);
+      vispPixel(s[1], U, V, d);
+      vispPixel(s[3], U, V, d + 3);
+    }
+  }
 
-int main()
-{
-#ifdef VISP_HAVE_OPENCV
-  vpImage<vpRGBa> Ic; // A color image
-  IplImage* Ip;
+  // u y0 y1 v y2 y3, the alpha byte is not modified
+  void yuv411ToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n / 4; i; i--, s += 6, d += 16) {
+      int U = vispU(s[0]), V = vispV(s[3]);
+      vispPixel(s[1], U, V, d);
+      vispPixel(s[2], U, V, d + 4);
+      vispPixel(s[4], U, V, d + 8);
+      vispPixel(s[5], U, V, d + 12);
+    }
+  }
 
-  // Read an image on a disk with openCV library
-  Ip = cvLoadImage("image.ppm", CV_LOAD_IMAGE_COLOR);
-  // Convert the grayscale IplImage into vpImage<vpRGBa>
-  vpImageConvert::convert(Ip, Ic);
+  void yuv411ToRGB(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n / 4; i; i--, s += 6, d += 12) {
+      int U = vispU(s[0]), V = vispV(s[3]);
+      vispPixel(s[1], U, V, d);
+      vispPixel(s[2], U, V, d + 3);
+      vispPixel(s[4], U, V, d + 6);
+      vispPixel(s[5], U, V, d + 9);
+    }
+  }
 
-  // ...
+  // u y v
+  void yuv444ToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, s += 3, d += 4) {
+      vispPixel(s[1], vispU(s[0]), vispV(s[2]), d);
+      d[3] = 0;
+    }
+  }
 
-  // Release Ip header and data
-  cvReleaseImage(&Ip);
-#endif
-}
-  \endcode
-*/
-void
-vpImageConvert::convert(const IplImage* src, vpImage<vpRGBa> & dest, bool flip)
-{
-  int nChannel = src->nChannels;
-  int depth = src->depth;
-  int height = src->height;
-  int width = src->width;
-  int widthStep = src->widthStep;
-  int lineStep = (flip) ? 1 : 0;
+  void yuv444ToRGB(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, s += 3, d += 3)
+      vispPixel(s[1], vispU(s[0]), vispV(s[2]), d);
+  }
 
-  if(nChannel == 3 && depth == 8){
-    dest.resize((unsigned int)height, (unsigned int)width);
+  template<unsigned int bpp>
+  void yuv420Rows(const unsigned char *y, const unsigned char *u,
+                  const unsigned char *v, unsigned char *dst,
+                  unsigned int width, unsigned int npairs, unsigned int j0)
+  {
+    for (unsigned int i = 0; i < npairs; i++) {
+      const unsigned char *y0 = y + 2*i*width, *y1 = y0 + width;
+      const unsigned char *ui = u + i*(width/2), *vi = v + i*(width/2);
+      unsigned char *d0 = dst + 2*i*width*bpp, *d1 = d0 + width*bpp;
+      for (unsigned int j = j0; j + 1 < width; j += 2) {
+        int U = vispU(ui[j/2]), V = vispV(vi[j/2]);
+        vispPixel(y0[j],   U, V, d0 + j*bpp);
+        vispPixel(y0[j+1], U, V, d0 + (j+1)*bpp);
+        vispPixel(y1[j],   U, V, d1 + j*bpp);
+        vispPixel(y1[j+1], U, V, d1 + (j+1)*bpp);
+        if (bpp == 4)
+          d0[j*bpp+3] = d0[(j+1)*bpp+3] = d1[j*bpp+3] = d1[(j+1)*bpp+3] = 0;
+      }
+    }
+  }
 
-    //starting source address
-    unsigned char* input = (unsigned char*)src->imageData;
-    unsigned char* line;
-    unsigned char* beginOutput = (unsigned char*)dest.bitmap;
-    unsigned char* output = NULL;
+  void yuv420ToRGBa(const unsigned char *y, const unsigned char *u,
+                    const unsigned char *v, unsigned char *dst,
+                    unsigned int width, unsigned int npairs)
+  {
+    yuv420Rows<4>(y, u, v, dst, width, npairs, 0);
+  }
 
-    for(int i=0 ; i < height ; i++)
-    {
-      line = input;
-      output = beginOutput + lineStep * ( 4 * width * ( height - 1 - i ) ) + (1-lineStep) * 4 * width * i;
-      for(int j=0 ; j < width ; j++)
-        {
-          *(output++) = *(line+2);
-          *(output++) = *(line+1);
-          *(output++) = *(line);
-          *(output++) = 0;
+  void yuv420ToRGB(const unsigned char *y, const unsigned char *u,
+                   const unsigned char *v, unsigned char *dst,
+                   unsigned int width, unsigned int npairs)
+  {
+    yuv420Rows<3>(y, u, v, dst, width, npairs, 0);
+  }
 
-          line+=3;
-        }
-      //go to the next line
-      input+=widthStep;
+  // Y0 Cb01 Y1 Cr01 (or Y0 Cr01 Y1 Cb01 when cb is 3)
+  template<unsigned int bpp, unsigned int cb>
+  void ycbcrToRGB(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const unsigned int cr = 4 - cb;
+    for (unsigned int i = 0; i < n; i++, s += 2, d += bpp) {
+      const unsigned char *c = s - 2*(i % 2);
+      int Y = s[0];
+      d[0] = vpSat(Y + vpLutCrr[c[cr]]);
+      d[1] = vpSat(Y + vpLutCgb[c[cb]] + vpLutCgr[c[cr]]);
+      d[2] = vpSat(Y + vpLutCbb[c[cb]]);
+      if (bpp == 4)
+        d[3] = 0;
     }
   }
-  else if(nChannel == 1 && depth == 8 ){
-    dest.resize((unsigned int)height, (unsigned int)width);
-    //starting source address
-    unsigned char * input = (unsigned char*)src->imageData;
-    unsigned char * line;
-    unsigned char* beginOutput = (unsigned char*)dest.bitmap;
-    unsigned char* output = NULL;
 
-    for(int i=0 ; i < height ; i++)
-    {
-      line = input;
-      output = beginOutput + lineStep * ( 4 * width * ( height - 1 - i ) ) + (1-lineStep) * 4 * width * i;
-      for(int j=0 ; j < width ; j++)
-        {
-          *output++ = *(line);
-          *output++ = *(line);
-          *output++ = *(line);
-          *output++ = *(line);;
+  // dst[k] = src[k*step + offset]
+  template<unsigned int step, unsigned int offset>
+  void extractBytes(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    s += offset;
+    for (unsigned int i = n; i; i--, s += step)
+      *d++ = *s;
+  }
 
-          line++;
-        }
-      //go to the next line
-      input+=widthStep;
+  void yuv411ToGrey(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 4 <= n; i += 4, s += 6) {
+      d[i]   = s[1];
+      d[i+1] = s[2];
+      d[i+2] = s[4];
+      d[i+3] = s[5];
     }
+    for (unsigned int k = 0; i < n; i++, k++)
+      d[i] = s[(k < 2) ? 1 + k : 2 + k];
   }
-}
 
-/*!
-  Convert a IplImage to a vpImage\<unsigned char\>
+  // Weights from linear RGB to CIE luminance
+  template<unsigned int bpp, unsigned int r, unsigned int b>
+  void toGrey(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, s += bpp)
+      *d++ = (unsigned char)(0.2126 * s[r] + 0.7152 * s[1] + 0.0722 * s[b]);
+  }
 
-  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
-  image structure. See http://opencvlibrary.sourceforge.net/ for general
-  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
-  for the specific IplImage structure documentation.
+  template<unsigned int r, unsigned int b>
+  void rgbToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, s += 3, d += 4) {
+      d[0] = s[r];
+      d[1] = s[1];
+      d[2] = s[b];
+      d[3] = 0;
+    }
+  }
 
-  \warning This function is only available if OpenCV was detected during
-  the configuration step.
+  void rgbaToRGB(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, s += 4, d += 3) {
+      d[0] = s[0];
+      d[1] = s[1];
+      d[2] = s[2];
+    }
+  }
 
-  \param src : Source image in OpenCV format.
-  \param dest : Destination image in ViSP format.
-  \param flip : Set to true to vertically flip the converted image.
+  void greyToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, d += 4)
+      d[0] = d[1] = d[2] = d[3] = *s++;
+  }
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
+  // Most significant byte of the big endian 16 bits values
+  void mono16ToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int i = n; i; i--, s += 2, d += 4) {
+      d[0] = d[1] = d[2] = s[0];
+      d[3] = 0;
+    }
+  }
 
-int main()
-{
-#ifdef VISP_HAVE_OPENCV
-  vpImage<unsigned char> Ig; // A grayscale image
-  IplImage* Ip;
+  // Convert an image row by row, from the last row of src if flip is true
+  void runRows(vpPackedKernel kernel, const unsigned char *src,
+               unsigned char *dst, unsigned int width, unsigned int height,
+               bool flip, unsigned int srcBpp, unsigned int dstBpp)
+  {
+    if (! flip) {
+      runPacked(kernel, src, dst, width*height, 1, srcBpp, dstBpp);
+      return;
+    }
+    int h = (int)height;
+#ifdef VISP_HAVE_OPENMP
+    int nthreads = (int)convertThreads(width*height);
+    #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+    for (int i = 0; i < h; i++)
+      kernel(src + (size_t)(h - 1 - i)*width*srcBpp,
+             dst + (size_t)i*width*dstBpp, width);
+  }
 
-  // Read an image on a disk with openCV library
-  Ip = cvLoadImage("image.pgm", CV_LOAD_IMAGE_GRAYSCALE);
-  // Convert the grayscale IplImage into vpImage<unsigned char>
-  vpImageConvert::convert(Ip, Ig);
+#ifdef VISP_HAVE_SSE2
+  //
+  // SSE2 kernels, 8 pixels per iteration
+  //
 
-  // ...
+  // (int)(d * c) for |d| <= 128, computed as (|d| * k) >> 16 with the
+  // sign of d. k = 23200 for c = 0.354 and k = 46334 for c = 0.707 give
+  // the same result as the double precision product for all the d.
+  inline __m128i truncMul(__m128i d, __m128i k)
+  {
+    __m128i s = _mm_srai_epi16(d, 15);
+    __m128i a = _mm_sub_epi16(_mm_xor_si128(d, s), s);
+    __m128i p = _mm_mulhi_epu16(a, k);
+    return _mm_sub_epi16(_mm_xor_si128(p, s), s);
+  }
 
-  // Release Ip header and data
-  cvReleaseImage(&Ip);
-#endif
-}
-  \endcode
-*/
-void
-vpImageConvert::convert(const IplImage* src,
-      vpImage<unsigned char> &dest, bool flip)
-{
-  int nChannel = src->nChannels;
-  int depth = src->depth;
-  int height = src->height;
-  int width = src->width;
-  int widthStep = src->widthStep;
-  int lineStep = (flip) ? 1 : 0;
+  // Y, u and v on 16 bits give R, G and B on 16 bits before saturation
+  inline void vispRGB(__m128i y, __m128i u, __m128i v,
+                      __m128i &r, __m128i &g, __m128i &b)
+  {
+    const __m128i c128 = _mm_set1_epi16(128);
+    __m128i U = truncMul(_mm_sub_epi16(u, c128), _mm_set1_epi16(23200));
+    __m128i V = truncMul(_mm_sub_epi16(v, c128), _mm_set1_epi16((short)46334));
+    r = _mm_add_epi16(y, _mm_add_epi16(V, V));
+    g = _mm_sub_epi16(y, _mm_add_epi16(U, V));
+    b = _mm_add_epi16(y, _mm_add_epi16(_mm_slli_epi16(U, 2), U));
+  }
 
-  if (flip == false)
+  // Duplicate the even (odd) 16 bits values: a0 a0 a2 a2... (a1 a1 a3 a3...)
+  inline __m128i dupEven(__m128i x)
   {
-    if(widthStep == width){
-      if(nChannel == 1 && depth == 8){
-        dest.resize((unsigned int)height, (unsigned int)width) ;
-        memcpy(dest.bitmap, src->imageData,
-                (size_t)(height*width));
-      }
-      if(nChannel == 3 && depth == 8){
-        dest.resize((unsigned int)height, (unsigned int)width) ;
-        BGRToGrey((unsigned char*)src->imageData,dest.bitmap, (unsigned int)width, (unsigned int)height,false);
-      }
-    }
-    else{
-      if(nChannel == 1 && depth == 8){
-        dest.resize((unsigned int)height, (unsigned int)width) ;
-        for (int i =0  ; i < height ; i++){
-          memcpy(dest.bitmap+i*width, src->imageData + i*widthStep,
-                (size_t)width);
-        }
-      }
-      if(nChannel == 3 && depth == 8){
-        dest.resize((unsigned int)height, (unsigned int)width) ;
-        for (int i = 0  ; i < height ; i++){
-          BGRToGrey((unsigned char*)src->imageData + i*widthStep,
-                      dest.bitmap + i*width, (unsigned int)width, 1, false);
-        }
-      }
-    }
+    return _mm_or_si128(_mm_and_si128(x, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(x, 16));
   }
-  else
+  inline __m128i dupOdd(__m128i x)
   {
-      if(nChannel == 1 && depth == 8){
-      unsigned char* beginOutput = (unsigned char*)dest.bitmap;
-        dest.resize((unsigned int)height, (unsigned int)width) ;
-        for (int i =0  ; i < height ; i++){
-          memcpy(beginOutput + lineStep * ( 4 * width * ( height - 1 - i ) ) , src->imageData + i*widthStep,
-                (size_t)width);
-        }
-      }
-      if(nChannel == 3 && depth == 8){
-        dest.resize((unsigned int)height, (unsigned int)width) ;
-        //for (int i = 0  ; i < height ; i++){
-          BGRToGrey((unsigned char*)src->imageData /*+ i*widthStep*/,
-                      dest.bitmap /*+ i*width*/, (unsigned int)width, (unsigned int)height/*1*/, true);
-        //}
-      }
+    return _mm_or_si128(_mm_srli_epi32(x, 16), _mm_andnot_si128(_mm_set1_epi32(0xFFFF), x));
   }
-}
-
-/*!
-  Convert a vpImage\<vpRGBa\> to a IplImage
 
-  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
-  image structure. See http://opencvlibrary.sourceforge.net/ for general
-  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
-  for the specific IplImage structure documentation.
+  // 8 packed u y v y pixels
+  inline void loadUYVY(const unsigned char *s, __m128i &y, __m128i &u, __m128i &v)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)s);
+    __m128i c = _mm_and_si128(x, _mm_set1_epi16(0xFF));
+    y = _mm_srli_epi16(x, 8);
+    u = dupEven(c);
+    v = dupOdd(c);
+  }
 
-  \warning This function is only available if OpenCV was detected during
-  the configuration step.
+  // 8 pixels of a planar image with the chroma sub-sampled by 2
+  inline void load420(const unsigned char *yr, const unsigned char *ur,
+                      const unsigned char *vr, __m128i &y, __m128i &u, __m128i &v)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    int u4, v4;
+    memcpy(&u4, ur, 4);
+    memcpy(&v4, vr, 4);
+    __m128i cu = _mm_cvtsi32_si128(u4);
+    __m128i cv = _mm_cvtsi32_si128(v4);
+    y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)yr), zero);
+    u = _mm_unpacklo_epi8(_mm_unpacklo_epi8(cu, cu), zero);
+    v = _mm_unpacklo_epi8(_mm_unpacklo_epi8(cv, cv), zero);
+  }
 
-  \param src : source image
-  \param dest : destination image
+  // Saturate and interleave 8 R, G, B values in 8 RGBa pixels. The
+  // alpha bytes are 0.
+  inline void packRGBa(__m128i r, __m128i g, __m128i b, __m128i &p0, __m128i &p1)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i rb = _mm_packus_epi16(r, b);
+    __m128i rg = _mm_unpacklo_epi8(rb, _mm_packus_epi16(g, zero));
+    __m128i b0 = _mm_unpackhi_epi8(rb, zero);
+    p0 = _mm_unpacklo_epi16(rg, b0);
+    p1 = _mm_unpackhi_epi16(rg, b0);
+  }
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
+  inline void storeRGBa(unsigned char *d, __m128i r, __m128i g, __m128i b,
+                        bool keepAlpha)
+  {
+    __m128i p0, p1;
+    packRGBa(r, g, b, p0, p1);
+    if (keepAlpha) {
+      const __m128i a = _mm_set1_epi32((int)0xFF000000);
+      p0 = _mm_or_si128(p0, _mm_and_si128(_mm_loadu_si128((const __m128i *)d), a));
+      p1 = _mm_or_si128(p1, _mm_and_si128(_mm_loadu_si128((const __m128i *)(d+16)), a));
+    }
+    _mm_storeu_si128((__m128i *)d, p0);
+    _mm_storeu_si128((__m128i *)(d+16), p1);
+  }
 
-int main()
-{
-#ifdef VISP_HAVE_OPENCV
-  vpImage<vpRGBa> Ic; // A color image
-  IplImage* Ip = NULL;
+  inline void storeRGB(unsigned char *d, __m128i r, __m128i g, __m128i b)
+  {
+    unsigned char t[32];
+    __m128i p0, p1;
+    packRGBa(r, g, b, p0, p1);
+    _mm_storeu_si128((__m128i *)t, p0);
+    _mm_storeu_si128((__m128i *)(t+16), p1);
+    for (unsigned int k = 0; k < 8; k++, d += 3) {
+      d[0] = t[4*k];
+      d[1] = t[4*k+1];
+      d[2] = t[4*k+2];
+    }
+  }
 
-  // Read an image on a disk
-  vpImageIo::readPPM(Ic, "image.ppm");
-  // Convert the vpImage<vpRGBa> in to color IplImage
-  vpImageConvert::convert(Ic, Ip);
-  // Treatments on IplImage
-  //...
-  // Save the IplImage on the disk
-  cvSaveImage("Ipl.ppm", Ip);
+  // YUYV model: cb = (du*454)>>8, cr = (dv*359)>>8 computed as the high
+  // part of (4d) * (64 * coefficient), cg = (du*88 + dv*183)>>8
+  inline void yuyvRGB(const unsigned char *s, __m128i &r, __m128i &g, __m128i &b)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)s);
+    __m128i y = _mm_and_si128(x, _mm_set1_epi16(0xFF));
+    __m128i d = _mm_sub_epi16(_mm_srli_epi16(x, 8), _mm_set1_epi16(128));
+    __m128i cbcr = _mm_mulhi_epi16(_mm_slli_epi16(d, 2),
+                                   _mm_set1_epi32((22976 << 16) | 29056));
+    __m128i cg = _mm_srai_epi32(_mm_madd_epi16(d, _mm_set1_epi32((183 << 16) | 88)), 8);
+    r = _mm_add_epi16(y, dupOdd(cbcr));
+    g = _mm_sub_epi16(y, dupEven(cg));
+    b = _mm_add_epi16(y, dupEven(cbcr));
+  }
 
-  //Release Ip header and data
-  cvReleaseImage(&Ip);
-#endif
-}
-  \endcode
-*/
-void
-vpImageConvert::convert(const vpImage<vpRGBa> & src, IplImage *&dest)
-{
-  int height = (int)src.getHeight();
-  int width  = (int)src.getWidth();
-  CvSize size = cvSize(width, height);
-  int depth = 8;
-  int channels = 3;
-  if (dest != NULL){
-    if(dest->nChannels != channels || dest->depth != depth
-       || dest->height != height || dest->width != width){
-      if(dest->nChannels != 0) cvReleaseImage(&dest);
-      dest = cvCreateImage( size, depth, channels );
+  void yuyvToRGBaSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 32) {
+      __m128i r, g, b;
+      yuyvRGB(s, r, g, b);
+      storeRGBa(d, r, g, b, false);
     }
+    yuyvToRGBa(s, d, n - i);
   }
-  else dest = cvCreateImage( size, depth, channels );
-
 
-  //starting source address
-  unsigned char * input = (unsigned char*)src.bitmap;//rgba image
-  unsigned char * line;
-  unsigned char * output = (unsigned char*)dest->imageData;//bgr image
+  void yuyvToRGBSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 24) {
+      __m128i r, g, b;
+      yuyvRGB(s, r, g, b);
+      storeRGB(d, r, g, b);
+    }
+    yuyvToRGB(s, d, n - i);
+  }
 
-  int j=0;
-  int i=0;
-  int widthStep = dest->widthStep;
+  void uyvyToRGBaSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 32) {
+      __m128i y, u, v, r, g, b;
+      loadUYVY(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGBa(d, r, g, b, true);
+    }
+    uyvyToRGBa(s, d, n - i);
+  }
 
-  for(i=0 ; i < height ; i++)
+  void uyvyToRGBSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
   {
-    output = (unsigned char*)dest->imageData + i*widthStep;
-    line = input;
-    for( j=0 ; j < width ; j++)
-      {
-        *output++ = *(line+2);  //B
-        *output++ = *(line+1);  //G
-        *output++ = *(line);  //R
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 24) {
+      __m128i y, u, v, r, g, b;
+      loadUYVY(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGB(d, r, g, b);
+    }
+    uyvyToRGB(s, d, n - i);
+  }
 
-        line+=4;
+  template<unsigned int bpp>
+  void yuv420SSE2(const unsigned char *y, const unsigned char *u,
+                  const unsigned char *v, unsigned char *dst,
+                  unsigned int width, unsigned int npairs)
+  {
+    unsigned int w8 = width & ~7u;
+    for (unsigned int i = 0; i < npairs; i++) {
+      const unsigned char *ui = u + i*(width/2), *vi = v + i*(width/2);
+      for (unsigned int k = 0; k < 2; k++) {
+        const unsigned char *yr = y + (2*i+k)*width;
+        unsigned char *d = dst + (2*i+k)*width*bpp;
+        for (unsigned int j = 0; j < w8; j += 8) {
+          __m128i Y, U, V, r, g, b;
+          load420(yr + j, ui + j/2, vi + j/2, Y, U, V);
+          vispRGB(Y, U, V, r, g, b);
+          if (bpp == 4)
+            storeRGBa(d + j*bpp, r, g, b, false);
+          else
+            storeRGB(d + j*bpp, r, g, b);
+        }
       }
-    //go to the next line
-    input+=4*width;
+    }
+    yuv420Rows<bpp>(y, u, v, dst, width, npairs, w8);
   }
-}
 
-/*!
-  Convert a vpImage\<unsigned char\> to a IplImage
+  void yuv420ToRGBaSSE2(const unsigned char *y, const unsigned char *u,
+                        const unsigned char *v, unsigned char *dst,
+                        unsigned int width, unsigned int npairs)
+  {
+    yuv420SSE2<4>(y, u, v, dst, width, npairs);
+  }
 
-  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
-  image structure. See http://opencvlibrary.sourceforge.net/ for general
-  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
-  for the specific IplImage structure documentation.
+  void yuv420ToRGBSSE2(const unsigned char *y, const unsigned char *u,
+                       const unsigned char *v, unsigned char *dst,
+                       unsigned int width, unsigned int npairs)
+  {
+    yuv420SSE2<3>(y, u, v, dst, width, npairs);
+  }
 
-  \warning This function is only available if OpenCV was detected during
-  the configuration step.
+  // The chroma offsets come from the tables; only the luminance is
+  // processed by SSE2
+  template<unsigned int bpp, unsigned int cb>
+  void ycbcrSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const unsigned int cr = 4 - cb;
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 8*bpp) {
+      short ro[8], go[8], bo[8];
+      for (unsigned int k = 0; k < 8; k += 2) {
+        const unsigned char *c = s + 2*k;
+        ro[k] = ro[k+1] = (short)vpLutCrr[c[cr]];
+        go[k] = go[k+1] = (short)(vpLutCgb[c[cb]] + vpLutCgr[c[cr]]);
+        bo[k] = bo[k+1] = (short)vpLutCbb[c[cb]];
+      }
+      __m128i y = _mm_and_si128(_mm_loadu_si128((const __m128i *)s), _mm_set1_epi16(0xFF));
+      __m128i r = _mm_add_epi16(y, _mm_loadu_si128((const __m128i *)ro));
+      __m128i g = _mm_add_epi16(y, _mm_loadu_si128((const __m128i *)go));
+      __m128i b = _mm_add_epi16(y, _mm_loadu_si128((const __m128i *)bo));
+      if (bpp == 4)
+        storeRGBa(d, r, g, b, false);
+      else
+        storeRGB(d, r, g, b);
+    }
+    ycbcrToRGB<bpp, cb>(s, d, n - i);
+  }
 
-  \param src : source image
-  \param dest : destination image
+  // Even (offset 0) or odd (offset 1) bytes of 16 bytes
+  template<unsigned int offset>
+  void extract2SSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const __m128i m = _mm_set1_epi16(0xFF);
+    unsigned int i = 0;
+    for ( ; i + 16 <= n; i += 16, s += 32, d += 16) {
+      __m128i a = _mm_loadu_si128((const __m128i *)s);
+      __m128i b = _mm_loadu_si128((const __m128i *)(s+16));
+      if (offset) {
+        a = _mm_srli_epi16(a, 8);
+        b = _mm_srli_epi16(b, 8);
+      }
+      else {
+        a = _mm_and_si128(a, m);
+        b = _mm_and_si128(b, m);
+      }
+      _mm_storeu_si128((__m128i *)d, _mm_packus_epi16(a, b));
+    }
+    extractBytes<2, offset>(s, d, n - i);
+  }
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
+  // Grey level of 4 pixels given on 32 bits, in double precision as the
+  // portable code
+  inline __m128i greyOf4(__m128i r, __m128i g, __m128i b)
+  {
+    const __m128d wr = _mm_set1_pd(0.2126);
+    const __m128d wg = _mm_set1_pd(0.7152);
+    const __m128d wb = _mm_set1_pd(0.0722);
+    __m128d lo = _mm_add_pd(_mm_add_pd(_mm_mul_pd(wr, _mm_cvtepi32_pd(r)),
+                                       _mm_mul_pd(wg, _mm_cvtepi32_pd(g))),
+                            _mm_mul_pd(wb, _mm_cvtepi32_pd(b)));
+    r = _mm_srli_si128(r, 8);
+    g = _mm_srli_si128(g, 8);
+    b = _mm_srli_si128(b, 8);
+    __m128d hi = _mm_add_pd(_mm_add_pd(_mm_mul_pd(wr, _mm_cvtepi32_pd(r)),
+                                       _mm_mul_pd(wg, _mm_cvtepi32_pd(g))),
+                            _mm_mul_pd(wb, _mm_cvtepi32_pd(b)));
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+  }
 
-int main()
-{
-#ifdef VISP_HAVE_OPENCV
-  vpImage<unsigned char> Ig; // A greyscale image
-  IplImage* Ip = NULL;
+  // 4 pixels stored as r g b x on 32 bits
+  inline __m128i greyOfRGBx(__m128i x, bool bgr)
+  {
+    const __m128i m = _mm_set1_epi32(0xFF);
+    __m128i c0 = _mm_and_si128(x, m);
+    __m128i c1 = _mm_and_si128(_mm_srli_epi32(x, 8), m);
+    __m128i c2 = _mm_and_si128(_mm_srli_epi32(x, 16), m);
+    return bgr ? greyOf4(c2, c1, c0) : greyOf4(c0, c1, c2);
+  }
 
-  // Read an image on a disk
-  vpImageIo::readPGM(Ig, "image.pgm");
-  // Convert the vpImage<unsigned char> in to greyscale IplImage
-  vpImageConvert::convert(Ig, Ip);
-  // Treatments on IplImage Ip
-  //...
-  // Save the IplImage on the disk
-  cvSaveImage("Ipl.pgm", Ip);
+  void rgbaToGreySSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 32, d += 8) {
+      __m128i g0 = greyOfRGBx(_mm_loadu_si128((const __m128i *)s), false);
+      __m128i g1 = greyOfRGBx(_mm_loadu_si128((const __m128i *)(s+16)), false);
+      __m128i g = _mm_packs_epi32(g0, g1);
+      _mm_storel_epi64((__m128i *)d, _mm_packus_epi16(g, g));
+    }
+    toGrey<4, 0, 2>(s, d, n - i);
+  }
 
-  //Release Ip header and data
-  cvReleaseImage(&Ip);
-#endif
-}
-  \endcode
-*/
-void
-vpImageConvert::convert(const vpImage<unsigned char> & src,
-      IplImage* &dest)
-{
-  unsigned int height = src.getHeight();
-  unsigned int width  = src.getWidth();
-  CvSize size = cvSize((int)width, (int)height);
-  int depth = 8;
-  int channels = 1;
-  if (dest != NULL){
-    if(dest->nChannels != channels || dest->depth != depth
-       || dest->height != (int) height || dest->width != (int) width){
-      if(dest->nChannels != 0) cvReleaseImage(&dest);
-      dest = cvCreateImage( size, depth, channels );
+  void greyToRGBaSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 16 <= n; i += 16, s += 16, d += 64) {
+      __m128i x = _mm_loadu_si128((const __m128i *)s);
+      __m128i lo = _mm_unpacklo_epi8(x, x);
+      __m128i hi = _mm_unpackhi_epi8(x, x);
+      _mm_storeu_si128((__m128i *)d,      _mm_unpacklo_epi16(lo, lo));
+      _mm_storeu_si128((__m128i *)(d+16), _mm_unpackhi_epi16(lo, lo));
+      _mm_storeu_si128((__m128i *)(d+32), _mm_unpacklo_epi16(hi, hi));
+      _mm_storeu_si128((__m128i *)(d+48), _mm_unpackhi_epi16(hi, hi));
     }
+    greyToRGBa(s, d, n - i);
   }
-  else dest = cvCreateImage( size, depth, channels );
 
-  unsigned int widthStep = (unsigned int)dest->widthStep;
+  void mono16ToRGBaSSE2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 32) {
+      // v on 16 bits gives the bytes v 0, vv gives v v
+      __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *)s), _mm_set1_epi16(0xFF));
+      __m128i vv = _mm_or_si128(v, _mm_slli_epi16(v, 8));
+      _mm_storeu_si128((__m128i *)d,      _mm_unpacklo_epi16(vv, v));
+      _mm_storeu_si128((__m128i *)(d+16), _mm_unpackhi_epi16(vv, v));
+    }
+    mono16ToRGBa(s, d, n - i);
+  }
+#endif // VISP_HAVE_SSE2
 
-  if ( width == widthStep){
-    memcpy(dest->imageData,src.bitmap, width*height);
+#ifdef VP_CONVERT_DISPATCH
+  //
+  // SSSE3 kernels: byte shuffles for the 3 bytes per pixel formats
+  //
+
+  VP_TARGET_SSSE3
+  inline void storeRGBSSSE3(unsigned char *d, __m128i r, __m128i g, __m128i b)
+  {
+    const __m128i m = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i p0, p1;
+    packRGBa(r, g, b, p0, p1);
+    p0 = _mm_shuffle_epi8(p0, m);
+    p1 = _mm_shuffle_epi8(p1, m);
+    _mm_storeu_si128((__m128i *)d, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storel_epi64((__m128i *)(d+16), _mm_srli_si128(p1, 4));
   }
-  else{
-    //copying each line taking account of the widthStep
-    for (unsigned int i =0  ; i < height ; i++){
-          memcpy(dest->imageData + i*widthStep, src.bitmap + i*width,
-                width);
+
+  VP_TARGET_SSSE3
+  void yuyvToRGBSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 24) {
+      __m128i r, g, b;
+      yuyvRGB(s, r, g, b);
+      storeRGBSSSE3(d, r, g, b);
     }
+    yuyvToRGB(s, d, n - i);
   }
-}
 
-#if VISP_HAVE_OPENCV_VERSION >= 0x020100
-/*!
-  Convert a cv::Mat to a vpImage\<vpRGBa\>
+  VP_TARGET_SSSE3
+  void uyvyToRGBSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 16, d += 24) {
+      __m128i y, u, v, r, g, b;
+      loadUYVY(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGBSSSE3(d, r, g, b);
+    }
+    uyvyToRGB(s, d, n - i);
+  }
 
-  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
-  the general OpenCV documentation, or
-  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
-  for the specific Mat structure documentation.
+  VP_TARGET_SSSE3
+  void yuv420ToRGBSSSE3(const unsigned char *y, const unsigned char *u,
+                        const unsigned char *v, unsigned char *dst,
+                        unsigned int width, unsigned int npairs)
+  {
+    unsigned int w8 = width & ~7u;
+    for (unsigned int i = 0; i < npairs; i++) {
+      const unsigned char *ui = u + i*(width/2), *vi = v + i*(width/2);
+      for (unsigned int k = 0; k < 2; k++) {
+        const unsigned char *yr = y + (2*i+k)*width;
+        unsigned char *d = dst + (2*i+k)*width*3;
+        for (unsigned int j = 0; j < w8; j += 8) {
+          __m128i Y, U, V, r, g, b;
+          load420(yr + j, ui + j/2, vi + j/2, Y, U, V);
+          vispRGB(Y, U, V, r, g, b);
+          storeRGBSSSE3(d + 3*j, r, g, b);
+        }
+      }
+    }
+    yuv420Rows<3>(y, u, v, dst, width, npairs, w8);
+  }
 
-  Similarily to the convert(const IplImage* src, vpImage<vpRGBa> & dest, bool flip)
-  method, only Mat with a depth equal to 8 and a channel between 1 and 3 are
-  converted.
+  // 8 pixels u y0 y1 v y2 y3; 16 bytes are read for 12 used
+  VP_TARGET_SSSE3
+  inline void load411(const unsigned char *s, __m128i &y, __m128i &u, __m128i &v)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i *)s);
+    y = _mm_shuffle_epi8(x, _mm_setr_epi8(1, -1, 2, -1, 4, -1, 5, -1, 7, -1, 8, -1, 10, -1, 11, -1));
+    u = _mm_shuffle_epi8(x, _mm_setr_epi8(0, -1, 0, -1, 0, -1, 0, -1, 6, -1, 6, -1, 6, -1, 6, -1));
+    v = _mm_shuffle_epi8(x, _mm_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 9, -1, 9, -1, 9, -1, 9, -1));
+  }
 
-  \warning This function is only available if OpenCV (version 2.1.0 or greater)
-  was detected during the configuration step.
+  VP_TARGET_SSSE3
+  void yuv411ToRGBaSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 12 <= n; i += 8, s += 12, d += 32) {
+      __m128i y, u, v, r, g, b;
+      load411(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGBa(d, r, g, b, true);
+    }
+    yuv411ToRGBa(s, d, n - i);
+  }
 
-  \param src : Source image in OpenCV format.
-  \param dest : Destination image in ViSP format.
-  \param flip : Set to true to vertically flip the converted image.
+  VP_TARGET_SSSE3
+  void yuv411ToRGBSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 12 <= n; i += 8, s += 12, d += 24) {
+      __m128i y, u, v, r, g, b;
+      load411(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGBSSSE3(d, r, g, b);
+    }
+    yuv411ToRGB(s, d, n - i);
+  }
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
-#include <visp/vpRGBa.h>
+  VP_TARGET_SSSE3
+  void yuv411ToGreySSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const __m128i m = _mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1);
+    unsigned int i = 0;
+    for ( ; i + 12 <= n; i += 8, s += 12, d += 8)
+      _mm_storel_epi64((__m128i *)d, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)s), m));
+    yuv411ToGrey(s, d, n - i);
+  }
 
-int main()
-{
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
-  vpImage<vpRGBa> Ic; // A color image
-  cv::Mat Ip;
+  // 8 pixels u y v; 28 bytes are read for 24 used
+  VP_TARGET_SSSE3
+  inline void load444(const unsigned char *s, __m128i &y, __m128i &u, __m128i &v)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i *)s);
+    __m128i b = _mm_loadu_si128((const __m128i *)(s+12));
+    y = _mm_or_si128(_mm_shuffle_epi8(a, _mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                     _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 1, -1, 4, -1, 7, -1, 10, -1)));
+    u = _mm_or_si128(_mm_shuffle_epi8(a, _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                     _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, -1, 3, -1, 6, -1, 9, -1)));
+    v = _mm_or_si128(_mm_shuffle_epi8(a, _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                     _mm_shuffle_epi8(b, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 2, -1, 5, -1, 8, -1, 11, -1)));
+  }
 
-  // Read an image on a disk with openCV library
-  Ip = cv::imread("image.pgm", 1);// second parameter > 0 for a RGB encoding.
-  // Convert the grayscale cv::Mat into vpImage<vpRGBa>
-  vpImageConvert::convert(Ip, Ic);
+  VP_TARGET_SSSE3
+  void yuv444ToRGBaSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 10 <= n; i += 8, s += 24, d += 32) {
+      __m128i y, u, v, r, g, b;
+      load444(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGBa(d, r, g, b, false);
+    }
+    yuv444ToRGBa(s, d, n - i);
+  }
 
-  // ...
-#endif
-}
-  \endcode
-*/
-void
-vpImageConvert::convert(const cv::Mat& src,
-          vpImage<vpRGBa>& dest, const bool flip)
-{
-  if(src.type() == CV_8UC4){
-    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
-    vpRGBa rgbaVal;
-    for(unsigned int i=0; i<dest.getRows(); ++i)
-      for(unsigned int j=0; j<dest.getCols(); ++j){
-        cv::Vec4b tmp = src.at<cv::Vec4b>((int)i, (int)j);
-        rgbaVal.R = tmp[2];
-        rgbaVal.G = tmp[1];
-        rgbaVal.B = tmp[0];
-	rgbaVal.A = tmp[3];
-        if(flip)
-          dest[dest.getRows()-i-1][j] = rgbaVal;
-        else
-          dest[i][j] = rgbaVal;
-      }
-  }else if(src.type() == CV_8UC3){
-    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
-    vpRGBa rgbaVal;
-    rgbaVal.A = 0;
-    for(unsigned int i=0; i<dest.getRows(); ++i){
-      for(unsigned int j=0; j<dest.getCols(); ++j){
-        cv::Vec3b tmp = src.at<cv::Vec3b>((int)i, (int)j);
-        rgbaVal.R = tmp[2];
-        rgbaVal.G = tmp[1];
-        rgbaVal.B = tmp[0];
-        if(flip){
-          dest[dest.getRows()-i-1][j] = rgbaVal;
-        }else{
-          dest[i][j] = rgbaVal;
-        }
-      }
+  VP_TARGET_SSSE3
+  void yuv444ToRGBSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 10 <= n; i += 8, s += 24, d += 24) {
+      __m128i y, u, v, r, g, b;
+      load444(s, y, u, v);
+      vispRGB(y, u, v, r, g, b);
+      storeRGBSSSE3(d, r, g, b);
     }
-  }else if(src.type() == CV_8UC1){
-    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
-    vpRGBa rgbaVal;
-    for(unsigned int i=0; i<dest.getRows(); ++i){
-      for(unsigned int j=0; j<dest.getCols(); ++j){
-        rgbaVal = src.at<unsigned char>((int)i, (int)j);
-        if(flip){
-          dest[dest.getRows()-i-1][j] = rgbaVal;
-        }else{
-          dest[i][j] = rgbaVal;
-        }
-      }
+    yuv444ToRGB(s, d, n - i);
+  }
+
+  VP_TARGET_SSSE3
+  void yuv444ToGreySSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const __m128i ma = _mm_setr_epi8(1, 4, 7, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i mb = _mm_setr_epi8(-1, -1, -1, -1, 1, 4, 7, 10, -1, -1, -1, -1, -1, -1, -1, -1);
+    unsigned int i = 0;
+    for ( ; i + 10 <= n; i += 8, s += 24, d += 8) {
+      __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)s), ma);
+      __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s+12)), mb);
+      _mm_storel_epi64((__m128i *)d, _mm_or_si128(a, b));
     }
+    extractBytes<3, 1>(s, d, n - i);
   }
-}
 
-/*!
-  Convert a cv::Mat to a vpImage\<unsigned char\>
+  // 4 pixels of 3 bytes spread on 32 bits, the fourth byte is 0;
+  // 16 bytes are read for 12 used
+  VP_TARGET_SSSE3
+  inline __m128i loadRGBx(const unsigned char *s, bool swap)
+  {
+    const __m128i rgb = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i bgr = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)s), swap ? bgr : rgb);
+  }
 
-  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
-  the general OpenCV documentation, or
-  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
-  for the specific Mat structure documentation.
+  template<bool bgr>
+  VP_TARGET_SSSE3
+  void rgbToGreySSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 10 <= n; i += 8, s += 24, d += 8) {
+      __m128i g0 = greyOfRGBx(loadRGBx(s, false), bgr);
+      __m128i g1 = greyOfRGBx(loadRGBx(s + 12, false), bgr);
+      __m128i g = _mm_packs_epi32(g0, g1);
+      _mm_storel_epi64((__m128i *)d, _mm_packus_epi16(g, g));
+    }
+    if (bgr)
+      toGrey<3, 2, 0>(s, d, n - i);
+    else
+      toGrey<3, 0, 2>(s, d, n - i);
+  }
 
-  Similarily to the convert(const IplImage* src, vpImage<vpRGBa> & dest, bool flip)
-  method, only Mat with a depth equal to 8 and a channel between 1 and 3 are
-  converted.
+  template<bool bgr>
+  VP_TARGET_SSSE3
+  void rgbToRGBaSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 10 <= n; i += 8, s += 24, d += 32) {
+      _mm_storeu_si128((__m128i *)d, loadRGBx(s, bgr));
+      _mm_storeu_si128((__m128i *)(d+16), loadRGBx(s + 12, bgr));
+    }
+    if (bgr)
+      rgbToRGBa<2, 0>(s, d, n - i);
+    else
+      rgbToRGBa<0, 2>(s, d, n - i);
+  }
 
-  \warning This function is only available if OpenCV was detected during
-  the configuration step.
+  VP_TARGET_SSSE3
+  void rgbaToRGBSSSE3(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const __m128i m = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    unsigned int i = 0;
+    for ( ; i + 8 <= n; i += 8, s += 32, d += 24) {
+      __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)s), m);
+      __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s+16)), m);
+      _mm_storeu_si128((__m128i *)d, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+      _mm_storel_epi64((__m128i *)(d+16), _mm_srli_si128(p1, 4));
+    }
+    rgbaToRGB(s, d, n - i);
+  }
 
-  \param src : Source image in OpenCV format.
-  \param dest : Destination image in ViSP format.
-  \param flip : Set to true to vertically flip the converted image.
+  //
+  // AVX2 kernels, 16 pixels per iteration. The unpack and pack
+  // instructions work inside each 128 bits lane, so the lanes are
+  // reordered before the stores.
+  //
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
+  VP_TARGET_AVX2
+  inline __m256i truncMulAVX2(__m256i d, __m256i k)
+  {
+    __m256i s = _mm256_srai_epi16(d, 15);
+    __m256i a = _mm256_sub_epi16(_mm256_xor_si256(d, s), s);
+    __m256i p = _mm256_mulhi_epu16(a, k);
+    return _mm256_sub_epi16(_mm256_xor_si256(p, s), s);
+  }
 
-int main()
-{
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
-  vpImage<unsigned char> Ig; // A grayscale image
-  cv::Mat Ip;
+  VP_TARGET_AVX2
+  inline void vispRGBAVX2(__m256i y, __m256i u, __m256i v,
+                          __m256i &r, __m256i &g, __m256i &b)
+  {
+    const __m256i c128 = _mm256_set1_epi16(128);
+    __m256i U = truncMulAVX2(_mm256_sub_epi16(u, c128), _mm256_set1_epi16(23200));
+    __m256i V = truncMulAVX2(_mm256_sub_epi16(v, c128), _mm256_set1_epi16((short)46334));
+    r = _mm256_add_epi16(y, _mm256_add_epi16(V, V));
+    g = _mm256_sub_epi16(y, _mm256_add_epi16(U, V));
+    b = _mm256_add_epi16(y, _mm256_add_epi16(_mm256_slli_epi16(U, 2), U));
+  }
 
-  // Read an image on a disk with openCV library
-  Ip = cv::imread("image.pgm", 0);// second parameter = 0 for a gray level.
-  // Convert the grayscale cv::Mat into vpImage<unsigned char>
-  vpImageConvert::convert(Ip, Ig);
+  VP_TARGET_AVX2
+  inline __m256i dupEvenAVX2(__m256i x)
+  {
+    return _mm256_or_si256(_mm256_and_si256(x, _mm256_set1_epi32(0xFFFF)), _mm256_slli_epi32(x, 16));
+  }
 
-  // ...
-#endif
-}
+  VP_TARGET_AVX2
+  inline __m256i dupOddAVX2(__m256i x)
+  {
+    return _mm256_or_si256(_mm256_srli_epi32(x, 16), _mm256_andnot_si256(_mm256_set1_epi32(0xFFFF), x));
+  }
 
-  \endcode
-*/
-void
-vpImageConvert::convert(const cv::Mat& src,
-          vpImage<unsigned char>& dest, const bool flip)
-{
-  if(src.type() == CV_8UC1){
-    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
-    if(src.isContinuous() && !flip){
-      memcpy(dest.bitmap, src.data, (size_t)(src.rows*src.cols));
+  VP_TARGET_AVX2
+  inline void storeRGBaAVX2(unsigned char *d, __m256i r, __m256i g, __m256i b,
+                            bool keepAlpha)
+  {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i rb = _mm256_packus_epi16(r, b);
+    __m256i rg = _mm256_unpacklo_epi8(rb, _mm256_packus_epi16(g, zero));
+    __m256i b0 = _mm256_unpackhi_epi8(rb, zero);
+    __m256i lo = _mm256_unpacklo_epi16(rg, b0); // pixels 0-3 and 8-11
+    __m256i hi = _mm256_unpackhi_epi16(rg, b0); // pixels 4-7 and 12-15
+    __m256i p0 = _mm256_permute2x128_si256(lo, hi, 0x20);
+    __m256i p1 = _mm256_permute2x128_si256(lo, hi, 0x31);
+    if (keepAlpha) {
+      const __m256i a = _mm256_set1_epi32((int)0xFF000000);
+      p0 = _mm256_or_si256(p0, _mm256_and_si256(_mm256_loadu_si256((const __m256i *)d), a));
+      p1 = _mm256_or_si256(p1, _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(d+32)), a));
     }
-    else{
-      if(flip){
-        for(unsigned int i=0; i<dest.getRows(); ++i){
-          memcpy(dest.bitmap+i*dest.getCols(), src.data+(dest.getRows()-i-1)*src.step1(), (size_t)src.step);
-        }
-      }else{
-        for(unsigned int i=0; i<dest.getRows(); ++i){
-          memcpy(dest.bitmap+i*dest.getCols(), src.data+i*src.step1(), (size_t)src.step);
-        }
-      }
+    _mm256_storeu_si256((__m256i *)d, p0);
+    _mm256_storeu_si256((__m256i *)(d+32), p1);
+  }
+
+  VP_TARGET_AVX2
+  void uyvyToRGBaAVX2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 16 <= n; i += 16, s += 32, d += 64) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)s);
+      __m256i c = _mm256_and_si256(x, _mm256_set1_epi16(0xFF));
+      __m256i r, g, b;
+      vispRGBAVX2(_mm256_srli_epi16(x, 8), dupEvenAVX2(c), dupOddAVX2(c), r, g, b);
+      storeRGBaAVX2(d, r, g, b, true);
     }
-  }else if(src.type() == CV_8UC3){
-    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
-    if(src.isContinuous() && !flip){
-      BGRToGrey((unsigned char*)src.data, (unsigned char*)dest.bitmap, (unsigned int)src.cols, (unsigned int)src.rows, flip);
+    uyvyToRGBaSSE2(s, d, n - i);
+  }
+
+  VP_TARGET_AVX2
+  void yuyvToRGBaAVX2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 16 <= n; i += 16, s += 32, d += 64) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)s);
+      __m256i y = _mm256_and_si256(x, _mm256_set1_epi16(0xFF));
+      __m256i c = _mm256_sub_epi16(_mm256_srli_epi16(x, 8), _mm256_set1_epi16(128));
+      __m256i cbcr = _mm256_mulhi_epi16(_mm256_slli_epi16(c, 2),
+                                        _mm256_set1_epi32((22976 << 16) | 29056));
+      __m256i cg = _mm256_srai_epi32(_mm256_madd_epi16(c, _mm256_set1_epi32((183 << 16) | 88)), 8);
+      storeRGBaAVX2(d, _mm256_add_epi16(y, dupOddAVX2(cbcr)),
+                    _mm256_sub_epi16(y, dupEvenAVX2(cg)),
+                    _mm256_add_epi16(y, dupEvenAVX2(cbcr)), false);
     }
-    else{
-      if(flip){
-        for(unsigned int i=0; i<dest.getRows(); ++i){
-          BGRToGrey((unsigned char*)src.data+i*src.step1(),
-                    (unsigned char*)dest.bitmap+(dest.getRows()-i-1)*dest.getCols(),
-                    (unsigned int)src.step/3, 1, false);
-        }
-      }else{
-        for(unsigned int i=0; i<dest.getRows(); ++i){
-          BGRToGrey((unsigned char*)src.data+i*src.step1(),
-                    (unsigned char*)dest.bitmap+i*dest.getCols(),
-                    (unsigned int)src.step/3, 1, false);
+    yuyvToRGBaSSE2(s, d, n - i);
+  }
+
+  VP_TARGET_AVX2
+  void yuv420ToRGBaAVX2(const unsigned char *y, const unsigned char *u,
+                        const unsigned char *v, unsigned char *dst,
+                        unsigned int width, unsigned int npairs)
+  {
+    unsigned int w16 = width & ~15u;
+    for (unsigned int i = 0; i < npairs; i++) {
+      const unsigned char *ui = u + i*(width/2), *vi = v + i*(width/2);
+      for (unsigned int k = 0; k < 2; k++) {
+        const unsigned char *yr = y + (2*i+k)*width;
+        unsigned char *d = dst + (2*i+k)*width*4;
+        for (unsigned int j = 0; j < w16; j += 16) {
+          __m128i cu = _mm_loadl_epi64((const __m128i *)(ui + j/2));
+          __m128i cv = _mm_loadl_epi64((const __m128i *)(vi + j/2));
+          __m256i r, g, b;
+          vispRGBAVX2(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(yr + j))),
+                      _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(cu, cu)),
+                      _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(cv, cv)), r, g, b);
+          storeRGBaAVX2(d + 4*j, r, g, b, false);
         }
       }
     }
+    yuv420Rows<4>(y, u, v, dst, width, npairs, w16);
+  }
+
+  template<unsigned int offset>
+  VP_TARGET_AVX2
+  void extract2AVX2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const __m256i m = _mm256_set1_epi16(0xFF);
+    unsigned int i = 0;
+    for ( ; i + 32 <= n; i += 32, s += 64, d += 32) {
+      __m256i a = _mm256_loadu_si256((const __m256i *)s);
+      __m256i b = _mm256_loadu_si256((const __m256i *)(s+32));
+      if (offset) {
+        a = _mm256_srli_epi16(a, 8);
+        b = _mm256_srli_epi16(b, 8);
+      }
+      else {
+        a = _mm256_and_si256(a, m);
+        b = _mm256_and_si256(b, m);
+      }
+      __m256i p = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+      _mm256_storeu_si256((__m256i *)d, p);
+    }
+    extract2SSE2<offset>(s, d, n - i);
+  }
+
+  // Grey level of 4 pixels r g b x, 4 double precision values at once
+  VP_TARGET_AVX2
+  inline __m128i greyOfRGBxAVX2(__m128i x)
+  {
+    const __m128i m = _mm_set1_epi32(0xFF);
+    __m256d r = _mm256_cvtepi32_pd(_mm_and_si128(x, m));
+    __m256d g = _mm256_cvtepi32_pd(_mm_and_si128(_mm_srli_epi32(x, 8), m));
+    __m256d b = _mm256_cvtepi32_pd(_mm_and_si128(_mm_srli_epi32(x, 16), m));
+    __m256d v = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(0.2126), r),
+                                            _mm256_mul_pd(_mm256_set1_pd(0.7152), g)),
+                              _mm256_mul_pd(_mm256_set1_pd(0.0722), b));
+    return _mm256_cvttpd_epi32(v);
+  }
+
+  VP_TARGET_AVX2
+  void rgbaToGreyAVX2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int i = 0;
+    for ( ; i + 16 <= n; i += 16, s += 64, d += 16) {
+      __m128i g0 = greyOfRGBxAVX2(_mm_loadu_si128((const __m128i *)s));
+      __m128i g1 = greyOfRGBxAVX2(_mm_loadu_si128((const __m128i *)(s+16)));
+      __m128i g2 = greyOfRGBxAVX2(_mm_loadu_si128((const __m128i *)(s+32)));
+      __m128i g3 = greyOfRGBxAVX2(_mm_loadu_si128((const __m128i *)(s+48)));
+      _mm_storeu_si128((__m128i *)d, _mm_packus_epi16(_mm_packs_epi32(g0, g1),
+                                                      _mm_packs_epi32(g2, g3)));
+    }
+    rgbaToGreySSE2(s, d, n - i);
   }
+#endif // VP_CONVERT_DISPATCH
 }
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
+#ifdef VISP_HAVE_SSE2
+#  define VP_SSE2(kernel) kernel
+#else
+#  define VP_SSE2(kernel) NULL
+#endif
+#ifdef VP_CONVERT_DISPATCH
+#  define VP_SSSE3(kernel) kernel
+#  define VP_AVX2(kernel) kernel
+#else
+#  define VP_SSSE3(kernel) NULL
+#  define VP_AVX2(kernel) NULL
+#endif
 
 /*!
-  Convert a vpImage\<unsigned char\> to a cv::Mat
-
-  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
-  the general OpenCV documentation, or
-  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
-  for the specific Mat structure documentation.
+  Return the most recent instruction set supported by the processor
+  among the ones the conversions are optimized for.
 
-  \warning This function is only available if OpenCV version 2.1.0 or greater
-  was detected during the configuration step.
+  \sa getSimdType(), setSimdType()
+*/
+vpImageConvert::vpSimdType
+vpImageConvert::getSimdSupport()
+{
+  return detectSimd();
+}
 
-  \param src : source image (vpRGBa format)
-  \param dest : destination image (BGR format)
+/*!
+  Return the instruction set used by the conversions. Unless
+  setSimdType() was called, it is the one returned by getSimdSupport().
+*/
+vpImageConvert::vpSimdType
+vpImageConvert::getSimdType()
+{
+  if (vpConvertSimd < 0)
+    vpConvertSimd = (int)detectSimd();
+  return (vpSimdType)vpConvertSimd;
+}
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
+/*!
+  Select the instruction set used by the conversions. It is mainly
+  useful to compare the optimized conversions with the portable ones
+  (SIMD_NONE). All the instruction sets give the same results.
 
-int main()
+  \param type : Instruction set. If it is not supported by the
+  processor, the most recent supported one is used.
+*/
+void
+vpImageConvert::setSimdType(vpSimdType type)
 {
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
-  vpImage<unsigned char> Ig; // A greyscale image
-  cv::Mat Ip;
+  vpSimdType support = detectSimd();
+  vpConvertSimd = (int)((type > support) ? support : type);
+}
 
-  // Read an image on a disk
-  vpImageIo::readPGM(Ig, "image.pgm");
-  // Convert the vpImage<unsigned char> in to color cv::Mat.
-  vpImageConvert::convert(Ig, Ip);
-  // Treatments on cv::Mat Ip
-  //...
-  // Save the cv::Mat on the disk
-  cv::imwrite("image.pgm", Ip);
-#endif
-}
+/*!
+  Set the number of threads used to convert the large images (at least
+  256x256 pixels). This setting is only effective when ViSP is built
+  with OpenMP.
 
-  \endcode
+  \param n : Number of threads. 0 is considered as 1.
 */
 void
-vpImageConvert::convert(const vpImage<vpRGBa> & src,
-          cv::Mat& dest)
+vpImageConvert::setNumberOfThreads(unsigned int n)
 {
-  cv::Mat vpToMat((int)src.getRows(), (int)src.getCols(), CV_8UC4, (void*)src.bitmap);
+  vpConvertThreads = (n == 0) ? 1 : n;
+}
 
-  dest = cv::Mat((int)src.getRows(), (int)src.getCols(), CV_8UC3);
-  cv::Mat alpha((int)src.getRows(), (int)src.getCols(), CV_8UC1);
+/*!
+  Return the number of threads used to convert the large images.
 
-  cv::Mat out[] = {dest, alpha};
-  int from_to[] = { 0,2,  1,1,  2,0,  3,3 };
-  cv::mixChannels(&vpToMat, 1, out, 2, from_to, 4);
+  \sa setNumberOfThreads()
+*/
+unsigned int
+vpImageConvert::getNumberOfThreads()
+{
+  return vpConvertThreads;
 }
 
+
 /*!
-  Convert a vpImage\<unsigned char\> to a cv::Mat
+Convert a vpImage\<vpRGBa\> to a vpImage\<unsigned char\>
+\param src : source image
+\param dest : destination image
+*/
+void
+vpImageConvert::convert(const vpImage<unsigned char> &src,
+      vpImage<vpRGBa> & dest)
+{
+  dest.resize(src.getHeight(), src.getWidth()) ;
 
-  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
-  the general OpenCV documentation, or
-  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
-  for the specific Mat structure documentation.
+  if (src.isContiguous())
+    GreyToRGBa(src.bitmap, (unsigned char *)dest.bitmap,
+         src.getHeight() * src.getWidth() );
+  else // Row by row for a view
+    for (unsigned int i = 0; i < src.getHeight(); i++)
+      GreyToRGBa((unsigned char *)src[i], (unsigned char *)dest[i], src.getWidth());
+}
 
-  \warning This function is only available if OpenCV version 2.1.0 or greater
-  was detected during the configuration step.
+/*!
+Convert a vpImage\<unsigned char\> to a vpImage\<vpRGBa\>
+\param src : source image
+\param dest : destination image
+*/
+void
+vpImageConvert::convert(const vpImage<vpRGBa> &src,
+      vpImage<unsigned char> & dest)
+{
+  dest.resize(src.getHeight(), src.getWidth()) ;
 
-  \param src : source image
-  \param dest : destination image
-  \param copyData : if true, the image is copied and modification in one object
-  will not modified the other.
+  if (src.isContiguous())
+    RGBaToGrey((unsigned char *)src.bitmap, dest.bitmap,
+         src.getHeight() * src.getWidth() );
+  else // Row by row for a view
+    for (unsigned int i = 0; i < src.getHeight(); i++)
+      RGBaToGrey((unsigned char *)src[i], dest[i], src.getWidth());
+}
 
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
 
-int main()
+/*!
+Convert a vpImage\<float\> to a vpImage\<unsigend char\> by renormalizing between 0 and 255.
+\param src : source image
+\param dest : destination image
+*/
+void
+vpImageConvert::convert(const vpImage<float> &src,
+          vpImage<unsigned char> &dest)
 {
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
-  vpImage<unsigned char> Ig; // A greyscale image
-  cv::Mat Ip;
+  dest.resize(src.getHeight(), src.getWidth()) ;
+  float min, max;
 
-  // Read an image on a disk
-  vpImageIo::readPGM(Ig, "image.pgm");
-  // Convert the vpImage<unsigned char> in to greyscale cv::Mat
-  vpImageConvert::convert(Ig, Ip);
-  // Treatments on cv::MatIp
-  //...
-  // Save the cv::Mat on the disk
-  cv::imwrite("image.pgm", Ip);
-#endif
+  src.getMinMaxValue(min,max);
+  
+  for (unsigned int i = 0; i < src.getHeight(); i++) {
+    for (unsigned int j = 0; j < src.getWidth(); j++) {
+      float val = 255.f * (src[i][j] - min) / (max - min);
+      if(val < 0)
+        dest[i][j] = 0;
+      else if(val > 255)
+        dest[i][j] = 255;
+      else
+        dest[i][j] = (unsigned char)val;
+    }
+  }
 }
 
-  \endcode
+/*!
+Convert a vpImage\<unsigned char\> to a vpImage\<float\> by basic casting.
+\param src : source image
+\param dest : destination image
 */
 void
-vpImageConvert::convert(const vpImage<unsigned char> & src,
-          cv::Mat& dest, const bool copyData)
+vpImageConvert::convert(const vpImage<unsigned char> &src,
+          vpImage<float> &dest)
 {
-  if(copyData){
-    cv::Mat tmpMap((int)src.getRows(), (int)src.getCols(), CV_8UC1, (void*)src.bitmap);
-    dest = tmpMap.clone();
-  }else{
-    dest = cv::Mat((int)src.getRows(), (int)src.getCols(), CV_8UC1, (void*)src.bitmap);
+  dest.resize(src.getHeight(), src.getWidth()) ;
+  for (unsigned int i = 0; i < src.getHeight(); i++)
+    for (unsigned int j = 0; j < src.getWidth(); j++)
+      dest[i][j] = (float)src[i][j];
+}
+
+/*!
+Convert a vpImage\<double\> to a vpImage\<unsigend char\> by renormalizing between 0 and 255.
+\param src : source image
+\param dest : destination image
+*/
+void
+vpImageConvert::convert(const vpImage<double> &src,
+          vpImage<unsigned char> &dest)
+{
+  dest.resize(src.getHeight(), src.getWidth()) ;
+  double min, max;
+
+  src.getMinMaxValue(min,max);
+  
+  for (unsigned int i = 0; i < src.getHeight(); i++) {
+    for (unsigned int j = 0; j < src.getWidth(); j++) {
+      double val = 255. * (src[i][j] - min) / (max - min);
+      if(val < 0)
+        dest[i][j] = 0;
+      else if(val > 255)
+        dest[i][j] = 255;
+      else
+        dest[i][j] = (unsigned char)val;
+    }
   }
 }
 
-#endif
-#endif
+/*!
+Convert a vpImage\<unsigned char\> to a vpImage\<double\> by basic casting.
+\param src : source image
+\param dest : destination image
+*/
+void
+vpImageConvert::convert(const vpImage<unsigned char> &src,
+          vpImage<double> &dest)
+{
+  dest.resize(src.getHeight(), src.getWidth()) ;
+  for (unsigned int i = 0; i < src.getHeight(); i++)
+    for (unsigned int j = 0; j < src.getWidth(); j++)
+      dest[i][j] = (double)src[i][j];
+}
 
-#ifdef VISP_HAVE_YARP
+#ifdef VISP_HAVE_OPENCV
 /*!
-  Convert a vpImage\<unsigned char\> to a yarp::sig::ImageOf\<yarp::sig::PixelMono\>
+  Convert a IplImage to a vpImage\<vpRGBa\>
 
-  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
-  the YARP image class documentation.
+  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
+  image structure. See http://opencvlibrary.sourceforge.net/ for general
+  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
+  for the specific IplImage structure documentation.
 
-  \param src : Source image in ViSP format.
-  \param dest : Destination image in YARP format.
-  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+  \warning This function is only available if OpenCV was detected during
+  the configuration step.
+
+  \param src : Source image in OpenCV format.
+  \param dest : Destination image in ViSP format.
+  \param flip : Set to true to vertically flip the converted image.
 
   \code
 #include <visp/vpConfig.h>
@@ -842,41 +1397,104 @@ vpImageConvert::convert(const vpImage<unsigned char> & src,
 
 int main()
 {
-#if defined(VISP_HAVE_YARP)
-  vpImage<unsigned char> I; // A mocochrome image
-  // Read an image on a disk
-  vpImageIo::readPGM(I, "image.pgm");
-  
-  yarp::sig::ImageOf< yarp::sig::PixelMono > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelMono >();
-  // Convert the vpImage\<unsigned char\> to a yarp::sig::ImageOf\<yarp::sig::PixelMono\>
-  vpImageConvert::convert(I, Iyarp);
+#ifdef VISP_HAVE_OPENCV
+  vpImage<vpRGBa> Ic; // A color image
+  IplImage* Ip;
+
+  // Read an image on a disk with openCV library
+  Ip = cvLoadImage("image.ppm", CV_LOAD_IMAGE_COLOR);
+  // Convert the grayscale IplImage into vpImage<vpRGBa>
+  vpImageConvert::convert(Ip, Ic);
 
   // ...
+
+  // Release Ip header and data
+  cvReleaseImage(&Ip);
 #endif
 }
   \endcode
 */
-void vpImageConvert::convert(const vpImage<unsigned char> & src,
-	yarp::sig::ImageOf< yarp::sig::PixelMono > *dest, const bool copyData)
+void
+vpImageConvert::convert(const IplImage* src, vpImage<vpRGBa> & dest, bool flip)
 {
-  if(copyData)
-  {
-    dest->resize(src.getWidth(),src.getHeight());
-    memcpy(dest->getRawImage(), src.bitmap, src.getHeight()*src.getWidth());
+  int nChannel = src->nChannels;
+  int depth = src->depth;
+  int height = src->height;
+  int width = src->width;
+  int widthStep = src->widthStep;
+  int lineStep = (flip) ? 1 : 0;
+
+  if(nChannel == 3 && depth == 8){
+    dest.resize((unsigned int)height, (unsigned int)width);
+
+    //starting source address
+    unsigned char* input = (unsigned char*)src->imageData;
+    unsigned char* line;
+    unsigned char* beginOutput = (unsigned char*)dest.bitmap;
+    unsigned char* output = NULL;
+
+    for(int i=0 ; i < height ; i++)
+    {
+      line = input;
+      output = beginOutput + lineStep * ( 4 * width * ( height - 1 - i ) ) + (1-lineStep) * 4 * width * i;
+      for(int j=0 ; j < width ; j++)
+        {
+          *(output++) = *(line+2);
+          *(output++) = *(line+1);
+          *(output++) = *(line);
+          *(output++) = 0;
+
+          line+=3;
+        }
+      //go to the next line
+      input+=widthStep;
+    }
+  }
+  else if(nChannel == 1 && depth == 8 ){
+    dest.resize((unsigned int)height, (unsigned int)width);
+    //starting source address
+    unsigned char * input = (unsigned char*)src->imageData;
+    unsigned char * line;
+    unsigned char* beginOutput = (unsigned char*)dest.bitmap;
+    unsigned char* output = NULL;
+
+    for(int i=0 ; i < height ; i++)
+    {
+      line = input;
+      output = beginOutput + lineStep * ( 4 * width * ( height - 1 - i ) ) + (1-lineStep) * 4 * width * i;
+      for(int j=0 ; j < width ; j++)
+        {
+          *output++ = *(line);
+          *output++ = *(line);
+          *output++ = *(line);
+          *output++ = *(line);;
+
+          line++;
+        }
+      //go to the next line
+      input+=widthStep;
+    }
   }
-  else
-    dest->setExternal(src.bitmap, (int)src.getCols(), (int)src.getRows());
 }
 
 /*!
-  Convert a yarp::sig::ImageOf\<yarp::sig::PixelMono\> to a vpImage\<unsigned char\>
+  Convert a IplImage to a vpImage\<unsigned char\>
 
-  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
-  the YARP image class documentation.
+  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
+  image structure. See http://opencvlibrary.sourceforge.net/ for general
+  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
+  for the specific IplImage structure documentation.
 
-  \param src : Source image in YARP format.
+  \warning This function is only available if OpenCV was detected during
+  the configuration step.
+
+  \param src : Source image in OpenCV format.
   \param dest : Destination image in ViSP format.
-  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+  \param flip : Set to true to vertically flip the converted image.
+  \param copyData : If false and \e src is a grey level image that is not
+  flipped, \e dest becomes a view on the pixels of \e src (see
+  vpImage::initView()) and nothing is copied. \e src has then to outlive
+  \e dest.
 
   \code
 #include <visp/vpConfig.h>
@@ -884,180 +1502,269 @@ void vpImageConvert::convert(const vpImage<unsigned char> & src,
 #include <visp/vpImageIo.h>
 #include <visp/vpImageConvert.h>
 
-#if defined(VISP_HAVE_YARP)
-  #include <yarp/sig/ImageFile.h>
-#endif
-
 int main()
 {
-#if defined(VISP_HAVE_YARP)
-  yarp::sig::ImageOf< yarp::sig::PixelMono > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelMono >();
-  // Read an image on a disk
-  yarp::sig::file::read(*Iyarp, "image.pgm");
-  
-  // Convert the yarp::sig::ImageOf<yarp::sig::PixelMono> to a vpImage<unsigned char>
-  vpImage<unsigned char> I;
-  vpImageConvert::convert(Iyarp, I);
+#ifdef VISP_HAVE_OPENCV
+  vpImage<unsigned char> Ig; // A grayscale image
+  IplImage* Ip;
+
+  // Read an image on a disk with openCV library
+  Ip = cvLoadImage("image.pgm", CV_LOAD_IMAGE_GRAYSCALE);
+  // Convert the grayscale IplImage into vpImage<unsigned char>
+  vpImageConvert::convert(Ip, Ig);
 
   // ...
+
+  // Release Ip header and data
+  cvReleaseImage(&Ip);
 #endif
 }
   \endcode
 */
-void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelMono > *src,
-	vpImage<unsigned char> & dest,const bool copyData )
+void
+vpImageConvert::convert(const IplImage* src,
+      vpImage<unsigned char> &dest, bool flip, bool copyData)
 {
-  dest.resize(src->height(),src->width());
-  if(copyData)
-    memcpy(dest.bitmap, src->getRawImage(), src->height()*src->width()*sizeof(yarp::sig::PixelMono));
+  int nChannel = src->nChannels;
+  int depth = src->depth;
+  int height = src->height;
+  int width = src->width;
+  int widthStep = src->widthStep;
+  int lineStep = (flip) ? 1 : 0;
+
+  if (! copyData && ! flip && nChannel == 1 && depth == 8) {
+    dest.initView((unsigned char*)src->imageData, (unsigned int)height,
+                  (unsigned int)width, (unsigned int)widthStep);
+    return;
+  }
+
+  if (flip == false)
+  {
+    if(widthStep == width){
+      if(nChannel == 1 && depth == 8){
+        dest.resize((unsigned int)height, (unsigned int)width) ;
+        memcpy(dest.bitmap, src->imageData,
+                (size_t)(height*width));
+      }
+      if(nChannel == 3 && depth == 8){
+        dest.resize((unsigned int)height, (unsigned int)width) ;
+        BGRToGrey((unsigned char*)src->imageData,dest.bitmap, (unsigned int)width, (unsigned int)height,false);
+      }
+    }
+    else{
+      if(nChannel == 1 && depth == 8){
+        dest.resize((unsigned int)height, (unsigned int)width) ;
+        for (int i =0  ; i < height ; i++){
+          memcpy(dest.bitmap+i*width, src->imageData + i*widthStep,
+                (size_t)width);
+        }
+      }
+      if(nChannel == 3 && depth == 8){
+        dest.resize((unsigned int)height, (unsigned int)width) ;
+        for (int i = 0  ; i < height ; i++){
+          BGRToGrey((unsigned char*)src->imageData + i*widthStep,
+                      dest.bitmap + i*width, (unsigned int)width, 1, false);
+        }
+      }
+    }
+  }
   else
-    dest.bitmap = src->getRawImage();
+  {
+      if(nChannel == 1 && depth == 8){
+      unsigned char* beginOutput = (unsigned char*)dest.bitmap;
+        dest.resize((unsigned int)height, (unsigned int)width) ;
+        for (int i =0  ; i < height ; i++){
+          memcpy(beginOutput + lineStep * ( 4 * width * ( height - 1 - i ) ) , src->imageData + i*widthStep,
+                (size_t)width);
+        }
+      }
+      if(nChannel == 3 && depth == 8){
+        dest.resize((unsigned int)height, (unsigned int)width) ;
+        //for (int i = 0  ; i < height ; i++){
+          BGRToGrey((unsigned char*)src->imageData /*+ i*widthStep*/,
+                      dest.bitmap /*+ i*width*/, (unsigned int)width, (unsigned int)height/*1*/, true);
+        //}
+      }
+  }
 }
-	
+
 /*!
-  Convert a vpImage\<vpRGBa\> to a yarp::sig::ImageOf\<yarp::sig::PixelRgba>
+  Convert a vpImage\<vpRGBa\> to a IplImage
 
-  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
-  the YARP image class documentation.
+  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
+  image structure. See http://opencvlibrary.sourceforge.net/ for general
+  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
+  for the specific IplImage structure documentation.
 
-  \param src : Source image in ViSP format.
-  \param dest : Destination image in YARP format.
-  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+  \warning This function is only available if OpenCV was detected during
+  the configuration step.
+
+  \param src : source image
+  \param dest : destination image
 
   \code
 #include <visp/vpConfig.h>
 #include <visp/vpImage.h>
 #include <visp/vpImageIo.h>
 #include <visp/vpImageConvert.h>
-#include <visp/vpRGBa.h>
 
 int main()
 {
-#if defined(VISP_HAVE_YARP)
-  vpImage<vpRGBa> I; // A color image
+#ifdef VISP_HAVE_OPENCV
+  vpImage<vpRGBa> Ic; // A color image
+  IplImage* Ip = NULL;
+
   // Read an image on a disk
-  vpImageIo::read(I,"image.jpg");
-  
-  yarp::sig::ImageOf< yarp::sig::PixelRgba > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgba >();
-  // Convert the vpImage<vpRGBa> to a yarp::sig::ImageOf<yarp::sig::PixelRgba>
-  vpImageConvert::convert(I,Iyarp);
+  vpImageIo::readPPM(Ic, "image.ppm");
+  // Convert the vpImage<vpRGBa> in to color IplImage
+  vpImageConvert::convert(Ic, Ip);
+  // Treatments on IplImage
+  //...
+  // Save the IplImage on the disk
+  cvSaveImage("Ipl.ppm", Ip);
 
-  // ...
+  //Release Ip header and data
+  cvReleaseImage(&Ip);
 #endif
 }
   \endcode
-*/	
-void vpImageConvert::convert(const vpImage<vpRGBa> & src,
-	yarp::sig::ImageOf< yarp::sig::PixelRgba > *dest, const bool copyData)
+*/
+void
+vpImageConvert::convert(const vpImage<vpRGBa> & src, IplImage *&dest)
 {
-  if(copyData){
-    dest->resize(src.getWidth(),src.getHeight());
-    memcpy(dest->getRawImage(), src.bitmap, src.getHeight()*src.getWidth()*sizeof(vpRGBa));
+  int height = (int)src.getHeight();
+  int width  = (int)src.getWidth();
+  CvSize size = cvSize(width, height);
+  int depth = 8;
+  int channels = 3;
+  if (dest != NULL){
+    if(dest->nChannels != channels || dest->depth != depth
+       || dest->height != height || dest->width != width){
+      if(dest->nChannels != 0) cvReleaseImage(&dest);
+      dest = cvCreateImage( size, depth, channels );
+    }
   }
-  else
-    dest->setExternal(src.bitmap, (int)src.getCols(), (int)src.getRows());
-}
-
-/*!
-  Convert a yarp::sig::ImageOf\<yarp::sig::PixelRgba> to a vpImage\<vpRGBa\>
+  else dest = cvCreateImage( size, depth, channels );
 
-  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
-  the YARP image class documentation.
 
-  \param src : Source image in YARP format.
-  \param dest : Destination image in ViSP format.
-  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
-  
-  \code
-#include <visp/vpConfig.h>
-#include <visp/vpImage.h>
-#include <visp/vpImageIo.h>
-#include <visp/vpImageConvert.h>
-#include <visp/vpRGBa.h>
+  //starting source address
+  unsigned char * input = (unsigned char*)src.bitmap;//rgba image
+  unsigned char * line;
+  unsigned char * output = (unsigned char*)dest->imageData;//bgr image
 
-#if defined(VISP_HAVE_YARP)
-  #include <yarp/sig/ImageFile.h>
-#endif
+  int j=0;
+  int i=0;
+  int widthStep = dest->widthStep;
 
-int main()
-{
-#if defined(VISP_HAVE_YARP)
-  yarp::sig::ImageOf< yarp::sig::PixelRgba > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgba >();
-  // Read an image on a disk
-  yarp::sig::file::read(*Iyarp,"image.pgm");
-  
-  // Convert the yarp::sig::ImageOf<yarp::sig::PixelRgba> to a vpImage<vpRGBa>
-  vpImage<vpRGBa> I;
-  vpImageConvert::convert(Iyarp,I);
+  for(i=0 ; i < height ; i++)
+  {
+    output = (unsigned char*)dest->imageData + i*widthStep;
+    line = input;
+    for( j=0 ; j < width ; j++)
+      {
+        *output++ = *(line+2);  //B
+        *output++ = *(line+1);  //G
+        *output++ = *(line);  //R
 
-  // ...
-#endif
-}
-  \endcode
-*/
-void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgba > *src,
-	vpImage<vpRGBa> & dest,const bool copyData)
-{
-  dest.resize(src->height(),src->width());
-  if(copyData)
-    memcpy(dest.bitmap, src->getRawImage(),src->height()*src->width()*sizeof(yarp::sig::PixelRgba));
-  else
-    dest.bitmap = (vpRGBa*)src->getRawImage();
+        line+=4;
+      }
+    //go to the next line
+    input+=4*width;
+  }
 }
 
 /*!
-  Convert a vpImage\<vpRGBa\> to a yarp::sig::ImageOf\<yarp::sig::PixelRgb>
+  Convert a vpImage\<unsigned char\> to a IplImage
 
-  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
-  the YARP image class documentation.
+  An IplImage is an OpenCV (Intel's Open source Computer Vision Library)
+  image structure. See http://opencvlibrary.sourceforge.net/ for general
+  OpenCV documentation, or http://opencvlibrary.sourceforge.net/CxCore
+  for the specific IplImage structure documentation.
 
-  \param src : Source image in ViSP format.
-  \param dest : Destination image in YARP format.
+  \warning This function is only available if OpenCV was detected during
+  the configuration step.
+
+  \param src : source image
+  \param dest : destination image
 
   \code
 #include <visp/vpConfig.h>
 #include <visp/vpImage.h>
 #include <visp/vpImageIo.h>
 #include <visp/vpImageConvert.h>
-#include <visp/vpRGBa.h>
 
 int main()
 {
-#if defined(VISP_HAVE_YARP)
-  vpImage<vpRGBa> I; // A color image
+#ifdef VISP_HAVE_OPENCV
+  vpImage<unsigned char> Ig; // A greyscale image
+  IplImage* Ip = NULL;
+
   // Read an image on a disk
-  vpImageIo::read(I,"image.jpg");
-  
-  yarp::sig::ImageOf< yarp::sig::PixelRgb > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgb >();
-  // Convert the vpImage<vpRGBa> to a yarp::sig::ImageOf<yarp::sig::PixelRgb>
-  vpImageConvert::convert(I,Iyarp);
+  vpImageIo::readPGM(Ig, "image.pgm");
+  // Convert the vpImage<unsigned char> in to greyscale IplImage
+  vpImageConvert::convert(Ig, Ip);
+  // Treatments on IplImage Ip
+  //...
+  // Save the IplImage on the disk
+  cvSaveImage("Ipl.pgm", Ip);
 
-  // ...
+  //Release Ip header and data
+  cvReleaseImage(&Ip);
 #endif
 }
   \endcode
 */
-void vpImageConvert::convert(const vpImage<vpRGBa> & src,
-	yarp::sig::ImageOf< yarp::sig::PixelRgb > *dest)
+void
+vpImageConvert::convert(const vpImage<unsigned char> & src,
+      IplImage* &dest)
 {
-  dest->resize(src.getWidth(),src.getHeight());
-  for(unsigned int i = 0 ; i < src.getRows() ; i++){
-    for(unsigned int j = 0 ; j < src.getWidth() ; j++){
-	dest->pixel(j,i).r = src[i][j].R;
-	dest->pixel(j,i).g = src[i][j].G;
-	dest->pixel(j,i).b = src[i][j].B;
-    }
-  }
-}
+  unsigned int height = src.getHeight();
+  unsigned int width  = src.getWidth();
+  CvSize size = cvSize((int)width, (int)height);
+  int depth = 8;
+  int channels = 1;
+  if (dest != NULL){
+    if(dest->nChannels != channels || dest->depth != depth
+       || dest->height != (int) height || dest->width != (int) width){
+      if(dest->nChannels != 0) cvReleaseImage(&dest);
+      dest = cvCreateImage( size, depth, channels );
+    }
+  }
+  else dest = cvCreateImage( size, depth, channels );
+
+  unsigned int widthStep = (unsigned int)dest->widthStep;
+
+  if ( width == widthStep && src.isContiguous()){
+    memcpy(dest->imageData,src.bitmap, width*height);
+  }
+  else{
+    //copying each line taking account of the widthStep
+    for (unsigned int i =0  ; i < height ; i++){
+          memcpy(dest->imageData + i*widthStep, src[i],
+                width);
+    }
+  }
+}
 
+#if VISP_HAVE_OPENCV_VERSION >= 0x020100
 /*!
-  Convert a yarp::sig::ImageOf\<yarp::sig::PixelRgb> to a vpImage\<vpRGBa\>
+  Convert a cv::Mat to a vpImage\<vpRGBa\>
 
-  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
-  the YARP image class documentation.
+  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
+  the general OpenCV documentation, or
+  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
+  for the specific Mat structure documentation.
 
-  \param src : Source image in YARP format.
+  Similarily to the convert(const IplImage* src, vpImage<vpRGBa> & dest, bool flip)
+  method, only Mat with a depth equal to 8 and a channel between 1 and 3 are
+  converted.
+
+  \warning This function is only available if OpenCV (version 2.1.0 or greater)
+  was detected during the configuration step.
+
+  \param src : Source image in OpenCV format.
   \param dest : Destination image in ViSP format.
+  \param flip : Set to true to vertically flip the converted image.
 
   \code
 #include <visp/vpConfig.h>
@@ -1066,1252 +1773,929 @@ void vpImageConvert::convert(const vpImage<vpRGBa> & src,
 #include <visp/vpImageConvert.h>
 #include <visp/vpRGBa.h>
 
-#if defined(VISP_HAVE_YARP)
-  #include <yarp/sig/ImageFile.h>
-#endif
-
 int main()
 {
-#if defined(VISP_HAVE_YARP)
-  yarp::sig::ImageOf< yarp::sig::PixelRgb > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgb >();
-  // Read an image on a disk
-  yarp::sig::file::read(*Iyarp,"image.pgm");
-  
-  // Convert the yarp::sig::ImageOf<yarp::sig::PixelRgb> to a vpImage<vpRGBa>
-  vpImage<vpRGBa> I;
-  vpImageConvert::convert(Iyarp,I);
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+  vpImage<vpRGBa> Ic; // A color image
+  cv::Mat Ip;
+
+  // Read an image on a disk with openCV library
+  Ip = cv::imread("image.pgm", 1);// second parameter > 0 for a RGB encoding.
+  // Convert the grayscale cv::Mat into vpImage<vpRGBa>
+  vpImageConvert::convert(Ip, Ic);
 
   // ...
 #endif
 }
   \endcode
 */
-void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgb > *src,
-	vpImage<vpRGBa> & dest)
+void
+vpImageConvert::convert(const cv::Mat& src,
+          vpImage<vpRGBa>& dest, const bool flip)
 {
-  dest.resize(src->height(),src->width());
-  for(int i = 0 ; i < src->height() ; i++){
-    for(int j = 0 ; j < src->width() ; j++){
-	dest[i][j].R = src->pixel(j,i).r;
-	dest[i][j].G = src->pixel(j,i).g;
-	dest[i][j].B = src->pixel(j,i).b;
-	dest[i][j].A = 0;
+  if(src.type() == CV_8UC4){
+    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
+    vpRGBa rgbaVal;
+    for(unsigned int i=0; i<dest.getRows(); ++i)
+      for(unsigned int j=0; j<dest.getCols(); ++j){
+        cv::Vec4b tmp = src.at<cv::Vec4b>((int)i, (int)j);
+        rgbaVal.R = tmp[2];
+        rgbaVal.G = tmp[1];
+        rgbaVal.B = tmp[0];
+	rgbaVal.A = tmp[3];
+        if(flip)
+          dest[dest.getRows()-i-1][j] = rgbaVal;
+        else
+          dest[i][j] = rgbaVal;
+      }
+  }else if(src.type() == CV_8UC3){
+    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
+    vpRGBa rgbaVal;
+    rgbaVal.A = 0;
+    for(unsigned int i=0; i<dest.getRows(); ++i){
+      for(unsigned int j=0; j<dest.getCols(); ++j){
+        cv::Vec3b tmp = src.at<cv::Vec3b>((int)i, (int)j);
+        rgbaVal.R = tmp[2];
+        rgbaVal.G = tmp[1];
+        rgbaVal.B = tmp[0];
+        if(flip){
+          dest[dest.getRows()-i-1][j] = rgbaVal;
+        }else{
+          dest[i][j] = rgbaVal;
+        }
+      }
+    }
+  }else if(src.type() == CV_8UC1){
+    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
+    vpRGBa rgbaVal;
+    for(unsigned int i=0; i<dest.getRows(); ++i){
+      for(unsigned int j=0; j<dest.getCols(); ++j){
+        rgbaVal = src.at<unsigned char>((int)i, (int)j);
+        if(flip){
+          dest[dest.getRows()-i-1][j] = rgbaVal;
+        }else{
+          dest[i][j] = rgbaVal;
+        }
+      }
     }
   }
 }
 
-#endif
-
-#if defined(VISP_HAVE_LIBJPEG)
-#if JPEG_LIB_VERSION > 70
 /*!
-  Convert a vpImage\<unsigned char> to a JPEG compressed buffer
+  Convert a cv::Mat to a vpImage\<unsigned char\>
 
-  \param src : Source image in ViSP format.
-  \param dest : Destination buffer in JPEG format.
-  \param destSize : Size of the destination buffer.
-  \param quality : purcentage of the quality of the compressed image.
-*/
-void vpImageConvert::convertToJPEGBuffer(const vpImage<unsigned char> &src, 
-                                  unsigned char **dest, long unsigned int &destSize, unsigned int quality)
-{
-  struct jpeg_compress_struct cinfo;
-  struct jpeg_error_mgr jerr;
+  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
+  the general OpenCV documentation, or
+  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
+  for the specific Mat structure documentation.
 
-  cinfo.err = jpeg_std_error(&jerr);
-  jpeg_create_compress(&cinfo);
-  
-  *dest = NULL;
-  destSize = 0;
-  
-  jpeg_mem_dest(&cinfo, dest, &destSize);
+  Similarily to the convert(const IplImage* src, vpImage<vpRGBa> & dest, bool flip)
+  method, only Mat with a depth equal to 8 and a channel between 1 and 3 are
+  converted.
 
-  unsigned int width = src.getWidth();
-  unsigned int height = src.getHeight();
+  \warning This function is only available if OpenCV was detected during
+  the configuration step.
 
-  cinfo.image_width = width;
-  cinfo.image_height = height;
-  cinfo.input_components = 1;
-  cinfo.in_color_space = JCS_GRAYSCALE;
-  jpeg_set_defaults(&cinfo);
-  jpeg_set_quality(&cinfo, quality, TRUE);
+  \param src : Source image in OpenCV format.
+  \param dest : Destination image in ViSP format.
+  \param flip : Set to true to vertically flip the converted image.
+  \param copyData : If false and \e src is a CV_8UC1 image that is not
+  flipped, \e dest becomes a view on the pixels of \e src (see
+  vpImage::initView()) and nothing is copied. \e src has then to outlive
+  \e dest.
 
-  jpeg_start_compress(&cinfo,TRUE);
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
 
-  unsigned char *line;
-  line = new unsigned char[width];
-  unsigned char* input = (unsigned char*)src.bitmap;
-  while (cinfo.next_scanline < cinfo.image_height)
-  {
-    for (unsigned int i = 0; i < width; i++)
-    {
-      line[i] = *(input);
-    input++;
-    }
-  jpeg_write_scanlines(&cinfo, &line, 1);
-  }
+int main()
+{
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+  vpImage<unsigned char> Ig; // A grayscale image
+  cv::Mat Ip;
 
-  jpeg_finish_compress(&cinfo);
-  jpeg_destroy_compress(&cinfo);
-  delete [] line;
+  // Read an image on a disk with openCV library
+  Ip = cv::imread("image.pgm", 0);// second parameter = 0 for a gray level.
+  // Convert the grayscale cv::Mat into vpImage<unsigned char>
+  vpImageConvert::convert(Ip, Ig);
+
+  // ...
+#endif
 }
-  
-/*!
-  Decompress a JPEG buffer in a vpImage\<unsigned char>
 
-  \param src : Source buffer in JPEG format.
-  \param srcSize : Size of the source buffer.
-  \param dest : Destination image in ViSP format.
+  \endcode
 */
-void vpImageConvert::convertToJPEGBuffer(unsigned char *src, long unsigned int srcSize, 
-                                  vpImage<unsigned char> &dest)
+void
+vpImageConvert::convert(const cv::Mat& src,
+          vpImage<unsigned char>& dest, const bool flip, const bool copyData)
 {
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
+  if(src.type() == CV_8UC1 && !copyData && !flip){
+    dest.initView((unsigned char*)src.data, (unsigned int)src.rows,
+                  (unsigned int)src.cols, (unsigned int)src.step[0]);
+    return;
+  }
+  if(src.type() == CV_8UC1){
+    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
+    if(src.isContinuous() && !flip){
+      memcpy(dest.bitmap, src.data, (size_t)(src.rows*src.cols));
+    }
+    else{
+      if(flip){
+        for(unsigned int i=0; i<dest.getRows(); ++i){
+          memcpy(dest.bitmap+i*dest.getCols(), src.data+(dest.getRows()-i-1)*src.step1(), (size_t)src.step);
+        }
+      }else{
+        for(unsigned int i=0; i<dest.getRows(); ++i){
+          memcpy(dest.bitmap+i*dest.getCols(), src.data+i*src.step1(), (size_t)src.step);
+        }
+      }
+    }
+  }else if(src.type() == CV_8UC3){
+    dest.resize((unsigned int)src.rows, (unsigned int)src.cols);
+    if(src.isContinuous() && !flip){
+      BGRToGrey((unsigned char*)src.data, (unsigned char*)dest.bitmap, (unsigned int)src.cols, (unsigned int)src.rows, flip);
+    }
+    else{
+      if(flip){
+        for(unsigned int i=0; i<dest.getRows(); ++i){
+          BGRToGrey((unsigned char*)src.data+i*src.step1(),
+                    (unsigned char*)dest.bitmap+(dest.getRows()-i-1)*dest.getCols(),
+                    (unsigned int)src.step/3, 1, false);
+        }
+      }else{
+        for(unsigned int i=0; i<dest.getRows(); ++i){
+          BGRToGrey((unsigned char*)src.data+i*src.step1(),
+                    (unsigned char*)dest.bitmap+i*dest.getCols(),
+                    (unsigned int)src.step/3, 1, false);
+        }
+      }
+    }
+  }
+}
 
-  cinfo.err = jpeg_std_error(&jerr);
-  jpeg_create_decompress(&cinfo);
 
-  jpeg_mem_src(&cinfo, src, srcSize);
-  jpeg_read_header(&cinfo, TRUE);
+/*!
+  Convert a vpImage\<unsigned char\> to a cv::Mat
 
-  unsigned int width = cinfo.image_width;
-  unsigned int height = cinfo.image_height;
+  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
+  the general OpenCV documentation, or
+  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
+  for the specific Mat structure documentation.
 
-  if ( (width != dest.getWidth()) || (height != dest.getHeight()) )
-    dest.resize(height,width);
+  \warning This function is only available if OpenCV version 2.1.0 or greater
+  was detected during the configuration step.
 
-  jpeg_start_decompress(&cinfo);
+  \param src : source image (vpRGBa format)
+  \param dest : destination image (BGR format)
 
-  unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
-  JSAMPARRAY buf = (*cinfo.mem->alloc_sarray) ((j_common_ptr) &cinfo, JPOOL_IMAGE, rowbytes, 1);
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
 
-  if (cinfo.out_color_space == JCS_GRAYSCALE)
-  {
-    unsigned int row;
-    while (cinfo.output_scanline<cinfo.output_height)
-    {
-      row = cinfo.output_scanline;
-      jpeg_read_scanlines(&cinfo,buf,1);
-      memcpy(dest[row], buf[0], rowbytes);
-    }
-  }
+int main()
+{
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+  vpImage<unsigned char> Ig; // A greyscale image
+  cv::Mat Ip;
 
-  jpeg_finish_decompress(&cinfo);
-  jpeg_destroy_decompress(&cinfo);
-}
+  // Read an image on a disk
+  vpImageIo::readPGM(Ig, "image.pgm");
+  // Convert the vpImage<unsigned char> in to color cv::Mat.
+  vpImageConvert::convert(Ig, Ip);
+  // Treatments on cv::Mat Ip
+  //...
+  // Save the cv::Mat on the disk
+  cv::imwrite("image.pgm", Ip);
 #endif
-#endif // defined(VISP_HAVE_LIBJPEG)
-
-
-#define vpSAT(c) \
-        if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
-/*!
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
-  Destination rgba memory area has to be allocated before.
+}
 
-  \sa YUV422ToRGBa()
+  \endcode
 */
-void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-        unsigned int width, unsigned int height)
+void
+vpImageConvert::convert(const vpImage<vpRGBa> & src,
+          cv::Mat& dest)
 {
-  unsigned char *s;
-  unsigned char *d;
-  int w, h, c;
-  int r, g, b, cr, cg, cb, y1, y2;
-
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgba;
-  while (h--) {
-    c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
-
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = 0;
-
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
+  cv::Mat vpToMat((int)src.getRows(), (int)src.getCols(), CV_8UC4, (void*)src.bitmap);
 
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = 0;
+  dest = cv::Mat((int)src.getRows(), (int)src.getCols(), CV_8UC3);
+  cv::Mat alpha((int)src.getRows(), (int)src.getCols(), CV_8UC1);
 
-    }
-  }
+  cv::Mat out[] = {dest, alpha};
+  int from_to[] = { 0,2,  1,1,  2,0,  3,3 };
+  cv::mixChannels(&vpToMat, 1, out, 2, from_to, 4);
 }
-/*!
 
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
-  to RGB24. Destination rgb memory area has to be allocated before.
+/*!
+  Convert a vpImage\<unsigned char\> to a cv::Mat
 
-  \sa YUV422ToRGB()
-*/
-void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
-             unsigned int width, unsigned int height)
-{
-  unsigned char *s;
-  unsigned char *d;
-  int h, w, c;
-  int r, g, b, cr, cg, cb, y1, y2;
+  A cv::Mat is an OpenCV image class. See http://opencv.willowgarage.com for
+  the general OpenCV documentation, or
+  http://opencv.willowgarage.com/documentation/cpp/core_basic_structures.html
+  for the specific Mat structure documentation.
 
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgb;
-  while (h--) {
-    c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
+  \warning This function is only available if OpenCV version 2.1.0 or greater
+  was detected during the configuration step.
 
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
+  \param src : source image
+  \param dest : destination image
+  \param copyData : if true, the image is copied and modification in one object
+  will not modified the other.
 
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
 
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
+int main()
+{
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+  vpImage<unsigned char> Ig; // A greyscale image
+  cv::Mat Ip;
 
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-    }
-  }
+  // Read an image on a disk
+  vpImageIo::readPGM(Ig, "image.pgm");
+  // Convert the vpImage<unsigned char> in to greyscale cv::Mat
+  vpImageConvert::convert(Ig, Ip);
+  // Treatments on cv::MatIp
+  //...
+  // Save the cv::Mat on the disk
+  cv::imwrite("image.pgm", Ip);
+#endif
 }
-/*!
-
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
-  to grey. Destination rgb memory area has to be allocated before.
 
-  \sa YUV422ToGrey()
+  \endcode
 */
-void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey,
-        unsigned int size)
+void
+vpImageConvert::convert(const vpImage<unsigned char> & src,
+          cv::Mat& dest, const bool copyData)
 {
-  unsigned int i=0,j=0;
-
-  while( j < size*2)
-    {
-      grey[i++] = yuyv[j];
-      grey[i++] = yuyv[j+2];
-      j+=4;
-    }
+  // The step allows to wrap a view of another image
+  if(copyData){
+    cv::Mat tmpMap((int)src.getRows(), (int)src.getCols(), CV_8UC1, (void*)src.bitmap,
+                   (size_t)src.getStride());
+    dest = tmpMap.clone();
+  }else{
+    dest = cv::Mat((int)src.getRows(), (int)src.getCols(), CV_8UC1, (void*)src.bitmap,
+                   (size_t)src.getStride());
+  }
 }
 
+#endif
+#endif
 
+#ifdef VISP_HAVE_YARP
 /*!
+  Convert a vpImage\<unsigned char\> to a yarp::sig::ImageOf\<yarp::sig::PixelMono\>
 
-Convert YUV411 into RGB32
-yuv411 : u y1 y2 v y3 y4
+  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
+  the YARP image class documentation.
+
+  \param src : Source image in ViSP format.
+  \param dest : Destination image in YARP format.
+  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
+
+int main()
+{
+#if defined(VISP_HAVE_YARP)
+  vpImage<unsigned char> I; // A mocochrome image
+  // Read an image on a disk
+  vpImageIo::readPGM(I, "image.pgm");
+  
+  yarp::sig::ImageOf< yarp::sig::PixelMono > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelMono >();
+  // Convert the vpImage\<unsigned char\> to a yarp::sig::ImageOf\<yarp::sig::PixelMono\>
+  vpImageConvert::convert(I, Iyarp);
 
+  // ...
+#endif
+}
+  \endcode
 */
-void vpImageConvert::YUV411ToRGBa(unsigned char* yuv,
-          unsigned char* rgba,
-          unsigned int size)
+void vpImageConvert::convert(const vpImage<unsigned char> & src,
+	yarp::sig::ImageOf< yarp::sig::PixelMono > *dest, const bool copyData)
 {
-#if 1
-  //  std::cout << "call optimized ConvertYUV411ToRGBa()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1, Y2, Y3;
-  for(unsigned int i = size / 4; i; i--) {
-    U   = (int)((*yuv++ - 128) * 0.354);
-    U5  = 5*U;
-    Y0  = *yuv++;
-    Y1  = *yuv++;
-    V   = (int)((*yuv++ - 128) * 0.707);
-    V2  = 2*V;
-    Y2  = *yuv++;
-    Y3  = *yuv++;
-    UV  = - U - V;
+  if(copyData)
+  {
+    dest->resize(src.getWidth(),src.getHeight());
+    memcpy(dest->getRawImage(), src.bitmap, src.getHeight()*src.getWidth());
+  }
+  else
+    dest->setExternal(src.bitmap, (int)src.getCols(), (int)src.getRows());
+}
 
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+/*!
+  Convert a yarp::sig::ImageOf\<yarp::sig::PixelMono\> to a vpImage\<unsigned char\>
 
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
+  the YARP image class documentation.
 
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  \param src : Source image in YARP format.
+  \param dest : Destination image in ViSP format.
+  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+#if defined(VISP_HAVE_YARP)
+  #include <yarp/sig/ImageFile.h>
+#endif
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+int main()
+{
+#if defined(VISP_HAVE_YARP)
+  yarp::sig::ImageOf< yarp::sig::PixelMono > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelMono >();
+  // Read an image on a disk
+  yarp::sig::file::read(*Iyarp, "image.pgm");
+  
+  // Convert the yarp::sig::ImageOf<yarp::sig::PixelMono> to a vpImage<unsigned char>
+  vpImage<unsigned char> I;
+  vpImageConvert::convert(Iyarp, I);
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  // ...
+#endif
+}
+  \endcode
+*/
+void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelMono > *src,
+	vpImage<unsigned char> & dest,const bool copyData )
+{
+  if(copyData) {
+    dest.resize(src->height(),src->width());
+    memcpy(dest.bitmap, src->getRawImage(), src->height()*src->width()*sizeof(yarp::sig::PixelMono));
+  }
+  else
+    dest.initView(src->getRawImage(), src->height(), src->width(),
+                  src->getRowSize() / sizeof(yarp::sig::PixelMono));
+}
+	
+/*!
+  Convert a vpImage\<vpRGBa\> to a yarp::sig::ImageOf\<yarp::sig::PixelRgba>
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
+  the YARP image class documentation.
 
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  \param src : Source image in ViSP format.
+  \param dest : Destination image in YARP format.
+  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
 
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpRGBa.h>
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+int main()
+{
+#if defined(VISP_HAVE_YARP)
+  vpImage<vpRGBa> I; // A color image
+  // Read an image on a disk
+  vpImageIo::read(I,"image.jpg");
+  
+  yarp::sig::ImageOf< yarp::sig::PixelRgba > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgba >();
+  // Convert the vpImage<vpRGBa> to a yarp::sig::ImageOf<yarp::sig::PixelRgba>
+  vpImageConvert::convert(I,Iyarp);
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
-  }
-#else
-  // tres tres lent ....
-  unsigned int i=0,j=0;
-  unsigned char r, g, b;
-  while( j < numpixels*3/2)
-  {
-
-    YUVToRGB (yuv[j+1], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
-
-    YUVToRGB (yuv[j+2], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
-
-    YUVToRGB (yuv[j+4], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
-
-    YUVToRGB (yuv[j+5], yuv[j], yuv[j+3], r, g, b);
-    rgba[i]   = r;
-    rgba[i+1] = g;
-    rgba[i+2] = b;
-    rgba[i+3] = 0;
-    i+=4;
-
-    j+=6;
-  }
+  // ...
 #endif
-
 }
-
-/*!
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB32 images.
-  Destination rgba memory area has to be allocated before.
-
-  \sa YUYVToRGBa()
-*/
-void vpImageConvert::YUV422ToRGBa(unsigned char* yuv,
-          unsigned char* rgba,
-          unsigned int size)
+  \endcode
+*/	
+void vpImageConvert::convert(const vpImage<vpRGBa> & src,
+	yarp::sig::ImageOf< yarp::sig::PixelRgba > *dest, const bool copyData)
 {
+  if(copyData){
+    dest->resize(src.getWidth(),src.getHeight());
+    memcpy(dest->getRawImage(), src.bitmap, src.getHeight()*src.getWidth()*sizeof(vpRGBa));
+  }
+  else
+    dest->setExternal(src.bitmap, (int)src.getCols(), (int)src.getRows());
+}
 
-#if 1
-  //  std::cout << "call optimized convertYUV422ToRGBa()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1;
-  for( unsigned int i = size / 2; i; i-- ) {
-    U   = (int)((*yuv++ - 128) * 0.354);
-    U5  = 5*U;
-    Y0  = *yuv++;
-    V   = (int)((*yuv++ - 128) * 0.707);
-    V2  = 2*V;
-    Y1  = *yuv++;
-    UV  = - U - V;
-
-    //---
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
+/*!
+  Convert a yarp::sig::ImageOf\<yarp::sig::PixelRgba> to a vpImage\<vpRGBa\>
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
+  the YARP image class documentation.
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  \param src : Source image in YARP format.
+  \param dest : Destination image in ViSP format.
+  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+  
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpRGBa.h>
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+#if defined(VISP_HAVE_YARP)
+  #include <yarp/sig/ImageFile.h>
+#endif
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    rgba++;
-  }
+int main()
+{
+#if defined(VISP_HAVE_YARP)
+  yarp::sig::ImageOf< yarp::sig::PixelRgba > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgba >();
+  // Read an image on a disk
+  yarp::sig::file::read(*Iyarp,"image.pgm");
+  
+  // Convert the yarp::sig::ImageOf<yarp::sig::PixelRgba> to a vpImage<vpRGBa>
+  vpImage<vpRGBa> I;
+  vpImageConvert::convert(Iyarp,I);
 
-#else
-  // tres tres lent ....
- unsigned int i=0,j=0;
- unsigned char r, g, b;
-
- while( j < size*2)
- {
-
-   YUVToRGB (yuv[j+1], yuv[j], yuv[j+2], r, g, b);
-   rgba[i]   = r;
-   rgba[i+1] = g;
-   rgba[i+2] = b;
-   rgba[i+3] = 0;
-   i+=4;
-
-   YUVToRGB (yuv[j+3], yuv[j], yuv[j+2], r, g, b);
-   rgba[i]   = r;
-   rgba[i+1] = g;
-   rgba[i+2] = b;
-   rgba[i+3] = 0;
-   i+=4;
-   j+=4;
-
- }
+  // ...
 #endif
 }
-
-/*!
-
-Convert YUV411 into Grey
-yuv411 : u y1 y2 v y3 y4
-
+  \endcode
 */
-void vpImageConvert::YUV411ToGrey(unsigned char* yuv,
-          unsigned char* grey,
-          unsigned int size)
+void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgba > *src,
+	vpImage<vpRGBa> & dest,const bool copyData)
 {
-
-
-  unsigned int i=0,j=0;
-  while( j < size*3/2)
-  {
-
-    grey[i  ] = yuv[j+1];
-    grey[i+1] = yuv[j+2];
-    grey[i+2] = yuv[j+4];
-    grey[i+3] = yuv[j+5];
-
-    i+=4;
-
-    j+=6;
+  if(copyData) {
+    dest.resize(src->height(),src->width());
+    memcpy(dest.bitmap, src->getRawImage(),src->height()*src->width()*sizeof(yarp::sig::PixelRgba));
   }
+  else
+    dest.initView((vpRGBa*)src->getRawImage(), src->height(), src->width(),
+                  src->getRowSize() / sizeof(yarp::sig::PixelRgba));
 }
 
 /*!
+  Convert a vpImage\<vpRGBa\> to a yarp::sig::ImageOf\<yarp::sig::PixelRgb>
 
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB images.
-  Destination rgb memory area has to be allocated before.
-
-  \sa YUYVToRGB()
-
-*/
-void vpImageConvert::YUV422ToRGB(unsigned char* yuv,
-         unsigned char* rgb,
-         unsigned int size)
-{
-#if 1
-  //  std::cout << "call optimized convertYUV422ToRGB()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1;
-  for( unsigned int i = size / 2; i; i-- ) {
-    U   = (int)((*yuv++ - 128) * 0.354);
-    U5  = 5*U;
-    Y0  = *yuv++;
-    V   = (int)((*yuv++ - 128) * 0.707);
-    V2  = 2*V;
-    Y1  = *yuv++;
-    UV  = - U - V;
-
-    //---
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
+  the YARP image class documentation.
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  \param src : Source image in ViSP format.
+  \param dest : Destination image in YARP format.
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpRGBa.h>
 
-  }
+int main()
+{
+#if defined(VISP_HAVE_YARP)
+  vpImage<vpRGBa> I; // A color image
+  // Read an image on a disk
+  vpImageIo::read(I,"image.jpg");
+  
+  yarp::sig::ImageOf< yarp::sig::PixelRgb > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgb >();
+  // Convert the vpImage<vpRGBa> to a yarp::sig::ImageOf<yarp::sig::PixelRgb>
+  vpImageConvert::convert(I,Iyarp);
 
-#else
-  // tres tres lent ....
- unsigned int i=0,j=0;
- unsigned char r, g, b;
-
- while( j < size*2)
- {
-
-   YUVToRGB (yuv[j+1], yuv[j], yuv[j+2], r, g, b);
-   rgb[i]   = r;
-   rgb[i+1] = g;
-   rgb[i+2] = b;
-   i+=3;
-
-   YUVToRGB (yuv[j+3], yuv[j], yuv[j+2], r, g, b);
-   rgb[i]   = r;
-   rgb[i+1] = g;
-   rgb[i+2] = b;
-   i+=3;
-   j+=4;
-
- }
+  // ...
 #endif
 }
-
-/*!
-
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
-  Destination grey memory area has to be allocated before.
-
-  \sa YUYVToGrey()
-
+  \endcode
 */
-void vpImageConvert::YUV422ToGrey(unsigned char* yuv,
-          unsigned char* grey,
-          unsigned int size)
+void vpImageConvert::convert(const vpImage<vpRGBa> & src,
+	yarp::sig::ImageOf< yarp::sig::PixelRgb > *dest)
 {
- unsigned int i=0,j=0;
-
- while( j < size*2)
- {
-   grey[i++] = yuv[j+1];
-   grey[i++] = yuv[j+3];
-   j+=4;
- }
+  dest->resize(src.getWidth(),src.getHeight());
+  for(unsigned int i = 0 ; i < src.getRows() ; i++){
+    for(unsigned int j = 0 ; j < src.getWidth() ; j++){
+	dest->pixel(j,i).r = src[i][j].R;
+	dest->pixel(j,i).g = src[i][j].G;
+	dest->pixel(j,i).b = src[i][j].B;
+    }
+  }
 }
 
 /*!
+  Convert a yarp::sig::ImageOf\<yarp::sig::PixelRgb> to a vpImage\<vpRGBa\>
 
-Convert YUV411 into RGB
-yuv411 : u y1 y2 v y3 y4
-
-*/
-void vpImageConvert::YUV411ToRGB(unsigned char* yuv,
-         unsigned char* rgb,
-         unsigned int size)
-{
-#if 1
-  //  std::cout << "call optimized ConvertYUV411ToRGB()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1, Y2, Y3;
-  for(unsigned int i = size / 4; i; i--) {
-    U   = (int)((*yuv++ - 128) * 0.354);
-    U5  = 5*U;
-    Y0  = *yuv++;
-    Y1  = *yuv++;
-    V   = (int)((*yuv++ - 128) * 0.707);
-    V2  = 2*V;
-    Y2  = *yuv++;
-    Y3  = *yuv++;
-    UV  = - U - V;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-  }
-#else
-  // tres tres lent ....
-
-  unsigned int i=0,j=0;
-  unsigned char r, g, b;
+  A yarp::sig::Image is a YARP image class. See http://eris.liralab.it/yarpdoc/df/d15/classyarp_1_1sig_1_1Image.html for
+  the YARP image class documentation.
 
-  while( j < size*3/2)
-  {
-    YUVToRGB (yuv[j+1], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
+  \param src : Source image in YARP format.
+  \param dest : Destination image in ViSP format.
 
-    YUVToRGB (yuv[j+2], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
+  \code
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpRGBa.h>
 
-    YUVToRGB (yuv[j+4], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
+#if defined(VISP_HAVE_YARP)
+  #include <yarp/sig/ImageFile.h>
+#endif
 
-    YUVToRGB (yuv[j+5], yuv[j], yuv[j+3], r, g, b);
-    rgb[i]   = r;
-    rgb[i+1] = g;
-    rgb[i+2] = b;
-    i+=3;
-    //TRACE("r= %d g=%d b=%d", r, g, b);
+int main()
+{
+#if defined(VISP_HAVE_YARP)
+  yarp::sig::ImageOf< yarp::sig::PixelRgb > *Iyarp = new yarp::sig::ImageOf< yarp::sig::PixelRgb >();
+  // Read an image on a disk
+  yarp::sig::file::read(*Iyarp,"image.pgm");
+  
+  // Convert the yarp::sig::ImageOf<yarp::sig::PixelRgb> to a vpImage<vpRGBa>
+  vpImage<vpRGBa> I;
+  vpImageConvert::convert(Iyarp,I);
 
-    j+=6;
-  }
+  // ...
 #endif
-
 }
-
-
-
-/*!
-
-  Convert YUV420 into RGBa
-  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
-
+  \endcode
 */
-void vpImageConvert::YUV420ToRGBa(unsigned char* yuv,
-         unsigned char* rgba,
-         unsigned int width, unsigned int height)
+void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgb > *src,
+	vpImage<vpRGBa> & dest)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGBa()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-7;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba -4*width+1;
+  dest.resize(src->height(),src->width());
+  for(int i = 0 ; i < src->height() ; i++){
+    for(int j = 0 ; j < src->width() ; j++){
+	dest[i][j].R = src->pixel(j,i).r;
+	dest[i][j].G = src->pixel(j,i).g;
+	dest[i][j].B = src->pixel(j,i).b;
+	dest[i][j].A = 0;
     }
-  yuv+=width;
-  rgba+=4*width;
   }
 }
-/*!
 
-  Convert YUV420 into RGB
-  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
+#endif
 
+#if defined(VISP_HAVE_LIBJPEG)
+#if JPEG_LIB_VERSION > 70
+/*!
+  Convert a vpImage\<unsigned char> to a JPEG compressed buffer
+
+  \param src : Source image in ViSP format.
+  \param dest : Destination buffer in JPEG format.
+  \param destSize : Size of the destination buffer.
+  \param quality : purcentage of the quality of the compressed image.
 */
-void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
-         unsigned char* rgb,
-         unsigned int width, unsigned int height)
+void vpImageConvert::convertToJPEGBuffer(const vpImage<unsigned char> &src, 
+                                  unsigned char **dest, long unsigned int &destSize, unsigned int quality)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGB()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
 
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+  
+  *dest = NULL;
+  destSize = 0;
+  
+  jpeg_mem_dest(&cinfo, dest, &destSize);
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
+  unsigned int width = src.getWidth();
+  unsigned int height = src.getHeight();
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 1;
+  cinfo.in_color_space = JCS_GRAYSCALE;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  jpeg_start_compress(&cinfo,TRUE);
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  unsigned char *line;
+  line = new unsigned char[width];
+  unsigned char* input = (unsigned char*)src.bitmap;
+  while (cinfo.next_scanline < cinfo.image_height)
+  {
+    for (unsigned int i = 0; i < width; i++)
+    {
+      line[i] = *(input);
+    input++;
+    }
+  jpeg_write_scanlines(&cinfo, &line, 1);
+  }
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb + 3*width-5;
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  delete [] line;
+}
+  
+/*!
+  Decompress a JPEG buffer in a vpImage\<unsigned char>
 
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  \param src : Source buffer in JPEG format.
+  \param srcSize : Size of the source buffer.
+  \param dest : Destination image in ViSP format.
+*/
+void vpImageConvert::convertToJPEGBuffer(unsigned char *src, long unsigned int srcSize, 
+                                  vpImage<unsigned char> &dest)
+{
+  struct jpeg_decompress_struct cinfo;
+  struct jpeg_error_mgr jerr;
 
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_decompress(&cinfo);
 
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  jpeg_mem_src(&cinfo, src, srcSize);
+  jpeg_read_header(&cinfo, TRUE);
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
+  unsigned int width = cinfo.image_width;
+  unsigned int height = cinfo.image_height;
 
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  if ( (width != dest.getWidth()) || (height != dest.getHeight()) )
+    dest.resize(height,width);
 
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  jpeg_start_decompress(&cinfo);
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
+  JSAMPARRAY buf = (*cinfo.mem->alloc_sarray) ((j_common_ptr) &cinfo, JPOOL_IMAGE, rowbytes, 1);
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb -3*width+1;
+  if (cinfo.out_color_space == JCS_GRAYSCALE)
+  {
+    unsigned int row;
+    while (cinfo.output_scanline<cinfo.output_height)
+    {
+      row = cinfo.output_scanline;
+      jpeg_read_scanlines(&cinfo,buf,1);
+      memcpy(dest[row], buf[0], rowbytes);
     }
-  yuv+=width;
-  rgb+=3*width;
   }
+
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
 }
+#endif
+#endif // defined(VISP_HAVE_LIBJPEG)
 
-/*!
 
-  Convert YUV420 into Grey
-  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
+#define vpSAT(c) \
+        if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
+/*!
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
+  Destination rgba memory area has to be allocated before.
 
+  \sa YUV422ToRGBa()
 */
-void vpImageConvert::YUV420ToGrey(unsigned char* yuv,
-         unsigned char* grey,
-         unsigned int size)
+void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
+        unsigned int width, unsigned int height)
 {
-  for(unsigned int i=0 ; i < size ; i++)
-  {
-    *grey++ = *yuv++;
+  if (width % 2) {
+    // The last pixel of each row is not converted
+    for (unsigned int i = 0; i < height; i++)
+      yuyvToRGBa(yuyv + 2*i*(width-1), rgba + 4*i*(width-1), width-1);
+    return;
   }
-
+  runPacked(selectKernel(yuyvToRGBa, VP_SSE2(yuyvToRGBaSSE2), NULL,
+                         VP_AVX2(yuyvToRGBaAVX2)),
+            yuyv, rgba, width*height, 2, 4, 8);
 }
 /*!
 
-  Convert YUV444 into RGBa
-  yuv444 :  u y v
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
+  to RGB24. Destination rgb memory area has to be allocated before.
 
+  \sa YUV422ToRGB()
 */
-void vpImageConvert::YUV444ToRGBa(unsigned char* yuv,
-         unsigned char* rgba,
-         unsigned int size)
+void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
+             unsigned int width, unsigned int height)
 {
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y;
-  for(unsigned int i = 0; i<size; i++)
-  {
-    U   = (int)((*yuv++ - 128) * 0.354);
-    U5  = 5*U;
-    Y   = *yuv++;
-    V   = (int)((*yuv++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
+  if (width % 2) {
+    // The last pixel of each row is not converted
+    for (unsigned int i = 0; i < height; i++)
+      yuyvToRGB(yuyv + 2*i*(width-1), rgb + 3*i*(width-1), width-1);
+    return;
   }
+  runPacked(selectKernel(yuyvToRGB, VP_SSE2(yuyvToRGBSSE2),
+                         VP_SSSE3(yuyvToRGBSSSE3), NULL),
+            yuyv, rgb, width*height, 2, 4, 6);
 }
 /*!
 
-  Convert YUV444 into RGB
-  yuv444 : u y v
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
+  to grey. Destination rgb memory area has to be allocated before.
 
+  \sa YUV422ToGrey()
 */
-void vpImageConvert::YUV444ToRGB(unsigned char* yuv,
-         unsigned char* rgb,
-         unsigned int size)
+void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey,
+        unsigned int size)
 {
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y;
-  for(unsigned int i = 0; i<size; i++)
-  {
-
-    U   = (int)((*yuv++ - 128) * 0.354);
-    U5  = 5*U;
-    Y   = *yuv++;
-    V   = (int)((*yuv++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
+  runPacked(selectKernel(extractBytes<2, 0>, VP_SSE2(extract2SSE2<0>), NULL,
+                         VP_AVX2(extract2AVX2<0>)),
+            yuyv, grey, size, 1, 2, 1);
+}
 
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
 
-    G = Y + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+Convert YUV411 into RGB32
+yuv411 : u y1 y2 v y3 y4
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-  }
+*/
+void vpImageConvert::YUV411ToRGBa(unsigned char* yuv,
+          unsigned char* rgba,
+          unsigned int size)
+{
+  runPacked(selectKernel(yuv411ToRGBa, NULL, VP_SSSE3(yuv411ToRGBaSSSE3), NULL),
+            yuv, rgba, size, 4, 6, 16);
 }
 
 /*!
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB32 images.
+  Destination rgba memory area has to be allocated before.
 
-  Convert YUV444 into Grey
-  yuv444 : u y v
-
+  \sa YUYVToRGBa()
 */
-void vpImageConvert::YUV444ToGrey(unsigned char* yuv,
-         unsigned char* grey,
-         unsigned int size)
+void vpImageConvert::YUV422ToRGBa(unsigned char* yuv,
+          unsigned char* rgba,
+          unsigned int size)
 {
-  yuv++;
-  for(unsigned int i=0 ; i < size ; i++)
-  {
-    *grey++ = *yuv;
-    yuv = yuv + 3;
-  }
+  runPacked(selectKernel(uyvyToRGBa, VP_SSE2(uyvyToRGBaSSE2), NULL,
+                         VP_AVX2(uyvyToRGBaAVX2)),
+            yuv, rgba, size, 2, 4, 8);
 }
 
 /*!
 
-  Convert YV12 into RGBa
-  yuv420 : Y(NxM), V(N/2xM/2), U(N/2xM/2)
+Convert YUV411 into Grey
+yuv411 : u y1 y2 v y3 y4
 
 */
-void vpImageConvert::YV12ToRGBa(unsigned char* yuv,
-         unsigned char* rgba,
-         unsigned int width, unsigned int height)
+void vpImageConvert::YUV411ToGrey(unsigned char* yuv,
+          unsigned char* grey,
+          unsigned int size)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGBa()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  runPacked(selectKernel(yuv411ToGrey, NULL, VP_SSSE3(yuv411ToGreySSSE3), NULL),
+            yuv, grey, size, 4, 6, 4);
+}
 
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB images.
+  Destination rgb memory area has to be allocated before.
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
+  \sa YUYVToRGB()
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+*/
+void vpImageConvert::YUV422ToRGB(unsigned char* yuv,
+         unsigned char* rgb,
+         unsigned int size)
+{
+  runPacked(selectKernel(uyvyToRGB, VP_SSE2(uyvyToRGBSSE2),
+                         VP_SSSE3(uyvyToRGBSSSE3), NULL),
+            yuv, rgb, size, 2, 4, 6);
+}
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
+  Destination grey memory area has to be allocated before.
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-7;
+  \sa YUYVToGrey()
 
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+*/
+void vpImageConvert::YUV422ToGrey(unsigned char* yuv,
+          unsigned char* grey,
+          unsigned int size)
+{
+  runPacked(selectKernel(extractBytes<2, 1>, VP_SSE2(extract2SSE2<1>), NULL,
+                         VP_AVX2(extract2AVX2<1>)),
+            yuv, grey, size, 1, 2, 1);
+}
 
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+Convert YUV411 into RGB
+yuv411 : u y1 y2 v y3 y4
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
+*/
+void vpImageConvert::YUV411ToRGB(unsigned char* yuv,
+         unsigned char* rgb,
+         unsigned int size)
+{
+  runPacked(selectKernel(yuv411ToRGB, NULL, VP_SSSE3(yuv411ToRGBSSSE3), NULL),
+            yuv, rgb, size, 4, 6, 12);
+}
 
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
 
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+/*!
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba -4*width+1;
-    }
-  yuv+=width;
-  rgba+=4*width;
-  }
+  Convert YUV420 into RGBa
+  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
+
+*/
+void vpImageConvert::YUV420ToRGBa(unsigned char* yuv,
+         unsigned char* rgba,
+         unsigned int width, unsigned int height)
+{
+  unsigned int size = width*height;
+  runPlanar(selectKernel(yuv420ToRGBa, VP_SSE2(yuv420ToRGBaSSE2), NULL,
+                         VP_AVX2(yuv420ToRGBaAVX2)),
+            yuv, yuv + size, yuv + 5*size/4, rgba, width, height, 4);
 }
 /*!
 
-  Convert YV12 into RGB
-  yuv420 : Y(NxM),  V(N/2xM/2), U(N/2xM/2)
+  Convert YUV420 into RGB
+  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
 */
-void vpImageConvert::YV12ToRGB(unsigned char* yuv,
+void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
          unsigned char* rgb,
-         unsigned int height, unsigned int width)
+         unsigned int width, unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGB()" << std::endl;
-  register int U, V, R, G, B, V2, U5, UV;
-  register int Y0, Y1, Y2, Y3;
   unsigned int size = width*height;
-  unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  runPlanar(selectKernel(yuv420ToRGB, VP_SSE2(yuv420ToRGBSSE2),
+                         VP_SSSE3(yuv420ToRGBSSSE3), NULL),
+            yuv, yuv + size, yuv + 5*size/4, rgb, width, height, 3);
+}
 
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+/*!
 
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert YUV420 into Grey
+  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
+*/
+void vpImageConvert::YUV420ToGrey(unsigned char* yuv,
+         unsigned char* grey,
+         unsigned int size)
+{
+  memcpy(grey, yuv, size);
+}
+/*!
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  Convert YUV444 into RGBa
+  yuv444 :  u y v
 
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+*/
+void vpImageConvert::YUV444ToRGBa(unsigned char* yuv,
+         unsigned char* rgba,
+         unsigned int size)
+{
+  runPacked(selectKernel(yuv444ToRGBa, NULL, VP_SSSE3(yuv444ToRGBaSSSE3), NULL),
+            yuv, rgba, size, 1, 3, 4);
+}
+/*!
 
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert YUV444 into RGB
+  yuv444 : u y v
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb + 3*width-5;
+*/
+void vpImageConvert::YUV444ToRGB(unsigned char* yuv,
+         unsigned char* rgb,
+         unsigned int size)
+{
+  runPacked(selectKernel(yuv444ToRGB, NULL, VP_SSSE3(yuv444ToRGBSSSE3), NULL),
+            yuv, rgb, size, 1, 3, 3);
+}
 
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+/*!
 
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+  Convert YUV444 into Grey
+  yuv444 : u y v
 
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+*/
+void vpImageConvert::YUV444ToGrey(unsigned char* yuv,
+         unsigned char* grey,
+         unsigned int size)
+{
+  runPacked(selectKernel(extractBytes<3, 1>, NULL, VP_SSSE3(yuv444ToGreySSSE3), NULL),
+            yuv, grey, size, 1, 3, 1);
+}
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
+/*!
 
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+  Convert YV12 into RGBa
+  yuv420 : Y(NxM), V(N/2xM/2), U(N/2xM/2)
 
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+*/
+void vpImageConvert::YV12ToRGBa(unsigned char* yuv,
+         unsigned char* rgba,
+         unsigned int width, unsigned int height)
+{
+  unsigned int size = width*height;
+  runPlanar(selectKernel(yuv420ToRGBa, VP_SSE2(yuv420ToRGBaSSE2), NULL,
+                         VP_AVX2(yuv420ToRGBaAVX2)),
+            yuv, yuv + 5*size/4, yuv + size, rgba, width, height, 4);
+}
+/*!
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+  Convert YV12 into RGB
+  yuv420 : Y(NxM),  V(N/2xM/2), U(N/2xM/2)
 
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb -3*width+1;
-    }
-  yuv+=width;
-  rgb+=3*width;
-  }
+*/
+void vpImageConvert::YV12ToRGB(unsigned char* yuv,
+         unsigned char* rgb,
+         unsigned int height, unsigned int width)
+{
+  unsigned int size = width*height;
+  runPlanar(selectKernel(yuv420ToRGB, VP_SSE2(yuv420ToRGBSSE2),
+                         VP_SSSE3(yuv420ToRGBSSSE3), NULL),
+            yuv, yuv + 5*size/4, yuv + size, rgb, width, height, 3);
 }
 
 /*!
@@ -2895,16 +3279,8 @@ void vpImageConvert::YVU9ToRGB(unsigned char* yuv,
 void vpImageConvert::RGBToRGBa(unsigned char* rgb, unsigned char* rgba,
              unsigned int size)
 {
-  unsigned char *pt_input = rgb;
-  unsigned char *pt_end = rgb + 3*size;
-  unsigned char *pt_output = rgba;
-
-  while(pt_input != pt_end) {
-    *(pt_output++) = *(pt_input++) ; // R
-    *(pt_output++) = *(pt_input++) ; // G
-    *(pt_output++) = *(pt_input++) ; // B
-    *(pt_output++) = 0 ; // A
-  }
+  runPacked(selectKernel(rgbToRGBa<0, 2>, NULL, VP_SSSE3(rgbToRGBaSSSE3<false>), NULL),
+            rgb, rgba, size, 1, 3, 4);
 }
 
 /*!
@@ -2915,16 +3291,8 @@ void vpImageConvert::RGBToRGBa(unsigned char* rgb, unsigned char* rgba,
 void vpImageConvert::RGBaToRGB(unsigned char* rgba, unsigned char* rgb,
              unsigned int size)
 {
-  unsigned char *pt_input = rgba;
-  unsigned char *pt_end = rgba + 4*size;
-  unsigned char *pt_output = rgb;
-
-  while(pt_input != pt_end) {
-    *(pt_output++) = *(pt_input++) ; // R
-    *(pt_output++) = *(pt_input++) ; // G
-    *(pt_output++) = *(pt_input++) ; // B
-    pt_input++ ;
-  }
+  runPacked(selectKernel(rgbaToRGB, NULL, VP_SSSE3(rgbaToRGBSSSE3), NULL),
+            rgba, rgb, size, 1, 4, 3);
 }
 /*!
   Weights convert from linear RGB to CIE luminance assuming a
@@ -2935,16 +3303,8 @@ void vpImageConvert::RGBaToRGB(unsigned char* rgba, unsigned char* rgb,
 void vpImageConvert::RGBToGrey(unsigned char* rgb, unsigned char* grey,
              unsigned int size)
 {
-  unsigned char *pt_input = rgb;
-  unsigned char* pt_end = rgb + size*3;
-  unsigned char *pt_output = grey;
-  while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
-    pt_input += 3;
-    pt_output ++;
-  }
+  runPacked(selectKernel(toGrey<3, 0, 2>, NULL, VP_SSSE3(rgbToGreySSSE3<false>), NULL),
+            rgb, grey, size, 1, 3, 1);
 }
 /*!
 
@@ -2956,17 +3316,9 @@ void vpImageConvert::RGBToGrey(unsigned char* rgb, unsigned char* grey,
 void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey,
         unsigned int size)
 {
-  unsigned char *pt_input = rgba;
-  unsigned char* pt_end = rgba + size*4;
-  unsigned char *pt_output = grey;
-
-  while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
-    pt_input += 4;
-    pt_output ++;
-  }
+  runPacked(selectKernel(toGrey<4, 0, 2>, VP_SSE2(rgbaToGreySSE2), NULL,
+                         VP_AVX2(rgbaToGreyAVX2)),
+            rgba, grey, size, 1, 4, 1);
 }
 
 /*!
@@ -2977,20 +3329,8 @@ void
 vpImageConvert::GreyToRGBa(unsigned char* grey,
          unsigned char* rgba, unsigned int size)
 {
-  unsigned char *pt_input = grey;
-  unsigned char *pt_end = grey + size;
-  unsigned char *pt_output = rgba;
-
-  while(pt_input != pt_end) {
-    unsigned char p =  *pt_input ;
-    *(pt_output     ) = p ; // R
-    *(pt_output  + 1) = p ; // G
-    *(pt_output  + 2) = p ; // B
-    *(pt_output  + 3) = p ; // A
-
-    pt_input ++;
-    pt_output += 4;
-  }
+  runPacked(selectKernel(greyToRGBa, VP_SSE2(greyToRGBaSSE2), NULL, NULL),
+            grey, rgba, size, 1, 1, 4);
 }
 
 /*!
@@ -3026,33 +3366,8 @@ void
 vpImageConvert::BGRToRGBa(unsigned char * bgr, unsigned char * rgba,
         unsigned int width, unsigned int height, bool flip)
 {
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? (bgr+(width*height*3)+lineStep) : bgr;
-  unsigned char * line;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  for(i=0 ; i < height ; i++)
-  {
-    line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      *rgba++ = *(line+2);
-      *rgba++ = *(line+1);
-      *rgba++ = *(line+0);
-      *rgba++ = 0;
-
-      line+=3;
-    }
-    //go to the next line
-    src+=lineStep;
-  }
-
+  runRows(selectKernel(rgbToRGBa<2, 0>, NULL, VP_SSSE3(rgbToRGBaSSSE3<true>), NULL),
+          bgr, rgba, width, height, flip, 3, 4);
 }
 
 /*!
@@ -3064,31 +3379,8 @@ void
 vpImageConvert::BGRToGrey(unsigned char * bgr, unsigned char * grey,
         unsigned int width, unsigned int height, bool flip)
 {
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? bgr+(width*height*3)+lineStep : bgr;
-  unsigned char * line;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  for(i=0 ; i < height ; i++)
-  {
-    line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      *grey++ = (unsigned char)( 0.2126 * *(line+2)
-         + 0.7152 * *(line+1)
-         + 0.0722 * *(line+0)) ;
-      line+=3;
-    }
-
-    //go to the next line
-    src+=lineStep;
-  }
+  runRows(selectKernel(toGrey<3, 2, 0>, NULL, VP_SSSE3(rgbToGreySSSE3<true>), NULL),
+          bgr, grey, width, height, flip, 3, 1);
 }
 /*!
   Converts a RGB image to RGBa
@@ -3099,30 +3391,8 @@ void
 vpImageConvert::RGBToRGBa(unsigned char * rgb, unsigned char * rgba,
         unsigned int width, unsigned int height, bool flip)
 {
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? (rgb+(width*height*3)+lineStep) : rgb;
-  unsigned char * line;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  for(i=0 ; i < height ; i++)
-  {
-    line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      *rgba++ = *(line++);
-      *rgba++ = *(line++);
-      *rgba++ = *(line++);
-      *rgba++ = 0;
-    }
-    //go to the next line
-    src+=lineStep;
-  }
+  runRows(selectKernel(rgbToRGBa<0, 2>, NULL, VP_SSSE3(rgbToRGBaSSSE3<false>), NULL),
+          rgb, rgba, width, height, flip, 3, 4);
 }
 
 /*!
@@ -3134,33 +3404,8 @@ void
 vpImageConvert::RGBToGrey(unsigned char * rgb, unsigned char * grey,
         unsigned int width, unsigned int height, bool flip)
 {
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? rgb+(width*height*3)+lineStep : rgb;
-  unsigned char * line;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  unsigned r,g,b;
-
-  for(i=0 ; i < height ; i++)
-  {
-    line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      r = *(line++);
-      g = *(line++);
-      b = *(line++);
-      *grey++ = (unsigned char)( 0.2126 * r + 0.7152 * g + 0.0722 * b) ;
-    }
-
-    //go to the next line
-    src+=lineStep;
-  }
+  runRows(selectKernel(toGrey<3, 0, 2>, NULL, VP_SSSE3(rgbToGreySSSE3<false>), NULL),
+          rgb, grey, width, height, flip, 3, 1);
 }
 
 /*!
@@ -3182,6 +3427,10 @@ void vpImageConvert::computeYCbCrLUT()
       vpImageConvert::vpCbb[index] = (int)( 460.5724 * aux) >> 8;
     }
 
+    vpLutCrr = vpImageConvert::vpCrr;
+    vpLutCgb = vpImageConvert::vpCgb;
+    vpLutCgr = vpImageConvert::vpCgr;
+    vpLutCbb = vpImageConvert::vpCbb;
     YCbCrLUTcomputed = true;
   }
 }
@@ -3209,39 +3458,9 @@ void vpImageConvert::computeYCbCrLUT()
 void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb,
         unsigned int size)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycbcr;
-  unsigned char *pt_rgb = rgb;
-  cbv = pt_ycbcr + 1;
-  crv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
-
-  int col = 0;
-
-	while (size--) {
-		register int val_r, val_g, val_b;
-		if (!(col++ % 2)) {
-			cbv = pt_ycbcr + 1;
-			crv = pt_ycbcr + 3;
-		}
-
-		val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgb++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgb++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgb++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-
-    pt_ycbcr += 2;
-	}
+  runPacked(selectKernel(ycbcrToRGB<3, 1>, VP_SSE2((ycbcrSSE2<3, 1>)), NULL, NULL),
+            ycbcr, rgb, size, 2, 4, 6);
 }
 
 /*!
@@ -3268,40 +3487,9 @@ void vpImageConvert::YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb,
 void vpImageConvert::YCbCrToRGBa(unsigned char *ycbcr, unsigned char *rgba,
          unsigned int size)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycbcr;
-  unsigned char *pt_rgba = rgba;
-  cbv = pt_ycbcr + 1;
-  crv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
-
-  int col = 0;
-
-  while (size--) {
-    register int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      cbv = pt_ycbcr + 1;
-      crv = pt_ycbcr + 3;
-    }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgba++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgba++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgba++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-    *pt_rgba++ = 0;
-
-    pt_ycbcr += 2;
-  }
+  runPacked(selectKernel(ycbcrToRGB<4, 1>, VP_SSE2((ycbcrSSE2<4, 1>)), NULL, NULL),
+            ycbcr, rgba, size, 2, 4, 8);
 }
 
 
@@ -3325,14 +3513,9 @@ void vpImageConvert::YCbCrToGrey(unsigned char* yuv,
           unsigned char* grey,
           unsigned int size)
 {
- unsigned int i=0,j=0;
-
- while( j < size*2)
- {
-   grey[i++] = yuv[j];
-   grey[i++] = yuv[j+2];
-   j+=4;
- }
+  runPacked(selectKernel(extractBytes<2, 0>, VP_SSE2(extract2SSE2<0>), NULL,
+                         VP_AVX2(extract2AVX2<0>)),
+            yuv, grey, size, 1, 2, 1);
 }
 
 /*!
@@ -3356,39 +3539,9 @@ void vpImageConvert::YCbCrToGrey(unsigned char* yuv,
 void vpImageConvert::YCrCbToRGB(unsigned char *ycrcb, unsigned char *rgb,
         unsigned int size)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycrcb;
-  unsigned char *pt_rgb = rgb;
-  crv = pt_ycbcr + 1;
-  cbv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
-
-  int col = 0;
-
-  while (size--) {
-    register int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      crv = pt_ycbcr + 1;
-      cbv = pt_ycbcr + 3;
-    }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgb++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgb++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgb++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-
-    pt_ycbcr += 2;
-  }
+  runPacked(selectKernel(ycbcrToRGB<3, 3>, VP_SSE2((ycbcrSSE2<3, 3>)), NULL, NULL),
+            ycrcb, rgb, size, 2, 4, 6);
 }
 /*!
 
@@ -3413,40 +3566,9 @@ void vpImageConvert::YCrCbToRGB(unsigned char *ycrcb, unsigned char *rgb,
 void vpImageConvert::YCrCbToRGBa(unsigned char *ycrcb, unsigned char *rgba,
          unsigned int size)
 {
-  unsigned char *cbv;
-  unsigned char *crv;
-  unsigned char *pt_ycbcr = ycrcb;
-  unsigned char *pt_rgba = rgba;
-  crv = pt_ycbcr + 1;
-  cbv = pt_ycbcr + 3;
-
   vpImageConvert::computeYCbCrLUT();
-
-  int col = 0;
-
-  while (size--) {
-    register int val_r, val_g, val_b;
-    if (!(col++ % 2)) {
-      crv = pt_ycbcr + 1;
-      cbv = pt_ycbcr + 3;
-    }
-
-    val_r = *pt_ycbcr + vpImageConvert::vpCrr[*crv];
-    val_g = *pt_ycbcr + vpImageConvert::vpCgb[*cbv] + vpImageConvert::vpCgr[*crv];
-    val_b = *pt_ycbcr + vpImageConvert::vpCbb[*cbv];
-
-    vpDEBUG_TRACE(5, "[%d] R: %d G: %d B: %d\n", size, val_r, val_g, val_b);
-
-    *pt_rgba++ = (val_r < 0) ? 0u :
-      ((val_r > 255) ? 255u : (unsigned char)val_r); // Red component.
-    *pt_rgba++ = (val_g < 0) ? 0u :
-      ((val_g > 255) ? 255u : (unsigned char)val_g); // Green component.
-    *pt_rgba++ = (val_b < 0) ? 0u :
-      ((val_b > 255) ? 255u : (unsigned char)val_b); // Blue component.
-    *pt_rgba++ = 0;
-
-    pt_ycbcr += 2;
-  }
+  runPacked(selectKernel(ycbcrToRGB<4, 3>, VP_SSE2((ycbcrSSE2<4, 3>)), NULL, NULL),
+            ycrcb, rgba, size, 2, 4, 8);
 }
 
 /*!
@@ -3552,14 +3674,9 @@ void vpImageConvert::split(const vpImage<vpRGBa> &src,
 void vpImageConvert::MONO16ToGrey(unsigned char *grey16, unsigned char *grey,
           unsigned int size)
 {
-  register int i = (((int)size)<<1)-1;
-  register int j = (int)size-1;
-  register int y;
-
-  while (i >= 0) {
-    y = grey16[i--];
-    grey[j--] = static_cast<unsigned char>( (y+(grey16[i--]<<8))>>8 );
-  }
+  runPacked(selectKernel(extractBytes<2, 0>, VP_SSE2(extract2SSE2<0>), NULL,
+                         VP_AVX2(extract2AVX2<0>)),
+            grey16, grey, size, 1, 2, 1);
 }
 
 /*!
@@ -3575,19 +3692,8 @@ void vpImageConvert::MONO16ToGrey(unsigned char *grey16, unsigned char *grey,
 void vpImageConvert::MONO16ToRGBa(unsigned char *grey16, unsigned char *rgba,
           unsigned int size)
 {
-  register int i = (((int)size)<<1)-1;
-  register int j = (int)(size*4-1);
-  register int y;
-  register unsigned char v;
-
-  while (i >= 0) {
-    y = grey16[i--];
-    v = static_cast<unsigned char>( (y+(grey16[i--]<<8))>>8 );
-    rgba[j--] = 0;
-    rgba[j--] = v;
-    rgba[j--] = v;
-    rgba[j--] = v;
-  }
+  runPacked(selectKernel(mono16ToRGBa, VP_SSE2(mono16ToRGBaSSE2), NULL, NULL),
+            grey16, rgba, size, 1, 2, 4);
 }
 
 /*
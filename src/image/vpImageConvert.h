@@ -91,11 +91,36 @@
 
   \brief Convert image types.
 
+  The conversions between the YUV, RGB and grey level formats use the
+  SSE2 instructions when ViSP is built with them. With GCC, Clang and
+  MSVC, SSSE3 and AVX2 versions are also built and selected at run
+  time when the processor supports them. All the versions give exactly
+  the same results; setSimdType() allows to force one of them.
+
+  The large images are converted by several threads when ViSP is built
+  with OpenMP (see setNumberOfThreads()).
 */
 class VISP_EXPORT vpImageConvert
 {
 
 public:
+  /*!
+    Instruction sets used by the conversions, from the oldest to the
+    most recent.
+  */
+  typedef enum {
+    SIMD_NONE,  /*!< Portable C++ code. */
+    SIMD_SSE2,  /*!< SSE2 instructions. */
+    SIMD_SSSE3, /*!< SSSE3 instructions. */
+    SIMD_AVX2   /*!< AVX2 instructions. */
+  } vpSimdType;
+
+  static vpSimdType getSimdSupport();
+  static vpSimdType getSimdType();
+  static void setSimdType(vpSimdType type);
+  static void setNumberOfThreads(unsigned int n);
+  static unsigned int getNumberOfThreads();
+
   static void convert(const vpImage<unsigned char> &src,
           vpImage<vpRGBa> & dest) ;
   static void convert(const vpImage<vpRGBa> &src,
@@ -115,7 +140,8 @@ public:
   static void convert(const IplImage* src,
           vpImage<vpRGBa> & dest, bool flip = false) ;
   static void convert(const IplImage* src,
-          vpImage<unsigned char> & dest, bool flip = false) ;
+          vpImage<unsigned char> & dest, bool flip = false,
+          bool copyData = true) ;
   static void convert(const vpImage<vpRGBa> & src,
           IplImage *&dest) ;
   static void convert(const vpImage<unsigned char> & src,
@@ -124,7 +150,8 @@ public:
   static void convert(const cv::Mat& src,
           vpImage<vpRGBa>& dest, const bool flip = false);
   static void convert(const cv::Mat& src,
-          vpImage<unsigned char>& dest, const bool flip = false);
+          vpImage<unsigned char>& dest, const bool flip = false,
+          const bool copyData = true);
   static void convert(const vpImage<vpRGBa> & src,
           cv::Mat& dest) ;
   static void convert(const vpImage<unsigned char> & src,
@@ -47,12 +47,429 @@
 #include <cv.h>
 #endif
 
+#include <visp/vpDebug.h>
+
+#include <vector>
+
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Number of threads used by the separable filters
+  unsigned int vpFilterThreads = 1;
+  // Images with less pixels are filtered by a single thread
+  const unsigned int vpFilterParallelMinPixels = 128*128;
+
+  // Index of the pixel used for the coordinate x of a row or a column of
+  // n pixels, -1 if it is zero
+  int borderIndex(int x, int n, vpImageFilter::vpBorderType border)
+  {
+    if (x >= 0 && x < n)
+      return x;
+    switch (border) {
+    case vpImageFilter::BORDER_ZERO:
+      return -1;
+    case vpImageFilter::BORDER_REFLECT:
+      if (n == 1)
+        return 0;
+      while (x < 0 || x >= n) {
+        if (x < 0) x = -x;
+        if (x >= n) x = 2*(n-1) - x;
+      }
+      return x;
+    case vpImageFilter::BORDER_REPLICATE:
+    default:
+      return (x < 0) ? 0 : n - 1;
+    }
+  }
+
+  void checkKernelSize(unsigned int size)
+  {
+    if (size == 0 || (size % 2) == 0) {
+      vpERROR_TRACE("Kernel size %d is not odd", size) ;
+      throw (vpImageException(vpImageException::incorrectInitializationError,
+                              "The size of a kernel has to be odd")) ;
+    }
+  }
+
+  // Horizontal correlation of a row of doubles padded with its borders
+  void filterRow(const double *pad, unsigned int w, const double *ku,
+                 const short * /*ku16*/, unsigned int nu, double *dst)
+  {
+    for (unsigned int j = 0; j < w; j++)
+      dst[j] = ku[0] * pad[j];
+    for (unsigned int k = 1; k < nu; k++) {
+      double c = ku[k];
+      if (c == 0.)
+        continue;
+      const double *p = pad + k;
+      for (unsigned int j = 0; j < w; j++)
+        dst[j] += c * p[j];
+    }
+  }
+
+  // Horizontal correlation of a row of bytes padded with its borders.
+  // When ku16 is not NULL, the taps are integers that fit in 16 bits and
+  // the products are accumulated as 32 bits integers; the row of pad is
+  // followed by 8 unused bytes.
+  void filterRow(const unsigned char *pad, unsigned int w, const double *ku,
+                 const short *ku16, unsigned int nu, double *dst)
+  {
+    if (ku16 == NULL) {
+      for (unsigned int j = 0; j < w; j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < nu; k++)
+          s += ku[k] * pad[j+k];
+        dst[j] = s;
+      }
+      return;
+    }
+    unsigned int j = 0;
+#ifdef VISP_HAVE_SSE2
+    // Two taps at a time: the pixels j+k and j+k+1 are interleaved and
+    // multiplied by the pair of taps with pmaddwd
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; j + 8 <= w; j += 8) {
+      __m128i lo = zero, hi = zero;
+      for (unsigned int k = 0; k < nu; k += 2) {
+        short c1 = (k + 1 < nu) ? ku16[k+1] : 0;
+        __m128i c = _mm_set1_epi32((int)(unsigned short)ku16[k] | ((int)c1 << 16));
+        __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(pad + j + k)), zero);
+        __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(pad + j + k + 1)), zero);
+        lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+        hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+      }
+      _mm_storeu_pd(dst + j, _mm_cvtepi32_pd(lo));
+      _mm_storeu_pd(dst + j + 2, _mm_cvtepi32_pd(_mm_srli_si128(lo, 8)));
+      _mm_storeu_pd(dst + j + 4, _mm_cvtepi32_pd(hi));
+      _mm_storeu_pd(dst + j + 6, _mm_cvtepi32_pd(_mm_srli_si128(hi, 8)));
+    }
+#endif
+    for ( ; j < w; j++) {
+      int s = 0;
+      for (unsigned int k = 0; k < nu; k++)
+        s += ku16[k] * pad[j+k];
+      dst[j] = (double)s;
+    }
+  }
+
+  // Buffer where the sums of a row are accumulated: the output row
+  // itself when it is made of doubles
+  inline double *accumulator(double *out, std::vector<double> & /*acc*/)
+  {
+    return out;
+  }
+  inline double *accumulator(float * /*out*/, std::vector<double> &acc)
+  {
+    return &acc[0];
+  }
+
+  // out = inv * sum_k k[k] src[k], the n vectors src[k] being of size w.
+  // The sums are computed in acc, that can be out if Out is double.
+  template<class Out>
+  void weightedSum(const double * const *src, const double *k, unsigned int n,
+                   unsigned int w, double inv, double *acc, Out *out)
+  {
+    double c = k[0];
+    const double *row = src[0];
+    if (n == 1) {
+      for (unsigned int j = 0; j < w; j++)
+        out[j] = (Out)((c * row[j]) * inv);
+      return;
+    }
+    for (unsigned int j = 0; j < w; j++)
+      acc[j] = c * row[j];
+    for (unsigned int l = 1; l + 1 < n; l++) {
+      c = k[l];
+      if (c == 0.)
+        continue;
+      row = src[l];
+      for (unsigned int j = 0; j < w; j++)
+        acc[j] += c * row[j];
+    }
+    // The normalization is done with the last tap
+    c = k[n-1];
+    row = src[n-1];
+    for (unsigned int j = 0; j < w; j++)
+      out[j] = (Out)((acc[j] + c * row[j]) * inv);
+  }
+
+  /*
+    Correlation of I with the horizontal kernel ku and the vertical
+    kernel kv, divided by divisor. Each band of rows is filtered by one
+    thread. The horizontally filtered rows are kept in a ring of nv rows
+    from which the output rows are computed. When ku16 is given, the
+    horizontal pass uses integer arithmetic (see filterRow()); as the
+    vertical pass sums products of integers smaller than 2^53, the
+    result is then exact before its normalization by divisor.
+  */
+  template<class In, class Out>
+  void separableFilter(const vpImage<In> &I, vpImage<Out> &If,
+                       const std::vector<double> &ku, const std::vector<short> &ku16,
+                       const std::vector<double> &kv, double divisor,
+                       vpImageFilter::vpBorderType border)
+  {
+    unsigned int h = I.getHeight();
+    unsigned int w = I.getWidth();
+    If.resize(h, w);
+    if (h == 0 || w == 0)
+      return;
+
+    int hu = (int)ku.size() / 2;
+    int hv = (int)kv.size() / 2;
+    unsigned int nu = (unsigned int)ku.size();
+    unsigned int nv = (unsigned int)kv.size();
+    const short *pku16 = ku16.empty() ? NULL : &ku16[0];
+    // Multiplying is much faster than dividing each pixel
+    const double inv = 1. / divisor;
+
+    int nbands = 1;
+    if (h*w >= vpFilterParallelMinPixels)
+      nbands = (int)((vpFilterThreads < h) ? vpFilterThreads : h);
+
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel for num_threads(nbands) if(nbands > 1)
+#endif
+    for (int t = 0; t < nbands; t++) {
+      int i0 = (int)(((double)h * t) / nbands);
+      int i1 = (int)(((double)h * (t+1)) / nbands);
+
+      std::vector<In> pad(w + 2*hu + 8, In(0));
+      std::vector<double> ring((size_t)nv * w);
+      std::vector<const double *> rows(nv);
+      std::vector<double> acc(w);
+
+      for (int r = i0 - hv; r < i1 + hv; r++) {
+        // Horizontal pass of the row r in the ring
+        double *dst = &ring[(size_t)((r - i0 + hv) % (int)nv) * w];
+        int sr = borderIndex(r, (int)h, border);
+        if (sr < 0) {
+          for (unsigned int j = 0; j < w; j++)
+            dst[j] = 0;
+        }
+        else {
+          const In *src = I[(unsigned int)sr];
+          for (int k = 0; k < hu; k++) {
+            int jl = borderIndex(k - hu, (int)w, border);
+            int jr = borderIndex((int)w + k, (int)w, border);
+            pad[k] = (jl < 0) ? In(0) : src[jl];
+            pad[w + hu + k] = (jr < 0) ? In(0) : src[jr];
+          }
+          for (unsigned int j = 0; j < w; j++)
+            pad[hu + j] = src[j];
+          filterRow(&pad[0], w, &ku[0], pku16, nu, dst);
+        }
+
+        // Vertical pass of the row i once its neighbours are in the ring
+        int i = r - hv;
+        if (i < i0)
+          continue;
+        for (unsigned int k = 0; k < nv; k++)
+          rows[k] = &ring[(size_t)((i - i0 + (int)k) % (int)nv) * w];
+        Out *out = If[(unsigned int)i];
+        weightedSum(&rows[0], &kv[0], nv, w, inv, accumulator(out, acc), out);
+      }
+    }
+  }
+
+  // Vertical correlation of rows of bytes with 16 bits integer taps,
+  // accumulated as 32 bits integers. rows[nv] has to be a row of zeros.
+  void filterColumns(const unsigned char * const *rows, unsigned int w,
+                     const short *kv16, unsigned int nv, double *dst)
+  {
+    unsigned int j = 0;
+#ifdef VISP_HAVE_SSE2
+    // Two rows at a time, interleaved and multiplied with pmaddwd
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; j + 8 <= w; j += 8) {
+      __m128i lo = zero, hi = zero;
+      for (unsigned int k = 0; k < nv; k += 2) {
+        short c1 = (k + 1 < nv) ? kv16[k+1] : 0;
+        __m128i c = _mm_set1_epi32((int)(unsigned short)kv16[k] | ((int)c1 << 16));
+        __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(rows[k] + j)), zero);
+        __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(rows[k+1] + j)), zero);
+        lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+        hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+      }
+      _mm_storeu_pd(dst + j, _mm_cvtepi32_pd(lo));
+      _mm_storeu_pd(dst + j + 2, _mm_cvtepi32_pd(_mm_srli_si128(lo, 8)));
+      _mm_storeu_pd(dst + j + 4, _mm_cvtepi32_pd(hi));
+      _mm_storeu_pd(dst + j + 6, _mm_cvtepi32_pd(_mm_srli_si128(hi, 8)));
+    }
+#endif
+    for ( ; j < w; j++) {
+      int s = 0;
+      for (unsigned int k = 0; k < nv; k++)
+        s += kv16[k] * rows[k][j];
+      dst[j] = (double)s;
+    }
+  }
+
+  /*
+    Same as separableFilter() for grey level images, but the vertical
+    pass is done first with the integer taps kv16, then each filtered
+    row is correlated with ku. It is faster when kv is longer than ku.
+  */
+  template<class Out>
+  void separableFilterVertical(const vpImage<unsigned char> &I, vpImage<Out> &If,
+                               const std::vector<double> &ku,
+                               const std::vector<short> &kv16, double divisor,
+                               vpImageFilter::vpBorderType border)
+  {
+    unsigned int h = I.getHeight();
+    unsigned int w = I.getWidth();
+    If.resize(h, w);
+    if (h == 0 || w == 0)
+      return;
+
+    int hu = (int)ku.size() / 2;
+    int hv = (int)kv16.size() / 2;
+    unsigned int nu = (unsigned int)ku.size();
+    unsigned int nv = (unsigned int)kv16.size();
+    const double inv = 1. / divisor;
+
+    int nbands = 1;
+    if (h*w >= vpFilterParallelMinPixels)
+      nbands = (int)((vpFilterThreads < h) ? vpFilterThreads : h);
+
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel for num_threads(nbands) if(nbands > 1)
+#endif
+    for (int t = 0; t < nbands; t++) {
+      int i0 = (int)(((double)h * t) / nbands);
+      int i1 = (int)(((double)h * (t+1)) / nbands);
+
+      std::vector<unsigned char> zeros(w, 0);
+      std::vector<const unsigned char *> rows(nv + 1);
+      std::vector<double> pad(w + 2*hu);
+      std::vector<const double *> cols(nu);
+      std::vector<double> acc(w);
+      for (unsigned int k = 0; k < nu; k++)
+        cols[k] = &pad[k];
+
+      for (int i = i0; i < i1; i++) {
+        for (unsigned int k = 0; k < nv; k++) {
+          int sr = borderIndex(i - hv + (int)k, (int)h, border);
+          rows[k] = (sr < 0) ? &zeros[0] : I[(unsigned int)sr];
+        }
+        rows[nv] = &zeros[0];
+        filterColumns(&rows[0], w, &kv16[0], nv, &pad[hu]);
+        for (int k = 0; k < hu; k++) {
+          int jl = borderIndex(k - hu, (int)w, border);
+          int jr = borderIndex((int)w + k, (int)w, border);
+          pad[k] = (jl < 0) ? 0. : pad[hu + jl];
+          pad[w + hu + k] = (jr < 0) ? 0. : pad[hu + jr];
+        }
+        Out *out = If[(unsigned int)i];
+        weightedSum(&cols[0], &ku[0], nu, w, inv, accumulator(out, acc), out);
+      }
+    }
+  }
+
+  // Integer taps of 16 bits for the horizontal pass on bytes, empty if
+  // the taps are not integers or do not fit
+  std::vector<short> shortKernel(const std::vector<double> &k)
+  {
+    std::vector<short> s(k.size());
+    for (unsigned int i = 0; i < k.size(); i++) {
+      if (k[i] != floor(k[i]) || fabs(k[i]) > 32767.)
+        return std::vector<short>();
+      s[i] = (short)k[i];
+    }
+    return s;
+  }
+
+  // Coefficients of derivativeFilterX() and derivativeFilterY()
+  const int vpDerivativeKernel[7] = { -112, -913, -2047, 0, 2047, 913, 112 };
+  const double vpDerivativeDivisor = 8418.;
+
+  // Separable filter with integer kernels, see vpImageFilter::sepFilter()
+  template<class Out>
+  void integerFilter(const vpImage<unsigned char> &I, vpImage<Out> &If,
+                     const int *ku, unsigned int nu, const int *kv, unsigned int nv,
+                     double divisor, vpImageFilter::vpBorderType border)
+  {
+    checkKernelSize(nu);
+    checkKernelSize(nv);
+
+    std::vector<double> u(ku, ku + nu);
+    std::vector<double> v(kv, kv + nv);
+    double l1u = 0, l1v = 0;
+    for (unsigned int k = 0; k < nu; k++)
+      l1u += fabs(u[k]);
+    for (unsigned int k = 0; k < nv; k++)
+      l1v += fabs(v[k]);
+
+    // The integers have to be exactly represented by doubles
+    if (255. * l1u * l1v >= 9007199254740992.) {
+      vpERROR_TRACE("Kernel coefficients too large");
+      throw (vpImageException(vpImageException::incorrectInitializationError,
+                              "Kernel coefficients too large"));
+    }
+    // The longest kernel is applied first to the pixels, with integer
+    // arithmetic if its taps fit in 16 bits and its sums in 32 bits
+    if (nv > nu && 255. * l1v < 2147483647.) {
+      std::vector<short> v16 = shortKernel(v);
+      if (! v16.empty()) {
+        separableFilterVertical(I, If, u, v16, divisor, border);
+        return;
+      }
+    }
+    std::vector<short> u16;
+    if (255. * l1u < 2147483647.)
+      u16 = shortKernel(u);
+    separableFilter(I, If, u, u16, v, divisor, border);
+  }
+
+  // Non separable correlation of I with M at the pixel (i, j)
+  template<class In>
+  double correlate(const vpImage<In> &I, const vpMatrix &M, bool transpose,
+                   unsigned int i, unsigned int j,
+                   vpImageFilter::vpBorderType border)
+  {
+    unsigned int size = M.getRows();
+    int half_size = (int)size / 2;
+    int h = (int)I.getHeight();
+    int w = (int)I.getWidth();
+    bool inside = ((int)i >= half_size && (int)i + half_size < h
+                   && (int)j >= half_size && (int)j + half_size < w);
+    double conv = 0;
+    for (unsigned int a = 0; a < size; a++) {
+      int r = (int)i - half_size + (int)a;
+      if (! inside)
+        r = borderIndex(r, h, border);
+      if (r < 0)
+        continue;
+      for (unsigned int b = 0; b < size; b++) {
+        int c = (int)j - half_size + (int)b;
+        if (! inside)
+          c = borderIndex(c, w, border);
+        if (c < 0)
+          continue;
+        double val = I[(unsigned int)r][(unsigned int)c];
+        conv += (transpose ? M[b][a] : M[a][b]) * val;
+      }
+    }
+    return conv;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
-  Apply a filter to an image.
+  Apply a filter to an image. The border pixels are computed by
+  replicating the first and last rows and columns of the image.
+
+  When the filter is separable (see isSeparable()), for example a
+  Gaussian or a derivative filter, it is applied as a horizontal and a
+  vertical 1D filter with fixed point arithmetic (see sepFilter()).
+  The cost per pixel is then proportional to the size of the filter
+  instead of its square.
 
   \param I : Image to filter
   \param If : Filtered image.
-  \param M : Filter coefficients.
+  \param M : Filter coefficients. Its size has to be odd.
 
 */
 void
@@ -60,39 +477,41 @@ vpImageFilter::filter(const vpImage<unsigned char> &I,
 		      vpImage<double>& If,
 		      const vpMatrix& M)
 {
-
   unsigned int size = M.getRows() ;
-  unsigned int half_size = size/2 ;
+  checkKernelSize(size) ;
 
-  If.resize(I.getHeight(),I.getWidth()) ;
+  vpColVector kv, ku ;
+  if (isSeparable(M, kv, ku)) {
+    sepFilter(I, If, ku, kv) ;
+    return ;
+  }
 
-  If = 0 ;
+  If.resize(I.getHeight(),I.getWidth()) ;
 
-  for (unsigned int i=half_size ; i < I.getHeight()-half_size ; i++)
+  int h = (int)I.getHeight() ;
+#ifdef VISP_HAVE_OPENMP
+  int nthreads = (int)vpFilterThreads ;
+  #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+  for (int i = 0 ; i < h ; i++)
   {
-    for (unsigned int j=half_size ; j < I.getWidth()-half_size ; j++)
-    {
-      double   conv_x = 0 ;
-
-      for(unsigned int a = 0 ; a < size ; a++ )
-        for(unsigned int b = 0 ; b < size ; b++ )
-	{
-	  double val =  I[i-half_size+a][j-half_size+b] ;
-	  conv_x += M[a][b] * val ;
-	}
-      If[i][j] = conv_x ;
-    }
+    for (unsigned int j = 0 ; j < I.getWidth() ; j++)
+      If[(unsigned int)i][j] = correlate(I, M, false, (unsigned int)i, j,
+                                         BORDER_REPLICATE) ;
   }
-
 }
 
 /*!
-  Apply a filter to an image.
+  Apply a filter to an image. The border pixels are computed by
+  replicating the first and last rows and columns of the image.
+
+  When the filter is separable (see isSeparable()), each output is
+  computed with a horizontal and a vertical 1D filter.
 
   \param I : Image to filter
   \param Iu : Filtered image along the horizontal axis (u = columns).
   \param Iv : Filtered image along the vertical axis (v = rows).
-  \param M : Separate filter coefficients
+  \param M : Separate filter coefficients. Its size has to be odd.
 
 */
 void
@@ -101,34 +520,275 @@ vpImageFilter::filter(const vpImage<double> &I,
 		      vpImage<double>& Iv,
 		      const vpMatrix& M)
 {
-
   unsigned int size = M.getRows() ;
-  unsigned int half_size = size/2 ;
+  checkKernelSize(size) ;
+
+  vpColVector kv, ku ;
+  if (isSeparable(M, kv, ku)) {
+    // Iu uses M and Iv the transpose of M
+    std::vector<double> u(size), v(size) ;
+    for (unsigned int k = 0 ; k < size ; k++) {
+      u[k] = ku[k] ;
+      v[k] = kv[k] ;
+    }
+    std::vector<short> none ;
+    separableFilter(I, Iu, u, none, v, 1., BORDER_REPLICATE) ;
+    separableFilter(I, Iv, v, none, u, 1., BORDER_REPLICATE) ;
+    return ;
+  }
 
   Iu.resize(I.getHeight(),I.getWidth()) ;
   Iv.resize(I.getHeight(),I.getWidth()) ;
 
-  Iu = 0 ;
-  Iv = 0 ;
-  for (unsigned int v=half_size ; v < I.getHeight()-half_size ; v++)
+  int h = (int)I.getHeight() ;
+#ifdef VISP_HAVE_OPENMP
+  int nthreads = (int)vpFilterThreads ;
+  #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+  for (int v = 0 ; v < h ; v++)
   {
-    for (unsigned int u=half_size ; u < I.getWidth()-half_size ; u++)
+    for (unsigned int u = 0 ; u < I.getWidth() ; u++)
     {
-      double   conv_u = 0 ;
-      double   conv_v = 0 ;
-
-      for(unsigned int a = 0 ; a < size ; a++ )
-        for(unsigned int b = 0 ; b < size ; b++ )
-	{
-	  double val =  I[v-half_size+a][u-half_size+b] ;
-	  conv_u += M[a][b] * val ;
-	  conv_v += M[b][a] * val  ;
-	}
-      Iu[v][u] = conv_u ;
-      Iv[v][u] = conv_v ;
+      Iu[(unsigned int)v][u] = correlate(I, M, false, (unsigned int)v, u, BORDER_REPLICATE) ;
+      Iv[(unsigned int)v][u] = correlate(I, M, true, (unsigned int)v, u, BORDER_REPLICATE) ;
     }
   }
+}
+
+/*!
+  Check if a square filter is separable, that is if it is the product
+  of a column and a row vector: \f$ M = k_v k_u^\top \f$.
+
+  \param M : Filter coefficients.
+  \param kv : Vertical kernel, set if the filter is separable.
+  \param ku : Horizontal kernel, set if the filter is separable.
+  \param threshold : Largest difference between a coefficient of \e M
+  and the one of \f$ k_v k_u^\top \f$, relative to the largest
+  coefficient of \e M.
+
+  \return true if the filter is separable.
+*/
+bool
+vpImageFilter::isSeparable(const vpMatrix &M, vpColVector &kv,
+                           vpColVector &ku, const double threshold)
+{
+  unsigned int rows = M.getRows() ;
+  unsigned int cols = M.getCols() ;
+  if (rows == 0 || cols == 0)
+    return false ;
+
+  // The row and the column of the largest coefficient give the kernels
+  unsigned int p = 0, q = 0 ;
+  double maxAbs = 0 ;
+  for (unsigned int a = 0 ; a < rows ; a++)
+    for (unsigned int b = 0 ; b < cols ; b++)
+      if (fabs(M[a][b]) > maxAbs) {
+        maxAbs = fabs(M[a][b]) ;
+        p = a ;
+        q = b ;
+      }
+
+  kv.resize(rows) ;
+  ku.resize(cols) ;
+  if (maxAbs == 0) {
+    kv = 0 ;
+    ku = 0 ;
+    return true ;
+  }
+  for (unsigned int a = 0 ; a < rows ; a++)
+    kv[a] = M[a][q] ;
+  for (unsigned int b = 0 ; b < cols ; b++)
+    ku[b] = M[p][b] / M[p][q] ;
+
+  for (unsigned int a = 0 ; a < rows ; a++)
+    for (unsigned int b = 0 ; b < cols ; b++)
+      if (fabs(M[a][b] - kv[a]*ku[b]) > threshold * maxAbs)
+        return false ;
+  return true ;
+}
+
+/*!
+  Apply a separable filter to an image: each row is first correlated
+  with the horizontal kernel \e ku, then each column of the result is
+  correlated with the vertical kernel \e kv.
+
+  The longest kernel is converted to fixed point numbers with 15
+  significant bits and is applied first, with integer arithmetic on the
+  8 bits pixels. The other pass uses doubles. The error of
+  the result with respect to a computation with doubles is then in the
+  order of \f$ 10^{-4} \f$ times the kernel norms and the pixel values.
+  Use the other sepFilter() with integer kernels to get exact results.
+
+  The rows of the image are split in bands filtered by different
+  threads when ViSP is built with OpenMP (see setNumberOfThreads()).
+
+  \param I : Image to filter.
+  \param If : Filtered image, resized to the size of \e I.
+  \param ku : Horizontal kernel. Its size has to be odd.
+  \param kv : Vertical kernel. Its size has to be odd.
+  \param border : Method used to compute the pixels outside the image.
+
+  \exception vpImageException::incorrectInitializationError : If the
+  size of a kernel is not odd.
+*/
+void
+vpImageFilter::sepFilter(const vpImage<unsigned char> &I,
+                         vpImage<double> &If,
+                         const vpColVector &ku, const vpColVector &kv,
+                         const vpBorderType border)
+{
+  checkKernelSize(ku.getRows()) ;
+  checkKernelSize(kv.getRows()) ;
+
+  // The longest kernel is applied first to the pixels, with its largest
+  // tap scaled to 2^14
+  bool vertical = (kv.getRows() > ku.getRows()) ;
+  const vpColVector &kq = vertical ? kv : ku ;
+  const vpColVector &kd = vertical ? ku : kv ;
+  double maxTap = 0 ;
+  for (unsigned int k = 0 ; k < kq.getRows() ; k++)
+    maxTap = vpMath::maximum(maxTap, fabs(kq[k])) ;
+  double scale = (maxTap > 0) ? 16384. / maxTap : 1. ;
+
+  std::vector<double> q(kq.getRows()), d(kd.getRows()) ;
+  for (unsigned int k = 0 ; k < kq.getRows() ; k++)
+    q[k] = vpMath::round(kq[k] * scale) ;
+  for (unsigned int k = 0 ; k < kd.getRows() ; k++)
+    d[k] = kd[k] ;
+  if (vertical)
+    separableFilterVertical(I, If, d, shortKernel(q), scale, border) ;
+  else
+    separableFilter(I, If, q, shortKernel(q), d, scale, border) ;
+}
+
+/*!
+  Apply a separable filter with integer coefficients to an image: each
+  row is first correlated with the horizontal kernel \e ku, then each
+  column of the result is correlated with the vertical kernel \e kv,
+  and the result is divided by \e divisor.
+
+  The filter is computed with integer arithmetic, so that the result is
+  exact before being multiplied by the inverse of \e divisor; it only
+  differs from a division by the rounding of the last bit. For example
+  the kernel (-112, -913, -2047, 0, 2047, 913, 112) with a divisor of
+  8418 gives the values of derivativeFilterX() (see getGradX()).
+
+  \param I : Image to filter.
+  \param If : Filtered image, resized to the size of \e I.
+  \param ku : Horizontal kernel of \e nu coefficients.
+  \param nu : Size of \e ku, it has to be odd.
+  \param kv : Vertical kernel of \e nv coefficients.
+  \param nv : Size of \e kv, it has to be odd.
+  \param divisor : Value the result of the integer filter is divided by.
+  \param border : Method used to compute the pixels outside the image.
+
+  \exception vpImageException::incorrectInitializationError : If the
+  size of a kernel is not odd or if the filtered values can not be
+  exactly represented by doubles.
+*/
+void
+vpImageFilter::sepFilter(const vpImage<unsigned char> &I,
+                         vpImage<double> &If,
+                         const int *ku, const unsigned int nu,
+                         const int *kv, const unsigned int nv,
+                         const double divisor, const vpBorderType border)
+{
+  integerFilter(I, If, ku, nu, kv, nv, divisor, border) ;
+}
+
+/*!
+  Compute the horizontal gradient of an image with the 7 taps filter of
+  derivativeFilterX(), including on the border pixels. For the pixels
+  that are at least 3 pixels away from the image border, the values
+  only differ from the ones of derivativeFilterX() by the rounding of
+  their last bit.
+
+  \param I : Input image.
+  \param dIx : Horizontal gradient, resized to the size of \e I.
+  \param border : Method used to compute the pixels outside the image.
+*/
+void
+vpImageFilter::getGradX(const vpImage<unsigned char> &I,
+                        vpImage<double> &dIx, const vpBorderType border)
+{
+  const int one = 1 ;
+  sepFilter(I, dIx, vpDerivativeKernel, 7, &one, 1, vpDerivativeDivisor, border) ;
+}
+
+/*!
+  Compute the vertical gradient of an image with the 7 taps filter of
+  derivativeFilterY(), including on the border pixels. For the pixels
+  that are at least 3 pixels away from the image border, the values
+  only differ from the ones of derivativeFilterY() by the rounding of
+  their last bit.
+
+  \param I : Input image.
+  \param dIy : Vertical gradient, resized to the size of \e I.
+  \param border : Method used to compute the pixels outside the image.
+*/
+void
+vpImageFilter::getGradY(const vpImage<unsigned char> &I,
+                        vpImage<double> &dIy, const vpBorderType border)
+{
+  const int one = 1 ;
+  sepFilter(I, dIy, &one, 1, vpDerivativeKernel, 7, vpDerivativeDivisor, border) ;
+}
+
+/*!
+  Compute the horizontal gradient of an image like getGradX(), as
+  single precision values. It halves the memory used by the gradient
+  for the processing of large images.
+
+  \param I : Input image.
+  \param dIx : Horizontal gradient, resized to the size of \e I.
+  \param border : Method used to compute the pixels outside the image.
+*/
+void
+vpImageFilter::getGradX(const vpImage<unsigned char> &I,
+                        vpImage<float> &dIx, const vpBorderType border)
+{
+  const int one = 1 ;
+  integerFilter(I, dIx, vpDerivativeKernel, 7, &one, 1, vpDerivativeDivisor, border) ;
+}
 
+/*!
+  Compute the vertical gradient of an image like getGradY(), as single
+  precision values.
+
+  \param I : Input image.
+  \param dIy : Vertical gradient, resized to the size of \e I.
+  \param border : Method used to compute the pixels outside the image.
+*/
+void
+vpImageFilter::getGradY(const vpImage<unsigned char> &I,
+                        vpImage<float> &dIy, const vpBorderType border)
+{
+  const int one = 1 ;
+  integerFilter(I, dIy, &one, 1, vpDerivativeKernel, 7, vpDerivativeDivisor, border) ;
+}
+
+/*!
+  Set the number of threads used by the filters. This setting is only
+  effective when ViSP is built with OpenMP. The separable filters only
+  use several threads for images of at least 128x128 pixels.
+
+  \param n : Number of threads. 0 is considered as 1.
+*/
+void
+vpImageFilter::setNumberOfThreads(const unsigned int n)
+{
+  vpFilterThreads = (n == 0) ? 1 : n ;
+}
+
+/*!
+  Return the number of threads used by the filters.
+
+  \sa setNumberOfThreads()
+*/
+unsigned int
+vpImageFilter::getNumberOfThreads()
+{
+  return vpFilterThreads ;
 }
 
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
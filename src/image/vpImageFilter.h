@@ -53,6 +53,7 @@
 #include <visp/vpImage.h>
 #include <visp/vpImageException.h>
 #include <visp/vpMatrix.h>
+#include <visp/vpColVector.h>
 #include <visp/vpMath.h>
 
 #include <fstream>
@@ -67,11 +68,45 @@
 
   \brief  Various image filter, convolution, etc...
 
+  The separable filters, such as the Gaussian and derivative ones, are
+  applied as a horizontal and a vertical 1D filter by sepFilter(), with
+  integer arithmetic for grey level images. The rows are split in bands
+  filtered in parallel when ViSP is built with OpenMP (see
+  setNumberOfThreads()). filter() uses them when the filter matrix is
+  separable.
+
+  The following example computes the gradient of an image used by
+  vpFeatureLuminance on the whole image, borders included:
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpImageFilter.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640, 128);
+  vpImage<double> dIx, dIy;
+
+  vpImageFilter::setNumberOfThreads(4);
+  vpImageFilter::getGradX(I, dIx);
+  vpImageFilter::getGradY(I, dIy);
+}
+  \endcode
 */
 class VISP_EXPORT vpImageFilter
 {
 
 public:
+  /*!
+    Method used by the filters to get the values of the pixels outside
+    the image.
+  */
+  typedef enum {
+    BORDER_ZERO,      /*!< The pixels outside the image are 0. */
+    BORDER_REPLICATE, /*!< Nearest pixel of the image: aa|abcd|dd. */
+    BORDER_REFLECT    /*!< Mirror without the border pixel: cb|abcd|cb. */
+  } vpBorderType;
+
   static void filter(const vpImage<double> &I,
 		     vpImage<double>& Iu,
 		     vpImage<double>& Iv,
@@ -82,6 +117,32 @@ public:
 		     vpImage<double>& If,
 		     const vpMatrix& M) ;
 
+  static bool isSeparable(const vpMatrix &M, vpColVector &kv, vpColVector &ku,
+                          const double threshold = 1e-9) ;
+
+  static void sepFilter(const vpImage<unsigned char> &I,
+                        vpImage<double> &If,
+                        const vpColVector &ku, const vpColVector &kv,
+                        const vpBorderType border = BORDER_REPLICATE) ;
+  static void sepFilter(const vpImage<unsigned char> &I,
+                        vpImage<double> &If,
+                        const int *ku, const unsigned int nu,
+                        const int *kv, const unsigned int nv,
+                        const double divisor,
+                        const vpBorderType border = BORDER_REPLICATE) ;
+
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx,
+                       const vpBorderType border = BORDER_REPLICATE) ;
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy,
+                       const vpBorderType border = BORDER_REPLICATE) ;
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float> &dIx,
+                       const vpBorderType border = BORDER_REPLICATE) ;
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float> &dIy,
+                       const vpBorderType border = BORDER_REPLICATE) ;
+
+  static void setNumberOfThreads(const unsigned int n) ;
+  static unsigned int getNumberOfThreads() ;
+
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
   static void canny(const vpImage<unsigned char>& I,
                     vpImage<unsigned char>& Ic,
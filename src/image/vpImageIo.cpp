@@ -47,6 +47,42 @@
 #include <visp/vpImage.h>
 #include <visp/vpImageIo.h>
 #include <visp/vpImageConvert.h> //image  conversion
+#include <visp/vpPNMReader.h>
+#include <visp/vpTime.h>
+#include <vector>
+
+#ifdef VISP_HAVE_OPENMP
+#  include <omp.h>
+#endif
+
+#if defined(VISP_HAVE_LIBJPEG)
+#  include <setjmp.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  unsigned int vpIoThreads = 1;
+
+  unsigned long vpNbBatchFiles = 0;
+  unsigned long vpNbBatchFailures = 0;
+  double vpBatchPixels = 0;
+  double vpBatchTime = 0;
+
+#if defined(VISP_HAVE_LIBJPEG)
+  // libjpeg error manager that returns to the caller instead of exiting
+  struct vpJpegErrorManager {
+    struct jpeg_error_mgr pub;
+    jmp_buf setjmpBuffer;
+  };
+
+  void vpJpegErrorExit(j_common_ptr cinfo)
+  {
+    vpJpegErrorManager *err = (vpJpegErrorManager *)cinfo->err;
+    longjmp(err->setjmpBuffer, 1);
+  }
+#endif
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 const int vpImageIo::vpMAX_LEN = 100;
 
@@ -449,6 +485,239 @@ vpImageIo::write(const vpImage<vpRGBa> &I, const std::string filename)
 {
   write(I,filename.c_str());
 }
+
+//--------------------------------------------------------------------------
+// Batch
+//--------------------------------------------------------------------------
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Run the read or write of each file of a batch, in parallel over the
+  // files. Each file is processed by a single thread, which only touches
+  // its own image and error slot.
+  template<class Image, class Op>
+  unsigned int runBatch(Image &I, const std::vector<std::string> &filenames,
+                        std::vector<std::string> &errors, Op op)
+  {
+    int n = (int)filenames.size();
+    errors.assign(filenames.size(), std::string());
+
+    double t = vpTime::measureTimeMs();
+    unsigned int nfailures = 0;
+    double npixels = 0;
+#ifdef VISP_HAVE_OPENMP
+    int nthreads = (int)vpIoThreads;
+    #pragma omp parallel for schedule(dynamic) num_threads(nthreads) if(nthreads > 1) reduction(+:nfailures, npixels)
+#endif
+    for (int i = 0; i < n; i++) {
+      try {
+        op(I[(unsigned int)i], filenames[(unsigned int)i]);
+        npixels += (double)I[(unsigned int)i].getWidth() * I[(unsigned int)i].getHeight();
+      }
+      catch(vpException &e) {
+        errors[(unsigned int)i] = e.getStringMessage();
+        nfailures++;
+      }
+      catch(...) {
+        errors[(unsigned int)i] = "unknown error";
+        nfailures++;
+      }
+    }
+
+    vpNbBatchFiles += filenames.size();
+    vpNbBatchFailures += nfailures;
+    vpBatchPixels += npixels;
+    vpBatchTime += vpTime::measureTimeMs() - t;
+    return nfailures;
+  }
+
+  struct vpReadOp {
+    template<class Type>
+    void operator()(vpImage<Type> &I, const std::string &filename) const
+    {
+      vpImageIo::read(I, filename);
+    }
+  };
+
+  struct vpWriteOp {
+    template<class Type>
+    void operator()(const vpImage<Type> &I, const std::string &filename) const
+    {
+      vpImageIo::write(I, filename);
+    }
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Read a batch of image files, in parallel when ViSP is built with OpenMP
+  (see setNumberOfThreads()).
+
+  Each file is read as read(vpImage<unsigned char> &, const std::string)
+  does, directly into its destination image, so that the memory used
+  besides the images is bounded by the number of threads. A file that
+  cannot be read does not stop the batch: its error message is stored
+  in \e errors. To import a very large set with a bounded memory, call
+  this function on successive slices of the file list with the same
+  vector of images, whose memory is then reused.
+
+  \param I : Read images. The vector is resized to the number of files.
+  \param filenames : Names of the files.
+  \param errors : Error message of each file, empty if the file was read.
+
+  \return The number of files that could not be read.
+
+  \sa getNbBatchFiles(), getBatchTime()
+*/
+unsigned int
+vpImageIo::read(std::vector<vpImage<unsigned char> > &I,
+                const std::vector<std::string> &filenames,
+                std::vector<std::string> &errors)
+{
+  I.resize(filenames.size());
+  return runBatch(I, filenames, errors, vpReadOp());
+}
+
+/*!
+  Read a batch of image files in color images, in parallel when ViSP is
+  built with OpenMP.
+
+  \sa read(std::vector<vpImage<unsigned char> > &, const std::vector<std::string> &, std::vector<std::string> &)
+*/
+unsigned int
+vpImageIo::read(std::vector<vpImage<vpRGBa> > &I,
+                const std::vector<std::string> &filenames,
+                std::vector<std::string> &errors)
+{
+  I.resize(filenames.size());
+  return runBatch(I, filenames, errors, vpReadOp());
+}
+
+/*!
+  Write a batch of images, in parallel when ViSP is built with OpenMP
+  (see setNumberOfThreads()). The format of each file is given by its
+  extension, as in write(const vpImage<unsigned char> &, const std::string).
+
+  A file that cannot be written does not stop the batch: its error
+  message is stored in \e errors.
+
+  \param I : Images to write.
+  \param filenames : Names of the files, one for each image.
+  \param errors : Error message of each file, empty if the file was
+  written.
+
+  \return The number of files that could not be written.
+
+  \exception vpException::dimensionError : If the numbers of images and
+  file names differ.
+*/
+unsigned int
+vpImageIo::write(const std::vector<vpImage<unsigned char> > &I,
+                 const std::vector<std::string> &filenames,
+                 std::vector<std::string> &errors)
+{
+  if (I.size() != filenames.size()) {
+    vpERROR_TRACE("%u images for %u file names", (unsigned int)I.size(), (unsigned int)filenames.size()) ;
+    throw (vpException(vpException::dimensionError,
+                       "the numbers of images and file names differ")) ;
+  }
+  return runBatch(I, filenames, errors, vpWriteOp());
+}
+
+/*!
+  Write a batch of color images, in parallel when ViSP is built with
+  OpenMP.
+
+  \sa write(const std::vector<vpImage<unsigned char> > &, const std::vector<std::string> &, std::vector<std::string> &)
+*/
+unsigned int
+vpImageIo::write(const std::vector<vpImage<vpRGBa> > &I,
+                 const std::vector<std::string> &filenames,
+                 std::vector<std::string> &errors)
+{
+  if (I.size() != filenames.size()) {
+    vpERROR_TRACE("%u images for %u file names", (unsigned int)I.size(), (unsigned int)filenames.size()) ;
+    throw (vpException(vpException::dimensionError,
+                       "the numbers of images and file names differ")) ;
+  }
+  return runBatch(I, filenames, errors, vpWriteOp());
+}
+
+/*!
+  Set the number of threads used by the batch read() and write()
+  functions. This setting is only effective when ViSP is built with
+  OpenMP.
+
+  \param n : Number of threads. 0 is considered as 1.
+*/
+void
+vpImageIo::setNumberOfThreads(const unsigned int n)
+{
+  vpIoThreads = (n == 0) ? 1 : n ;
+}
+
+/*!
+  \return The number of threads used by the batch read() and write()
+  functions.
+*/
+unsigned int
+vpImageIo::getNumberOfThreads()
+{
+  return vpIoThreads ;
+}
+
+/*!
+  \return The number of files processed by the batch read() and write()
+  functions since the last resetBatchCounters(), failed ones included.
+*/
+unsigned long
+vpImageIo::getNbBatchFiles()
+{
+  return vpNbBatchFiles ;
+}
+
+/*!
+  \return The number of files that the batch read() and write()
+  functions could not process since the last resetBatchCounters().
+*/
+unsigned long
+vpImageIo::getNbBatchFailures()
+{
+  return vpNbBatchFailures ;
+}
+
+/*!
+  \return The number of pixels of the images read or written by the
+  batch functions since the last resetBatchCounters().
+*/
+double
+vpImageIo::getBatchPixels()
+{
+  return vpBatchPixels ;
+}
+
+/*!
+  \return The time spent in the batch read() and write() functions
+  since the last resetBatchCounters(), in milliseconds. The throughput
+  is getNbBatchFiles() / getBatchTime() files per millisecond.
+*/
+double
+vpImageIo::getBatchTime()
+{
+  return vpBatchTime ;
+}
+
+/*!
+  Reset the counters of the batch functions.
+*/
+void
+vpImageIo::resetBatchCounters()
+{
+  vpNbBatchFiles = 0 ;
+  vpNbBatchFailures = 0 ;
+  vpBatchPixels = 0 ;
+  vpBatchTime = 0 ;
+}
 //--------------------------------------------------------------------------
 // PFM
 //--------------------------------------------------------------------------
@@ -489,11 +758,15 @@ vpImageIo::writePFM(const vpImage<float> &I,
   fprintf(fd, "%d %d\n", I.getWidth(), I.getHeight());	// Image size
   fprintf(fd, "255\n");					// Max level
 
-  // Write the bitmap
-  size_t ierr;
+  // Write the bitmap, row by row for a view
+  size_t ierr = 0;
   size_t nbyte = I.getWidth()*I.getHeight();
 
-  ierr = fwrite(I.bitmap, sizeof(float), nbyte, fd) ;
+  if (I.isContiguous())
+    ierr = fwrite(I.bitmap, sizeof(float), nbyte, fd) ;
+  else
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      ierr += fwrite(I[i], sizeof(float), I.getWidth(), fd) ;
   if (ierr != nbyte) {
     fclose(fd);
     vpERROR_TRACE("couldn't write %d bytes to file \"%s\"\n",
@@ -545,11 +818,15 @@ vpImageIo::writePGM(const vpImage<unsigned char> &I,
   fprintf(fd, "%d %d\n", I.getWidth(), I.getHeight());	// Image size
   fprintf(fd, "255\n");					// Max level
 
-  // Write the bitmap
-  size_t ierr;
+  // Write the bitmap, row by row for a view
+  size_t ierr = 0;
   size_t nbyte = I.getWidth()*I.getHeight();
 
-  ierr = fwrite(I.bitmap, sizeof(unsigned char), nbyte, fd) ;
+  if (I.isContiguous())
+    ierr = fwrite(I.bitmap, sizeof(unsigned char), nbyte, fd) ;
+  else
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      ierr += fwrite(I[i], sizeof(unsigned char), I.getWidth(), fd) ;
   if (ierr != nbyte) {
     fclose(fd);
     vpERROR_TRACE("couldn't write %d bytes to file \"%s\"\n",
@@ -578,8 +855,9 @@ vpImageIo::writePGM(const vpImage<short> &I, const char *filename)
 
   Iuc.resize(nrows, ncols);
 
-  for (unsigned int i=0 ; i < nrows * ncols ; i++)
-    Iuc.bitmap[i] =  (unsigned char)I.bitmap[i] ;
+  for (unsigned int i=0 ; i < nrows ; i++)
+    for (unsigned int j=0 ; j < ncols ; j++)
+      Iuc[i][j] =  (unsigned char)I[i][j] ;
 
   vpImageIo::writePGM(Iuc, filename) ;
 
@@ -788,8 +1066,15 @@ vpImageIo::readPFM(vpImage<float> &I, const char *filename)
           "error reading pfm file")) ;
   }
 
+  // Row by row for a view of the same size
   unsigned int nbyte = I.getHeight()*I.getWidth();
-  if (fread (I.bitmap, sizeof(float), nbyte, fd ) != nbyte)
+  size_t nread = 0;
+  if (I.isContiguous())
+    nread = fread (I.bitmap, sizeof(float), nbyte, fd );
+  else
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      nread += fread (I[i], sizeof(float), I.getWidth(), fd );
+  if (nread != nbyte)
   {
     fclose (fd);
     vpERROR_TRACE("couldn't read %d bytes in file \"%s\"\n", nbyte, filename) ;
@@ -815,6 +1100,11 @@ vpImageIo::readPFM(vpImage<float> &I, const char *filename)
   only if the new image size is different, else we re-use the same
   memory space.
 
+  The file is mapped in memory and its pixels are copied directly into
+  \e I (see vpPNMReader). To read a sequence of files, a vpPNMReader
+  also avoids parsing the same header for each file, and can make \e I
+  a view on the file without any copy.
+
   \param I : Image to set with the \e filename content.
   \param filename : Name of the file containing the image.
 
@@ -823,145 +1113,15 @@ vpImageIo::readPFM(vpImage<float> &I, const char *filename)
 void
 vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
 {
-  FILE* fd = NULL; // File descriptor
-  int   ierr;
-  int   line;
-  int   is255;
-  char* err ;
-  char  str[vpMAX_LEN];
-  unsigned int   w, h;
-
-  // Test the filename
-  if (filename == '\0')
-  {
-    vpERROR_TRACE("no filename") ;
-    throw (vpImageException(vpImageException::ioError,
-          " no filename")) ;
-
-  }
-
-  // Open the filename
-  fd = fopen(filename, "rb");
-  if (fd == NULL)
-  {
-    vpERROR_TRACE("couldn't read file \"%s\"", filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  // Read the first line with magic number P5
-  line = 0;
-
-  err = fgets(str, vpMAX_LEN - 1, fd);
-  line++;
-  if (err == NULL)
+  vpPNMReader reader ;
+  reader.open(filename) ;
+  if (reader.isColor())
   {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n",  line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  if (strlen(str) < 3)
-  {
-    fclose (fd);
     vpERROR_TRACE("\"%s\" is not a PGM file\n", filename) ;
     throw (vpImageException(vpImageException::ioError,
           "this is not a pgm file")) ;
   }
-
-  str[2] = '\0';
-  if (strcmp(str, "P5") != 0)
-  {
-    fclose (fd);
-    vpERROR_TRACE("\"%s\" is not a PGM file\n", filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "this is not a pgm file")) ;
-  }
-
-  // Jump the possible comment, or empty line and read the following line
-  do {
-    err = fgets(str, vpMAX_LEN - 1, fd);
-    line++;
-    if (err == NULL) {
-      fprintf(stderr, "couldn't read line %d of file \"%s\"\n", line, filename);
-      fclose (fd);
-    }
-  } while ((str[0] == '#') || (str[0] == '\n'));
-
-  // Extract image size
-  ierr = sscanf(str, "%d %d", &w, &h);
-  if(ierr == 1){// the norm allows to have the two values on two separated lines.
-    do {
-      err = fgets(str, vpMAX_LEN - 1, fd);
-      line++;
-      if (err == NULL) {
-        fprintf(stderr, "couldn't read line %d of file \"%s\"\n", line, filename);
-        fclose (fd);
-      }
-    } while ((str[0] == '#') || (str[0] == '\n'));
-    ierr = sscanf(str, "%d", &h);
-  }
-  if (ierr == EOF)
-  {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n",line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  if ((h != I.getHeight())||( w != I.getWidth()))
-  {
-
-    try
-    {
-      I.resize(h,w) ;
-    }
-    catch(...)
-    {
-      vpERROR_TRACE(" ") ;
-      throw ;
-    }
-  }
-
-  // Read 255
-  err = fgets(str, vpMAX_LEN - 1, fd);
-  line++;
-  if (err == NULL) {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n",line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  ierr = sscanf(str, "%d", &is255);
-  if (ierr == EOF) {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n", line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  if (is255 != 255)
-  {
-    fclose (fd);
-    vpERROR_TRACE("MAX_VAL is not 255 in file \"%s\"\n", filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "error reading pgm file")) ;
-  }
-
-  unsigned int nbyte = I.getHeight()*I.getWidth();
-  if (fread (I.bitmap, sizeof(unsigned char), nbyte, fd ) != nbyte)
-  {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read %d bytes in file \"%s\"\n", nbyte, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "error reading pgm file")) ;
-  }
-
-  fclose (fd);
-
-
+  reader.read(I) ;
 }
 
 
@@ -986,22 +1146,15 @@ vpImageIo::readPGM(vpImage<unsigned char> &I, const char *filename)
 void
 vpImageIo::readPGM(vpImage<vpRGBa> &I, const char *filename)
 {
-
-  try
+  vpPNMReader reader ;
+  reader.open(filename) ;
+  if (reader.isColor())
   {
-    vpImage<unsigned char> Itmp ;
-
-    vpImageIo::readPGM(Itmp, filename) ;
-
-
-    vpImageConvert::convert(Itmp, I) ;
-
-  }
-  catch(...)
-  {
-    vpERROR_TRACE(" ") ;
-    throw ;
+    vpERROR_TRACE("\"%s\" is not a PGM file\n", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+          "this is not a pgm file")) ;
   }
+  reader.read(I) ;
 }
 
 
@@ -1025,188 +1178,47 @@ vpImageIo::readPGM(vpImage<vpRGBa> &I, const char *filename)
   \param filename : Name of the file containing the image.
 
 */
-void
-vpImageIo::readPPM(vpImage<unsigned char> &I, const char *filename)
-{
-
-  try
-  {
-    vpImage<vpRGBa> Itmp ;
-
-    vpImageIo::readPPM(Itmp, filename) ;
-
-    vpImageConvert::convert(Itmp, I) ;
-  }
-  catch(...)
-  {
-    vpERROR_TRACE(" ") ;
-    throw ;
-  }
-}
-
-
-/*!
-  Read the contents of the portable pixmap (PPM P6) filename,
-  allocate memory for the corresponding vpRGBa image.
-
-  If the image has been already initialized, memory allocation is done
-  only if the new image size is different, else we re-use the same
-  memory space.
-
-  \param I : Image to set with the \e filename content.
-  \param filename : Name of the file containing the image.
-*/
-void
-vpImageIo::readPPM(vpImage<vpRGBa> &I, const char *filename)
-{
-
-  FILE* fd = NULL; // File descriptor
-  int   ierr;
-  int   line;
-  int   is255;
-  char* err ;
-  char  str[vpMAX_LEN];
-  unsigned int   w, h;
-
-  // Test the filename
-  if (filename == '\0')
-  {
-    vpERROR_TRACE("no filename") ;
-    throw (vpImageException(vpImageException::ioError,
-          " no filename")) ;
-
-  }
-
-  // Open the filename
-  fd = fopen(filename, "rb");
-  if (fd == NULL)
-  {
-    vpERROR_TRACE("couldn't read file \"%s\"", filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  // Read the first line with magic number P5
-  line = 0;
-
-  err = fgets(str, vpMAX_LEN - 1, fd);
-  line++;
-  if (err == NULL)
-  {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n",  line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
-
-  if (strlen(str) < 3)
-  {
-    fclose (fd);
-    vpERROR_TRACE("\"%s\" is not a PPM file\n", filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "this is not a ppm file")) ;
-  }
-
-  str[2] = '\0';
-  if (strcmp(str, "P6") != 0)
-  {
-    fclose (fd);
-    vpERROR_TRACE("\"%s\" is not a PPM file\n", filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "this is not a ppm file")) ;
-  }
-
-  // Jump the possible comment, or empty line and read the following line
-  do {
-    err = fgets(str, vpMAX_LEN - 1, fd);
-    line++;
-    if (err == NULL) {
-      fprintf(stderr, "couldn't read line %d of file \"%s\"\n", line, filename);
-      fclose (fd);
-    }
-  } while ((str[0] == '#') || (str[0] == '\n'));
-
-  // Extract image size
-  ierr = sscanf(str, "%d %d", &w, &h);
-  if(ierr == 1){// the norm allows to have the two values on two separated lines.
-    do {
-      err = fgets(str, vpMAX_LEN - 1, fd);
-      line++;
-      if (err == NULL) {
-        fprintf(stderr, "couldn't read line %d of file \"%s\"\n", line, filename);
-        fclose (fd);
-      }
-    } while ((str[0] == '#') || (str[0] == '\n'));
-    ierr = sscanf(str, "%d", &h);
-  }
-  if (ierr == EOF)
+void
+vpImageIo::readPPM(vpImage<unsigned char> &I, const char *filename)
+{
+  vpPNMReader reader ;
+  reader.open(filename) ;
+  if (! reader.isColor())
   {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n",line, filename) ;
+    vpERROR_TRACE("\"%s\" is not a PPM file\n", filename) ;
     throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
+          "this is not a ppm file")) ;
   }
+  reader.read(I) ;
+}
 
-  if ((h != I.getHeight())||( w != I.getWidth()))
-  {
 
-    try
-    {
-      I.resize(h,w) ;
-    }
-    catch(...)
-    {
-      vpERROR_TRACE(" ") ;
-      throw ;
-    }
-  }
+/*!
+  Read the contents of the portable pixmap (PPM P6) filename,
+  allocate memory for the corresponding vpRGBa image.
 
-  // Read 255
-  err = fgets(str, vpMAX_LEN - 1, fd);
-  line++;
-  if (err == NULL) {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n",line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
+  If the image has been already initialized, memory allocation is done
+  only if the new image size is different, else we re-use the same
+  memory space.
 
-  ierr = sscanf(str, "%d", &is255);
-  if (ierr == EOF) {
-    fclose (fd);
-    vpERROR_TRACE("couldn't read line %d of file \"%s\"\n", line, filename) ;
-    throw (vpImageException(vpImageException::ioError,
-          "couldn't read file")) ;
-  }
+  The file is mapped in memory and its pixels are converted directly
+  into \e I (see vpPNMReader).
 
-  if (is255 != 255)
+  \param I : Image to set with the \e filename content.
+  \param filename : Name of the file containing the image.
+*/
+void
+vpImageIo::readPPM(vpImage<vpRGBa> &I, const char *filename)
+{
+  vpPNMReader reader ;
+  reader.open(filename) ;
+  if (! reader.isColor())
   {
-    fclose (fd);
-    vpERROR_TRACE("MAX_VAL is not 255 in file \"%s\"\n", filename) ;
+    vpERROR_TRACE("\"%s\" is not a PPM file\n", filename) ;
     throw (vpImageException(vpImageException::ioError,
-          "error reading ppm file")) ;
-  }
-
-  for(unsigned int i=0;i<I.getHeight();i++)
-  {
-    for(unsigned int j=0;j<I.getWidth();j++)
-    {
-      vpRGBa v ;
-      size_t res = fread(&v.R,sizeof(v.R),1,fd) ;
-      res |= fread(&v.G,sizeof(v.G),1,fd) ;
-      res |= fread(&v.B,sizeof(v.B),1,fd) ;
-      if (res==0)
-      {
-   fclose (fd);
-   vpERROR_TRACE("couldn't read  bytes in file \"%s\"\n", filename) ;
-   throw (vpImageException(vpImageException::ioError,
-         "error reading ppm file")) ;
-      }
-      I[i][j] = v ;
-    }
+          "this is not a ppm file")) ;
   }
-  fclose(fd) ;
-
+  reader.read(I) ;
 }
 
 /*!
@@ -1223,19 +1235,46 @@ void
 vpImageIo::writePPM(const vpImage<unsigned char> &I, const char *filename)
 {
 
-  try
-  {
-    vpImage<vpRGBa> Itmp ;
+  FILE* f;
+
+  // Test the filename
+  if ((filename == NULL) || (*filename == '\0'))   {
+     vpERROR_TRACE("no filename\n");
+    throw (vpImageException(vpImageException::ioError,
+           "no filename")) ;
+  }
 
-    vpImageConvert::convert(I, Itmp) ;
+  f = fopen(filename, "wb");
 
-    vpImageIo::writePPM(Itmp, filename) ;
+  if (f == NULL) {
+     vpERROR_TRACE("couldn't write to file \"%s\"\n",  filename);
+     throw (vpImageException(vpImageException::ioError,
+           "cannot write file")) ;
   }
-  catch(...)
+
+  fprintf(f,"P6\n");			         // Magic number
+  fprintf(f,"%d %d\n", I.getWidth(), I.getHeight());	// Image size
+  fprintf(f,"%d\n",255);	        	// Max level
+
+  // Convert and write the image row by row
+  std::vector<unsigned char> rgb(3*I.getWidth()) ;
+  for(unsigned int i=0;i<I.getHeight();i++)
   {
-    vpERROR_TRACE(" ") ;
-    throw ;
+    if (I.getWidth() == 0)
+      break;
+    vpImageConvert::GreyToRGB((unsigned char *)I[i], &rgb[0], I.getWidth()) ;
+    size_t res = fwrite(&rgb[0], sizeof(unsigned char), rgb.size(), f) ;
+    if (res != rgb.size())
+    {
+      fclose(f);
+      vpERROR_TRACE("couldn't write file") ;
+      throw (vpImageException(vpImageException::ioError,
+            "cannot write file")) ;
+    }
   }
+
+  fflush(f);
+  fclose(f);
 }
 
 
@@ -1274,41 +1313,20 @@ vpImageIo::writePPM(const vpImage<vpRGBa> &I, const char *filename)
   fprintf(f,"%d %d\n", I.getWidth(), I.getHeight());	// Image size
   fprintf(f,"%d\n",255);	        	// Max level
 
+  // Convert and write the image row by row
+  std::vector<unsigned char> rgb(3*I.getWidth()) ;
   for(unsigned int i=0;i<I.getHeight();i++)
   {
-    for(unsigned int j=0;j<I.getWidth();j++)
+    if (I.getWidth() == 0)
+      break;
+    vpImageConvert::RGBaToRGB((unsigned char *)I[i], &rgb[0], I.getWidth()) ;
+    size_t res = fwrite(&rgb[0], sizeof(unsigned char), rgb.size(), f) ;
+    if (res != rgb.size())
     {
-      vpRGBa P ;
-      size_t res ;
-      P = I[i][j] ;
-      unsigned char   tmp ;
-      tmp = P.R ;
-      res = fwrite(&tmp,sizeof(tmp),1,f) ;
-      if (res==0)
-      {
-  fclose(f);
-  vpERROR_TRACE("couldn't write file") ;
-  throw (vpImageException(vpImageException::ioError,
-        "cannot write file")) ;
-      }
-      tmp = P.G;
-      res = fwrite(&tmp,sizeof(tmp),1,f) ;
-      if (res==0)
-      {
-  fclose(f);
-  vpERROR_TRACE("couldn't write file") ;
-  throw (vpImageException(vpImageException::ioError,
-        "cannot write file")) ;
-      }
-      tmp = P.B ;
-      res = fwrite(&tmp,sizeof(tmp),1,f) ;
-      if (res==0)
-      {
-  fclose(f);
-  vpERROR_TRACE("couldn't write file") ;
-  throw (vpImageException(vpImageException::ioError,
-        "cannot write file")) ;
-      }
+      fclose(f);
+      vpERROR_TRACE("couldn't write file") ;
+      throw (vpImageException(vpImageException::ioError,
+            "cannot write file")) ;
     }
   }
 
@@ -1533,9 +1551,10 @@ vpImageIo::writeJPEG(const vpImage<unsigned char> &I, const char *filename)
 
   unsigned char *line;
   line = new unsigned char[width];
-  unsigned char* input = (unsigned char*)I.bitmap;
   while (cinfo.next_scanline < cinfo.image_height)
   {
+    // The rows of a view are not contiguous
+    unsigned char* input = (unsigned char*)I[cinfo.next_scanline];
     for (unsigned int i = 0; i < width; i++)
     {
       line[i] = *(input);
@@ -1612,9 +1631,10 @@ vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const char *filename)
 
   unsigned char *line;
   line = new unsigned char[3*width];
-  unsigned char* input = (unsigned char*)I.bitmap;
   while (cinfo.next_scanline < cinfo.image_height)
   {
+    // The rows of a view are not contiguous
+    unsigned char* input = (unsigned char*)I[cinfo.next_scanline];
     for (unsigned int i = 0; i < width; i++)
     {
       line[i*3] = *(input); input++;
@@ -1646,91 +1666,211 @@ vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const std::string filename)
 }
 
 
-/*!
-  Read the contents of the JPEG file, allocate memory
-  for the corresponding gray level image, if necessary convert the data in gray level, and
-  set the bitmap whith the gray level data. That means that the image \e I is a
-  "black and white" rendering of the original image in \e filename, as in a
-  black and white photograph. If necessary, the quantization formula used is \f$0,299 r +
-  0,587 g + 0,114 b\f$.
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Decode a JPEG file in a grey level image. Ic receives the pixels of a
+    color file before their conversion. It is given by the caller, since
+    the automatic variables modified after setjmp() are indeterminate
+    when libjpeg returns there after an error.
+  */
+  void vpReadJpeg(vpImage<unsigned char> &I, vpImage<vpRGBa> &Ic, const char *filename)
+  {
+    struct jpeg_decompress_struct cinfo;
+    vpJpegErrorManager jerr;
+    FILE *file;
 
-  If the image has been already initialized, memory allocation is done
-  only if the new image size is different, else we re-use the same
-  memory space.
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = vpJpegErrorExit;
+    jpeg_create_decompress(&cinfo);
 
-  \param I : Image to set with the \e filename content.
-  \param filename : Name of the file containing the image.
+    // Test the filename
+    if ((filename == NULL) || (*filename == '\0'))   {
+       vpERROR_TRACE("no filename\n");
+      throw (vpImageException(vpImageException::ioError,
+             "no filename")) ;
+    }
 
-*/
-void
-vpImageIo::readJPEG(vpImage<unsigned char> &I, const char *filename)
-{
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-  FILE *file;
+    file = fopen(filename, "rb");
 
-  cinfo.err = jpeg_std_error(&jerr);
-  jpeg_create_decompress(&cinfo);
+    if (file == NULL) {
+       vpERROR_TRACE("couldn't read file \"%s\"\n",  filename);
+       throw (vpImageException(vpImageException::ioError,
+             "cannot read file")) ;
+    }
 
-  // Test the filename
-  if (filename == '\0')   {
-     vpERROR_TRACE("no filename\n");
-    throw (vpImageException(vpImageException::ioError,
-           "no filename")) ;
-  }
+    // A corrupted file makes libjpeg return here
+    if (setjmp(jerr.setjmpBuffer)) {
+      char message[JMSG_LENGTH_MAX];
+      (*cinfo.err->format_message)((j_common_ptr)&cinfo, message);
+      jpeg_destroy_decompress(&cinfo);
+      fclose(file);
+      vpERROR_TRACE("couldn't decode file \"%s\": %s\n", filename, message);
+      throw (vpImageException(vpImageException::ioError,
+             "cannot decode file")) ;
+    }
 
-  file = fopen(filename, "rb");
+    jpeg_stdio_src(&cinfo, file);
+    jpeg_read_header(&cinfo, TRUE);
 
-  if (file == NULL) {
-     vpERROR_TRACE("couldn't read file \"%s\"\n",  filename);
-     throw (vpImageException(vpImageException::ioError,
-           "cannot read file")) ;
-  }
+    unsigned int width = cinfo.image_width;
+    unsigned int height = cinfo.image_height;
 
-  jpeg_stdio_src(&cinfo, file);
-  jpeg_read_header(&cinfo, TRUE);
+    if ( (width != I.getWidth()) || (height != I.getHeight()) )
+      I.resize(height,width);
 
-  unsigned int width = cinfo.image_width;
-  unsigned int height = cinfo.image_height;
+    jpeg_start_decompress(&cinfo);
 
-  if ( (width != I.getWidth()) || (height != I.getHeight()) )
-    I.resize(height,width);
+    unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
+    JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)
+                        ((j_common_ptr) &cinfo, JPOOL_IMAGE, rowbytes, 1);
 
-  jpeg_start_decompress(&cinfo);
-
-  unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
-  JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)
-                      ((j_common_ptr) &cinfo, JPOOL_IMAGE, rowbytes, 1);
-
-  if (cinfo.out_color_space == JCS_RGB) {
-    vpImage<vpRGBa> Ic(height,width);
-    unsigned char* output = (unsigned char*)Ic.bitmap;
-    while (cinfo.output_scanline<cinfo.output_height)	{
-      jpeg_read_scanlines(&cinfo,buffer,1);
-      for (unsigned int i = 0; i < width; i++) {
-        *(output++) = buffer[0][i*3];
-        *(output++) = buffer[0][i*3+1];
-        *(output++) = buffer[0][i*3+2];
-	*(output++) = 0;
+    if (cinfo.out_color_space == JCS_RGB) {
+      Ic.resize(height,width);
+      unsigned char* output = (unsigned char*)Ic.bitmap;
+      while (cinfo.output_scanline<cinfo.output_height)	{
+        jpeg_read_scanlines(&cinfo,buffer,1);
+        for (unsigned int i = 0; i < width; i++) {
+          *(output++) = buffer[0][i*3];
+          *(output++) = buffer[0][i*3+1];
+          *(output++) = buffer[0][i*3+2];
+  	*(output++) = 0;
+        }
       }
+      vpImageConvert::convert(Ic,I) ;
     }
-    vpImageConvert::convert(Ic,I) ;
+
+    else if (cinfo.out_color_space == JCS_GRAYSCALE)
+    {
+      unsigned int row;
+      while (cinfo.output_scanline<cinfo.output_height)
+      {
+        row = cinfo.output_scanline;
+        jpeg_read_scanlines(&cinfo,buffer,1);
+        memcpy(I[row], buffer[0], rowbytes);
+      }
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(file);
   }
 
-  else if (cinfo.out_color_space == JCS_GRAYSCALE)
+  /*
+    Decode a JPEG file in a color image. Ig receives the pixels of a grey
+    level file before their conversion, for the same reason as above.
+  */
+  void vpReadJpeg(vpImage<vpRGBa> &I, vpImage<unsigned char> &Ig, const char *filename)
   {
-    unsigned int row;
-    while (cinfo.output_scanline<cinfo.output_height)
+    struct jpeg_decompress_struct cinfo;
+    vpJpegErrorManager jerr;
+    FILE *file;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = vpJpegErrorExit;
+    jpeg_create_decompress(&cinfo);
+
+    // Test the filename
+    if ((filename == NULL) || (*filename == '\0'))   {
+       vpERROR_TRACE("no filename\n");
+      throw (vpImageException(vpImageException::ioError,
+             "no filename")) ;
+    }
+
+    file = fopen(filename, "rb");
+
+    if (file == NULL) {
+       vpERROR_TRACE("couldn't read file \"%s\"\n",  filename);
+       throw (vpImageException(vpImageException::ioError,
+             "cannot read file")) ;
+    }
+
+    // A corrupted file makes libjpeg return here
+    if (setjmp(jerr.setjmpBuffer)) {
+      char message[JMSG_LENGTH_MAX];
+      (*cinfo.err->format_message)((j_common_ptr)&cinfo, message);
+      jpeg_destroy_decompress(&cinfo);
+      fclose(file);
+      vpERROR_TRACE("couldn't decode file \"%s\": %s\n", filename, message);
+      throw (vpImageException(vpImageException::ioError,
+             "cannot decode file")) ;
+    }
+
+    jpeg_stdio_src(&cinfo, file);
+
+    jpeg_read_header(&cinfo, TRUE);
+
+    unsigned int width = cinfo.image_width;
+    unsigned int height = cinfo.image_height;
+
+    if ( (width != I.getWidth()) || (height != I.getHeight()) )
+      I.resize(height,width);
+
+    jpeg_start_decompress(&cinfo);
+
+    unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
+    JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)
+                        ((j_common_ptr) &cinfo, JPOOL_IMAGE, rowbytes, 1);
+
+    if (cinfo.out_color_space == JCS_RGB)
+    {
+      while (cinfo.output_scanline<cinfo.output_height)
+      {
+        // Row by row, I can be a view of the same size
+        unsigned char* output = (unsigned char*)I[cinfo.output_scanline];
+        jpeg_read_scanlines(&cinfo,buffer,1);
+        for (unsigned int i = 0; i < width; i++) {
+          *(output++) = buffer[0][i*3];
+          *(output++) = buffer[0][i*3+1];
+          *(output++) = buffer[0][i*3+2];
+  	*(output++) = 0;
+        }
+      }
+    }
+
+    else if (cinfo.out_color_space == JCS_GRAYSCALE)
     {
-      row = cinfo.output_scanline;
-      jpeg_read_scanlines(&cinfo,buffer,1);
-      memcpy(I[row], buffer[0], rowbytes);
+      Ig.resize(height,width);
+
+      unsigned int row;
+      while (cinfo.output_scanline<cinfo.output_height)
+      {
+        row = cinfo.output_scanline;
+        jpeg_read_scanlines(&cinfo,buffer,1);
+        memcpy(Ig[row], buffer[0], rowbytes);
+      }
+
+      vpImageConvert::convert(Ig,I) ;
     }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(file);
   }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
-  jpeg_finish_decompress(&cinfo);
-  jpeg_destroy_decompress(&cinfo);
-  fclose(file);
+/*!
+  Read the contents of the JPEG file, allocate memory
+  for the corresponding gray level image, if necessary convert the data in gray level, and
+  set the bitmap whith the gray level data. That means that the image \e I is a
+  "black and white" rendering of the original image in \e filename, as in a
+  black and white photograph. If necessary, the quantization formula used is \f$0,299 r +
+  0,587 g + 0,114 b\f$.
+
+  If the image has been already initialized, memory allocation is done
+  only if the new image size is different, else we re-use the same
+  memory space.
+
+  \param I : Image to set with the \e filename content.
+  \param filename : Name of the file containing the image.
+
+*/
+void
+vpImageIo::readJPEG(vpImage<unsigned char> &I, const char *filename)
+{
+  vpImage<vpRGBa> Ic;
+  vpReadJpeg(I, Ic, filename);
 }
 
 
@@ -1778,77 +1918,8 @@ vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string filename)
 void
 vpImageIo::readJPEG(vpImage<vpRGBa> &I, const char *filename)
 {
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-  FILE *file;
-
-  cinfo.err = jpeg_std_error(&jerr);
-  jpeg_create_decompress(&cinfo);
-
-  // Test the filename
-  if (filename == '\0')   {
-     vpERROR_TRACE("no filename\n");
-    throw (vpImageException(vpImageException::ioError,
-           "no filename")) ;
-  }
-
-  file = fopen(filename, "rb");
-
-  if (file == NULL) {
-     vpERROR_TRACE("couldn't read file \"%s\"\n",  filename);
-     throw (vpImageException(vpImageException::ioError,
-           "cannot read file")) ;
-  }
-
-  jpeg_stdio_src(&cinfo, file);
-
-  jpeg_read_header(&cinfo, TRUE);
-
-  unsigned int width = cinfo.image_width;
-  unsigned int height = cinfo.image_height;
-
-  if ( (width != I.getWidth()) || (height != I.getHeight()) )
-    I.resize(height,width);
-
-  jpeg_start_decompress(&cinfo);
-
-  unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
-  JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)
-                      ((j_common_ptr) &cinfo, JPOOL_IMAGE, rowbytes, 1);
-
-  if (cinfo.out_color_space == JCS_RGB)
-  {
-    unsigned char* output = (unsigned char*)I.bitmap;
-    while (cinfo.output_scanline<cinfo.output_height)
-    {
-      jpeg_read_scanlines(&cinfo,buffer,1);
-      for (unsigned int i = 0; i < width; i++) {
-        *(output++) = buffer[0][i*3];
-        *(output++) = buffer[0][i*3+1];
-        *(output++) = buffer[0][i*3+2];
-	*(output++) = 0;
-      }
-    }
-  }
-
-  else if (cinfo.out_color_space == JCS_GRAYSCALE)
-  {
-    vpImage<unsigned char> Ig(height,width);
-
-    unsigned int row;
-    while (cinfo.output_scanline<cinfo.output_height)
-    {
-      row = cinfo.output_scanline;
-      jpeg_read_scanlines(&cinfo,buffer,1);
-      memcpy(Ig[row], buffer[0], rowbytes);
-    }
-
-    vpImageConvert::convert(Ig,I) ;
-  }
-
-  jpeg_finish_decompress(&cinfo);
-  jpeg_destroy_decompress(&cinfo);
-  fclose(file);
+  vpImage<unsigned char> Ig;
+  vpReadJpeg(I, Ig, filename);
 }
 
 
@@ -2145,10 +2216,10 @@ vpImageIo::writePNG(const vpImage<unsigned char> &I, const char *filename)
   for (unsigned int i = 0; i < height; i++)
     row_ptrs[i] = new png_byte[width];
 
-  unsigned char* input = (unsigned char*)I.bitmap;
-
   for (unsigned int i = 0; i < height; i++)
   {
+    // The rows of a view are not contiguous
+    unsigned char* input = (unsigned char*)I[i];
     png_byte* row = row_ptrs[i];
     for(unsigned int j = 0; j < width; j++)
     {
@@ -2283,10 +2354,10 @@ vpImageIo::writePNG(const vpImage<vpRGBa> &I, const char *filename)
   for (unsigned int i = 0; i < height; i++)
     row_ptrs[i] = new png_byte[3*width];
 
-  unsigned char* input = (unsigned char*)I.bitmap;;
-
   for (unsigned int i = 0; i < height; i++)
   {
+    // The rows of a view are not contiguous
+    unsigned char* input = (unsigned char*)I[i];
     png_byte* row = row_ptrs[i];
     for(unsigned int j = 0; j < width; j++)
     {
@@ -2490,18 +2561,21 @@ vpImageIo::readPNG(vpImage<unsigned char> &I, const char *filename)
 
   switch (channels)
   {
+  // Row by row, I can be a view of the same size
   case 1:
-    output = (unsigned char*)I.bitmap;
-    for (unsigned int i = 0; i < width*height; i++)
+    for (unsigned int i = 0; i < height; i++)
       {
-        *(output++) = data[i];
+        output = (unsigned char*)I[i];
+        for (unsigned int j = i*width; j < (i+1)*width; j++)
+          *(output++) = data[j];
       }
     break;
   case 2:
-    output = (unsigned char*)I.bitmap;
-    for (unsigned int i = 0; i < width*height; i++)
+    for (unsigned int i = 0; i < height; i++)
       {
-        *(output++) = data[i*2];
+        output = (unsigned char*)I[i];
+        for (unsigned int j = i*width; j < (i+1)*width; j++)
+          *(output++) = data[j*2];
       }
     break;
   case 3:
@@ -2717,25 +2791,31 @@ vpImageIo::readPNG(vpImage<vpRGBa> &I, const char *filename)
       }
     vpImageConvert::convert(Ig,I) ;
     break;
+  // Row by row, I can be a view of the same size
   case 3:
-
-    output = (unsigned char*)I.bitmap;
-      for (unsigned int i = 0; i < width*height; i++)
+    for (unsigned int i = 0; i < height; i++)
       {
-        *(output++) = data[i*3];
-        *(output++) = data[i*3+1];
-        *(output++) = data[i*3+2];
-        *(output++) = 0;
+        output = (unsigned char*)I[i];
+        for (unsigned int j = i*width; j < (i+1)*width; j++)
+          {
+            *(output++) = data[j*3];
+            *(output++) = data[j*3+1];
+            *(output++) = data[j*3+2];
+            *(output++) = 0;
+          }
       }
     break;
   case 4:
-    output = (unsigned char*)I.bitmap;
-      for (unsigned int i = 0; i < width*height; i++)
+    for (unsigned int i = 0; i < height; i++)
       {
-        *(output++) = data[i*4];
-        *(output++) = data[i*4+1];
-        *(output++) = data[i*4+2];
-        *(output++) = data[i*4+3];
+        output = (unsigned char*)I[i];
+        for (unsigned int j = i*width; j < (i+1)*width; j++)
+          {
+            *(output++) = data[j*4];
+            *(output++) = data[j*4+1];
+            *(output++) = data[j*4+2];
+            *(output++) = data[j*4+3];
+          }
       }
     break;
   }
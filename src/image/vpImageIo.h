@@ -55,6 +55,8 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #ifdef WIN32
 #  include <windows.h>
@@ -97,6 +99,37 @@ int main()
 
   vpImageIo::read(I, filename); // Convert the color image in a gray level image
   vpImageIo::write(I, "Klimt.pgm"); // Write the image in a PGM P5 image file format 
+}
+  \endcode
+
+  Sets of images can be read or written in parallel with the batch
+  versions of read() and write(), which report the errors file by file:
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <iostream>
+#include <stdio.h>
+
+int main()
+{
+  std::vector<std::string> filenames;
+  for (int i = 0; i < 1000; i++) {
+    char name[FILENAME_MAX];
+    sprintf(name, "/tmp/image%04d.jpg", i);
+    filenames.push_back(name);
+  }
+
+  vpImageIo::setNumberOfThreads(4);
+  std::vector<vpImage<unsigned char> > I;
+  std::vector<std::string> errors;
+  if (vpImageIo::read(I, filenames, errors) > 0) {
+    for (unsigned int i = 0; i < errors.size(); i++)
+      if (! errors[i].empty())
+        std::cout << filenames[i] << ": " << errors[i] << std::endl;
+  }
+  std::cout << vpImageIo::getNbBatchFiles() / vpImageIo::getBatchTime() * 1000.
+            << " images per second" << std::endl;
 }
   \endcode
 */
@@ -147,6 +180,32 @@ public:
   static
   void write(const vpImage<vpRGBa> &I, const std::string filename) ;
 
+  static
+  unsigned int read(std::vector<vpImage<unsigned char> > &I,
+                    const std::vector<std::string> &filenames,
+                    std::vector<std::string> &errors) ;
+  static
+  unsigned int read(std::vector<vpImage<vpRGBa> > &I,
+                    const std::vector<std::string> &filenames,
+                    std::vector<std::string> &errors) ;
+  static
+  unsigned int write(const std::vector<vpImage<unsigned char> > &I,
+                     const std::vector<std::string> &filenames,
+                     std::vector<std::string> &errors) ;
+  static
+  unsigned int write(const std::vector<vpImage<vpRGBa> > &I,
+                     const std::vector<std::string> &filenames,
+                     std::vector<std::string> &errors) ;
+
+  static void setNumberOfThreads(const unsigned int n) ;
+  static unsigned int getNumberOfThreads() ;
+
+  static unsigned long getNbBatchFiles() ;
+  static unsigned long getNbBatchFailures() ;
+  static double getBatchPixels() ;
+  static double getBatchTime() ;
+  static void resetBatchCounters() ;
+
  static
   void readPFM(vpImage<float> &I, const char *filename) ;
 
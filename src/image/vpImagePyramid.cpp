@@ -0,0 +1,261 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Image pyramid reusing its buffers from one image to the next.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImagePyramid.cpp
+  \brief Image pyramid that keeps its levels allocated between frames.
+*/
+
+#include <visp/vpImagePyramid.h>
+#include <visp/vpImageException.h>
+#include <visp/vpDebug.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  inline unsigned int clampIndex(int i, unsigned int n)
+  {
+    if (i < 0) return 0;
+    if (i >= (int)n) return n - 1;
+    return (unsigned int)i;
+  }
+
+  /*
+    Filter the row src of width w with the kernel (1 4 6 4 1) and keep
+    one value over two in dst of width w/2. Values are scaled by 16.
+  */
+  void reduceRow(const unsigned char *src, unsigned int w,
+                 unsigned short *dst, unsigned int n)
+  {
+    for (unsigned int l = 0; l < n; l++) {
+      unsigned int c = 2*l;
+      if (c >= 2 && c + 2 < w) {
+        const unsigned char *p = src + c;
+        dst[l] = (unsigned short)(p[-2] + p[2] + 4*(p[-1] + p[1]) + 6*p[0]);
+      }
+      else {
+        dst[l] = (unsigned short)(src[clampIndex((int)c-2, w)]
+                                  + src[clampIndex((int)c+2, w)]
+                                  + 4*(src[clampIndex((int)c-1, w)]
+                                       + src[clampIndex((int)c+1, w)])
+                                  + 6*src[c]);
+      }
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor.
+
+  \param _type : Method used to compute a level from the previous one.
+*/
+vpImagePyramid::vpImagePyramid(const vpReductionType _type)
+  : type(_type), nthreads(1), levels(), buffers(), tmp()
+{
+}
+
+/*!
+  Destructor that frees the images of the levels.
+*/
+vpImagePyramid::~vpImagePyramid()
+{
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    if (buffers[i] != NULL) {
+      delete buffers[i];
+      buffers[i] = NULL;
+    }
+  }
+}
+
+/*!
+  Set the number of threads used to compute the levels. This setting is
+  only effective when ViSP is built with OpenMP.
+
+  \param n : Number of threads. 0 is considered as 1.
+*/
+void vpImagePyramid::setNumberOfThreads(const unsigned int n)
+{
+  nthreads = (n == 0) ? 1 : n;
+}
+
+/*!
+  Compute the \e nbLevels first levels of the pyramid of \e I.
+
+  \param I : Input image, used as level 0.
+  \param nbLevels : Number of levels to compute.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I,
+                           const unsigned int nbLevels)
+{
+  build(I, std::vector<bool>(nbLevels, true));
+}
+
+/*!
+  Compute the levels of the pyramid of \e I. Level \e i is computed
+  only if \e levels[i] is true. The other levels are set to NULL
+  unless they are needed by the Gaussian reduction to compute the next
+  levels.
+
+  \param I : Input image, used as level 0.
+  \param _levels : Levels to compute.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I,
+                           const std::vector<bool> &_levels)
+{
+  unsigned int n = (unsigned int)_levels.size();
+  // Last requested level
+  unsigned int last = n;
+  while (last > 0 && !_levels[last-1]) last--;
+
+  levels.resize(n);
+  for (unsigned int i = 0; i < n; i++) {
+    bool needed = _levels[i] || (type == GAUSSIAN && i < last);
+    levels[i] = NULL;
+    if (! needed) continue;
+    if (i == 0) {
+      levels[0] = &I;
+      continue;
+    }
+    if (buffers.size() < i) {
+      buffers.resize(i, NULL);
+    }
+    if (buffers[i-1] == NULL) {
+      buffers[i-1] = new vpImage<unsigned char>;
+    }
+    // No allocation if the size did not change since the previous image
+    buffers[i-1]->resize(I.getHeight() >> i, I.getWidth() >> i);
+    levels[i] = buffers[i-1];
+  }
+  if (type == GAUSSIAN && n > 1) {
+    tmp.resize(I.getHeight() * (I.getWidth() >> 1));
+  }
+
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+#endif
+  {
+    for (unsigned int i = 1; i < n; i++) {
+      if (levels[i] == NULL) continue;
+      vpImage<unsigned char> &L = *buffers[i-1];
+      int h = (int)L.getHeight();
+      unsigned int w = L.getWidth();
+
+      if (type == DECIMATION) {
+        unsigned int step = 1u << i;
+#ifdef VISP_HAVE_OPENMP
+        #pragma omp for nowait
+#endif
+        for (int k = 0; k < h; k++) {
+          const unsigned char *src = I[(unsigned int)k * step];
+          unsigned char *dst = L[k];
+          for (unsigned int l = 0, jj = 0; l < w; l++, jj += step) {
+            dst[l] = src[jj];
+          }
+        }
+      }
+      else {
+        const vpImage<unsigned char> &P = *levels[i-1];
+        int hp = (int)P.getHeight();
+        unsigned int wp = P.getWidth();
+        // Horizontal filtering of all the rows of the previous level
+#ifdef VISP_HAVE_OPENMP
+        #pragma omp for
+#endif
+        for (int k = 0; k < hp; k++) {
+          reduceRow(P[k], wp, &tmp[(unsigned int)k * w], w);
+        }
+        // Vertical filtering of one row over two
+#ifdef VISP_HAVE_OPENMP
+        #pragma omp for
+#endif
+        for (int k = 0; k < h; k++) {
+          const unsigned short *r[5];
+          for (int d = 0; d < 5; d++) {
+            r[d] = &tmp[clampIndex(2*k+d-2, (unsigned int)hp) * w];
+          }
+          unsigned char *dst = L[k];
+          for (unsigned int l = 0; l < w; l++) {
+            unsigned int s = r[0][l] + r[4][l] + 4u*(r[1][l] + r[3][l])
+              + 6u*r[2][l];
+            dst[l] = (unsigned char)((s + 128) >> 8);
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!
+  \param level : Level of the pyramid.
+
+  \return A pointer to the image of the level, or NULL if this level was
+  not computed by the last call to build().
+*/
+const vpImage<unsigned char> *
+vpImagePyramid::getLevel(const unsigned int level) const
+{
+  if (level >= levels.size()) {
+    return NULL;
+  }
+  return levels[level];
+}
+
+/*!
+  \param level : Level of the pyramid.
+
+  \return The image of the level.
+
+  \exception vpImageException::notInitializedError : If the level was
+  not computed by the last call to build().
+*/
+const vpImage<unsigned char> &
+vpImagePyramid::operator[](const unsigned int level) const
+{
+  if (! isBuilt(level)) {
+    vpERROR_TRACE("Level %d of the pyramid is not computed", level) ;
+    throw (vpImageException(vpImageException::notInitializedError,
+                            "Level of the pyramid not computed")) ;
+  }
+  return *levels[level];
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,183 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Image pyramid reusing its buffers from one image to the next.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpImagePyramid_H
+#define vpImagePyramid_H
+
+/*!
+  \file vpImagePyramid.h
+
+  \brief Image pyramid that keeps its levels allocated between frames.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+
+#include <vector>
+
+/*!
+  \class vpImagePyramid
+
+  \ingroup ImageTool
+
+  \brief Pyramid of grey level images whose buffers are reused from one
+  image to the next.
+
+  Level 0 is the input image itself and is not copied. Level \e i has a
+  size of \f$ h/2^i \times w/2^i \f$ where \f$ h \times w \f$ is the size
+  of the input image. The images of the other levels are allocated the
+  first time they are needed and are then reused by the next calls to
+  build() as long as the size of the input image does not change.
+
+  Two reductions are available:
+  - vpImagePyramid::DECIMATION: level \e i is obtained by taking one
+    pixel every \f$ 2^i \f$ pixels of the input image, without any
+    smoothing. This is the behavior of vpImage::halfSizeImage() and the
+    fastest reduction. Only the requested levels are computed.
+  - vpImagePyramid::GAUSSIAN: level \e i is obtained by filtering level
+    \e i-1 with a 5x5 separable binomial kernel (1 4 6 4 1)/16 before
+    taking one pixel over two. This avoids aliasing but requires the
+    computation of all the levels below the last requested one.
+
+  The rows of the levels are computed in parallel when ViSP is built
+  with OpenMP (see setNumberOfThreads()). With the decimation, a thread
+  that is done with a level goes on with the next one without waiting
+  for the others.
+
+  The pyramid only gives read access to its levels, so that a single
+  pyramid built once per frame can be shared by several consumers, for
+  example a model-based tracker, a KLT tracker and a blob search. The
+  pyramid built by vpMbEdgeTracker can be accessed with
+  vpMbEdgeTracker::getPyramid().
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpImagePyramid.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpImagePyramid pyramid(vpImagePyramid::GAUSSIAN);
+
+  for ( ; ; ) {
+    // acquire a new image in I
+    pyramid.build(I, 3); // levels 0, 1 and 2
+    const vpImage<unsigned char> &I2 = pyramid[2]; // 120 x 160 image
+  }
+}
+  \endcode
+
+  \warning As level 0 is a pointer to the input image, the input image
+  has to exist and not be resized as long as the pyramid is used.
+*/
+class VISP_EXPORT vpImagePyramid
+{
+public:
+  /*!
+    Method used to compute a level from the previous one.
+  */
+  typedef enum {
+    DECIMATION, /*!< Subsampling without smoothing. */
+    GAUSSIAN    /*!< Binomial 5x5 smoothing before subsampling. */
+  } vpReductionType;
+
+  vpImagePyramid(const vpReductionType type = DECIMATION);
+  virtual ~vpImagePyramid();
+
+  void build(const vpImage<unsigned char> &I, const unsigned int nbLevels);
+  void build(const vpImage<unsigned char> &I, const std::vector<bool> &levels);
+
+  const vpImage<unsigned char> *getLevel(const unsigned int level) const;
+  const vpImage<unsigned char> &operator[](const unsigned int level) const;
+
+  /*!
+    \return The number of levels of the pyramid, including the levels
+    that were not computed.
+  */
+  inline unsigned int getNbLevels() const {
+    return (unsigned int)levels.size();
+  }
+  /*!
+    \return The number of threads used to compute the levels.
+  */
+  inline unsigned int getNumberOfThreads() const { return nthreads; }
+  /*!
+    \return The method used to compute a level from the previous one.
+  */
+  inline vpReductionType getReductionType() const { return type; }
+  /*!
+    \param level : Level of the pyramid.
+    \return true if the level was computed by the last call to build().
+  */
+  inline bool isBuilt(const unsigned int level) const {
+    return (level < levels.size()) && (levels[level] != NULL);
+  }
+
+  void setNumberOfThreads(const unsigned int nthreads);
+  /*!
+    Set the method used to compute a level from the previous one. It
+    will be used by the next call to build().
+
+    \param _type : Reduction method.
+  */
+  inline void setReductionType(const vpReductionType _type) { type = _type; }
+
+private:
+  // The pyramid can not be copied since level 0 points to the input image
+  vpImagePyramid(const vpImagePyramid &);
+  vpImagePyramid &operator=(const vpImagePyramid &);
+
+private:
+  vpReductionType type;
+  unsigned int nthreads;
+  //! Levels computed by the last call to build(), NULL if not computed
+  std::vector<const vpImage<unsigned char> *> levels;
+  //! Buffers of the levels 1 to n, kept between two calls to build()
+  std::vector<vpImage<unsigned char> *> buffers;
+  //! Horizontally filtered rows used by the Gaussian reduction
+  std::vector<unsigned short> tmp;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
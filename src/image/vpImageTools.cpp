@@ -152,13 +152,20 @@ void vpImageTools::imageDifference(vpImage<unsigned char> &I1,
   if ((I1.getHeight() != Idiff.getHeight()) || (I1.getWidth() != Idiff.getWidth()))
     Idiff.resize(I1.getHeight(), I1.getWidth());
   
-  unsigned int n = I1.getHeight() * I1.getWidth() ;
+  // The images may be views whose rows are not contiguous
+  unsigned int width = I1.getWidth() ;
   int diff ;
-  for (unsigned int b = 0; b < n ; b++)
+  for (unsigned int i = 0; i < I1.getHeight() ; i++)
     {
-      diff = I1.bitmap[b] - I2.bitmap[b] + 128;
-      Idiff.bitmap[b] = (unsigned char)
-	(vpMath::maximum(vpMath::minimum(diff, 255), 0));
+      const unsigned char *p1 = I1[i] ;
+      const unsigned char *p2 = I2[i] ;
+      unsigned char *pdiff = Idiff[i] ;
+      for (unsigned int j = 0; j < width ; j++)
+	{
+	  diff = p1[j] - p2[j] + 128;
+	  pdiff[j] = (unsigned char)
+	    (vpMath::maximum(vpMath::minimum(diff, 255), 0));
+	}
     }
 }
 
@@ -124,6 +124,9 @@ public:
   \param i_sub, j_sub : coordinates of the upper left point of the sub image
   \param nrow_sub, ncol_sub : number of row, column of the sub image
   \param S : Sub-image.
+
+  \sa vpImage::initView() to access a sub part of an image without
+  copying it.
 */
 template<class Type>
 void vpImageTools::createSubImage(const vpImage<Type> &I,
@@ -162,6 +165,9 @@ void vpImageTools::createSubImage(const vpImage<Type> &I,
   sub part of the image to extract.
 
   \param S : Sub-image.
+
+  \sa vpImage::initView() to access a sub part of an image without
+  copying it.
 */
 template<class Type>
 void vpImageTools::createSubImage(const vpImage<Type> &I,
@@ -219,13 +225,16 @@ void vpImageTools::binarise(vpImage<Type> &I,
 			    Type value1, Type value2, Type value3)
 {
   unsigned char v;
-  unsigned char *p = I.bitmap;
-  unsigned char *pend = I.bitmap + I.getWidth()*I.getHeight();
-  for (; p < pend; p ++) {
-    v = *p;
-    if (v < threshold1) *p = value1;
-    else if (v > threshold2) *p = value3;
-    else *p = value2;
+  // Row by row, since the image may be a view whose rows are not contiguous
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    unsigned char *p = I[i];
+    unsigned char *pend = p + I.getWidth();
+    for (; p < pend; p ++) {
+      v = *p;
+      if (v < threshold1) *p = value1;
+      else if (v > threshold2) *p = value3;
+      else *p = value2;
+    }
   }
 
 }
@@ -241,6 +250,7 @@ public:
   Type *dst;
   unsigned int width;
   unsigned int height;
+  unsigned int stride; // number of elements between two rows of src
   vpCameraParameters cam;
   unsigned int nthreads;
   unsigned int threadid;
@@ -251,6 +261,7 @@ public:
     dst = u.dst;
     width = u.width;
     height = u.height;
+    stride = u.stride;
     cam = u.cam;
     nthreads = u.nthreads;
     threadid = u.threadid;
@@ -268,6 +279,7 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   int width    = (int)undistortSharedData->width;
   int height   = (int)undistortSharedData->height;
   int nthreads = (int)undistortSharedData->nthreads;
+  int stride   = (int)undistortSharedData->stride;
 
   double u0 = undistortSharedData->cam.get_u0();
   double v0 = undistortSharedData->cam.get_v0();
@@ -312,9 +324,9 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
       if ( (0 <= u_round) && (0 <= v_round) &&
 	   (u_round < ((width) - 1)) && (v_round < ((height) - 1)) ) {
 	//process interpolation
-	const Type* _mp = &src[v_round*width+u_round];
+	const Type* _mp = &src[v_round*stride+u_round];
 	v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-	_mp += width;
+	_mp += stride;
 	v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
 	*dst = (Type)(v01 + ((v23 - v01) * dv_double));
       }
@@ -349,6 +361,9 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+
+  \sa vpImageUndistortMap to undistort a sequence of images acquired
+  with the same camera; the distortion model is then evaluated only once.
 */
 template<class Type>
 void vpImageTools::undistort(const vpImage<Type> &I,
@@ -389,6 +404,7 @@ void vpImageTools::undistort(const vpImage<Type> &I,
     undistortSharedData[i].dst      = undistI.bitmap;
     undistortSharedData[i].width    = I.getWidth();
     undistortSharedData[i].height   = I.getHeight();
+    undistortSharedData[i].stride   = I.getStride();
     undistortSharedData[i].cam      = cam;
     undistortSharedData[i].nthreads = nthreads;
     undistortSharedData[i].threadid = i;
@@ -467,7 +483,7 @@ void vpImageTools::undistort(const vpImage<Type> &I,
         //process interpolation
         const Type* _mp = &I[(unsigned int)v_round][(unsigned int)u_round];
         v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
+        _mp = &I[(unsigned int)v_round+1][(unsigned int)u_round];
         v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
         *dst = (Type)(v01 + ((v23 - v01) * dv_double));
         //printf("R %d G %d B %d\n", dst->R, dst->G, dst->B);
@@ -526,15 +542,17 @@ void vpImageTools::flip(const vpImage<Type> &I,
                         vpImage<Type> &newI)
 {
     unsigned int height = 0, width = 0;
-    int i = 0;
+    unsigned int i = 0;
 
     height = I.getHeight();
     width = I.getWidth();
     newI.resize(height, width);
 
+    // Row by row, since the input image may be a view whose rows are
+    // not contiguous
     for ( i = 0; i < height; i++)
     {
-      memcpy(newI.bitmap+i*width, I.bitmap+(height-1-i)*width,
+      memcpy((unsigned char *)newI[i], (const unsigned char *)I[height-1-i],
 	     width*sizeof(Type));
     }
 }
@@ -558,12 +576,12 @@ void vpImageTools::flip(vpImage<Type> &I)
 
     for ( i = 0; i < height/2; i++)
     {
-      memcpy(Ibuf.bitmap, I.bitmap+i*width,
+      memcpy((unsigned char *)Ibuf[0], (const unsigned char *)I[i],
   	            width*sizeof(Type));
 
-      memcpy(I.bitmap+i*width, I.bitmap+(height-1-i)*width,
+      memcpy((unsigned char *)I[i], (const unsigned char *)I[height-1-i],
   	            width*sizeof(Type));
-      memcpy(I.bitmap+(height-1-i)*width, Ibuf.bitmap,
+      memcpy((unsigned char *)I[height-1-i], (const unsigned char *)Ibuf[0],
   	            width*sizeof(Type));
     }
 }
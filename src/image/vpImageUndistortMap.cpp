@@ -0,0 +1,344 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Precomputed undistortion map.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImageUndistortMap.cpp
+  \brief Precomputed look up tables used to undistort images.
+*/
+
+#include <visp/vpImageUndistortMap.h>
+#include <visp/vpImageException.h>
+#include <visp/vpDebug.h>
+
+#include <cmath>
+#include <limits>
+
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  const int vpUndistortShift = 2 * (int)vpImageUndistortMap::FRAC_BITS;
+  const int vpUndistortRound = 1 << (2 * vpImageUndistortMap::FRAC_BITS - 1);
+
+  // The offsets of the map are computed for contiguous images of the
+  // given width. For a view, they are converted to the stride of the
+  // source image.
+  inline int sourceOffset(int off, unsigned int width, unsigned int stride)
+  {
+    if (stride == width)
+      return off;
+    return (off / (int)width) * (int)stride + off % (int)width;
+  }
+
+  void undistortRow(const unsigned char *src, unsigned int width,
+                    unsigned int stride,
+                    const int *off, const unsigned short *w,
+                    unsigned char *dst, unsigned int n)
+  {
+    for (unsigned int j = 0; j < n; j++, w += 4) {
+      if (off[j] < 0) {
+        dst[j] = 0;
+        continue;
+      }
+      const unsigned char *p = src + sourceOffset(off[j], width, stride);
+      dst[j] = (unsigned char)((w[0]*p[0] + w[1]*p[1]
+                                + w[2]*p[stride] + w[3]*p[stride+1]
+                                + vpUndistortRound) >> vpUndistortShift);
+    }
+  }
+
+  void undistortRow(const vpRGBa *src, unsigned int width,
+                    unsigned int stride,
+                    const int *off, const unsigned short *w,
+                    vpRGBa *dst, unsigned int n)
+  {
+#ifdef VISP_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rnd = _mm_set1_epi32(vpUndistortRound);
+    for (unsigned int j = 0; j < n; j++, w += 4) {
+      if (off[j] < 0) {
+        dst[j] = vpRGBa(0);
+        continue;
+      }
+      const vpRGBa *p = src + sourceOffset(off[j], width, stride);
+      // Two neighbour pixels of each row, expanded to 16 bits and
+      // interleaved as R0 R1 G0 G1 B0 B1 A0 A1
+      __m128i t = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p), zero);
+      __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(p+stride)), zero);
+      t = _mm_unpacklo_epi16(t, _mm_srli_si128(t, 8));
+      b = _mm_unpacklo_epi16(b, _mm_srli_si128(b, 8));
+      __m128i wt = _mm_set1_epi32((int)w[0] | ((int)w[1] << 16));
+      __m128i wb = _mm_set1_epi32((int)w[2] | ((int)w[3] << 16));
+      __m128i s = _mm_add_epi32(_mm_madd_epi16(t, wt), _mm_madd_epi16(b, wb));
+      s = _mm_srai_epi32(_mm_add_epi32(s, rnd), vpUndistortShift);
+      s = _mm_packus_epi16(_mm_packs_epi32(s, s), zero);
+      int rgba = _mm_cvtsi128_si32(s);
+      dst[j] = vpRGBa((unsigned char)rgba, (unsigned char)(rgba >> 8),
+                      (unsigned char)(rgba >> 16), (unsigned char)(rgba >> 24));
+    }
+#else
+    for (unsigned int j = 0; j < n; j++, w += 4) {
+      if (off[j] < 0) {
+        dst[j] = vpRGBa(0);
+        continue;
+      }
+      const vpRGBa *p = src + sourceOffset(off[j], width, stride);
+      const unsigned char *p00 = (const unsigned char *)p;
+      const unsigned char *p01 = p00 + sizeof(vpRGBa);
+      const unsigned char *p10 = (const unsigned char *)(p + stride);
+      const unsigned char *p11 = p10 + sizeof(vpRGBa);
+      unsigned char *d = (unsigned char *)(dst + j);
+      for (unsigned int c = 0; c < sizeof(vpRGBa); c++) {
+        d[c] = (unsigned char)((w[0]*p00[c] + w[1]*p01[c]
+                                + w[2]*p10[c] + w[3]*p11[c]
+                                + vpUndistortRound) >> vpUndistortShift);
+      }
+    }
+#endif
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The map is empty; call init() before
+  undistort().
+*/
+vpImageUndistortMap::vpImageUndistortMap()
+  : width(0), height(0), nthreads(1), offset(), weight(), identity(false)
+{
+}
+
+/*!
+  Build the undistortion map for images of size \e height x \e width
+  acquired with the camera \e cam.
+
+  \param cam : Parameters of the camera causing distortion.
+  \param height, width : Size of the images to undistort.
+*/
+vpImageUndistortMap::vpImageUndistortMap(const vpCameraParameters &cam,
+                                         unsigned int height,
+                                         unsigned int width)
+  : width(0), height(0), nthreads(1), offset(), weight(), identity(false)
+{
+  init(cam, height, width);
+}
+
+/*!
+  Destructor.
+*/
+vpImageUndistortMap::~vpImageUndistortMap()
+{
+}
+
+/*!
+  Compute the undistortion map. For each pixel of the undistorted
+  image, the position of the corresponding point in the distorted
+  image is computed with the same model as vpImageTools::undistort(),
+  then the index of the top left neighbour and the four bilinear
+  weights are stored.
+
+  This method has to be called again only if the camera parameters or
+  the image size change.
+
+  \param cam : Parameters of the camera causing distortion.
+  \param h, w : Size of the images to undistort.
+*/
+void vpImageUndistortMap::init(const vpCameraParameters &cam,
+                               unsigned int h, unsigned int w)
+{
+  width = w;
+  height = h;
+
+  double kud = cam.get_kud();
+  identity = (std::fabs(kud) <= std::numeric_limits<double>::epsilon());
+  if (identity) {
+    // There is no need to undistort the image
+    offset.clear();
+    weight.clear();
+    return;
+  }
+
+  offset.resize(width*height);
+  weight.resize(4*width*height);
+
+  double u0 = cam.get_u0();
+  double v0 = cam.get_v0();
+  double invpx = 1.0/cam.get_px();
+  double invpy = 1.0/cam.get_py();
+
+  double kud_px2 = kud * invpx * invpx;
+  double kud_py2 = kud * invpy * invpy;
+
+  const int one = 1 << FRAC_BITS;
+  unsigned int k = 0;
+  for (unsigned int v = 0; v < height; v++) {
+    double deltav = (double)v - v0;
+    double fr1 = 1.0 + kud_py2 * deltav * deltav;
+
+    for (unsigned int u = 0; u < width; u++, k++) {
+      double deltau = (double)u - u0;
+      double fr2 = fr1 + kud_px2 * deltau * deltau;
+
+      double u_double = deltau * fr2 + u0;
+      double v_double = deltav * fr2 + v0;
+
+      int u_round = (int) (u_double);
+      int v_round = (int) (v_double);
+      if (u_double < 0.) u_round = -1;
+      if (v_double < 0.) v_round = -1;
+
+      unsigned short *wk = &weight[4*k];
+      if ( (0 <= u_round) && (0 <= v_round) &&
+           (u_round < ((int)width - 1)) && (v_round < ((int)height - 1)) ) {
+        int fu = (int)((u_double - (double)u_round) * one + 0.5);
+        int fv = (int)((v_double - (double)v_round) * one + 0.5);
+        if (fu > one) fu = one;
+        if (fv > one) fv = one;
+        offset[k] = v_round * (int)width + u_round;
+        wk[0] = (unsigned short)((one - fu) * (one - fv));
+        wk[1] = (unsigned short)(fu * (one - fv));
+        wk[2] = (unsigned short)((one - fu) * fv);
+        wk[3] = (unsigned short)(fu * fv);
+      }
+      else {
+        offset[k] = -1;
+        wk[0] = wk[1] = wk[2] = wk[3] = 0;
+      }
+    }
+  }
+}
+
+/*!
+  Set the number of threads used to undistort the image rows. This
+  setting is only effective when ViSP is built with OpenMP.
+
+  \param n : Number of threads. 0 is considered as 1.
+*/
+void vpImageUndistortMap::setNumberOfThreads(unsigned int n)
+{
+  nthreads = (n == 0) ? 1 : n;
+}
+
+/*!
+  \exception vpImageException::notInitializedError : If init() was not
+  called.
+  \exception vpImageException::incorrectInitializationError : If the
+  image size differs from the one of the map.
+*/
+void vpImageUndistortMap::checkSize(unsigned int h, unsigned int w) const
+{
+  if (! isInitialized()) {
+    vpERROR_TRACE("Undistortion map not initialized") ;
+    throw (vpImageException(vpImageException::notInitializedError,
+                            "Undistortion map not initialized")) ;
+  }
+  if (h != height || w != width) {
+    vpERROR_TRACE("Image size %dx%d differs from the map size %dx%d",
+                  w, h, width, height) ;
+    throw (vpImageException(vpImageException::incorrectInitializationError,
+                            "Image size differs from the map size")) ;
+  }
+}
+
+/*!
+  Undistort a grey level image.
+
+  \param I : Input image to undistort. Its size has to be the one
+  given to init(). It can be a view (see vpImage::initView()).
+  \param undistI : Undistorted output image, resized if needed.
+*/
+void vpImageUndistortMap::undistort(const vpImage<unsigned char> &I,
+                                    vpImage<unsigned char> &undistI) const
+{
+  checkSize(I.getHeight(), I.getWidth());
+  if (identity) {
+    undistI = I;
+    return;
+  }
+  undistI.resize(height, width);
+
+  const unsigned char *src = I.bitmap;
+  unsigned int stride = I.getStride();
+  int h = (int)height;
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+  for (int i = 0; i < h; i++) {
+    unsigned int k = (unsigned int)i * width;
+    undistortRow(src, width, stride, &offset[k], &weight[4*k],
+                 undistI[(unsigned int)i], width);
+  }
+}
+
+/*!
+  Undistort a color image.
+
+  \param I : Input image to undistort. Its size has to be the one
+  given to init(). It can be a view (see vpImage::initView()).
+  \param undistI : Undistorted output image, resized if needed.
+*/
+void vpImageUndistortMap::undistort(const vpImage<vpRGBa> &I,
+                                    vpImage<vpRGBa> &undistI) const
+{
+  checkSize(I.getHeight(), I.getWidth());
+  if (identity) {
+    undistI = I;
+    return;
+  }
+  undistI.resize(height, width);
+
+  const vpRGBa *src = I.bitmap;
+  unsigned int stride = I.getStride();
+  int h = (int)height;
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+  for (int i = 0; i < h; i++) {
+    unsigned int k = (unsigned int)i * width;
+    undistortRow(src, width, stride, &offset[k], &weight[4*k],
+                 undistI[(unsigned int)i], width);
+  }
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
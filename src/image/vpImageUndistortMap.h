@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Precomputed undistortion map.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpImageUndistortMap_H
+#define vpImageUndistortMap_H
+
+/*!
+  \file vpImageUndistortMap.h
+
+  \brief Precomputed look up tables used to undistort images.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpRGBa.h>
+#include <visp/vpCameraParameters.h>
+
+#include <vector>
+
+/*!
+  \class vpImageUndistortMap
+
+  \ingroup ImageTool
+
+  \brief Undistortion map computed once from the camera parameters and
+  applied to each new image.
+
+  vpImageTools::undistort() evaluates the radial distortion model and
+  the bilinear interpolation weights for each pixel each time it is
+  called. When the camera parameters and the image size do not change,
+  this class allows to compute these values only once. For each pixel
+  of the undistorted image the map stores the index of the top left
+  source pixel and the four bilinear weights in fixed point
+  arithmetic. Undistorting an image then only requires a gather of four
+  pixels and an integer interpolation.
+
+  Rows can be processed in parallel using OpenMP (see
+  setNumberOfThreads()). When ViSP is built with SSE2 support, the
+  interpolation of color images is vectorized.
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpImageUndistortMap.h>
+
+int main()
+{
+  vpImage<unsigned char> I(960, 1280), U;
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, 640, 480, -0.17, 0.17);
+
+  vpImageUndistortMap map(cam, I.getHeight(), I.getWidth());
+  for ( ; ; ) {
+    // acquire a new image in I
+    map.undistort(I, U);
+  }
+}
+  \endcode
+
+  \sa vpImageTools::undistort()
+*/
+class VISP_EXPORT vpImageUndistortMap
+{
+public:
+  /*!
+    Number of bits used to code the sub-pixel position along each axis.
+    The four bilinear weights of a pixel sum to
+    \f$ 2^{2 \times \mbox{FRAC\_BITS}} \f$.
+  */
+  static const unsigned int FRAC_BITS = 7;
+
+  vpImageUndistortMap();
+  vpImageUndistortMap(const vpCameraParameters &cam,
+                      unsigned int height, unsigned int width);
+  virtual ~vpImageUndistortMap();
+
+  void init(const vpCameraParameters &cam,
+            unsigned int height, unsigned int width);
+
+  /*!
+    \return The height of the images the map was built for.
+  */
+  inline unsigned int getHeight() const { return height; }
+  /*!
+    \return The width of the images the map was built for.
+  */
+  inline unsigned int getWidth() const { return width; }
+  /*!
+    \return The number of threads used to process the rows.
+  */
+  inline unsigned int getNumberOfThreads() const { return nthreads; }
+  /*!
+    \return true if the map was built with init().
+  */
+  inline bool isInitialized() const { return (width != 0 && height != 0); }
+
+  void setNumberOfThreads(unsigned int nthreads);
+
+  void undistort(const vpImage<unsigned char> &I,
+                 vpImage<unsigned char> &undistI) const;
+  void undistort(const vpImage<vpRGBa> &I,
+                 vpImage<vpRGBa> &undistI) const;
+
+private:
+  void checkSize(unsigned int h, unsigned int w) const;
+
+private:
+  unsigned int width;
+  unsigned int height;
+  unsigned int nthreads;
+  //! For each pixel, index of the top left source pixel or -1 if outside
+  std::vector<int> offset;
+  //! For each pixel, the four weights w00, w01, w10, w11
+  std::vector<unsigned short> weight;
+  //! Copy of I when the camera has no distortion
+  bool identity;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
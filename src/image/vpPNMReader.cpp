@@ -0,0 +1,405 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Memory mapped reader of PNM (PGM P5 and PPM P6) image files.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPNMReader.cpp
+  \brief Memory mapped reader of PGM P5 and PPM P6 image files.
+*/
+
+#include <visp/vpPNMReader.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpImageException.h>
+#include <visp/vpDebug.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(UNIX)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  inline bool isSpace(unsigned char c)
+  {
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r')
+      || (c == '\v') || (c == '\f');
+  }
+
+  // Skip the white spaces and the comments preceding a header field.
+  // Return false if there is no separator.
+  bool skipSeparators(const unsigned char *buf, size_t size, size_t &pos)
+  {
+    size_t start = pos;
+    while (pos < size) {
+      if (buf[pos] == '#') {
+        while ((pos < size) && (buf[pos] != '\n'))
+          pos++;
+      }
+      else if (isSpace(buf[pos]))
+        pos++;
+      else
+        break;
+    }
+    return (pos > start);
+  }
+
+  bool readNumber(const unsigned char *buf, size_t size, size_t &pos,
+                  unsigned int &value)
+  {
+    if (! skipSeparators(buf, size, pos))
+      return false;
+    size_t start = pos;
+    value = 0;
+    while ((pos < size) && (buf[pos] >= '0') && (buf[pos] <= '9')) {
+      if (value > 100000000)
+        return false;
+      value = 10 * value + (unsigned int)(buf[pos] - '0');
+      pos++;
+    }
+    return (pos > start);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. No file is opened.
+*/
+vpPNMReader::vpPNMReader()
+  : data(NULL), size(0), mapped(false), buffer(), header(),
+    color(false), width(0), height(0), nbHeaderParses(0)
+{
+}
+
+/*!
+  Destructor. Release the opened file.
+*/
+vpPNMReader::~vpPNMReader()
+{
+  close();
+}
+
+/*!
+  \return true if the files are mapped in memory, false if they are
+  read in a buffer.
+*/
+bool
+vpPNMReader::isMappingSupported()
+{
+#if defined(UNIX)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*!
+  Open a PGM P5 or a PPM P6 file and parse its header, unless it is the
+  same as the header of the previous file.
+
+  The file previously opened is closed.
+
+  \param filename : Name of the file.
+
+  \exception vpImageException::ioError : If the file cannot be read, is
+  not a PGM P5 or PPM P6 file with 255 as maximum value, or is too short.
+*/
+void
+vpPNMReader::open(const char *filename)
+{
+  close();
+
+  if ((filename == NULL) || (*filename == '\0')) {
+    vpERROR_TRACE("no filename") ;
+    throw (vpImageException(vpImageException::ioError,
+                            "no filename")) ;
+  }
+
+#if defined(UNIX)
+  int fd = ::open(filename, O_RDONLY);
+  if (fd < 0) {
+    vpERROR_TRACE("couldn't read file \"%s\"", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "couldn't read file")) ;
+  }
+  struct stat st;
+  if ((fstat(fd, &st) != 0) || (st.st_size < 2)) {
+    ::close(fd);
+    vpERROR_TRACE("\"%s\" is not a PNM file", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "this is not a pnm file")) ;
+  }
+  size = (size_t)st.st_size;
+  // Private mapping: the pixels of a view can be modified without
+  // modifying the file
+  void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (ptr == MAP_FAILED) {
+    size = 0;
+    vpERROR_TRACE("couldn't map file \"%s\"", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "couldn't read file")) ;
+  }
+#  ifdef MADV_WILLNEED
+  madvise(ptr, size, MADV_WILLNEED);
+#  endif
+  data = (unsigned char *)ptr;
+  mapped = true;
+#else
+  FILE *fd = fopen(filename, "rb");
+  if (fd == NULL) {
+    vpERROR_TRACE("couldn't read file \"%s\"", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "couldn't read file")) ;
+  }
+  long length = -1;
+  if (fseek(fd, 0, SEEK_END) == 0)
+    length = ftell(fd);
+  if ((length < 2) || (fseek(fd, 0, SEEK_SET) != 0)) {
+    fclose(fd);
+    vpERROR_TRACE("\"%s\" is not a PNM file", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "this is not a pnm file")) ;
+  }
+  buffer.resize((size_t)length);
+  if (fread(&buffer[0], 1, (size_t)length, fd) != (size_t)length) {
+    fclose(fd);
+    vpERROR_TRACE("couldn't read %ld bytes in file \"%s\"", length, filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "couldn't read file")) ;
+  }
+  fclose(fd);
+  data = &buffer[0];
+  size = (size_t)length;
+#endif
+
+  try {
+    if (header.empty() || (size < header.size())
+        || (memcmp(data, &header[0], header.size()) != 0))
+      parseHeader(filename);
+
+    size_t nbytes = (size_t)width * height * (color ? 3 : 1);
+    if (size - header.size() < nbytes) {
+      vpERROR_TRACE("couldn't read %d bytes in file \"%s\"", nbytes, filename) ;
+      throw (vpImageException(vpImageException::ioError,
+                              "error reading pnm file")) ;
+    }
+  }
+  catch(...) {
+    close();
+    throw;
+  }
+}
+
+/*!
+  Open a PGM P5 or a PPM P6 file.
+
+  \sa open(const char *)
+*/
+void
+vpPNMReader::open(const std::string &filename)
+{
+  open(filename.c_str());
+}
+
+/*!
+  Release the opened file. The images made views by view() must not be
+  used anymore. The cached header is kept.
+*/
+void
+vpPNMReader::close()
+{
+#if defined(UNIX)
+  if (mapped && (data != NULL))
+    munmap(data, size);
+#endif
+  // The buffer keeps its capacity for the next file
+  buffer.clear();
+  data = NULL;
+  size = 0;
+  mapped = false;
+}
+
+void
+vpPNMReader::parseHeader(const char *filename)
+{
+  header.clear();
+
+  if ((data[0] != 'P') || ((data[1] != '5') && (data[1] != '6'))) {
+    vpERROR_TRACE("\"%s\" is not a PGM P5 or PPM P6 file", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "this is not a pnm file")) ;
+  }
+  bool isColor = (data[1] == '6');
+
+  size_t pos = 2;
+  unsigned int w, h, maxval;
+  if (! readNumber(data, size, pos, w) || ! readNumber(data, size, pos, h)
+      || ! readNumber(data, size, pos, maxval)
+      || (pos >= size) || ! isSpace(data[pos])) {
+    vpERROR_TRACE("couldn't read the header of file \"%s\"", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "couldn't read file")) ;
+  }
+  if (maxval != 255) {
+    vpERROR_TRACE("MAX_VAL is not 255 in file \"%s\"", filename) ;
+    throw (vpImageException(vpImageException::ioError,
+                            "error reading pnm file")) ;
+  }
+  // A single white space separates the header from the pixels
+  pos++;
+
+  header.assign(data, data + pos);
+  color = isColor;
+  width = w;
+  height = h;
+  nbHeaderParses++;
+}
+
+void
+vpPNMReader::checkOpened() const
+{
+  if (data == NULL) {
+    vpERROR_TRACE("no opened file") ;
+    throw (vpImageException(vpImageException::notInitializedError,
+                            "no opened file")) ;
+  }
+}
+
+/*!
+  Convert the pixels of the opened file into a grey level image. A PPM
+  P6 color file is converted with vpImageConvert::RGBToGrey().
+
+  The image is resized only if its size is different.
+
+  \param I : Image to set.
+
+  \exception vpImageException::notInitializedError : If no file is opened.
+*/
+void
+vpPNMReader::read(vpImage<unsigned char> &I) const
+{
+  checkOpened();
+
+  if ((I.getHeight() != height) || (I.getWidth() != width))
+    I.resize(height, width);
+
+  unsigned char *src = data + header.size();
+  if (I.isContiguous()) {
+    if (color)
+      vpImageConvert::RGBToGrey(src, I.bitmap, width * height);
+    else
+      memcpy(I.bitmap, src, (size_t)width * height);
+    return;
+  }
+  for (unsigned int i = 0; i < height; i++) {
+    if (color)
+      vpImageConvert::RGBToGrey(src + (size_t)i * 3 * width, I[i], width);
+    else
+      memcpy(I[i], src + (size_t)i * width, width);
+  }
+}
+
+/*!
+  Convert the pixels of the opened file into a color image. A PGM P5
+  file is converted with vpImageConvert::GreyToRGBa().
+
+  The image is resized only if its size is different.
+
+  \param I : Image to set.
+
+  \exception vpImageException::notInitializedError : If no file is opened.
+*/
+void
+vpPNMReader::read(vpImage<vpRGBa> &I) const
+{
+  checkOpened();
+
+  if ((I.getHeight() != height) || (I.getWidth() != width))
+    I.resize(height, width);
+
+  unsigned char *src = data + header.size();
+  unsigned int channels = color ? 3 : 1;
+  unsigned int nrows = I.isContiguous() ? 1 : height;
+  unsigned int n = I.isContiguous() ? width * height : width;
+  for (unsigned int i = 0; i < nrows; i++) {
+    unsigned char *dst = (unsigned char *)I[i];
+    if (color)
+      vpImageConvert::RGBToRGBa(src + (size_t)i * channels * n, dst, n);
+    else
+      vpImageConvert::GreyToRGBa(src + (size_t)i * channels * n, dst, n);
+  }
+}
+
+/*!
+  Make \e I a view on the pixels of the opened PGM P5 file. Nothing is
+  copied.
+
+  The view is valid until the next call to open() or close(). The
+  mapping is private, so that modifying the pixels of the view does not
+  modify the file. Before giving \e I to code that writes it after the
+  next open(), detach it with another call to view() or with
+  vpImage::destroy().
+
+  \param I : Image made a view on the pixels of the file.
+
+  \exception vpImageException::notInitializedError : If no file is opened.
+  \exception vpImageException::ioError : If the file is a PPM P6 file.
+*/
+void
+vpPNMReader::view(vpImage<unsigned char> &I)
+{
+  checkOpened();
+
+  if (color) {
+    vpERROR_TRACE("a PPM file cannot be viewed as a grey level image") ;
+    throw (vpImageException(vpImageException::ioError,
+                            "this is not a pgm file")) ;
+  }
+
+  I.initView(data + header.size(), height, width, width);
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
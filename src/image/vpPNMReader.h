@@ -0,0 +1,158 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Memory mapped reader of PNM (PGM P5 and PPM P6) image files.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpPNMReader_H
+#define vpPNMReader_H
+
+/*!
+  \file vpPNMReader.h
+
+  \brief Memory mapped reader of PGM P5 and PPM P6 image files.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpRGBa.h>
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*!
+  \class vpPNMReader
+
+  \ingroup ImageRW
+
+  \brief Read PGM P5 and PPM P6 files by mapping them in memory.
+
+  open() maps the whole file in memory and parses its header. The
+  pixels are then converted directly from the mapped pages into the
+  destination image by read(), without intermediate buffer. When the
+  file is a PGM P5 file, view() makes a vpImage<unsigned char> a view
+  on the mapped pixels, so that nothing is copied at all.
+
+  The header of the last opened file is kept. When the next file starts
+  with the same header bytes, which is the case of the images of a
+  sequence, its header is not parsed again. getNbHeaderParses() gives
+  the number of parsed headers.
+
+  On systems without mmap(), the file is read in an internal buffer
+  that is reused from one file to the next.
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpPNMReader.h>
+
+int main()
+{
+  vpPNMReader reader;
+  vpImage<unsigned char> I;
+  char filename[FILENAME_MAX];
+  for (int i = 0; i < 100; i++) {
+    sprintf(filename, "/tmp/image.%04d.pgm", i);
+    reader.open(filename);
+    reader.view(I); // No copy, valid until the next open() or close()
+    // ... process I
+  }
+}
+  \endcode
+
+  vpImageIo::readPGM() and vpImageIo::readPPM() use this class, and
+  vpDiskGrabber keeps one reader to benefit from the header cache along
+  a sequence.
+*/
+class VISP_EXPORT vpPNMReader
+{
+public:
+  vpPNMReader();
+  virtual ~vpPNMReader();
+
+  void open(const char *filename);
+  void open(const std::string &filename);
+  void close();
+
+  void read(vpImage<unsigned char> &I) const;
+  void read(vpImage<vpRGBa> &I) const;
+  void view(vpImage<unsigned char> &I);
+
+  /*!
+    \return true if a file is opened.
+  */
+  inline bool isOpened() const { return (data != NULL); }
+  /*!
+    \return true if the opened file is a PPM P6 color file, false if it
+    is a PGM P5 file.
+  */
+  inline bool isColor() const { return color; }
+  //! \return The width of the image of the opened file.
+  inline unsigned int getWidth() const { return width; }
+  //! \return The height of the image of the opened file.
+  inline unsigned int getHeight() const { return height; }
+  //! \return The number of headers parsed since the construction.
+  inline unsigned long getNbHeaderParses() const { return nbHeaderParses; }
+
+  static bool isMappingSupported();
+
+private:
+  // The mapping is not shared
+  vpPNMReader(const vpPNMReader &);
+  vpPNMReader &operator=(const vpPNMReader &);
+
+  void parseHeader(const char *filename);
+  void checkOpened() const;
+
+  unsigned char *data;     //!< First byte of the file
+  size_t size;             //!< Size of the file in bytes
+  bool mapped;             //!< true if data is a memory mapping
+  std::vector<unsigned char> buffer; //!< File content without mapping
+
+  std::vector<unsigned char> header; //!< Header of the last parsed file
+  bool color;
+  unsigned int width;
+  unsigned int height;
+  unsigned long nbHeaderParses;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
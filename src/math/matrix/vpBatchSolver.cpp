@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Batched solver of small symmetric linear systems.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpBatchSolver.cpp
+  \brief Solver of a batch of independent 6x6 symmetric linear systems.
+*/
+
+#include <visp/vpBatchSolver.h>
+#include <visp/vpMatrixException.h>
+#include <visp/vpDebug.h>
+
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  const unsigned int vpBatchSize = vpBatchSolver::SIZE;
+  const unsigned int vpBatchNA = vpBatchSize*(vpBatchSize+1)/2;
+
+  // Operations on the elements of one system
+  struct vpLaneScalar
+  {
+    typedef double type;
+    enum { width = 1 };
+    static inline type load(const double *p) { return *p; }
+    static inline void store(double *p, type v) { *p = v; }
+    static inline type set1(double v) { return v; }
+    static inline type add(type a, type b) { return a + b; }
+    static inline type sub(type a, type b) { return a - b; }
+    static inline type mul(type a, type b) { return a * b; }
+    static inline type div(type a, type b) { return a / b; }
+    static inline type max(type a, type b) { return (a > b) ? a : b; }
+    // Masks are 1 or 0
+    static inline type lessEqual(type a, type b) { return (a <= b) ? 1. : 0.; }
+    static inline type maskOr(type a, type b) { return (a != 0. || b != 0.) ? 1. : 0.; }
+    static inline type select(type mask, type a, type b) { return (mask != 0.) ? a : b; }
+    static inline type flag(type mask) { return mask; }
+  };
+
+#ifdef VISP_HAVE_SSE2
+  // Operations on the elements of two systems
+  struct vpLaneSse2
+  {
+    typedef __m128d type;
+    enum { width = 2 };
+    static inline type load(const double *p) { return _mm_loadu_pd(p); }
+    static inline void store(double *p, type v) { _mm_storeu_pd(p, v); }
+    static inline type set1(double v) { return _mm_set1_pd(v); }
+    static inline type add(type a, type b) { return _mm_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm_mul_pd(a, b); }
+    static inline type div(type a, type b) { return _mm_div_pd(a, b); }
+    static inline type max(type a, type b) { return _mm_max_pd(a, b); }
+    // Masks have all their bits set or cleared
+    static inline type lessEqual(type a, type b) { return _mm_cmple_pd(a, b); }
+    static inline type maskOr(type a, type b) { return _mm_or_pd(a, b); }
+    static inline type select(type mask, type a, type b)
+    { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+    static inline type flag(type mask) { return _mm_and_pd(mask, _mm_set1_pd(1.)); }
+  };
+#endif
+
+  // Solves the systems stored in the columns c to c + V::width - 1 of
+  // the lanes by a LDL^T factorization. The systems with a small pivot
+  // are flagged and their solution is meaningless.
+  template<class V>
+  void ldltSolve(const vpMatrix &lanes, unsigned int c, double threshold)
+  {
+    typedef typename V::type T;
+    T l[vpBatchSize][vpBatchSize];
+    T d[vpBatchSize], dinv[vpBatchSize];
+    T one = V::set1(1.);
+
+    // Scale of the pivots
+    T scale = V::set1(0.);
+    for (unsigned int i = 0; i < vpBatchSize; i++)
+      scale = V::max(scale, V::load(lanes[i*(i+1)/2 + i] + c));
+    T tolerance = V::mul(scale, V::set1(threshold));
+
+    T deficient = V::lessEqual(scale, V::set1(0.));
+    for (unsigned int j = 0; j < vpBatchSize; j++) {
+      // d_j = a_jj - sum_k l_jk^2 d_k
+      T djj = V::load(lanes[j*(j+1)/2 + j] + c);
+      for (unsigned int k = 0; k < j; k++)
+        djj = V::sub(djj, V::mul(V::mul(l[j][k], l[j][k]), d[k]));
+      T small = V::lessEqual(djj, tolerance);
+      deficient = V::maskOr(deficient, small);
+      // A null pivot is replaced by 1 so that the other operations of
+      // the system stay finite
+      d[j] = V::select(small, one, djj);
+      dinv[j] = V::div(one, d[j]);
+      // l_ij = (a_ij - sum_k l_ik l_jk d_k) / d_j
+      for (unsigned int i = j + 1; i < vpBatchSize; i++) {
+        T lij = V::load(lanes[i*(i+1)/2 + j] + c);
+        for (unsigned int k = 0; k < j; k++)
+          lij = V::sub(lij, V::mul(V::mul(l[i][k], l[j][k]), d[k]));
+        l[i][j] = V::mul(lij, dinv[j]);
+      }
+    }
+
+    // L y = b, then L^T x = D^-1 y
+    T y[vpBatchSize];
+    for (unsigned int i = 0; i < vpBatchSize; i++) {
+      T yi = V::load(lanes[vpBatchNA + i] + c);
+      for (unsigned int k = 0; k < i; k++)
+        yi = V::sub(yi, V::mul(l[i][k], y[k]));
+      y[i] = yi;
+    }
+    T x[vpBatchSize];
+    for (unsigned int i = vpBatchSize; i-- > 0; ) {
+      T xi = V::mul(y[i], dinv[i]);
+      for (unsigned int k = i + 1; k < vpBatchSize; k++)
+        xi = V::sub(xi, V::mul(l[k][i], x[k]));
+      x[i] = xi;
+      V::store(lanes[vpBatchNA + vpBatchSize + i] + c, xi);
+    }
+    V::store(lanes[vpBatchNA + 2*vpBatchSize] + c, V::flag(deficient));
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Build a solver of \e n systems.
+*/
+vpBatchSolver::vpBatchSolver(unsigned int n)
+  : nsystems(0), threshold(1e-12), lanes(), svdSolver(SIZE, SIZE),
+    Ak(SIZE, SIZE), Akp(SIZE, SIZE), bk(SIZE), xk(SIZE)
+{
+  resize(n);
+}
+
+/*!
+  Set the number of systems. The systems are initialized to
+  \f$ I\;x = 0 \f$.
+*/
+void
+vpBatchSolver::resize(unsigned int n)
+{
+  nsystems = n;
+  // Even number of columns so that the systems are solved two by two
+  unsigned int cols = n + (n & 1);
+  lanes.resize(NA + 2*SIZE + 1, cols);
+  for (unsigned int i = 0; i < SIZE; i++) {
+    double *aii = getA(i, i);
+    for (unsigned int k = 0; k < cols; k++)
+      aii[k] = 1.;
+  }
+}
+
+/*!
+  Set the system \e k to \f$ A x = b \f$. Only the lower triangle of \e A
+  is used.
+
+  \exception vpMatrixException::incorrectMatrixSizeError : If \e A is not
+  a 6x6 matrix or \e b a vector of size 6.
+*/
+void
+vpBatchSolver::setSystem(unsigned int k, const vpMatrix &A, const vpColVector &b)
+{
+  if ((A.getRows() != SIZE) || (A.getCols() != SIZE) || (b.getRows() != SIZE)) {
+    vpERROR_TRACE("\n\t\t vpBatchSolver: the systems have 6 unknowns") ;
+    throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                            "\n\t\t vpBatchSolver: the systems have 6 unknowns")) ;
+  }
+  for (unsigned int i = 0; i < SIZE; i++) {
+    for (unsigned int j = 0; j <= i; j++)
+      getA(i, j)[k] = A[i][j];
+    getB(i)[k] = b[i];
+  }
+}
+
+/*!
+  Set the system \e k to the normal equations \f$ J^T J\; x = J^T e \f$
+  of the least squares problem \f$ J x = e \f$. Its solution is then
+  \f$ J^+ e \f$ when \e J has full rank.
+
+  \exception vpMatrixException::incorrectMatrixSizeError : If \e J
+  doesn't have 6 columns or the size of \e e differs from the number of
+  rows of \e J.
+*/
+void
+vpBatchSolver::setLeastSquares(unsigned int k, const vpMatrix &J, const vpColVector &e)
+{
+  if ((J.getCols() != SIZE) || (e.getRows() != J.getRows())) {
+    vpERROR_TRACE("\n\t\t vpBatchSolver: the systems have 6 unknowns") ;
+    throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                            "\n\t\t vpBatchSolver: the systems have 6 unknowns")) ;
+  }
+  double a[NA], r[SIZE];
+  for (unsigned int i = 0; i < NA; i++)
+    a[i] = 0.;
+  for (unsigned int i = 0; i < SIZE; i++)
+    r[i] = 0.;
+  for (unsigned int m = 0; m < J.getRows(); m++) {
+    const double *jm = J[m];
+    double em = e[m];
+    double *ap = a;
+    for (unsigned int i = 0; i < SIZE; i++) {
+      for (unsigned int j = 0; j <= i; j++)
+        *ap++ += jm[i] * jm[j];
+      r[i] += jm[i] * em;
+    }
+  }
+  for (unsigned int i = 0; i < NA; i++)
+    lanes[i][k] = a[i];
+  for (unsigned int i = 0; i < SIZE; i++)
+    getB(i)[k] = r[i];
+}
+
+/*!
+  Copy in \e x the solution of the system \e k computed by solve().
+*/
+void
+vpBatchSolver::getSolution(unsigned int k, vpColVector &x) const
+{
+  if (x.getRows() != SIZE)
+    x.resize(SIZE, false);
+  for (unsigned int i = 0; i < SIZE; i++)
+    x[i] = getX(i)[k];
+}
+
+/*!
+  Solve the systems. The rank deficient systems are solved by the pseudo
+  inverse of their matrix.
+
+  \return The number of rank deficient systems.
+*/
+unsigned int
+vpBatchSolver::solve()
+{
+  unsigned int cols = lanes.getCols();
+  unsigned int c = 0;
+#ifdef VISP_HAVE_SSE2
+  for (; c + 2 <= cols; c += 2)
+    ldltSolve<vpLaneSse2>(lanes, c, threshold);
+#endif
+  for (; c < cols; c++)
+    ldltSolve<vpLaneScalar>(lanes, c, threshold);
+
+  unsigned int ndeficient = 0;
+  for (unsigned int k = 0; k < nsystems; k++) {
+    if (! isRankDeficient(k))
+      continue;
+    ndeficient++;
+    for (unsigned int i = 0; i < SIZE; i++) {
+      for (unsigned int j = 0; j <= i; j++)
+        Ak[i][j] = Ak[j][i] = getA(i, j)[k];
+      bk[i] = getB(i)[k];
+    }
+    svdSolver.pseudoInverse(Ak, Akp, threshold);
+    vpMatrix::multMatrixVector(Akp, bk, xk);
+    for (unsigned int i = 0; i < SIZE; i++)
+      lanes[NA + SIZE + i][k] = xk[i];
+  }
+  return ndeficient;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
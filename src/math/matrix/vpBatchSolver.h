@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Batched solver of small symmetric linear systems.
+ *
+ *****************************************************************************/
+
+#ifndef vpBatchSolver_H
+#define vpBatchSolver_H
+
+/*!
+  \file vpBatchSolver.h
+  \brief Solver of a batch of independent 6x6 symmetric linear systems.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpColVector.h>
+#include <visp/vpSvdSolver.h>
+
+/*!
+  \class vpBatchSolver
+  \ingroup Matrix
+
+  \brief Solver of a batch of independent symmetric linear systems
+  \f$ A_k x_k = b_k \f$ of size 6, such as the normal equations
+  \f$ J_k^T J_k\; x_k = J_k^T e_k \f$ of many 6-DOF pose estimations.
+
+  The systems are stored in structure of arrays layout: getA(i, j)
+  returns the array of the elements (i, j) of all the matrices, whose
+  element k belongs to the system k. The systems are solved together by
+  a \f$ L D L^T \f$ factorization whose operations are done on the
+  systems two by two with SSE2.
+
+  A system whose factorization has a pivot not greater than
+  getThreshold() times the largest diagonal element of its matrix is
+  considered as rank deficient and solved by the pseudo inverse of its
+  matrix (see vpSvdSolver), with the same threshold on the singular
+  values.
+
+  The memory is allocated by the constructor or resize(); solving
+  batches of the same size doesn't allocate memory.
+
+  \code
+#include <visp/vpBatchSolver.h>
+
+int main()
+{
+  unsigned int n = 100;
+  vpBatchSolver batch(n);
+  vpMatrix J(8, 6);
+  vpColVector e(8), x;
+  for (unsigned int k = 0; k < n; k++) {
+    // ... compute J and e of the system k
+    batch.setLeastSquares(k, J, e); // J^T J x = J^T e
+  }
+  batch.solve();
+  for (unsigned int k = 0; k < n; k++)
+    batch.getSolution(k, x);
+}
+  \endcode
+*/
+class VISP_EXPORT vpBatchSolver
+{
+public:
+  //! Number of unknowns of the systems.
+  static const unsigned int SIZE = 6;
+
+  explicit vpBatchSolver(unsigned int n = 0);
+
+  void resize(unsigned int n);
+  //! Return the number of systems.
+  inline unsigned int getSize() const { return nsystems; }
+
+  //! Set the relative threshold under which a pivot is considered as
+  //! null (1e-12 by default).
+  inline void setThreshold(double t) { threshold = t; }
+  //! Return the relative threshold under which a pivot is considered
+  //! as null.
+  inline double getThreshold() const { return threshold; }
+
+  /*!
+    Return the array of the elements (i, j) of the matrices. Since they
+    are symmetric, getA(i, j) and getA(j, i) return the same array.
+  */
+  inline double *getA(unsigned int i, unsigned int j)
+  { return (i >= j) ? lanes[i*(i+1)/2 + j] : lanes[j*(j+1)/2 + i]; }
+  //! Return the array of the elements i of the right-hand sides.
+  inline double *getB(unsigned int i) { return lanes[NA + i]; }
+  //! Return the array of the elements i of the solutions.
+  inline const double *getX(unsigned int i) const { return lanes[NA + SIZE + i]; }
+
+  void setSystem(unsigned int k, const vpMatrix &A, const vpColVector &b);
+  void setLeastSquares(unsigned int k, const vpMatrix &J, const vpColVector &e);
+  void getSolution(unsigned int k, vpColVector &x) const;
+  //! Return true if the system k was rank deficient in the last call to
+  //! solve().
+  inline bool isRankDeficient(unsigned int k) const { return lanes[NA + 2*SIZE][k] != 0.; }
+
+  unsigned int solve();
+
+private:
+  // Number of stored elements of a symmetric matrix
+  static const unsigned int NA = SIZE*(SIZE+1)/2;
+
+  unsigned int nsystems;
+  double threshold;
+  // The rows store the NA elements of the matrices, the right-hand
+  // sides, the solutions and the rank deficiency flags; column k is the
+  // system k
+  vpMatrix lanes;
+
+  // Rank deficient systems
+  vpSvdSolver svdSolver;
+  vpMatrix Ak, Akp;
+  vpColVector bk, xk;
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -61,26 +61,11 @@
 #include <math.h> //EM gcc 4.3
 
   //! operator addition of two vectors
-vpColVector
+vpMatrixLinear<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpColVector> >
 vpColVector::operator+(const vpColVector &m) const
 {
-  vpColVector v ;
-
-  try {
-    v.resize(rowNum) ;
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
-
-  double *vd = v.data ;   double *d = data ;  double *md = m.data ;
-
-  for (unsigned int i=0;i<rowNum;i++)
-      *(vd++) = *(d++) + *(md++);
-
-  return v;
+  return vpMatrixLinear<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpColVector> >
+    (vpMatrixLeaf<vpColVector>(*this), 1., vpMatrixLeaf<vpColVector>(m), 1.);
 }
 
 //! operator dot product
@@ -95,29 +80,19 @@ vpColVector::operator*(const vpColVector &m) const
 }
 
 //! operator dot product
-vpMatrix vpColVector::operator*(const vpRowVector &m) const
+vpMatrixProduct<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpRowVector> >
+vpColVector::operator*(const vpRowVector &m) const
 {
-
-  return (vpMatrix)*this*(vpMatrix)m;
+  return vpMatrixProduct<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpRowVector> >
+    (vpMatrixLeaf<vpColVector>(*this), vpMatrixLeaf<vpRowVector>(m));
 }
 
   //! operator substraction of two vectors V = A-v
-vpColVector vpColVector::operator-(const vpColVector &m) const
+vpMatrixLinear<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpColVector> >
+vpColVector::operator-(const vpColVector &m) const
 {
-  vpColVector v ;
-
-  try {
-    v.resize(rowNum) ;
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
-
-  for (unsigned int i=0;i<rowNum;i++)
-      v[i] = (*this)[i] - m[i];
-  return v;
+  return vpMatrixLinear<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpColVector> >
+    (vpMatrixLeaf<vpColVector>(*this), 1., vpMatrixLeaf<vpColVector>(m), -1.);
 }
 
 vpColVector::vpColVector (vpColVector &m, unsigned int r, unsigned int nrows)
@@ -139,44 +114,17 @@ vpColVector::vpColVector (const vpRotationVector &v){
 
   
  //! operator A = -A
-vpColVector vpColVector::operator-()
+vpMatrixScaled<vpMatrixLeaf<vpColVector> >
+vpColVector::operator-() const
 {
-  vpColVector A ;
-  try {
-    A.resize(rowNum)  ;
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
-
-  double *vd = A.data ;   double *d = data ;
-
-  for (unsigned int i=0; i<rowNum; i++)
-    *(vd++)= - (*d++);
-
-  return A;
+  return vpMatrixScaled<vpMatrixLeaf<vpColVector> >(vpMatrixLeaf<vpColVector>(*this), -1.);
 }
 
 //! operator multiplication by a scalar V =  A * x
-vpColVector vpColVector::operator*(double x) const
+vpMatrixScaled<vpMatrixLeaf<vpColVector> >
+vpColVector::operator*(double x) const
 {
-  vpColVector v;
-  try {
-    v.resize(rowNum)  ;
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
-
-  double *vd = v.data ;   double *d = data ;
-
-  for (unsigned int i=0;i<rowNum;i++)
-     *(vd++)=  (*d++) * x;
-  return v;
+  return vpMatrixScaled<vpMatrixLeaf<vpColVector> >(vpMatrixLeaf<vpColVector>(*this), x);
 }
 
 /*!
@@ -334,11 +282,10 @@ vpRowVector vpColVector::t() const
   \relates vpColVector
   \brief  multiplication by a scalar Ci = x*Bi
 */
-vpColVector operator*(const double &x,const vpColVector &B)
+vpMatrixScaled<vpMatrixLeaf<vpColVector> >
+operator*(const double &x,const vpColVector &B)
 {
-  vpColVector v1 ;
-  v1 = B*x ;
-  return v1 ;
+  return vpMatrixScaled<vpMatrixLeaf<vpColVector> >(vpMatrixLeaf<vpColVector>(B), x);
 }
 
 vpColVector::vpColVector (const vpColVector &v) : vpMatrix(v)
@@ -109,19 +109,24 @@ public:
   vpColVector &operator=(const vpMatrix &m);
   //! initialisation each element of the vector is x
   vpColVector &operator=(double x);
+  //! Evaluate an expression in the vector, see vpMatrixExpression.h
+  template<class E> vpColVector &operator=(const vpMatrixExpression<E> &e);
 
   //! operator addition of two vectors V = A+v
-  vpColVector operator+(const vpColVector &v) const;
+  vpMatrixLinear<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpColVector> >
+  operator+(const vpColVector &v) const;
   //! operator substraction of two vectors V = A-v
-  vpColVector operator-(const vpColVector &v) const;
+  vpMatrixLinear<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpColVector> >
+  operator-(const vpColVector &v) const;
   //! operator dot product
   double  operator*(const vpColVector &x) const;
   //! operator dot product
-  vpMatrix  operator*(const vpRowVector &x) const;
+  vpMatrixProduct<vpMatrixLeaf<vpColVector>, vpMatrixLeaf<vpRowVector> >
+  operator*(const vpRowVector &x) const;
   //! operator multiplication by a scalar V =  A * x
-  vpColVector operator*(const double x) const;
+  vpMatrixScaled<vpMatrixLeaf<vpColVector> > operator*(const double x) const;
   //! operator A = -A
-  vpColVector operator-() ;
+  vpMatrixScaled<vpMatrixLeaf<vpColVector> > operator-() const;
 
   vpColVector rows(unsigned int first_row, unsigned int last_row)
   { 
@@ -202,6 +207,21 @@ public:
 
 };
 
+/*!
+  Evaluate the expression \e e, that must have one column, in the vector.
+*/
+template<class E>
+vpColVector &vpColVector::operator=(const vpMatrixExpression<E> &e)
+{
+  if (e.getCols() != 1)
+  {
+    vpTRACE(" m should be a 1 cols matrix ") ;
+    throw (vpException(vpException::dimensionError," m should be a 1 cols matrix "));
+  }
+  e.derived().evalTo(*this);
+  return *this;
+}
+
 
 #endif
 
@@ -101,6 +101,40 @@ vpMatrix::init()
 
   dsize = 0 ;
   trsize =0 ;
+  fixedStorage = false ;
+}
+
+/*!
+  Use an array that is not allocated by the matrix to store its
+  elements, typically the vpMatrixFixedStorage of a class that derives
+  from vpMatrix and always has the same size. The elements are not
+  initialized.
+
+  The matrix must not be resized to another size while it uses the
+  array. Otherwise resize() copies the elements in memory allocated on
+  the heap and the array is no more used.
+
+  \param array : Array of nrows*ncols elements.
+  \param rows : Array of nrows row pointers.
+  \param nrows, ncols : Size of the matrix.
+*/
+void
+vpMatrix::attach(double *array, double **rows,
+                 unsigned int nrows, unsigned int ncols)
+{
+  if (data == array)
+    return;
+
+  kill() ;
+  data = array ;
+  rowPtrs = rows ;
+  for (unsigned int i=0 ; i < nrows ; i++)
+    rowPtrs[i] = data + i*ncols ;
+  rowNum = nrows ;
+  colNum = ncols ;
+  dsize = nrows*ncols ;
+  trsize = nrows ;
+  fixedStorage = true ;
 }
 
 /*!
@@ -196,6 +230,23 @@ void vpMatrix::resize(const unsigned int nrows, const unsigned int ncols,
       rowTmp=this->rowNum; colTmp=this->colNum;
     }
 
+    if (fixedStorage)
+    {
+      vpDEBUG_TRACE (25, "Move the fixed size storage to the heap.");
+      double *heapData = (double*)malloc(this->dsize*sizeof(double));
+      if ((NULL == heapData) && (0 != this->dsize))
+      {
+        vpERROR_TRACE("\n\t\tMemory allocation error when allocating data") ;
+        throw(vpException(vpException::memoryAllocationError,
+          "\n\t\t Memory allocation error when "
+          "allocating data")) ;
+      }
+      memcpy(heapData, this->data, this->dsize*sizeof(double));
+      this->data = heapData;
+      this->rowPtrs = NULL;
+      fixedStorage = false;
+    }
+
     vpDEBUG_TRACE (25, "Reallocation of this->data array.");
     this->dsize = nrows*ncols;
     this->data = (double*)realloc(this->data, this->dsize*sizeof(double));
@@ -283,6 +334,15 @@ vpMatrix::init(const vpMatrix &m,unsigned int r, unsigned int c, unsigned int nr
 void
 vpMatrix::kill()
 {
+  if (fixedStorage)
+  {
+    // Not allocated by the matrix
+    data = NULL ;
+    rowPtrs = NULL ;
+    fixedStorage = false ;
+    return ;
+  }
+
   if (data != NULL )
   {
     free(data);
@@ -379,65 +439,15 @@ vpMatrix::operator<<( double *x )
 // Matrix operations.
 //---------------------------------
 
-/*!
-Operation C = A * B. 
-
-The result is placed in the third parameter C and not returned.
-A new matrix won't be allocated for every use of the function 
-(Speed gain if used many times with the same result matrix size).
-
-\sa operator*()
-*/
-void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
-{
-  try 
-  {
-    if ((A.rowNum != C.rowNum) || (B.colNum != C.colNum)) C.resize(A.rowNum,B.colNum);
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    std::cout << me << std::endl ;
-    throw ;
-  }
-
-  if (A.colNum != B.rowNum)
-  {
-    vpERROR_TRACE("\n\t\tvpMatrix mismatch in vpMatrix/vpMatrix multiply") ;
-    throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
-      "\n\t\tvpMatrix mismatch in "
-      "vpMatrix/vpMatrix multiply")) ;
-  }
-
-  // 5/12/06 some "very" simple optimization to avoid indexation
-  unsigned int BcolNum = B.colNum;
-  unsigned int BrowNum = B.rowNum;
-  unsigned int i,j,k;
-  double **BrowPtrs = B.rowPtrs;
-  for (i=0;i<A.rowNum;i++)
-  {
-    double *rowptri = A.rowPtrs[i];
-    double *ci = C[i];
-    for (j=0;j<BcolNum;j++)
-    {
-      double s = 0;
-      for (k=0;k<BrowNum;k++) s += rowptri[k] * BrowPtrs[k][j];
-      ci[j] = s;
-    }
-  }
-}
-
 /*!
 Operation C = A * B (A is unchanged).
 \sa mult2Matrices() to avoid matrix allocation for each use.
 */
-vpMatrix vpMatrix::operator*(const vpMatrix &B) const
+vpMatrixProduct<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+vpMatrix::operator*(const vpMatrix &B) const
 {
-  vpMatrix C;
-
-  vpMatrix::mult2Matrices(*this,B,C);
-
-  return C;
+  return vpMatrixProduct<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+    (vpMatrixLeaf<vpMatrix>(*this), vpMatrixLeaf<vpMatrix>(B));
 }
 /*!
 Operation C = A*wA + B*wB 
@@ -539,12 +549,11 @@ void vpMatrix::add2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
 Operation C = A + B (A is unchanged).
 \sa add2Matrices() to avoid matrix allocation for each use.
 */
-vpMatrix vpMatrix::operator+(const vpMatrix &B) const
+vpMatrixLinear<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+vpMatrix::operator+(const vpMatrix &B) const
 {
-
-  vpMatrix C;
-  vpMatrix::add2Matrices(*this,B,C);
-  return C;
+  return vpMatrixLinear<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+    (vpMatrixLeaf<vpMatrix>(*this), 1., vpMatrixLeaf<vpMatrix>(B), 1.);
 }
 
 
@@ -610,11 +619,11 @@ void vpMatrix::sub2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
 Operation C = A - B (A is unchanged).
 \sa sub2Matrices() to avoid matrix allocation for each use.
 */
-vpMatrix vpMatrix::operator-(const vpMatrix &B) const
+vpMatrixLinear<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+vpMatrix::operator-(const vpMatrix &B) const
 {
-  vpMatrix C;
-  vpMatrix::sub2Matrices(*this,B,C);
-  return C;
+  return vpMatrixLinear<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+    (vpMatrixLeaf<vpMatrix>(*this), 1., vpMatrixLeaf<vpMatrix>(B), -1.);
 }
 
 //! Operation A = A + B
@@ -746,11 +755,10 @@ void vpMatrix::negateMatrix(const vpMatrix &A, vpMatrix &C)
 Operation C = -A (A is unchanged).
 \sa negateMatrix() to avoid matrix allocation for each use.
 */
-vpMatrix vpMatrix::operator-() const //negate
+vpMatrixScaled<vpMatrixLeaf<vpMatrix> >
+vpMatrix::operator-() const //negate
 {
-  vpMatrix C;
-  vpMatrix::negateMatrix(*this,C);
-  return C;
+  return vpMatrixScaled<vpMatrixLeaf<vpMatrix> >(vpMatrixLeaf<vpMatrix>(*this), -1.);
 }
 
 //!return sum of the Aij^2 (for all i, for all j)
@@ -797,55 +805,15 @@ vpMatrix::sumSquare() const
 // Matrix/vector operations.
 //---------------------------------
 
-/*!
-Operation c = A * b (c and b are vectors). 
-
-The result is placed in the second parameter C and not returned.
-A new matrix won't be allocated for every use of the function 
-(Speed gain if used many times with the same result matrix size).
-
-\sa operator*(const vpColVector &b) const
-*/
-void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &b, vpColVector &c)
-{
-  if (A.colNum != b.getRows())
-  {
-    vpERROR_TRACE("vpMatrix mismatch in vpMatrix/vector multiply") ;
-    throw(vpMatrixException::incorrectMatrixSizeError) ;
-  }
-
-  try 
-  {
-    if (A.rowNum != c.rowNum) c.resize(A.rowNum);
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    std::cout << me << std::endl ;
-    throw ;
-  }
-
-  c = 0.0;
-  for (unsigned int j=0;j<A.colNum;j++) 
-  {
-    double bj = b[j] ; // optimization em 5/12/2006
-    for (unsigned int i=0;i<A.rowNum;i++) 
-    {
-      c[i]+=A.rowPtrs[i][j] * bj;
-    }
-  }
-}
-
 /*!
 Operation c = A * b (A is unchanged, c and b are vectors).
 \sa multMatrixVector() to avoid matrix allocation for each use.
 */
-vpColVector
+vpMatrixProduct<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpColVector> >
 vpMatrix::operator*(const vpColVector &b) const
 {
-  vpColVector c;
-  vpMatrix::multMatrixVector(*this,b,c);
-  return c;
+  return vpMatrixProduct<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpColVector> >
+    (vpMatrixLeaf<vpMatrix>(*this), vpMatrixLeaf<vpColVector>(b));
 }
 
 //! Operation c = A * b (A is unchanged, c and b are translation vectors).
@@ -881,99 +849,23 @@ vpMatrix::operator*(const vpTranslationVector &b) const
   \relates vpMatrix
   Multiplication by a scalar  Cij = x*Bij.
 */
-vpMatrix operator*(const double &x,const vpMatrix &B)
+vpMatrixScaled<vpMatrixLeaf<vpMatrix> >
+operator*(const double &x,const vpMatrix &B)
 {
-  // Modif EM 13/6/03
-  vpMatrix C ;
-
-  try {
-    C.resize(B.getRows(),B.getCols());
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    std::cout << me << std::endl ;
-    throw ;
-  }
-  // 	double t0,t1;
-
-  unsigned int Brow = B.getRows() ;
-  unsigned int Bcol = B.getCols() ;
-  // 	t0=vpTime::measureTimeMicros();
-  // 
-  // 	for (int i=0;i<Brow; i++)
-  // 	{
-  // 	    double *ci = C[i] ;
-  // 	    double *Bi = B[i] ;
-  // 	    for (int j=0 ; j < Bcol;j++)
-  // 	    ci[j] = Bi[j]*x;
-  // 	 }
-  //  
-  // 	t1=vpTime::measureTimeMicros();
-  // 	std::cout<< t1-t0<<" ";
-
-  // 	t0=vpTime::measureTimeMicros();
-  for (unsigned int i=0;i<Brow;i++)
-    for(unsigned int j=0;j<Bcol;j++)
-      C[i][j]= B[i][j]*x;
-  // 	t1=vpTime::measureTimeMicros();
-  // 	std::cout<< t1-t0<<std::endl;
-
-
-
-  return C ;
+  return vpMatrixScaled<vpMatrixLeaf<vpMatrix> >(vpMatrixLeaf<vpMatrix>(B), x);
 }
 
 //! Cij = Aij * x (A is unchanged)
-vpMatrix vpMatrix::operator*(double x) const
+vpMatrixScaled<vpMatrixLeaf<vpMatrix> >
+vpMatrix::operator*(double x) const
 {
-  vpMatrix C;
-
-  try {
-    C.resize(rowNum,colNum);
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    std::cout << me << std::endl ;
-    throw ;
-  }
-  //	double t0,t1;
-
-  double ** CrowPtrs=C.rowPtrs;
-
-  // 	t0=vpTime::measureTimeMicros();
-  // 	for (int i=0;i<dsize;i++)
-  // 	  *(C.data+i) = *(data+i)*x;
-  //  
-  // 	t1=vpTime::measureTimeMicros();
-  // 	std::cout<< t1-t0<<" ";
-  // 	
-  // 	t0=vpTime::measureTimeMicros();
-  for (unsigned int i=0;i<rowNum;i++)
-    for(unsigned int j=0;j<colNum;j++)
-      CrowPtrs[i][j]= rowPtrs[i][j]*x;
-  // 	t1=vpTime::measureTimeMicros();
-  // 	std::cout<< t1-t0<<std::endl;
-
-  return C;
+  return vpMatrixScaled<vpMatrixLeaf<vpMatrix> >(vpMatrixLeaf<vpMatrix>(*this), x);
 }
 
 //! Cij = Aij / x (A is unchanged)
-vpMatrix  vpMatrix::operator/(double x) const
+vpMatrixScaled<vpMatrixLeaf<vpMatrix> >
+vpMatrix::operator/(double x) const
 {
-  vpMatrix C;
-
-  try {
-    C.resize(rowNum,colNum);
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    vpCERROR << me << std::endl ;
-    throw ;
-  }
-
   //if (x == 0) {
   if (std::fabs(x) <= std::numeric_limits<double>::epsilon()) {
     vpERROR_TRACE("Divide by zero in method /(double x)") ;
@@ -981,26 +873,7 @@ vpMatrix  vpMatrix::operator/(double x) const
   }
 
   double  xinv = 1/x ;
-
-
-  //   	double t0,t1;
-  //      
-  // 	t0=vpTime::measureTimeMicros();
-  // 	for (int i=0;i<dsize;i++)
-  // 	    *(C.data+i) = *(data+i)*xinv ;
-  //  
-  // 	t1=vpTime::measureTimeMicros();
-  // 	std::cout<< t1-t0<<" ";
-  // 	
-  // 	t0=vpTime::measureTimeMicros();
-  for (unsigned int i=0;i<rowNum;i++)
-    for(unsigned int j=0;j<colNum;j++)
-      C[i][j]=rowPtrs[i][j]*xinv;
-  // 	t1=vpTime::measureTimeMicros();
-  // 	std::cout<< t1-t0<<std::endl;
-
-  return C;
-
+  return vpMatrixScaled<vpMatrixLeaf<vpMatrix> >(vpMatrixLeaf<vpMatrix>(*this), xinv);
 }
 
 
@@ -1252,103 +1125,6 @@ vpMatrix vpMatrix::AAt() const
   return B;
 }
 
-/*!
-  Compute the AAt operation such as \f$B = A*A^T\f$.
-
-  The result is placed in the parameter \e B and not returned.
-
-  A new matrix won't be allocated for every use of the function. This
-  results in a speed gain if used many times with the same result
-  matrix size.  
-
-  \sa AAt()
-*/
-void vpMatrix::AAt(vpMatrix &B)const {
-
-  try {
-    if ((B.rowNum != rowNum) || (B.colNum != rowNum)) B.resize(rowNum,rowNum);
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    vpCERROR << me << std::endl ;
-    throw ;
-  }
-
-  // compute A*A^T
-  for(unsigned int i=0;i<rowNum;i++){
-    for(unsigned int j=i;j<rowNum;j++){
-      double *pi = rowPtrs[i];// row i
-      double *pj = rowPtrs[j];// row j
-
-      // sum (row i .* row j)
-      double ssum=0;
-      for(unsigned int k=0; k < colNum ;k++) 
-        ssum += *(pi++)* *(pj++);
-
-      B[i][j]=ssum; //upper triangle
-      if(i!=j)
-        B[j][i]=ssum; //lower triangle
-    }
-  }
-}
-
-
-
-/*!
-  Compute the AtA operation such as \f$B = A^T*A\f$.
-
-  The result is placed in the parameter \e B and not returned.  
-
-  A new matrix won't be allocated for every use of the function. This
-  results in a speed gain if used many times with the same result matrix
-  size.
-
-  \sa AtA()
-*/
-void vpMatrix::AtA(vpMatrix &B) const
-{
-  try {
-    if ((B.rowNum != colNum) || (B.colNum != colNum)) B.resize(colNum,colNum);
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    vpCERROR << me << std::endl ;
-    throw ;
-  }
-
-  unsigned int i,j,k;
-  double s;
-  double *ptr;
-  double *Bi;
-  for (i=0;i<colNum;i++)
-  {
-    Bi = B[i] ;
-    for (j=0;j<i;j++)
-    {
-      ptr=data;
-      s = 0 ;
-      for (k=0;k<rowNum;k++)
-      {
-        s +=(*(ptr+i)) * (*(ptr+j));
-        ptr+=colNum;
-      }
-      *Bi++ = s ;
-      B[j][i] = s;
-    }
-    ptr=data;
-    s = 0 ;
-    for (k=0;k<rowNum;k++)
-    {
-      s +=(*(ptr+i)) * (*(ptr+i));
-      ptr+=colNum;
-    }
-    *Bi = s;
-  }
-}
-
-
 /*!
   Compute the AtA operation such as \f$B = A^T*A\f$
   \return  \f$A^T*A\f$
@@ -58,6 +58,11 @@
 class vpRowVector;
 class vpColVector;
 class vpTranslationVector;
+template<class E> class vpMatrixExpression;
+template<class T> class vpMatrixLeaf;
+template<class L, class R> class vpMatrixLinear;
+template<class E> class vpMatrixScaled;
+template<class L, class R> class vpMatrixProduct;
 
 
 class vpColVector;
@@ -88,6 +93,38 @@ class vpRowVector;
 
   \warning Note the matrix in the class (*this) will be noted A in the comment
 
+  The products of large matrices (mult2Matrices(), operator*(), AtA(),
+  AAt()) pack their operands in cache-sized blocks that are multiplied
+  by an AVX2 kernel when the processor supports it. When ViSP is built
+  with OpenMP they can be shared between several threads (see
+  setNumberOfThreads()), and the BLAS library found with Lapack can be
+  used instead (see setGemmType()). Small matrices keep the original
+  loops.
+
+  The arithmetic operators don't compute their result but return an
+  expression (see vpMatrixExpression.h) that is evaluated when it is
+  assigned to a matrix or a vector. The element-wise operations of an
+  expression such as \f$A + 2B - C\f$ are then done in a single pass,
+  without temporary matrices, and the products of an expression such as
+  \f$L\;V\;J\f$ are computed in the order that needs the fewest
+  operations (see vpMatrixChain). The temporaries that are still needed
+  are taken from a pool (see vpMatrixWorkspace), so that an expression
+  assigned at each iteration of a loop to the same matrix doesn't
+  allocate memory after the first iteration.
+  \code
+vpMatrix L(8, 6), V(6, 6), J(6, 6), J1;
+vpColVector e(8), v;
+double lambda = 0.5;
+J1 = L * V * J;          // No temporary for the result
+v = -lambda * J.t() * e; // Computed as -lambda * (J^T e)
+  \endcode
+  An expression forwards t(), sumSquare(), euclideanNorm(),
+  infinityNorm(), pseudoInverse(), inverseByLU() and operator[] to its
+  value, so that <tt>(A * B).pseudoInverse()</tt> still compiles; the
+  value is evaluated at each call. The other member functions of
+  vpMatrix need a conversion first, for instance
+  <tt>vpMatrix(A * B).getCols()</tt>.
+
   \ingroup libmath
 
   \sa vpRowVector, vpColVector, vpHomogeneousMatrix, vpRotationMatrix,
@@ -104,6 +141,19 @@ class VISP_EXPORT vpMatrix
     LU_DECOMPOSITION     /*!< LU decomposition method. */
   } vpDetMethod;
 
+  /*!
+    Implementation of the products mult2Matrices(), AtA(), AAt() and
+    multMatrixVector().
+    \sa setGemmType()
+  */
+  typedef enum {
+    GEMM_NAIVE,   /*!< Original loops, without blocking. */
+    GEMM_BLOCKED, /*!< Packed and cache-blocked portable kernel. */
+    GEMM_AVX2,    /*!< Packed and cache-blocked AVX2 and FMA kernel. */
+    GEMM_BLAS     /*!< dgemm() and dgemv() of the BLAS library found with
+                    Lapack at configure time. */
+  } vpGemmType;
+
 
 protected:
   //! number of rows
@@ -122,6 +172,11 @@ protected:
   unsigned int dsize;
   //! Total row space
   unsigned int trsize;
+  //! true if data and rowPtrs are a vpMatrixFixedStorage, see attach()
+  bool fixedStorage;
+
+  void attach(double *array, double **rows,
+              unsigned int nrows, unsigned int ncols);
 
  public:
   //! Basic constructor
@@ -235,6 +290,8 @@ protected:
   vpMatrix &operator=(const vpMatrix &B);
   //! Set all the element of the matrix A to x
   vpMatrix &operator=(const double x);
+  //! Evaluate an expression in A, see vpMatrixExpression.h
+  template<class E> vpMatrix &operator=(const vpMatrixExpression<E> &e);
   void diag(const vpColVector &A);
   //@}
 
@@ -259,6 +316,13 @@ protected:
   static void sub2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C);
   static void negateMatrix(const vpMatrix &A, vpMatrix &C);
   static void multMatrixVector(const vpMatrix &A, const vpColVector &b, vpColVector &c);
+
+  static vpGemmType getGemmSupport();
+  static bool isGemmTypeSupported(vpGemmType type);
+  static vpGemmType getGemmType();
+  static void setGemmType(vpGemmType type);
+  static void setNumberOfThreads(unsigned int n);
+  static unsigned int getNumberOfThreads();
   
   static vpMatrix computeCovarianceMatrix(const vpMatrix &A, const vpColVector &x, const vpColVector &b);
   static vpMatrix computeCovarianceMatrix(const vpMatrix &A, const vpColVector &x, const vpColVector &b, const vpMatrix &w);
@@ -273,16 +337,20 @@ protected:
   // operation A = A - B
   vpMatrix &operator-=(const vpMatrix &B);
 
-  vpMatrix operator*(const vpMatrix &B) const;
-  vpMatrix operator+(const vpMatrix &B) const;
-  vpMatrix operator-(const vpMatrix &B) const;
-  vpMatrix operator-() const;
+  vpMatrixProduct<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+  operator*(const vpMatrix &B) const;
+  vpMatrixLinear<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+  operator+(const vpMatrix &B) const;
+  vpMatrixLinear<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpMatrix> >
+  operator-(const vpMatrix &B) const;
+  vpMatrixScaled<vpMatrixLeaf<vpMatrix> > operator-() const;
 
   //---------------------------------
   // Matrix/vector operations.
   //---------------------------------
 
-  vpColVector operator*(const vpColVector &b) const;
+  vpMatrixProduct<vpMatrixLeaf<vpMatrix>, vpMatrixLeaf<vpColVector> >
+  operator*(const vpColVector &b) const;
   // operation c = A * b (A is unchanged, c and b are translation vectors)
   vpTranslationVector operator*(const vpTranslationVector  &b) const;
   //---------------------------------
@@ -299,9 +367,9 @@ protected:
   vpMatrix &operator/=(double x);
 
   // Cij = Aij * x (A is unchanged)
-  vpMatrix operator*(const double x) const;
+  vpMatrixScaled<vpMatrixLeaf<vpMatrix> > operator*(const double x) const;
   // Cij = Aij / x (A is unchanged)
-  vpMatrix operator/(const double x) const;
+  vpMatrixScaled<vpMatrixLeaf<vpMatrix> > operator/(const double x) const;
 
   //!return sum of the Aij^2 (for all i, for all j)
   double sumSquare() const;
@@ -510,12 +578,14 @@ protected:
 
 
 //! multiplication by a scalar C = x*A
-VISP_EXPORT vpMatrix operator*(const double &x, const vpMatrix &A) ;
+VISP_EXPORT vpMatrixScaled<vpMatrixLeaf<vpMatrix> >
+operator*(const double &x, const vpMatrix &A) ;
 
   //! multiplication by a scalar C = x*A
-VISP_EXPORT vpColVector operator*(const double &x, const vpColVector &A) ;
-
+VISP_EXPORT vpMatrixScaled<vpMatrixLeaf<vpColVector> >
+operator*(const double &x, const vpColVector &A) ;
 
+#include <visp/vpMatrixExpression.h>
 
 #endif
 
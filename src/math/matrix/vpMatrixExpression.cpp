@@ -0,0 +1,390 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Lazy expressions on matrices and vectors.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMatrixExpression.cpp
+  \brief Temporaries and products of chains of matrices used to
+  evaluate the lazy matrix expressions.
+*/
+
+#include <visp/vpMatrix.h>
+#include <visp/vpMatrixException.h>
+#include <visp/vpDebug.h>
+
+#include <vector>
+
+#ifdef VISP_HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Temporaries given back by the workspaces. Allocated on first use and
+  // never destroyed, so that workspaces used by static destructors of
+  // other translation units can still use it
+  std::vector<vpMatrix *> *vpTemporaryPool = NULL;
+  const size_t vpTemporaryPoolMaxSize = 64;
+
+  unsigned long vpNbTemporaryAllocations = 0;
+  unsigned long vpNbTemporaryReuses = 0;
+
+#ifdef VISP_HAVE_PTHREAD
+  pthread_mutex_t vpTemporaryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+  class vpTemporaryLock
+  {
+  public:
+    vpTemporaryLock() { pthread_mutex_lock(&vpTemporaryMutex); }
+    ~vpTemporaryLock() { pthread_mutex_unlock(&vpTemporaryMutex); }
+  };
+#endif
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+// All the accesses to the pool are done in the block following
+// VP_TEMPORARY_LOCK. With pthread the lock is released at the end of the
+// enclosing scope, with OpenMP at the end of the block.
+#if defined(VISP_HAVE_PTHREAD)
+#  define VP_TEMPORARY_LOCK vpTemporaryLock lock;
+#elif defined(VISP_HAVE_OPENMP)
+#  define VP_TEMPORARY_LOCK _Pragma("omp critical (vpMatrixWorkspace)")
+#else
+#  define VP_TEMPORARY_LOCK
+#endif
+
+/*!
+  Build an empty workspace.
+*/
+vpMatrixWorkspace::vpMatrixWorkspace()
+  : ntemporaries(0), moreTemporaries()
+{
+}
+
+/*!
+  Give the temporaries back to the pool. When the pool is full, the
+  temporaries it holds for the longest time are destroyed.
+*/
+vpMatrixWorkspace::~vpMatrixWorkspace()
+{
+  if (ntemporaries == 0)
+    return;
+  std::vector<vpMatrix *> evicted;
+  {
+    VP_TEMPORARY_LOCK
+    {
+      if (vpTemporaryPool == NULL)
+        vpTemporaryPool = new std::vector<vpMatrix *>;
+      for (unsigned int i = 0; i < ntemporaries; i++) {
+        if (vpTemporaryPool->size() >= vpTemporaryPoolMaxSize) {
+          evicted.push_back(vpTemporaryPool->front());
+          vpTemporaryPool->erase(vpTemporaryPool->begin());
+        }
+        vpTemporaryPool->push_back(i < NB_LOCAL_TEMPORARIES ?
+                                   temporaries[i] :
+                                   moreTemporaries[i - NB_LOCAL_TEMPORARIES]);
+      }
+    }
+  }
+  for (size_t i = 0; i < evicted.size(); i++)
+    delete evicted[i];
+}
+
+/*!
+  Return a temporary matrix of size \e rows x \e cols, that remains
+  valid until the destruction of the workspace. Its elements are not
+  initialized.
+
+  A temporary of this size is taken from the pool if there is one,
+  otherwise a new one is allocated.
+*/
+vpMatrix &
+vpMatrixWorkspace::acquire(unsigned int rows, unsigned int cols)
+{
+  vpMatrix *T = NULL;
+  {
+    VP_TEMPORARY_LOCK
+    {
+      if (vpTemporaryPool != NULL) {
+        // The most recent temporary of this size
+        for (size_t i = vpTemporaryPool->size(); i > 0; i--) {
+          vpMatrix *P = (*vpTemporaryPool)[i-1];
+          if ((P->getRows() == rows) && (P->getCols() == cols)) {
+            T = P;
+            vpTemporaryPool->erase(vpTemporaryPool->begin() + (long)(i-1));
+            break;
+          }
+        }
+      }
+      if (T == NULL)
+        vpNbTemporaryAllocations++;
+      else
+        vpNbTemporaryReuses++;
+    }
+  }
+
+  if (T == NULL)
+    T = new vpMatrix(rows, cols);
+  if (ntemporaries < NB_LOCAL_TEMPORARIES)
+    temporaries[ntemporaries] = T;
+  else
+    moreTemporaries.push_back(T);
+  ntemporaries++;
+  return *T;
+}
+
+/*!
+  Destroy the temporaries held by the pool.
+*/
+void
+vpMatrixWorkspace::clearPool()
+{
+  std::vector<vpMatrix *> evicted;
+  {
+    VP_TEMPORARY_LOCK
+    {
+      if (vpTemporaryPool != NULL)
+        evicted.swap(*vpTemporaryPool);
+    }
+  }
+  for (size_t i = 0; i < evicted.size(); i++)
+    delete evicted[i];
+}
+
+/*!
+  Return the number of temporaries allocated since the last call to
+  resetCounters().
+*/
+unsigned long
+vpMatrixWorkspace::getNbAllocations()
+{
+  unsigned long n = 0;
+  {
+    VP_TEMPORARY_LOCK
+    {
+      n = vpNbTemporaryAllocations;
+    }
+  }
+  return n;
+}
+
+/*!
+  Return the number of temporaries taken from the pool since the last
+  call to resetCounters().
+*/
+unsigned long
+vpMatrixWorkspace::getNbReuses()
+{
+  unsigned long n = 0;
+  {
+    VP_TEMPORARY_LOCK
+    {
+      n = vpNbTemporaryReuses;
+    }
+  }
+  return n;
+}
+
+/*!
+  Reset the counters returned by getNbAllocations() and getNbReuses().
+*/
+void
+vpMatrixWorkspace::resetCounters()
+{
+  VP_TEMPORARY_LOCK
+  {
+    vpNbTemporaryAllocations = 0;
+    vpNbTemporaryReuses = 0;
+  }
+}
+
+/*!
+  Build an empty chain, whose product is the scalar 1.
+*/
+vpMatrixChain::vpMatrixChain()
+  : workspace(), nfactors(0), coef(1.)
+{
+}
+
+/*!
+  Append the matrix \e A to the chain. It is not copied and has to
+  remain valid until evaluate() is called.
+
+  If the chain already has MAX_FACTORS factors, their product is
+  computed first and replaces them.
+
+  \exception vpMatrixException::incorrectMatrixSizeError : If the
+  number of rows of \e A differs from the number of columns of the last
+  factor.
+*/
+void
+vpMatrixChain::push(const vpMatrix &A)
+{
+  if ((nfactors > 0) && (factors[nfactors-1]->getCols() != A.getRows())) {
+    vpERROR_TRACE("\n\t\tvpMatrix mismatch in vpMatrix/vpMatrix multiply") ;
+    throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                            "\n\t\tvpMatrix mismatch in "
+                            "vpMatrix/vpMatrix multiply")) ;
+  }
+  if (nfactors == MAX_FACTORS) {
+    vpMatrix &T = temporary(factors[0]->getRows(),
+                            factors[nfactors-1]->getCols());
+    multiply(T);
+    factors[0] = &T;
+    nfactors = 1;
+  }
+  factors[nfactors++] = &A;
+}
+
+/*!
+  Return a temporary matrix of size \e rows x \e cols, valid as long as
+  the chain, used to push the value of an expression that is not a
+  product.
+*/
+vpMatrix &
+vpMatrixChain::temporary(unsigned int rows, unsigned int cols)
+{
+  return workspace.acquire(rows, cols);
+}
+
+/*!
+  Compute in \e C the product of the factors and of the scalar. \e C
+  may be one of the factors.
+*/
+void
+vpMatrixChain::evaluate(vpMatrix &C)
+{
+  if (nfactors == 0) {
+    vpERROR_TRACE("Empty product of matrices") ;
+    throw(vpMatrixException(vpMatrixException::matrixError,
+                            "Empty product of matrices")) ;
+  }
+
+  bool aliased = false;
+  for (unsigned int i = 0; i < nfactors; i++)
+    if (factors[i] == &C)
+      aliased = true;
+
+  if (aliased) {
+    vpMatrix &T = temporary(factors[0]->getRows(),
+                            factors[nfactors-1]->getCols());
+    multiply(T);
+    C = T;
+  }
+  else
+    multiply(C);
+
+  if (coef != 1.)
+    C *= coef;
+}
+
+/*!
+  Compute in \e C, that is not one of the factors, the product of the
+  factors. The parenthesization that needs the fewest multiply-adds is
+  found by dynamic programming on the sizes of the factors.
+*/
+void
+vpMatrixChain::multiply(vpMatrix &C)
+{
+  unsigned int n = nfactors;
+  if (n == 1) {
+    C = *factors[0];
+    return;
+  }
+  if (n == 2) {
+    vpMatrix::mult2Matrices(*factors[0], *factors[1], C);
+    return;
+  }
+
+  // The factor i is a d[i] x d[i+1] matrix
+  double d[MAX_FACTORS+1];
+  for (unsigned int i = 0; i < n; i++)
+    d[i] = factors[i]->getRows();
+  d[n] = factors[n-1]->getCols();
+
+  // cost[i][j] is the cost of the product of the factors i to j and
+  // split[i][j] the factor after which it is split
+  double cost[MAX_FACTORS][MAX_FACTORS];
+  unsigned int split[MAX_FACTORS][MAX_FACTORS];
+  for (unsigned int i = 0; i < n; i++)
+    cost[i][i] = 0;
+  for (unsigned int len = 2; len <= n; len++) {
+    for (unsigned int i = 0; i + len <= n; i++) {
+      unsigned int j = i + len - 1;
+      cost[i][j] = -1;
+      for (unsigned int k = i; k < j; k++) {
+        double c = cost[i][k] + cost[k+1][j] + d[i]*d[k+1]*d[j+1];
+        if ((cost[i][j] < 0) || (c < cost[i][j])) {
+          cost[i][j] = c;
+          split[i][j] = k;
+        }
+      }
+    }
+  }
+
+  multiply(0, n-1, split, &C);
+}
+
+/*!
+  Return the product of the factors \e i to \e j, computed in \e C if it
+  is not NULL and in a temporary otherwise.
+*/
+const vpMatrix &
+vpMatrixChain::multiply(unsigned int i, unsigned int j,
+                        const unsigned int split[][MAX_FACTORS],
+                        vpMatrix *C)
+{
+  if (i == j) {
+    if (C == NULL)
+      return *factors[i];
+    *C = *factors[i];
+    return *C;
+  }
+
+  unsigned int k = split[i][j];
+  const vpMatrix &A = multiply(i, k, split, NULL);
+  const vpMatrix &B = multiply(k+1, j, split, NULL);
+  vpMatrix &R = (C != NULL) ? *C : temporary(A.getRows(), B.getCols());
+  vpMatrix::mult2Matrices(A, B, R);
+  return R;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
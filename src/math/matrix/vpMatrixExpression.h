@@ -0,0 +1,536 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Lazy expressions on matrices and vectors.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpMatrixExpression_H
+#define vpMatrixExpression_H
+
+/*!
+  \file vpMatrixExpression.h
+
+  \brief Lazy expressions returned by the arithmetic operators of
+  vpMatrix, vpColVector and vpRowVector.
+
+  This file is included by vpMatrix.h and should not be included
+  directly.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpMatrixException.h>
+#include <visp/vpDebug.h>
+
+#include <cmath>    // std::fabs
+#include <limits>   // numeric_limits
+#include <vector>
+
+class vpColVector;
+class vpRowVector;
+
+/*!
+  \class vpMatrixWorkspace
+  \ingroup Matrix
+
+  \brief Temporary matrices used to evaluate the matrix expressions.
+
+  The temporaries are taken from a pool shared by all the threads and
+  given back to it by the destructor. An expression evaluated at each
+  iteration of a loop thus finds in the pool the temporaries of the
+  previous iteration, with the same size, and doesn't allocate memory
+  after the first iteration.
+
+  getNbAllocations() and getNbReuses() count the temporaries that had
+  to be allocated or resized and the ones reused as they were.
+
+  A workspace can hold any number of temporaries; the first
+  NB_LOCAL_TEMPORARIES are kept in the workspace itself, the next ones
+  in a vector allocated for the largest expressions only.
+*/
+class VISP_EXPORT vpMatrixWorkspace
+{
+public:
+  //! Number of temporaries held without allocating memory.
+  static const unsigned int NB_LOCAL_TEMPORARIES = 16;
+
+  vpMatrixWorkspace();
+  ~vpMatrixWorkspace();
+
+  vpMatrix &acquire(unsigned int rows, unsigned int cols);
+
+  static void clearPool();
+  static unsigned long getNbAllocations();
+  static unsigned long getNbReuses();
+  static void resetCounters();
+
+private:
+  vpMatrix *temporaries[NB_LOCAL_TEMPORARIES];
+  unsigned int ntemporaries;
+  std::vector<vpMatrix *> moreTemporaries;
+
+  vpMatrixWorkspace(const vpMatrixWorkspace &);
+  vpMatrixWorkspace &operator=(const vpMatrixWorkspace &);
+};
+
+/*!
+  \class vpMatrixChain
+  \ingroup Matrix
+
+  \brief Product of a chain of matrices and of a scalar.
+
+  The factors are multiplied in the order that needs the fewest
+  multiply-adds, found by dynamic programming on their sizes. For
+  instance the product \f$L\;V\;J\f$ of a 2nx6 matrix, a 6x6 matrix and
+  a 6x1 vector is computed as \f$L\;(V\;J)\f$.
+*/
+class VISP_EXPORT vpMatrixChain
+{
+public:
+  //! Maximal number of factors; longer chains are partially evaluated.
+  static const unsigned int MAX_FACTORS = 8;
+
+  vpMatrixChain();
+
+  void push(const vpMatrix &A);
+  vpMatrix &temporary(unsigned int rows, unsigned int cols);
+  //! Multiply the product by \e s.
+  inline void scale(double s) { coef *= s; }
+  void evaluate(vpMatrix &C);
+
+private:
+  vpMatrixWorkspace workspace;
+  const vpMatrix *factors[MAX_FACTORS];
+  unsigned int nfactors;
+  double coef;
+
+  const vpMatrix &multiply(unsigned int i, unsigned int j,
+                           const unsigned int split[][MAX_FACTORS],
+                           vpMatrix *C);
+  void multiply(vpMatrix &C);
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// Type of the result of a sum and of a product of two expressions,
+// after their evaluation
+template<class L, class R> struct vpMatrixSumResult { typedef vpMatrix type; };
+template<> struct vpMatrixSumResult<vpColVector, vpColVector> { typedef vpColVector type; };
+template<> struct vpMatrixSumResult<vpRowVector, vpRowVector> { typedef vpRowVector type; };
+
+// double is a dot product, computed immediately
+template<class L, class R> struct vpMatrixProductResult { typedef vpMatrix type; };
+template<> struct vpMatrixProductResult<vpMatrix, vpColVector> { typedef vpColVector type; };
+template<> struct vpMatrixProductResult<vpRowVector, vpMatrix> { typedef vpRowVector type; };
+template<> struct vpMatrixProductResult<vpRowVector, vpRowVector> { typedef vpRowVector type; };
+template<> struct vpMatrixProductResult<vpRowVector, vpColVector> { typedef double type; };
+template<> struct vpMatrixProductResult<vpColVector, vpColVector> { typedef double type; };
+
+// Type of the transpose of a matrix or a vector
+template<class T> struct vpMatrixTransposeResult { typedef vpMatrix type; };
+template<> struct vpMatrixTransposeResult<vpColVector> { typedef vpRowVector type; };
+template<> struct vpMatrixTransposeResult<vpRowVector> { typedef vpColVector type; };
+
+// Element i of the value of an expression: a copy of the row i of a
+// matrix, or the element i of a vector. vpMatrixRowResult makes the row
+// type dependent, since vpRowVector is incomplete here.
+template<class T> struct vpMatrixRowResult { typedef vpRowVector type; };
+template<class T> struct vpMatrixElementResult
+{
+  typedef typename vpMatrixRowResult<T>::type type;
+  template<class M> static type get(const M &A, unsigned int i)
+  {
+    type r(A.getCols());
+    for (unsigned int j = 0; j < A.getCols(); j++)
+      r[j] = A[i][j];
+    return r;
+  }
+};
+template<> struct vpMatrixElementResult<vpColVector>
+{
+  typedef double type;
+  template<class V> static double get(const V &v, unsigned int i) { return v[i]; }
+};
+template<> struct vpMatrixElementResult<vpRowVector>
+{
+  typedef double type;
+  template<class V> static double get(const V &v, unsigned int i) { return v[i]; }
+};
+
+// Member functions of vpMatrix, vpColVector and vpRowVector that are
+// forwarded to the value of an expression, so that for instance
+// (A*B).t() or (a-b).sumSquare() compile as when the operators returned
+// a matrix. The value is evaluated at each call.
+#define VP_MATRIX_EXPRESSION_MEMBERS                                          \
+  typename vpMatrixTransposeResult<result_type>::type t() const               \
+  { result_type C; evalTo(C); return C.t(); }                                 \
+  double sumSquare() const                                                    \
+  { result_type C; evalTo(C); return C.sumSquare(); }                         \
+  double euclideanNorm() const                                                \
+  { result_type C; evalTo(C); return C.euclideanNorm(); }                     \
+  double infinityNorm() const                                                 \
+  { result_type C; evalTo(C); return C.infinityNorm(); }                      \
+  vpMatrix pseudoInverse(double svThreshold = 1e-6) const                     \
+  { result_type C; evalTo(C); return C.pseudoInverse(svThreshold); }          \
+  unsigned int pseudoInverse(vpMatrix &Ap, double svThreshold = 1e-6) const   \
+  { result_type C; evalTo(C); return C.pseudoInverse(Ap, svThreshold); }      \
+  unsigned int pseudoInverse(vpMatrix &Ap, vpColVector &sv,                   \
+                             double svThreshold = 1e-6) const                 \
+  { result_type C; evalTo(C); return C.pseudoInverse(Ap, sv, svThreshold); }  \
+  vpMatrix inverseByLU() const                                                \
+  { result_type C; evalTo(C); return C.inverseByLU(); }                       \
+  typename vpMatrixElementResult<result_type>::type                           \
+  operator[](unsigned int i) const                                            \
+  { result_type C; evalTo(C); return vpMatrixElementResult<result_type>::get(C, i); }
+
+/*
+  Each expression E provides:
+  - E::result_type, the type of its value;
+  - E::isProduct, non zero if its value is computed by vpMatrixChain;
+  - getRows(), getCols();
+  - prepare(), which evaluates its products in temporaries of a
+    workspace, and then coeff(i, j), the element (i, j) of its value;
+  - pushFactors(), which adds its factors to a vpMatrixChain;
+  - evalTo(), which evaluates it in a matrix.
+  The expressions returned by the operators also have the members of
+  VP_MATRIX_EXPRESSION_MEMBERS.
+*/
+template<class E>
+class vpMatrixExpression
+{
+public:
+  inline const E &derived() const { return *static_cast<const E *>(this); }
+  inline unsigned int getRows() const { return derived().getRows(); }
+  inline unsigned int getCols() const { return derived().getCols(); }
+};
+
+template<bool product> struct vpMatrixEvaluator;
+
+// Products are evaluated by a chain
+template<>
+struct vpMatrixEvaluator<true>
+{
+  template<class E>
+  static void run(const E &e, vpMatrix &C)
+  {
+    vpMatrixChain chain;
+    e.pushFactors(chain);
+    chain.evaluate(C);
+  }
+};
+
+// Element-wise expressions are evaluated in a single pass once their
+// products are evaluated. C may be one of their operands since the
+// element (i, j) only depends on the elements (i, j) of the operands.
+template<>
+struct vpMatrixEvaluator<false>
+{
+  template<class E>
+  static void run(const E &e, vpMatrix &C)
+  {
+    vpMatrixWorkspace workspace;
+    e.prepare(workspace);
+    unsigned int rows = e.getRows(), cols = e.getCols();
+    if ((C.getRows() != rows) || (C.getCols() != cols))
+      C.resize(rows, cols, false);
+    for (unsigned int i = 0; i < rows; i++) {
+      double *ci = C[i];
+      for (unsigned int j = 0; j < cols; j++)
+        ci[j] = e.coeff(i, j);
+    }
+  }
+};
+
+// Operand of an expression that is a matrix or a vector of type T
+template<class T>
+class vpMatrixLeaf : public vpMatrixExpression<vpMatrixLeaf<T> >
+{
+public:
+  typedef T result_type;
+  enum { isProduct = 0 };
+
+  explicit vpMatrixLeaf(const T &A) : m(&A) {}
+
+  inline unsigned int getRows() const { return m->getRows(); }
+  inline unsigned int getCols() const { return m->getCols(); }
+  inline void prepare(vpMatrixWorkspace &) const {}
+  inline double coeff(unsigned int i, unsigned int j) const { return (*m)[i][j]; }
+  inline void pushFactors(vpMatrixChain &chain) const { chain.push(*m); }
+  inline void evalTo(vpMatrix &C) const { if (&C != m) C = *m; }
+
+private:
+  const vpMatrix *m;
+};
+
+// a*L + b*R
+template<class L, class R>
+class vpMatrixLinear : public vpMatrixExpression<vpMatrixLinear<L, R> >
+{
+public:
+  typedef typename vpMatrixSumResult<typename L::result_type,
+                                     typename R::result_type>::type result_type;
+  enum { isProduct = 0 };
+
+  vpMatrixLinear(const L &l, double a, const R &r, double b)
+    : lhs(l), rhs(r), alpha(a), beta(b)
+  {
+    if ((l.getRows() != r.getRows()) || (l.getCols() != r.getCols())) {
+      vpERROR_TRACE("\n\t\t vpMatrix mismatch in vpMatrix/vpMatrix addition") ;
+      throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                              "\n\t\t vpMatrix mismatch in "
+                              "vpMatrix/vpMatrix addition")) ;
+    }
+  }
+
+  inline unsigned int getRows() const { return lhs.getRows(); }
+  inline unsigned int getCols() const { return lhs.getCols(); }
+  inline void prepare(vpMatrixWorkspace &w) const { lhs.prepare(w); rhs.prepare(w); }
+  inline double coeff(unsigned int i, unsigned int j) const
+  { return alpha * lhs.coeff(i, j) + beta * rhs.coeff(i, j); }
+  void pushFactors(vpMatrixChain &chain) const
+  {
+    vpMatrix &T = chain.temporary(getRows(), getCols());
+    evalTo(T);
+    chain.push(T);
+  }
+  inline void evalTo(vpMatrix &C) const { vpMatrixEvaluator<false>::run(*this, C); }
+  operator result_type() const { result_type C; evalTo(C); return C; }
+  VP_MATRIX_EXPRESSION_MEMBERS
+
+private:
+  L lhs;
+  R rhs;
+  double alpha, beta;
+};
+
+// s*E
+template<class E>
+class vpMatrixScaled : public vpMatrixExpression<vpMatrixScaled<E> >
+{
+public:
+  typedef typename E::result_type result_type;
+  enum { isProduct = E::isProduct };
+
+  vpMatrixScaled(const E &e, double s) : expr(e), scale(s) {}
+
+  inline unsigned int getRows() const { return expr.getRows(); }
+  inline unsigned int getCols() const { return expr.getCols(); }
+  inline void prepare(vpMatrixWorkspace &w) const { expr.prepare(w); }
+  inline double coeff(unsigned int i, unsigned int j) const
+  { return expr.coeff(i, j) * scale; }
+  inline void pushFactors(vpMatrixChain &chain) const
+  { expr.pushFactors(chain); chain.scale(scale); }
+  inline void evalTo(vpMatrix &C) const
+  { vpMatrixEvaluator<(isProduct != 0)>::run(*this, C); }
+  operator result_type() const { result_type C; evalTo(C); return C; }
+  VP_MATRIX_EXPRESSION_MEMBERS
+
+private:
+  E expr;
+  double scale;
+};
+
+// L*R
+template<class L, class R>
+class vpMatrixProduct : public vpMatrixExpression<vpMatrixProduct<L, R> >
+{
+public:
+  typedef typename vpMatrixProductResult<typename L::result_type,
+                                         typename R::result_type>::type result_type;
+  enum { isProduct = 1 };
+
+  vpMatrixProduct(const L &l, const R &r) : lhs(l), rhs(r), value(NULL)
+  {
+    if (l.getCols() != r.getRows()) {
+      vpERROR_TRACE("\n\t\tvpMatrix mismatch in vpMatrix/vpMatrix multiply") ;
+      throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                              "\n\t\tvpMatrix mismatch in "
+                              "vpMatrix/vpMatrix multiply")) ;
+    }
+  }
+
+  inline unsigned int getRows() const { return lhs.getRows(); }
+  inline unsigned int getCols() const { return rhs.getCols(); }
+  void prepare(vpMatrixWorkspace &w) const
+  {
+    vpMatrix &T = w.acquire(getRows(), getCols());
+    evalTo(T);
+    value = &T;
+  }
+  inline double coeff(unsigned int i, unsigned int j) const { return (*value)[i][j]; }
+  inline void pushFactors(vpMatrixChain &chain) const
+  { lhs.pushFactors(chain); rhs.pushFactors(chain); }
+  inline void evalTo(vpMatrix &C) const { vpMatrixEvaluator<true>::run(*this, C); }
+  operator result_type() const { result_type C; evalTo(C); return C; }
+  VP_MATRIX_EXPRESSION_MEMBERS
+
+private:
+  L lhs;
+  R rhs;
+  // Value computed by prepare()
+  mutable const vpMatrix *value;
+};
+
+// Builds the product of two expressions, or computes it when it is a
+// dot product
+template<class L, class R,
+         class Result = typename vpMatrixProductResult<typename L::result_type,
+                                                       typename R::result_type>::type>
+struct vpMatrixProductMaker
+{
+  typedef vpMatrixProduct<L, R> type;
+  static inline type make(const L &l, const R &r) { return type(l, r); }
+};
+
+template<class L, class R>
+struct vpMatrixProductMaker<L, R, double>
+{
+  typedef double type;
+  static double make(const L &l, const R &r)
+  {
+    unsigned int n = l.getRows() * l.getCols();
+    if (n != r.getRows() * r.getCols()) {
+      vpERROR_TRACE("\n\t\tvpMatrix mismatch in dot product") ;
+      throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                              "\n\t\tvpMatrix mismatch in dot product")) ;
+    }
+    vpMatrixWorkspace workspace;
+    vpMatrix &a = workspace.acquire(l.getRows(), l.getCols());
+    vpMatrix &b = workspace.acquire(r.getRows(), r.getCols());
+    l.evalTo(a);
+    r.evalTo(b);
+    double s = 0;
+    for (unsigned int i = 0; i < n; i++)
+      s += a.data[i] * b.data[i];
+    return s;
+  }
+};
+
+template<class E>
+vpMatrix &vpMatrix::operator=(const vpMatrixExpression<E> &e)
+{
+  e.derived().evalTo(*this);
+  return *this;
+}
+
+//
+// Operators on expressions
+//
+
+template<class L, class R>
+inline vpMatrixLinear<L, R>
+operator+(const vpMatrixExpression<L> &l, const vpMatrixExpression<R> &r)
+{ return vpMatrixLinear<L, R>(l.derived(), 1., r.derived(), 1.); }
+
+template<class L, class R>
+inline vpMatrixLinear<L, R>
+operator-(const vpMatrixExpression<L> &l, const vpMatrixExpression<R> &r)
+{ return vpMatrixLinear<L, R>(l.derived(), 1., r.derived(), -1.); }
+
+template<class L, class R>
+inline typename vpMatrixProductMaker<L, R>::type
+operator*(const vpMatrixExpression<L> &l, const vpMatrixExpression<R> &r)
+{ return vpMatrixProductMaker<L, R>::make(l.derived(), r.derived()); }
+
+template<class E>
+inline vpMatrixScaled<E>
+operator*(const double &x, const vpMatrixExpression<E> &e)
+{ return vpMatrixScaled<E>(e.derived(), x); }
+
+template<class E>
+inline vpMatrixScaled<E>
+operator*(const vpMatrixExpression<E> &e, const double &x)
+{ return vpMatrixScaled<E>(e.derived(), x); }
+
+template<class E>
+inline vpMatrixScaled<E>
+operator/(const vpMatrixExpression<E> &e, const double &x)
+{
+  if (std::fabs(x) <= std::numeric_limits<double>::epsilon()) {
+    vpERROR_TRACE("Divide by zero in method /(double x)") ;
+    throw vpMatrixException(vpMatrixException::divideByZeroError, "Divide by zero in method /(double x)");
+  }
+  return vpMatrixScaled<E>(e.derived(), 1/x);
+}
+
+template<class E>
+inline vpMatrixScaled<E>
+operator-(const vpMatrixExpression<E> &e)
+{ return vpMatrixScaled<E>(e.derived(), -1.); }
+
+// Operators between a matrix or a vector of type T and an expression
+#define VP_MATRIX_EXPRESSION_OPERATORS(T)                                     \
+template<class R>                                                             \
+inline vpMatrixLinear<vpMatrixLeaf<T>, R>                                     \
+operator+(const T &l, const vpMatrixExpression<R> &r)                         \
+{ return vpMatrixLinear<vpMatrixLeaf<T>, R>(vpMatrixLeaf<T>(l), 1., r.derived(), 1.); } \
+template<class L>                                                             \
+inline vpMatrixLinear<L, vpMatrixLeaf<T> >                                    \
+operator+(const vpMatrixExpression<L> &l, const T &r)                         \
+{ return vpMatrixLinear<L, vpMatrixLeaf<T> >(l.derived(), 1., vpMatrixLeaf<T>(r), 1.); } \
+template<class R>                                                             \
+inline vpMatrixLinear<vpMatrixLeaf<T>, R>                                     \
+operator-(const T &l, const vpMatrixExpression<R> &r)                         \
+{ return vpMatrixLinear<vpMatrixLeaf<T>, R>(vpMatrixLeaf<T>(l), 1., r.derived(), -1.); } \
+template<class L>                                                             \
+inline vpMatrixLinear<L, vpMatrixLeaf<T> >                                    \
+operator-(const vpMatrixExpression<L> &l, const T &r)                         \
+{ return vpMatrixLinear<L, vpMatrixLeaf<T> >(l.derived(), 1., vpMatrixLeaf<T>(r), -1.); } \
+template<class R>                                                             \
+inline typename vpMatrixProductMaker<vpMatrixLeaf<T>, R>::type                \
+operator*(const T &l, const vpMatrixExpression<R> &r)                         \
+{ return vpMatrixProductMaker<vpMatrixLeaf<T>, R>::make(vpMatrixLeaf<T>(l), r.derived()); } \
+template<class L>                                                             \
+inline typename vpMatrixProductMaker<L, vpMatrixLeaf<T> >::type               \
+operator*(const vpMatrixExpression<L> &l, const T &r)                         \
+{ return vpMatrixProductMaker<L, vpMatrixLeaf<T> >::make(l.derived(), vpMatrixLeaf<T>(r)); }
+
+VP_MATRIX_EXPRESSION_OPERATORS(vpMatrix)
+VP_MATRIX_EXPRESSION_OPERATORS(vpColVector)
+VP_MATRIX_EXPRESSION_OPERATORS(vpRowVector)
+
+#undef VP_MATRIX_EXPRESSION_OPERATORS
+#undef VP_MATRIX_EXPRESSION_MEMBERS
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
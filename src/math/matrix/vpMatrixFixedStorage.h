@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Compile-time sized storage and products of small matrices.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpMatrixFixedStorage_H
+#define vpMatrixFixedStorage_H
+
+/*!
+  \file vpMatrixFixedStorage.h
+
+  \brief Compile-time sized storage of the elements of a vpMatrix, and
+  products of small matrices with sizes known at compile time.
+*/
+
+#include <visp/vpConfig.h>
+
+/*!
+  \class vpMatrixFixedStorage
+
+  \ingroup Matrix
+
+  \brief Storage of the elements and of the row pointers of a \e R by
+  \e C matrix, embedded in the object that owns it.
+
+  The transformation classes that derive from vpMatrix or vpColVector
+  and always have the same size (vpHomogeneousMatrix,
+  vpRotationMatrix, vpVelocityTwistMatrix, vpForceTwistMatrix,
+  vpTranslationVector, vpPoseVector) hold one of them and give it to
+  vpMatrix::attach() in their init() method. Their elements are then
+  stored in the object itself, on the stack for a local variable,
+  instead of in two heap blocks. They are still accessed through
+  vpMatrix::data and the row pointers, so that all the vpMatrix
+  methods apply to them. If such a matrix is resized to another size,
+  vpMatrix::resize() moves its elements to the heap.
+
+  The copy of a storage does not copy anything: the elements are copied
+  by the vpMatrix copy operators, and the row pointers of each object
+  must point to its own elements.
+*/
+template<unsigned int R, unsigned int C>
+class vpMatrixFixedStorage
+{
+public:
+  vpMatrixFixedStorage() {}
+  vpMatrixFixedStorage(const vpMatrixFixedStorage &) {}
+  vpMatrixFixedStorage &operator=(const vpMatrixFixedStorage &) { return *this; }
+
+  //! Elements, row by row.
+  double data[R * C];
+  //! Address of the first element of each row.
+  double *rowPtrs[R];
+};
+
+/*!
+  \relates vpMatrixFixedStorage
+
+  Product \f$ AB = A B \f$ of a \e R by \e K matrix by a \e K by \e C
+  matrix, stored row by row. The loops have constant bounds, which
+  lets the compiler unroll them. \e AB must not be \e A or \e B.
+*/
+template<unsigned int R, unsigned int K, unsigned int C>
+inline void vpFixedMult(const double *A, const double *B, double *AB)
+{
+  for (unsigned int i = 0; i < R; i++) {
+    for (unsigned int j = 0; j < C; j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < K; k++)
+        s += A[i * K + k] * B[k * C + j];
+      AB[i * C + j] = s;
+    }
+  }
+}
+
+/*!
+  \relates vpMatrixFixedStorage
+
+  Product \f$ Av = A v \f$ of a \e R by \e C matrix stored row by row
+  by a vector of size \e C. \e Av must not be \e v.
+*/
+template<unsigned int R, unsigned int C>
+inline void vpFixedMultVector(const double *A, const double *v, double *Av)
+{
+  for (unsigned int i = 0; i < R; i++) {
+    double s = 0;
+    for (unsigned int j = 0; j < C; j++)
+      s += A[i * C + j] * v[j];
+    Av[i] = s;
+  }
+}
+
+/*!
+  \relates vpMatrixFixedStorage
+
+  Product \f$ Atv = A^T v \f$ of the transpose of a \e R by \e C matrix
+  stored row by row by a vector of size \e R. \e Atv must not be \e v.
+*/
+template<unsigned int R, unsigned int C>
+inline void vpFixedMultTransposeVector(const double *A, const double *v, double *Atv)
+{
+  for (unsigned int j = 0; j < C; j++) {
+    double s = 0;
+    for (unsigned int i = 0; i < R; i++)
+      s += A[i * C + j] * v[i];
+    Atv[j] = s;
+  }
+}
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
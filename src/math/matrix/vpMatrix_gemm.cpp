@@ -0,0 +1,940 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Blocked, SIMD and multithreaded matrix products.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMatrix_gemm.cpp
+  \brief Definition of the matrix products of the vpMatrix class.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpColVector.h>
+
+// Exception
+#include <visp/vpException.h>
+#include <visp/vpMatrixException.h>
+
+// Debug trace
+#include <visp/vpDebug.h>
+
+#include <string.h>
+
+#ifdef VISP_HAVE_SSE2
+// The AVX2 kernels are compiled for their own instruction set and only
+// called when the processor supports it
+#  if (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || defined(__clang__)
+#    include <immintrin.h>
+#    define VP_GEMM_DISPATCH
+#    define VP_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#  elif defined(_MSC_VER) && (_MSC_VER >= 1800)
+#    include <immintrin.h>
+#    include <intrin.h>
+#    define VP_GEMM_DISPATCH
+#    define VP_TARGET_AVX2
+#  endif
+#endif
+
+#ifdef VISP_HAVE_LAPACK
+extern "C" void dgemm_(char *transa, char *transb, int *m, int *n, int *k,
+                       double *alpha, double *a, int *lda, double *b, int *ldb,
+                       double *beta, double *c, int *ldc);
+extern "C" void dgemv_(char *trans, int *m, int *n, double *alpha, double *a,
+                       int *lda, double *x, int *incx, double *beta,
+                       double *y, int *incy);
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Size of the tile of C computed by a micro-kernel
+  const unsigned int vpGemmMR = 6;
+  const unsigned int vpGemmNR = 8;
+  // Rows of A (L2 cache), inner dimension (L1 cache) and columns of B
+  // (L3 cache) of a packed block
+  const unsigned int vpGemmMC = 96;
+  const unsigned int vpGemmKC = 256;
+  const unsigned int vpGemmNC = 2048;
+  // Products with less multiply-adds keep the original loops
+  const double vpGemmMinOps = 24.*24.*24.;
+  // Products with less multiply-adds are computed by a single thread
+  const double vpGemmParallelMinOps = 128.*128.*128.;
+  // Matrix-vector products with less elements use a single thread
+  const double vpGemvParallelMinSize = 256.*256.;
+
+  // Number of threads used by the large products
+  unsigned int vpGemmThreads = 1;
+  // Implementation in use, -1 until the processor is probed
+  int vpGemmImpl = -1;
+
+  // Computes the MR x NR tile c (or adds it to c) from kc columns of a
+  // packed panel of A and kc rows of a packed panel of B
+  typedef void (*vpGemmKernel)(unsigned int kc, const double *a,
+                               const double *b, double *c, unsigned int ldc,
+                               bool add);
+  // Dot product of two vectors of size n
+  typedef double (*vpDotKernel)(const double *x, const double *y,
+                                unsigned int n);
+
+  // Operand of a product. Element (r, c) is data[r*stride+c], or
+  // data[c*stride+r] when the stored matrix is used transposed.
+  struct vpGemmOperand
+  {
+    const double *data;
+    unsigned int stride;
+    bool trans;
+
+    vpGemmOperand(const double *d, unsigned int s, bool t)
+      : data(d), stride(s), trans(t) {}
+  };
+
+  // Uninitialized buffer released at the end of the scope
+  class vpGemmBuffer
+  {
+  public:
+    double *ptr;
+    explicit vpGemmBuffer(size_t n) : ptr(new double[n]) {}
+    ~vpGemmBuffer() { delete [] ptr; }
+  private:
+    vpGemmBuffer(const vpGemmBuffer &);
+    vpGemmBuffer &operator=(const vpGemmBuffer &);
+  };
+
+  inline unsigned int minSize(unsigned int a, unsigned int b)
+  {
+    return (a < b) ? a : b;
+  }
+
+  vpMatrix::vpGemmType detectGemm()
+  {
+#if defined(VP_GEMM_DISPATCH) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int nids = info[0];
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool avx = ((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0)
+      && ((_xgetbv(0) & 6) == 6);
+    bool avx2 = false;
+    if (avx && nids >= 7) {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    if (avx2 && fma) return vpMatrix::GEMM_AVX2;
+    return vpMatrix::GEMM_BLOCKED;
+#elif defined(VP_GEMM_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return vpMatrix::GEMM_AVX2;
+    return vpMatrix::GEMM_BLOCKED;
+#else
+    return vpMatrix::GEMM_BLOCKED;
+#endif
+  }
+
+  unsigned int gemmThreads(double size, double minSize)
+  {
+#ifdef VISP_HAVE_OPENMP
+    if (size >= minSize)
+      return vpGemmThreads;
+#else
+    (void)size;
+    (void)minSize;
+#endif
+    return 1;
+  }
+
+  // Packs the mc x kc block of A starting at (i0, k0) in panels of MR
+  // rows. Each panel stores its kc columns one after the other; the rows
+  // after the last one of A are set to 0.
+  void packA(const vpGemmOperand &A, unsigned int i0, unsigned int k0,
+             unsigned int mc, unsigned int kc, double *buf)
+  {
+    for (unsigned int ip = 0; ip < mc; ip += vpGemmMR) {
+      unsigned int mr = minSize(vpGemmMR, mc - ip);
+      if (A.trans) {
+        for (unsigned int k = 0; k < kc; k++) {
+          const double *src = A.data + (size_t)(k0 + k)*A.stride + i0 + ip;
+          double *dst = buf + k*vpGemmMR;
+          unsigned int r = 0;
+          for (; r < mr; r++) dst[r] = src[r];
+          for (; r < vpGemmMR; r++) dst[r] = 0.;
+        }
+      }
+      else {
+        for (unsigned int r = 0; r < vpGemmMR; r++) {
+          double *dst = buf + r;
+          if (r < mr) {
+            const double *src = A.data + (size_t)(i0 + ip + r)*A.stride + k0;
+            for (unsigned int k = 0; k < kc; k++) dst[k*vpGemmMR] = src[k];
+          }
+          else {
+            for (unsigned int k = 0; k < kc; k++) dst[k*vpGemmMR] = 0.;
+          }
+        }
+      }
+      buf += vpGemmMR*kc;
+    }
+  }
+
+  // Packs the kc x nc block of B starting at (k0, j0) in panels of NR
+  // columns. Each panel stores its kc rows one after the other; the
+  // columns after the last one of B are set to 0.
+  void packB(const vpGemmOperand &B, unsigned int k0, unsigned int j0,
+             unsigned int kc, unsigned int nc, double *buf)
+  {
+    for (unsigned int jp = 0; jp < nc; jp += vpGemmNR) {
+      unsigned int nr = minSize(vpGemmNR, nc - jp);
+      if (B.trans) {
+        for (unsigned int c = 0; c < vpGemmNR; c++) {
+          double *dst = buf + c;
+          if (c < nr) {
+            const double *src = B.data + (size_t)(j0 + jp + c)*B.stride + k0;
+            for (unsigned int k = 0; k < kc; k++) dst[k*vpGemmNR] = src[k];
+          }
+          else {
+            for (unsigned int k = 0; k < kc; k++) dst[k*vpGemmNR] = 0.;
+          }
+        }
+      }
+      else {
+        for (unsigned int k = 0; k < kc; k++) {
+          const double *src = B.data + (size_t)(k0 + k)*B.stride + j0 + jp;
+          double *dst = buf + k*vpGemmNR;
+          unsigned int c = 0;
+          for (; c < nr; c++) dst[c] = src[c];
+          for (; c < vpGemmNR; c++) dst[c] = 0.;
+        }
+      }
+      buf += vpGemmNR*kc;
+    }
+  }
+
+  void gemmKernelScalar(unsigned int kc, const double *a, const double *b,
+                        double *c, unsigned int ldc, bool add)
+  {
+    double acc[vpGemmMR][vpGemmNR];
+    for (unsigned int i = 0; i < vpGemmMR; i++)
+      for (unsigned int j = 0; j < vpGemmNR; j++)
+        acc[i][j] = 0.;
+
+    for (unsigned int k = 0; k < kc; k++) {
+      for (unsigned int i = 0; i < vpGemmMR; i++) {
+        double ai = a[i];
+        for (unsigned int j = 0; j < vpGemmNR; j++)
+          acc[i][j] += ai * b[j];
+      }
+      a += vpGemmMR;
+      b += vpGemmNR;
+    }
+
+    for (unsigned int i = 0; i < vpGemmMR; i++) {
+      double *ci = c + i*ldc;
+      if (add)
+        for (unsigned int j = 0; j < vpGemmNR; j++) ci[j] += acc[i][j];
+      else
+        for (unsigned int j = 0; j < vpGemmNR; j++) ci[j] = acc[i][j];
+    }
+  }
+
+  double dotKernelScalar(const double *x, const double *y, unsigned int n)
+  {
+    // Four partial sums break the dependency between the additions
+    double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4) {
+      s0 += x[i] * y[i];
+      s1 += x[i+1] * y[i+1];
+      s2 += x[i+2] * y[i+2];
+      s3 += x[i+3] * y[i+3];
+    }
+    for (; i < n; i++) s0 += x[i] * y[i];
+    return (s0 + s1) + (s2 + s3);
+  }
+
+#ifdef VP_GEMM_DISPATCH
+  // 6 x 8 tile held in 12 registers; each step broadcasts one element of
+  // the panel of A and multiplies it with two vectors of the panel of B
+  VP_TARGET_AVX2
+  void gemmKernelAvx2(unsigned int kc, const double *a, const double *b,
+                      double *c, unsigned int ldc, bool add)
+  {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for (unsigned int k = 0; k < kc; k++) {
+      __m256d b0 = _mm256_loadu_pd(b);
+      __m256d b1 = _mm256_loadu_pd(b + 4);
+      __m256d ai = _mm256_broadcast_sd(a);
+      c00 = _mm256_fmadd_pd(ai, b0, c00);
+      c01 = _mm256_fmadd_pd(ai, b1, c01);
+      ai = _mm256_broadcast_sd(a + 1);
+      c10 = _mm256_fmadd_pd(ai, b0, c10);
+      c11 = _mm256_fmadd_pd(ai, b1, c11);
+      ai = _mm256_broadcast_sd(a + 2);
+      c20 = _mm256_fmadd_pd(ai, b0, c20);
+      c21 = _mm256_fmadd_pd(ai, b1, c21);
+      ai = _mm256_broadcast_sd(a + 3);
+      c30 = _mm256_fmadd_pd(ai, b0, c30);
+      c31 = _mm256_fmadd_pd(ai, b1, c31);
+      ai = _mm256_broadcast_sd(a + 4);
+      c40 = _mm256_fmadd_pd(ai, b0, c40);
+      c41 = _mm256_fmadd_pd(ai, b1, c41);
+      ai = _mm256_broadcast_sd(a + 5);
+      c50 = _mm256_fmadd_pd(ai, b0, c50);
+      c51 = _mm256_fmadd_pd(ai, b1, c51);
+      a += vpGemmMR;
+      b += vpGemmNR;
+    }
+
+    if (add) {
+      c00 = _mm256_add_pd(c00, _mm256_loadu_pd(c));
+      c01 = _mm256_add_pd(c01, _mm256_loadu_pd(c + 4));
+      c10 = _mm256_add_pd(c10, _mm256_loadu_pd(c + ldc));
+      c11 = _mm256_add_pd(c11, _mm256_loadu_pd(c + ldc + 4));
+      c20 = _mm256_add_pd(c20, _mm256_loadu_pd(c + 2*ldc));
+      c21 = _mm256_add_pd(c21, _mm256_loadu_pd(c + 2*ldc + 4));
+      c30 = _mm256_add_pd(c30, _mm256_loadu_pd(c + 3*ldc));
+      c31 = _mm256_add_pd(c31, _mm256_loadu_pd(c + 3*ldc + 4));
+      c40 = _mm256_add_pd(c40, _mm256_loadu_pd(c + 4*ldc));
+      c41 = _mm256_add_pd(c41, _mm256_loadu_pd(c + 4*ldc + 4));
+      c50 = _mm256_add_pd(c50, _mm256_loadu_pd(c + 5*ldc));
+      c51 = _mm256_add_pd(c51, _mm256_loadu_pd(c + 5*ldc + 4));
+    }
+    _mm256_storeu_pd(c, c00);
+    _mm256_storeu_pd(c + 4, c01);
+    _mm256_storeu_pd(c + ldc, c10);
+    _mm256_storeu_pd(c + ldc + 4, c11);
+    _mm256_storeu_pd(c + 2*ldc, c20);
+    _mm256_storeu_pd(c + 2*ldc + 4, c21);
+    _mm256_storeu_pd(c + 3*ldc, c30);
+    _mm256_storeu_pd(c + 3*ldc + 4, c31);
+    _mm256_storeu_pd(c + 4*ldc, c40);
+    _mm256_storeu_pd(c + 4*ldc + 4, c41);
+    _mm256_storeu_pd(c + 5*ldc, c50);
+    _mm256_storeu_pd(c + 5*ldc + 4, c51);
+  }
+
+  VP_TARGET_AVX2
+  double dotKernelAvx2(const double *x, const double *y, unsigned int n)
+  {
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8) {
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+      s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), s1);
+    }
+    for (; i + 4 <= n; i += 4)
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+    s0 = _mm256_add_pd(s0, s1);
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s0), _mm256_extractf128_pd(s0, 1));
+    h = _mm_add_sd(h, _mm_unpackhi_pd(h, h));
+    double s = _mm_cvtsd_f64(h);
+    for (; i < n; i++) s += x[i] * y[i];
+    return s;
+  }
+#endif
+
+  vpGemmKernel selectGemmKernel()
+  {
+#ifdef VP_GEMM_DISPATCH
+    if (vpMatrix::getGemmType() == vpMatrix::GEMM_AVX2)
+      return gemmKernelAvx2;
+#endif
+    return gemmKernelScalar;
+  }
+
+  vpDotKernel selectDotKernel()
+  {
+#ifdef VP_GEMM_DISPATCH
+    if (vpMatrix::getGemmType() == vpMatrix::GEMM_AVX2)
+      return dotKernelAvx2;
+#endif
+    return dotKernelScalar;
+  }
+
+  // Computes the tiles of the mc x nc block of C from the packed blocks
+  // of A and B. The incomplete tiles of the borders are computed in a
+  // local tile and then copied.
+  void gemmMacroKernel(vpGemmKernel kernel, unsigned int mc, unsigned int nc,
+                       unsigned int kc, const double *Apack,
+                       const double *Bpack, double *C, unsigned int ldc,
+                       bool add)
+  {
+    double tile[vpGemmMR*vpGemmNR];
+    for (unsigned int jp = 0; jp < nc; jp += vpGemmNR) {
+      unsigned int nr = minSize(vpGemmNR, nc - jp);
+      const double *b = Bpack + (size_t)jp*kc;
+      for (unsigned int ip = 0; ip < mc; ip += vpGemmMR) {
+        unsigned int mr = minSize(vpGemmMR, mc - ip);
+        const double *a = Apack + (size_t)ip*kc;
+        double *c = C + (size_t)ip*ldc + jp;
+        if (mr == vpGemmMR && nr == vpGemmNR) {
+          kernel(kc, a, b, c, ldc, add);
+        }
+        else {
+          kernel(kc, a, b, tile, vpGemmNR, false);
+          for (unsigned int i = 0; i < mr; i++) {
+            double *ci = c + (size_t)i*ldc;
+            const double *ti = tile + i*vpGemmNR;
+            if (add)
+              for (unsigned int j = 0; j < nr; j++) ci[j] += ti[j];
+            else
+              for (unsigned int j = 0; j < nr; j++) ci[j] = ti[j];
+          }
+        }
+      }
+    }
+  }
+
+  // C (m x n, ldc) = A(:, k0:k1) * B(k0:k1, :). The blocks of MC rows of
+  // A are shared between nthreads threads, each one packing its own
+  // blocks in its part of the A buffer.
+  void gemmRange(vpGemmKernel kernel, const vpGemmOperand &A,
+                 const vpGemmOperand &B, double *C, unsigned int ldc,
+                 unsigned int m, unsigned int n, unsigned int k0,
+                 unsigned int k1, int nthreads)
+  {
+    unsigned int kcMax = minSize(vpGemmKC, k1 - k0);
+    unsigned int ncMax = minSize(vpGemmNC, ((n + vpGemmNR - 1)/vpGemmNR)*vpGemmNR);
+    unsigned int mcMax = minSize(vpGemmMC, ((m + vpGemmMR - 1)/vpGemmMR)*vpGemmMR);
+    unsigned int nblocks = (m + vpGemmMC - 1)/vpGemmMC;
+    if (nthreads > (int)nblocks) nthreads = (int)nblocks;
+
+    vpGemmBuffer Bpack((size_t)kcMax*ncMax);
+    vpGemmBuffer Apack((size_t)nthreads*mcMax*kcMax);
+
+    for (unsigned int jc = 0; jc < n; jc += vpGemmNC) {
+      unsigned int nc = minSize(vpGemmNC, n - jc);
+      for (unsigned int pc = k0; pc < k1; pc += vpGemmKC) {
+        unsigned int kc = minSize(vpGemmKC, k1 - pc);
+        bool add = (pc != k0);
+        packB(B, pc, jc, kc, nc, Bpack.ptr);
+#ifdef VISP_HAVE_OPENMP
+        #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+        for (int t = 0; t < nthreads; t++) {
+          double *a = Apack.ptr + (size_t)t*mcMax*kcMax;
+          for (unsigned int ib = (unsigned int)t; ib < nblocks; ib += (unsigned int)nthreads) {
+            unsigned int ic = ib*vpGemmMC;
+            unsigned int mc = minSize(vpGemmMC, m - ic);
+            packA(A, ic, pc, mc, kc, a);
+            gemmMacroKernel(kernel, mc, nc, kc, a, Bpack.ptr,
+                            C + (size_t)ic*ldc + jc, ldc, add);
+          }
+        }
+      }
+    }
+  }
+
+#ifdef VISP_HAVE_LAPACK
+  // Row major C = A * B is the column major C^T = B^T * A^T, which is
+  // what dgemm computes from the row major arrays of B and A
+  void gemmBlas(const vpGemmOperand &A, const vpGemmOperand &B, double *C,
+                unsigned int m, unsigned int n, unsigned int k)
+  {
+    char transa = A.trans ? 'T' : 'N';
+    char transb = B.trans ? 'T' : 'N';
+    int im = (int)m, in = (int)n, ik = (int)k;
+    int lda = (int)A.stride, ldb = (int)B.stride, ldc = (int)n;
+    double alpha = 1., beta = 0.;
+    dgemm_(&transb, &transa, &in, &im, &ik, &alpha, (double *)B.data, &ldb,
+           (double *)A.data, &lda, &beta, C, &ldc);
+  }
+#endif
+
+  // C (m x n) = A (m x k) * B (k x n) with the implementation selected
+  // by vpMatrix::setGemmType(), other than GEMM_NAIVE. m, n and k are
+  // not 0.
+  void gemm(const vpGemmOperand &A, const vpGemmOperand &B, double *C,
+            unsigned int m, unsigned int n, unsigned int k)
+  {
+#ifdef VISP_HAVE_LAPACK
+    if (vpMatrix::getGemmType() == vpMatrix::GEMM_BLAS) {
+      gemmBlas(A, B, C, m, n, k);
+      return;
+    }
+#endif
+    vpGemmKernel kernel = selectGemmKernel();
+    int nthreads = (int)gemmThreads((double)m*n*k, vpGemmParallelMinOps);
+    unsigned int nblocks = (m + vpGemmMC - 1)/vpGemmMC;
+    unsigned int nslices = (k + vpGemmKC - 1)/vpGemmKC;
+    if (nthreads > 1 && nblocks < (unsigned int)nthreads && nslices > 1) {
+      // Too few blocks of rows, as in AtA() of a tall matrix: each thread
+      // computes the product of a slice of the inner dimension and the
+      // results are summed
+      if (nthreads > (int)nslices) nthreads = (int)nslices;
+      size_t size = (size_t)m*n;
+      vpGemmBuffer partial((size_t)(nthreads - 1)*size);
+#ifdef VISP_HAVE_OPENMP
+      #pragma omp parallel for num_threads(nthreads)
+#endif
+      for (int t = 0; t < nthreads; t++) {
+        unsigned int s0 = (unsigned int)(((double)nslices * t) / nthreads);
+        unsigned int s1 = (unsigned int)(((double)nslices * (t+1)) / nthreads);
+        unsigned int kb = s0*vpGemmKC;
+        unsigned int ke = minSize(s1*vpGemmKC, k);
+        double *Ct = (t == 0) ? C : partial.ptr + (size_t)(t - 1)*size;
+        gemmRange(kernel, A, B, Ct, n, m, n, kb, ke, 1);
+      }
+      for (int t = 1; t < nthreads; t++) {
+        const double *p = partial.ptr + (size_t)(t - 1)*size;
+        for (size_t i = 0; i < size; i++) C[i] += p[i];
+      }
+      return;
+    }
+    gemmRange(kernel, A, B, C, n, m, n, 0, k, nthreads);
+  }
+
+  // True when the rows of a matrix are stored one after the other from
+  // data, which is not the case of a vpSubMatrix
+  bool isContiguous(const double *data, double * const *rowPtrs,
+                    unsigned int rows, unsigned int cols)
+  {
+    for (unsigned int i = 0; i < rows; i++)
+      if (rowPtrs[i] != data + (size_t)i*cols)
+        return false;
+    return true;
+  }
+
+  // c (m) = A (m x n) * b (n) with the implementation selected by
+  // vpMatrix::setGemmType(), other than GEMM_NAIVE. The rows of A are
+  // given by their pointers; A may be a vpSubMatrix. m and n are not 0.
+  void gemv(double * const *A, const double *b, double *c,
+            unsigned int m, unsigned int n)
+  {
+#ifdef VISP_HAVE_LAPACK
+    if ((vpMatrix::getGemmType() == vpMatrix::GEMM_BLAS)
+        && isContiguous(A[0], A, m, n)) {
+      // The row major A is the column major A^T
+      char trans = 'T';
+      int im = (int)n, in = (int)m, inc = 1;
+      double alpha = 1., beta = 0.;
+      dgemv_(&trans, &im, &in, &alpha, A[0], &im, (double *)b, &inc,
+             &beta, c, &inc);
+      return;
+    }
+#endif
+    // Dot products of the rows of A with b
+    vpDotKernel dot = selectDotKernel();
+    int nthreads = (int)gemmThreads((double)m * n, vpGemvParallelMinSize);
+    int rows = (int)m;
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel for num_threads(nthreads) if(nthreads > 1)
+#endif
+    for (int i = 0; i < rows; i++)
+      c[i] = dot(A[i], b, n);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Return the fastest implementation of the matrix products built in
+  ViSP for this processor: GEMM_AVX2 if it supports AVX2 and FMA,
+  GEMM_BLOCKED otherwise. GEMM_BLAS is never returned since it depends
+  on the BLAS library; use isGemmTypeSupported() to know if it is
+  available.
+
+  \sa getGemmType(), setGemmType()
+*/
+vpMatrix::vpGemmType
+vpMatrix::getGemmSupport()
+{
+  return detectGemm();
+}
+
+/*!
+  Return true if the implementation \e type of the matrix products can
+  be used: always for GEMM_NAIVE and GEMM_BLOCKED, if the processor
+  supports AVX2 and FMA for GEMM_AVX2, and if ViSP is built with Lapack
+  for GEMM_BLAS.
+*/
+bool
+vpMatrix::isGemmTypeSupported(vpGemmType type)
+{
+  switch (type) {
+  case GEMM_NAIVE:
+  case GEMM_BLOCKED:
+    return true;
+  case GEMM_AVX2:
+    return (detectGemm() == GEMM_AVX2);
+  case GEMM_BLAS:
+#ifdef VISP_HAVE_LAPACK
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+/*!
+  Return the implementation of the matrix products. Unless setGemmType()
+  was called, it is the one returned by getGemmSupport().
+*/
+vpMatrix::vpGemmType
+vpMatrix::getGemmType()
+{
+  if (vpGemmImpl < 0)
+    vpGemmImpl = (int)detectGemm();
+  return (vpGemmType)vpGemmImpl;
+}
+
+/*!
+  Select the implementation of the matrix products. It allows to route
+  the products to the BLAS library found with Lapack (GEMM_BLAS), which
+  may be faster than the ViSP kernels when it is an optimized one, or to
+  compare the kernels with the original loops (GEMM_NAIVE).
+
+  Whatever the implementation, the products of small matrices (less
+  than about 24x24x24 multiply-adds) use the original loops. The
+  implementations don't sum the terms in the same order, so their
+  results may differ by a few rounding errors.
+
+  \param type : Implementation. If it is not supported (see
+  isGemmTypeSupported()), the one returned by getGemmSupport() is used.
+*/
+void
+vpMatrix::setGemmType(vpGemmType type)
+{
+  vpGemmImpl = (int)(isGemmTypeSupported(type) ? type : detectGemm());
+}
+
+/*!
+  Set the number of threads used by the products of large matrices (at
+  least 128x128x128 multiply-adds) and by the products of large matrices
+  with a vector (at least 256x256 elements). This setting is only
+  effective when ViSP is built with OpenMP, and not used with GEMM_BLAS.
+
+  \param n : Number of threads. 0 is considered as 1.
+*/
+void
+vpMatrix::setNumberOfThreads(unsigned int n)
+{
+  vpGemmThreads = (n == 0) ? 1 : n;
+}
+
+/*!
+  Return the number of threads used by the products of large matrices.
+
+  \sa setNumberOfThreads()
+*/
+unsigned int
+vpMatrix::getNumberOfThreads()
+{
+  return vpGemmThreads;
+}
+
+/*!
+Operation C = A * B. 
+
+The result is placed in the third parameter C and not returned.
+A new matrix won't be allocated for every use of the function 
+(Speed gain if used many times with the same result matrix size).
+
+C may be the same matrix as A or B.
+
+\sa operator*(), setGemmType()
+*/
+void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
+{
+  if ((&C == &A) || (&C == &B))
+  {
+    vpMatrix R;
+    mult2Matrices(A, B, R);
+    C = R;
+    return;
+  }
+
+  try 
+  {
+    if ((A.rowNum != C.rowNum) || (B.colNum != C.colNum)) C.resize(A.rowNum,B.colNum);
+  }
+  catch(vpException me)
+  {
+    vpERROR_TRACE("Error caught") ;
+    std::cout << me << std::endl ;
+    throw ;
+  }
+
+  if (A.colNum != B.rowNum)
+  {
+    vpERROR_TRACE("\n\t\tvpMatrix mismatch in vpMatrix/vpMatrix multiply") ;
+    throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+      "\n\t\tvpMatrix mismatch in "
+      "vpMatrix/vpMatrix multiply")) ;
+  }
+
+  // The blocked products read the matrices linearly, a vpSubMatrix keeps
+  // the original loops
+  double ops = (double)A.rowNum * B.colNum * A.colNum;
+  if ((ops >= vpGemmMinOps) && (getGemmType() != GEMM_NAIVE)
+      && isContiguous(A.data, A.rowPtrs, A.rowNum, A.colNum)
+      && isContiguous(B.data, B.rowPtrs, B.rowNum, B.colNum)
+      && isContiguous(C.data, C.rowPtrs, C.rowNum, C.colNum))
+  {
+    // Product by a column vector, as in the products of expressions
+    if (B.colNum == 1)
+    {
+      gemv(A.rowPtrs, B.data, C.data, A.rowNum, A.colNum);
+      return;
+    }
+    gemm(vpGemmOperand(A.data, A.colNum, false),
+         vpGemmOperand(B.data, B.colNum, false),
+         C.data, A.rowNum, B.colNum, A.colNum);
+    return;
+  }
+
+  // 5/12/06 some "very" simple optimization to avoid indexation
+  unsigned int BcolNum = B.colNum;
+  unsigned int BrowNum = B.rowNum;
+  unsigned int i,j,k;
+  double **BrowPtrs = B.rowPtrs;
+  for (i=0;i<A.rowNum;i++)
+  {
+    double *rowptri = A.rowPtrs[i];
+    double *ci = C[i];
+    for (j=0;j<BcolNum;j++)
+    {
+      double s = 0;
+      for (k=0;k<BrowNum;k++) s += rowptri[k] * BrowPtrs[k][j];
+      ci[j] = s;
+    }
+  }
+}
+
+/*!
+Operation c = A * b (c and b are vectors). 
+
+The result is placed in the second parameter C and not returned.
+A new matrix won't be allocated for every use of the function 
+(Speed gain if used many times with the same result matrix size).
+
+\sa operator*(const vpColVector &b) const, setGemmType()
+*/
+void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &b, vpColVector &c)
+{
+  if (A.colNum != b.getRows())
+  {
+    vpERROR_TRACE("vpMatrix mismatch in vpMatrix/vector multiply") ;
+    throw(vpMatrixException::incorrectMatrixSizeError) ;
+  }
+
+  if (&c == &b)
+  {
+    vpColVector r;
+    multMatrixVector(A, b, r);
+    c = r;
+    return;
+  }
+
+  try 
+  {
+    if (A.rowNum != c.rowNum) c.resize(A.rowNum);
+  }
+  catch(vpException me)
+  {
+    vpERROR_TRACE("Error caught") ;
+    std::cout << me << std::endl ;
+    throw ;
+  }
+
+  // b or c may be a vpSubColVector, whose elements are not contiguous
+  if ((getGemmType() == GEMM_NAIVE) || (A.rowNum == 0) || (A.colNum == 0)
+      || ! isContiguous(b.data, b.rowPtrs, b.rowNum, 1)
+      || ! isContiguous(c.data, c.rowPtrs, c.rowNum, 1))
+  {
+    c = 0.0;
+    for (unsigned int j=0;j<A.colNum;j++) 
+    {
+      double bj = b[j] ; // optimization em 5/12/2006
+      for (unsigned int i=0;i<A.rowNum;i++) 
+      {
+        c[i]+=A.rowPtrs[i][j] * bj;
+      }
+    }
+    return;
+  }
+
+  gemv(A.rowPtrs, b.data, c.data, A.rowNum, A.colNum);
+}
+
+/*!
+  Compute the AAt operation such as \f$B = A*A^T\f$.
+
+  The result is placed in the parameter \e B and not returned.
+
+  A new matrix won't be allocated for every use of the function. This
+  results in a speed gain if used many times with the same result
+  matrix size.  
+
+  \sa AAt(), setGemmType()
+*/
+void vpMatrix::AAt(vpMatrix &B)const {
+
+  if (&B == this)
+  {
+    vpMatrix R;
+    AAt(R);
+    B = R;
+    return;
+  }
+
+  try {
+    if ((B.rowNum != rowNum) || (B.colNum != rowNum)) B.resize(rowNum,rowNum);
+  }
+  catch(vpException me)
+  {
+    vpERROR_TRACE("Error caught") ;
+    vpCERROR << me << std::endl ;
+    throw ;
+  }
+
+  double ops = (double)rowNum * rowNum * colNum;
+  if ((ops >= vpGemmMinOps) && (getGemmType() != GEMM_NAIVE)
+      && isContiguous(data, rowPtrs, rowNum, colNum)
+      && isContiguous(B.data, B.rowPtrs, B.rowNum, B.colNum))
+  {
+    gemm(vpGemmOperand(data, colNum, false), vpGemmOperand(data, colNum, true),
+         B.data, rowNum, rowNum, colNum);
+    // Exactly symmetric, whatever the rounding of the implementation
+    for (unsigned int i = 0; i < rowNum; i++)
+      for (unsigned int j = i + 1; j < rowNum; j++)
+        B[j][i] = B[i][j];
+    return;
+  }
+
+  // compute A*A^T
+  for(unsigned int i=0;i<rowNum;i++){
+    for(unsigned int j=i;j<rowNum;j++){
+      double *pi = rowPtrs[i];// row i
+      double *pj = rowPtrs[j];// row j
+
+      // sum (row i .* row j)
+      double ssum=0;
+      for(unsigned int k=0; k < colNum ;k++) 
+        ssum += *(pi++)* *(pj++);
+
+      B[i][j]=ssum; //upper triangle
+      if(i!=j)
+        B[j][i]=ssum; //lower triangle
+    }
+  }
+}
+
+/*!
+  Compute the AtA operation such as \f$B = A^T*A\f$.
+
+  The result is placed in the parameter \e B and not returned.  
+
+  A new matrix won't be allocated for every use of the function. This
+  results in a speed gain if used many times with the same result matrix
+  size.
+
+  \sa AtA(), setGemmType()
+*/
+void vpMatrix::AtA(vpMatrix &B) const
+{
+  if (&B == this)
+  {
+    vpMatrix R;
+    AtA(R);
+    B = R;
+    return;
+  }
+
+  try {
+    if ((B.rowNum != colNum) || (B.colNum != colNum)) B.resize(colNum,colNum);
+  }
+  catch(vpException me)
+  {
+    vpERROR_TRACE("Error caught") ;
+    vpCERROR << me << std::endl ;
+    throw ;
+  }
+
+  double ops = (double)colNum * colNum * rowNum;
+  if ((ops >= vpGemmMinOps) && (getGemmType() != GEMM_NAIVE)
+      && isContiguous(data, rowPtrs, rowNum, colNum)
+      && isContiguous(B.data, B.rowPtrs, B.rowNum, B.colNum))
+  {
+    gemm(vpGemmOperand(data, colNum, true), vpGemmOperand(data, colNum, false),
+         B.data, colNum, colNum, rowNum);
+    // Exactly symmetric, whatever the rounding of the implementation
+    for (unsigned int i = 0; i < colNum; i++)
+      for (unsigned int j = i + 1; j < colNum; j++)
+        B[j][i] = B[i][j];
+    return;
+  }
+
+  unsigned int i,j,k;
+  double s;
+  double *ptr;
+  double *Bi;
+  for (i=0;i<colNum;i++)
+  {
+    Bi = B[i] ;
+    for (j=0;j<i;j++)
+    {
+      s = 0 ;
+      for (k=0;k<rowNum;k++)
+      {
+        ptr=rowPtrs[k];
+        s +=(*(ptr+i)) * (*(ptr+j));
+      }
+      *Bi++ = s ;
+      B[j][i] = s;
+    }
+    s = 0 ;
+    for (k=0;k<rowNum;k++)
+    {
+      ptr=rowPtrs[k];
+      s +=(*(ptr+i)) * (*(ptr+i));
+    }
+    *Bi = s;
+  }
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -142,29 +142,11 @@ double vpRowVector::operator*(const vpColVector &x) const
   \return A vpRowVector.
 
 */
-vpRowVector vpRowVector::operator*(const vpMatrix &A) const
+vpMatrixProduct<vpMatrixLeaf<vpRowVector>, vpMatrixLeaf<vpMatrix> >
+vpRowVector::operator*(const vpMatrix &A) const
 {
-
-  vpRowVector c(A.getCols());
-
-  if (colNum != A.getRows())
-  {
-    vpERROR_TRACE("vpMatrix mismatch in vpRowVector/matrix multiply") ;
-    throw(vpMatrixException::incorrectMatrixSizeError) ;
-  }
-
-  c = 0.0;
-
-  for (unsigned int i=0;i<colNum;i++) {
-    {
-      double bi = data[i] ; // optimization em 5/12/2006
-      for (unsigned int j=0;j<A.getCols();j++) {
-        c[j]+=bi*A[i][j];
-      }
-    }
-  }
-
-  return c ;
+  return vpMatrixProduct<vpMatrixLeaf<vpRowVector>, vpMatrixLeaf<vpMatrix> >
+    (vpMatrixLeaf<vpRowVector>(*this), vpMatrixLeaf<vpMatrix>(A));
 }
 
 /*!
@@ -98,11 +98,14 @@ public:
   vpRowVector &operator=(const vpRowVector &v);
   //! copy from a matrix
   vpRowVector & operator=(const vpMatrix &m) ;
+  //! Evaluate an expression in the vector, see vpMatrixExpression.h
+  template<class E> vpRowVector &operator=(const vpMatrixExpression<E> &e);
 
   //!operator dot product
   double  operator*(const vpColVector &x) const;
   //!operator dot product
-  vpRowVector operator*(const vpMatrix &A) const;
+  vpMatrixProduct<vpMatrixLeaf<vpRowVector>, vpMatrixLeaf<vpMatrix> >
+  operator*(const vpMatrix &A) const;
   
   //! initialisation each element of the vector is x
   vpRowVector& operator=(const double x);
@@ -131,6 +134,22 @@ public:
 
 };
 
+/*!
+  Evaluate the expression \e e, that must have one row, in the vector.
+*/
+template<class E>
+vpRowVector &vpRowVector::operator=(const vpMatrixExpression<E> &e)
+{
+  if (e.getRows() != 1)
+  {
+    vpERROR_TRACE("\n\t\t m should be a 1 row matrix") ;
+    throw(vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+      "\n\t\t m should be a 1 row matrix")) ;
+  }
+  e.derived().evalTo(*this);
+  return *this;
+}
+
 
 #endif
 
@@ -0,0 +1,703 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Singular value decomposition and pseudo inverse reusing their memory.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpSvdSolver.cpp
+  \brief Singular value decomposition and pseudo inverse reusing their
+  memory between calls.
+*/
+
+#include <visp/vpSvdSolver.h>
+#include <visp/vpMatrixException.h>
+#include <visp/vpTime.h>
+#include <visp/vpDebug.h>
+
+#include <cmath>    // std::fabs
+#include <limits>   // numeric_limits
+#include <algorithm>
+#include <string.h>
+
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifdef VISP_HAVE_LAPACK
+extern "C" int dgesdd_(char *jobz, int *m, int *n, double *a, int *lda,
+                       double *s, double *u, int *ldu, double *vt, int *ldvt,
+                       double *work, int *lwork, int *iwork, int *info);
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Maximal number of sweeps of the Jacobi algorithm; it usually
+  // converges in less than 10
+  const unsigned int vpJacobiMaxSweeps = 60;
+
+  // xx = x.x, yy = y.y and xy = x.y
+  void jacobiDots(const double *x, const double *y, unsigned int n,
+                  double &xx, double &yy, double &xy)
+  {
+    unsigned int i = 0;
+#ifdef VISP_HAVE_SSE2
+    __m128d sxx = _mm_setzero_pd(), syy = _mm_setzero_pd(), sxy = _mm_setzero_pd();
+    for (; i + 2 <= n; i += 2) {
+      __m128d vx = _mm_loadu_pd(x + i);
+      __m128d vy = _mm_loadu_pd(y + i);
+      sxx = _mm_add_pd(sxx, _mm_mul_pd(vx, vx));
+      syy = _mm_add_pd(syy, _mm_mul_pd(vy, vy));
+      sxy = _mm_add_pd(sxy, _mm_mul_pd(vx, vy));
+    }
+    double t[2];
+    _mm_storeu_pd(t, sxx); xx = t[0] + t[1];
+    _mm_storeu_pd(t, syy); yy = t[0] + t[1];
+    _mm_storeu_pd(t, sxy); xy = t[0] + t[1];
+#else
+    xx = yy = xy = 0.;
+#endif
+    for (; i < n; i++) {
+      xx += x[i] * x[i];
+      yy += y[i] * y[i];
+      xy += x[i] * y[i];
+    }
+  }
+
+  // (x, y) = (c x - s y, s x + c y)
+  void jacobiRotate(double *x, double *y, unsigned int n, double c, double s)
+  {
+    unsigned int i = 0;
+#ifdef VISP_HAVE_SSE2
+    __m128d vc = _mm_set1_pd(c), vs = _mm_set1_pd(s);
+    for (; i + 2 <= n; i += 2) {
+      __m128d vx = _mm_loadu_pd(x + i);
+      __m128d vy = _mm_loadu_pd(y + i);
+      _mm_storeu_pd(x + i, _mm_sub_pd(_mm_mul_pd(vc, vx), _mm_mul_pd(vs, vy)));
+      _mm_storeu_pd(y + i, _mm_add_pd(_mm_mul_pd(vs, vx), _mm_mul_pd(vc, vy)));
+    }
+#endif
+    for (; i < n; i++) {
+      double xi = x[i];
+      x[i] = c * xi - s * y[i];
+      y[i] = s * xi + c * y[i];
+    }
+  }
+
+  // y += a x
+  void axpy(double *y, const double *x, unsigned int n, double a)
+  {
+    unsigned int i = 0;
+#ifdef VISP_HAVE_SSE2
+    __m128d va = _mm_set1_pd(a);
+    for (; i + 2 <= n; i += 2)
+      _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                      _mm_mul_pd(va, _mm_loadu_pd(x + i))));
+#endif
+    for (; i < n; i++)
+      y[i] += a * x[i];
+  }
+
+  double dot(const double *x, const double *y, unsigned int n)
+  {
+    double s = 0.;
+    for (unsigned int i = 0; i < n; i++)
+      s += x[i] * y[i];
+    return s;
+  }
+
+  void transposeSquare(vpMatrix &M)
+  {
+    unsigned int n = M.getRows();
+    for (unsigned int i = 0; i < n; i++)
+      for (unsigned int j = i + 1; j < n; j++)
+        std::swap(M[i][j], M[j][i]);
+  }
+
+  // Resize M, keeping its memory if it already has the right size
+  inline void reshape(vpMatrix &M, unsigned int rows, unsigned int cols)
+  {
+    if ((M.getRows() != rows) || (M.getCols() != cols))
+      M.resize(rows, cols, false);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Build a solver that allocates its memory at the first decomposition.
+*/
+vpSvdSolver::vpSvdSolver()
+  : method(SVD_AUTO), lastMethod(SVD_AUTO), nrows(0), ncols(0),
+    transposed(false), ut(), w(), vt(), u(), work(NULL), iwork(NULL),
+    lwork(0), liwork(0), lastTime(0), totalTime(0), ndecompositions(0)
+{
+}
+
+/*!
+  Build a solver and allocate its memory for \e rows x \e cols matrices.
+
+  \sa reserve()
+*/
+vpSvdSolver::vpSvdSolver(unsigned int rows, unsigned int cols)
+  : method(SVD_AUTO), lastMethod(SVD_AUTO), nrows(0), ncols(0),
+    transposed(false), ut(), w(), vt(), u(), work(NULL), iwork(NULL),
+    lwork(0), liwork(0), lastTime(0), totalTime(0), ndecompositions(0)
+{
+  reserve(rows, cols);
+}
+
+/*!
+  Copy constructor. Only the method is copied; the memory of the new
+  solver is allocated at its first decomposition.
+*/
+vpSvdSolver::vpSvdSolver(const vpSvdSolver &solver)
+  : method(solver.method), lastMethod(SVD_AUTO), nrows(0), ncols(0),
+    transposed(false), ut(), w(), vt(), u(), work(NULL), iwork(NULL),
+    lwork(0), liwork(0), lastTime(0), totalTime(0), ndecompositions(0)
+{
+}
+
+/*!
+  Destructor.
+*/
+vpSvdSolver::~vpSvdSolver()
+{
+  delete [] work;
+  delete [] iwork;
+}
+
+/*!
+  Copy the method of \e solver. The memory of this solver is kept.
+*/
+vpSvdSolver &
+vpSvdSolver::operator=(const vpSvdSolver &solver)
+{
+  method = solver.method;
+  return *this;
+}
+
+/*!
+  Allocate the memory needed to decompose \e rows x \e cols matrices,
+  with SVD_JACOBI as well as with SVD_DEFAULT. The memory allocated for
+  another size is released.
+*/
+void
+vpSvdSolver::reserve(unsigned int rows, unsigned int cols)
+{
+  allocate(rows, cols);
+}
+
+/*!
+  Return the mean duration in ms of the calls to svd() and
+  pseudoInverse() since the construction or the last call to
+  resetTime().
+*/
+double
+vpSvdSolver::getMeanTime() const
+{
+  if (ndecompositions == 0)
+    return 0.;
+  return totalTime / ndecompositions;
+}
+
+/*!
+  Reset the durations returned by getTime() and getMeanTime().
+*/
+void
+vpSvdSolver::resetTime()
+{
+  lastTime = 0.;
+  totalTime = 0.;
+  ndecompositions = 0;
+}
+
+/*!
+  Compute the thin singular value decomposition \f$ A = U\; diag(w)\;
+  V^T \f$. If \e A is a m x n matrix and k = min(m, n), \e U is a m x k
+  matrix, \e w a vector of size k and \e V a n x k matrix. Unlike
+  vpMatrix::svd(), \e A is not modified and may have more columns than
+  rows.
+
+  \param A : Matrix to decompose.
+  \param U : Left singular vectors, in columns.
+  \param w : Singular values, in decreasing order.
+  \param V : Right singular vectors, in columns.
+*/
+void
+vpSvdSolver::svd(const vpMatrix &A, vpMatrix &U, vpColVector &w, vpMatrix &V)
+{
+  double t0 = vpTime::measureTimeMs();
+  decompose(A);
+
+  // A^T = U' diag(w) V'^T gives A = V' diag(w) U'^T
+  const vpMatrix &left = transposed ? vt : ut;
+  const vpMatrix &right = transposed ? ut : vt;
+  reshape(U, left.getCols(), ncols);
+  reshape(V, right.getCols(), ncols);
+  for (unsigned int k = 0; k < ncols; k++) {
+    for (unsigned int i = 0; i < left.getCols(); i++)
+      U[i][k] = left[k][i];
+    for (unsigned int i = 0; i < right.getCols(); i++)
+      V[i][k] = right[k][i];
+  }
+  if (w.getRows() != ncols)
+    w.resize(ncols, false);
+  for (unsigned int k = 0; k < ncols; k++)
+    w[k] = this->w[k];
+
+  record(t0);
+}
+
+/*!
+  Compute the pseudo inverse \f$ A^+ \f$ of \e A.
+
+  \param A : Matrix to invert.
+  \param Ap : Pseudo inverse of A.
+  \param svThreshold : Singular values smaller than \e svThreshold times
+  the largest one are considered as null.
+  \return The rank of A.
+
+  \sa vpMatrix::pseudoInverse()
+*/
+unsigned int
+vpSvdSolver::pseudoInverse(const vpMatrix &A, vpMatrix &Ap, double svThreshold)
+{
+  double t0 = vpTime::measureTimeMs();
+  unsigned int r = inverse(A, Ap, svThreshold);
+  record(t0);
+  return r;
+}
+
+/*!
+  Compute the pseudo inverse \f$ A^+ \f$ of \e A and its singular
+  values.
+
+  \param A : Matrix to invert.
+  \param Ap : Pseudo inverse of A.
+  \param sv : Singular values of A, in decreasing order.
+  \param svThreshold : Singular values smaller than \e svThreshold times
+  the largest one are considered as null.
+  \return The rank of A.
+*/
+unsigned int
+vpSvdSolver::pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                           vpColVector &sv, double svThreshold)
+{
+  double t0 = vpTime::measureTimeMs();
+  unsigned int r = inverse(A, Ap, svThreshold);
+  if (sv.getRows() != ncols)
+    sv.resize(ncols, false);
+  for (unsigned int k = 0; k < ncols; k++)
+    sv[k] = w[k];
+  record(t0);
+  return r;
+}
+
+/*!
+  Compute the pseudo inverse \f$ A^+ \f$ of \e A, its singular values
+  and orthonormal bases of the images of \e A and \f$ A^T \f$, as
+  vpMatrix::pseudoInverse(vpMatrix &, vpColVector &, double, vpMatrix &, vpMatrix &) const.
+
+  \param A : m x n matrix to invert.
+  \param Ap : Pseudo inverse of A.
+  \param sv : Singular values of A, in decreasing order.
+  \param svThreshold : Singular values smaller than \e svThreshold times
+  the largest one are considered as null.
+  \param imA : m x r matrix whose columns are a basis of the image of A,
+  r being the rank of A.
+  \param imAt : n x r matrix whose columns are a basis of the image of
+  \f$ A^T \f$.
+  \return The rank of A.
+*/
+unsigned int
+vpSvdSolver::pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                           vpColVector &sv, double svThreshold,
+                           vpMatrix &imA, vpMatrix &imAt)
+{
+  double t0 = vpTime::measureTimeMs();
+  unsigned int r = inverse(A, Ap, svThreshold);
+  if (sv.getRows() != ncols)
+    sv.resize(ncols, false);
+  for (unsigned int k = 0; k < ncols; k++)
+    sv[k] = w[k];
+  image(r, imA, imAt);
+  record(t0);
+  return r;
+}
+
+/*!
+  Compute the pseudo inverse \f$ A^+ \f$ of \e A, its singular values,
+  orthonormal bases of the images of \e A and \f$ A^T \f$ and of the
+  kernel of \e A.
+
+  \param A : m x n matrix to invert.
+  \param Ap : Pseudo inverse of A.
+  \param sv : Singular values of A, in decreasing order.
+  \param svThreshold : Singular values smaller than \e svThreshold times
+  the largest one are considered as null.
+  \param imA : m x r matrix whose columns are a basis of the image of A,
+  r being the rank of A.
+  \param imAt : n x r matrix whose columns are a basis of the image of
+  \f$ A^T \f$.
+  \param kerA : (n-r) x n matrix whose rows are a basis of the kernel of
+  A.
+  \return The rank of A.
+*/
+unsigned int
+vpSvdSolver::pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                           vpColVector &sv, double svThreshold,
+                           vpMatrix &imA, vpMatrix &imAt,
+                           vpMatrix &kerA)
+{
+  double t0 = vpTime::measureTimeMs();
+  unsigned int r = inverse(A, Ap, svThreshold);
+  if (sv.getRows() != ncols)
+    sv.resize(ncols, false);
+  for (unsigned int k = 0; k < ncols; k++)
+    sv[k] = w[k];
+  image(r, imA, imAt);
+  kernel(r, kerA);
+  record(t0);
+  return r;
+}
+
+/*!
+  Allocate the buffers to decompose \e rows x \e cols matrices, unless
+  they are already allocated for this size.
+*/
+void
+vpSvdSolver::allocate(unsigned int rows, unsigned int cols)
+{
+  bool t = (rows < cols);
+  unsigned int nr = t ? cols : rows;
+  unsigned int nc = t ? rows : cols;
+  transposed = t;
+  if ((nr == nrows) && (nc == ncols))
+    return;
+
+  nrows = nr;
+  ncols = nc;
+  ut.resize(nc, nr, false);
+  w.resize(nc, false);
+  vt.resize(nc, nc, false);
+
+#ifdef VISP_HAVE_LAPACK
+  // Column major nr x nc copy of the matrix, destroyed by Lapack
+  u.resize(nc, nr, false);
+  delete [] work;
+  delete [] iwork;
+  work = NULL;
+  iwork = NULL;
+  lwork = liwork = 0;
+  if (nc == 0)
+    return;
+
+  liwork = 8 * nc;
+  iwork = new int[liwork];
+  int m = (int)nr, n = (int)nc, lda = (int)nr, ldu = (int)nr, ldvt = (int)nc;
+  int query = -1, info = 0;
+  double wkopt = 0.;
+  dgesdd_((char *)"S", &m, &n, u.data, &lda, w.data, ut.data, &ldu,
+          vt.data, &ldvt, &wkopt, &query, iwork, &info);
+  lwork = (unsigned int)wkopt;
+  work = new double[lwork];
+#else
+  u.resize(nr, nc, false);
+#endif
+}
+
+/*!
+  Decompose \e A, or \f$ A^T \f$ if it has more columns than rows, with
+  the method selected by setMethod(), and sort the singular values.
+*/
+void
+vpSvdSolver::decompose(const vpMatrix &A)
+{
+  allocate(A.getRows(), A.getCols());
+  if (ncols == 0) {
+    lastMethod = SVD_JACOBI;
+    return;
+  }
+
+  if ((method == SVD_JACOBI) || ((method == SVD_AUTO) && (ncols <= JACOBI_MAX_SIZE)))
+    lastMethod = SVD_JACOBI;
+  else
+    lastMethod = SVD_DEFAULT;
+
+  // The Jacobi algorithm and Lapack work on the columns of the
+  // decomposed matrix, stored in the rows of a buffer
+#ifdef VISP_HAVE_LAPACK
+  vpMatrix &columns = (lastMethod == SVD_JACOBI) ? ut : u;
+#else
+  vpMatrix &columns = ut;
+#endif
+  if (transposed)
+    memcpy(columns.data, A.data, nrows * ncols * sizeof(double));
+  else {
+    for (unsigned int i = 0; i < nrows; i++) {
+      const double *ai = A[i];
+      for (unsigned int k = 0; k < ncols; k++)
+        columns[k][i] = ai[k];
+    }
+  }
+
+  if (lastMethod == SVD_JACOBI)
+    decomposeJacobi();
+  else
+    decomposeDefault();
+  sort();
+}
+
+/*!
+  One-sided Jacobi algorithm: rotations of pairs of columns of the
+  matrix, stored in the rows of ut, orthogonalize them. The norms of the
+  columns are then the singular values and the product of the rotations
+  is V.
+*/
+void
+vpSvdSolver::decomposeJacobi()
+{
+  double epsilon = 10 * std::numeric_limits<double>::epsilon();
+  vt.setIdentity();
+
+  bool rotated = true;
+  for (unsigned int sweep = 0; rotated && (sweep < vpJacobiMaxSweeps); sweep++) {
+    rotated = false;
+    for (unsigned int p = 0; p + 1 < ncols; p++) {
+      for (unsigned int q = p + 1; q < ncols; q++) {
+        double alpha, beta, gamma;
+        jacobiDots(ut[p], ut[q], nrows, alpha, beta, gamma);
+        if (std::fabs(gamma) <= epsilon * sqrt(alpha * beta))
+          continue;
+        rotated = true;
+        // Rotation that cancels the dot product of the columns
+        double zeta = (beta - alpha) / (2 * gamma);
+        double t = ((zeta >= 0) ? 1. : -1.) / (std::fabs(zeta) + sqrt(1 + zeta * zeta));
+        double c = 1 / sqrt(1 + t * t);
+        double s = c * t;
+        jacobiRotate(ut[p], ut[q], nrows, c, s);
+        jacobiRotate(vt[p], vt[q], ncols, c, s);
+      }
+    }
+  }
+  if (rotated) {
+    vpERROR_TRACE("The Jacobi SVD doesn't converge") ;
+    throw(vpMatrixException(vpMatrixException::convergencyError,
+                            "The Jacobi SVD doesn't converge")) ;
+  }
+
+  for (unsigned int k = 0; k < ncols; k++) {
+    double *uk = ut[k];
+    w[k] = sqrt(dot(uk, uk, nrows));
+    if (w[k] > 0.) {
+      double s = 1 / w[k];
+      for (unsigned int i = 0; i < nrows; i++)
+        uk[i] *= s;
+    }
+  }
+}
+
+/*!
+  Decomposition by the backend of vpMatrix::svd(). Lapack is called on
+  the column major matrix stored in u, with the workspace allocated by
+  allocate().
+*/
+void
+vpSvdSolver::decomposeDefault()
+{
+#ifdef VISP_HAVE_LAPACK
+  int m = (int)nrows, n = (int)ncols, lda = (int)nrows, ldu = (int)nrows;
+  int ldvt = (int)ncols, lw = (int)lwork, info = 0;
+  dgesdd_((char *)"S", &m, &n, u.data, &lda, w.data, ut.data, &ldu,
+          vt.data, &ldvt, work, &lw, iwork, &info);
+  if (info != 0) {
+    vpERROR_TRACE("The Lapack SVD doesn't converge") ;
+    throw(vpMatrixException(vpMatrixException::convergencyError,
+                            "The Lapack SVD doesn't converge")) ;
+  }
+  // The column major V^T is the row major V
+  transposeSquare(vt);
+#else
+  // u = a, replaced by U
+  for (unsigned int i = 0; i < nrows; i++)
+    for (unsigned int k = 0; k < ncols; k++)
+      u[i][k] = ut[k][i];
+  u.svd(w, vt);
+  for (unsigned int i = 0; i < nrows; i++)
+    for (unsigned int k = 0; k < ncols; k++)
+      ut[k][i] = u[i][k];
+  transposeSquare(vt);
+#endif
+}
+
+/*!
+  Sort the singular values in decreasing order, with their singular
+  vectors.
+*/
+void
+vpSvdSolver::sort()
+{
+  for (unsigned int k = 0; k + 1 < ncols; k++) {
+    unsigned int kmax = k;
+    for (unsigned int l = k + 1; l < ncols; l++)
+      if (w[l] > w[kmax])
+        kmax = l;
+    if (kmax != k) {
+      std::swap(w[k], w[kmax]);
+      std::swap_ranges(ut[k], ut[k] + nrows, ut[kmax]);
+      std::swap_ranges(vt[k], vt[k] + ncols, vt[kmax]);
+    }
+  }
+}
+
+/*!
+  Decompose \e A and compute its pseudo inverse in \e Ap. Return the
+  rank of \e A.
+*/
+unsigned int
+vpSvdSolver::inverse(const vpMatrix &A, vpMatrix &Ap, double svThreshold)
+{
+  decompose(A);
+
+  unsigned int r = 0;
+  double threshold = (ncols > 0) ? w[0] * svThreshold : 0.;
+  while ((r < ncols) && (w[r] > threshold))
+    r++;
+
+  // a = U diag(w) V^T and a^+ = V diag(1/w) U^T. If A = a^T,
+  // A^+ = U diag(1/w) V^T.
+  const vpMatrix &left = transposed ? vt : ut;
+  const vpMatrix &right = transposed ? ut : vt;
+  unsigned int m = left.getCols(), n = right.getCols();
+  reshape(Ap, n, m);
+  for (unsigned int i = 0; i < n; i++) {
+    double *api = Ap[i];
+    for (unsigned int j = 0; j < m; j++)
+      api[j] = 0.;
+    for (unsigned int k = 0; k < r; k++)
+      axpy(api, left[k], m, right[k][i] / w[k]);
+  }
+  return r;
+}
+
+/*!
+  Copy in imA and imAt the first \e r singular vectors of the last
+  decomposition.
+*/
+void
+vpSvdSolver::image(unsigned int r, vpMatrix &imA, vpMatrix &imAt)
+{
+  const vpMatrix &left = transposed ? vt : ut;
+  const vpMatrix &right = transposed ? ut : vt;
+  reshape(imA, left.getCols(), r);
+  reshape(imAt, right.getCols(), r);
+  for (unsigned int i = 0; i < left.getCols(); i++)
+    for (unsigned int j = 0; j < r; j++)
+      imA[i][j] = left[j][i];
+  for (unsigned int i = 0; i < right.getCols(); i++)
+    for (unsigned int j = 0; j < r; j++)
+      imAt[i][j] = right[j][i];
+}
+
+/*!
+  Compute in the rows of kerA an orthonormal basis of the kernel of the
+  last decomposed matrix A of rank \e r.
+
+  If A has more rows than columns, V is square and the basis is made of
+  its last columns. Otherwise the first \e r columns of U, the basis of
+  the image of \f$ A^T \f$, are completed by Gram-Schmidt
+  orthogonalisation of the canonical vectors.
+*/
+void
+vpSvdSolver::kernel(unsigned int r, vpMatrix &kerA)
+{
+  if (! transposed) {
+    reshape(kerA, ncols - r, ncols);
+    for (unsigned int k = r; k < ncols; k++)
+      memcpy(kerA[k - r], vt[k], ncols * sizeof(double));
+    return;
+  }
+
+  unsigned int n = nrows;
+  reshape(kerA, n - r, n);
+  for (unsigned int k = 0; k < n - r; k++) {
+    double *b = kerA[k];
+    // Norm of the projection of each canonical vector on the kernel
+    // left to find
+    for (unsigned int i = 0; i < n; i++)
+      b[i] = 1.;
+    for (unsigned int l = 0; l < r; l++)
+      for (unsigned int i = 0; i < n; i++)
+        b[i] -= ut[l][i] * ut[l][i];
+    for (unsigned int l = 0; l < k; l++)
+      for (unsigned int i = 0; i < n; i++)
+        b[i] -= kerA[l][i] * kerA[l][i];
+    unsigned int imax = 0;
+    for (unsigned int i = 1; i < n; i++)
+      if (b[i] > b[imax])
+        imax = i;
+
+    // Projection of the canonical vector imax, done twice for accuracy
+    for (unsigned int i = 0; i < n; i++)
+      b[i] = 0.;
+    b[imax] = 1.;
+    for (unsigned int pass = 0; pass < 2; pass++) {
+      for (unsigned int l = 0; l < r; l++)
+        axpy(b, ut[l], n, -dot(b, ut[l], n));
+      for (unsigned int l = 0; l < k; l++)
+        axpy(b, kerA[l], n, -dot(b, kerA[l], n));
+    }
+    double s = 1 / sqrt(dot(b, b, n));
+    for (unsigned int i = 0; i < n; i++)
+      b[i] *= s;
+  }
+}
+
+/*!
+  Update the durations with the call started at \e t0.
+*/
+void
+vpSvdSolver::record(double t0)
+{
+  lastTime = vpTime::measureTimeMs() - t0;
+  totalTime += lastTime;
+  ndecompositions++;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
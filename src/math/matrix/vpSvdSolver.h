@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Singular value decomposition and pseudo inverse reusing their memory.
+ *
+ *****************************************************************************/
+
+#ifndef vpSvdSolver_H
+#define vpSvdSolver_H
+
+/*!
+  \file vpSvdSolver.h
+  \brief Singular value decomposition and pseudo inverse reusing their
+  memory between calls.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpColVector.h>
+
+/*!
+  \class vpSvdSolver
+  \ingroup Matrix
+
+  \brief Singular value decomposition and pseudo inverse of matrices
+  whose size doesn't change between calls, as in a control loop.
+
+  The solver keeps the buffers of the decomposition (and the workspace
+  of Lapack) of the last size it was used with. Once a matrix of a given
+  size has been decomposed, or reserve() called with this size, the
+  following decompositions don't allocate memory, provided that the
+  output matrices are also reused and keep their size.
+
+  Two methods are available (see setMethod()):
+  - SVD_JACOBI, a one-sided Jacobi algorithm whose inner loops use SSE2.
+    It is the fastest for the small matrices used in visual servoing and
+    pose estimation: 2n x 6 interaction matrices, matrices up to 8x8;
+  - SVD_DEFAULT, the algorithm used by vpMatrix::svd(). Lapack is called
+    with the workspace of the solver; the other backends (OpenCV, GSL,
+    Numerical Recipes) still allocate their own workspace.
+
+  By default (SVD_AUTO) SVD_JACOBI is used when the smallest dimension of
+  the matrix is not greater than JACOBI_MAX_SIZE.
+
+  The singular values are sorted in decreasing order, whatever the
+  method. getTime() and getMeanTime() give the duration of the
+  decompositions.
+
+  \code
+#include <visp/vpSvdSolver.h>
+
+int main()
+{
+  vpMatrix J(8, 6), Jp;
+  vpColVector e(8), v;
+  vpSvdSolver solver(8, 6); // Allocates the memory for 8x6 matrices
+  for (unsigned int iter = 0; iter < 1000; iter++) {
+    // ... update J and e
+    solver.pseudoInverse(J, Jp); // No allocation
+    v = -0.5 * Jp * e;
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpSvdSolver
+{
+public:
+  typedef enum {
+    SVD_AUTO,    /*!< SVD_JACOBI for small matrices, SVD_DEFAULT otherwise. */
+    SVD_JACOBI,  /*!< One-sided Jacobi algorithm. */
+    SVD_DEFAULT  /*!< Algorithm of vpMatrix::svd(). */
+  } vpSvdMethod;
+
+  //! Smallest dimension up to which SVD_AUTO uses SVD_JACOBI.
+  static const unsigned int JACOBI_MAX_SIZE = 8;
+
+  vpSvdSolver();
+  vpSvdSolver(unsigned int rows, unsigned int cols);
+  vpSvdSolver(const vpSvdSolver &solver);
+  virtual ~vpSvdSolver();
+
+  vpSvdSolver &operator=(const vpSvdSolver &solver);
+
+  void reserve(unsigned int rows, unsigned int cols);
+
+  //! Set the method used by the following decompositions.
+  inline void setMethod(vpSvdMethod m) { method = m; }
+  //! Return the method set by setMethod().
+  inline vpSvdMethod getMethod() const { return method; }
+  //! Return the method used by the last decomposition: SVD_JACOBI or
+  //! SVD_DEFAULT.
+  inline vpSvdMethod getLastMethod() const { return lastMethod; }
+
+  //! Return the duration in ms of the last call to svd() or
+  //! pseudoInverse().
+  inline double getTime() const { return lastTime; }
+  double getMeanTime() const;
+  void resetTime();
+
+  void svd(const vpMatrix &A, vpMatrix &U, vpColVector &w, vpMatrix &V);
+
+  unsigned int pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                             double svThreshold=1e-6);
+  unsigned int pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                             vpColVector &sv, double svThreshold=1e-6);
+  unsigned int pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                             vpColVector &sv, double svThreshold,
+                             vpMatrix &imA, vpMatrix &imAt);
+  unsigned int pseudoInverse(const vpMatrix &A, vpMatrix &Ap,
+                             vpColVector &sv, double svThreshold,
+                             vpMatrix &imA, vpMatrix &imAt,
+                             vpMatrix &kerA);
+
+private:
+  vpSvdMethod method;
+  vpSvdMethod lastMethod;
+
+  // Size of the decomposed matrix, transposed if it has more columns
+  // than rows so that nrows >= ncols
+  unsigned int nrows, ncols;
+  bool transposed;
+
+  // Decomposition a = U diag(w) V^T: the rows of ut are the columns of
+  // U and the rows of vt the columns of V
+  vpMatrix ut;
+  vpColVector w;
+  vpMatrix vt;
+
+  // Buffers of Lapack
+  vpMatrix u;
+  double *work;
+  int *iwork;
+  unsigned int lwork;
+  unsigned int liwork;
+
+  double lastTime;
+  double totalTime;
+  unsigned long ndecompositions;
+
+  void allocate(unsigned int rows, unsigned int cols);
+  void decompose(const vpMatrix &A);
+  void decomposeJacobi();
+  void decomposeDefault();
+  void sort();
+  unsigned int inverse(const vpMatrix &A, vpMatrix &Ap, double svThreshold);
+  void image(unsigned int r, vpMatrix &imA, vpMatrix &imAt);
+  void kernel(unsigned int r, vpMatrix &kerA);
+  void record(double t0);
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
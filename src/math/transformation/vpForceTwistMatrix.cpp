@@ -88,13 +88,8 @@ vpForceTwistMatrix::init()
 {
   unsigned int i,j ;
 
-  try {
-    resize(6,6) ;
-  }
-  catch(vpException me) {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
+  // The elements are stored in the object, not on the heap
+  attach(storage.data, storage.rowPtrs, 6, 6) ;
 
   for (i=0 ; i < 6 ; i++) {
     for (j=0 ; j < 6; j++) {
@@ -248,14 +243,8 @@ vpForceTwistMatrix::operator*(const vpForceTwistMatrix &F) const
 {
   vpForceTwistMatrix Fout ;
 
-  for (unsigned int i=0;i<6;i++) {
-    for (unsigned int j=0;j<6;j++) {
-      double s =0 ;
-      for (unsigned int k=0;k<6;k++)
-	s +=rowPtrs[i][k] * F.rowPtrs[k][j];
-      Fout[i][j] = s ;
-    }
-  }
+  vpFixedMult<6,6,6>(data, F.data, Fout.data) ;
+
   return Fout;
 }
 
@@ -348,14 +337,8 @@ vpForceTwistMatrix::operator*(const vpColVector &H) const
     throw(vpMatrixException::incorrectMatrixSizeError) ;
   }
 
-  Hout = 0.0;
+  vpFixedMultVector<6,6>(data, H.data, Hout.data) ;
 
-  for (unsigned int i=0;i<6;i++) {
-    for (unsigned int j=0;j<6;j++) {
-      Hout[i]+=rowPtrs[i][j] * H[j];
-    }
-  }
-  
   return Hout ;
 }
 
@@ -375,8 +358,12 @@ vpForceTwistMatrix::buildFrom(const vpTranslationVector &t,
 			 const vpRotationMatrix &R)
 {
   unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
-  
+  double skewa[9] = { 0, -t[2], t[1],
+                      t[2], 0, -t[0],
+                      -t[1], t[0], 0 } ;
+  double skewaR[3][3] ;
+  vpFixedMult<3,3,3>(skewa, R.data, skewaR[0]) ;
+
   for (i=0 ; i < 3 ; i++) {
     for (j=0 ; j < 3 ; j++)	{
       (*this)[i][j] = R[i][j] ;
@@ -44,6 +44,7 @@
 #define vpForceTwistMatrix_h
 
 #include <visp/vpMatrix.h>
+#include <visp/vpMatrixFixedStorage.h>
 #include <visp/vpColVector.h>
 #include <visp/vpHomogeneousMatrix.h>
 #include <visp/vpRotationMatrix.h>
@@ -139,6 +140,8 @@ class VISP_EXPORT vpForceTwistMatrix : public vpMatrix
 
   // copy operator from vpMatrix (handle with care)
   vpForceTwistMatrix &operator=(const vpForceTwistMatrix &H);
+ private:
+  vpMatrixFixedStorage<6,6> storage;
 } ;
 
 #endif
@@ -55,6 +55,8 @@
 #include <visp/vpException.h>
 #include <visp/vpMatrixException.h>
 
+#include <string.h>
+
 // Debug trace
 #include <visp/vpDebug.h>
 
@@ -67,15 +69,8 @@ vpHomogeneousMatrix::init()
 {
   unsigned int i,j ;
 
-  try {
-    resize(4,4) ;
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
-
+  // The elements are stored in the object, not on the heap
+  attach(storage.data, storage.rowPtrs, 4, 4) ;
 
   for (i=0 ; i < 4 ; i++)
     for (j=0 ; j < 4; j++)
@@ -203,16 +198,10 @@ vpHomogeneousMatrix::buildFrom(const double tx,
 vpHomogeneousMatrix &
 vpHomogeneousMatrix::operator=(const vpHomogeneousMatrix &M)
 {
+  attach(storage.data, storage.rowPtrs, 4, 4) ;
+  if (data != M.data)
+    memcpy(data, M.data, 16*sizeof(double)) ;
 
-  if (rowPtrs != M.rowPtrs) init() ;
-
-  for (int i=0; i<4; i++)
-  {
-    for (int j=0; j<4; j++)
-    {
-      rowPtrs[i][j] = M.rowPtrs[i][j];
-    }
-  }
   return *this;
 }
 
@@ -236,24 +225,18 @@ int main()
 vpHomogeneousMatrix
 vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M) const
 {
-  vpHomogeneousMatrix p,p1 ;
-
-  vpRotationMatrix R1, R2, R ;
-  vpTranslationVector T1, T2 , T;
-
-
-  extract(T1) ;
-  M.extract(T2) ;
-
-  extract (R1) ;
-  M.extract (R2) ;
-
-  R = R1*R2 ;
-
-  T = R1*T2 + T1 ;
-
-  p.insert(T) ;
-  p.insert(R) ;
+  vpHomogeneousMatrix p ;
+
+  // R = R1*R2 and T = R1*T2 + T1, the last row stays [0 0 0 1]
+  const double *a = data ;
+  const double *b = M.data ;
+  double *c = p.data ;
+  for (unsigned int i=0 ; i < 3 ; i++) {
+    const double *ai = a + 4*i ;
+    for (unsigned int j=0 ; j < 4 ; j++)
+      c[4*i+j] = ai[0]*b[j] + ai[1]*b[4+j] + ai[2]*b[8+j] ;
+    c[4*i+3] += ai[3] ;
+  }
 
   return p;
 }
@@ -263,13 +246,7 @@ vpHomogeneousMatrix::operator*(vpColVector &v) const
 {
   vpColVector p(rowNum);
 
-  p = 0.0;
-
-  for (unsigned int j=0;j<4;j++) {
-    for (unsigned int i=0;i<4;i++) {
-      p[i]+=rowPtrs[i][j] * v[j];
-    }
-  }
+  vpFixedMultVector<4,4>(data, v.data, p.data) ;
 
   return p;
 }
@@ -404,15 +381,7 @@ vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi ;
 
-
-  vpRotationMatrix R ;      extract(R) ;
-  vpTranslationVector T ;   extract(T) ;
-
-  vpTranslationVector RtT ; RtT = -(R.t()*T) ;
-
-
-  Mi.insert(R.t()) ;
-  Mi.insert(RtT) ;
+  inverse(Mi) ;
 
   return Mi ;
 }
@@ -452,7 +421,25 @@ void vpHomogeneousMatrix::eye()
 void
 vpHomogeneousMatrix::inverse(vpHomogeneousMatrix &M) const
 {
-  M = inverse() ;
+  if (&M == this) {
+    vpHomogeneousMatrix Mi ;
+    inverse(Mi) ;
+    M = Mi ;
+    return ;
+  }
+
+  const double *a = data ;
+  double *m = M.data ;
+  for (unsigned int i=0 ; i < 3 ; i++) {
+    // R^T
+    m[4*i]   = a[i] ;
+    m[4*i+1] = a[4+i] ;
+    m[4*i+2] = a[8+i] ;
+    // -R^T t
+    m[4*i+3] = -(a[i]*a[3] + a[4+i]*a[7] + a[8+i]*a[11]) ;
+  }
+  m[12] = m[13] = m[14] = 0 ;
+  m[15] = 1 ;
 }
 
 
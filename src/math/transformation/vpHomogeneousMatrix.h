@@ -57,6 +57,7 @@ class vpPoseVector;
 class vpThetaUVector;
 
 #include <visp/vpMatrix.h>
+#include <visp/vpMatrixFixedStorage.h>
 
 #include <visp/vpRotationMatrix.h>
 #include <visp/vpThetaUVector.h>
@@ -181,6 +182,8 @@ class VISP_EXPORT vpHomogeneousMatrix : public vpMatrix
   //! Print the matrix as a vector [T thetaU]
   void print() ;
 
+ private:
+  vpMatrixFixedStorage<4,4> storage;
 } ;
 
 #endif
@@ -60,6 +60,8 @@
 void 
 vpPoseVector::init()
 {
+  // The elements are stored in the object, not on the heap
+  attach(storage.data, storage.rowPtrs, 6, 1) ;
   resize(6) ;
 }
 
@@ -80,6 +82,17 @@ vpPoseVector::vpPoseVector()
   init() ;
 }
 
+/*!
+  Copy constructor.
+
+  \param p : Pose vector to copy.
+*/
+vpPoseVector::vpPoseVector(const vpPoseVector &p) : vpColVector()
+{
+  init() ;
+  *this = p ;
+}
+
 /*!  
 
   Construct a 6 dimension pose vector \f$ [\bf{t}, \Theta
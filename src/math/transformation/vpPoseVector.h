@@ -58,6 +58,7 @@ class vpTranslationVector;
 class vpThetaUVector;
 
 #include <visp/vpMatrix.h>
+#include <visp/vpMatrixFixedStorage.h>
 #include <visp/vpRotationMatrix.h>
 #include <visp/vpHomogeneousMatrix.h>
 
@@ -96,9 +97,13 @@ class VISP_EXPORT vpPoseVector : public vpColVector
   // initialize a size 6 vector
   void init() ;
 
+  vpMatrixFixedStorage<6,1> storage;
+
  public:
   // constructor
   vpPoseVector() ;
+  // copy constructor
+  vpPoseVector(const vpPoseVector &p) ;
   // constructor from 3 angles (in radian)
   vpPoseVector(const double tx, const double ty, const double tz,
 	       const double tux, const double tuy, const double tuz) ;
@@ -74,14 +74,9 @@ vpRotationMatrix::init()
 {
   unsigned int i,j ;
 
-  try {
-    resize(3,3) ;
-  }
-  catch(vpException me)
-  {
-    vpERROR_TRACE("Error caught") ;
-    throw ;
-  }
+  // The elements are stored in the object, not on the heap
+  attach(storage.data, storage.rowPtrs, 3, 3) ;
+
   for (i=0 ; i < 3 ; i++)
     for (j=0 ; j < 3; j++)
       if (i==j)
@@ -171,14 +166,8 @@ vpRotationMatrix::operator*(const vpRotationMatrix &B) const
 {
   vpRotationMatrix p ;
 
-  for (unsigned int i=0;i<3;i++)
-    for (unsigned int j=0;j<3;j++)
-    {
-      double s =0 ;
-      for (unsigned int k=0;k<3;k++)
-	s +=rowPtrs[i][k] * B.rowPtrs[k][j];
-      p[i][j] = s ;
-    }
+  vpFixedMult<3,3,3>(data, B.data, p.data) ;
+
   return p;
 }
 /*! 
@@ -253,8 +242,8 @@ vpRotationMatrix::operator*(const vpColVector &v) const
     throw (vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
 			     "The column vector is not a 3 dimension vector"));
   }
-  vpColVector c;
-  vpMatrix::multMatrixVector(*this, v, c);
+  vpColVector c(3);
+  vpFixedMultVector<3,3>(data, v.data, c.data) ;
   return c;
 }
 
@@ -293,13 +282,7 @@ vpRotationMatrix::operator*(const vpTranslationVector &mat) const
 {
   vpTranslationVector p ;
 
-  for (unsigned int j=0;j<3;j++)p[j]=0 ;
-
-  for (unsigned int j=0;j<3;j++) {
-    for (unsigned int i=0;i<3;i++) {
-      p[i]+=rowPtrs[i][j] * mat[j];
-    }
-  }
+  vpFixedMultVector<3,3>(data, mat.data, p.data) ;
 
   return p;
 }
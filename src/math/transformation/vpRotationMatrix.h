@@ -49,6 +49,7 @@
 */
 
 #include <visp/vpMatrix.h>
+#include <visp/vpMatrixFixedStorage.h>
 #include <visp/vpRxyzVector.h>
 #include <visp/vpRzyxVector.h>
 #include <visp/vpRzyzVector.h>
@@ -152,6 +153,7 @@ public:
 private:
   static const double threshold;
   static const double minimum; // useful only for debug
+  vpMatrixFixedStorage<3,3> storage;
   };
 
 #endif
@@ -112,12 +112,33 @@ std::ostream &operator <<(std::ostream &s,const vpRotationVector &m)
 
 void vpRotationVector::init(const unsigned int size){
 	this->_size = size;
-	r = new double[this->_size];
+	if (this->_size <= 4)
+	  r = storage;
+	else
+	  r = new double[this->_size];
 	std::fill(r,r+this->_size,0.);
 }
 
+/*!
+  Copy constructor.
+*/
+vpRotationVector::vpRotationVector(const vpRotationVector &v){
+	init(v._size);
+	std::copy(v.r,v.r+_size,r);
+}
+
+/*!
+  Copy the elements of a rotation vector of the same size.
+*/
+vpRotationVector &vpRotationVector::operator=(const vpRotationVector &v){
+	if (this != &v)
+	  std::copy(v.r,v.r+std::min(_size,v._size),r);
+	return *this;
+}
+
 vpRotationVector::~vpRotationVector(){
-	delete[] r;
+	if (r != storage)
+	  delete[] r;
 }
 
 /*
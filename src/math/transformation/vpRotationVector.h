@@ -99,6 +99,9 @@ protected:
   double *r ;
   unsigned int _size;
   void init(const unsigned int size);
+private:
+  // Elements of the vectors of up to 4 elements, to avoid the heap
+  double storage[4];
 public:
   //! Constructor that constructs a vector of size 3 initialize three vector values to zero.
   vpRotationVector() { 
@@ -110,6 +113,9 @@ public:
   vpRotationVector(const unsigned int n) { 
 	init(n);
   }
+
+  vpRotationVector(const vpRotationVector &v);
+  vpRotationVector &operator=(const vpRotationVector &v);
   
   ~vpRotationVector();
 
@@ -60,6 +60,8 @@
 //! initialize a size 3 vector
 void vpTranslationVector::init()
 {
+    // The elements are stored in the object, not on the heap
+    attach(storage.data, storage.rowPtrs, 3, 1) ;
     resize(3) ;
 }
 
@@ -91,8 +93,10 @@ vpTranslationVector::vpTranslationVector(const double tx,
   \endcode
 
 */
-vpTranslationVector::vpTranslationVector (const vpTranslationVector &t) : vpColVector(t)
+vpTranslationVector::vpTranslationVector (const vpTranslationVector &t) : vpColVector()
 {
+    init() ;
+    *this = t ;
 }
 
 /*!
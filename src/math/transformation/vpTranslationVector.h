@@ -51,6 +51,7 @@
 */
 
 #include <visp/vpColVector.h>
+#include <visp/vpMatrixFixedStorage.h>
 
 
 /*!
@@ -98,6 +99,8 @@ private:
     //! initialize a size 3 vector
     void init() ;
 
+    vpMatrixFixedStorage<3,1> storage;
+
 public:
 
     /*!
@@ -89,14 +89,8 @@ vpVelocityTwistMatrix::init()
 {
   unsigned int i,j ;
 
-  try {
-    resize(6,6) ;
-  }
-  catch(vpException me)
-    {
-      vpERROR_TRACE("Error caught") ;
-      throw ;
-    }
+  // The elements are stored in the object, not on the heap
+  attach(storage.data, storage.rowPtrs, 6, 6) ;
 
   for (i=0 ; i < 6 ; i++)
     for (j=0 ; j < 6; j++)
@@ -220,14 +214,8 @@ vpVelocityTwistMatrix::operator*(const vpVelocityTwistMatrix &V) const
 {
   vpVelocityTwistMatrix p ;
 
-  for (unsigned int i=0;i<6;i++)
-    for (unsigned int j=0;j<6;j++)
-      {
-	double s =0 ;
-	for (int k=0;k<6;k++)
-	  s +=rowPtrs[i][k] * V.rowPtrs[k][j];
-	p[i][j] = s ;
-      }
+  vpFixedMult<6,6,6>(data, V.data, p.data) ;
+
   return p;
 }
 
@@ -318,15 +306,7 @@ vpVelocityTwistMatrix::operator*(const vpColVector &v) const
       throw(vpMatrixException::incorrectMatrixSizeError) ;
     }
 
-  c = 0.0;
-
-  for (unsigned int i=0;i<6;i++) {
-    for (unsigned int j=0;j<6;j++) {
-      {
- 	c[i]+=rowPtrs[i][j] * v[j];
-      }
-    }
-  }
+  vpFixedMultVector<6,6>(data, v.data, c.data) ;
 
   return c ;
 }
@@ -347,7 +327,11 @@ vpVelocityTwistMatrix::buildFrom(const vpTranslationVector &t,
 				 const vpRotationMatrix &R)
 {
   unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
+  double skewa[9] = { 0, -t[2], t[1],
+                      t[2], 0, -t[0],
+                      -t[1], t[0], 0 } ;
+  double skewaR[3][3] ;
+  vpFixedMult<3,3,3>(skewa, R.data, skewaR[0]) ;
 
   for (i=0 ; i < 3 ; i++)
     for (j=0 ; j < 3 ; j++)
@@ -44,6 +44,7 @@
 #define vpVelocityRwistMatrix_h
 
 #include <visp/vpMatrix.h>
+#include <visp/vpMatrixFixedStorage.h>
 #include <visp/vpColVector.h>
 #include <visp/vpHomogeneousMatrix.h>
 #include <visp/vpRotationMatrix.h>
@@ -147,6 +148,8 @@ class VISP_EXPORT vpVelocityTwistMatrix : public vpMatrix
   void extract( vpRotationMatrix &R) const;
   //! extract the translation vector from the twist matrix
   void extract(vpTranslationVector &t) const;
+ private:
+  vpMatrixFixedStorage<6,6> storage;
 } ;
 
 #endif
@@ -886,8 +886,10 @@ vpColVector
 
   try
   {
-    vpVelocityTwistMatrix cVa ; // Twist transformation matrix
-    vpMatrix aJe ;      // Jacobian
+    // The twist transformation and the Jacobian are referenced rather
+    // than copied so that the loop doesn't allocate memory
+    const vpMatrix *cVa = NULL ; // Twist transformation matrix
+    const vpMatrix *aJe = NULL ; // Jacobian
 
     if (iteration==0)
     {
@@ -924,21 +926,22 @@ vpColVector
     case EYEINHAND_L_cVe_eJe:
     case EYETOHAND_L_cVe_eJe:
 
-      cVa = cVe ;
-      aJe = eJe ;
+      cVa = &cVe ;
+      aJe = &eJe ;
 
       init_cVe = false ;
       init_eJe = false ;
       break ;
     case  EYETOHAND_L_cVf_fVe_eJe:
-      cVa = cVf*fVe ;
-      aJe = eJe ;
+      vpMatrix::mult2Matrices(cVf, fVe, cVf_fVe) ;
+      cVa = &cVf_fVe ;
+      aJe = &eJe ;
       init_fVe = false ;
       init_eJe = false ;
       break ;
     case EYETOHAND_L_cVf_fJe    :
-      cVa = cVf ;
-      aJe = fJe ;
+      cVa = &cVf ;
+      aJe = &fJe ;
       init_fJe = false ;
       break ;
     }
@@ -947,7 +950,7 @@ vpColVector
     computeError() ;
 
     // compute  task Jacobian
-    J1 = L*cVa*aJe ;
+    J1 = L*(*cVa)*(*aJe) ;
 
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix ;
@@ -956,18 +959,18 @@ vpColVector
     // and rank of the task Jacobian
     // the image of J1 is also computed to allows the computation
     // of the projection operator
-    vpMatrix imJ1t, imJ1 ;
+    // The solver, the singular values and the images are members so
+    // that the loop doesn't allocate memory after the first iteration
     bool imageComputed = false ;
 
     if (inversionType==PSEUDO_INVERSE)
     {
-      vpColVector sv ;
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t) ;
+      rankJ1 = svdSolver.pseudoInverse(J1, J1p, svJ1, 1e-6, imJ1, imJ1t) ;
 
       imageComputed = true ;
     }
     else
-      J1p = J1.t() ;
+      J1.transpose(J1p) ;
 
     if (rankJ1 == L.getCols())
     {
@@ -983,14 +986,12 @@ vpColVector
     {
       if (imageComputed!=true)
 	    {
-	      vpMatrix Jtmp ;
-	      vpColVector sv ;
 	      // image of J1 is computed to allows the computation
 	      // of the projection operator
-	      rankJ1 = J1.pseudoInverse(Jtmp,sv, 1e-6, imJ1, imJ1t) ;
+	      rankJ1 = svdSolver.pseudoInverse(J1, J1pTmp, svJ1, 1e-6, imJ1, imJ1t) ;
 	      imageComputed = true ;
 	    }
-      WpW = imJ1t*imJ1t.t() ;
+      imJ1t.AAt(WpW) ; // WpW = imJ1t*imJ1t.t()
 
 #ifdef DEBUG
       std::cout << "rank J1 " << rankJ1 <<std::endl ;
@@ -1005,12 +1006,17 @@ vpColVector
     }
     e = - lambda(e1) * e1 ;
 
-    vpMatrix I ;
-
-    I.resize(J1.getCols(),J1.getCols()) ;
-    I.setIdentity() ;
-
-    I_WpW = (I - WpW) ;
+    // I_WpW = I - WpW, computed in place
+    const unsigned int n = WpW.getRows() ;
+    I_WpW.resize(n, n, false) ;
+    for (unsigned int i = 0 ; i < n ; i++)
+    {
+      const double *WpW_i = WpW[i] ;
+      double *I_WpW_i = I_WpW[i] ;
+      for (unsigned int j = 0 ; j < n ; j++)
+        I_WpW_i[j] = - WpW_i[j] ;
+      I_WpW_i[i] += 1. ;
+    }
   }
   catch(vpMatrixException me)
   {
@@ -1063,14 +1069,6 @@ vpColVector
   else
   {
     vpColVector sec ;
-#if 0
-    // computed in computeControlLaw()
-    vpMatrix I ;
-
-    I.resize(J1.getCols(),J1.getCols()) ;
-    I.setIdentity() ;
-    I_WpW = (I - WpW) ;
-#endif
     //    std::cout << "I-WpW" << std::endl << I_WpW <<std::endl ;
     sec = I_WpW*de2dt ;
 
@@ -1111,15 +1109,6 @@ vpColVector
   else
   {
     vpColVector sec ;
-#if 0
-    // computed in computeControlLaw()
-    vpMatrix I ;
-
-    I.resize(J1.getCols(),J1.getCols()) ;
-    I.setIdentity() ;
-
-    I_WpW = (I - WpW) ;
-#endif
 
     // To be coherent with the primary task the gain must be the same between
     // primary and secondary task.
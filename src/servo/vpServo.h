@@ -51,6 +51,7 @@
 */
 
 #include <visp/vpMatrix.h>
+#include <visp/vpSvdSolver.h>
 #include <visp/vpVelocityTwistMatrix.h>
 #include <visp/vpBasicFeature.h>
 #include <visp/vpServoException.h>
@@ -511,6 +512,24 @@ protected:
   vpMatrix WpW ;
   //! projection operators I-WpW
   vpMatrix I_WpW ;
+
+  /*
+    Pseudo inverse of the task Jacobian
+  */
+
+  //! Solver reusing its memory at each iteration
+  vpSvdSolver svdSolver ;
+  //! Singular values of the task Jacobian
+  vpColVector svJ1 ;
+  //! Image of the task Jacobian
+  vpMatrix imJ1 ;
+  //! Image of the transpose of the task Jacobian
+  vpMatrix imJ1t ;
+  //! Product of the twist transformations cVf and fVe
+  vpMatrix cVf_fVe ;
+  //! Pseudo inverse only used to get the image of the task Jacobian when
+  //! the transpose is used to compute the control law
+  vpMatrix J1pTmp ;
 } ;
 
 
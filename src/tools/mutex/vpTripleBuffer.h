@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Lock-free triple buffer to hand frames from a producer to a consumer thread.
+ *
+ *****************************************************************************/
+
+
+#ifndef vpTripleBuffer_H
+#define vpTripleBuffer_H
+
+/*!
+  \file vpTripleBuffer.h
+  \brief Lock-free triple buffer to hand frames from a producer thread
+  to a consumer thread.
+*/
+
+#include <visp/vpConfig.h>
+
+#if defined(__GNUC__)
+   // Atomic builtins of gcc
+#elif defined(WIN32)
+#  include <windows.h>
+#elif defined(VISP_HAVE_PTHREAD)
+#  include <pthread.h>
+#endif
+
+/*!
+  \class vpTripleBuffer
+
+  \ingroup Mutex
+
+  \brief Lock-free handoff of the latest frame from a producer thread,
+  typically a driver callback, to a consumer thread.
+
+  The three buffers are owned in turn by the producer, by the consumer,
+  and by none of them, in which case they hold the last published
+  frame. The producer fills getWriteBuffer() and calls publish(), which
+  exchanges the filled buffer with the pending one. The consumer calls
+  update(), which exchanges its buffer with the pending one when a new
+  frame was published, and then reads getReadBuffer(). Only buffer
+  indexes are exchanged, with one atomic operation, so that none of the
+  threads ever waits for the other one. When the consumer is slower
+  than the producer, the frames it does not take are overwritten, and
+  counted by getNbDroppedFrames().
+
+  There must be a single producer thread and a single consumer thread.
+  The atomic exchange uses the gcc builtins or the Windows interlocked
+  functions. On other compilers it is protected by a pthread mutex.
+
+  \code
+#include <visp/vpImage.h>
+#include <visp/vpTripleBuffer.h>
+
+vpTripleBuffer<vpImage<unsigned char> > frames;
+
+void callback(const unsigned char *data) // Producer thread
+{
+  vpImage<unsigned char> &I = frames.getWriteBuffer();
+  // ... fill I with data
+  frames.publish();
+}
+
+void loop() // Consumer thread
+{
+  if (frames.update()) {
+    const vpImage<unsigned char> &I = frames.getReadBuffer();
+    // ... process I
+  }
+}
+  \endcode
+*/
+template<class Type>
+class vpTripleBuffer
+{
+public:
+  /*!
+    Build the three buffers with the default constructor of \e Type.
+  */
+  vpTripleBuffer()
+    : back(0), pending(1), front(2), nbPublished(0), nbDropped(0)
+  {
+#if !defined(__GNUC__) && !defined(WIN32) && defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_init(&mutex, NULL);
+#endif
+  }
+
+  /*!
+    Destructor.
+  */
+  virtual ~vpTripleBuffer()
+  {
+#if !defined(__GNUC__) && !defined(WIN32) && defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_destroy(&mutex);
+#endif
+  }
+
+  /*!
+    \return The buffer that the producer fills before calling publish().
+    It is only accessed by the producer thread.
+  */
+  inline Type &getWriteBuffer() { return buffers[back]; }
+
+  /*!
+    Hand the buffer filled by the producer to the consumer. Called by
+    the producer thread.
+  */
+  void publish()
+  {
+    unsigned int previous = exchange(back | NEW_FRAME);
+    if (previous & NEW_FRAME)
+      nbDropped++;
+    back = previous & ~NEW_FRAME;
+    nbPublished++;
+  }
+
+  /*!
+    Take the last published frame, if any. Called by the consumer
+    thread.
+
+    \return true if a frame was published since the last call, false if
+    getReadBuffer() is unchanged.
+  */
+  bool update()
+  {
+    if (! (load() & NEW_FRAME))
+      return false;
+    front = exchange(front) & ~NEW_FRAME;
+    return true;
+  }
+
+  /*!
+    \return The last frame taken by update(). It is only accessed by
+    the consumer thread.
+  */
+  inline Type &getReadBuffer() { return buffers[front]; }
+
+  /*!
+    \return The buffer of index \e i, between 0 and 2, to initialize the
+    three buffers before the threads start.
+  */
+  inline Type &operator[](unsigned int i) { return buffers[i]; }
+
+  //! \return The number of frames published by the producer. Exact
+  //! only when read by the producer thread or after it stopped.
+  inline unsigned long getNbPublishedFrames() const { return nbPublished; }
+  //! \return The number of published frames that the consumer did not
+  //! take. Exact only when read by the producer thread or after it stopped.
+  inline unsigned long getNbDroppedFrames() const { return nbDropped; }
+
+private:
+  // Flag of the pending index set when it holds a frame not yet taken
+  static const unsigned int NEW_FRAME = 4;
+
+  // Not copyable
+  vpTripleBuffer(const vpTripleBuffer &);
+  vpTripleBuffer &operator=(const vpTripleBuffer &);
+
+  // Atomically read the pending index.
+  unsigned int load()
+  {
+#if defined(__GNUC__)
+    return __sync_fetch_and_or(&pending, 0);
+#elif defined(WIN32)
+    return (unsigned int)InterlockedCompareExchange((volatile LONG *)&pending, 0, 0);
+#elif defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_lock(&mutex);
+    unsigned int value = pending;
+    pthread_mutex_unlock(&mutex);
+    return value;
+#else
+    return pending;
+#endif
+  }
+
+  // Atomically replace the pending index and return the previous one.
+  // It is a full memory barrier: the frame written before is visible to
+  // the thread that takes it.
+  unsigned int exchange(unsigned int value)
+  {
+#if defined(__GNUC__)
+    unsigned int previous = value;
+    for (;;) {
+      unsigned int current = __sync_val_compare_and_swap(&pending, previous, value);
+      if (current == previous)
+        return previous;
+      previous = current;
+    }
+#elif defined(WIN32)
+    return (unsigned int)InterlockedExchange((volatile LONG *)&pending, (LONG)value);
+#elif defined(VISP_HAVE_PTHREAD)
+    pthread_mutex_lock(&mutex);
+    unsigned int previous = pending;
+    pending = value;
+    pthread_mutex_unlock(&mutex);
+    return previous;
+#else
+    unsigned int previous = pending;
+    pending = value;
+    return previous;
+#endif
+  }
+
+  Type buffers[3];
+  unsigned int back;              //!< Owned by the producer
+  volatile unsigned int pending;  //!< Exchanged, with the NEW_FRAME flag
+  unsigned int front;             //!< Owned by the consumer
+  unsigned long nbPublished;
+  unsigned long nbDropped;
+#if !defined(__GNUC__) && !defined(WIN32) && defined(VISP_HAVE_PTHREAD)
+  pthread_mutex_t mutex;
+#endif
+};
+
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
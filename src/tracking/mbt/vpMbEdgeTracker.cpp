@@ -70,6 +70,37 @@
 #include <sstream>
 #include <float.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Add the contribution of the nbFeature rows of the interaction matrix L to
+    the upper part of LTL and to LTR. Row i is scaled by rowWeight[offset+i]
+    and associated to the error weighted_error[offset+i].
+  */
+  void addToNormalEquations(const vpMatrix &L, const unsigned int nbFeature,
+                            const unsigned int offset,
+                            const vpColVector &rowWeight,
+                            const vpColVector &weighted_error,
+                            double LTL[6][6], double LTR[6])
+  {
+    double li[6];
+    for (unsigned int i = 0; i < nbFeature; i++){
+      double wi = rowWeight[offset+i];
+      double ei = weighted_error[offset+i];
+      for (unsigned int j = 0; j < 6; j++){
+        li[j] = wi*L[i][j];
+      }
+      for (unsigned int j = 0; j < 6; j++){
+        for (unsigned int k = j; k < 6; k++){
+          LTL[j][k] += li[k]*li[j];
+        }
+        LTR[j] += li[j]*ei;
+      }
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Basic constructor
 */
@@ -92,6 +123,7 @@ vpMbEdgeTracker::vpMbEdgeTracker()
   lines[0].clear();
   cylinders[0].clear();
   Ipyramid.resize(0);
+  nthreads = 1;
 }
 
 /*!
@@ -153,6 +185,54 @@ vpMbEdgeTracker::setMovingEdge(const vpMe &_me)
 }
 
 
+/*!
+  Compute the normal equations \f$ {\bf L}^T {\bf L} \f$ and 
+  \f$ {\bf L}^T {\bf e} \f$ of the virtual visual servoing directly from the 
+  interaction matrices of the lines and cylinders. The rows are weighted on the
+  fly, so that the interaction matrix of all the features is never built. The 
+  summation order is the one of vpMatrix::AtA() applied to the stacked and 
+  weighted interaction matrix.
+
+  \param rowWeight : Weight applied to each row of the interaction matrix.
+  \param weighted_error : Weighted error of each feature.
+  \param LTL : The 6x6 matrix \f$ {\bf L}^T {\bf L} \f$.
+  \param LTR : The 6x1 vector \f$ {\bf L}^T {\bf e} \f$.
+*/
+void
+vpMbEdgeTracker::computeVVSNormalEquations(const vpColVector &rowWeight, const vpColVector &weighted_error,
+                                           vpMatrix &LTL, vpColVector &LTR)
+{
+  double A[6][6];
+  double b[6];
+  for (unsigned int j = 0; j < 6; j++){
+    b[j] = 0;
+    for (unsigned int k = 0; k < 6; k++){
+      A[j][k] = 0;
+    }
+  }
+
+  unsigned int n = 0;
+  for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
+    vpMbtDistanceLine *l = *it;
+    addToNormalEquations(l->L, l->nbFeature, n, rowWeight, weighted_error, A, b);
+    n += l->nbFeature;
+  }
+  for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
+    vpMbtDistanceCylinder *cy = *it;
+    addToNormalEquations(cy->L, cy->nbFeature, n, rowWeight, weighted_error, A, b);
+    n += cy->nbFeature;
+  }
+
+  LTL.resize(6, 6);
+  LTR.resize(6);
+  for (unsigned int j = 0; j < 6; j++){
+    for (unsigned int k = j; k < 6; k++){
+      LTL[j][k] = LTL[k][j] = A[j][k];
+    }
+    LTR[j] = b[j];
+  }
+}
+
 /*!
   Compute the visual servoing loop to get the pose of the feature set.
   
@@ -166,8 +246,8 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
 {
   double residu_1 =1e3;
   double r =1e3-1;
-  vpMatrix LTL;
-  vpColVector LTR;
+  vpMatrix LTL(6,6);
+  vpColVector LTR(6);
 
   // compute the interaction matrix and its pseudo inverse
   vpMbtDistanceLine *l ;
@@ -176,6 +256,7 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
   vpColVector w;
   vpColVector weighted_error;
   vpColVector factor;
+  vpColVector rowWeight;
 
   unsigned int iter = 0;
 
@@ -203,8 +284,6 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
     throw vpTrackingException(vpTrackingException::notEnoughPointError, "\n\t\t Error-> not enough data in the interaction matrix...");
   }
   
-  vpMatrix L(nbrow,6), Lp;
-
   // compute the error vector
   vpColVector error(nbrow);
   unsigned int nerror = error.getRows();
@@ -229,6 +308,7 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
       w = 0;
       factor.resize(nerror);
       factor = 1;
+      rowWeight.resize(nerror);
     }
     
     count = 0;
@@ -263,10 +343,6 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
       
       for (unsigned int i=0 ; i < l->nbFeature ; i++)
       {
-        for (unsigned int j=0; j < 6 ; j++)
-        {
-          L[n+i][j] = l->L[i][j]; //On remplit la matrice d'interaction globale
-        }
         error[n+i] = l->error[i]; //On remplit la matrice d'erreur
 
         if (error[n+i] <= limite) count = count+1.0; //Si erreur proche de 0 on incremente cur
@@ -340,9 +416,6 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
       }
 
       for(unsigned int i=0 ; i < cy->nbFeature ; i++){
-        for(unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = cy->L[i][j]; //On remplit la matrice d'interaction globale
-        }
         error[n+i] = cy->error[i]; //On remplit la matrice d'erreur
 
         if (error[n+i] <= limite) count = count+1.0; //Si erreur proche de 0 on incremente cur
@@ -446,18 +519,10 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
       den += wi ;
 
       weighted_error[i] =  wi*eri ;
+      rowWeight[i] = ((iter==0) || compute_interaction) ? wi : 1.;
     }
 
-    if((iter==0) || compute_interaction){
-      for (unsigned int i=0 ; i < nerror ; i++){
-        for (unsigned int j=0 ; j < 6 ; j++){
-          L[i][j] = w[i]*factor[i]*L[i][j] ;
-        }
-      }
-    }
-
-    LTL = L.AtA();
-    computeJTR(L, weighted_error, LTR);
+    computeVVSNormalEquations(rowWeight, weighted_error, LTL, LTR);
     v = -0.7*LTL.pseudoInverse(LTL.getRows()*DBL_EPSILON)*LTR;
     cMo =  vpExponentialMap::direct(v).inverse() * cMo;
 
@@ -478,8 +543,6 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
   vpColVector error_cylinders(nberrors_cylinders);
 
   vpColVector error_vec;
-  vpColVector W_true;
-  vpMatrix L_true;
   
   while ( ((int)((residu_1 - r)*1e8) !=0 )  && (iter<30))
   {
@@ -490,11 +553,8 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
       l = *it;
       l->computeInteractionMatrixError(cMo) ;
       for (unsigned int i=0 ; i < l->nbFeature ; i++){
-        for (unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = l->L[i][j];
-          error[n+i] = l->error[i];
-          error_lines[nlines+i] = error[n+i];
-        }
+        error[n+i] = l->error[i];
+        error_lines[nlines+i] = error[n+i];
       }
       n+= l->nbFeature;
       nlines+= l->nbFeature;
@@ -504,11 +564,8 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
       cy = *it;
       cy->computeInteractionMatrixError(cMo, _I) ;
       for(unsigned int i=0 ; i < cy->nbFeature ; i++){
-        for(unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = cy->L[i][j];
-          error[n+i] = cy->error[i];
-          error_cylinders[ncylinders+i] = error[n+i];
-        }
+        error[n+i] = cy->error[i];
+        error_cylinders[ncylinders+i] = error[n+i];
       }
 
       n+= cy->nbFeature ;
@@ -562,41 +619,55 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I)
     double wi;
     double eri;
     
-    L_true = L;
-    W_true = vpColVector(nerror);
-    
     for(unsigned int i=0; i<nerror; i++){
       wi = w[i]*factor[i];
-      W_true[i] = wi*wi;
       eri = error[i];
       num += wi*vpMath::sqr(eri);
       den += wi;
 
       weighted_error[i] =  wi*eri ;
+      rowWeight[i] = ((iter==0) || compute_interaction) ? wi : 1.;
     }
     
     r = sqrt(num/den); //Le critere d'arret prend en compte le poids
 
-    if((iter==0)|| compute_interaction){
-      for (unsigned int i=0 ; i < nerror ; i++){
-        for (unsigned int j=0 ; j < 6 ; j++){
-          L[i][j] = w[i]*factor[i]*L[i][j];
-        }
-      }
-    }
-
-    LTL = L.AtA();
-    computeJTR(L, weighted_error, LTR);
+    computeVVSNormalEquations(rowWeight, weighted_error, LTL, LTR);
     v = -lambda*LTL.pseudoInverse(LTL.getRows()*DBL_EPSILON)*LTR;
     cMo =  vpExponentialMap::direct(v).inverse() * cMo;
 
     iter++;
   }
   
-  vpMatrix D; //Should be the M.diag(wi) * M.diag(wi).transpose() =  (M.diag(wi^2))  which is more efficient
-  D.diag(W_true);
-  
   if(computeCovariance){
+    // The interaction matrices of the primitives are still the ones of the 
+    // last iteration. The full interaction matrix is only built here.
+    vpMatrix L_true(nbrow, 6);
+    vpColVector W_true(nerror);
+    unsigned int n = 0;
+    for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
+      l = *it;
+      for (unsigned int i=0 ; i < l->nbFeature ; i++){
+        for (unsigned int j=0; j < 6 ; j++){
+          L_true[n+i][j] = l->L[i][j];
+        }
+      }
+      n+= l->nbFeature;
+    }
+    for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
+      cy = *it;
+      for(unsigned int i=0 ; i < cy->nbFeature ; i++){
+        for(unsigned int j=0; j < 6 ; j++){
+          L_true[n+i][j] = cy->L[i][j];
+        }
+      }
+      n+= cy->nbFeature ;
+    }
+    for(unsigned int i=0; i<nerror; i++){
+      W_true[i] = vpMath::sqr(w[i]*factor[i]);
+    }
+
+    vpMatrix D; //Should be the M.diag(wi) * M.diag(wi).transpose() =  (M.diag(wi^2))  which is more efficient
+    D.diag(W_true);
     covarianceMatrix = vpMatrix::computeCovarianceMatrix(L_true,v,-lambda*error,D);
   }
   
@@ -1081,12 +1152,20 @@ vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHomogen
 
 /*!
   Track the moving edges in the image.
+
+  The primitives are tracked in parallel when ViSP is built with OpenMP and
+  more than one thread is set with setNumberOfThreads(). Each primitive only
+  updates its own moving edges, so that the result does not depend on the
+  number of threads.
   
   \param I : the image.
 */
 void
 vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 {
+  // The initialisation modifies the range of the shared vpMe and is 
+  // done sequentially before the tracking.
+  std::vector<vpMbtDistanceLine*> trackedLines;
   vpMbtDistanceLine *l ;
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     l = *it;
@@ -1094,20 +1173,52 @@ vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
       if(l->meline == NULL){
         l->initMovingEdge(I, cMo);
       }
-      l->trackMovingEdge(I, cMo) ;
+      trackedLines.push_back(l);
     }
   }
 
+  std::vector<vpMbtDistanceCylinder*> trackedCylinders;
   vpMbtDistanceCylinder *cy;
   for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
     cy = *it;
     if(cy->meline1 == NULL || cy->meline2 == NULL){
       cy->initMovingEdge(I, cMo);
     }
-    cy->trackMovingEdge(I, cMo) ;
+    trackedCylinders.push_back(cy);
+  }
+
+  int nbLines = (int)trackedLines.size();
+  int nbPrimitives = nbLines + (int)trackedCylinders.size();
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel for schedule(dynamic) num_threads(nthreads) if(nthreads > 1)
+#endif
+  for(int i = 0; i < nbPrimitives; i++){
+    if(i < nbLines){
+      trackedLines[(unsigned int)i]->trackMovingEdge(I, cMo) ;
+    }
+    else{
+      trackedCylinders[(unsigned int)(i - nbLines)]->trackMovingEdge(I, cMo) ;
+    }
   }
 }
 
+/*!
+  Set the number of threads used to track the moving edges of the lines and
+  cylinders in trackMovingEdge(). This setting is only effective when ViSP is
+  built with OpenMP. By default a single thread is used.
+
+  The update of the moving edges that follows the pose computation is always
+  done sequentially since it modifies the range of the vpMe shared by all the
+  primitives.
+
+  \param _nthreads : The number of threads. 0 is considered as 1.
+*/
+void
+vpMbEdgeTracker::setNumberOfThreads(const unsigned int _nthreads)
+{
+  nthreads = (_nthreads == 0) ? 1 : _nthreads;
+}
+
 
 /*!
   Update the moving edges at the end of the virtual visual servoing.
@@ -1637,14 +1748,16 @@ vpMbEdgeTracker::setScales(const std::vector<bool>& _scales)
 
 /*!
   Compute the pyramid of image associated to the image in parameter. The scales 
-  computed are the ones corresponding to the scales  attribte of the class. If 
-  OpenCV is detected, the functions used to computed a smoothed pyramid come 
-  from OpenCV, otherwise a simple subsampling (no smoothing, no interpolation) 
-  is realised. 
+  computed are the ones corresponding to the scales  attribte of the class. The
+  images are computed by the pyramid attribute of the class, that keeps them 
+  allocated from one call to the next. Depending on 
+  setPyramidReductionType(), the scales are obtained by a simple subsampling 
+  (no smoothing, no interpolation) or by a Gaussian smoothing followed by a 
+  subsampling. 
   
-  \warning The pyramid contains pointers to vpImage. To properly deallocate the
-  pyramid. All the element but the first (which is a pointer to the input image)
-  must be freed. A proper cleaning is implemented in the cleanPyramid() method. 
+  \warning The pyramid contains pointers to vpImage owned by the pyramid 
+  attribute (except the first one which is a pointer to the input image). These
+  pointers must not be freed. They are reset by the cleanPyramid() method. 
   
   \param _I : The input image.
   \param _pyramid : The pyramid of image to build from the input image.
@@ -1652,36 +1765,12 @@ vpMbEdgeTracker::setScales(const std::vector<bool>& _scales)
 void 
 vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, std::vector< const vpImage<unsigned char>* >& _pyramid)
 {
+  pyramid.build(_I, scales);
+
   _pyramid.resize(scales.size());
-  
-  if(scales[0]){
-    _pyramid[0] = &_I;
-  }
-  else{
-    _pyramid[0] = NULL;
-  }
-  
-  for(unsigned int i=1; i<_pyramid.size(); i += 1){
+  for(unsigned int i=0; i<_pyramid.size(); i += 1){
     if(scales[i]){
-      unsigned int cScale = static_cast<unsigned int>(pow(2., (int)i));
-      vpImage<unsigned char>* I = new vpImage<unsigned char>(_I.getHeight() / cScale, _I.getWidth() / cScale);
-#ifdef VISP_HAVE_OPENCV
-      IplImage* vpI0 = cvCreateImageHeader(cvSize((int)_I.getWidth(), (int)_I.getHeight()), IPL_DEPTH_8U, 1);
-      vpI0->imageData = (char*)(_I.bitmap);
-      IplImage* vpI = cvCreateImage(cvSize((int)(_I.getWidth() / cScale), (int)(_I.getHeight() / cScale)), IPL_DEPTH_8U, 1);
-      cvResize(vpI0, vpI, CV_INTER_NN);
-      vpImageConvert::convert(vpI, *I);
-      cvReleaseImage(&vpI);  
-      vpI0->imageData = NULL;
-      cvReleaseImageHeader(&vpI0);    
-#else
-      for (unsigned int k = 0, ii = 0; k < I->getHeight(); k += 1, ii += cScale){
-        for (unsigned int l = 0, jj = 0; l < I->getWidth(); l += 1, jj += cScale){
-          (*I)[k][l] = _I[ii][jj];
-        }
-      }
-#endif   
-      _pyramid[i] = I;
+      _pyramid[i] = pyramid.getLevel(i);
     }
     else{
       _pyramid[i] = NULL;
@@ -1690,24 +1779,16 @@ vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, std::vector< cons
 }
 
 /*!
-  Clean the pyramid of image allocated with the initPyramid() method. The vector
-  has a size equal to zero at the end of the method. 
+  Clean the pyramid of image built with the initPyramid() method. The vector
+  has a size equal to zero at the end of the method. The images are not freed
+  since they are reused by the next call to initPyramid().
   
   \param _pyramid : The pyramid of image to clean.
 */
 void 
 vpMbEdgeTracker::cleanPyramid(std::vector< const vpImage<unsigned char>* >& _pyramid)
 {
-  if(_pyramid.size() > 0){
-    _pyramid[0] = NULL;
-    for (unsigned int i = 1; i < _pyramid.size(); i += 1){
-      if(_pyramid[i] != NULL){
-        delete _pyramid[i];
-        _pyramid[i] = NULL;
-      }
-    }
-    _pyramid.resize(0);
-  }
+  _pyramid.resize(0);
 }
 
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
@@ -56,6 +56,7 @@
 #include <visp/vpMbtDistanceLine.h>
 #include <visp/vpMbtDistanceCylinder.h>
 #include <visp/vpXmlParser.h>
+#include <visp/vpImagePyramid.h>
 
 #include <iostream>
 #include <fstream>
@@ -155,6 +156,7 @@ int main()
   scales.push_back(false); //Second scale (/2) : not active
   scales.push_back(true); //Third scale (/4) : active
   tracker.setScales(scales); // Set active scales for multi-scale tracking
+  tracker.setPyramidReductionType(vpImagePyramid::GAUSSIAN); // Smooth the scales /2 and /4
 
   tracker.loadConfigFile("cube.xml"); // Load the configuration of the tracker
   tracker.getCameraParameters(cam); // Get the camera parameters used by the tracker (from the configuration file).
@@ -283,6 +285,12 @@ class VISP_EXPORT vpMbEdgeTracker: public vpMbTracker
     
     //! Pyramid of image associated to the current image. This pyramid is compted in the init() and in the track() methods.
     std::vector< const vpImage<unsigned char>* > Ipyramid;
+
+    //! Images of the pyramid, kept allocated from one image to the next.
+    vpImagePyramid pyramid;
+
+    //! Number of threads used to track the moving edges of the primitives.
+    unsigned int nthreads;
     
     //! Current scale level used. This attribute must not be modified outsied of the downScale() and upScale() methods, as it used to specify to some methods which set of distanceLine use. 
     unsigned int scaleLevel;
@@ -362,6 +370,44 @@ public:
   */
   std::vector<bool> getScales() const {return scales;}
 
+  /*!
+    Return the pyramid of images computed from the last image given to
+    init() or track(). It can be used by other trackers working on the
+    same image to avoid building their own pyramid. The levels
+    activated with setScales() are always computed.
+
+    \warning The level 0 of the pyramid is a pointer to the last image
+    given to init() or track().
+
+    \return The pyramid of images used for the tracking.
+  */
+  const vpImagePyramid& getPyramid() const {return pyramid;}
+
+  /*!
+    Set the method used to compute the scales of the pyramid. By default
+    the scales are computed by decimation, without smoothing.
+
+    \param _type : The reduction method.
+  */
+  void setPyramidReductionType(const vpImagePyramid::vpReductionType _type) {pyramid.setReductionType(_type);}
+
+  /*!
+    Set the number of threads used to compute the pyramid. This setting
+    is only effective when ViSP is built with OpenMP.
+
+    \param _nthreads : The number of threads.
+  */
+  void setPyramidNumberOfThreads(const unsigned int _nthreads) {pyramid.setNumberOfThreads(_nthreads);}
+
+  void setNumberOfThreads(const unsigned int _nthreads);
+
+  /*!
+    Return the number of threads used to track the moving edges.
+
+    \return The number of threads.
+  */
+  unsigned int getNumberOfThreads() const {return nthreads;}
+
 
 
   /*!
@@ -388,6 +434,8 @@ public:
 
  protected:
   void computeVVS(const vpImage<unsigned char>& _I);
+  void computeVVSNormalEquations(const vpColVector &rowWeight, const vpColVector &weighted_error,
+                                 vpMatrix &LTL, vpColVector &LTR);
   void initMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo) ;
   void trackMovingEdge(const vpImage<unsigned char> &I) ;
   void updateMovingEdge(const vpImage<unsigned char> &I) ;
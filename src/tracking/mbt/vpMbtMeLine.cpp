@@ -309,7 +309,7 @@ vpMbtMeLine::seekExtremities(const vpImage<unsigned char> &I)
     else
     if(!outOfImage(P.i, P.j, 5, rows, cols))
     {
-      P.track(I,me,false) ;
+      P.track(I,me,false,queries) ;
 
       if (P.getState() == vpMeSite::NO_SUPPRESSION)
       {
@@ -337,7 +337,7 @@ vpMbtMeLine::seekExtremities(const vpImage<unsigned char> &I)
   else
   if(!outOfImage(P.i, P.j, 5, rows, cols))
     {
-      P.track(I,me,false) ;
+      P.track(I,me,false,queries) ;
 			
       if (P.getState() == vpMeSite::NO_SUPPRESSION)
       {
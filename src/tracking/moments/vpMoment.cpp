@@ -52,7 +52,7 @@
 /*!
   Default constructor
 */
-vpMoment::vpMoment(): object(NULL),moments(NULL) {
+vpMoment::vpMoment(): object(NULL),moments(NULL),revision(0) {
 }
 
 
@@ -116,6 +116,21 @@ void vpMoment::linkTo(vpMomentDatabase& moments){
 */
 void vpMoment::update(vpMomentObject& object){
     this->object=&object;
+    this->revision=object.getRevision();
+}
+
+/*!
+  Computes the moment again if its object was modified since the last update
+  or the last refresh, for example with vpMomentObject::updateFromImage().
+  Nothing is done if the moment is up to date or was never updated with an
+  object.
+*/
+void vpMoment::refresh(){
+    if(object==NULL || revision==object->getRevision())
+      return;
+    // Set before computing to stop the recursion if compute() queries the moment
+    revision=object->getRevision();
+    compute();
 }
 
 /*!
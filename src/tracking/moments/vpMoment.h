@@ -93,6 +93,11 @@ class vpMomentObject;
   Each moment must also implement a compute method describing how to obtain its values from the object.
 
   \attention Order of moment computation DOES matter: when you compute (vpMoment::compute call) a moment, all moment dependencies must be computed.
+
+  When the object is modified after the update, for example with vpMomentObject::updateFromImage(),
+  the moment is computed again the next time it is queried with get(), the accessors of the
+  derived classes such as vpMomentGravityCenter::getXg(), or vpMomentDatabase::get().
+  Since the dependencies are obtained from the database, they are also computed again if needed.
   Moments pre-implementes dans ViSP:
   - vpMomentAlpha
   - vpMomentBasic
@@ -106,6 +111,7 @@ class VISP_EXPORT vpMoment{
         vpMomentObject* object;
         vpMomentDatabase* moments;
         char _name[255];
+        unsigned long revision;
  protected:
         std::vector<double> values;
         /*!
@@ -122,8 +128,9 @@ class VISP_EXPORT vpMoment{
         Returns all values computed by the moment.
         \return vector of values
         */
-        std::vector<double>& get(){ return values;}
+        std::vector<double>& get(){ refresh(); return values;}
         void linkTo(vpMomentDatabase& moments);
+        void refresh();
         void update(vpMomentObject& object);
         virtual void compute()=0;
         virtual const char* name() = 0;
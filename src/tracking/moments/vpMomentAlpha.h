@@ -210,7 +210,7 @@ class VISP_EXPORT vpMomentAlpha : public vpMoment {
         /*!
           Retrieve the orientation of the object as a single double value.
           */
-        double get(){ return values[0]; }
+        double get(){ refresh(); return values[0]; }
         /*!
           Moment name.
           */
@@ -133,43 +133,43 @@ class VISP_EXPORT vpMomentCInvariant : public vpMoment {
         /*!
           Shorcut for getting the value of \f$C_1\f$.
           */
-        double C1(){ return values[0]; }
+        double C1(){ refresh(); return values[0]; }
         /*!
           Shorcut for getting the value of \f$C_2\f$.
           */
-        double C2(){ return values[1]; }
+        double C2(){ refresh(); return values[1]; }
         /*!
           Shorcut for getting the value of \f$C_3\f$.
           */
-        double C3(){ return values[2]; }
+        double C3(){ refresh(); return values[2]; }
         /*!
           Shorcut for getting the value of \f$C_4\f$.
           */
-        double C4(){ return values[3]; }
+        double C4(){ refresh(); return values[3]; }
         /*!
           Shorcut for getting the value of \f$C_5\f$.
           */
-        double C5(){ return values[4]; }
+        double C5(){ refresh(); return values[4]; }
         /*!
           Shorcut for getting the value of \f$C_6\f$.
           */
-        double C6(){ return values[5]; }
+        double C6(){ refresh(); return values[5]; }
         /*!
           Shorcut for getting the value of \f$C_7\f$.
           */
-        double C7(){ return values[6]; }
+        double C7(){ refresh(); return values[6]; }
         /*!
           Shorcut for getting the value of \f$C_8\f$.
           */
-        double C8(){ return values[7]; }
+        double C8(){ refresh(); return values[7]; }
         /*!
           Shorcut for getting the value of \f$C_9\f$.
           */
-        double C9(){ return values[8]; }
+        double C9(){ refresh(); return values[8]; }
         /*!
           Shorcut for getting the value of \f$C_{10}\f$.
           */
-        double C10(){ return values[9]; }
+        double C10(){ refresh(); return values[9]; }
 
 	void compute();
 
@@ -177,30 +177,30 @@ class VISP_EXPORT vpMomentCInvariant : public vpMoment {
           Gets the desired invariant.
           \param i given index. For invariants from C1 to C10 the corresponding index is from 0 to 9. For \f$S_x\f$,\f$S_y\f$ the indexes are 10,11 and for \f$P_x\f$,\f$P_y\f$ they are 12,13.
           */
-        double get(unsigned int i){ return values[i]; }
+        double get(unsigned int i){ refresh(); return values[i]; }
 
         /*!
           Access to partial invariant c (see [2]).
           */
-        double getC(unsigned int i){return c[i];}
+        double getC(unsigned int i){ refresh(); return c[i];}
         /*!
           Access to partial invariants. The index convention is the same as in [1].
           */
-        double getI(unsigned int index){return I[index];}
+        double getI(unsigned int index){ refresh(); return I[index];}
 
         /*!
           Access to partial invariant I (see [2]).
           */
-        double getII(unsigned int i){return II[i];}
+        double getII(unsigned int i){ refresh(); return II[i];}
         /*!
           Access to partial invariant K (see [2]).
           */
-        double getK(){return K;}
+        double getK(){ refresh(); return K;}
 
         /*!
           Access to partial invariant S (see [2]).
           */
-        double getS(unsigned int i){return s[i];}
+        double getS(unsigned int i){ refresh(); return s[i];}
 
         /*!
           Moment name.
@@ -215,20 +215,20 @@ class VISP_EXPORT vpMomentCInvariant : public vpMoment {
         /*!
           Shorcut for getting the value of \f$P_x\f$.
           */
-        double Px(){ return values[12]; }
+        double Px(){ refresh(); return values[12]; }
         /*!
           Shorcut for getting the value of\f$P_y\f$.
           */
-        double Py(){ return values[13]; }
+        double Py(){ refresh(); return values[13]; }
 
         /*!
           Shorcut for getting the value of \f$S_x\f$.
           */
-        double Sx(){ return values[10]; }
+        double Sx(){ refresh(); return values[10]; }
         /*!
           Shorcut for getting the value of \f$S_y\f$.
           */
-        double Sy(){ return values[11]; }
+        double Sy(){ refresh(); return values[11]; }
 
         friend VISP_EXPORT std::ostream & operator<<(std::ostream & os, const vpMomentCInvariant& v);
 };
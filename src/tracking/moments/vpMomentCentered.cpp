@@ -91,6 +91,7 @@ double vpMomentCentered::get(unsigned int i,unsigned int j){
     assert(i+j<=getObject().getOrder());
     if(i+j>getObject().getOrder()) throw vpException(vpException::badValue,"The requested value has not been computed, you should specify a higher order.");
 
+    refresh();
     return values[j*(getObject().getOrder()+1)+i];
 }
 
@@ -61,11 +61,17 @@ void vpMomentDatabase::add(vpMoment& moment,const char* name){
   \param type : Name of the moment's class.
   \param found : true if the moment's type exists in the database, false otherwise.
   \return Moment corresponding to \e type.
+
+  If the object of the moment was modified since the moment was last
+  computed (see vpMomentObject::updateFromImage()), the moment is computed
+  again before being returned.
 */
 vpMoment& vpMomentDatabase::get(const char* type, bool& found){
   std::map<const char*,vpMoment*,vpMomentDatabase::cmp_str>::const_iterator it = moments.find(type);
     
     found = (it!=moments.end());
+    if(found)
+      it->second->refresh();
     return *(it->second);
 }
 
@@ -44,12 +44,84 @@
 #include <visp/vpCameraParameters.h>
 #include <visp/vpPixelMeterConversion.h>
 #include <visp/vpConfig.h>
+#include <visp/vpDebug.h>
 #include <cmath>
 #include <limits>
 #ifdef VISP_HAVE_OPENMP
 #include <omp.h>
 #endif
 #include <cassert>
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Computes for l in [0:order-1] the sum of x^l over the pixels of the
+    row that are above the threshold. When prev is not NULL, the pixels of
+    prev that are above the threshold are counted negatively, so that only
+    the pixels that changed contribute. The powers of x are stored in xpow,
+    one block of stride values per power. mask is a scratch buffer of
+    width values.
+
+    Returns the number of contributing pixels.
+  */
+  unsigned int rowSums(const unsigned char *row, const unsigned char *prev,
+                       unsigned int width, unsigned char threshold,
+                       const double *xpow, unsigned int stride, unsigned int order,
+                       double *mask, double *s)
+  {
+    unsigned int count = 0;
+    double sum0 = 0.;
+    for(unsigned int i=0;i<width;i++){
+      double m = (row[i] > threshold) ? 1. : 0.;
+      if(prev != NULL)
+        m -= (prev[i] > threshold) ? 1. : 0.;
+      mask[i] = m;
+      sum0 += m;
+      count += (m != 0.) ? 1 : 0;
+    }
+    if(count == 0)
+      return 0;
+
+    s[0] = sum0;
+    if(4*count < width){
+      // Few contributing pixels, typically when only the boundary of the
+      // object changed: sparse accumulation
+      for(unsigned int l=1;l<order;l++)
+        s[l] = 0.;
+      for(unsigned int i=0;i<width;i++){
+        if(mask[i] != 0.){
+          for(unsigned int l=1;l<order;l++)
+            s[l] += mask[i]*xpow[l*stride+i];
+        }
+      }
+      return count;
+    }
+    for(unsigned int l=1;l<order;l++){
+      const double *xl = xpow + l*stride;
+      unsigned int i = 0;
+      double sum = 0.;
+#ifdef VISP_HAVE_SSE2
+      __m128d acc0 = _mm_setzero_pd();
+      __m128d acc1 = _mm_setzero_pd();
+      for( ; i+4<=width; i+=4){
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(mask+i), _mm_loadu_pd(xl+i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(mask+i+2), _mm_loadu_pd(xl+i+2)));
+      }
+      double tmp[2];
+      _mm_storeu_pd(tmp, _mm_add_pd(acc0, acc1));
+      sum = tmp[0] + tmp[1];
+#endif
+      for( ; i<width; i++)
+        sum += mask[i]*xl[i];
+      s[l] = sum;
+    }
+    return count;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   Computes moments from a vector of points describing a polygon.
@@ -230,12 +302,20 @@ void vpMomentObject::fromVector(std::vector<vpPoint>& points){
             }
         }
     }
+    revision++;
 }
 
 /*!
   Computes basic moments from an image.
   There is no assumption made about whether the input is dense or discrete but it's more common to use vpMomentObject::DENSE_FULL_OBJECT with this method.
 
+  The image is scanned row by row. When the camera has no distortion, the
+  normalized coordinates are separable: the powers of x are tabulated once per
+  column, the sums of these powers are accumulated over each row, and they are
+  then weighted by the powers of the row coordinate y. The rows are shared
+  between the OpenMP threads and the partial sums are merged by a pairwise
+  tree reduction.
+
   \param image : Image to consider.
   \param threshold : Pixels with a luminance lower than this threshold will be considered.
   \param cam : Camera parameters used to convert pixels coordinates in meters in the image plane.
@@ -262,72 +342,182 @@ int main()
 */
 
 void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned char threshold, const vpCameraParameters& cam){
-#ifdef VISP_HAVE_OPENMP    
-  #pragma omp parallel shared(threshold)
-  {        
-    std::vector<double> curvals(order*order); 
-    curvals.assign(order*order,0.);
-    unsigned int i_, j_;
-
-    #pragma omp for nowait//automatically organize loop counter between threads
-    for(int i=0;i<(int)image.getCols();i++){
-      for(int j=0;j<(int)image.getRows();j++){
-        i_ = static_cast<unsigned int>(i);
-        j_ = static_cast<unsigned int>(j);
-        if(image[j_][i_]>threshold){
-          double x=0;
-          double y=0;
-          vpPixelMeterConversion::convertPoint(cam,i_,j_,x,y);
-
-          double xval=1.;
-          double yval=1.;
-          for(register unsigned int k=0;k<order;k++){            
-            xval=1.;
-            for(register unsigned int l=0;l<order-k;l++){
-              curvals[(k*order+l)]+=(xval*yval);
-              xval*=x;
-            }
-            yval*=y;
-          }          
-        }
-      }
-    }    
-    
-    #pragma omp master //only set this variable in master thread
-    {      
-      values.assign(order*order, 0.);      
-    }
+  values.assign(order*order, 0.);
+  addImage(NULL, image, threshold, cam);
+  revision++;
+}
+
+/*!
+  Updates the basic moments computed from the image \e previous so that they
+  correspond to the image \e image. Only the pixels that crossed the threshold
+  between the two images contribute: the monomials of the pixels that entered
+  the object are added and those of the pixels that left it are subtracted.
+  When the object only moves slightly between two frames, this is much cheaper
+  than fromImage().
+
+  The basic moments have to be the ones of \e previous, computed with
+  fromImage() or updateFromImage() with the same threshold and camera
+  parameters. Since the update accumulates rounding errors, it may be useful to
+  call fromImage() from time to time.
+
+  The moments of a vpMomentDatabase linked to this object are not computed
+  again by this method. They are computed again when they are queried with
+  vpMomentDatabase::get() or vpMoment::get().
+
+  \param previous : Image the current basic moments were computed from.
+  \param image : New image to consider.
+  \param threshold : Pixels with a luminance lower than this threshold will be considered.
+  \param cam : Camera parameters used to convert pixels coordinates in meters in the image plane.
+
+  \exception vpException::dimensionError : If the two images do not have the same size.
 
-    #pragma omp barrier
-    
-    for(register unsigned int k=0;k<order;k++){    
-      for(register unsigned int l=0;l<order-k;l++){
-        #pragma omp atomic
-        values[k*order+l]+= curvals[k*order+l];
+  \code
+#include <visp/vpMomentObject.h>
+#include <visp/vpImage.h>
+
+int main()
+{
+  vpCameraParameters cam;
+  vpImage<unsigned char> I(288, 384), Iprev;
+  // ... Initialize the image
+
+  vpMomentObject obj(3);
+  obj.fromImage(I, 128, cam);
+  for ( ; ; ) {
+    Iprev = I;
+    // ... Acquire a new image in I
+    obj.updateFromImage(Iprev, I, 128, cam);
+  }
+}
+  \endcode
+*/
+void vpMomentObject::updateFromImage(const vpImage<unsigned char>& previous, const vpImage<unsigned char>& image,
+                                     unsigned char threshold, const vpCameraParameters& cam){
+  if(previous.getRows() != image.getRows() || previous.getCols() != image.getCols()){
+    vpERROR_TRACE("Images of different sizes %dx%d and %dx%d",
+                  previous.getCols(), previous.getRows(), image.getCols(), image.getRows());
+    throw vpException(vpException::dimensionError, "The two images do not have the same size");
+  }
+  if(values.size() < order*order)
+    values.resize(order*order, 0.);
+  addImage(&previous, image, threshold, cam);
+  revision++;
+}
+
+/*!
+  Adds the contributions of the pixels of \e image above the threshold to the
+  basic moments. When \e previous is not NULL, the pixels of \e previous above
+  the threshold are subtracted. Used internally.
+*/
+void vpMomentObject::addImage(const vpImage<unsigned char>* previous, const vpImage<unsigned char>& image,
+                              unsigned char threshold, const vpCameraParameters& cam){
+  const unsigned int height = image.getRows();
+  const unsigned int width = image.getCols();
+  const unsigned int size = order*order;
+
+  // Without distortion the coordinates are separable: x only depends on
+  // the column and y on the row. The powers of x are tabulated once.
+  const bool separable =
+      (cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion);
+  std::vector<double> xpow;
+  std::vector<double> ytab(height);
+  if(separable){
+    xpow.resize(order*width);
+    for(unsigned int i=0;i<width;i++){
+      double x = ((double)i - cam.get_u0())*cam.get_px_inverse();
+      double xval = 1.;
+      for(unsigned int l=0;l<order;l++){
+        xpow[l*width+i] = xval;
+        xval *= x;
       }
     }
-    
-  }    
-  
+    for(unsigned int j=0;j<height;j++)
+      ytab[j] = ((double)j - cam.get_v0())*cam.get_py_inverse();
+  }
+
+#ifdef VISP_HAVE_OPENMP
+  std::vector<double> partial((unsigned int)omp_get_max_threads()*size, 0.);
+  #pragma omp parallel
 #else
-  std::vector<double> cache(order*order,0.);
-    values.assign(order*order,0);
-    for(register unsigned int i=0;i<image.getCols();i++){
-        for(register unsigned int j=0;j<image.getRows();j++){
-            if(image[j][i]>threshold){
-                double x=0;
-                double y=0;
-                vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-                cacheValues(cache,x,y);
-                for(register unsigned int k=0;k<order;k++){
-                    for(register unsigned int l=0;l<order-k;l++){
-                        values[k*order+l]+=cache[k*order+l];
-                    }
-                }
+  std::vector<double> partial(size, 0.);
+#endif
+  {
+#ifdef VISP_HAVE_OPENMP
+    const int nthreads = omp_get_num_threads();
+    const int t = omp_get_thread_num();
+#else
+    const int t = 0;
+#endif
+    double *curvals = &partial[(unsigned int)t*size];
+    std::vector<double> mask(width);
+    std::vector<double> rowvals(order);
+
+    int h = (int)height;
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for(int j=0;j<h;j++){
+      const unsigned char *row = image[(unsigned int)j];
+      const unsigned char *prev = (previous != NULL) ? (*previous)[(unsigned int)j] : NULL;
+      // Only the span of the row that changed has to be considered
+      unsigned int i0 = 0, i1 = width;
+      if(prev != NULL){
+        while(i0 < i1 && row[i0] == prev[i0]) i0++;
+        while(i1 > i0 && row[i1-1] == prev[i1-1]) i1--;
+        if(i0 == i1)
+          continue;
+      }
+      if(separable){
+        // Sums of the powers of x over the row, then weighted by the powers of y
+        if(rowSums(row+i0, (prev != NULL) ? prev+i0 : NULL, i1-i0, threshold,
+                   &xpow[i0], width, order, &mask[0], &rowvals[0]) == 0)
+          continue;
+        double yval = 1.;
+        for(unsigned int k=0;k<order;k++){
+          for(unsigned int l=0;l<order-k;l++)
+            curvals[k*order+l] += yval*rowvals[l];
+          yval *= ytab[(unsigned int)j];
+        }
+      }
+      else{
+        for(unsigned int i=i0;i<i1;i++){
+          int w = (row[i]>threshold) ? 1 : 0;
+          if(prev != NULL)
+            w -= (prev[i]>threshold) ? 1 : 0;
+          if(w != 0){
+            double x=0;
+            double y=0;
+            vpPixelMeterConversion::convertPoint(cam,i,(unsigned int)j,x,y);
+            double yval=(double)w;
+            for(unsigned int k=0;k<order;k++){
+              double xval=yval;
+              for(unsigned int l=0;l<order-k;l++){
+                curvals[k*order+l]+=xval;
+                xval*=x;
+              }
+              yval*=y;
             }
+          }
         }
+      }
+    }
+
+#ifdef VISP_HAVE_OPENMP
+    // Pairwise tree reduction of the partial sums into the first one
+    for(int step=1;step<nthreads;step*=2){
+      if((t % (2*step)) == 0 && (t+step) < nthreads){
+        double *dst = curvals;
+        const double *src = &partial[(unsigned int)(t+step)*size];
+        for(unsigned int k=0;k<size;k++)
+          dst[k] += src[k];
+      }
+      #pragma omp barrier
     }
 #endif
+  }
+
+  for(unsigned int k=0;k<size;k++)
+    values[k] += partial[k];
 }
 
 
@@ -343,7 +533,7 @@ void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned cha
   parameter. For example if this parameter is 5, all moment values of
   order 0 to 5 included will be computed.
 */
-vpMomentObject::vpMomentObject(unsigned int order) : order(order+1),type(DENSE_FULL_OBJECT){
+vpMomentObject::vpMomentObject(unsigned int order) : order(order+1),type(DENSE_FULL_OBJECT),revision(0){
     values.resize((order+1)*(order+1)*12);
     values.assign((order+1)*(order+1)*12,0);
 }
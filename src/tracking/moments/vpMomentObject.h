@@ -75,6 +75,14 @@ class vpCameraParameters;
 
   With setType() method you can specify the object type.
 
+  When a dense object defined by a binary image moves, only the pixels along
+  its boundary change from one frame to the next. Instead of calling
+  fromImage() again, updateFromImage() only adds the contributions of the
+  pixels that entered the object and removes those of the pixels that left it.
+  Each modification of the basic moments increments a revision number (see
+  getRevision()) that allows the moments of a vpMomentDatabase to be computed
+  again only when they are queried.
+
 
   \attention Be careful with the object order. When you specify a maximum order in the vpMomentObject::vpMomentObject constructor (see its detailed description),
     it will compute all moment orders up to the order you specified. If you want to access the values \f$ m_{ij} \f$ with the vpMomentObject::get method, you can
@@ -223,6 +231,8 @@ public:
   vpMomentObject(unsigned int order);
   void fromImage(const vpImage<unsigned char>& image,unsigned char threshold, const vpCameraParameters& cam);
   void fromVector(std::vector<vpPoint>& points);
+  void updateFromImage(const vpImage<unsigned char>& previous, const vpImage<unsigned char>& image,
+                       unsigned char threshold, const vpCameraParameters& cam);
   std::vector<double>& get();
   double get(unsigned int i,unsigned int j) const;
   /*!
@@ -234,6 +244,11 @@ public:
     are for  \f$i+j \in [0:\mbox{order}]\f$.
   */
   unsigned int getOrder() const {return order-1;}
+  /*!
+    \return The revision of the basic moments. It is incremented each time the
+    moments are computed or updated.
+  */
+  unsigned long getRevision() const {return revision;}
   /*!
     Specifies the type of the input data.
     \param type : An input type.
@@ -245,6 +260,9 @@ private:
   unsigned int order;
   vpObjectType type;
   std::vector<double> values;
+  unsigned long revision;
+  void addImage(const vpImage<unsigned char>* previous, const vpImage<unsigned char>& image,
+                unsigned char threshold, const vpCameraParameters& cam);
   void cacheValues(std::vector<double>& cache,double x, double y);
   double calc_mom_polygon(unsigned int p, unsigned int q, const std::vector<vpPoint>& points);
 
@@ -361,7 +361,8 @@ calcul_masques(vpColVector &angle, // d
 
 /*!
   Initialise the array of matrices with the defined size and the number of
-  matrices to create.
+  matrices to create. A copy of the masks as 16 bits integers, used to
+  compute the convolutions, is also built (see getKernel()).
 
 */
 void
@@ -384,6 +385,22 @@ vpMe::initMask()
 
   calcul_masques(angle, mask_size, mask ) ;
 
+  // Copy the masks in contiguous 16 bits integers, the mask values being
+  // integers in [-100, 100]. Rows are padded to a multiple of 8 values
+  // to allow vectorized convolutions.
+  if (kernel != NULL)
+    delete [] kernel;
+
+  kernel_stride = (mask_size + 7) & ~7u ;
+  kernel = new short[n_mask * mask_size * kernel_stride] ;
+  short *pk = kernel ;
+  for (unsigned int m = 0 ; m < n_mask ; m++) {
+    for (unsigned int a = 0 ; a < mask_size ; a++) {
+      for (unsigned int b = 0 ; b < kernel_stride ; b++) {
+        *pk++ = (b < mask_size) ? (short)mask[m][a][b] : 0 ;
+      }
+    }
+  }
 }
 
 
@@ -413,6 +430,8 @@ vpMe::print( )
 vpMe::vpMe()
 {
   mask = NULL ;
+  kernel = NULL ;
+  kernel_stride = 0 ;
   threshold = 1500 ;
   mu1 = 0.5 ;
   mu2 = 0.5 ;
@@ -438,6 +457,8 @@ vpMe::vpMe()
 vpMe::vpMe(const vpMe &me)
 {
   mask = NULL ;
+  kernel = NULL ;
+  kernel_stride = 0 ;
   
   *this = me;
 }
@@ -479,6 +500,11 @@ vpMe::~vpMe()
     delete [] mask ;
     mask = NULL;
   }
+  if (kernel != NULL)
+  {
+    delete [] kernel ;
+    kernel = NULL;
+  }
 }
 
 
@@ -96,6 +96,12 @@ private:
   //int graph ;
   vpMatrix *mask ; //! Array of matrices defining the different masks (one for every angle step).
 
+private:
+  //! Copy of the masks as contiguous 16 bits integers. Each row of a
+  //! mask is padded with zeros up to kernel_stride values.
+  short *kernel ;
+  unsigned int kernel_stride ;
+
 public:
   vpMe() ;
   vpMe(const vpMe &me) ;
@@ -115,6 +121,27 @@ public:
   */
   inline vpMatrix* getMask() const { return mask; }
 
+  /*!
+    Get the mask corresponding to an angle step as 16 bits integers.
+    The mask values are stored row by row; each row contains
+    getKernelStride() values, the ones after getMaskSize() being null.
+
+    \param index_mask : Index of the mask in [0, getMaskNumber()[.
+
+    \return Pointer to the first value of the mask.
+
+    \sa getMask()
+  */
+  inline const short* getKernel(const unsigned int index_mask) const {
+    return kernel + index_mask * mask_size * kernel_stride;
+  }
+
+  /*!
+    Return the number of values in a row of the masks returned by
+    getKernel(). This is getMaskSize() rounded up to a multiple of 8.
+  */
+  inline unsigned int getKernelStride() const { return kernel_stride; }
+
   /*!
     Set the number of mask applied to determine the object contour. The number of mask determines the precision of
     the normal of the edge for every sample. If precision is 2deg, then there
@@ -481,7 +481,7 @@ vpMeEllipse::seekExtremities(const vpImage<unsigned char>  &I)
 
       if(!outOfImage(P.i, P.j, 5, rows, cols))
       {
-        P.track(I,me,false) ;
+        P.track(I,me,false,queries) ;
 
         if (P.getState() == vpMeSite::NO_SUPPRESSION)
         {
@@ -518,7 +518,7 @@ vpMeEllipse::seekExtremities(const vpImage<unsigned char>  &I)
 
       if(!outOfImage(P.i, P.j, 5, rows, cols))
       {
-        P.track(I,me,false) ;
+        P.track(I,me,false,queries) ;
 
         if (P.getState() == vpMeSite::NO_SUPPRESSION)
         {
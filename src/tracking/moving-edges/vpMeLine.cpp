@@ -631,7 +631,7 @@ vpMeLine::seekExtremities(const vpImage<unsigned char> &I)
 
     if(!outOfImage(P.i, P.j, 5, rows, cols))
     {
-      P.track(I,me,false) ;
+      P.track(I,me,false,queries) ;
 
       if (P.getState() == vpMeSite::NO_SUPPRESSION)
       {
@@ -662,7 +662,7 @@ vpMeLine::seekExtremities(const vpImage<unsigned char> &I)
 
     if(!outOfImage(P.i, P.j, 5, rows, cols))
     {
-      P.track(I,me,false) ;
+      P.track(I,me,false,queries) ;
 
       if (P.getState() == vpMeSite::NO_SUPPRESSION)
       {
@@ -492,7 +492,7 @@ vpMeNurbs::seekExtremities(const vpImage<unsigned char> &I)
       if (vpImagePoint::distance(end[0],pt) < threshold) break;
       if(!outOfImage(P.i, P.j, 5, rows, cols))
       {
-        P.track(I,me,false);
+        P.track(I,me,false,queries);
 
         if (P.getState() == vpMeSite::NO_SUPPRESSION)
         {
@@ -530,7 +530,7 @@ vpMeNurbs::seekExtremities(const vpImage<unsigned char> &I)
       if (vpImagePoint::distance(begin[0],pt) < threshold) break;
       if(!outOfImage(P.i, P.j, 5, rows, cols))
       {
-        P.track(I,me,false);
+        P.track(I,me,false,queries);
 
         if (P.getState() == vpMeSite::NO_SUPPRESSION)
         {
@@ -705,7 +705,7 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
       for (int j = 0; j < nbr; j++)
       {
         vpMeSite s = *itList2;
-        s.track(I,me,false);
+        s.track(I,me,false,queries);
         *itList2 = s;
         ++itList2;
       }
@@ -845,7 +845,7 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
       for (int j = 0; j < nbr; j++)
       {
         vpMeSite s = *itList2;
-        s.track(I,me,false);
+        s.track(I,me,false,queries);
         *itList2 = s;
         --itList2;
       }
@@ -965,7 +965,7 @@ vpMeNurbs::localReSample(const vpImage<unsigned char> &I)
             vpMeSite pix ; //= list.value();
             pix.init(iP[0].get_i(), iP[0].get_j(), delta) ;
             pix.setDisplay(selectDisplay) ;
-            pix.track(I,me,false);
+            pix.track(I,me,false,queries);
             if (pix.getState() == vpMeSite::NO_SUPPRESSION)
             {
               list.insert(it, pix);
@@ -56,6 +56,10 @@
 #include <limits>   // numeric_limits
 #include "vpMeSite.h"
 
+#ifdef VISP_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 static
@@ -300,61 +304,114 @@ vpMeSite::getSign(const vpImage<unsigned char> &I, const int range)
 double
 vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
 {
-  int half;
-  unsigned int index_mask ;
-  int height_ = static_cast<int>(I.getHeight());
-  int width_  = static_cast<int>(I.getWidth());
+  vpMeSiteQuery q;
+  q.i = i;
+  q.j = j;
+  convolution(I, me, alpha, mask_sign, &q, 1);
+  i = q.i;
+  j = q.j;
+  return q.convlt;
+}
 
-  double conv = 0.0 ;
+/*!
+  Compute in one call the convolution of the mask corresponding to the
+  angle \e alpha at the position of each candidate. The mask index is
+  computed once for all the candidates and the integer masks returned by
+  vpMe::getKernel() are used, so that the result is exactly the one of
+  a double precision convolution with vpMe::getMask().
+
+  If a candidate is too close to the image border, its convolution is
+  null and its position is set to (0, 0).
+
+  \param I : Image in which the convolutions are computed.
+  \param me : Moving edges parameters.
+  \param alpha : Angle of the normal to the contour.
+  \param mask_sign : Sign applied to the convolutions.
+  \param queries : Candidates. Their convolution is updated.
+  \param nquery : Number of candidates.
+*/
+void
+vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me,
+                      double alpha, int mask_sign,
+                      vpMeSiteQuery *queries, unsigned int nquery)
+{
+  unsigned int height_ = I.getHeight();
+  int width_  = static_cast<int>(I.getWidth());
   unsigned int msize = me->getMaskSize();
-  half = (static_cast<int>(msize) - 1) >> 1 ;
+  int half = (static_cast<int>(msize) - 1) >> 1 ;
+  int half_strip = half + me->getStrip();
+
+  // Calculate tangent angle from normal
+  double theta  = alpha+M_PI/2;
+  // Move tangent angle to within 0->M_PI for a positive
+  // mask index
+  while (theta<0) theta += M_PI;
+  while (theta>M_PI) theta -= M_PI;
 
-  if(horsImage( i , j , half + me->getStrip() , height_, width_))
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI) ;
+
+  if(abs(thetadeg) == 180 )
   {
-    conv = 0.0 ;
-    i = 0 ; j = 0 ;
+    thetadeg= 0 ;
   }
-  else
-  {
-    // Calculate tangent angle from normal
-    double theta  = alpha+M_PI/2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta<0) theta += M_PI;
-    while (theta>M_PI) theta -= M_PI;
 
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI) ;
+  unsigned int index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
+  const short *kernel = me->getKernel(index_mask);
+  unsigned int stride = me->getKernelStride();
 
-    if(abs(thetadeg) == 180 )
+  for (unsigned int n = 0 ; n < nquery ; n++)
+  {
+    vpMeSiteQuery &q = queries[n];
+    if(horsImage( q.i , q.j , half_strip , (int)height_, width_))
     {
-      thetadeg= 0 ;
+      q.convlt = 0.0 ;
+      q.i = 0 ; q.j = 0 ;
+      continue;
     }
 
-    index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
-
-    unsigned int i_ = static_cast<unsigned int>(i);
-    unsigned int j_ = static_cast<unsigned int>(j);
-    unsigned int half_ = static_cast<unsigned int>(half);
+    unsigned int ihalf = static_cast<unsigned int>(q.i - half) ;
+    unsigned int jhalf = static_cast<unsigned int>(q.j - half) ;
+    int conv = 0 ;
 
-    unsigned int ihalf = i_-half_ ;
-    unsigned int jhalf = j_-half_ ;
-    unsigned int ihalfa ;
-    
-    for(unsigned int a = 0 ; a < msize ; a++ )
+#ifdef VISP_HAVE_SSE2
+    // Each row of the mask is read by blocks of 8 pixels. The values read
+    // after the mask size are multiplied by 0 and stay in the image as
+    // long as the mask does not reach the last image row.
+    if (ihalf + msize < height_)
     {
-      ihalfa = ihalf+a ;
-      for(unsigned int b = 0 ; b < msize ; b++ )
+      const __m128i zero = _mm_setzero_si128();
+      __m128i acc = zero;
+      const short *k = kernel;
+      for(unsigned int a = 0 ; a < msize ; a++, k += stride )
       {
-        conv += mask_sign* me->getMask()[index_mask][a][b] *
-            //	  I(i-half+a,j-half+b) ;
-            I(ihalfa,jhalf+b) ;
+        const unsigned char *p = I[ihalf+a] + jhalf ;
+        for(unsigned int b = 0 ; b < stride ; b += 8 )
+        {
+          __m128i pix = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(p+b)), zero);
+          acc = _mm_add_epi32(acc, _mm_madd_epi16(pix, _mm_loadu_si128((const __m128i *)(k+b))));
+        }
+      }
+      acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+      acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+      conv = _mm_cvtsi128_si32(acc);
+    }
+    else
+#endif
+    {
+      const short *k = kernel;
+      for(unsigned int a = 0 ; a < msize ; a++, k += stride )
+      {
+        const unsigned char *p = I[ihalf+a] + jhalf ;
+        for(unsigned int b = 0 ; b < msize ; b++ )
+        {
+          conv += k[b] * p[b] ;
+        }
       }
     }
 
+    q.convlt = (double)(mask_sign * conv) ;
   }
-
-  return(conv) ;
 }
 
 
@@ -362,162 +419,86 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
 
   Specific function for ME.
 
+  Seek along the normal to the contour, in the range given by
+  vpMe::getRange(), the position where the convolution of the moving
+  edge mask is the most likely to correspond to the site.
+
   \warning To display the moving edges graphics a call to vpDisplay::flush()
   is needed.
 
+  \sa track(const vpImage<unsigned char>&, const vpMe *, const bool, std::vector<vpMeSiteQuery> &)
 */
 void
 vpMeSite::track(const vpImage<unsigned char>& I,
                 const vpMe *me,
                 const bool test_contraste)
 {
-  //   vpMeSite  *list_query_pixels ;
-  //   int  max_rank =0 ;
-  //   int max_rank1=0 ;
-  //   int max_rank2 = 0;
-  //   double  convolution = 0 ;
-  //   double  max_convolution = 0 ;
-  //   double max = 0 ;
-  //   double contraste = 0;
-  //   //  vpDisplay::display(I) ;
-  //   //  vpERROR_TRACE("getclcik %d",me->getRange()) ;
-  //   //  vpDisplay::getClick(I) ;
-  //
-  //   // range = +/- range of pixels within which the correspondent
-  //   // of the current pixel will be sought
-  //   int range  = me->getRange() ;
-  //
-  //   //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  //   list_query_pixels = getQueryList(I, range) ;
-  //
-  //   double  contraste_max = 1 + me->getMu2();
-  //   double  contraste_min = 1 - me->getMu1();
-  //
-  //   // array in which likelihood ratios will be stored
-  //   double  *likelihood= new double[ 2 * range + 1 ] ;
-  //
-  //   int ii_1 = i ;
-  //   int jj_1 = j ;
-  //   i_1 = i ;
-  //   j_1 = j ;
-  //   double threshold;
-  //   threshold = me->getThreshold();
-  //
-  //   //    std::cout <<"---------------------"<<std::endl ;
-  //   for(int n = 0 ; n < 2 * range + 1 ; n++)
-  //     {
-  //
-  //       //   convolution results
-  //       convolution = list_query_pixels[n].convolution(I, me) ;
-  //
-  //       // luminance ratio of reference pixel to potential correspondent pixel
-  //       // the luminance must be similar, hence the ratio value should
-  //       // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-  //       if( test_contraste )
-  // 	{
-  // 	  // Include this to eliminate temporal calculation
-  // 	  if (convlt==0)
-  // 	    {
-  // 	      std::cout << "vpMeSite::track : Division by zero  convlt = 0" << std::endl ;
-  // 	      delete []list_query_pixels ;
-  // 	      delete []likelihood;
-  // 	      throw(vpTrackingException(vpTrackingException::initializationError,
-  // 					"Division by zero")) ;
-  // 	    }
-  //
-  // // 	  contraste = fabs(convolution / convlt) ;
-  // 	  contraste = convolution / convlt ;
-  // 	  // likelihood ratios
-  // 	  if((contraste > contraste_min) && (contraste < contraste_max))
-  // 	    likelihood[n] = fabs(convolution + convlt ) ;
-  // 	  else
-  // 	    likelihood[n] = 0 ;
-  // 	}
-  //       else
-  // 	likelihood[n] = fabs(2*convolution) ;
-  //
-  //
-  //       // establishment of the maximal likelihood ratios's  rank
-  //       // in the array, the value of the likelihood ratio can now be
-  //     // referenced by its rank in the array
-  //     if (likelihood[n] > max)
-  //     {
-  //       max_convolution= convolution;
-  //       max = likelihood[n] ;
-  //       max_rank = n ;
-  //       max_rank2 = max_rank1;
-  //       max_rank1 = max_rank;
-  //     }
-  //
-  //   }
-  //
-  //   // test on the likelihood threshold if threshold==-1 then
-  //   // the me->threshold is  selected
-  //
-  //   vpImagePoint ip;
-  //
-  //   //  if (test_contrast)
-  //   if(max > threshold)
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::red);
-  // 	}
-  //
-  //       *this = list_query_pixels[max_rank] ;//The vpMeSite is replaced by the vpMeSite of max likelihood
-  //       normGradient =  vpMath::sqr(max_convolution);
-  //
-  //       convlt = max_convolution;
-  //       i_1 = ii_1; //list_query_pixels[max_rank].i ;
-  //       j_1 = jj_1; //list_query_pixels[max_rank].j ;
-  //       delete []list_query_pixels ;
-  //       delete []likelihood;
-  //     }
-  //   else //none of the query sites is better than the threshold
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::green);
-  // 	}
-  //       normGradient = 0 ;
-  //       if(max == 0)
-  // 	suppress = 1; // contrast suppression
-  //       else
-  // 	suppress = 2; // threshold suppression
-  //
-  //       delete []list_query_pixels ;
-  //       delete []likelihood; // modif portage
-  //     }
-
-  vpMeSite  *list_query_pixels ;
+  std::vector<vpMeSiteQuery> queries;
+  track(I, me, test_contraste, queries);
+}
+
+/*!
+
+  Specific function for ME. Same as track(const vpImage<unsigned char>&,
+  const vpMe *, const bool) except that the candidates sampled along the
+  normal are stored in \e queries. This buffer is only resized when it
+  is too small to contain the 2*range+1 candidates. Reusing the same
+  buffer for all the sites and all the images avoids any memory
+  allocation during the tracking.
+
+  \param I : Image in which the site is tracked.
+  \param me : Moving edges parameters.
+  \param test_contraste : If true, the contrast of the candidates is
+  compared to the one of the site.
+  \param queries : Scratch buffer used to store the candidates.
+
+  \warning To display the moving edges graphics a call to vpDisplay::flush()
+  is needed.
+*/
+void
+vpMeSite::track(const vpImage<unsigned char>& I,
+                const vpMe *me,
+                const bool test_contraste,
+                std::vector<vpMeSiteQuery> &queries)
+{
   int  max_rank =-1 ;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
-  double  convolution = 0 ;
   double  max_convolution = 0 ;
   double max = 0 ;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range  = me->getRange() ;
+  int range  = (int)me->getRange() ;
+  unsigned int nquery = 2 * (unsigned int)range + 1;
+  if (queries.size() < nquery)
+    queries.resize(nquery);
+
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
+  vpImagePoint ip;
+
+  // Sample the candidates along the normal
+  vpMeSiteQuery *q = &queries[0];
+  for(int k = -range ; k <= range ; k++, q++)
+  {
+    double ii = (ifloat+k*salpha);
+    double jj = (jfloat+k*calpha);
 
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  list_query_pixels = getQueryList(I, (int)range) ;
+    // Display
+    if    ((selectDisplay==RANGE_RESULT)||(selectDisplay==RANGE)) {
+      ip.set_i( ii );
+      ip.set_j( jj );
+      vpDisplay::displayCross(I, ip, 1, vpColor::yellow) ;
+    }
+
+    q->i = (int)ii;
+    q->j = (int)jj;
+  }
+  convolution(I, me, alpha, mask_sign, &queries[0], nquery);
 
   double  contraste_max = 1 + me->getMu2();
   double  contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double  *likelihood= new double[ 2 * range + 1 ] ;
-
   int ii_1 = i ;
   int jj_1 = j ;
   i_1 = i ;
@@ -526,77 +507,76 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   threshold = me->getThreshold() ;
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for(unsigned int n = 0 ; n < 2 * range + 1 ; n++)
+  for(unsigned int n = 0 ; n < nquery ; n++)
   {
     //   convolution results
-    convolution = list_query_pixels[n].convolution(I, me) ;
+    double convolution = queries[n].convlt ;
 
     // luminance ratio of reference pixel to potential correspondent pixel
     // the luminance must be similar, hence the ratio value should
     // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
     if( test_contraste )
     {
-      likelihood[n] = fabs(convolution + convlt );
-      if (likelihood[n]> threshold)
+      double likelihood = fabs(convolution + convlt );
+      if (likelihood > threshold)
       {
         contraste = convolution / convlt;
         if((contraste > contraste_min) && (contraste < contraste_max) && fabs(1-contraste) < diff)
         {
           diff = fabs(1-contraste);
           max_convolution= convolution;
-          max = likelihood[n] ;
+          max = likelihood ;
           max_rank = (int)n ;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
         }
       }
     }
 
     else
     {
-      likelihood[n] = fabs(2*convolution) ;
-      if (likelihood[n] > max  && likelihood[n] > threshold)
+      double likelihood = fabs(2*convolution) ;
+      if (likelihood > max  && likelihood > threshold)
       {
         max_convolution= convolution;
-        max = likelihood[n] ;
+        max = likelihood ;
         max_rank = (int)n ;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
       }
     }
   }
-  
+
   // test on the likelihood threshold if threshold==-1 then
   // the me->threshold is  selected
 
-  vpImagePoint ip;
-
-  //  if (test_contrast)
   if(max_rank >= 0)
   {
+    const vpMeSiteQuery &best = queries[(unsigned int)max_rank];
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[max_rank].i );
-      ip.set_j( list_query_pixels[max_rank].j );
+      ip.set_i( best.i );
+      ip.set_j( best.j );
       vpDisplay::displayPoint(I, ip, vpColor::red);
     }
-		
-    *this = list_query_pixels[max_rank] ;//The vpMeSite2 is replaced by the vpMeSite2 of max likelihood
+
+    // The site is replaced by the candidate of max likelihood
+    int k = max_rank - range;
+    ifloat = (ifloat+k*salpha);
+    jfloat = (jfloat+k*calpha);
+    i = best.i;
+    j = best.j;
+    v = 0;
+    weight = -1;
+    setState(NO_SUPPRESSION);
     normGradient =  vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
     i_1 = ii_1; //list_query_pixels[max_rank].i ;
     j_1 = jj_1; //list_query_pixels[max_rank].j ;
-    delete []list_query_pixels ;
-    delete []likelihood;
   }
   else //none of the query sites is better than the threshold
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[0].i );
-      ip.set_j( list_query_pixels[0].j );
+      ip.set_i( queries[0].i );
+      ip.set_j( queries[0].j );
       vpDisplay::displayPoint(I, ip, vpColor::green);
     }
     normGradient = 0 ;
@@ -605,9 +585,6 @@ vpMeSite::track(const vpImage<unsigned char>& I,
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete []list_query_pixels ;
-    delete []likelihood; // modif portage
   }
 }
 
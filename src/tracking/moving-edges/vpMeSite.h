@@ -56,6 +56,8 @@
 #include <visp/vpDisplay.h>
 #include <visp/vpMe.h>
 
+#include <vector>
+
 /*!
   \class vpMeSite
   \ingroup TrackingImageME
@@ -93,6 +95,18 @@ public:
     TOO_NEAR = 4,
     UNKNOW = 5
   } vpMeSiteState;
+
+  /*!
+    Candidate position sampled along the normal of a site during the
+    tracking. Unlike getQueryList() that builds a full vpMeSite for each
+    candidate, only the data needed to select the best candidate is kept.
+  */
+  typedef struct
+  {
+    int i;          //!< Row of the candidate (0 if too close to the border)
+    int j;          //!< Column of the candidate (0 if too close to the border)
+    double convlt;  //!< Convolution of the mask at the candidate position
+  } vpMeSiteQuery;
   
 public:
   int i,j ;
@@ -133,6 +147,10 @@ public:
   void track(const vpImage<unsigned char>& im,
 	     const vpMe *me,
 	     const  bool test_contraste=true);
+  void track(const vpImage<unsigned char>& im,
+	     const vpMe *me,
+	     const  bool test_contraste,
+	     std::vector<vpMeSiteQuery> &queries);
   
   /*!
     Set the angle of tangent at site
@@ -245,6 +263,11 @@ public:
     return(vpMath::sqr(S1.ifloat-S2.ifloat)+vpMath::sqr(S1.jfloat-S2.jfloat));}
     
   static void display(const vpImage<unsigned char>& I, const double &i, const double &j, const vpMeSiteState &state = NO_SUPPRESSION);
+
+private:
+  static void convolution(const vpImage<unsigned char>& I, const vpMe *me,
+                          double alpha, int mask_sign,
+                          vpMeSiteQuery *queries, unsigned int nquery);
   
 //Deprecated 
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
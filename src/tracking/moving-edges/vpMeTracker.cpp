@@ -178,7 +178,7 @@ vpMeTracker::initTracking(const vpImage<unsigned char>& I)
     if(refp.getState() == vpMeSite::NO_SUPPRESSION)
     {
       try {
-        refp.track(I,me,false);
+        refp.track(I,me,false,queries);
       }
       catch(...)
       {
@@ -256,7 +256,7 @@ vpMeTracker::track(const vpImage<unsigned char>& I)
       try{
         //	vpERROR_TRACE("%d",d ) ;
         //	vpERROR_TRACE("range %d",me->range) ;
-        s.track(I,me,true);
+        s.track(I,me,true,queries);
       }
       catch(vpTrackingException)
       {
@@ -67,6 +67,7 @@
 #include <math.h>
 #include <iostream>
 #include <list>
+#include <vector>
 
 class VISP_EXPORT vpMeTracker : public vpTracker
 {
@@ -85,6 +86,9 @@ protected:
   
 protected:
   vpMeSite::vpMeSiteDisplayType selectDisplay ;
+  //! Scratch buffer reused by all the sites to store the candidates
+  //! sampled along their normal (see vpMeSite::track()).
+  std::vector<vpMeSite::vpMeSiteQuery> queries;
 
 public:
   // Constructor/Destructor
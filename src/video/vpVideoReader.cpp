@@ -65,6 +65,7 @@ vpVideoReader::vpVideoReader()
   firstFrame = 0;
   frameCount = 0;
   lastFrame = 0;
+  prefetchDepth = 0;
 }
 
 
@@ -111,6 +112,23 @@ void vpVideoReader::setFileName(const char *filename)
 }
 
 
+/*!
+  Set the number of images of a sequence decoded in advance by a
+  background thread, while the current image is processed. See
+  vpDiskGrabber::setPrefetch(). This setting has no effect on video
+  files.
+
+  \param depth : Number of prefetched images. 0, the default, disables
+  the prefetch.
+*/
+void vpVideoReader::setPrefetch(unsigned int depth)
+{
+  prefetchDepth = depth;
+  if (imSequence != NULL)
+    imSequence->setPrefetch(depth);
+}
+
+
 /*!
   Sets all the parameters needed to read the video or the image sequence.
   
@@ -134,6 +152,7 @@ void vpVideoReader::open(vpImage< vpRGBa > &I)
     imSequence = new vpDiskGrabber;
     imSequence->setGenericName(fileName);
     imSequence->setImageNumber((int)firstFrame);
+    imSequence->setPrefetch(prefetchDepth);
   }
   #ifdef VISP_HAVE_FFMPEG
   else if (formatType == FORMAT_AVI ||
@@ -201,6 +220,7 @@ void vpVideoReader::open(vpImage<unsigned char> &I)
     imSequence = new vpDiskGrabber;
     imSequence->setGenericName(fileName);
     imSequence->setImageNumber((int)firstFrame);
+    imSequence->setPrefetch(prefetchDepth);
   }
   #ifdef VISP_HAVE_FFMPEG
   else if (formatType == FORMAT_AVI ||
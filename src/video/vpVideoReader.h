@@ -156,6 +156,8 @@ class VISP_EXPORT vpVideoReader : public vpFrameGrabber
     long firstFrame;
     //!The last frame index
     long lastFrame;
+    //!Number of images of a sequence read in advance
+    unsigned int prefetchDepth;
 
   public:
     vpVideoReader();
@@ -186,6 +188,13 @@ class VISP_EXPORT vpVideoReader : public vpFrameGrabber
     inline long getLastFrameIndex() const {return lastFrame;}
     
     void setFileName(const char *filename);
+    void setPrefetch(unsigned int depth);
+    /*!
+      Return the number of images of a sequence read in advance.
+
+      \sa setPrefetch()
+    */
+    inline unsigned int getPrefetch() const {return prefetchDepth;}
     void open (vpImage< vpRGBa > &I);
     void open (vpImage< unsigned char > &I);
     void acquire(vpImage< vpRGBa > &I);
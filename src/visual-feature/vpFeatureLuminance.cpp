@@ -58,12 +58,9 @@ vpFeatureLuminance::init(unsigned int _nbr, unsigned int _nbc, double _Z)
   dim_s = (nbr-2*bord)*(nbc-2*bord) ;
 
   s.resize(dim_s) ;
-  
-  if (pixInfo != NULL)
-    delete [] pixInfo;
+  pixX.resize(dim_s) ;
+  pixY.resize(dim_s) ;
 
-  pixInfo = new vpLuminance[dim_s] ;
-  
   Z = _Z ;
 }
 
@@ -76,7 +73,7 @@ vpFeatureLuminance::vpFeatureLuminance() : vpBasicFeature()
     dim_s = 0 ;
     bord = 10 ;
     flags = NULL;
-    pixInfo = NULL;
+    nthreads = 1 ;
 
     init() ;
 }
@@ -86,7 +83,6 @@ vpFeatureLuminance::vpFeatureLuminance() : vpBasicFeature()
 */
 vpFeatureLuminance::~vpFeatureLuminance() 
 {
-  if (pixInfo != NULL) delete [] pixInfo ;
   if (flags != NULL) delete [] flags;
 }
 
@@ -123,21 +119,35 @@ vpFeatureLuminance::setCameraParameters(vpCameraParameters &_cam)
   cam = _cam ;
 }
 
+/*!
+  Set the number of threads used by interaction() and buildFrom() to
+  process the rows of the feature. This setting is only effective when
+  ViSP is built with OpenMP. The threads used to compute the image
+  gradient are set by vpImageFilter::setNumberOfThreads().
+
+  \param n : Number of threads. 0 is considered as 1.
+*/
+void
+vpFeatureLuminance::setNumberOfThreads(const unsigned int n)
+{
+  nthreads = (n == 0) ? 1 : n ;
+}
+
 
 /*!
 
   Build a luminance feature directly from the image
+
+  The gradient of the whole image is computed by two separable passes
+  of vpImageFilter::getGradX() and vpImageFilter::getGradY(), which
+  give the values of vpImageFilter::derivativeFilterX() and
+  vpImageFilter::derivativeFilterY().
 */
 
 void
 vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 {
   unsigned int l = 0;
-  double Ix,Iy ;
-
-  double px = cam.get_px() ;
-  double py = cam.get_py() ;
-
 
   if (firstTimeIn==0)
     { 
@@ -145,44 +155,36 @@ vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
       l =0 ;
       for (unsigned int i=bord; i < nbr-bord ; i++)
 	{
-	  //   cout << i << endl ;
 	  for (unsigned int j = bord ; j < nbc-bord; j++)
 	    {	double x=0,y=0;
 	      vpPixelMeterConversion::convertPoint(cam,
 						   i, j,
 						   y, x)  ;
 	    
-	      pixInfo[l].x = x;
-	      pixInfo[l].y = y;
-
-	      pixInfo[l].Z   = Z ;
+	      pixX[l] = x;
+	      pixY[l] = y;
 
 	      l++;
 	    }
 	}
     }
 
-  l= 0 ;
-  for (unsigned int i=bord; i < nbr-bord ; i++)
+  vpImageFilter::getGradX(I, imIx) ;
+  vpImageFilter::getGradY(I, imIy) ;
+
+  unsigned int ncols = nbc - 2*bord ;
+  int nrows = (int)(nbr - 2*bord) ;
+#ifdef VISP_HAVE_OPENMP
+  int n = (int)nthreads ;
+  #pragma omp parallel for num_threads(n) if(n > 1)
+#endif
+  for (int r = 0; r < nrows ; r++)
     {
-      //   cout << i << endl ;
-      for (unsigned int j = bord ; j < nbc-bord; j++)
-	{
-	  // cout << dim_s <<" " <<l <<"  " <<i << "  " << j <<endl ;
-          Ix =  px * vpImageFilter::derivativeFilterX(I,i,j) ;
-	  Iy =  py * vpImageFilter::derivativeFilterY(I,i,j) ;
-	  
-	  // Calcul de Z
-	  
-	  pixInfo[l].I  =  I[i][j] ;
-	  s[l]  =  I[i][j] ;
-	  pixInfo[l].Ix  = Ix;
-	  pixInfo[l].Iy  = Iy;
-	  
-	  l++;
-	}
+      const unsigned char *src = I[(unsigned int)r + bord] + bord ;
+      double *dst = s.data + (unsigned int)r * ncols ;
+      for (unsigned int c = 0 ; c < ncols ; c++)
+	dst[c] = src[c] ;
     }
-
 }
 
 
@@ -192,31 +194,55 @@ vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 
   Compute and return the interaction matrix \f$ L_I \f$. The computation is made
   thanks to the values of the luminance features \f$ I \f$
+
+  The rows of \f$ L_I \f$ are filled in the order of the pixels, from the
+  gradient and coordinates arrays, by several threads when ViSP is built
+  with OpenMP (see setNumberOfThreads()).
+
+  \exception vpException::notInitialized : If buildFrom() was not called.
 */
 void
 vpFeatureLuminance::interaction(vpMatrix &L)
 {
-  double x,y,Ix,Iy,Zinv;
+  if ((imIx.getHeight() < nbr) || (imIx.getWidth() < nbc)) {
+    vpERROR_TRACE("buildFrom() has to be called before interaction()") ;
+    throw vpException(vpException::notInitialized, "buildFrom() has to be called before interaction().");
+  }
 
   L.resize(dim_s,6) ;
 
-  for(unsigned int m = 0; m< L.getRows(); m++)
+  double px = cam.get_px() ;
+  double py = cam.get_py() ;
+  double Zinv = 1 / Z ;
+
+  unsigned int ncols = nbc - 2*bord ;
+  int nrows = (int)(nbr - 2*bord) ;
+#ifdef VISP_HAVE_OPENMP
+  int n = (int)nthreads ;
+  #pragma omp parallel for num_threads(n) if(n > 1)
+#endif
+  for (int r = 0 ; r < nrows ; r++)
     {
-      Ix = pixInfo[m].Ix;
-      Iy = pixInfo[m].Iy;
-
-      x = pixInfo[m].x ;
-      y = pixInfo[m].y ;
-      Zinv =  1 / pixInfo[m].Z;
-
-      {
-	L[m][0] = Ix * Zinv;
-	L[m][1] = Iy * Zinv;
-	L[m][2] = -(x*Ix+y*Iy)*Zinv;
-	L[m][3] = -Ix*x*y-(1+y*y)*Iy;
-	L[m][4] = (1+x*x)*Ix + Iy*x*y;
-	L[m][5]  = Iy*x-Ix*y;
-      }
+      const float *gx = imIx[(unsigned int)r + bord] + bord ;
+      const float *gy = imIy[(unsigned int)r + bord] + bord ;
+      unsigned int m = (unsigned int)r * ncols ;
+      const double *xr = &pixX[m] ;
+      const double *yr = &pixY[m] ;
+      for (unsigned int c = 0 ; c < ncols ; c++, m++)
+	{
+	  double Ix = px * gx[c] ;
+	  double Iy = py * gy[c] ;
+	  double x = xr[c] ;
+	  double y = yr[c] ;
+
+	  double *Lm = L[m] ;
+	  Lm[0] = Ix * Zinv;
+	  Lm[1] = Iy * Zinv;
+	  Lm[2] = -(x*Ix+y*Iy)*Zinv;
+	  Lm[3] = -Ix*x*y-(1+y*y)*Iy;
+	  Lm[4] = (1+x*x)*Ix + Iy*x*y;
+	  Lm[5]  = Iy*x-Ix*y;
+	}
     }
 }
 
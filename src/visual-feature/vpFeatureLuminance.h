@@ -46,6 +46,8 @@
 #include <visp/vpBasicFeature.h>
 #include <visp/vpImage.h>
 
+#include <vector>
+
 
 /*!
   \file vpFeatureLuminance.h
@@ -87,6 +89,14 @@ class VISP_EXPORT vpLuminance
   servoing set free from image processing. In IEEE Int. Conf. on
   Robotics and Automation, ICRA'08, Pages 81-86, Pasadena, Californie,
   Mai 2008.
+
+  buildFrom() computes the gradient of the whole image with two
+  separable passes of vpImageFilter (see vpImageFilter::getGradX()),
+  whose number of threads is set by vpImageFilter::setNumberOfThreads().
+  The gradient and the coordinates of the pixels are stored in separate
+  arrays, from which interaction() fills the rows of the interaction
+  matrix in parallel when ViSP is built with OpenMP (see
+  setNumberOfThreads()).
 */
 
 class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
@@ -103,9 +113,16 @@ class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
   //! Border size.
   unsigned int bord ;
   
-  //! Store the image (as a vector with intensity and gradient I, Ix, Iy) 
-  vpLuminance *pixInfo ;
+  //! Gradient of the image along the columns (derivativeFilterX())
+  vpImage<float> imIx ;
+  //! Gradient of the image along the rows (derivativeFilterY())
+  vpImage<float> imIy ;
+  //! Coordinates in meter of the pixels of the feature, row by row
+  std::vector<double> pixX ;
+  std::vector<double> pixY ;
   int  firstTimeIn  ;
+  //! Number of threads used to build the interaction matrix
+  unsigned int nthreads ;
 
  public:
   void buildFrom(vpImage<unsigned char> &I) ;
@@ -131,6 +148,12 @@ public:
   void set_Z(const double Z) ;
   double get_Z() const  ;
 
+  void setNumberOfThreads(const unsigned int n) ;
+  /*!
+    \return The number of threads used to build the interaction matrix.
+  */
+  inline unsigned int getNumberOfThreads() const { return nthreads; }
+
 
   /*
     vpBasicFeature method instantiation
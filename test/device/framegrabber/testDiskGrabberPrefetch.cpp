@@ -0,0 +1,260 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the prefetch of vpDiskGrabber and vpVideoReader.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDiskGrabberPrefetch.cpp
+
+  Writes a sequence of images and reads it back with vpDiskGrabber and
+  vpVideoReader, with and without prefetch, checking the step, the
+  random access and the end of the sequence.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpDiskGrabber.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageException.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpTime.h>
+#include <visp/vpVideoReader.h>
+
+#include <iostream>
+#include <stdio.h>
+#include <string>
+
+namespace {
+  const long nbImages = 30;
+
+  bool check(const vpImage<unsigned char> &I, long number)
+  {
+    return (I.getHeight() == 120) && (I.getWidth() == 160)
+      && (I[0][0] == (unsigned char)number) && (I[119][159] == (unsigned char)(2 * number));
+  }
+
+  bool check(const vpImage<vpRGBa> &I, long number)
+  {
+    return (I.getHeight() == 120) && (I.getWidth() == 160)
+      && (I[0][0].R == (unsigned char)number) && (I[119][159].G == (unsigned char)(2 * number));
+  }
+
+  template<class Type>
+  bool acquireFails(vpDiskGrabber &g, vpImage<Type> &I)
+  {
+    try {
+      g.acquire(I);
+    }
+    catch(vpImageException &) {
+      return true;
+    }
+    return false;
+  }
+
+  bool testGrabber(const std::string &dir, unsigned int depth)
+  {
+    vpDiskGrabber g(dir.c_str(), "I", 0, 1, 4, "pgm");
+    g.setPrefetch(depth);
+    vpImage<unsigned char> I;
+    vpImage<vpRGBa> C;
+
+    // Sequential reading up to the end of the sequence
+    g.open(I);
+    for (long k = 0; k < nbImages; k++) {
+      g.acquire(I);
+      if (! check(I, k)) {
+        std::cout << "Bad image " << k << std::endl;
+        return false;
+      }
+    }
+    if (! acquireFails(g, I) || ! acquireFails(g, I)) {
+      std::cout << "No error at the end of the sequence" << std::endl;
+      return false;
+    }
+
+    // Step and color images
+    g.setImageNumber(1);
+    g.setStep(4);
+    for (long k = 1; k < nbImages; k += 4) {
+      g.acquire(C);
+      if (! check(C, k)) {
+        std::cout << "Bad color image " << k << " with a step" << std::endl;
+        return false;
+      }
+    }
+    if (! acquireFails(g, C)) {
+      std::cout << "No error at the end of the sequence with a step" << std::endl;
+      return false;
+    }
+
+    // Random access, then sequential reading from the current number
+    g.setStep(1);
+    g.setImageNumber(10);
+    g.acquire(I);
+    g.acquire(I, 25);
+    if (! check(I, 25)) {
+      std::cout << "Bad random access" << std::endl;
+      return false;
+    }
+    g.acquire(I);
+    if (! check(I, 11) || (g.getImageNumber() != 12)) {
+      std::cout << "Bad image after a random access" << std::endl;
+      return false;
+    }
+    g.acquire(I, 3);
+    g.acquire(I, 4);
+    if (! check(I, 4)) {
+      std::cout << "Bad consecutive random access" << std::endl;
+      return false;
+    }
+
+    // Restart after the end of the sequence
+    g.setImageNumber(nbImages - 1);
+    g.acquire(I);
+    if (! check(I, nbImages - 1) || ! acquireFails(g, I)) {
+      std::cout << "Bad end of the sequence" << std::endl;
+      return false;
+    }
+    g.setImageNumber(0);
+    g.acquire(I);
+    if (! check(I, 0)) {
+      std::cout << "Bad image after the end of the sequence" << std::endl;
+      return false;
+    }
+    g.close();
+    g.acquire(I);
+    if (! check(I, 1)) {
+      std::cout << "Bad image after close()" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Reading time of the sequence with some processing of each image
+  double timeSequence(const std::string &dir, unsigned int depth)
+  {
+    vpDiskGrabber g(dir.c_str(), "I", 0, 1, 4, "pgm");
+    g.setPrefetch(depth);
+    vpImage<unsigned char> I;
+    double t = vpTime::measureTimeMs();
+    unsigned int sum = 0;
+    for (long k = 0; k < nbImages; k++) {
+      g.acquire(I);
+      for (int n = 0; n < 20; n++)
+        for (unsigned int i = 0; i < I.getHeight(); i++)
+          for (unsigned int j = 0; j < I.getWidth(); j++)
+            sum += I[i][j];
+    }
+    t = vpTime::measureTimeMs() - t;
+    if (sum == 1)
+      std::cout << std::endl;
+    return t;
+  }
+}
+
+int main()
+{
+  try {
+#ifdef WIN32
+    std::string dir = "C:\\temp";
+#else
+    std::string dir = "/tmp";
+#endif
+    dir += vpIoTools::path("/") + "testDiskGrabberPrefetch";
+    if (vpIoTools::checkDirectory(dir) == false)
+      vpIoTools::makeDirectory(dir);
+
+    vpImage<unsigned char> I(120, 160);
+    char name[FILENAME_MAX];
+    for (long k = 0; k < nbImages; k++) {
+      for (unsigned int i = 0; i < I.getHeight(); i++)
+        for (unsigned int j = 0; j < I.getWidth(); j++)
+          I[i][j] = (unsigned char)(k * (1 + (i + j) / (I.getHeight() + I.getWidth() - 2)));
+      sprintf(name, "%s/I%04ld.pgm", dir.c_str(), k);
+      vpImageIo::writePGM(I, name);
+    }
+    sprintf(name, "%s/I%04ld.pgm", dir.c_str(), nbImages);
+    remove(name);
+
+    unsigned int depths[3] = { 0, 1, 4 };
+    for (int d = 0; d < 3; d++) {
+      if (! testGrabber(dir, depths[d])) {
+        std::cout << "Failure with a prefetch depth of " << depths[d] << std::endl;
+        return -1;
+      }
+    }
+
+    // Image sequence read by vpVideoReader
+    vpVideoReader reader;
+    reader.setPrefetch(3);
+    reader.setFileName((dir + "/I%04d.pgm").c_str());
+    reader.open(I);
+    for (long k = 0; k < 10; k++) {
+      reader.acquire(I);
+      if (! check(I, k)) {
+        std::cout << "Bad image " << k << " read by vpVideoReader" << std::endl;
+        return -1;
+      }
+    }
+    if (! reader.getFrame(I, 20) || ! check(I, 20) || reader.getFrame(I, nbImages)) {
+      std::cout << "Bad vpVideoReader::getFrame()" << std::endl;
+      return -1;
+    }
+
+    double t0 = timeSequence(dir, 0);
+    double t4 = timeSequence(dir, 4);
+    std::cout << nbImages << " images: " << t0 << " ms without prefetch, "
+              << t4 << " ms with a prefetch depth of 4" << std::endl;
+
+    for (long k = 0; k < nbImages; k++) {
+      sprintf(name, "%s/I%04ld.pgm", dir.c_str(), k);
+      remove(name);
+    }
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+
+  std::cout << "testDiskGrabberPrefetch is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
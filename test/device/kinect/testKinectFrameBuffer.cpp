@@ -0,0 +1,248 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the lock-free frame handoff of vpKinectFrameBuffer with a synthetic
+ * frame source.
+ *
+ *****************************************************************************/
+
+
+/*!
+  \example testKinectFrameBuffer.cpp
+
+  Feeds vpKinectFrameBuffer with synthetic color images and depth maps
+  from a producer thread, as the libfreenect callbacks do, and checks
+  that the frames read by the main thread are complete and in order.
+  Also checks the raw depth conversion table and compares its speed
+  with the per pixel conversion.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpKinectFrameBuffer.h>
+#include <visp/vpTime.h>
+
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+#if defined(VISP_HAVE_PTHREAD)
+
+#include <pthread.h>
+
+namespace {
+  const unsigned int height = 480;
+  const unsigned int width = 640;
+  const unsigned long nbFrames = 300;
+
+  // The pixels of the frame k are all set from k
+  void fillRGB(std::vector<unsigned char> &rgb, unsigned long k)
+  {
+    for (unsigned int i = 0; i < height * width; i++) {
+      rgb[3 * i] = (unsigned char)k;
+      rgb[3 * i + 1] = (unsigned char)(k >> 8);
+      rgb[3 * i + 2] = (unsigned char)(7 * k);
+    }
+  }
+
+  unsigned short rawDepth(unsigned long k)
+  {
+    return (unsigned short)(k % 1024);
+  }
+
+  void *producer(void *arg)
+  {
+    vpKinectFrameBuffer *frames = (vpKinectFrameBuffer *)arg;
+    std::vector<unsigned char> rgb(3 * height * width);
+    std::vector<unsigned short> depth(height * width);
+    for (unsigned long k = 1; k <= nbFrames; k++) {
+      fillRGB(rgb, k);
+      for (unsigned int i = 0; i < height * width; i++)
+        depth[i] = rawDepth(k);
+      frames->pushRGB(&rgb[0]);
+      frames->pushDepth(&depth[0]);
+    }
+    return NULL;
+  }
+
+  // Return the number of the frame, or 0 if it is torn
+  unsigned long frameNumber(const vpImage<vpRGBa> &I)
+  {
+    vpRGBa p = I[0][0];
+    unsigned long k = p.R + ((unsigned long)p.G << 8);
+    if (p.B != (unsigned char)(7 * k))
+      return 0;
+    for (unsigned int i = 0; i < height * width; i++) {
+      if ((I.bitmap[i].R != p.R) || (I.bitmap[i].G != p.G) || (I.bitmap[i].B != p.B))
+        return 0;
+    }
+    return k;
+  }
+
+  bool isUniform(const vpImage<float> &map)
+  {
+    for (unsigned int i = 0; i < height * width; i++) {
+      if (map.bitmap[i] != map.bitmap[0])
+        return false;
+    }
+    return true;
+  }
+
+  bool testHandoff()
+  {
+    vpKinectFrameBuffer frames(height, width);
+    vpImage<vpRGBa> I;
+    vpImage<float> map;
+
+    if (frames.getRGB(I) || frames.getDepthMap(map)) {
+      std::cout << "Frame read before any frame was published" << std::endl;
+      return false;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, producer, &frames) != 0) {
+      std::cout << "Cannot create the producer thread" << std::endl;
+      return false;
+    }
+
+    unsigned long last = 0;
+    unsigned long nbRead = 0;
+    bool ok = true;
+    while (ok && (last < nbFrames)) {
+      if (frames.getRGB(I)) {
+        unsigned long k = frameNumber(I);
+        if ((k == 0) || (k <= last)) {
+          std::cout << "Torn or out of order color image " << k
+                    << " after " << last << std::endl;
+          ok = false;
+        }
+        last = k;
+        nbRead++;
+      }
+      if (frames.getDepthMap(map) && ! isUniform(map)) {
+        std::cout << "Torn depth map" << std::endl;
+        ok = false;
+      }
+    }
+    pthread_join(thread, NULL);
+    if (! ok)
+      return false;
+
+    // The last depth map is always available after the producer ended
+    frames.getDepthMap(map);
+    if (! isUniform(map)
+        || (map[0][0] != vpKinectFrameBuffer::rawToMeter(rawDepth(nbFrames)))) {
+      std::cout << "Bad last depth map" << std::endl;
+      return false;
+    }
+    if (frames.getRGB(I) || frames.getDepthMap(map)) {
+      std::cout << "Same frame read twice" << std::endl;
+      return false;
+    }
+    if ((frames.getNbRGBFrames() != nbFrames) || (frames.getNbDepthFrames() != nbFrames)
+        || (nbRead + frames.getNbDroppedRGBFrames() != nbFrames)) {
+      std::cout << "Bad frame counters: " << frames.getNbRGBFrames() << " published, "
+                << nbRead << " read, " << frames.getNbDroppedRGBFrames()
+                << " dropped" << std::endl;
+      return false;
+    }
+    std::cout << nbRead << " color images read, "
+              << frames.getNbDroppedRGBFrames() << " dropped" << std::endl;
+    return true;
+  }
+
+  bool testConversion()
+  {
+    vpKinectFrameBuffer frames(height, width);
+    std::vector<unsigned short> depth(height * width);
+    for (unsigned int i = 0; i < height * width; i++)
+      depth[i] = (unsigned short)(i % 2100);
+
+    vpImage<float> map;
+    frames.pushDepth(&depth[0]);
+    frames.getDepthMap(map);
+    for (unsigned int i = 0; i < height * width; i++) {
+      float expected = (depth[i] > 1023) ? -1.f
+        : 0.1236f * (float)tan(depth[i] / 2842.5f + 1.1863f);
+      if (fabs(map.bitmap[i] - expected) > 1e-6) {
+        std::cout << "Bad depth " << map.bitmap[i] << " for raw value "
+                  << depth[i] << " instead of " << expected << std::endl;
+        return false;
+      }
+    }
+
+    // Speed of the table compared with the per pixel conversion
+    const unsigned int nbIter = 20;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIter; n++) {
+      for (unsigned int i = 0; i < height * width; i++) {
+        map.bitmap[i] = 0.1236f * (float)tan(depth[i] / 2842.5f + 1.1863f);
+        if (depth[i] > 1023)
+          map.bitmap[i] = -1;
+      }
+    }
+    double tTan = (vpTime::measureTimeMs() - t) / nbIter;
+    t = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIter; n++)
+      frames.pushDepth(&depth[0]);
+    double tTable = (vpTime::measureTimeMs() - t) / nbIter;
+    std::cout << "Depth conversion: " << tTan << " ms with tan per pixel, "
+              << tTable << " ms with the table" << std::endl;
+    return true;
+  }
+}
+
+int main()
+{
+  if (! testConversion())
+    return -1;
+  if (! testHandoff())
+    return -1;
+  std::cout << "vpKinectFrameBuffer is ok" << std::endl;
+  return 0;
+}
+
+#else
+int main()
+{
+  std::cout << "This test requires pthread" << std::endl;
+  return 0;
+}
+#endif
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,283 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the streaming decoder of the Sick LD-MRS messages and the replay of
+ * a raw capture.
+ *
+ *****************************************************************************/
+
+
+/*!
+  \example testSickLDMRSDecoder.cpp
+
+  Builds a synthetic stream of Sick LD-MRS messages, with corrupted
+  bytes and messages that are not measures, and decodes it by pieces
+  of various sizes with vpSickLDMRSDecoder. Then replays it from a raw
+  capture file with vpSickLDMRS.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpLaserScan.h>
+#include <visp/vpMath.h>
+#include <visp/vpSickLDMRS.h>
+#include <visp/vpSickLDMRSDecoder.h>
+
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+  // Magic word and message type of the measures, see vpSickLDMRS, which
+  // is only available on UNIX
+  const unsigned int magicWord = 0xAFFEC0C2;
+  const unsigned short measuredData = 0x2202;
+
+  const unsigned short numSteps = 11520;
+  const unsigned int nbMeasures = 6;
+
+  void putBigEndian32(std::vector<unsigned char> &v, unsigned int value)
+  {
+    v.push_back((unsigned char)(value >> 24));
+    v.push_back((unsigned char)(value >> 16));
+    v.push_back((unsigned char)(value >> 8));
+    v.push_back((unsigned char)value);
+  }
+
+  void put16(std::vector<unsigned char> &v, unsigned int offset, unsigned short value)
+  {
+    v[offset] = (unsigned char)value;
+    v[offset + 1] = (unsigned char)(value >> 8);
+  }
+
+  void put32(std::vector<unsigned char> &v, unsigned int offset, unsigned int value)
+  {
+    put16(v, offset, (unsigned short)value);
+    put16(v, offset + 2, (unsigned short)(value >> 16));
+  }
+
+  void addMessage(std::vector<unsigned char> &stream, unsigned short type,
+                  const std::vector<unsigned char> &body, unsigned int length)
+  {
+    putBigEndian32(stream, magicWord);
+    putBigEndian32(stream, 0);
+    putBigEndian32(stream, length);
+    stream.push_back(0);
+    stream.push_back(7);
+    stream.push_back((unsigned char)(type >> 8));
+    stream.push_back((unsigned char)type);
+    putBigEndian32(stream, 0);
+    putBigEndian32(stream, 0);
+    stream.insert(stream.end(), body.begin(), body.end());
+  }
+
+  unsigned int nbPointsOf(unsigned int id) { return 200 + 300 * id; }
+  unsigned int layerOf(unsigned int i) { return i % 4; }
+  bool isFirstEcho(unsigned int i) { return (i % 5) != 4; }
+  short hAngleOf(unsigned int i) { return (short)(1000 - (int)i); }
+  unsigned short distanceOf(unsigned int id, unsigned int i) { return (unsigned short)(100 + i + id); }
+
+  void addMeasure(std::vector<unsigned char> &stream, unsigned int id)
+  {
+    unsigned int nbPoints = nbPointsOf(id);
+    std::vector<unsigned char> body(44 + 10 * nbPoints, 0);
+    put16(body, 0, (unsigned short)id);
+    put32(body, 6, 0x80000000u);  // start: id + 0.5 s
+    put32(body, 10, id);
+    put32(body, 14, 0x40000000u); // end: id + 1.25 s
+    put32(body, 18, id + 1);
+    put16(body, 22, numSteps);
+    put16(body, 24, (unsigned short)1000);
+    put16(body, 26, (unsigned short)(-1000));
+    put16(body, 28, (unsigned short)nbPoints);
+    for (unsigned int i = 0; i < nbPoints; i++) {
+      unsigned int o = 44 + 10 * i;
+      body[o] = (unsigned char)(layerOf(i) | (isFirstEcho(i) ? 0 : 0x10));
+      put16(body, o + 2, (unsigned short)hAngleOf(i));
+      put16(body, o + 4, distanceOf(id, i));
+    }
+    addMessage(stream, measuredData, body, (unsigned int)body.size());
+  }
+
+  // Stream with dropped bytes and skipped messages between the measures
+  unsigned int buildStream(std::vector<unsigned char> &stream)
+  {
+    unsigned int nbDropped = 0;
+    for (unsigned int id = 0; id < nbMeasures; id++) {
+      if (id == 1) {
+        for (unsigned int i = 0; i < 7; i++)
+          stream.push_back((unsigned char)(0xAF + i));
+        nbDropped += 7;
+      }
+      if (id == 3) { // Header of a message larger than the ring buffer
+        addMessage(stream, measuredData, std::vector<unsigned char>(), 1u << 30);
+        nbDropped += vpSickLDMRSDecoder::HEADER_SIZE;
+      }
+      if (id == 2) // Not a measure
+        addMessage(stream, 0x2030, std::vector<unsigned char>(50, 3), 50);
+      addMeasure(stream, id);
+    }
+    return nbDropped;
+  }
+
+  bool check(const vpSickLDMRSDecoder &decoder, unsigned int id)
+  {
+    if ((decoder.getMeasurementId() != id) || (decoder.getNumPoints() != nbPointsOf(id))
+        || (decoder.getNumSteps() != numSteps) || (decoder.getStartAngle() != 1000)
+        || (decoder.getStopAngle() != -1000)
+        || (decoder.getStartTimestamp() != id + 0.5)
+        || (decoder.getEndTimestamp() != id + 1.25)) {
+      std::cout << "Bad header of measure " << id << std::endl;
+      return false;
+    }
+    std::vector<unsigned int> n(4, 0);
+    for (unsigned int i = 0; i < nbPointsOf(id); i++) {
+      if (! isFirstEcho(i))
+        continue;
+      unsigned int layer = layerOf(i);
+      unsigned int k = n[layer]++;
+      if ((k >= decoder.getNbPoints(layer))
+          || (fabs(decoder.getRadialDistances(layer)[k] - 0.01 * distanceOf(id, i)) > 1e-12)
+          || (fabs(decoder.getHorizontalAngles(layer)[k] - 2. * M_PI / numSteps * hAngleOf(i)) > 1e-12)) {
+        std::cout << "Bad point " << i << " of measure " << id << std::endl;
+        return false;
+      }
+    }
+    for (unsigned int layer = 0; layer < 4; layer++) {
+      if (decoder.getNbPoints(layer) != n[layer]) {
+        std::cout << "Bad number of points in layer " << layer << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool testDecoder(const std::vector<unsigned char> &stream, unsigned int nbDropped,
+                   unsigned int chunk)
+  {
+    // The ring buffer wraps several times
+    vpSickLDMRSDecoder decoder(32768);
+    unsigned int pos = 0;
+    unsigned int id = 0;
+    while (pos < stream.size()) {
+      unsigned int n = chunk;
+      if (n > stream.size() - pos)
+        n = (unsigned int)stream.size() - pos;
+      pos += decoder.push(&stream[pos], n);
+      while (decoder.decode()) {
+        if (! check(decoder, id))
+          return false;
+        id++;
+      }
+    }
+    if ((id != nbMeasures) || (decoder.getNbMeasures() != nbMeasures)
+        || (decoder.getNbSkippedMessages() != 1) || (decoder.getNbDroppedBytes() != nbDropped)
+        || (decoder.getSize() != 0)) {
+      std::cout << "Bad decoding with pieces of " << chunk << " bytes: " << id
+                << " measures, " << decoder.getNbSkippedMessages() << " skipped, "
+                << decoder.getNbDroppedBytes() << " dropped" << std::endl;
+      return false;
+    }
+
+    vpLaserScan laserscan[4];
+    decoder.toLaserScan(laserscan);
+    for (unsigned int layer = 0; layer < 4; layer++) {
+      std::vector<vpScanPoint> points = laserscan[layer].getScanPoints();
+      if ((points.size() != decoder.getNbPoints(layer)) || points.empty()
+          || (points[0].getRadialDist() != decoder.getRadialDistances(layer)[0])
+          || (points[0].getVAngle() != decoder.getVerticalAngle(layer))) {
+        std::cout << "Bad laser scan of layer " << layer << std::endl;
+        return false;
+      }
+    }
+    std::cout << "Pieces of " << chunk << " bytes: mean decoding time "
+              << decoder.getMeanDecodeTime() << " ms" << std::endl;
+    return true;
+  }
+
+#ifdef UNIX
+  bool testReplay(const std::vector<unsigned char> &stream)
+  {
+    std::string filename = "/tmp/testSickLDMRSDecoder.raw";
+    FILE *fd = fopen(filename.c_str(), "wb");
+    if ((fd == NULL) || (fwrite(&stream[0], 1, stream.size(), fd) != stream.size())) {
+      std::cout << "Cannot write " << filename << std::endl;
+      return false;
+    }
+    fclose(fd);
+
+    vpSickLDMRS laser;
+    if (! laser.setReplayFile(filename))
+      return false;
+    vpLaserScan laserscan[4];
+    for (unsigned int id = 0; id < nbMeasures; id++) {
+      if (! laser.measure(laserscan) || ! check(laser.getDecoder(), id)
+          || (laserscan[0].getScanPoints().size() != laser.getDecoder().getNbPoints(0))) {
+        std::cout << "Bad replay of measure " << id << std::endl;
+        return false;
+      }
+    }
+    if (laser.measure(laserscan)) {
+      std::cout << "Measure after the end of the replay" << std::endl;
+      return false;
+    }
+    remove(filename.c_str());
+    return true;
+  }
+#endif
+}
+
+int main()
+{
+  std::vector<unsigned char> stream;
+  unsigned int nbDropped = buildStream(stream);
+
+  unsigned int chunks[] = { 1, 13, 1000, 32768 };
+  for (unsigned int i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+    if (! testDecoder(stream, nbDropped, chunks[i]))
+      return -1;
+  }
+#ifdef UNIX
+  if (! testReplay(stream))
+    return -1;
+#endif
+  std::cout << "vpSickLDMRSDecoder is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Batched and parallel Ransac estimation of an homography.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testHomographyRansacBatch.cpp
+
+  Estimate an homography from matches corrupted by outliers with
+  vpHomography::ransacBatch() and check that the result does not depend
+  on the number of threads nor on the block size.
+*/
+
+#include <visp/vpHomography.h>
+#include <visp/vpMath.h>
+#include <visp/vpNoise.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+  try {
+    // 2000 matches, one out of three is an outlier
+    const unsigned int n = 2000;
+    vpHomography aHb;
+    aHb[0][0] = 1.05; aHb[0][1] = 0.02; aHb[0][2] = 0.03;
+    aHb[1][0] = -0.04; aHb[1][1] = 0.97; aHb[1][2] = -0.02;
+    aHb[2][0] = 0.1; aHb[2][1] = -0.05; aHb[2][2] = 1.;
+
+    vpUniRand rnd(3);
+    std::vector<double> xb(n), yb(n), xa(n), ya(n);
+    std::vector<bool> outlier(n);
+    unsigned int nbOutliers = 0;
+    for (unsigned int i = 0; i < n; i++) {
+      xb[i] = rnd() - 0.5;
+      yb[i] = rnd() - 0.5;
+      double w = aHb[2][0]*xb[i] + aHb[2][1]*yb[i] + aHb[2][2];
+      xa[i] = (aHb[0][0]*xb[i] + aHb[0][1]*yb[i] + aHb[0][2]) / w;
+      ya[i] = (aHb[1][0]*xb[i] + aHb[1][1]*yb[i] + aHb[1][2]) / w;
+      outlier[i] = (i % 3 == 2);
+      if (outlier[i]) {
+        xa[i] += 0.2*rnd() + 0.05;
+        ya[i] -= 0.2*rnd() + 0.05;
+        nbOutliers++;
+      }
+    }
+    const double threshold = 1e-4;
+    const int consensus = (int)(n - nbOutliers);
+
+    vpHomography H[4];
+    vpColVector inliers[4];
+    unsigned int nbThreads[4] = { 1, 4, 1, 4 };
+    unsigned int blockSize[4] = { 1, 1, 64, 64 };
+    for (unsigned int k = 0; k < 4; k++) {
+      double t = vpTime::measureTimeMs();
+      bool found = vpHomography::ransacBatch(n, &xb[0], &yb[0], &xa[0], &ya[0],
+                                             H[k], inliers[k], 42, nbThreads[k],
+                                             consensus, threshold, 0.0,
+                                             10000, blockSize[k]);
+      t = vpTime::measureTimeMs() - t;
+      if (! found) {
+        std::cout << "No homography found" << std::endl;
+        return -1;
+      }
+      std::cout << nbThreads[k] << " thread(s), blocks of " << blockSize[k]
+                << ": " << inliers[k].sumSquare() << " inliers, "
+                << t << " ms" << std::endl;
+    }
+
+    // Same seed, same result whatever the threads and blocks
+    for (unsigned int k = 1; k < 4; k++) {
+      for (unsigned int i = 0; i < n; i++) {
+        if (inliers[k][i] != inliers[0][i]) {
+          std::cout << "The inliers depend on the threads or blocks" << std::endl;
+          return -1;
+        }
+      }
+      for (unsigned int i = 0; i < 9; i++) {
+        if (fabs(H[k].data[i] - H[0].data[i]) > 1e-9) {
+          std::cout << "The homography depends on the threads or blocks" << std::endl;
+          return -1;
+        }
+      }
+    }
+
+    // The outliers are rejected and the homography is the expected one
+    for (unsigned int i = 0; i < n; i++) {
+      if ((inliers[0][i] != 0) == outlier[i]) {
+        std::cout << "Match " << i << " is badly classified" << std::endl;
+        return -1;
+      }
+    }
+    for (unsigned int i = 0; i < 9; i++) {
+      if (fabs(H[0].data[i] - aHb.data[i]) > 1e-6) {
+        std::cout << "Bad homography:\n" << H[0] << std::endl;
+        return -1;
+      }
+    }
+
+    // Compare with the serial implementation
+    vpHomography Hs;
+    double t = vpTime::measureTimeMs();
+    vpHomography::ransac(n, &xb[0], &yb[0], &xa[0], &ya[0], Hs, consensus, threshold);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "vpHomography::ransac(): " << t << " ms" << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
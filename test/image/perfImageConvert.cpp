@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Benchmark of the image conversions.
+ *
+ *****************************************************************************/
+
+/*!
+  \example perfImageConvert.cpp
+
+  Measure the throughput in megapixels per second of the main
+  vpImageConvert conversions for a VGA image, with each instruction
+  set supported by the processor.
+*/
+
+#include <visp/vpImageConvert.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+  typedef void (*vpConversion)(unsigned char *src, unsigned char *dst,
+                               unsigned int width, unsigned int height);
+
+  void yuv422ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV422ToRGBa(s, d, w*h); }
+  void yuyvToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUYVToRGB(s, d, w, h); }
+  void yuyvToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUYVToGrey(s, d, w*h); }
+  void yuv420ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV420ToRGBa(s, d, w, h); }
+  void yuv411ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV411ToRGBa(s, d, w*h); }
+  void yuv444ToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV444ToRGB(s, d, w*h); }
+  void rgbToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBToRGBa(s, d, w*h); }
+  void rgbaToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBaToGrey(s, d, w*h); }
+  void bgrToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::BGRToGrey(s, d, w, h, false); }
+  void greyToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::GreyToRGBa(s, d, w*h); }
+  void ycbcrToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YCbCrToRGBa(s, d, w*h); }
+
+  struct vpConversionPerf {
+    const char *name;
+    vpConversion convert;
+  };
+
+  const vpConversionPerf conversions[] = {
+    { "YUV422ToRGBa", yuv422ToRGBa }, { "YUYVToRGB", yuyvToRGB },
+    { "YUYVToGrey", yuyvToGrey }, { "YUV420ToRGBa", yuv420ToRGBa },
+    { "YUV411ToRGBa", yuv411ToRGBa }, { "YUV444ToRGB", yuv444ToRGB },
+    { "RGBToRGBa", rgbToRGBa }, { "RGBaToGrey", rgbaToGrey },
+    { "BGRToGrey", bgrToGrey }, { "GreyToRGBa", greyToRGBa },
+    { "YCbCrToRGBa", ycbcrToRGBa }
+  };
+
+  const char *simdNames[] = { "none", "SSE2", "SSSE3", "AVX2" };
+}
+
+int main()
+{
+  const unsigned int width = 640;
+  const unsigned int height = 480;
+  const unsigned int nruns = 100;
+  const unsigned int nconversions = sizeof(conversions) / sizeof(conversions[0]);
+
+  std::vector<unsigned char> src(4*width*height);
+  std::vector<unsigned char> dst(4*width*height);
+  for (unsigned int i = 0; i < src.size(); i++)
+    src[i] = (unsigned char)(rand() % 256);
+
+  int support = (int)vpImageConvert::getSimdSupport();
+  printf("%-14s", "MPix/s");
+  for (int t = 0; t <= support; t++)
+    printf("%10s", simdNames[t]);
+  printf("\n");
+
+  for (unsigned int c = 0; c < nconversions; c++) {
+    printf("%-14s", conversions[c].name);
+    for (int t = 0; t <= support; t++) {
+      vpImageConvert::setSimdType((vpImageConvert::vpSimdType)t);
+      conversions[c].convert(&src[0], &dst[0], width, height); // warm up
+      double t0 = vpTime::measureTimeMs();
+      for (unsigned int r = 0; r < nruns; r++)
+        conversions[c].convert(&src[0], &dst[0], width, height);
+      double ms = vpTime::measureTimeMs() - t0;
+      printf("%10.1f", (ms > 0) ? (double)nruns*width*height / (ms * 1000.) : 0.);
+    }
+    printf("\n");
+  }
+  vpImageConvert::setSimdType((vpImageConvert::vpSimdType)support);
+  return 0;
+}
@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Compare the SIMD and portable image conversions.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testConversionSimd.cpp
+
+  Check that all the instruction sets supported by the processor give
+  the same results as the portable code for the vpImageConvert
+  conversions, on random images of even and odd sizes, with one and
+  several threads.
+*/
+
+#include <visp/vpImageConvert.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+namespace {
+  // Conversion of an image of width x height pixels
+  typedef void (*vpConversion)(unsigned char *src, unsigned char *dst,
+                               unsigned int width, unsigned int height);
+
+  void yuv422ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV422ToRGBa(s, d, w*h); }
+  void yuv422ToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV422ToRGB(s, d, w*h); }
+  void yuv422ToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV422ToGrey(s, d, w*h); }
+  void yuyvToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUYVToRGBa(s, d, w, h); }
+  void yuyvToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUYVToRGB(s, d, w, h); }
+  void yuyvToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUYVToGrey(s, d, w*h); }
+  void yuv411ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV411ToRGBa(s, d, w*h); }
+  void yuv411ToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV411ToRGB(s, d, w*h); }
+  void yuv411ToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV411ToGrey(s, d, w*h); }
+  void yuv420ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV420ToRGBa(s, d, w, h); }
+  void yuv420ToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV420ToRGB(s, d, w, h); }
+  void yv12ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YV12ToRGBa(s, d, w, h); }
+  void yv12ToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YV12ToRGB(s, d, w, h); }
+  void yuv444ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV444ToRGBa(s, d, w*h); }
+  void yuv444ToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV444ToRGB(s, d, w*h); }
+  void yuv444ToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YUV444ToGrey(s, d, w*h); }
+  void rgbToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBToRGBa(s, d, w*h); }
+  void rgbaToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBaToRGB(s, d, w*h); }
+  void rgbToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBToGrey(s, d, w*h); }
+  void rgbaToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBaToGrey(s, d, w*h); }
+  void greyToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::GreyToRGBa(s, d, w*h); }
+  void rgbToRGBaFlip(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBToRGBa(s, d, w, h, true); }
+  void rgbToGreyFlip(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::RGBToGrey(s, d, w, h, true); }
+  void bgrToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::BGRToRGBa(s, d, w, h, false); }
+  void bgrToGreyFlip(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::BGRToGrey(s, d, w, h, true); }
+  void ycbcrToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YCbCrToRGB(s, d, w*h); }
+  void ycbcrToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YCbCrToRGBa(s, d, w*h); }
+  void ycrcbToRGB(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YCrCbToRGB(s, d, w*h); }
+  void ycrcbToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YCrCbToRGBa(s, d, w*h); }
+  void ycbcrToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::YCbCrToGrey(s, d, w*h); }
+  void mono16ToGrey(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::MONO16ToGrey(s, d, w*h); }
+  void mono16ToRGBa(unsigned char *s, unsigned char *d, unsigned int w, unsigned int h)
+  { vpImageConvert::MONO16ToRGBa(s, d, w*h); }
+
+  struct vpConversionTest {
+    const char *name;
+    vpConversion convert;
+  };
+
+  const vpConversionTest conversions[] = {
+    { "YUV422ToRGBa", yuv422ToRGBa }, { "YUV422ToRGB", yuv422ToRGB },
+    { "YUV422ToGrey", yuv422ToGrey }, { "YUYVToRGBa", yuyvToRGBa },
+    { "YUYVToRGB", yuyvToRGB }, { "YUYVToGrey", yuyvToGrey },
+    { "YUV411ToRGBa", yuv411ToRGBa }, { "YUV411ToRGB", yuv411ToRGB },
+    { "YUV411ToGrey", yuv411ToGrey }, { "YUV420ToRGBa", yuv420ToRGBa },
+    { "YUV420ToRGB", yuv420ToRGB }, { "YV12ToRGBa", yv12ToRGBa },
+    { "YV12ToRGB", yv12ToRGB }, { "YUV444ToRGBa", yuv444ToRGBa },
+    { "YUV444ToRGB", yuv444ToRGB }, { "YUV444ToGrey", yuv444ToGrey },
+    { "RGBToRGBa", rgbToRGBa }, { "RGBaToRGB", rgbaToRGB },
+    { "RGBToGrey", rgbToGrey }, { "RGBaToGrey", rgbaToGrey },
+    { "GreyToRGBa", greyToRGBa }, { "RGBToRGBa flip", rgbToRGBaFlip },
+    { "RGBToGrey flip", rgbToGreyFlip }, { "BGRToRGBa", bgrToRGBa },
+    { "BGRToGrey flip", bgrToGreyFlip }, { "YCbCrToRGB", ycbcrToRGB },
+    { "YCbCrToRGBa", ycbcrToRGBa }, { "YCrCbToRGB", ycrcbToRGB },
+    { "YCrCbToRGBa", ycrcbToRGBa }, { "YCbCrToGrey", ycbcrToGrey },
+    { "MONO16ToGrey", mono16ToGrey }, { "MONO16ToRGBa", mono16ToRGBa }
+  };
+
+  const char *simdName(vpImageConvert::vpSimdType type)
+  {
+    switch (type) {
+    case vpImageConvert::SIMD_SSE2: return "SSE2";
+    case vpImageConvert::SIMD_SSSE3: return "SSSE3";
+    case vpImageConvert::SIMD_AVX2: return "AVX2";
+    default: return "none";
+    }
+  }
+}
+
+int main()
+{
+  // Sizes chosen to exercise the remaining pixels of the SIMD loops;
+  // the last one is large enough to be converted by several threads
+  const unsigned int sizes[][2] = { {1, 2}, {3, 5}, {17, 7}, {33, 31},
+                                    {64, 48}, {127, 65}, {640, 480} };
+  const unsigned int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+  const unsigned int nconversions = sizeof(conversions) / sizeof(conversions[0]);
+
+  vpImageConvert::vpSimdType support = vpImageConvert::getSimdSupport();
+  std::cout << "Instruction set supported: " << simdName(support) << std::endl;
+
+  srand(12345);
+  // The sources use at most 4 bytes per pixel; the destinations are
+  // filled with a marker to detect the bytes written out of the image
+  const unsigned int maxPixels = 640*480;
+  std::vector<unsigned char> src(4*maxPixels + 64);
+  std::vector<unsigned char> ref(4*maxPixels + 64);
+  std::vector<unsigned char> dst(4*maxPixels + 64);
+  for (unsigned int i = 0; i < src.size(); i++)
+    src[i] = (unsigned char)(rand() % 256);
+
+  int nbErrors = 0;
+  for (unsigned int threads = 1; threads <= 4; threads += 3) {
+    vpImageConvert::setNumberOfThreads(threads);
+    for (unsigned int s = 0; s < nsizes; s++) {
+      unsigned int w = sizes[s][0];
+      unsigned int h = sizes[s][1];
+      for (unsigned int c = 0; c < nconversions; c++) {
+        vpImageConvert::setSimdType(vpImageConvert::SIMD_NONE);
+        memset(&ref[0], 0xA5, ref.size());
+        conversions[c].convert(&src[0], &ref[0], w, h);
+
+        for (int t = (int)vpImageConvert::SIMD_SSE2; t <= (int)support; t++) {
+          vpImageConvert::setSimdType((vpImageConvert::vpSimdType)t);
+          memset(&dst[0], 0xA5, dst.size());
+          conversions[c].convert(&src[0], &dst[0], w, h);
+          if (memcmp(&ref[0], &dst[0], dst.size()) != 0) {
+            std::cout << conversions[c].name << " " << w << "x" << h
+                      << " with " << threads << " threads: "
+                      << simdName((vpImageConvert::vpSimdType)t)
+                      << " differs from the portable code" << std::endl;
+            nbErrors++;
+          }
+        }
+      }
+    }
+  }
+  vpImageConvert::setSimdType(support);
+  vpImageConvert::setNumberOfThreads(1);
+
+  if (nbErrors) {
+    std::cout << nbErrors << " errors" << std::endl;
+    return -1;
+  }
+  std::cout << "All the conversions give the same results" << std::endl;
+  return 0;
+}
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Aligned and pooled image allocation.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageAllocator.cpp
+
+  Check the alignment of the vpImage pixels and rows, the row padding
+  of vpImage::initPadded(), and the reuse of the memory blocks by the
+  vpImageAllocator pool, also when images are allocated by several
+  threads.
+*/
+
+#include <visp/vpImage.h>
+#include <visp/vpImageAllocator.h>
+#include <visp/vpRGBa.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+
+namespace {
+  bool isAligned(const void *p, unsigned int alignment)
+  {
+    return ((size_t)p % alignment) == 0;
+  }
+
+  // Temporary image allocated and released at each frame
+  void processFrames(unsigned int nframes)
+  {
+    for (unsigned int f = 0; f < nframes; f++) {
+      vpImage<unsigned char> tmp;
+      tmp.resize(480, 640);
+      tmp[f % 480][f % 640] = 255;
+    }
+  }
+}
+
+int main()
+{
+  try {
+    // Default alignment of the pixels
+    vpImage<unsigned char> I(17, 33);
+    vpImage<vpRGBa> C(5, 7);
+    if (! isAligned(I.bitmap, vpImageAllocator::DEFAULT_ALIGNMENT)
+        || ! isAligned(C.bitmap, vpImageAllocator::DEFAULT_ALIGNMENT)) {
+      std::cout << "Pixels not aligned" << std::endl;
+      return -1;
+    }
+
+    // Padded rows
+    vpImage<unsigned char> P;
+    P.initPadded(40, 50);
+    if (P.getStride() != 64 || P.isContiguous() || P.isView()) {
+      std::cout << "Bad padded image properties" << std::endl;
+      return -1;
+    }
+    for (unsigned int i = 0; i < P.getHeight(); i++) {
+      if (! isAligned(P[i], vpImageAllocator::DEFAULT_ALIGNMENT)) {
+        std::cout << "Row " << i << " not aligned" << std::endl;
+        return -1;
+      }
+      for (unsigned int j = 0; j < P.getWidth(); j++)
+        P[i][j] = (unsigned char)(i + 3*j);
+    }
+    vpImage<unsigned char> Pc(P);
+    if (! Pc.isContiguous() || !(Pc == P)) {
+      std::cout << "Bad copy of a padded image" << std::endl;
+      return -1;
+    }
+    vpImage<vpRGBa> Pr;
+    Pr.initPadded(3, 5);
+    if (Pr.getStride() != 8 || ! isAligned(Pr[2], vpImageAllocator::DEFAULT_ALIGNMENT)) {
+      std::cout << "Bad padded color image" << std::endl;
+      return -1;
+    }
+    P.resize(40, 50);
+    if (! P.isContiguous()) {
+      std::cout << "Resizing a padded image should give contiguous pixels" << std::endl;
+      return -1;
+    }
+
+    // Other alignment
+    vpImageAllocator::setAlignment(64);
+    vpImage<unsigned char> A(3, 3);
+    if (! isAligned(A.bitmap, 64)) {
+      std::cout << "Pixels not aligned on 64 bytes" << std::endl;
+      return -1;
+    }
+    bool thrown = false;
+    try {
+      vpImageAllocator::setAlignment(24);
+    }
+    catch(vpException &) {
+      thrown = true;
+    }
+    if (! thrown) {
+      std::cout << "An alignment of 24 should be rejected" << std::endl;
+      return -1;
+    }
+    vpImageAllocator::setAlignment(vpImageAllocator::DEFAULT_ALIGNMENT);
+
+    // Without pool, each frame allocates the pixels and the rows
+    const unsigned int nframes = 200;
+    vpImageAllocator::resetCounters();
+    double t = vpTime::measureTimeMs();
+    processFrames(nframes);
+    double tSystem = vpTime::measureTimeMs() - t;
+    if (vpImageAllocator::getNbAllocations() != 2*nframes
+        || vpImageAllocator::getNbReleases() != 2*nframes
+        || vpImageAllocator::getNbReuses() != 0) {
+      std::cout << "Bad counters without pool" << std::endl;
+      return -1;
+    }
+
+    // With the pool, only the first frame allocates memory
+    vpImageAllocator::setPoolEnabled(true);
+    vpImageAllocator::resetCounters();
+    t = vpTime::measureTimeMs();
+    processFrames(nframes);
+    double tPool = vpTime::measureTimeMs() - t;
+    std::cout << nframes << " frames: " << tSystem << " ms without pool, "
+              << tPool << " ms with pool ("
+              << vpImageAllocator::getNbAllocations() << " allocations, "
+              << vpImageAllocator::getNbReuses() << " reuses)" << std::endl;
+    if (vpImageAllocator::getNbAllocations() != 2
+        || vpImageAllocator::getNbReuses() != 2*(nframes-1)
+        || vpImageAllocator::getNbReleases() != 0
+        || vpImageAllocator::getPoolSize() != 480*640 + 480*sizeof(unsigned char *)) {
+      std::cout << "Bad counters with pool" << std::endl;
+      return -1;
+    }
+
+    // Blocks larger than the pool are freed
+    vpImageAllocator::clearPool();
+    vpImageAllocator::resetCounters();
+    vpImageAllocator::setPoolMaxSize(4096);
+    {
+      vpImage<unsigned char> big(480, 640);
+    }
+    if (vpImageAllocator::getNbReleases() != 1
+        || vpImageAllocator::getPoolSize() != 480*sizeof(unsigned char *)) {
+      std::cout << "The pool should not exceed its maximum size" << std::endl;
+      return -1;
+    }
+    vpImageAllocator::setPoolMaxSize(64*1024*1024);
+
+    // Concurrent allocations from several threads
+    vpImageAllocator::clearPool();
+    vpImageAllocator::resetCounters();
+    int nbErrors = 0;
+#ifdef VISP_HAVE_OPENMP
+    #pragma omp parallel for num_threads(4) reduction(+:nbErrors)
+#endif
+    for (int k = 0; k < 64; k++) {
+      for (unsigned int f = 0; f < 50; f++) {
+        unsigned int h = 10 + (unsigned int)(k % 4) * 10;
+        vpImage<unsigned char> tmp(h, 64, (unsigned char)k);
+        if (tmp[h-1][63] != (unsigned char)k || ! isAligned(tmp.bitmap, 32))
+          nbErrors++;
+      }
+    }
+    unsigned long requests = vpImageAllocator::getNbAllocations()
+      + vpImageAllocator::getNbReuses();
+    vpImageAllocator::setPoolEnabled(false);
+    if (nbErrors != 0 || requests != 2*64*50
+        || vpImageAllocator::getNbReleases() != vpImageAllocator::getNbAllocations()
+        || vpImageAllocator::getPoolSize() != 0) {
+      std::cout << "Bad concurrent use of the pool" << std::endl;
+      return -1;
+    }
+    std::cout << "Concurrent use: " << vpImageAllocator::getNbAllocations()
+              << " allocations for " << requests << " requests" << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
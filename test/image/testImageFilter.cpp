@@ -0,0 +1,255 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the separable and integer image filters.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageFilter.cpp
+
+  Compare the separable filters of vpImageFilter with direct 2D
+  correlations, for each border type and with several threads, and
+  measure the time needed to compute the image gradient.
+*/
+
+#include <visp/vpImage.h>
+#include <visp/vpImageFilter.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+
+namespace {
+  int refIndex(int x, int n, vpImageFilter::vpBorderType border)
+  {
+    if (x >= 0 && x < n) return x;
+    if (border == vpImageFilter::BORDER_ZERO) return -1;
+    if (border == vpImageFilter::BORDER_REPLICATE) return (x < 0) ? 0 : n-1;
+    // Reflection without the border pixel, for kernels smaller than the image
+    return (x < 0) ? -x : 2*(n-1) - x;
+  }
+
+  // Direct 2D correlation with the border handling of vpImageFilter
+  template<class In>
+  void correlate(const vpImage<In> &I, const vpMatrix &M,
+                 vpImageFilter::vpBorderType border, vpImage<double> &If)
+  {
+    int h = (int)I.getHeight(), w = (int)I.getWidth();
+    int half = (int)M.getRows() / 2;
+    If.resize((unsigned int)h, (unsigned int)w);
+    for (int i = 0; i < h; i++) {
+      for (int j = 0; j < w; j++) {
+        double s = 0;
+        for (int a = -half; a <= half; a++) {
+          int r = refIndex(i + a, h, border);
+          if (r < 0) continue;
+          for (int b = -half; b <= half; b++) {
+            int c = refIndex(j + b, w, border);
+            if (c < 0) continue;
+            s += M[(unsigned int)(a+half)][(unsigned int)(b+half)] * I[(unsigned int)r][(unsigned int)c];
+          }
+        }
+        If[(unsigned int)i][(unsigned int)j] = s;
+      }
+    }
+  }
+
+  double maxDifference(const vpImage<double> &A, const vpImage<double> &B)
+  {
+    if (A.getHeight() != B.getHeight() || A.getWidth() != B.getWidth())
+      return 1e30;
+    double d = 0;
+    for (unsigned int i = 0; i < A.getHeight(); i++)
+      for (unsigned int j = 0; j < A.getWidth(); j++)
+        d = vpMath::maximum(d, fabs(A[i][j] - B[i][j]));
+    return d;
+  }
+}
+
+int main()
+{
+  try {
+    vpImage<unsigned char> I(97, 131);
+    srand(1);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char)(rand() % 256);
+
+    // Separability
+    const int bin[5] = { 1, 4, 6, 4, 1 };
+    const int der[5] = { -1, -2, 0, 2, 1 };
+    vpMatrix G(5, 5), D(5, 5), N(3, 3);
+    for (unsigned int a = 0; a < 5; a++)
+      for (unsigned int b = 0; b < 5; b++) {
+        G[a][b] = bin[a]*bin[b] / 256.;
+        D[a][b] = bin[a]*der[b] / 48.;
+      }
+    N = 1; N[1][1] = 8; // Non separable
+    vpColVector kv, ku;
+    if (! vpImageFilter::isSeparable(G, kv, ku) || ! vpImageFilter::isSeparable(D, kv, ku)
+        || vpImageFilter::isSeparable(N, kv, ku)) {
+      std::cout << "Bad separability detection" << std::endl;
+      return -1;
+    }
+
+    // Exact integer filters for each border type
+    vpImageFilter::vpBorderType borders[3] = { vpImageFilter::BORDER_ZERO,
+                                               vpImageFilter::BORDER_REPLICATE,
+                                               vpImageFilter::BORDER_REFLECT };
+    // The second filter is a vertical derivative, applied vertically first
+    const int one = 1;
+    vpMatrix Dv(5, 5);
+    Dv = 0;
+    for (unsigned int a = 0; a < 5; a++)
+      Dv[a][2] = der[a] / 3.;
+    vpImage<double> If, Iref;
+    for (unsigned int k = 0; k < 3; k++) {
+      vpImageFilter::sepFilter(I, If, der, 5, bin, 5, 48., borders[k]);
+      correlate(I, D, borders[k], Iref);
+      double d = maxDifference(If, Iref);
+      vpImageFilter::sepFilter(I, If, &one, 1, der, 5, 3., borders[k]);
+      correlate(I, Dv, borders[k], Iref);
+      d = vpMath::maximum(d, maxDifference(If, Iref));
+      if (d > 1e-9) {
+        std::cout << "Integer filter with border " << k << ": error " << d << std::endl;
+        return -1;
+      }
+    }
+
+    // Fixed point filter with double kernels, used by filter()
+    vpImageFilter::filter(I, If, G);
+    correlate(I, G, vpImageFilter::BORDER_REPLICATE, Iref);
+    double d = maxDifference(If, Iref);
+    if (d > 0.05) {
+      std::cout << "Fixed point Gaussian filter: error " << d << std::endl;
+      return -1;
+    }
+
+    vpColVector ku1(1), kv5(5);
+    ku1 = 1;
+    for (unsigned int a = 0; a < 5; a++)
+      kv5[a] = der[a] / 3.;
+    vpImageFilter::sepFilter(I, If, ku1, kv5, vpImageFilter::BORDER_REFLECT);
+    correlate(I, Dv, vpImageFilter::BORDER_REFLECT, Iref);
+    d = maxDifference(If, Iref);
+    if (d > 0.05) {
+      std::cout << "Fixed point vertical filter: error " << d << std::endl;
+      return -1;
+    }
+
+    // Non separable filter
+    vpImageFilter::filter(I, If, N);
+    correlate(I, N, vpImageFilter::BORDER_REPLICATE, Iref);
+    if (maxDifference(If, Iref) > 1e-9) {
+      std::cout << "Non separable filter differs" << std::endl;
+      return -1;
+    }
+
+    // Separable filter of a double image in both directions
+    vpImage<double> Id(I.getHeight(), I.getWidth()), Iu, Iv, Ivref;
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        Id[i][j] = I[i][j] / 3.;
+    vpImageFilter::filter(Id, Iu, Iv, D);
+    correlate(Id, D, vpImageFilter::BORDER_REPLICATE, Iref);
+    vpMatrix Dt = D.t();
+    correlate(Id, Dt, vpImageFilter::BORDER_REPLICATE, Ivref);
+    if (maxDifference(Iu, Iref) > 1e-9 || maxDifference(Iv, Ivref) > 1e-9) {
+      std::cout << "Separable filter of a double image differs" << std::endl;
+      return -1;
+    }
+
+    // Gradient: values of derivativeFilterX/Y() inside the image
+    vpImage<unsigned char> J(480, 640);
+    for (unsigned int i = 0; i < J.getHeight(); i++)
+      for (unsigned int j = 0; j < J.getWidth(); j++)
+        J[i][j] = (unsigned char)((i*j + rand() % 16) % 256);
+
+    const unsigned int nruns = 10;
+    vpImage<double> dIx(J.getHeight(), J.getWidth()), dIy(J.getHeight(), J.getWidth());
+    double t = vpTime::measureTimeMs();
+    for (unsigned int r = 0; r < nruns; r++) {
+      for (unsigned int i = 3; i < J.getHeight()-3; i++) {
+        for (unsigned int j = 3; j < J.getWidth()-3; j++) {
+          dIx[i][j] = vpImageFilter::derivativeFilterX(J, i, j);
+          dIy[i][j] = vpImageFilter::derivativeFilterY(J, i, j);
+        }
+      }
+    }
+    double tPixel = (vpTime::measureTimeMs() - t) / nruns;
+
+    vpImage<double> gx, gy;
+    t = vpTime::measureTimeMs();
+    for (unsigned int r = 0; r < nruns; r++) {
+      vpImageFilter::getGradX(J, gx);
+      vpImageFilter::getGradY(J, gy);
+    }
+    double tSep = (vpTime::measureTimeMs() - t) / nruns;
+
+    for (unsigned int i = 3; i < J.getHeight()-3; i++) {
+      for (unsigned int j = 3; j < J.getWidth()-3; j++) {
+        if (fabs(gx[i][j] - dIx[i][j]) > 1e-12 * fabs(dIx[i][j])
+            || fabs(gy[i][j] - dIy[i][j]) > 1e-12 * fabs(dIy[i][j])) {
+          std::cout << "Gradient differs at " << i << " " << j << std::endl;
+          return -1;
+        }
+      }
+    }
+
+    // Several threads give the same result
+    vpImageFilter::setNumberOfThreads(4);
+    vpImage<double> gx4;
+    t = vpTime::measureTimeMs();
+    for (unsigned int r = 0; r < nruns; r++) {
+      vpImageFilter::getGradX(J, gx4);
+      vpImageFilter::getGradY(J, gy);
+    }
+    double tSep4 = (vpTime::measureTimeMs() - t) / nruns;
+    vpImageFilter::setNumberOfThreads(1);
+    if (maxDifference(gx, gx4) != 0) {
+      std::cout << "Multithreaded gradient differs" << std::endl;
+      return -1;
+    }
+
+    std::cout << "Gradient of a 640x480 image: " << tPixel << " ms per pixel, "
+              << tSep << " ms separable, " << tSep4 << " ms with 4 threads" << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the batch read and write functions of vpImageIo.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageIoBatch.cpp
+
+  Writes and reads back a set of images with the batch functions of
+  vpImageIo, checks the per-file errors and the counters, and compares
+  the results with one and several threads.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpIoTools.h>
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+  bool equal(const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2,
+             int tolerance)
+  {
+    if ((I1.getHeight() != I2.getHeight()) || (I1.getWidth() != I2.getWidth()))
+      return false;
+    for (unsigned int i = 0; i < I1.getHeight(); i++)
+      for (unsigned int j = 0; j < I1.getWidth(); j++)
+        if (abs((int)I1[i][j] - (int)I2[i][j]) > tolerance)
+          return false;
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+#ifdef WIN32
+    std::string opath = "C:\\temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    opath += vpIoTools::path("/") + "testImageIoBatch";
+    if (vpIoTools::checkDirectory(opath) == false)
+      vpIoTools::makeDirectory(opath);
+
+    std::vector<std::string> extensions;
+    extensions.push_back("pgm");
+    extensions.push_back("ppm");
+#if (defined(VISP_HAVE_LIBPNG) || defined(VISP_HAVE_OPENCV))
+    extensions.push_back("png");
+#endif
+#if (defined(VISP_HAVE_LIBJPEG) || defined(VISP_HAVE_OPENCV))
+    extensions.push_back("jpg");
+#endif
+
+    const unsigned int nimages = 48;
+    std::vector<vpImage<unsigned char> > I(nimages);
+    std::vector<std::string> filenames(nimages);
+    for (unsigned int k = 0; k < nimages; k++) {
+      I[k].resize(120, 160);
+      for (unsigned int i = 0; i < I[k].getHeight(); i++)
+        for (unsigned int j = 0; j < I[k].getWidth(); j++)
+          I[k][i][j] = (unsigned char)(k + i / 4 + j / 8);
+      char name[FILENAME_MAX];
+      sprintf(name, "%s/I%03u.%s", opath.c_str(), k,
+              extensions[k % extensions.size()].c_str());
+      filenames[k] = name;
+    }
+
+    vpImageIo::setNumberOfThreads(4);
+    vpImageIo::resetBatchCounters();
+    std::vector<std::string> errors;
+    if (vpImageIo::write(I, filenames, errors) != 0) {
+      std::cout << "Cannot write the images" << std::endl;
+      return -1;
+    }
+
+    // Add a missing file, a file in an unknown format and a corrupted file
+    std::vector<std::string> readnames = filenames;
+    readnames.push_back(opath + "/missing.pgm");
+    readnames.push_back(opath + "/unknown.xyz");
+    std::string corrupted = opath + "/corrupted.pgm";
+    FILE *fd = fopen(corrupted.c_str(), "wb");
+    fprintf(fd, "P5\n160 120\n255\nabc");
+    fclose(fd);
+    readnames.push_back(corrupted);
+#if (defined(VISP_HAVE_LIBJPEG) || defined(VISP_HAVE_OPENCV))
+    std::string corruptedJpeg = opath + "/corrupted.jpg";
+    fd = fopen(corruptedJpeg.c_str(), "wb");
+    fprintf(fd, "this is not a jpeg file");
+    fclose(fd);
+    readnames.push_back(corruptedJpeg);
+#endif
+
+    std::vector<vpImage<unsigned char> > R, R1;
+    unsigned int nfailures = vpImageIo::read(R, readnames, errors);
+    if ((nfailures != readnames.size() - nimages) || (R.size() != readnames.size())) {
+      std::cout << "Bad number of failures: " << nfailures << std::endl;
+      return -1;
+    }
+    for (unsigned int k = 0; k < readnames.size(); k++) {
+      bool failed = ! errors[k].empty();
+      if (failed != (k >= nimages)) {
+        std::cout << "Bad error report for " << readnames[k] << std::endl;
+        return -1;
+      }
+      if (failed)
+        std::cout << readnames[k] << ": " << errors[k] << std::endl;
+    }
+    for (unsigned int k = 0; k < nimages; k++) {
+      // JPEG is lossy, and the grey level to color to grey level round
+      // trip of PPM files may differ by one
+      std::string ext = filenames[k].substr(filenames[k].size() - 3);
+      int tolerance = (ext == "jpg") ? 8 : ((ext == "ppm") ? 1 : 0);
+      if (! equal(I[k], R[k], tolerance)) {
+        std::cout << "Bad image " << filenames[k] << std::endl;
+        return -1;
+      }
+    }
+
+    // Same result with a single thread
+    vpImageIo::setNumberOfThreads(1);
+    vpImageIo::read(R1, filenames, errors);
+    for (unsigned int k = 0; k < nimages; k++)
+      if (! equal(R[k], R1[k], 0)) {
+        std::cout << "The images depend on the number of threads" << std::endl;
+        return -1;
+      }
+
+    // Color images
+    std::vector<vpImage<vpRGBa> > C;
+    vpImageIo::setNumberOfThreads(4);
+    if (vpImageIo::read(C, filenames, errors) != 0
+        || (C[0][10][20].R != R[0][10][20])) {
+      std::cout << "Bad color images" << std::endl;
+      return -1;
+    }
+
+    unsigned long nfiles = nimages + readnames.size() + 2 * nimages;
+    if ((vpImageIo::getNbBatchFiles() != nfiles)
+        || (vpImageIo::getNbBatchFailures() != readnames.size() - nimages)
+        || (vpImageIo::getBatchPixels() != 4. * nimages * 120 * 160)) {
+      std::cout << "Bad batch counters" << std::endl;
+      return -1;
+    }
+    std::cout << vpImageIo::getNbBatchFiles() << " files in "
+              << vpImageIo::getBatchTime() << " ms" << std::endl;
+
+    std::vector<std::string> wrongnames(nimages - 1);
+    try {
+      vpImageIo::write(I, wrongnames, errors);
+      std::cout << "Batch write with a wrong number of file names" << std::endl;
+      return -1;
+    }
+    catch(vpException &) {
+    }
+
+    for (unsigned int k = 0; k < readnames.size(); k++)
+      remove(readnames[k].c_str());
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+
+  std::cout << "testImageIoBatch is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the read and write functions of vpImageIo on image views.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageIoView.cpp
+
+  Writes views on a sub-rectangle of an image with the functions of
+  vpImageIo, checks that the files are the ones of a copy of the view,
+  and reads them back into views of the same size without modifying
+  the pixels outside of the views.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpRGBa.h>
+
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+  const unsigned int top = 20, left = 10, height = 30, width = 60;
+
+  template<class Type>
+  bool samePixels(const vpImage<Type> &I1, const vpImage<Type> &I2)
+  {
+    if ((I1.getHeight() != I2.getHeight()) || (I1.getWidth() != I2.getWidth()))
+      return false;
+    for (unsigned int i = 0; i < I1.getHeight(); i++)
+      if (memcmp(I1[i], I2[i], I1.getWidth() * sizeof(Type)) != 0)
+        return false;
+    return true;
+  }
+
+  // Pixel (i, j) of the images written and of the images read in
+  void pattern(unsigned char &v, unsigned int i, unsigned int j, unsigned int k)
+  { v = (unsigned char)(i*3 + j*5 + k); }
+  void pattern(float &v, unsigned int i, unsigned int j, unsigned int k)
+  { v = (float)(i*3 + j*5 + k); }
+  void pattern(vpRGBa &v, unsigned int i, unsigned int j, unsigned int k)
+  { v = vpRGBa((unsigned char)(i*3 + k), (unsigned char)(j*5), (unsigned char)(i + j), 0); }
+
+  template<class Type>
+  void fill(vpImage<Type> &I, unsigned int k)
+  {
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        pattern(I[i][j], i, j, k);
+  }
+
+  template<class Type>
+  void writeImage(const vpImage<Type> &I, const std::string &filename)
+  { vpImageIo::write(I, filename); }
+  void writeImage(const vpImage<float> &I, const std::string &filename)
+  { vpImageIo::writePFM(I, filename.c_str()); }
+
+  template<class Type>
+  void readImage(vpImage<Type> &I, const std::string &filename)
+  { vpImageIo::read(I, filename); }
+  void readImage(vpImage<float> &I, const std::string &filename)
+  { vpImageIo::readPFM(I, filename.c_str()); }
+
+  template<class Type>
+  bool test(const std::string &filename)
+  {
+    vpImage<Type> P(80, 100), V, Vc, R, Rc;
+    fill(P, 0);
+    V.initView(P, top, left, height, width);
+    Vc = V;
+
+    // The file of a view is the one of its copy
+    size_t slash = filename.find_last_of("/\\");
+    std::string copyname = filename.substr(0, slash + 1) + "copy_"
+      + filename.substr(slash + 1);
+    writeImage(V, filename);
+    writeImage(Vc, copyname);
+    readImage(R, filename);
+    readImage(Rc, copyname);
+    remove(copyname.c_str());
+    if (! samePixels(R, Rc)) {
+      std::cout << "Bad file written from a view: " << filename << std::endl;
+      return false;
+    }
+
+    // Reading in a view of the same size does not modify the other pixels
+    vpImage<Type> Q(80, 100), Q0, W;
+    fill(Q, 1);
+    Q0 = Q;
+    W.initView(Q, top, left, height, width);
+    readImage(W, filename);
+    remove(filename.c_str());
+    if (! samePixels(W, R)) {
+      std::cout << "Bad image read in a view: " << filename << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < Q.getHeight(); i++)
+      for (unsigned int j = 0; j < Q.getWidth(); j++) {
+        bool in = (i >= top) && (i < top + height) && (j >= left) && (j < left + width);
+        if (! in && (memcmp(&Q[i][j], &Q0[i][j], sizeof(Type)) != 0)) {
+          std::cout << "Pixel (" << i << ", " << j << ") modified outside of the view by "
+                    << filename << std::endl;
+          return false;
+        }
+      }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+#ifdef WIN32
+    std::string opath = "C:\\temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    opath += vpIoTools::path("/") + "testImageIoView";
+    if (vpIoTools::checkDirectory(opath) == false)
+      vpIoTools::makeDirectory(opath);
+    opath += vpIoTools::path("/");
+
+    std::vector<std::string> extensions;
+    extensions.push_back("pgm");
+    extensions.push_back("ppm");
+#if (defined(VISP_HAVE_LIBPNG) || defined(VISP_HAVE_OPENCV))
+    extensions.push_back("png");
+#endif
+#if (defined(VISP_HAVE_LIBJPEG) || defined(VISP_HAVE_OPENCV))
+    extensions.push_back("jpg");
+#endif
+
+    for (unsigned int k = 0; k < extensions.size(); k++) {
+      if (! test<unsigned char>(opath + "grey." + extensions[k])
+          || ! test<vpRGBa>(opath + "color." + extensions[k]))
+        return -1;
+    }
+    if (! test<float>(opath + "float.pfm"))
+      return -1;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+
+  std::cout << "testImageIoView is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
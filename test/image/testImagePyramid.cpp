@@ -0,0 +1,174 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test vpImagePyramid.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImagePyramid.cpp
+
+  \brief Test vpImagePyramid.
+
+  Check the levels computed by decimation and by Gaussian reduction
+  against straightforward implementations, that the buffers are reused
+  from one image to the next and that the result does not depend on the
+  number of threads.
+*/
+
+#include <visp/vpImage.h>
+#include <visp/vpImagePyramid.h>
+#include <visp/vpImageException.h>
+
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+/*
+  Gaussian reduction of I computed pixel by pixel.
+ */
+void gaussianReference(const vpImage<unsigned char> &I,
+                       vpImage<unsigned char> &R)
+{
+  const int k[5] = {1, 4, 6, 4, 1};
+  int h = (int)I.getHeight();
+  int w = (int)I.getWidth();
+  R.resize(I.getHeight()/2, I.getWidth()/2);
+  for (int i = 0; i < (int)R.getHeight(); i++) {
+    for (int j = 0; j < (int)R.getWidth(); j++) {
+      int s = 0;
+      for (int a = -2; a <= 2; a++) {
+        int ii = 2*i + a;
+        if (ii < 0) ii = 0;
+        if (ii >= h) ii = h - 1;
+        for (int b = -2; b <= 2; b++) {
+          int jj = 2*j + b;
+          if (jj < 0) jj = 0;
+          if (jj >= w) jj = w - 1;
+          s += k[a+2] * k[b+2] * I[ii][jj];
+        }
+      }
+      R[i][j] = (unsigned char)((s + 128) >> 8);
+    }
+  }
+}
+
+bool isSame(const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth())
+    return false;
+  for (unsigned int i = 0; i < I1.getSize(); i++) {
+    if (I1.bitmap[i] != I2.bitmap[i])
+      return false;
+  }
+  return true;
+}
+
+int main()
+{
+  vpImage<unsigned char> I(483, 641);
+  srand(0);
+  for (unsigned int i = 0; i < I.getSize(); i++)
+    I.bitmap[i] = (unsigned char)(rand() % 256);
+
+  // Decimation of the levels 0 and 2 only
+  std::vector<bool> levels(3, true);
+  levels[1] = false;
+  vpImagePyramid pyramid;
+  pyramid.build(I, levels);
+  vpImage<unsigned char> I4;
+  I.quarterSizeImage(I4);
+  if (pyramid.getLevel(0) != &I || pyramid.isBuilt(1)
+      || ! isSame(pyramid[2], I4)) {
+    std::cout << "Decimation differs from vpImage::quarterSizeImage()" << std::endl;
+    return -1;
+  }
+  bool exception = false;
+  try {
+    pyramid[1];
+  }
+  catch(vpImageException &) {
+    exception = true;
+  }
+  if (! exception) {
+    std::cout << "Access to a level not computed should throw" << std::endl;
+    return -1;
+  }
+
+  // The buffers are reused when the size does not change
+  const unsigned char *bitmap = pyramid[2].bitmap;
+  vpImage<unsigned char> J(I.getHeight(), I.getWidth(), 0);
+  pyramid.build(J, levels);
+  if (pyramid[2].bitmap != bitmap || pyramid[2][10][10] != 0) {
+    std::cout << "Pyramid buffers were not reused" << std::endl;
+    return -1;
+  }
+
+  // Gaussian reduction with 1 and 4 threads
+  for (unsigned int nthreads = 1; nthreads <= 4; nthreads *= 4) {
+    vpImagePyramid gaussian(vpImagePyramid::GAUSSIAN);
+    gaussian.setNumberOfThreads(nthreads);
+    gaussian.build(I, levels);
+    if (! gaussian.isBuilt(1)) {
+      std::cout << "Intermediate Gaussian level not computed" << std::endl;
+      return -1;
+    }
+    vpImage<unsigned char> R = I;
+    for (unsigned int l = 1; l < 3; l++) {
+      vpImage<unsigned char> P = R;
+      gaussianReference(P, R);
+      if (! isSame(gaussian[l], R)) {
+        std::cout << "Gaussian level " << l << " differs from the reference with "
+                  << nthreads << " thread(s)" << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // Decimation with 4 threads
+  vpImagePyramid decimation;
+  decimation.setNumberOfThreads(4);
+  decimation.build(I, 4);
+  vpImage<unsigned char> I2, I8;
+  I.halfSizeImage(I2);
+  I4.halfSizeImage(I8);
+  if (! isSame(decimation[1], I2) || ! isSame(decimation[2], I4)
+      || ! isSame(decimation[3], I8)) {
+    std::cout << "Decimation with 4 threads differs" << std::endl;
+    return -1;
+  }
+
+  std::cout << "Pyramid levels are correct" << std::endl;
+  return 0;
+}
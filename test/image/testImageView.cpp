@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Image views on external buffers and on sub-rectangles.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageView.cpp
+
+  Create vpImage views on an external buffer with a row stride and on a
+  sub-rectangle of another image, and check that the image methods and
+  tools, the undistortion map and the dot tracker work on them as on a
+  copy.
+*/
+
+#include <visp/vpImage.h>
+#include <visp/vpImageTools.h>
+#include <visp/vpImageUndistortMap.h>
+#include <visp/vpCameraParameters.h>
+#include <visp/vpDot2.h>
+#include <visp/vpImagePoint.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+  try {
+    // External buffer of 40x50 pixels with rows padded to 64 bytes
+    const unsigned int h = 40, w = 50, stride = 64;
+    std::vector<unsigned char> buffer(h*stride, 7);
+    for (unsigned int i = 0; i < h; i++)
+      for (unsigned int j = 0; j < w; j++)
+        buffer[i*stride+j] = (unsigned char)(i + 2*j);
+
+    vpImage<unsigned char> V;
+    V.initView(&buffer[0], h, w, stride);
+    if (! V.isView() || V.isContiguous() || V.getStride() != stride
+        || V.getHeight() != h || V.getWidth() != w) {
+      std::cout << "Bad view properties" << std::endl;
+      return -1;
+    }
+    for (unsigned int i = 0; i < h; i++)
+      for (unsigned int j = 0; j < w; j++)
+        if (V[i][j] != (unsigned char)(i + 2*j) || V(i, j) != V[i][j]) {
+          std::cout << "Bad pixel (" << i << ", " << j << ")" << std::endl;
+          return -1;
+        }
+    unsigned char vmin, vmax;
+    V.getMinMaxValue(vmin, vmax);
+    if (vmin != 0 || vmax != (h-1) + 2*(w-1)) {
+      std::cout << "Bad min/max values" << std::endl;
+      return -1;
+    }
+
+    // A copy owns compact pixels, the padding is not copied
+    vpImage<unsigned char> C(V);
+    vpImage<unsigned char> D;
+    D = V;
+    if (C.isView() || ! C.isContiguous() || !(C == V) || !(D == V)) {
+      std::cout << "Bad copy of a view" << std::endl;
+      return -1;
+    }
+
+    // Writing through the view modifies the buffer but not the padding
+    V = 3;
+    for (unsigned int i = 0; i < h; i++)
+      for (unsigned int j = 0; j < stride; j++)
+        if (buffer[i*stride+j] != (j < w ? 3 : 7)) {
+          std::cout << "Bad buffer after writing through the view" << std::endl;
+          return -1;
+        }
+
+    // View on a sub-rectangle, and view of a view
+    vpImage<unsigned char> I(120, 160, 0);
+    vpImage<unsigned char> S, SS;
+    S.initView(I, 10, 20, 60, 80);
+    SS.initView(S, 5, 5, 10, 10);
+    SS = 200;
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        bool in = (i >= 15 && i < 25 && j >= 25 && j < 35);
+        if (I[i][j] != (in ? 200 : 0)) {
+          std::cout << "Bad pixel (" << i << ", " << j << ") in the viewed image" << std::endl;
+          return -1;
+        }
+      }
+    vpImage<unsigned char> Scopy;
+    vpImageTools::createSubImage(I, 10, 20, 60, 80, Scopy);
+    if (!(Scopy == S)) {
+      std::cout << "The view differs from the sub-image" << std::endl;
+      return -1;
+    }
+
+    // Resizing a view detaches it
+    SS.resize(3, 3);
+    SS = 1;
+    if (SS.isView() || I[15][25] != 200) {
+      std::cout << "Resizing a view modified the viewed image" << std::endl;
+      return -1;
+    }
+
+    // Undistortion of a view
+    vpImage<unsigned char> G(240, 320);
+    for (unsigned int i = 0; i < G.getHeight(); i++)
+      for (unsigned int j = 0; j < G.getWidth(); j++)
+        G[i][j] = (unsigned char)((i*7 + j*3) % 256);
+    vpImage<unsigned char> Gv, Gc, U1, U2;
+    Gv.initView(G, 40, 60, 120, 160);
+    vpImageTools::createSubImage(G, 40, 60, 120, 160, Gc);
+    vpCameraParameters cam;
+    cam.initPersProjWithDistortion(300, 300, 80, 60, -0.2, 0.2);
+    vpImageUndistortMap map(cam, 120, 160);
+    map.undistort(Gv, U1);
+    map.undistort(Gc, U2);
+    if (!(U1 == U2)) {
+      std::cout << "Undistortion of a view differs from the one of a copy" << std::endl;
+      return -1;
+    }
+
+    // A contiguous view of the same size is detached by a copy
+    vpImage<unsigned char> Band, Z(2, 160, 9);
+    Band.initView(I, 30, 0, 2, 160);
+    Band = Z;
+    if (Band.isView() || I[30][0] != 0 || I[31][159] != 0) {
+      std::cout << "Copying into a view modified the viewed image" << std::endl;
+      return -1;
+    }
+
+    // Cropping an image in place with a view on its own pixels
+    vpImage<unsigned char> K(100, 120), Kc, Kroi;
+    for (unsigned int i = 0; i < K.getHeight(); i++)
+      for (unsigned int j = 0; j < K.getWidth(); j++)
+        K[i][j] = (unsigned char)((i*5 + j) % 256);
+    vpImageTools::createSubImage(K, 10, 20, 30, 40, Kc);
+    Kroi.initView(K, 10, 20, 30, 40);
+    K = Kroi;
+    if (K.isView() || ! K.isContiguous() || !(K == Kc)) {
+      std::cout << "Bad crop of an image in place" << std::endl;
+      return -1;
+    }
+    Kroi.initView(K, 0, 0, 30, 40);
+    K = Kroi;
+    if (K.isView() || !(K == Kc)) {
+      std::cout << "Bad copy of a view on the whole image" << std::endl;
+      return -1;
+    }
+
+    // The image tools on a view give the result of a copy, and do not
+    // modify the pixels outside of the view
+    vpImage<unsigned char> R1, R2, D1, D2;
+    vpImageTools::undistort(Gv, cam, R1);
+    vpImageTools::undistort(Gc, cam, R2);
+    vpImageTools::flip(Gv, D1);
+    vpImageTools::flip(Gc, D2);
+    if (!(R1 == R2) || !(D1 == D2)) {
+      std::cout << "Undistortion or flip of a view differs from the one of a copy" << std::endl;
+      return -1;
+    }
+    vpImage<unsigned char> Gv2;
+    Gv2.initView(G, 50, 40, 120, 160);
+    vpImageTools::createSubImage(G, 50, 40, 120, 160, D2);
+    vpImageTools::imageDifference(Gc, D2, R2);
+    vpImageTools::imageDifference(Gv, Gv2, R1);
+    if (!(R1 == R2)) {
+      std::cout << "Difference of views differs from the one of copies" << std::endl;
+      return -1;
+    }
+    vpImage<unsigned char> G0(G);
+    vpImageTools::binarise(Gv, (unsigned char)100, (unsigned char)200,
+                           (unsigned char)0, (unsigned char)128, (unsigned char)255);
+    vpImageTools::binarise(Gc, (unsigned char)100, (unsigned char)200,
+                           (unsigned char)0, (unsigned char)128, (unsigned char)255);
+    vpImageTools::flip(Gv);
+    vpImageTools::flip(Gc);
+    if (!(Gv == Gc)) {
+      std::cout << "Binarisation or flip of a view differs from the one of a copy" << std::endl;
+      return -1;
+    }
+    for (unsigned int i = 0; i < G.getHeight(); i++)
+      for (unsigned int j = 0; j < G.getWidth(); j++) {
+        bool in = (i >= 40 && i < 160 && j >= 60 && j < 220);
+        if (! in && G[i][j] != G0[i][j]) {
+          std::cout << "Pixel (" << i << ", " << j << ") modified outside of the view" << std::endl;
+          return -1;
+        }
+      }
+
+    // Dot tracking in a view
+    vpImage<unsigned char> T(480, 640, 255);
+    for (unsigned int i = 0; i < T.getHeight(); i++)
+      for (unsigned int j = 0; j < T.getWidth(); j++) {
+        double di = (double)i - 230., dj = (double)j - 330.;
+        if (di*di + dj*dj < 20.*20.)
+          T[i][j] = 0;
+      }
+    vpImage<unsigned char> Tv, Tc;
+    Tv.initView(T, 200, 300, 100, 120);
+    vpImageTools::createSubImage(T, 200, 300, 100, 120, Tc);
+    vpDot2 dv, dc;
+    dv.initTracking(Tv, vpImagePoint(30, 30));
+    dc.initTracking(Tc, vpImagePoint(30, 30));
+    dv.track(Tv);
+    dc.track(Tc);
+    vpImagePoint cv = dv.getCog(), cc = dc.getCog();
+    std::cout << "Dot tracked in the view at " << cv << std::endl;
+    if (cv != cc || fabs(cv.get_i() - 30.) > 0.5 || fabs(cv.get_j() - 30.) > 0.5) {
+      std::cout << "Bad dot tracking in the view" << std::endl;
+      return -1;
+    }
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
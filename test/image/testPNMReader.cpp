@@ -0,0 +1,311 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the memory mapped PNM reader and the PNM writers.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPNMReader.cpp
+
+  Writes PGM and PPM files, reads them back with vpImageIo and
+  vpPNMReader, checks the header cache, the zero-copy view and the
+  errors on malformed files, and compares the reading time with the
+  per-pixel reading loop that was used before.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageConvert.h>
+#include <visp/vpImageException.h>
+#include <visp/vpImageIo.h>
+#include <visp/vpIoTools.h>
+#include <visp/vpPNMReader.h>
+#include <visp/vpTime.h>
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+namespace {
+  template<class Type>
+  bool equal(const vpImage<Type> &I1, const vpImage<Type> &I2)
+  {
+    if ((I1.getHeight() != I2.getHeight()) || (I1.getWidth() != I2.getWidth()))
+      return false;
+    for (unsigned int i = 0; i < I1.getHeight(); i++)
+      if (memcmp(I1[i], I2[i], I1.getWidth() * sizeof(Type)) != 0)
+        return false;
+    return true;
+  }
+
+  void writeFile(const std::string &filename, const std::string &content)
+  {
+    FILE *fd = fopen(filename.c_str(), "wb");
+    fwrite(content.c_str(), 1, content.size(), fd);
+    fclose(fd);
+  }
+
+  bool openFails(vpPNMReader &reader, const std::string &filename)
+  {
+    try {
+      reader.open(filename);
+    }
+    catch(vpImageException &) {
+      return ! reader.isOpened();
+    }
+    return false;
+  }
+
+  // Reading loop of vpImageIo::readPPM() before the memory mapped reader,
+  // header excluded
+  void readPPMPerPixel(vpImage<vpRGBa> &I, const std::string &filename,
+                       long offset)
+  {
+    FILE *fd = fopen(filename.c_str(), "rb");
+    fseek(fd, offset, SEEK_SET);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        vpRGBa v;
+        size_t res = fread(&v.R, sizeof(v.R), 1, fd);
+        res |= fread(&v.G, sizeof(v.G), 1, fd);
+        res |= fread(&v.B, sizeof(v.B), 1, fd);
+        if (res == 0)
+          break;
+        I[i][j] = v;
+      }
+    fclose(fd);
+  }
+}
+
+int main()
+{
+  try {
+#ifdef WIN32
+    std::string opath = "C:\\temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    if (vpIoTools::checkDirectory(opath) == false)
+      vpIoTools::makeDirectory(opath);
+
+    const unsigned int h = 240, w = 320;
+    vpImage<unsigned char> G(h, w);
+    vpImage<vpRGBa> C(h, w);
+    for (unsigned int i = 0; i < h; i++)
+      for (unsigned int j = 0; j < w; j++) {
+        G[i][j] = (unsigned char)(i * 7 + j * 3);
+        C[i][j] = vpRGBa((unsigned char)i, (unsigned char)j,
+                         (unsigned char)(i + j), 0);
+      }
+
+    std::string pgm = opath + vpIoTools::path("/") + "testPNMReader.pgm";
+    std::string ppm = opath + vpIoTools::path("/") + "testPNMReader.ppm";
+    vpImageIo::writePGM(G, pgm);
+    vpImageIo::writePPM(C, ppm);
+
+    // Read back with vpImageIo
+    vpImage<unsigned char> G2;
+    vpImage<vpRGBa> C2;
+    vpImageIo::readPGM(G2, pgm);
+    vpImageIo::readPPM(C2, ppm);
+    if (! equal(G, G2) || ! equal(C, C2)) {
+      std::cout << "Bad image read by vpImageIo" << std::endl;
+      return -1;
+    }
+
+    // Conversions done by the reader
+    vpImage<unsigned char> Gref;
+    vpImage<vpRGBa> Cref;
+    vpImageConvert::convert(C, Gref);
+    vpImageConvert::convert(G, Cref);
+    vpImageIo::readPPM(G2, ppm);
+    vpImageIo::readPGM(C2, pgm);
+    if (! equal(Gref, G2) || ! equal(Cref, C2)) {
+      std::cout << "Bad converted image" << std::endl;
+      return -1;
+    }
+
+    // A PPM file is not a PGM file
+    try {
+      vpImageIo::readPGM(G2, ppm);
+      std::cout << "readPGM() accepted a PPM file" << std::endl;
+      return -1;
+    }
+    catch(vpImageException &) {
+    }
+
+    // Zero-copy view and header cache
+    vpPNMReader reader;
+    reader.open(pgm);
+    vpImage<unsigned char> V;
+    reader.view(V);
+    if (! V.isView() || ! equal(G, V)) {
+      std::cout << "Bad view on the PGM file" << std::endl;
+      return -1;
+    }
+    V[0][0] = 255 - V[0][0]; // Private mapping, the file is not modified
+    reader.open(pgm);
+    reader.read(G2);
+    if (! equal(G, G2) || (reader.getNbHeaderParses() != 1)) {
+      std::cout << "Bad header cache: " << reader.getNbHeaderParses()
+                << " parses" << std::endl;
+      return -1;
+    }
+    V.destroy();
+    reader.open(ppm);
+    if (! reader.isColor() || (reader.getNbHeaderParses() != 2)) {
+      std::cout << "The header of the PPM file was not parsed" << std::endl;
+      return -1;
+    }
+    try {
+      reader.view(V);
+      std::cout << "A PPM file was viewed as a grey level image" << std::endl;
+      return -1;
+    }
+    catch(vpImageException &) {
+    }
+
+    // Write a strided view, and read it in a strided view
+    vpImage<unsigned char> roi;
+    roi.initView(G, 10, 20, 100, 150);
+    vpImageIo::writePGM(roi, pgm);
+    vpImage<vpRGBa> croi;
+    croi.initView(C, 5, 7, 50, 60);
+    vpImageIo::writePPM(croi, ppm);
+    vpImage<unsigned char> Gbig(200, 300, 0), groi;
+    groi.initView(Gbig, 50, 60, 100, 150);
+    vpImageIo::readPGM(groi, pgm);
+    vpImageIo::readPPM(C2, ppm);
+    if (! equal(roi, groi) || ! equal(croi, C2) || (Gbig[49][60] != 0)) {
+      std::cout << "Bad strided image" << std::endl;
+      return -1;
+    }
+
+    // Header with comments and the size on two lines
+    std::string pnm = opath + vpIoTools::path("/") + "testPNMReader.pnm";
+    writeFile(pnm, std::string("P5\n# comment\n3\n# other\n2 255\n") + "abcdef");
+    reader.open(pnm);
+    reader.read(G2);
+    if ((G2.getWidth() != 3) || (G2.getHeight() != 2) || (G2[1][2] != 'f')) {
+      std::cout << "Bad header with comments" << std::endl;
+      return -1;
+    }
+
+    // Malformed files
+    writeFile(pnm, "P5\n3 2\n65535\nabcdefabcdef");
+    if (! openFails(reader, pnm)) {
+      std::cout << "A 16 bits file was accepted" << std::endl;
+      return -1;
+    }
+    writeFile(pnm, "P5\n3 2\n255\nabcde");
+    if (! openFails(reader, pnm)) {
+      std::cout << "A truncated file was accepted" << std::endl;
+      return -1;
+    }
+    writeFile(pnm, "P2\n3 2\n255\n1 2 3 4 5 6");
+    if (! openFails(reader, pnm)) {
+      std::cout << "An ASCII file was accepted" << std::endl;
+      return -1;
+    }
+    if (! openFails(reader, opath + vpIoTools::path("/") + "testPNMReader.none")) {
+      std::cout << "A missing file was accepted" << std::endl;
+      return -1;
+    }
+
+    // Timing on a VGA color sequence
+    vpImage<vpRGBa> Cvga(480, 640);
+    for (unsigned int i = 0; i < Cvga.getHeight(); i++)
+      for (unsigned int j = 0; j < Cvga.getWidth(); j++)
+        Cvga[i][j] = vpRGBa((unsigned char)(i ^ j), (unsigned char)j,
+                            (unsigned char)i, 0);
+    vpImageIo::writePPM(Cvga, ppm);
+    long offset = (long)std::string("P6\n640 480\n255\n").size();
+    const int nframes = 20;
+    C2.resize(Cvga.getHeight(), Cvga.getWidth());
+    double tOld = vpTime::measureTimeMs();
+    for (int k = 0; k < nframes; k++)
+      readPPMPerPixel(C2, ppm, offset);
+    tOld = vpTime::measureTimeMs() - tOld;
+    double tNew = vpTime::measureTimeMs();
+    for (int k = 0; k < nframes; k++) {
+      reader.open(ppm);
+      reader.read(C2);
+    }
+    tNew = vpTime::measureTimeMs() - tNew;
+    if (! equal(Cvga, C2)) {
+      std::cout << "Bad VGA image" << std::endl;
+      return -1;
+    }
+    std::cout << "640x480 PPM to RGBa: " << tNew / nframes << " ms (per-pixel fread: "
+              << tOld / nframes << " ms)" << std::endl;
+
+    vpImage<unsigned char> Gvga;
+    vpImageConvert::convert(Cvga, Gvga);
+    vpImageIo::writePGM(Gvga, pgm);
+    double tRead = vpTime::measureTimeMs();
+    for (int k = 0; k < nframes; k++)
+      vpImageIo::readPGM(G2, pgm);
+    tRead = vpTime::measureTimeMs() - tRead;
+    double tView = vpTime::measureTimeMs();
+    for (int k = 0; k < nframes; k++) {
+      reader.open(pgm);
+      reader.view(V);
+    }
+    tView = vpTime::measureTimeMs() - tView;
+    std::cout << "640x480 PGM: " << tRead / nframes << " ms with readPGM(), "
+              << tView / nframes << " ms with a view" << std::endl;
+    reader.close();
+    V.destroy();
+
+    remove(pgm.c_str());
+    remove(ppm.c_str());
+    remove(pnm.c_str());
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+
+  std::cout << "testPNMReader is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,227 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test and benchmark of the precomputed undistortion map.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testUndistortMap.cpp
+
+  \brief Compare vpImageUndistortMap with vpImageTools::undistort().
+
+  Undistort a synthetic image with both implementations, check that
+  the results are the same up to the fixed point rounding and print
+  the time spent by each of them.
+*/
+
+#include <visp/vpImage.h>
+#include <visp/vpRGBa.h>
+#include <visp/vpImageTools.h>
+#include <visp/vpImageUndistortMap.h>
+#include <visp/vpParseArgv.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+
+// List of allowed command line options
+#define GETOPTARGS	"n:t:h"
+
+/*!
+
+  Print the program options.
+
+*/
+void usage(const char *name, const char *badparam, unsigned int nbiter,
+           unsigned int nthreads)
+{
+  fprintf(stdout, "\n\
+Compare vpImageUndistortMap with vpImageTools::undistort().\n\
+\n\
+SYNOPSIS\n\
+  %s [-n <iterations>] [-t <threads>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -n <iterations>                                      %u\n\
+     Number of undistortions used for the time measure.\n\
+\n\
+  -t <threads>                                         %u\n\
+     Number of threads used by vpImageUndistortMap.\n\
+\n\
+  -h\n\
+     Print the help.\n", nbiter, nthreads);
+
+  if (badparam)
+    fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+}
+/*!
+
+  Set the program options.
+
+  \return false if the program has to be stopped, true otherwise.
+
+*/
+bool getOptions(int argc, const char **argv, unsigned int &nbiter,
+                unsigned int &nthreads)
+{
+  const char *optarg;
+  int	c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg)) > 1) {
+
+    switch (c) {
+    case 'n': nbiter = (unsigned int)atoi(optarg); break;
+    case 't': nthreads = (unsigned int)atoi(optarg); break;
+    case 'h': usage(argv[0], NULL, nbiter, nthreads); return false; break;
+
+    default:
+      usage(argv[0], optarg, nbiter, nthreads);
+      return false; break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, nbiter, nthreads);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, const char ** argv)
+{
+  unsigned int nbiter = 3;
+  unsigned int nthreads = 1;
+
+  // Read the command line options
+  if (getOptions(argc, argv, nbiter, nthreads) == false) {
+    exit (-1);
+  }
+
+  const unsigned int height = 960;
+  const unsigned int width = 1280;
+
+  vpImage<unsigned char> I(height, width);
+  vpImage<vpRGBa> Irgba(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      I[i][j] = (unsigned char)((i * 7 + j * 3 + (i*j) % 13) & 0xff);
+      Irgba[i][j] = vpRGBa((unsigned char)(j & 0xff), (unsigned char)(i & 0xff),
+                           (unsigned char)((i+j) & 0xff), 0);
+    }
+  }
+
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, width/2, height/2, -0.17, 0.17);
+
+  vpImage<unsigned char> U_ref, U;
+  vpImage<vpRGBa> Urgba_ref, Urgba;
+
+  double t = vpTime::measureTimeMs();
+  vpImageUndistortMap map(cam, height, width);
+  map.setNumberOfThreads(nthreads);
+  std::cout << "Time to build the map (ms): "
+            << vpTime::measureTimeMs() - t << std::endl;
+
+  // Check the grey level images. vpImageTools::undistort() truncates
+  // the two horizontal interpolations and the vertical one, while the
+  // map rounds the result, hence a tolerance of 3 grey levels.
+  vpImageTools::undistort(I, cam, U_ref);
+  map.undistort(I, U);
+  unsigned int nerr = 0;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      int d = (int)U[i][j] - (int)U_ref[i][j];
+      if (d > 3 || d < -3)
+        nerr ++;
+    }
+  }
+  if (nerr) {
+    std::cout << nerr << " grey level pixels differ (bad result)" << std::endl;
+    return -1;
+  }
+
+  // Check the color images
+  vpImageTools::undistort(Irgba, cam, Urgba_ref);
+  map.undistort(Irgba, Urgba);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      int dR = (int)Urgba[i][j].R - (int)Urgba_ref[i][j].R;
+      int dG = (int)Urgba[i][j].G - (int)Urgba_ref[i][j].G;
+      int dB = (int)Urgba[i][j].B - (int)Urgba_ref[i][j].B;
+      if (dR > 3 || dR < -3 || dG > 3 || dG < -3 || dB > 3 || dB < -3)
+        nerr ++;
+    }
+  }
+  if (nerr) {
+    std::cout << nerr << " color pixels differ (bad result)" << std::endl;
+    return -1;
+  }
+
+  // Benchmark
+  t = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbiter; n++)
+    vpImageTools::undistort(I, cam, U_ref);
+  double t_ref = vpTime::measureTimeMs() - t;
+
+  t = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbiter; n++)
+    map.undistort(I, U);
+  double t_map = vpTime::measureTimeMs() - t;
+
+  std::cout << "Grey " << width << "x" << height << " (ms/image): "
+            << "vpImageTools::undistort() " << t_ref / nbiter
+            << " - vpImageUndistortMap " << t_map / nbiter << std::endl;
+
+  t = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbiter; n++)
+    vpImageTools::undistort(Irgba, cam, Urgba_ref);
+  t_ref = vpTime::measureTimeMs() - t;
+
+  t = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbiter; n++)
+    map.undistort(Irgba, Urgba);
+  t_map = vpTime::measureTimeMs() - t;
+
+  std::cout << "Color " << width << "x" << height << " (ms/image): "
+            << "vpImageTools::undistort() " << t_ref / nbiter
+            << " - vpImageUndistortMap " << t_map / nbiter << std::endl;
+
+  return 0;
+}
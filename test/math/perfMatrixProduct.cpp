@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Measure the matrix products throughput.
+ *
+ *****************************************************************************/
+
+/*!
+  \example perfMatrixProduct.cpp
+
+  Measure the throughput in GFLOP/s of the products of square matrices
+  of several sizes and of AtA() for a tall matrix, with each
+  implementation of the matrix products supported by the machine.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+
+namespace {
+  const char *gemmNames[] = { "naive", "blocked", "AVX2", "BLAS" };
+  // Multiply-adds of each measure, so that the small sizes are repeated
+  const double opsPerMeasure = 3e7;
+
+  void randomize(vpMatrix &A)
+  {
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        A[i][j] = (double)rand() / RAND_MAX - 0.5;
+  }
+
+  // GFLOP/s of C = A * B, or of A^T * A when B is empty
+  double measure(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
+  {
+    bool atA = (B.getRows() == 0);
+    double ops = atA ? (double)A.getCols() * A.getCols() * A.getRows()
+      : (double)A.getRows() * B.getCols() * A.getCols();
+    unsigned int nruns = (unsigned int)(opsPerMeasure / ops) + 1;
+
+    if (atA) A.AtA(C); else vpMatrix::mult2Matrices(A, B, C); // warm up
+    double t0 = vpTime::measureTimeMs();
+    for (unsigned int r = 0; r < nruns; r++) {
+      if (atA) A.AtA(C); else vpMatrix::mult2Matrices(A, B, C);
+    }
+    double ms = vpTime::measureTimeMs() - t0;
+    return (ms > 0) ? 2. * ops * nruns / (ms * 1e6) : 0.;
+  }
+}
+
+int main()
+{
+  const unsigned int sizes[] = { 8, 16, 32, 64, 128, 256, 384 };
+  const unsigned int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+
+  printf("%-14s", "GFLOP/s");
+  for (int t = 0; t <= (int)vpMatrix::GEMM_BLAS; t++)
+    if (vpMatrix::isGemmTypeSupported((vpMatrix::vpGemmType)t))
+      printf("%10s", gemmNames[t]);
+  printf("\n");
+
+  for (unsigned int s = 0; s <= nsizes; s++) {
+    vpMatrix A, B, C;
+    char name[32];
+    if (s < nsizes) {
+      A.resize(sizes[s], sizes[s]);
+      B.resize(sizes[s], sizes[s]);
+      randomize(B);
+      sprintf(name, "%ux%u", sizes[s], sizes[s]);
+    }
+    else {
+      // Normal equations of a least squares problem
+      A.resize(4000, 30);
+      sprintf(name, "AtA 4000x30");
+    }
+    randomize(A);
+
+    printf("%-14s", name);
+    for (int t = 0; t <= (int)vpMatrix::GEMM_BLAS; t++) {
+      if (! vpMatrix::isGemmTypeSupported((vpMatrix::vpGemmType)t))
+        continue;
+      vpMatrix::setGemmType((vpMatrix::vpGemmType)t);
+      printf("%10.2f", measure(A, B, C));
+      fflush(stdout);
+    }
+    printf("\n");
+  }
+  vpMatrix::setGemmType(vpMatrix::getGemmSupport());
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the batched solver of 6x6 symmetric systems.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testBatchSolver.cpp
+
+  Checks the solutions of batches of well conditioned and rank deficient
+  6x6 symmetric systems computed by vpBatchSolver against
+  vpMatrix::pseudoInverse(), and the batched pose estimation by virtual
+  visual servoing against the pose estimated one by one.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpBatchSolver.h>
+#include <visp/vpPose.h>
+#include <visp/vpPoint.h>
+#include <visp/vpMath.h>
+#include <visp/vpHomogeneousMatrix.h>
+
+#include <iostream>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+  void randomize(vpMatrix &A)
+  {
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        A[i][j] = (double)rand() / RAND_MAX - 0.5;
+  }
+
+  // Random least squares problem whose jacobian has the given rank
+  void randomProblem(unsigned int rank, vpMatrix &J, vpColVector &e)
+  {
+    vpMatrix A(12, rank), B(rank, 6);
+    randomize(A);
+    randomize(B);
+    J = vpMatrix(A * B);
+    e.resize(12);
+    randomize(e);
+  }
+
+  bool near(const vpColVector &a, const vpColVector &b, double tolerance)
+  {
+    for (unsigned int i = 0; i < a.getRows(); i++)
+      if (fabs(a[i] - b[i]) > tolerance * (1 + fabs(b[i])))
+        return false;
+    return true;
+  }
+
+  bool testBatch(unsigned int n)
+  {
+    vpBatchSolver batch(n);
+    std::vector<vpMatrix> J(n);
+    std::vector<vpColVector> e(n);
+    std::vector<unsigned int> rank(n);
+    unsigned int nbDeficient = 0;
+    for (unsigned int k = 0; k < n; k++) {
+      // one system out of five is rank deficient
+      rank[k] = (k % 5 == 3) ? 1 + k % 5 : 6;
+      if (rank[k] < 6)
+        nbDeficient++;
+      randomProblem(rank[k], J[k], e[k]);
+      batch.setLeastSquares(k, J[k], e[k]);
+    }
+
+    unsigned int r = batch.solve();
+    if (r != nbDeficient) {
+      std::cout << r << " rank deficient systems instead of " << nbDeficient
+                << " in a batch of " << n << std::endl;
+      return false;
+    }
+
+    vpColVector x;
+    for (unsigned int k = 0; k < n; k++) {
+      if (batch.isRankDeficient(k) != (rank[k] < 6)) {
+        std::cout << "Bad rank deficiency of the system " << k
+                  << " in a batch of " << n << std::endl;
+        return false;
+      }
+      batch.getSolution(k, x);
+      vpColVector xp = vpMatrix(J[k].pseudoInverse(1e-6)) * e[k];
+      if (! near(x, xp, 1e-6)) {
+        std::cout << "Bad solution of the system " << k << " of rank "
+                  << rank[k] << " in a batch of " << n << std::endl;
+        return false;
+      }
+    }
+
+    // solving the systems again gives the same solutions
+    for (unsigned int k = 0; k < n; k++)
+      batch.setLeastSquares(k, J[k], e[k]);
+    batch.solve();
+    for (unsigned int k = 0; k < n; k++) {
+      batch.getSolution(k, x);
+      vpColVector xp = vpMatrix(J[k].pseudoInverse(1e-6)) * e[k];
+      if (! near(x, xp, 1e-6)) {
+        std::cout << "Bad solution of the system " << k
+                  << " solved twice in a batch of " << n << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool testPose()
+  {
+    const unsigned int n = 5;
+    const double L = 0.035;
+    std::vector<vpPose *> poses(n);
+    std::vector<vpHomogeneousMatrix> cMo(n), cMoRef(n);
+    for (unsigned int i = 0; i < n; i++) {
+      vpHomogeneousMatrix cMoTrue(0.01 * i, -0.02, 0.3 + 0.05 * i,
+                                  vpMath::rad(10. * i), vpMath::rad(5), 0);
+      poses[i] = new vpPose;
+      for (unsigned int k = 0; k < 5; k++) {
+        vpPoint P;
+        P.setWorldCoordinates((k == 1 || k == 2) ? L : -L,
+                              (k == 2 || k == 3) ? L : -L,
+                              (k == 4) ? L : 0);
+        P.project(cMoTrue);
+        poses[i]->addPoint(P);
+      }
+      // initial poses close to the true ones
+      cMo[i] = vpHomogeneousMatrix(0.01 * i + 0.005, -0.01, 0.32 + 0.05 * i,
+                                   vpMath::rad(10. * i + 3), vpMath::rad(2), 0);
+      cMoRef[i] = cMo[i];
+      poses[i]->poseVirtualVS(cMoRef[i]);
+    }
+
+    vpPose::poseVirtualVS(poses, cMo);
+
+    bool ok = true;
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int j = 0; j < 3; j++)
+        for (unsigned int k = 0; k < 4; k++)
+          if (fabs(cMo[i][j][k] - cMoRef[i][j][k]) > 1e-6)
+            ok = false;
+      delete poses[i];
+    }
+    if (! ok)
+      std::cout << "Bad batched pose estimation" << std::endl;
+    return ok;
+  }
+}
+
+int main()
+{
+  unsigned int sizes[] = { 1, 3, 7, 100 };
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    if (! testBatch(sizes[i]))
+      return -1;
+  if (! testPose())
+    return -1;
+  std::cout << "Batch solver is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
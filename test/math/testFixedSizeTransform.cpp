@@ -0,0 +1,240 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the transformations stored in a vpMatrixFixedStorage.
+ *
+ *****************************************************************************/
+
+
+/*!
+  \example testFixedSizeTransform.cpp
+
+  Checks that the products and inverses of homogeneous, rotation and
+  twist matrices computed on their fixed size storage match the
+  generic vpMatrix ones, that their copies are independent, and that
+  they can still be resized as a vpMatrix.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpColVector.h>
+#include <visp/vpForceTwistMatrix.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpPoseVector.h>
+#include <visp/vpRotationMatrix.h>
+#include <visp/vpThetaUVector.h>
+#include <visp/vpTime.h>
+#include <visp/vpTranslationVector.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+namespace {
+  bool equal(const vpMatrix &A, const vpMatrix &B, const char *what)
+  {
+    bool ok = (A.getRows() == B.getRows()) && (A.getCols() == B.getCols());
+    for (unsigned int i = 0; ok && (i < A.getRows()); i++)
+      for (unsigned int j = 0; ok && (j < A.getCols()); j++)
+        ok = fabs(A[i][j] - B[i][j]) < 1e-12;
+    if (! ok)
+      std::cout << "Bad " << what << ":" << std::endl << A << std::endl
+                << "instead of" << std::endl << B << std::endl;
+    return ok;
+  }
+
+  // Generic product through a vpMatrix stored on the heap
+  vpMatrix mult(const vpMatrix &A, const vpMatrix &B)
+  {
+    vpMatrix a(A), b(B);
+    return a * b;
+  }
+
+  bool testProducts()
+  {
+    vpHomogeneousMatrix aMb(0.1, -0.2, 0.3, 0.4, -0.5, 0.6);
+    vpHomogeneousMatrix bMc(-1.2, 0.7, 2.1, -0.3, 0.2, 1.1);
+
+    vpHomogeneousMatrix aMc = aMb * bMc;
+    if (! equal(aMc, mult(aMb, bMc), "homogeneous product"))
+      return false;
+
+    vpColVector v(4);
+    v[0] = 1; v[1] = -2; v[2] = 3; v[3] = 1;
+    if (! equal(aMb * v, mult(aMb, v), "homogeneous matrix vector product"))
+      return false;
+
+    vpHomogeneousMatrix bMa = aMb.inverse();
+    if (! equal(bMa, aMb.pseudoInverse(), "homogeneous inverse"))
+      return false;
+    vpHomogeneousMatrix M = aMb;
+    M.inverse(M);
+    if (! equal(M, bMa, "homogeneous inverse in place")
+        || ! equal(aMb * bMa, vpHomogeneousMatrix(), "product by the inverse"))
+      return false;
+
+    vpRotationMatrix R1, R2;
+    aMb.extract(R1);
+    bMc.extract(R2);
+    if (! equal(R1 * R2, mult(R1, R2), "rotation product"))
+      return false;
+    vpTranslationVector t(0.5, -1, 2);
+    if (! equal(R1 * t, mult(R1, t), "rotation translation product")
+        || ! equal(R1 * (vpColVector)t, mult(R1, t), "rotation vector product"))
+      return false;
+
+    vpVelocityTwistMatrix V1(aMb), V2(bMc);
+    if (! equal(V1 * V2, mult(V1, V2), "velocity twist product"))
+      return false;
+    // The twist of a product is the product of the twists
+    if (! equal(vpVelocityTwistMatrix(aMc), V1 * V2, "velocity twist"))
+      return false;
+    vpColVector w(6);
+    for (unsigned int i = 0; i < 6; i++)
+      w[i] = i - 2.5;
+    if (! equal(V1 * w, mult(V1, w), "velocity twist vector product"))
+      return false;
+
+    vpForceTwistMatrix F1(aMb), F2(bMc);
+    if (! equal(F1 * F2, mult(F1, F2), "force twist product")
+        || ! equal(vpForceTwistMatrix(aMc), F1 * F2, "force twist")
+        || ! equal(F1 * w, mult(F1, w), "force twist vector product"))
+      return false;
+    return true;
+  }
+
+  bool testStorage()
+  {
+    // Copies use their own storage
+    vpHomogeneousMatrix M1(0.1, 0.2, 0.3, 0.1, 0.2, 0.3);
+    vpHomogeneousMatrix M2(M1);
+    M2[0][3] = 5;
+    if (M1[0][3] != 0.1) {
+      std::cout << "The copy of an homogeneous matrix shares its elements" << std::endl;
+      return false;
+    }
+    std::vector<vpHomogeneousMatrix> list(3, M1);
+    list[1][2][3] = 7;
+    if ((list[0][2][3] != 0.3) || (list[2][2][3] != 0.3)
+        || (&list[1][0][0] == &list[0][0][0])) {
+      std::cout << "The copies in a vector share their elements" << std::endl;
+      return false;
+    }
+
+    vpTranslationVector t1(1, 2, 3), t2(t1);
+    t2[0] = 4;
+    vpPoseVector p1(1, 2, 3, 0.1, 0.2, 0.3), p2(p1);
+    p2[5] = 4;
+    vpThetaUVector tu1(0.1, 0.2, 0.3), tu2(tu1);
+    tu2[0] = 4;
+    if ((t1[0] != 1) || (p1[5] != 0.3) || (tu1[0] != 0.1) || (t2[1] != 2)
+        || (p2[4] != 0.2) || (tu2[2] != 0.3)) {
+      std::cout << "The copy of a vector shares its elements" << std::endl;
+      return false;
+    }
+
+    // Resizing to another size moves the elements to the heap
+    vpColVector &v = t1;
+    v.resize(5, false);
+    v[4] = 8;
+    if ((t1.getRows() != 5) || (t1[2] != 3) || (t1[4] != 8)) {
+      std::cout << "Bad resize of a translation vector" << std::endl;
+      return false;
+    }
+    t1 = t2;
+    if ((t1.getRows() != 3) || (t1[0] != 4)) {
+      std::cout << "Bad copy in a resized translation vector" << std::endl;
+      return false;
+    }
+    vpMatrix &A = M2;
+    A.resize(2, 2);
+    M2.setIdentity();
+    M2 = M1;
+    if ((M2.getRows() != 4) || ! equal(M2, M1, "copy in a resized matrix"))
+      return false;
+
+    // Boundaries with vpMatrix
+    vpMatrix B = M1;
+    B[0][0] = 9;
+    if (M1[0][0] == 9) {
+      std::cout << "A vpMatrix copy shares the elements" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  void benchmark()
+  {
+    vpHomogeneousMatrix aMb(0.1, -0.2, 0.3, 0.4, -0.5, 0.6);
+    vpHomogeneousMatrix bMc(-1.2, 0.7, 2.1, -0.3, 0.2, 1.1);
+    vpMatrix A = aMb, B = bMc, C;
+    const unsigned int n = 100000;
+
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < n; i++)
+      C = A * B;
+    double tMatrix = vpTime::measureTimeMs() - t;
+
+    vpHomogeneousMatrix aMc;
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < n; i++)
+      aMc = aMb * bMc;
+    double tHomogeneous = vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < n; i++)
+      aMc = aMb.inverse();
+    double tInverse = vpTime::measureTimeMs() - t;
+
+    std::cout << n << " 4x4 products: " << tMatrix << " ms with vpMatrix, "
+              << tHomogeneous << " ms with vpHomogeneousMatrix" << std::endl;
+    std::cout << n << " homogeneous inverses: " << tInverse << " ms" << std::endl;
+  }
+}
+
+int main()
+{
+  if (! testProducts() || ! testStorage())
+    return -1;
+  benchmark();
+  std::cout << "Fixed size transformations are ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
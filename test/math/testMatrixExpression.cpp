@@ -0,0 +1,278 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the lazy expressions on matrices and vectors.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMatrixExpression.cpp
+
+  Checks that the expressions built by the arithmetic operators of
+  vpMatrix, vpColVector and vpRowVector give the same values as the
+  eager functions, including when the result is one of the operands,
+  that the usual member functions can be called on an expression, that
+  large expressions need as many temporaries as necessary, and that evaluating the same expressions in a loop doesn't allocate
+  temporaries after the first iteration.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpRowVector.h>
+
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+  void randomize(vpMatrix &A)
+  {
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        A[i][j] = (double)rand() / RAND_MAX - 0.5;
+  }
+
+  bool equal(const vpMatrix &A, const vpMatrix &B, const char *what)
+  {
+    bool ok = (A.getRows() == B.getRows()) && (A.getCols() == B.getCols());
+    for (unsigned int i = 0; ok && (i < A.getRows()); i++)
+      for (unsigned int j = 0; ok && (j < A.getCols()); j++)
+        ok = fabs(A[i][j] - B[i][j]) < 1e-12;
+    if (! ok)
+      std::cout << "Bad " << what << std::endl;
+    return ok;
+  }
+
+  bool testValues()
+  {
+    vpMatrix A(5, 4), B(5, 4), C(4, 6), D(6, 3), R, T;
+    vpColVector a(4), b(4), x(3);
+    randomize(A); randomize(B); randomize(C); randomize(D);
+    randomize(a); randomize(b); randomize(x);
+
+    // Linear combinations
+    vpMatrix E = 2*A - B/4 + (-A);
+    vpMatrix::add2WeightedMatrices(A, 1., B, -0.25, R);
+    if (! equal(E, R, "linear combination"))
+      return false;
+
+    // Chain of products, whatever the order of evaluation
+    E = A*C*D*x;
+    vpMatrix::mult2Matrices(A, C, R);
+    vpMatrix::mult2Matrices(R, D, T);
+    vpMatrix::mult2Matrices(T, x, R);
+    if (! equal(E, R, "chain of products"))
+      return false;
+    vpColVector v = 3*(A*C*D)*x;
+    if (! equal(v, R*3, "scaled chain of products"))
+      return false;
+
+    // Products of sums
+    E = (A + B)*(C*D);
+    vpMatrix::add2Matrices(A, B, T);
+    vpMatrix::mult2Matrices(C, D, R);
+    vpMatrix::mult2Matrices(T, R, T);
+    if (! equal(E, T, "product of sums"))
+      return false;
+    E = A - B*(C*D)*(D.t()*C.t());
+    vpMatrix::mult2Matrices(R, R.t(), T);
+    vpMatrix::mult2Matrices(B, T, T);
+    vpMatrix::sub2Matrices(A, T, T);
+    if (! equal(E, T, "sum of products"))
+      return false;
+
+    // Vectors
+    vpColVector c = a + 2*b;
+    for (unsigned int i = 0; i < 4; i++)
+      if (fabs(c[i] - (a[i] + 2*b[i])) > 1e-12) {
+        std::cout << "Bad sum of vectors" << std::endl;
+        return false;
+      }
+    double s = a.t()*b, sref = vpColVector::dotProd(a, b);
+    double t = a.t()*(A.t()*B)*b;
+    vpMatrix::mult2Matrices(A.t(), B, T);
+    vpColVector Tb = T*b;
+    if ((fabs(s - sref) > 1e-12) || (fabs(t - vpColVector::dotProd(a, Tb)) > 1e-12)) {
+      std::cout << "Bad dot product" << std::endl;
+      return false;
+    }
+    vpRowVector r = a.t()*C;
+    vpMatrix::mult2Matrices(a.t(), C, T);
+    return equal(r, T, "row vector product");
+  }
+
+  bool testAliasing()
+  {
+    vpMatrix A(6, 6), B(6, 6), R;
+    vpColVector a(6), b(6), r;
+    randomize(A); randomize(B); randomize(a); randomize(b);
+
+    vpMatrix::sub2Matrices(B, A, R);
+    A = B - A;
+    if (! equal(A, R, "difference in place"))
+      return false;
+    vpMatrix::mult2Matrices(A, B, R);
+    A = A*B;
+    if (! equal(A, R, "product in place"))
+      return false;
+    vpMatrix::mult2Matrices(B, A, R);
+    vpMatrix::mult2Matrices(R, B, R);
+    A = B*A*B;
+    if (! equal(A, R, "chain of products in place"))
+      return false;
+    vpMatrix::mult2Matrices(A, a, r);
+    a = A*a - b;
+    vpMatrix::sub2Matrices(r, b, r);
+    return equal(a, r, "vector in place");
+  }
+
+  bool testErrors()
+  {
+    vpMatrix A(3, 4), B(3, 4);
+    vpColVector a(3);
+    int nerrors = 0;
+    try { vpMatrix C = A*B; } catch(vpMatrixException &) { nerrors++; }
+    try { vpMatrix C = A + A.t(); } catch(vpMatrixException &) { nerrors++; }
+    try { vpColVector c; c = A*B.t(); } catch(vpException &) { nerrors++; }
+    try { vpMatrix C = A/0.; } catch(vpMatrixException &) { nerrors++; }
+    try { vpRowVector r = a.t()*B.t(); } catch(vpMatrixException &) { nerrors++; }
+    if (nerrors != 5) {
+      std::cout << "Missing exceptions: " << 5 - nerrors << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Member functions called on an expression
+  bool testMembers()
+  {
+    vpMatrix A(5, 4), C(4, 6), R, T;
+    vpColVector a(4), b(4);
+    randomize(A); randomize(C); randomize(a); randomize(b);
+
+    vpMatrix::mult2Matrices(A, C, R);
+    if (! equal((A*C).t(), R.t(), "transpose of a product")
+        || ! equal((A*C).pseudoInverse(), R.pseudoInverse(), "pseudo inverse of a product"))
+      return false;
+    vpMatrix Ap;
+    vpColVector sv;
+    if (((A*C).pseudoInverse(Ap, 1e-6) != R.pseudoInverse(T, 1e-6))
+        || ! equal(Ap, T, "pseudo inverse of a product in a matrix")
+        || ((A*C).pseudoInverse(Ap, sv, 1e-6) != R.pseudoInverse(T, 1e-6))
+        || ! equal(Ap, T, "pseudo inverse of a product and its singular values"))
+      return false;
+    vpMatrix::add2Matrices(a, b, T);
+    vpRowVector r = (a + b).t();
+    if (! equal(r, T.t(), "transpose of a sum"))
+      return false;
+    vpColVector d = a - b;
+    if ((fabs((a - b).sumSquare() - d.sumSquare()) > 1e-12)
+        || (fabs((a - b).euclideanNorm() - d.euclideanNorm()) > 1e-12)
+        || (fabs((A*C).infinityNorm() - R.infinityNorm()) > 1e-12)
+        || ((A*C)[2][3] != R[2][3]) || ((a - b)[1] != d[1])) {
+      std::cout << "Bad member of an expression" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Expressions needing more temporaries than a workspace holds locally
+  bool testLargeExpressions()
+  {
+    vpMatrix A(3, 3), B(3, 3), E, R, T;
+    randomize(A); randomize(B);
+
+    // 17 products, each evaluated in a temporary
+    E = A*B + A*B + A*B + A*B + A*B + A*B + A*B + A*B + A*B
+      + A*B + A*B + A*B + A*B + A*B + A*B + A*B + A*B;
+    vpMatrix::mult2Matrices(A, B, T);
+    if (! equal(E, T*17, "sum of 17 products"))
+      return false;
+
+    // 25 factors, partially evaluated every vpMatrixChain::MAX_FACTORS
+    E = A*B*A*B*A*B*A*B*A*B*A*B*A*B*A*B*A*B*A*B*A*B*A*B*A;
+    R = A;
+    for (unsigned int i = 0; i < 12; i++) {
+      vpMatrix::mult2Matrices(R, T, R);
+    }
+    return equal(E, R, "chain of 25 factors");
+  }
+
+  // Evaluation of a control law at each iteration of a loop
+  bool testReuse()
+  {
+    vpMatrix L(8, 6), cVa(6, 6), aJe(6, 6), J1(8, 6), Lp(6, 8);
+    vpColVector e(8), v;
+    randomize(L); randomize(cVa); randomize(aJe); randomize(Lp); randomize(e);
+    double lambda = 0.5;
+
+    const double *J1data = J1.data;
+    for (unsigned int iter = 0; iter < 10; iter++) {
+      if (iter == 1)
+        vpMatrixWorkspace::resetCounters();
+      J1 = L*cVa*aJe;
+      v = -lambda*Lp*e;
+      e = e - 0.01*(L*v);
+    }
+    if (J1.data != J1data) {
+      std::cout << "The result was reallocated" << std::endl;
+      return false;
+    }
+    if (vpMatrixWorkspace::getNbAllocations() != 0) {
+      std::cout << vpMatrixWorkspace::getNbAllocations()
+                << " temporaries allocated after the first iteration" << std::endl;
+      return false;
+    }
+    std::cout << vpMatrixWorkspace::getNbReuses() << " temporaries reused"
+              << std::endl;
+    return true;
+  }
+}
+
+int main()
+{
+  if (! testValues() || ! testAliasing() || ! testErrors() || ! testMembers()
+      || ! testLargeExpressions() || ! testReuse())
+    return -1;
+  vpMatrixWorkspace::clearPool();
+  std::cout << "Matrix expressions are ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
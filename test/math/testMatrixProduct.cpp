@@ -0,0 +1,263 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the blocked matrix products.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMatrixProduct.cpp
+
+  Checks that the matrix products, AtA(), AAt() and the matrix-vector
+  products computed by each implementation supported by the machine
+  (blocked kernels, BLAS, several threads) match the original loops,
+  including the matrices whose sizes are not a multiple of the blocks
+  and the sub-matrices whose rows are not contiguous.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpSubMatrix.h>
+#include <visp/vpSubColVector.h>
+
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+  const char *gemmNames[] = { "naive", "blocked", "AVX2", "BLAS" };
+
+  void randomize(vpMatrix &A)
+  {
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        A[i][j] = (double)rand() / RAND_MAX - 0.5;
+  }
+
+  // The sums of k terms of the implementations only differ by rounding
+  bool equal(const vpMatrix &A, const vpMatrix &B, unsigned int k,
+             const char *what, vpMatrix::vpGemmType type)
+  {
+    bool ok = (A.getRows() == B.getRows()) && (A.getCols() == B.getCols());
+    double tolerance = 1e-14 * (k + 1);
+    for (unsigned int i = 0; ok && (i < A.getRows()); i++)
+      for (unsigned int j = 0; ok && (j < A.getCols()); j++)
+        ok = fabs(A[i][j] - B[i][j]) < tolerance;
+    if (! ok)
+      std::cout << "Bad " << what << " of size " << A.getRows() << "x"
+                << A.getCols() << " with the " << gemmNames[type]
+                << " implementation" << std::endl;
+    return ok;
+  }
+
+  bool testSizes(vpMatrix::vpGemmType type, unsigned int m, unsigned int k,
+                 unsigned int n)
+  {
+    vpMatrix A(m, k), B(k, n), C, Cref, S, Sref;
+    vpColVector b(k), c, cref;
+    randomize(A);
+    randomize(B);
+    for (unsigned int i = 0; i < k; i++)
+      b[i] = (double)rand() / RAND_MAX - 0.5;
+
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    vpMatrix::mult2Matrices(A, B, Cref);
+    vpMatrix::multMatrixVector(A, b, cref);
+    vpMatrix::setGemmType(type);
+    vpMatrix::mult2Matrices(A, B, C);
+    vpMatrix::multMatrixVector(A, b, c);
+    if (! equal(C, Cref, k, "product", type)
+        || ! equal(c, cref, k, "matrix vector product", type))
+      return false;
+
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    A.AtA(Sref);
+    vpMatrix::setGemmType(type);
+    A.AtA(S);
+    if (! equal(S, Sref, m, "AtA", type))
+      return false;
+
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    A.AAt(Sref);
+    vpMatrix::setGemmType(type);
+    A.AAt(S);
+    if (! equal(S, Sref, k, "AAt", type))
+      return false;
+
+    for (unsigned int i = 0; i < S.getRows(); i++)
+      for (unsigned int j = 0; j < i; j++)
+        if (S[i][j] != S[j][i]) {
+          std::cout << "AAt is not symmetric" << std::endl;
+          return false;
+        }
+    return true;
+  }
+
+  bool testImplementation(vpMatrix::vpGemmType type)
+  {
+    // Sizes around the 6x8 tiles and the 96x256x2048 blocks
+    const unsigned int sizes[][3] = {
+      { 1, 1, 1 }, { 6, 6, 6 }, { 24, 24, 24 }, { 25, 31, 17 },
+      { 97, 257, 9 }, { 200, 300, 100 }, { 3000, 40, 30 }, { 30, 2000, 30 },
+      { 13, 600, 2100 }
+    };
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+      if (! testSizes(type, sizes[s][0], sizes[s][1], sizes[s][2]))
+        return false;
+    return true;
+  }
+
+  // Compact copy of the elements of a matrix
+  vpMatrix copy(const vpMatrix &A)
+  {
+    vpMatrix C(A.getRows(), A.getCols());
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        C[i][j] = A[i][j];
+    return C;
+  }
+
+  // Operands and results that are parts of larger matrices
+  bool testSubMatrices(vpMatrix::vpGemmType type)
+  {
+    vpMatrix PA(40, 40), PB(40, 40), PC(40, 40), C, S, Ref;
+    randomize(PA);
+    randomize(PB);
+    vpSubMatrix A(PA, 3, 5, 30, 30), B(PB, 7, 2, 30, 30), Cs(PC, 4, 6, 30, 30);
+    vpMatrix Ac = copy(A), Bc = copy(B);
+
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    vpMatrix::mult2Matrices(Ac, Bc, Ref);
+    vpMatrix::setGemmType(type);
+    vpMatrix::mult2Matrices(A, B, C);
+    vpMatrix::mult2Matrices(A, B, Cs);
+    if (! equal(C, Ref, 30, "product of sub-matrices", type)
+        || ! equal(copy(Cs), Ref, 30, "product in a sub-matrix", type))
+      return false;
+
+    vpColVector pb(40), c, cref;
+    randomize(pb);
+    vpSubColVector b(pb, 6, 30);
+    vpColVector bc(30);
+    for (unsigned int i = 0; i < 30; i++)
+      bc[i] = b[i];
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    vpMatrix::multMatrixVector(Ac, bc, cref);
+    vpMatrix::setGemmType(type);
+    vpMatrix::multMatrixVector(A, bc, c);
+    if (! equal(c, cref, 30, "sub-matrix vector product", type))
+      return false;
+    vpMatrix::multMatrixVector(Ac, b, c);
+    if (! equal(c, cref, 30, "product by a sub-vector", type))
+      return false;
+
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    Ac.AAt(Ref);
+    vpMatrix::setGemmType(type);
+    A.AAt(S);
+    if (! equal(S, Ref, 30, "AAt of a sub-matrix", type))
+      return false;
+
+    vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+    Ac.AtA(Ref);
+    vpMatrix::setGemmType(type);
+    A.AtA(S);
+    return equal(S, Ref, 30, "AtA of a sub-matrix", type);
+  }
+
+  bool testAliasing()
+  {
+    vpMatrix A(40, 40), B(40, 40), C;
+    randomize(A);
+    randomize(B);
+    vpMatrix::mult2Matrices(A, B, C);
+    vpMatrix::mult2Matrices(A, B, A);
+    if (! equal(A, C, 40, "product in place", vpMatrix::getGemmType()))
+      return false;
+    vpMatrix::mult2Matrices(B, B, C);
+    vpMatrix::mult2Matrices(B, B, B);
+    if (! equal(B, C, 40, "square in place", vpMatrix::getGemmType()))
+      return false;
+    A.AtA(C);
+    A.AtA(A);
+    return equal(A, C, 40, "AtA in place", vpMatrix::getGemmType());
+  }
+
+  bool testMismatch()
+  {
+    vpMatrix A(3, 4), B(3, 4), C;
+    try {
+      vpMatrix::mult2Matrices(A, B, C);
+    }
+    catch(...) {
+      return true;
+    }
+    std::cout << "No exception for a size mismatch" << std::endl;
+    return false;
+  }
+}
+
+int main()
+{
+  for (int type = (int)vpMatrix::GEMM_BLOCKED; type <= (int)vpMatrix::GEMM_BLAS; type++) {
+    if (! vpMatrix::isGemmTypeSupported((vpMatrix::vpGemmType)type))
+      continue;
+    if (! testImplementation((vpMatrix::vpGemmType)type)
+        || ! testSubMatrices((vpMatrix::vpGemmType)type))
+      return -1;
+    std::cout << "The " << gemmNames[type] << " products are ok" << std::endl;
+  }
+
+#ifdef VISP_HAVE_OPENMP
+  // Row blocks and inner dimension slices shared between threads
+  vpMatrix::setNumberOfThreads(3);
+  if (! testImplementation(vpMatrix::getGemmSupport()))
+    return -1;
+  vpMatrix::setNumberOfThreads(1);
+  std::cout << "The multithreaded products are ok" << std::endl;
+#endif
+
+  vpMatrix::setGemmType(vpMatrix::getGemmSupport());
+  if (! testAliasing() || ! testMismatch())
+    return -1;
+  std::cout << "Matrix products are ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the singular value decomposition solver.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testSvdSolver.cpp
+
+  Checks the pseudo inverses, singular values, images and kernels
+  computed by vpSvdSolver with each method against the Moore-Penrose
+  conditions and vpMatrix::pseudoInverse(), and that repeated
+  decompositions of matrices of the same size don't allocate memory.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpColVector.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpSvdSolver.h>
+
+#include <iostream>
+#include <new>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+  unsigned long nbAllocations = 0;
+}
+
+// Count the allocations done with new, such as the buffers of Lapack.
+// The elements of vpMatrix are allocated with malloc and realloc: their
+// reallocation is detected by comparing the data pointers
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+  nbAllocations++;
+  void *p = malloc(size ? size : 1);
+  if (p == NULL)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+  return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+  free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+  free(p);
+}
+
+namespace {
+  const char *methodNames[] = { "auto", "Jacobi", "default" };
+
+  void randomize(vpMatrix &A)
+  {
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        A[i][j] = (double)rand() / RAND_MAX - 0.5;
+  }
+
+  // Random matrix of the given rank
+  vpMatrix randomMatrix(unsigned int rows, unsigned int cols, unsigned int rank)
+  {
+    vpMatrix A(rows, rank), B(rank, cols);
+    randomize(A);
+    randomize(B);
+    return A * B;
+  }
+
+  bool small(const vpMatrix &A, double tolerance)
+  {
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        if (fabs(A[i][j]) > tolerance)
+          return false;
+    return true;
+  }
+
+  bool error(const char *what, const vpMatrix &A, vpSvdSolver::vpSvdMethod method)
+  {
+    std::cout << "Bad " << what << " of a " << A.getRows() << "x"
+              << A.getCols() << " matrix with the " << methodNames[method]
+              << " method" << std::endl;
+    return false;
+  }
+
+  bool testMatrix(const vpMatrix &A, unsigned int rank,
+                  vpSvdSolver::vpSvdMethod method)
+  {
+    vpSvdSolver solver;
+    solver.setMethod(method);
+    vpMatrix Ap, imA, imAt, kerA, U, V, I;
+    vpColVector sv, w;
+    unsigned int r = solver.pseudoInverse(A, Ap, sv, 1e-6, imA, imAt, kerA);
+    double tolerance = 1e-9;
+
+    if (r != rank)
+      return error("rank", A, method);
+
+    // Moore-Penrose conditions
+    vpMatrix ApA = Ap * A, AAp = A * Ap;
+    if (! small(A * ApA - A, tolerance) || ! small(ApA * Ap - Ap, tolerance)
+        || ! small(ApA - ApA.t(), tolerance) || ! small(AAp - AAp.t(), tolerance))
+      return error("pseudo inverse", A, method);
+
+    vpMatrix Apref;
+    A.pseudoInverse(Apref, 1e-6);
+    if (! small(Ap - Apref, tolerance))
+      return error("pseudo inverse compared to vpMatrix", A, method);
+
+    for (unsigned int k = 0; k + 1 < sv.getRows(); k++)
+      if (sv[k] < sv[k+1])
+        return error("order of the singular values", A, method);
+
+    // Orthonormal bases of the images and of the kernel
+    I.eye(rank);
+    if ((imA.getRows() != A.getRows()) || (imAt.getRows() != A.getCols())
+        || (imA.getCols() != rank) || (imAt.getCols() != rank)
+        || ! small(imA.t() * imA - I, tolerance) || ! small(imAt.t() * imAt - I, tolerance)
+        || ! small(AAp * imA - imA, tolerance) || ! small(ApA * imAt - imAt, tolerance))
+      return error("images", A, method);
+    I.eye(A.getCols() - rank);
+    if ((kerA.getRows() != A.getCols() - rank) || (kerA.getCols() != A.getCols())
+        || ! small(A * kerA.t(), tolerance) || ! small(kerA * kerA.t() - I, tolerance))
+      return error("kernel", A, method);
+
+    // Reconstruction from the decomposition
+    solver.svd(A, U, w, V);
+    vpMatrix S;
+    S.diag(w);
+    if (! small(U * S * V.t() - A, tolerance) || ! small(w - sv, tolerance))
+      return error("decomposition", A, method);
+
+    vpSvdSolver::vpSvdMethod expected = method;
+    if (method == vpSvdSolver::SVD_AUTO) {
+      unsigned int size = (A.getRows() < A.getCols()) ? A.getRows() : A.getCols();
+      expected = (size <= vpSvdSolver::JACOBI_MAX_SIZE) ? vpSvdSolver::SVD_JACOBI
+                                                       : vpSvdSolver::SVD_DEFAULT;
+    }
+    if (solver.getLastMethod() != expected)
+      return error("method", A, method);
+    return true;
+  }
+
+  bool testMethod(vpSvdSolver::vpSvdMethod method)
+  {
+    const unsigned int sizes[][3] = {
+      { 1, 1, 1 }, { 3, 3, 3 }, { 8, 6, 6 }, { 6, 8, 6 }, { 24, 6, 6 },
+      { 8, 8, 8 }, { 20, 6, 4 }, { 6, 20, 5 }, { 9, 9, 7 }, { 40, 25, 25 },
+      { 25, 40, 18 }
+    };
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+      if (! testMatrix(randomMatrix(sizes[s][0], sizes[s][1], sizes[s][2]),
+                       sizes[s][2], method))
+        return false;
+    return true;
+  }
+
+  // Control loop with a 12x6 interaction matrix
+  bool testAllocations(vpSvdSolver::vpSvdMethod method)
+  {
+    vpMatrix L(12, 6), Lp, imL, imLt;
+    vpColVector sv;
+    randomize(L);
+    vpSvdSolver solver(12, 6);
+    solver.setMethod(method);
+    solver.pseudoInverse(L, Lp, sv, 1e-6, imL, imLt);
+
+    unsigned long n = nbAllocations;
+    const double *Lpdata = Lp.data, *svdata = sv.data;
+    const double *imLdata = imL.data, *imLtdata = imLt.data;
+    for (unsigned int iter = 0; iter < 100; iter++) {
+      L[iter % 12][iter % 6] += 0.01;
+      solver.pseudoInverse(L, Lp, sv, 1e-6, imL, imLt);
+      if ((Lp.data != Lpdata) || (sv.data != svdata)
+          || (imL.data != imLdata) || (imLt.data != imLtdata)) {
+        std::cout << "Results reallocated with the " << methodNames[method]
+                  << " method" << std::endl;
+        return false;
+      }
+    }
+    if (nbAllocations != n) {
+      std::cout << nbAllocations - n << " allocations with the "
+                << methodNames[method] << " method" << std::endl;
+      return false;
+    }
+    std::cout << "12x6 pseudo inverse with the " << methodNames[method]
+              << " method: " << solver.getMeanTime() * 1000 << " us"
+              << std::endl;
+    return true;
+  }
+}
+
+int main()
+{
+  for (int method = (int)vpSvdSolver::SVD_AUTO; method <= (int)vpSvdSolver::SVD_DEFAULT; method++)
+    if (! testMethod((vpSvdSolver::vpSvdMethod)method))
+      return -1;
+  if (! testAllocations(vpSvdSolver::SVD_JACOBI))
+    return -1;
+#ifdef VISP_HAVE_LAPACK
+  if (! testAllocations(vpSvdSolver::SVD_DEFAULT))
+    return -1;
+#endif
+  std::cout << "SVD solver is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
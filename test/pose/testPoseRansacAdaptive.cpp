@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Compare the Ransac algorithms available to compute a pose.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPoseRansacAdaptive.cpp
+
+  Compute the pose of a 3D object from points corrupted by outliers with
+  the standard, adaptive and PROSAC Ransac algorithms of vpPose, and check
+  that the adaptive algorithms report a consensus that is not reached.
+*/
+
+#include <visp/vpPose.h>
+#include <visp/vpPoseException.h>
+#include <visp/vpPoint.h>
+#include <visp/vpMath.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpNoise.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+  try {
+    // 200 points, the 60 last ones are outliers. The points are sorted by
+    // decreasing quality, as the matches would be by increasing distance.
+    const unsigned int size = 200;
+    const unsigned int nbOutliers = 60;
+    vpHomogeneousMatrix cMo_ref(0.05, -0.1, 1, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(5));
+    vpUniRand rnd(10);
+    std::vector<vpPoint> P(size);
+    for (unsigned int i = 0; i < size; i++) {
+      P[i].setWorldCoordinates(0.4*rnd() - 0.2, 0.4*rnd() - 0.2, 0.2*rnd() - 0.1);
+      P[i].project(cMo_ref);
+      if (i >= size - nbOutliers) {
+        P[i].set_x(P[i].get_x() + 0.1*rnd() - 0.05);
+        P[i].set_y(P[i].get_y() + 0.1*rnd() - 0.05);
+      }
+    }
+
+    vpPose::vpRansacMethodType methods[3] = { vpPose::RANSAC_STANDARD,
+                                              vpPose::RANSAC_ADAPTIVE,
+                                              vpPose::RANSAC_PROSAC };
+    const char *names[3] = { "standard", "adaptive", "PROSAC" };
+    for (unsigned int m = 0; m < 3; m++) {
+      vpPose pose;
+      for (unsigned int i = 0; i < size; i++)
+        pose.addPoint(P[i]);
+      pose.setRansacNbInliersToReachConsensus((int)(size - nbOutliers) / 2);
+      pose.setRansacThreshold(0.001);
+      pose.setRansacMaxTrials(2000);
+      pose.setRansacMethod(methods[m]);
+
+      vpHomogeneousMatrix cMo;
+      double t = vpTime::measureTimeMs();
+      pose.computePose(vpPose::RANSAC, cMo);
+      t = vpTime::measureTimeMs() - t;
+
+      vpHomogeneousMatrix cdMc = cMo_ref * cMo.inverse();
+      vpTranslationVector tr;
+      cdMc.extract(tr);
+      std::cout << "Ransac " << names[m] << ": " << pose.getRansacNbInliers()
+                << " inliers";
+      if (methods[m] != vpPose::RANSAC_STANDARD)
+        std::cout << ", " << pose.getRansacNbTrials() << " trials";
+      std::cout << ", " << t << " ms, translation error "
+                << tr.euclideanNorm() << std::endl;
+
+      if ((unsigned int)pose.getRansacNbInliers() != size - nbOutliers
+          || tr.euclideanNorm() > 1e-6) {
+        std::cout << "Bad pose" << std::endl;
+        return -1;
+      }
+
+      // The inliers are the points added, with their camera coordinates
+      std::vector<vpPoint> inliers = pose.getRansacInliers();
+      for (unsigned int k = 0; k < inliers.size(); k++) {
+        bool found = false;
+        for (unsigned int i = 0; i < size - nbOutliers && ! found; i++)
+          found = (inliers[k].get_oX() == P[i].get_oX()) && (inliers[k].get_x() == P[i].get_x())
+            && (inliers[k].get_Z() == P[i].get_Z());
+        if (! found) {
+          std::cout << "Inlier " << k << " is not one of the points" << std::endl;
+          return -1;
+        }
+      }
+    }
+
+    // A consensus that can not be reached leaves the pose unchanged
+    for (unsigned int m = 1; m < 3; m++) {
+      vpPose pose;
+      for (unsigned int i = 0; i < size; i++)
+        pose.addPoint(P[i]);
+      pose.setRansacNbInliersToReachConsensus((int)(size - nbOutliers) + 10);
+      pose.setRansacThreshold(0.001);
+      pose.setRansacMaxTrials(200);
+      pose.setRansacMethod(methods[m]);
+      vpHomogeneousMatrix cMo, cMo0;
+      bool failed = false;
+      try {
+        pose.computePose(vpPose::RANSAC, cMo);
+      }
+      catch(vpPoseException &) {
+        failed = true;
+      }
+      bool same = true;
+      for (unsigned int i = 0; i < 16; i++)
+        same = same && (cMo.data[i] == cMo0.data[i]);
+      if (! failed || ! same || pose.getRansacNbInliers() != 0) {
+        std::cout << "Ransac " << names[m] << " did not report the failure" << std::endl;
+        return -1;
+      }
+    }
+
+    // Same seed, same result
+    vpHomogeneousMatrix cMo[2];
+    unsigned int nbTrials[2];
+    for (unsigned int k = 0; k < 2; k++) {
+      vpPose pose;
+      for (unsigned int i = 0; i < size; i++)
+        pose.addPoint(P[i]);
+      pose.setRansacNbInliersToReachConsensus((int)(size - nbOutliers) / 2);
+      pose.setRansacThreshold(0.001);
+      pose.setRansacMethod(vpPose::RANSAC_ADAPTIVE);
+      pose.setRansacSeed(42);
+      pose.computePose(vpPose::RANSAC, cMo[k]);
+      nbTrials[k] = pose.getRansacNbTrials();
+    }
+    bool same = (nbTrials[0] == nbTrials[1]);
+    for (unsigned int i = 0; i < 16; i++)
+      same = same && (cMo[0].data[i] == cMo[1].data[i]);
+    if (! same) {
+      std::cout << "The result depends on the run" << std::endl;
+      return -1;
+    }
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
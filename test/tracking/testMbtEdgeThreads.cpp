@@ -0,0 +1,264 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the multithreaded moving edges tracking of vpMbEdgeTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtEdgeThreads.cpp
+
+  \brief Check that the moving edges tracked by vpMbEdgeTracker do not
+  depend on the number of threads.
+
+  A planar object made of nine squares is rendered in two synthetic images
+  at two different poses. The moving edges initialised in the first image
+  are tracked in the second one with one and four threads and must be
+  identical. The pose computed by the tracker is then checked.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpImage.h>
+#include <visp/vpMbEdgeTracker.h>
+#include <visp/vpMe.h>
+#include <visp/vpCameraParameters.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpMeterPixelConversion.h>
+#include <visp/vpPoint.h>
+#include <visp/vpIoTools.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <list>
+
+/*
+  Give access to vpMbEdgeTracker::trackMovingEdge().
+ */
+class vpMbEdgeTrackerTest : public vpMbEdgeTracker
+{
+public:
+  using vpMbEdgeTracker::trackMovingEdge;
+};
+
+/*
+  Moving edges of all the lines of a tracker.
+ */
+std::vector<std::list<vpMeSite> > getSites(vpMbEdgeTrackerTest &tracker)
+{
+  std::vector<std::list<vpMeSite> > sites;
+  std::list<vpMbtDistanceLine *> lines;
+  tracker.getLline(lines);
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+    if ((*it)->meline != NULL)
+      sites.push_back((*it)->meline->getMeList());
+  }
+  return sites;
+}
+
+/*
+  Restore the moving edges saved with getSites().
+ */
+void setSites(vpMbEdgeTrackerTest &tracker, const std::vector<std::list<vpMeSite> > &sites)
+{
+  std::list<vpMbtDistanceLine *> lines;
+  tracker.getLline(lines);
+  unsigned int n = 0;
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+    if ((*it)->meline != NULL)
+      (*it)->meline->getMeList() = sites[n++];
+  }
+}
+
+/*
+  Render the squares of side 0.1 m centered on a 3x3 grid of step 0.15 m
+  with 4x4 samples per pixel.
+ */
+void render(vpImage<unsigned char> &I, const vpCameraParameters &cam,
+            const vpHomogeneousMatrix &cMo)
+{
+  I = 50;
+  for (int s = 0; s < 9; s++) {
+    double xc = 0.15 * (s % 3 - 1);
+    double yc = 0.15 * (s / 3 - 1);
+    double u[4], v[4];
+    for (int k = 0; k < 4; k++) {
+      vpPoint P;
+      P.setWorldCoordinates(xc + ((k == 1 || k == 2) ? 0.05 : -0.05),
+                            yc + ((k >= 2) ? 0.05 : -0.05), 0);
+      P.track(cMo);
+      vpMeterPixelConversion::convertPoint(cam, P.get_x(), P.get_y(), u[k], v[k]);
+    }
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        int inside = 0;
+        for (int a = 0; a < 4; a++) {
+          for (int b = 0; b < 4; b++) {
+            double y = i + (a + 0.5) / 4. - 0.5;
+            double x = j + (b + 0.5) / 4. - 0.5;
+            int sign = 0;
+            bool in = true;
+            for (int k = 0; k < 4 && in; k++) {
+              double cross = (u[(k+1)%4] - u[k]) * (y - v[k])
+                - (v[(k+1)%4] - v[k]) * (x - u[k]);
+              int sk = (cross > 0) ? 1 : -1;
+              if (sign == 0) sign = sk;
+              else if (sk != sign) in = false;
+            }
+            if (in) inside++;
+          }
+        }
+        if (inside)
+          I[i][j] = (unsigned char)(I[i][j] + (200 - 50) * inside / 16);
+      }
+    }
+  }
+}
+
+int main()
+{
+  try {
+    // Write the CAD model in a temporary directory
+    std::string opath;
+#ifdef UNIX
+    opath = "/tmp";
+#elif WIN32
+    opath = "C:\\temp";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    opath += vpIoTools::path("/") + username;
+    if (vpIoTools::checkDirectory(opath) == false)
+      vpIoTools::makeDirectory(opath);
+    std::string model = opath + vpIoTools::path("/") + "testMbtEdgeThreads.cao";
+
+    std::ofstream file(model.c_str());
+    file << "V1" << std::endl << 36 << std::endl;
+    for (int s = 0; s < 9; s++) {
+      double xc = 0.15 * (s % 3 - 1);
+      double yc = 0.15 * (s / 3 - 1);
+      file << xc - 0.05 << " " << yc - 0.05 << " 0" << std::endl;
+      file << xc - 0.05 << " " << yc + 0.05 << " 0" << std::endl;
+      file << xc + 0.05 << " " << yc + 0.05 << " 0" << std::endl;
+      file << xc + 0.05 << " " << yc - 0.05 << " 0" << std::endl;
+    }
+    file << 0 << std::endl << 0 << std::endl << 9 << std::endl;
+    for (int s = 0; s < 9; s++) {
+      file << "4 " << 4*s << " " << 4*s+1 << " " << 4*s+2 << " " << 4*s+3 << std::endl;
+    }
+    file << 0 << std::endl;
+    file.close();
+
+    vpCameraParameters cam(400, 400, 160, 120);
+    vpHomogeneousMatrix cMo0(0, 0, 1, vpMath::rad(10), vpMath::rad(-5), 0);
+    vpHomogeneousMatrix cMo1(0.01, -0.005, 1.02, vpMath::rad(11), vpMath::rad(-4), vpMath::rad(2));
+    vpImage<unsigned char> I0(240, 320), I1(240, 320);
+    render(I0, cam, cMo0);
+    render(I1, cam, cMo1);
+
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(8);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+
+    vpMbEdgeTrackerTest tracker;
+    tracker.setCameraParameters(cam);
+    tracker.setMovingEdge(me);
+    tracker.loadModel(model);
+    tracker.initFromPose(I0, cMo0);
+
+    // Track the same moving edges with 1 and 4 threads
+    std::vector<std::list<vpMeSite> > init = getSites(tracker);
+    std::vector<std::list<vpMeSite> > sites[2];
+    unsigned int nthreads[2] = {1, 4};
+    for (unsigned int k = 0; k < 2; k++) {
+      setSites(tracker, init);
+      tracker.setNumberOfThreads(nthreads[k]);
+      tracker.trackMovingEdge(I1);
+      sites[k] = getSites(tracker);
+    }
+
+    unsigned int nbSites = 0;
+    for (unsigned int l = 0; l < init.size(); l++) {
+      if (sites[0][l].size() != sites[1][l].size()) {
+        std::cout << "Bad number of moving edges" << std::endl;
+        return -1;
+      }
+      std::list<vpMeSite>::const_iterator it1 = sites[1][l].begin();
+      for (std::list<vpMeSite>::const_iterator it0 = sites[0][l].begin();
+           it0 != sites[0][l].end(); ++it0, ++it1) {
+        if (it0->i != it1->i || it0->j != it1->j || it0->ifloat != it1->ifloat
+            || it0->jfloat != it1->jfloat || it0->convlt != it1->convlt
+            || it0->getState() != it1->getState()) {
+          std::cout << "A moving edge depends on the number of threads"
+                    << std::endl;
+          return -1;
+        }
+        nbSites++;
+      }
+    }
+    if (nbSites == 0) {
+      std::cout << "No moving edge tracked" << std::endl;
+      return -1;
+    }
+
+    // Track the object with 4 threads
+    setSites(tracker, init);
+    for (unsigned int n = 0; n < 3; n++) {
+      tracker.track(I1);
+    }
+    vpHomogeneousMatrix cMo;
+    tracker.getPose(cMo);
+    std::cout << "Pose:" << std::endl << cMo << std::endl;
+    vpHomogeneousMatrix cdMc = cMo1 * cMo.inverse();
+    vpTranslationVector t;
+    cdMc.extract(t);
+    if (t.euclideanNorm() > 0.005) {
+      std::cout << "Bad tracking result" << std::endl;
+      return -1;
+    }
+    std::cout << nbSites << " moving edges tracked identically with 1 and 4 threads"
+              << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
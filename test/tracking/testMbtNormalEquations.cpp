@@ -0,0 +1,206 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Compare the accumulated and the stacked normal equations of vpMbEdgeTracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtNormalEquations.cpp
+
+  \brief Check that the normal equations accumulated by
+  vpMbEdgeTracker::computeVVSNormalEquations() give the same pose as the
+  former computation from the stacked interaction matrix.
+
+  Random interaction matrices are set to lines and cylinders of a
+  tracker. The normal equations are computed from these primitives, and
+  with vpMatrix::AtA() and computeJTR() from the weighted interaction
+  matrix of all the features. Both must be bit-identical, as well as the
+  poses updated by the virtual visual servoing control law.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpMbEdgeTracker.h>
+#include <visp/vpMbtDistanceLine.h>
+#include <visp/vpMbtDistanceCylinder.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpColVector.h>
+#include <visp/vpHomogeneousMatrix.h>
+#include <visp/vpExponentialMap.h>
+#include <visp/vpMath.h>
+
+#include <iostream>
+#include <float.h>
+#include <stdlib.h>
+
+/*
+  Give access to the primitives and to the computation of the normal
+  equations of vpMbEdgeTracker.
+ */
+class vpMbEdgeTrackerTest : public vpMbEdgeTracker
+{
+public:
+  using vpMbEdgeTracker::computeVVSNormalEquations;
+  using vpMbEdgeTracker::computeJTR;
+  using vpMbEdgeTracker::lines;
+  using vpMbEdgeTracker::cylinders;
+  using vpMbEdgeTracker::scaleLevel;
+};
+
+double random(double a, double b)
+{
+  return a + (b - a) * rand() / RAND_MAX;
+}
+
+void randomize(vpMatrix &L)
+{
+  for (unsigned int i = 0; i < L.getRows(); i++)
+    for (unsigned int j = 0; j < L.getCols(); j++)
+      L[i][j] = random(-1., 1.);
+}
+
+bool identical(const vpMatrix &A, const vpMatrix &B)
+{
+  for (unsigned int i = 0; i < A.getRows(); i++)
+    for (unsigned int j = 0; j < A.getCols(); j++)
+      if (A[i][j] != B[i][j])
+        return false;
+  return true;
+}
+
+/*
+  Pose updated by the virtual visual servoing control law.
+ */
+vpHomogeneousMatrix update(const vpHomogeneousMatrix &cMo, const vpMatrix &LTL,
+                           const vpColVector &LTR)
+{
+  vpColVector v = vpMatrix(-0.7 * LTL.pseudoInverse(LTL.getRows()*DBL_EPSILON)) * LTR;
+  return vpExponentialMap::direct(v).inverse() * cMo;
+}
+
+/*
+  Compare both computations with nbLines lines and nbCylinders cylinders.
+ */
+bool test(unsigned int nbLines, unsigned int nbCylinders, bool weighted)
+{
+  vpMbEdgeTrackerTest tracker;
+  unsigned int n = 0;
+  for (unsigned int i = 0; i < nbLines; i++) {
+    vpMbtDistanceLine *l = new vpMbtDistanceLine;
+    l->nbFeature = 5 + rand() % 20;
+    l->L.resize(l->nbFeature, 6);
+    randomize(l->L);
+    tracker.lines[tracker.scaleLevel].push_back(l);
+    n += l->nbFeature;
+  }
+  for (unsigned int i = 0; i < nbCylinders; i++) {
+    vpMbtDistanceCylinder *cy = new vpMbtDistanceCylinder;
+    cy->nbFeature = 10 + rand() % 30;
+    cy->L.resize(cy->nbFeature, 6);
+    randomize(cy->L);
+    tracker.cylinders[tracker.scaleLevel].push_back(cy);
+    n += cy->nbFeature;
+  }
+
+  vpColVector rowWeight(n), weighted_error(n);
+  for (unsigned int i = 0; i < n; i++) {
+    rowWeight[i] = weighted ? random(0., 1.) : 1.;
+    weighted_error[i] = random(-0.01, 0.01);
+  }
+
+  // Former computation from the stacked and weighted interaction matrix
+  vpMatrix L(n, 6);
+  unsigned int k = 0;
+  for (std::list<vpMbtDistanceLine*>::const_iterator it = tracker.lines[tracker.scaleLevel].begin();
+       it != tracker.lines[tracker.scaleLevel].end(); ++it)
+    for (unsigned int i = 0; i < (*it)->nbFeature; i++, k++)
+      for (unsigned int j = 0; j < 6; j++)
+        L[k][j] = (*it)->L[i][j];
+  for (std::list<vpMbtDistanceCylinder*>::const_iterator it = tracker.cylinders[tracker.scaleLevel].begin();
+       it != tracker.cylinders[tracker.scaleLevel].end(); ++it)
+    for (unsigned int i = 0; i < (*it)->nbFeature; i++, k++)
+      for (unsigned int j = 0; j < 6; j++)
+        L[k][j] = (*it)->L[i][j];
+  if (weighted) {
+    for (unsigned int i = 0; i < n; i++)
+      for (unsigned int j = 0; j < 6; j++)
+        L[i][j] = rowWeight[i] * L[i][j];
+  }
+  vpMatrix LTLRef = L.AtA();
+  vpColVector LTRRef;
+  tracker.computeJTR(L, weighted_error, LTRRef);
+
+  vpMatrix LTL;
+  vpColVector LTR;
+  tracker.computeVVSNormalEquations(rowWeight, weighted_error, LTL, LTR);
+
+  if (! identical(LTL, LTLRef) || ! identical(LTR, LTRRef)) {
+    std::cout << "Different normal equations with " << nbLines << " lines and "
+              << nbCylinders << " cylinders" << std::endl;
+    return false;
+  }
+
+  vpHomogeneousMatrix cMo(0.02, -0.01, 0.5, vpMath::rad(5), vpMath::rad(-10), vpMath::rad(20));
+  if (! identical(update(cMo, LTL, LTR), update(cMo, LTLRef, LTRRef))) {
+    std::cout << "Different poses with " << nbLines << " lines and "
+              << nbCylinders << " cylinders" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main()
+{
+  // The stacked matrix is multiplied with the original loops, whose
+  // summation order is the one of the accumulated normal equations
+  vpMatrix::setGemmType(vpMatrix::GEMM_NAIVE);
+
+  srand(0);
+  for (unsigned int nbLines = 0; nbLines <= 12; nbLines += 4) {
+    for (unsigned int nbCylinders = 0; nbCylinders <= 2; nbCylinders++) {
+      if (nbLines + nbCylinders == 0)
+        continue;
+      if (! test(nbLines, nbCylinders, true) || ! test(nbLines, nbCylinders, false))
+        return -1;
+    }
+  }
+  std::cout << "The accumulated normal equations are bit-identical" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
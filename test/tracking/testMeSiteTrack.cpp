@@ -0,0 +1,297 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test that vpMeSite::track() with a reusable query buffer and integer
+ * convolution masks gives the same result than the former implementation.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMeSiteTrack.cpp
+
+  \brief Check that the moving edges tracked with a reusable buffer of
+  candidates and integer convolution masks are bit-identical to the ones
+  obtained with the former implementation that built a vpMeSite for each
+  candidate and computed the convolutions in double precision.
+*/
+
+#include <visp/vpImage.h>
+#include <visp/vpMe.h>
+#include <visp/vpMeSite.h>
+#include <visp/vpMath.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/*
+  Former double precision implementation of vpMeSite::convolution()
+  kept as reference.
+ */
+double convolutionReference(vpMeSite &s, const vpImage<unsigned char>& I,
+                            const vpMe *me)
+{
+  int height_ = static_cast<int>(I.getHeight());
+  int width_  = static_cast<int>(I.getWidth());
+  double conv = 0.0;
+  unsigned int msize = me->getMaskSize();
+  int half = (static_cast<int>(msize) - 1) >> 1;
+  int half_1 = half + me->getStrip() + 1;
+  int half_3 = half + me->getStrip() + 3;
+
+  if ((0 < (half_1 - s.i)) || ((s.i - height_ + half_3) > 0)
+      || (0 < (half_1 - s.j)) || ((s.j - width_ + half_3) > 0)) {
+    s.i = 0; s.j = 0;
+    return 0.0;
+  }
+
+  double theta = s.alpha + M_PI/2;
+  while (theta < 0) theta += M_PI;
+  while (theta > M_PI) theta -= M_PI;
+  int thetadeg = vpMath::round(theta * 180 / M_PI);
+  if (abs(thetadeg) == 180)
+    thetadeg = 0;
+  unsigned int index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
+
+  unsigned int ihalf = (unsigned int)(s.i - half);
+  unsigned int jhalf = (unsigned int)(s.j - half);
+  for (unsigned int a = 0; a < msize; a++) {
+    for (unsigned int b = 0; b < msize; b++) {
+      conv += s.mask_sign * me->getMask()[index_mask][a][b] * I(ihalf+a, jhalf+b);
+    }
+  }
+  return conv;
+}
+
+/*
+  Former implementation of vpMeSite::track() kept as reference.
+ */
+void trackReference(vpMeSite &s, const vpImage<unsigned char>& I,
+                    const vpMe *me, bool test_contraste)
+{
+  int max_rank = -1;
+  double max_convolution = 0;
+  double max = 0;
+  double contraste = 0;
+  unsigned int range = me->getRange();
+  vpMeSite *list_query_pixels = s.getQueryList(I, (int)range);
+  double contraste_max = 1 + me->getMu2();
+  double contraste_min = 1 - me->getMu1();
+  double *likelihood = new double[2 * range + 1];
+  int ii_1 = s.i;
+  int jj_1 = s.j;
+  s.i_1 = s.i;
+  s.j_1 = s.j;
+  double threshold = me->getThreshold();
+  double diff = 1e6;
+
+  for (unsigned int n = 0; n < 2 * range + 1; n++) {
+    double convolution = convolutionReference(list_query_pixels[n], I, me);
+    if (test_contraste) {
+      likelihood[n] = fabs(convolution + s.convlt);
+      if (likelihood[n] > threshold) {
+        contraste = convolution / s.convlt;
+        if ((contraste > contraste_min) && (contraste < contraste_max)
+            && fabs(1-contraste) < diff) {
+          diff = fabs(1-contraste);
+          max_convolution = convolution;
+          max = likelihood[n];
+          max_rank = (int)n;
+        }
+      }
+    }
+    else {
+      likelihood[n] = fabs(2*convolution);
+      if (likelihood[n] > max && likelihood[n] > threshold) {
+        max_convolution = convolution;
+        max = likelihood[n];
+        max_rank = (int)n;
+      }
+    }
+  }
+
+  if (max_rank >= 0) {
+    s = list_query_pixels[max_rank];
+    s.normGradient = vpMath::sqr(max_convolution);
+    s.convlt = max_convolution;
+    s.i_1 = ii_1;
+    s.j_1 = jj_1;
+  }
+  else {
+    s.normGradient = 0;
+    if (std::fabs(contraste) > std::numeric_limits<double>::epsilon())
+      s.setState(vpMeSite::CONSTRAST);
+    else
+      s.setState(vpMeSite::THRESHOLD);
+  }
+  delete [] list_query_pixels;
+  delete [] likelihood;
+}
+
+bool isSame(const vpMeSite &a, const vpMeSite &b)
+{
+  return (a.i == b.i && a.j == b.j && a.i_1 == b.i_1 && a.j_1 == b.j_1
+          && a.ifloat == b.ifloat && a.jfloat == b.jfloat
+          && a.v == b.v && a.mask_sign == b.mask_sign && a.alpha == b.alpha
+          && a.convlt == b.convlt && a.normGradient == b.normGradient
+          && a.weight == b.weight && a.getState() == b.getState());
+}
+
+/*
+  Draw a dark disk with a blurred border on a textured background.
+ */
+void drawDisk(vpImage<unsigned char> &I, double ci, double cj, double radius)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double r = sqrt(vpMath::sqr(i - ci) + vpMath::sqr(j - cj));
+      double v = 50. + 150. / (1. + exp((radius - r) / 1.5));
+      I[i][j] = (unsigned char)(v + (i*31 + j*17) % 7);
+    }
+  }
+}
+
+int main()
+{
+  vpImage<unsigned char> I1(240, 320), I2(240, 320);
+  drawDisk(I1, 120, 160, 80);
+  drawDisk(I2, 121.3, 159.2, 80.6);
+
+  vpMe me;
+  me.setRange(6);
+  me.setThreshold(2000);
+  me.setMu1(0.5);
+  me.setMu2(0.5);
+
+  std::vector<vpMeSite::vpMeSiteQuery> queries;
+  unsigned int nsites = 0;
+  unsigned int ntracked = 0;
+
+  for (int mask_sign = -1; mask_sign <= 1; mask_sign += 2) {
+    for (unsigned int k = 0; k < 96; k++) {
+      double theta = k * M_PI / 48.;
+      double alpha = theta + ((int)(k % 5) - 2) * 0.05;
+      double radius = 80. + ((int)(k % 7) - 3) * 0.7;
+      vpMeSite s;
+      s.init(120 + radius * sin(theta), 160 + radius * cos(theta), alpha, 0, mask_sign);
+
+      // Initialisation stage without contrast test, then two tracking
+      // steps with contrast test
+      vpMeSite s_ref = s;
+      trackReference(s_ref, I1, &me, false);
+      s.track(I1, &me, false, queries);
+      if (! isSame(s, s_ref)) {
+        std::cout << "Site " << k << " differs at initialisation (bad result)" << std::endl;
+        return -1;
+      }
+      for (unsigned int n = 0; n < 2; n++) {
+        const vpImage<unsigned char> &I = (n == 0) ? I2 : I1;
+        if (s.getState() != vpMeSite::NO_SUPPRESSION)
+          break;
+        trackReference(s_ref, I, &me, true);
+        s.track(I, &me, true, queries);
+        if (! isSame(s, s_ref)) {
+          std::cout << "Site " << k << " differs at step " << n << " (bad result)" << std::endl;
+          return -1;
+        }
+      }
+      // Convenience version without buffer
+      vpMeSite s2 = s;
+      s_ref = s;
+      trackReference(s_ref, I1, &me, true);
+      s2.track(I1, &me, true);
+      if (! isSame(s2, s_ref)) {
+        std::cout << "Site " << k << " differs without buffer (bad result)" << std::endl;
+        return -1;
+      }
+      nsites ++;
+      if (s.getState() == vpMeSite::NO_SUPPRESSION)
+        ntracked ++;
+    }
+  }
+
+  // Sites close to the image border
+  for (unsigned int k = 0; k < 20; k++) {
+    vpMeSite s;
+    s.init(2. + k * 0.3, 5. + k * 15., k * M_PI / 10., 0, 1);
+    vpMeSite s_ref = s;
+    trackReference(s_ref, I1, &me, false);
+    s.track(I1, &me, false, queries);
+    if (! isSame(s, s_ref)) {
+      std::cout << "Border site " << k << " differs (bad result)" << std::endl;
+      return -1;
+    }
+  }
+
+  std::cout << ntracked << " sites over " << nsites
+            << " tracked; results are bit-identical" << std::endl;
+  if (ntracked == 0) {
+    std::cout << "No site tracked (bad result)" << std::endl;
+    return -1;
+  }
+
+  // Time spent by both implementations
+  std::vector<vpMeSite> sites;
+  for (unsigned int k = 0; k < 400; k++) {
+    double theta = k * M_PI / 200.;
+    vpMeSite s;
+    s.init(120 + 80 * sin(theta), 160 + 80 * cos(theta), theta, 0, 1);
+    s.track(I1, &me, false, queries);
+    sites.push_back(s);
+  }
+  unsigned int nbiter = 50;
+  double t = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbiter; n++) {
+    for (unsigned int k = 0; k < sites.size(); k++) {
+      vpMeSite s = sites[k];
+      trackReference(s, (n % 2) ? I1 : I2, &me, true);
+    }
+  }
+  double t_ref = vpTime::measureTimeMs() - t;
+  t = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbiter; n++) {
+    for (unsigned int k = 0; k < sites.size(); k++) {
+      vpMeSite s = sites[k];
+      s.track((n % 2) ? I1 : I2, &me, true, queries);
+    }
+  }
+  double t_new = vpTime::measureTimeMs() - t;
+  std::cout << "Time to track " << sites.size() << " sites (ms): former "
+            << t_ref / nbiter << " - current " << t_new / nbiter << std::endl;
+
+  return 0;
+}
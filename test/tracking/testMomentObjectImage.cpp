@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Compute the basic moments of a binary image.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMomentObjectImage.cpp
+
+  Compare the basic moments computed by vpMomentObject::fromImage() with a
+  direct per pixel evaluation, with and without distortion.
+*/
+
+#include <visp/vpMomentObject.h>
+#include <visp/vpImage.h>
+#include <visp/vpCameraParameters.h>
+#include <visp/vpPixelMeterConversion.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <iostream>
+#include <vector>
+
+// Direct evaluation of the moments, column after column
+std::vector<double> referenceMoments(const vpImage<unsigned char> &I,
+                                     unsigned char threshold,
+                                     const vpCameraParameters &cam,
+                                     unsigned int order)
+{
+  std::vector<double> m(order*order, 0.);
+  for (unsigned int i = 0; i < I.getWidth(); i++) {
+    for (unsigned int j = 0; j < I.getHeight(); j++) {
+      if (I[j][i] > threshold) {
+        double x, y;
+        vpPixelMeterConversion::convertPoint(cam, i, j, x, y);
+        for (unsigned int k = 0; k < order; k++)
+          for (unsigned int l = 0; l < order - k; l++)
+            m[k*order+l] += pow(x, (int)l) * pow(y, (int)k);
+      }
+    }
+  }
+  return m;
+}
+
+int main()
+{
+  try {
+    // A tilted ellipse and a rectangle
+    vpImage<unsigned char> I(480, 640, 0);
+    for (unsigned int j = 0; j < I.getHeight(); j++) {
+      for (unsigned int i = 0; i < I.getWidth(); i++) {
+        double u = (double)i - 250., v = (double)j - 200.;
+        double a = 0.8*u + 0.6*v, b = -0.6*u + 0.8*v;
+        if (a*a / (150.*150.) + b*b / (70.*70.) < 1.)
+          I[j][i] = 255;
+        if (i >= 450 && i < 600 && j >= 300 && j < 420)
+          I[j][i] = 200;
+      }
+    }
+    const unsigned char threshold = 128;
+    const unsigned int maxOrder = 5;
+
+    for (unsigned int c = 0; c < 2; c++) {
+      vpCameraParameters cam;
+      if (c == 0)
+        cam.initPersProjWithoutDistortion(600, 620, 320, 240);
+      else
+        cam.initPersProjWithDistortion(600, 620, 320, 240, -0.1, 0.1);
+
+      vpMomentObject obj(maxOrder);
+      obj.setType(vpMomentObject::DENSE_FULL_OBJECT);
+      double t = vpTime::measureTimeMs();
+      obj.fromImage(I, threshold, cam);
+      t = vpTime::measureTimeMs() - t;
+
+      std::vector<double> ref = referenceMoments(I, threshold, cam, maxOrder+1);
+      std::cout << (c == 0 ? "Without" : "With") << " distortion: m00 = "
+                << obj.get(0, 0) << ", " << t << " ms" << std::endl;
+      for (unsigned int k = 0; k <= maxOrder; k++) {
+        for (unsigned int l = 0; l <= maxOrder - k; l++) {
+          double m = obj.get(l, k);
+          double r = ref[k*(maxOrder+1)+l];
+          if (fabs(m - r) > 1e-9 * (fabs(r) + 1e-3)) {
+            std::cout << "Bad moment m" << l << k << ": " << m
+                      << " instead of " << r << std::endl;
+            return -1;
+          }
+        }
+      }
+    }
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Incremental update of the basic moments of a moving binary object.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMomentObjectUpdate.cpp
+
+  Follow a moving binary object with vpMomentObject::updateFromImage() and
+  check that the basic moments, and the moments of a database that are
+  lazily computed again, match the ones obtained from scratch.
+*/
+
+#include <visp/vpMomentObject.h>
+#include <visp/vpMomentDatabase.h>
+#include <visp/vpMomentGravityCenter.h>
+#include <visp/vpMomentCentered.h>
+#include <visp/vpMomentCInvariant.h>
+#include <visp/vpImage.h>
+#include <visp/vpCameraParameters.h>
+#include <visp/vpTime.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <iostream>
+
+// Binary image of an ellipse and a square centered in (u0, v0) and rotated by theta
+void drawEllipse(vpImage<unsigned char> &I, double u0, double v0, double theta)
+{
+  double c = cos(theta), s = sin(theta);
+  for (unsigned int j = 0; j < I.getHeight(); j++) {
+    for (unsigned int i = 0; i < I.getWidth(); i++) {
+      double u = (double)i - u0, v = (double)j - v0;
+      double a = c*u + s*v, b = -s*u + c*v;
+      bool in = (a*a / (120.*120.) + b*b / (60.*60.) < 1.);
+      // A square on one side to break the symmetry of the ellipse
+      in = in || (a > 60. && a < 160. && b > 0. && b < 100.);
+      I[j][i] = in ? 255 : 0;
+    }
+  }
+}
+
+bool equal(double a, double b, double tol)
+{
+  return fabs(a - b) <= tol * (fabs(b) + 1e-6);
+}
+
+int main()
+{
+  try {
+    const unsigned int order = 6;
+    const unsigned char threshold = 128;
+    vpCameraParameters cam;
+    cam.initPersProjWithoutDistortion(600, 600, 320, 240);
+
+    vpImage<unsigned char> I(480, 640), Iprev;
+    drawEllipse(I, 300, 220, 0.3);
+
+    vpMomentObject obj(order);
+    obj.fromImage(I, threshold, cam);
+
+    vpMomentDatabase db;
+    vpMomentGravityCenter g;
+    vpMomentCentered mc;
+    vpMomentCInvariant ci;
+    g.linkTo(db);
+    mc.linkTo(db);
+    ci.linkTo(db);
+    db.updateAll(obj);
+    g.compute();
+    mc.compute();
+    ci.compute();
+
+    // Moments only queried with their own getters
+    vpMomentDatabase db2;
+    vpMomentGravityCenter g2;
+    vpMomentCentered mc2;
+    g2.linkTo(db2);
+    mc2.linkTo(db2);
+    db2.updateAll(obj);
+    g2.compute();
+    mc2.compute();
+
+    double tUpdate = 0, tFull = 0;
+    for (unsigned int k = 1; k <= 20; k++) {
+      Iprev = I;
+      drawEllipse(I, 300 + 2*k, 220 - k, 0.3 + 0.01*k);
+
+      double t = vpTime::measureTimeMs();
+      obj.updateFromImage(Iprev, I, threshold, cam);
+      tUpdate += vpTime::measureTimeMs() - t;
+
+      // Reference computed from scratch
+      t = vpTime::measureTimeMs();
+      vpMomentObject ref(order);
+      ref.fromImage(I, threshold, cam);
+      tFull += vpTime::measureTimeMs() - t;
+
+      vpMomentDatabase dbRef;
+      vpMomentGravityCenter gRef;
+      vpMomentCentered mcRef;
+      vpMomentCInvariant ciRef;
+      gRef.linkTo(dbRef);
+      mcRef.linkTo(dbRef);
+      ciRef.linkTo(dbRef);
+      dbRef.updateAll(ref);
+      gRef.compute();
+      mcRef.compute();
+      ciRef.compute();
+
+      for (unsigned int j = 0; j <= order; j++) {
+        for (unsigned int i = 0; i <= order - j; i++) {
+          if (! equal(obj.get(i, j), ref.get(i, j), 1e-9)) {
+            std::cout << "Frame " << k << ": bad m" << i << j << " " << obj.get(i, j)
+                      << " instead of " << ref.get(i, j) << std::endl;
+            return -1;
+          }
+        }
+      }
+
+      // The getters compute the moments again without the database
+      if (! equal(g2.getXg(), gRef.getXg(), 1e-9) || ! equal(g2.getYg(), gRef.getYg(), 1e-9)
+          || ! equal(mc2.get(1, 1), mcRef.get(1, 1), 1e-9)) {
+        std::cout << "Frame " << k << ": getters not updated" << std::endl;
+        return -1;
+      }
+
+      // Only the invariants are queried, the gravity center and the centered
+      // moments they depend on are computed again through the database
+      bool found;
+      vpMomentCInvariant &C = static_cast<vpMomentCInvariant&>(db.get("vpMomentCInvariant", found));
+      if (! found) {
+        std::cout << "vpMomentCInvariant not found" << std::endl;
+        return -1;
+      }
+      for (unsigned int i = 0; i < 14; i++) {
+        if (! equal(C.get(i), ciRef.get(i), 1e-6)) {
+          std::cout << "Frame " << k << ": bad invariant " << i << " " << C.get(i)
+                    << " instead of " << ciRef.get(i) << std::endl;
+          return -1;
+        }
+      }
+      if (! equal(mc.get(2, 0), mcRef.get(2, 0), 1e-9)
+          || ! equal(g.get()[0], gRef.get()[0], 1e-9)) {
+        std::cout << "Frame " << k << ": dependencies not updated" << std::endl;
+        return -1;
+      }
+    }
+    std::cout << "Incremental update: " << tUpdate / 20 << " ms per frame, from scratch: "
+              << tFull / 20 << " ms per frame" << std::endl;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return -1;
+  }
+  return 0;
+}
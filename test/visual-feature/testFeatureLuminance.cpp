@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the interaction matrix of the luminance visual feature.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testFeatureLuminance.cpp
+
+  Compares the luminance feature and its interaction matrix with the
+  values given by the per-pixel derivative filters, and checks that the
+  result does not depend on the number of threads.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpCameraParameters.h>
+#include <visp/vpFeatureLuminance.h>
+#include <visp/vpImage.h>
+#include <visp/vpImageFilter.h>
+#include <visp/vpPixelMeterConversion.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpTime.h>
+
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+
+int main()
+{
+  const unsigned int h = 240, w = 320, bord = 10;
+  const double Z = 0.8;
+
+  vpImage<unsigned char> I(h, w);
+  for (unsigned int i = 0; i < h; i++)
+    for (unsigned int j = 0; j < w; j++)
+      I[i][j] = (unsigned char)(128 + 60*sin(0.05*j + 0.03*i) + 40*cos(0.11*i*j/w) + (rand() % 16));
+
+  vpCameraParameters cam(600, 600, w/2., h/2.);
+
+  vpFeatureLuminance sI;
+  sI.init(h, w, Z);
+  sI.setCameraParameters(cam);
+
+  vpMatrix L;
+  try {
+    sI.interaction(L);
+    std::cout << "interaction() before buildFrom() should throw" << std::endl;
+    return -1;
+  }
+  catch(vpException &) {
+  }
+
+  double t = vpTime::measureTimeMs();
+  sI.buildFrom(I);
+  sI.interaction(L);
+  t = vpTime::measureTimeMs() - t;
+
+  // Reference values computed pixel by pixel
+  double tref = vpTime::measureTimeMs();
+  vpMatrix Lref((h-2*bord)*(w-2*bord), 6);
+  vpColVector sref((h-2*bord)*(w-2*bord));
+  unsigned int m = 0;
+  for (unsigned int i = bord; i < h-bord; i++) {
+    for (unsigned int j = bord; j < w-bord; j++, m++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, i, j, y, x);
+      double Ix = cam.get_px() * vpImageFilter::derivativeFilterX(I, i, j);
+      double Iy = cam.get_py() * vpImageFilter::derivativeFilterY(I, i, j);
+      sref[m] = I[i][j];
+      Lref[m][0] = Ix / Z;
+      Lref[m][1] = Iy / Z;
+      Lref[m][2] = -(x*Ix+y*Iy) / Z;
+      Lref[m][3] = -Ix*x*y-(1+y*y)*Iy;
+      Lref[m][4] = (1+x*x)*Ix + Iy*x*y;
+      Lref[m][5] = Iy*x-Ix*y;
+    }
+  }
+  tref = vpTime::measureTimeMs() - tref;
+
+  if (L.getRows() != Lref.getRows() || L.getCols() != 6) {
+    std::cout << "Bad size of the interaction matrix" << std::endl;
+    return -1;
+  }
+
+  vpColVector s = sI.get_s();
+  double scale = 0;
+  for (unsigned int k = 0; k < Lref.getRows(); k++)
+    for (unsigned int c = 0; c < 6; c++)
+      if (fabs(Lref[k][c]) > scale) scale = fabs(Lref[k][c]);
+
+  for (unsigned int k = 0; k < Lref.getRows(); k++) {
+    if (s[k] != sref[k]) {
+      std::cout << "Bad luminance value at " << k << std::endl;
+      return -1;
+    }
+    for (unsigned int c = 0; c < 6; c++) {
+      if (fabs(L[k][c] - Lref[k][c]) > 1e-5 * scale) {
+        std::cout << "Bad interaction matrix at (" << k << "," << c << "): "
+                  << L[k][c] << " instead of " << Lref[k][c] << std::endl;
+        return -1;
+      }
+    }
+  }
+
+  // The result does not depend on the number of threads
+  vpMatrix L2;
+  sI.setNumberOfThreads(4);
+  vpImageFilter::setNumberOfThreads(4);
+  sI.buildFrom(I);
+  sI.interaction(L2);
+  vpImageFilter::setNumberOfThreads(1);
+  for (unsigned int k = 0; k < L.getRows(); k++)
+    for (unsigned int c = 0; c < 6; c++)
+      if (L2[k][c] != L[k][c]) {
+        std::cout << "The interaction matrix depends on the number of threads" << std::endl;
+        return -1;
+      }
+
+  std::cout << "buildFrom() + interaction(): " << t << " ms (per-pixel filters: "
+            << tref << " ms)" << std::endl;
+  std::cout << "testFeatureLuminance is ok" << std::endl;
+  return 0;
+}
+
+/*
+ * Local variables:
+ * c-basic-offset: 2
+ * End:
+ */
@@ -0,0 +1,236 @@
+/****************************************************************************
+ *
+ * $Id$
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2012 by INRIA. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact INRIA about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://www.irisa.fr/lagadic/visp/visp.html for more information.
+ *
+ * This software was developed at:
+ * INRIA Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ * http://www.irisa.fr/lagadic
+ *
+ * If you have questions regarding the use of this file, please contact
+ * INRIA at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test the memory reuse of the control law computed by vpServo.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testServoControlLaw.cpp
+
+  Checks that vpServo::computeControlLaw() computes the projection
+  operator \f$\bf I-W^+W\f$ and the transpose of the task Jacobian
+  correctly, and that calling it in a loop reuses the memory of the
+  task: the data pointers of the matrices stay the same and neither
+  new nor the matrix workspace allocate after the first iteration.
+*/
+
+#include <visp/vpConfig.h>
+#include <visp/vpFeaturePoint.h>
+#include <visp/vpMatrix.h>
+#include <visp/vpMatrixExpression.h>
+#include <visp/vpServo.h>
+#include <visp/vpVelocityTwistMatrix.h>
+
+#include <iostream>
+#include <new>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+  unsigned long nbAllocations = 0;
+}
+
+// Count the allocations done with new. The elements of vpMatrix are
+// allocated with malloc and realloc: their reallocation is detected by
+// comparing the data pointers
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+  nbAllocations++;
+  void *p = malloc(size ? size : 1);
+  if (p == NULL)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+  return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+  free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+  free(p);
+}
+
+namespace {
+  const unsigned int nbIterations = 10;
+
+  // Gives access to the matrices the control law keeps between two calls
+  class vpServoMemory : public vpServo
+  {
+  public:
+    ~vpServoMemory() { kill(); }
+
+    void getPointers(std::vector<const double *> &p) const
+    {
+      p.clear();
+      p.push_back(J1.data);
+      p.push_back(J1p.data);
+      p.push_back(WpW.data);
+      p.push_back(I_WpW.data);
+      p.push_back(e1.data);
+      p.push_back(e.data);
+      p.push_back(cVf_fVe.data);
+    }
+
+    bool checkValues() const
+    {
+      const unsigned int n = J1.getCols();
+      if ((I_WpW.getRows() != n) || (I_WpW.getCols() != n)) {
+        std::cout << "Bad size of I-WpW" << std::endl;
+        return false;
+      }
+      for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < n; j++)
+          if (fabs(I_WpW[i][j] + WpW[i][j] - (i == j ? 1. : 0.)) > 1e-12) {
+            std::cout << "Bad I-WpW" << std::endl;
+            return false;
+          }
+      if (inversionType == TRANSPOSE) {
+        for (unsigned int i = 0; i < J1.getRows(); i++)
+          for (unsigned int j = 0; j < n; j++)
+            if (J1p[j][i] != J1[i][j]) {
+              std::cout << "Bad transpose of the task Jacobian" << std::endl;
+              return false;
+            }
+      }
+      return true;
+    }
+  };
+
+  // Move the points a little at each iteration to change the control law
+  void setFeatures(vpFeaturePoint *p, vpFeaturePoint *pd,
+                   unsigned int nbPoints, unsigned int k)
+  {
+    for (unsigned int i = 0; i < nbPoints; i++) {
+      double x = (i & 1) ? 0.1 : -0.1, y = (i & 2) ? 0.1 : -0.1;
+      p[i].buildFrom(x + 0.02/(k+1), y - 0.01/(k+1), 1.2 - 0.01*k);
+      pd[i].buildFrom(x, y, 1.);
+    }
+  }
+
+  bool testControlLaw(const char *name, vpServo::vpServoType type,
+                      vpServo::vpServoInversionType inversion,
+                      unsigned int nbPoints)
+  {
+    std::cout << name << std::endl;
+
+    vpServoMemory task;
+    task.setServo(type);
+    task.setInteractionMatrixType(vpServo::CURRENT, inversion);
+    task.setLambda(0.5);
+
+    vpFeaturePoint p[4], pd[4];
+    for (unsigned int i = 0; i < nbPoints; i++)
+      task.addFeature(p[i], pd[i]);
+
+    vpHomogeneousMatrix cMe(0.01, 0.02, 0.1, 0.1, 0.2, 0.3);
+    vpHomogeneousMatrix fMe(0.1, 0.2, 0.3, 0.3, 0.2, 0.1);
+    vpVelocityTwistMatrix cVe(cMe), cVf(cMe*fMe.inverse()), fVe(fMe);
+    vpMatrix eJe(6, 6);
+    eJe.setIdentity();
+
+    std::vector<const double *> first, current;
+    for (unsigned int k = 0; k < nbIterations; k++) {
+      // The features return their interaction matrix and their error by
+      // value, and the control law is returned by value: count these
+      // allocations to leave them out of the ones of the control law
+      setFeatures(p, pd, nbPoints, k);
+      unsigned long n = nbAllocations;
+      task.computeInteractionMatrix();
+      task.computeError();
+      const unsigned long nbFeatureAllocations = nbAllocations - n + 1;
+
+      setFeatures(p, pd, nbPoints, k);
+      task.set_cVe(cVe);
+      task.set_cVf(cVf);
+      task.set_fVe(fVe);
+      task.set_eJe(eJe);
+      if (k == 1)
+        vpMatrixWorkspace::resetCounters();
+      n = nbAllocations;
+      task.computeControlLaw();
+      const unsigned long nbLawAllocations = nbAllocations - n;
+      if (! task.checkValues())
+        return false;
+
+      if (k == 0) {
+        task.getPointers(first);
+        continue;
+      }
+      task.getPointers(current);
+      if (current != first) {
+        std::cout << "The control law reallocated a matrix at iteration "
+                  << k << std::endl;
+        return false;
+      }
+      if ((nbLawAllocations != nbFeatureAllocations)
+          || (vpMatrixWorkspace::getNbAllocations() != 0)) {
+        std::cout << nbLawAllocations - nbFeatureAllocations
+                  << " allocations with new and "
+                  << vpMatrixWorkspace::getNbAllocations()
+                  << " temporaries allocated at iteration " << k << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int
+main()
+{
+  // Full rank task Jacobian: WpW is the identity
+  if (! testControlLaw("Eye-in-hand, 4 points", vpServo::EYEINHAND_L_cVe_eJe,
+                       vpServo::PSEUDO_INVERSE, 4))
+    return -1;
+  // Rank deficient task Jacobian: WpW is computed from its image
+  if (! testControlLaw("Eye-to-hand, 2 points", vpServo::EYETOHAND_L_cVf_fVe_eJe,
+                       vpServo::PSEUDO_INVERSE, 2))
+    return -1;
+  if (! testControlLaw("Eye-in-hand, 2 points, transpose",
+                       vpServo::EYEINHAND_L_cVe_eJe,
+                       vpServo::TRANSPOSE, 2))
+    return -1;
+
+  std::cout << "vpServo::computeControlLaw() reuses its memory" << std::endl;
+  return 0;
+}